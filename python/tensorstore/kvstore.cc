@@ -333,9 +333,12 @@ Example:
     KvStore({
       'context': {
         'file_io_concurrency': {},
+        'file_io_direct': False,
+        'file_io_group_commit': {},
         'file_io_locking': {},
         'file_io_memmap': False,
         'file_io_sync': True,
+        'file_io_uring': {},
       },
       'driver': 'file',
       'path': 'tmp/data/abc',
@@ -344,9 +347,12 @@ Example:
     KvStore({
       'context': {
         'file_io_concurrency': {},
+        'file_io_direct': False,
+        'file_io_group_commit': {},
         'file_io_locking': {},
         'file_io_memmap': False,
         'file_io_sync': True,
+        'file_io_uring': {},
       },
       'driver': 'file',
       'path': 'tmp/dataabc',
@@ -373,9 +379,12 @@ Example:
     KvStore({
       'context': {
         'file_io_concurrency': {},
+        'file_io_direct': False,
+        'file_io_group_commit': {},
         'file_io_locking': {},
         'file_io_memmap': False,
         'file_io_sync': True,
+        'file_io_uring': {},
       },
       'driver': 'file',
       'path': 'tmp/data/abc',
@@ -384,9 +393,12 @@ Example:
     KvStore({
       'context': {
         'file_io_concurrency': {},
+        'file_io_direct': False,
+        'file_io_group_commit': {},
         'file_io_locking': {},
         'file_io_memmap': False,
         'file_io_sync': True,
+        'file_io_uring': {},
       },
       'driver': 'file',
       'path': 'tmp/data/abc',
@@ -1125,9 +1137,12 @@ Example:
     KvStore({
       'context': {
         'file_io_concurrency': {},
+        'file_io_direct': False,
+        'file_io_group_commit': {},
         'file_io_locking': {},
         'file_io_memmap': False,
         'file_io_sync': True,
+        'file_io_uring': {},
       },
       'driver': 'file',
       'path': 'tmp/data/',
@@ -1147,9 +1162,12 @@ Example:
   KvStore({
     'context': {
       'file_io_concurrency': {},
+      'file_io_direct': False,
+      'file_io_group_commit': {},
       'file_io_locking': {},
       'file_io_memmap': False,
       'file_io_sync': True,
+      'file_io_uring': {},
     },
     'driver': 'file',
     'path': 'tmp/data/abc/',
@@ -1158,9 +1176,12 @@ Example:
   KvStore({
     'context': {
       'file_io_concurrency': {},
+      'file_io_direct': False,
+      'file_io_group_commit': {},
       'file_io_locking': {},
       'file_io_memmap': False,
       'file_io_sync': True,
+      'file_io_uring': {},
     },
     'driver': 'file',
     'path': 'tmp/data/',
@@ -1369,9 +1390,12 @@ Example:
   {'context': {},
    'driver': 'file',
    'file_io_concurrency': 'file_io_concurrency',
+   'file_io_direct': 'file_io_direct',
+   'file_io_group_commit': 'file_io_group_commit',
    'file_io_locking': 'file_io_locking',
    'file_io_memmap': 'file_io_memmap',
    'file_io_sync': 'file_io_sync',
+   'file_io_uring': 'file_io_uring',
    'path': 'tmp/dataset/abc/'}
 
 Group:
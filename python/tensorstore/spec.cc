@@ -802,9 +802,11 @@ Example:
     'context': {
       'cache_pool': {},
       'data_copy_concurrency': {},
+      'disk_cache': {},
       'memory_key_value_store': {},
     },
     'data_copy_concurrency': ['data_copy_concurrency'],
+    'disk_cache': ['disk_cache'],
     'driver': 'n5',
     'kvstore': {
       'driver': 'memory',
@@ -186,6 +186,7 @@ Examples:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -381,6 +382,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1220,6 +1222,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'downsample_factors': [2, 4],
@@ -1236,6 +1239,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1269,6 +1273,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1431,6 +1436,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1564,6 +1570,7 @@ integer or boolean array indexing terms are applied orthogonally:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1679,6 +1686,7 @@ domain:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1806,6 +1814,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -1974,6 +1983,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'n5',
@@ -2097,6 +2107,7 @@ Example:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'n5',
@@ -2355,6 +2366,7 @@ Opens or creates a :py:class:`TensorStore` from a :py:class:`Spec`.
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -2416,6 +2428,7 @@ like the data type, domain, and chunk layout, may be omitted:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'gcs_request_concurrency': {},
         'gcs_request_retries': {},
         'gcs_user_project': {},
@@ -2478,6 +2491,7 @@ properties that are left unconstrained:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -2530,6 +2544,7 @@ determine a matching chunk layout automatically:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
@@ -2582,6 +2597,7 @@ independent of the driver/format:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'n5',
@@ -2625,6 +2641,7 @@ schema constraints:
       'context': {
         'cache_pool': {},
         'data_copy_concurrency': {},
+        'disk_cache': {},
         'memory_key_value_store': {},
       },
       'driver': 'zarr',
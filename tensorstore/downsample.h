@@ -19,15 +19,20 @@
 /// Downsampling adapter for TensorStore objects.
 
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/driver/downsample/downsample.h"
+#include "tensorstore/driver/downsample/downsample_pyramid.h"
+#include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/spec.h"
 #include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
@@ -106,6 +111,77 @@ Result<Spec> Downsample(const Spec& base_spec,
       downsample_method);
 }
 
+/// Options for `DownsamplePyramid`.
+///
+/// \ingroup downsample
+struct DownsamplePyramidOptions {
+  /// Limit on the total size in bytes of the base data being downsampled
+  /// concurrently, or `0` for no limit.  At least one region of the base data
+  /// is always processed, even if it exceeds the limit.
+  Index bytes_limit = 0;
+};
+
+/// Writes all levels of a multi-resolution pyramid in a single pass over the
+/// base data.
+///
+/// Level `k` is downsampled by `downsample_factors[k]` from level `k - 1` (or
+/// from `base`, for `k == 0`), and written to `levels[k]`.  The result is
+/// identical to writing the chained views::
+///
+///     Downsample(Downsample(base, downsample_factors[0], method),
+///                downsample_factors[1], method)
+///
+/// and so on, but each element of `base` is read only once, rather than once
+/// per level: `base` is read in regions aligned to the product of all
+/// downsample factors (and, where possible, to its read chunk grid), and each
+/// region is downsampled to all levels in memory before being written.
+///
+/// Since each region contributes only a portion of the chunks of the coarser
+/// levels, the downsampled data is accumulated in memory until a write chunk
+/// of the level is complete, such that each chunk is written only once.  This
+/// memory is not included in `DownsamplePyramidOptions::bytes_limit`.
+///
+/// Example::
+///
+///     std::vector<TensorStore<>> levels = {scale1, scale2, scale3};
+///     std::vector<std::vector<Index>> factors(3, {2, 2, 1});
+///     TENSORSTORE_RETURN_IF_ERROR(
+///         DownsamplePyramid(scale0, levels, factors, DownsampleMethod::kMean)
+///             .result());
+///
+/// \param base Base data to downsample, must support reading.
+/// \param levels Targets for each level, must support writing.  The domain of
+///     each level must contain its downsampled domain.
+/// \param downsample_factors Factors by which each level is downsampled from
+///     the preceding level.  Must have the same length as `levels`, and each
+///     element must have length equal to `base.rank()`.
+/// \param downsample_method The downsampling method.
+/// \param options Specifies the limit on the memory used.
+/// \returns A future that becomes ready once all levels have been written
+///     (and, for non-transactional writes, committed), or an error occurs.
+/// \error `absl::StatusCode::kInvalidArgument` if `downsample_factors` is
+///     invalid, or `downsample_method` is not supported for `base.dtype()`.
+/// \ingroup downsample
+template <typename Element, DimensionIndex Rank, ReadWriteMode Mode>
+Future<void> DownsamplePyramid(
+    const TensorStore<Element, Rank, Mode>& base,
+    tensorstore::span<const TensorStore<>> levels,
+    tensorstore::span<const std::vector<Index>> downsample_factors,
+    DownsampleMethod downsample_method, DownsamplePyramidOptions options = {}) {
+  static_assert(Mode != ReadWriteMode::write,
+                "Cannot downsample write-only TensorStore");
+  std::vector<internal::DriverHandle> level_handles;
+  level_handles.reserve(levels.size());
+  for (const auto& level : levels) {
+    level_handles.push_back(internal::TensorStoreAccess::handle(level));
+  }
+  return internal::DriverDownsamplePyramid(
+      internal::TensorStoreAccess::handle(base), std::move(level_handles),
+      std::vector<std::vector<Index>>(downsample_factors.begin(),
+                                      downsample_factors.end()),
+      downsample_method, options.bytes_limit);
+}
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_DOWNSAMPLE_H_
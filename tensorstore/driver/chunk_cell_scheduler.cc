@@ -0,0 +1,125 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/chunk_cell_scheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+void ChunkCellScheduler::Initialize(BoxView<> domain,
+                                    const ChunkLayout& layout,
+                                    Index element_size, Index bytes_limit) {
+  const DimensionIndex rank = domain.rank();
+  std::vector<Index> cell_shape(rank, 0);
+  std::vector<Index> grid_origin(rank, kImplicit);
+  if (layout.rank() == rank) {
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      cell_shape[i] = layout.read_chunk_shape()[i];
+      grid_origin[i] = layout.grid_origin()[i];
+    }
+  }
+  Initialize(domain, cell_shape, grid_origin, element_size, bytes_limit);
+}
+
+void ChunkCellScheduler::Initialize(BoxView<> domain,
+                                    span<const Index> cell_shape,
+                                    span<const Index> grid_origin,
+                                    Index element_size, Index bytes_limit) {
+  const DimensionIndex rank = domain.rank();
+  assert(cell_shape.size() == rank);
+  assert(grid_origin.size() == rank);
+  domain_ = domain;
+  element_size_ = element_size;
+  bytes_limit_ = bytes_limit;
+  cell_shape_.resize(rank);
+  first_cell_origin_.resize(rank);
+  bool empty = false;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const IndexInterval interval = domain[i];
+    if (interval.empty()) empty = true;
+    Index size = cell_shape[i];
+    Index origin = grid_origin[i];
+    if (size <= 0 || origin == kImplicit) {
+      size = std::max(Index(1), interval.size());
+      origin = interval.inclusive_min();
+    }
+    cell_shape_[i] = size;
+    first_cell_origin_[i] =
+        origin + FloorOfRatio(interval.inclusive_min() - origin, size) * size;
+  }
+  absl::MutexLock lock(&mutex_);
+  next_cell_origin_ = first_cell_origin_;
+  done_ = empty;
+}
+
+bool ChunkCellScheduler::AcquireNextCell(Box<>& cell, Index& bytes) {
+  const DimensionIndex rank = domain_.rank();
+  absl::MutexLock lock(&mutex_);
+  if (starting_ || done_) return false;
+  cell.set_rank(rank);
+  bytes = element_size_;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    cell[i] = Intersect(domain_[i], IndexInterval::UncheckedSized(
+                                        next_cell_origin_[i], cell_shape_[i]));
+    bytes *= cell[i].size();
+  }
+  if (bytes_limit_ > 0 && outstanding_bytes_ > 0 &&
+      outstanding_bytes_ + bytes > bytes_limit_) {
+    return false;
+  }
+  outstanding_bytes_ += bytes;
+  starting_ = true;
+
+  // Advance to the next cell in C order.
+  done_ = true;
+  for (DimensionIndex i = rank - 1; i >= 0; --i) {
+    next_cell_origin_[i] += cell_shape_[i];
+    if (next_cell_origin_[i] <= domain_[i].inclusive_max()) {
+      done_ = false;
+      break;
+    }
+    next_cell_origin_[i] = first_cell_origin_[i];
+  }
+  return true;
+}
+
+void ChunkCellScheduler::Release(Index bytes) {
+  absl::MutexLock lock(&mutex_);
+  outstanding_bytes_ -= bytes;
+}
+
+void ChunkCellScheduler::Stop() {
+  absl::MutexLock lock(&mutex_);
+  done_ = true;
+}
+
+bool ChunkCellScheduler::done() {
+  absl::MutexLock lock(&mutex_);
+  return done_;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
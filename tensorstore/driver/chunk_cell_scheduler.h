@@ -0,0 +1,107 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_CHUNK_CELL_SCHEDULER_H_
+#define TENSORSTORE_DRIVER_CHUNK_CELL_SCHEDULER_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Starts operations on the cells of a read chunk grid, in C order, while
+/// the total size of the cells whose operations are outstanding does not
+/// exceed a limit.
+///
+/// Used by `DriverPrefetch` and `DriverCopy` to bound the amount of data in
+/// flight.  At least one cell is always outstanding, even if it exceeds the
+/// limit.
+///
+/// All member functions other than `Initialize` are thread safe.
+class ChunkCellScheduler {
+ public:
+  /// Partitions `domain` into cells of the read chunk grid of `layout`, which
+  /// must be in the same index space.  Dimensions for which `layout` does not
+  /// specify a read chunk size or grid origin are not partitioned.
+  ///
+  /// \param element_size Size in bytes of each element.
+  /// \param bytes_limit Limit on the total size of the outstanding cells, or
+  ///     `0` to indicate no limit.
+  void Initialize(BoxView<> domain, const ChunkLayout& layout,
+                  Index element_size, Index bytes_limit);
+
+  /// Partitions `domain` into cells of the grid specified by `cell_shape` and
+  /// `grid_origin`.  Dimensions for which `cell_shape` is not positive or
+  /// `grid_origin` is `kImplicit` are not partitioned.
+  void Initialize(BoxView<> domain, span<const Index> cell_shape,
+                  span<const Index> grid_origin, Index element_size,
+                  Index bytes_limit);
+
+  /// Invokes `start(Box<> cell, Index bytes)` for each cell that may be
+  /// started, where `cell` is the intersection of the cell with the domain.
+  ///
+  /// Returns immediately if called while another call is starting cells,
+  /// since that call checks the limit again before returning.  Consequently,
+  /// `start` may safely call `Release` and `StartCells` recursively.
+  template <typename Start>
+  void StartCells(Start start) {
+    Box<> cell;
+    Index bytes;
+    while (AcquireNextCell(cell, bytes)) {
+      start(std::move(cell), bytes);
+      absl::MutexLock lock(&mutex_);
+      starting_ = false;
+    }
+  }
+
+  /// Releases the `bytes` of a cell whose operation has completed.  The
+  /// caller should subsequently call `StartCells`.
+  void Release(Index bytes);
+
+  /// Prevents any further cells from being started.
+  void Stop();
+
+  /// Returns `true` if all cells have been started, or `Stop` was called.
+  bool done();
+
+ private:
+  bool AcquireNextCell(Box<>& cell, Index& bytes);
+
+  Box<> domain_;
+  std::vector<Index> cell_shape_;
+  Index element_size_;
+  Index bytes_limit_;
+
+  /// Origins of the first and next cells, which may lie outside `domain_`.
+  std::vector<Index> first_cell_origin_;
+  std::vector<Index> next_cell_origin_ ABSL_GUARDED_BY(mutex_);
+
+  absl::Mutex mutex_;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  bool starting_ ABSL_GUARDED_BY(mutex_) = false;
+  Index outstanding_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_CHUNK_CELL_SCHEDULER_H_
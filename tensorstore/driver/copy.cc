@@ -14,20 +14,32 @@
 
 #include "tensorstore/driver/copy.h"
 
+#include <algorithm>
 #include <atomic>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/data_type_conversion.h"
 #include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/chunk_cell_scheduler.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable.h"
@@ -45,6 +57,7 @@
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
@@ -95,6 +108,13 @@ namespace {
 /// 8. Once `CopyState` is destroyed and all `CommitCallback` links are
 ///    completed, the `commit_promise` is marked ready, indicating to the caller
 ///    that all data has been written back (or an error has occurred).
+///
+/// If a `CopyBytesLimit` is specified, step 3 instead partitions the source
+/// domain into cells computed by `GetCopyCellGrid`, and `CopyScheduleState`
+/// calls `Driver::Read` separately for each cell while the limit permits.  A
+/// `CopyCellState` referenced from the receivers and operations of steps 4-6
+/// (and, for non-transactional writes, until the chunks are committed) starts
+/// further cells once it is destroyed.
 struct CopyState : public internal::AtomicReferenceCount<CopyState> {
   /// CommitState is a separate reference-counted struct (rather than simply
   /// using `CopyState`) in order to ensure the reference to `copy_promise` and
@@ -103,6 +123,7 @@ struct CopyState : public internal::AtomicReferenceCount<CopyState> {
   /// referenced, to be freed).
   struct CommitState : public internal::AtomicReferenceCount<CommitState> {
     CopyProgressFunction progress_function;
+    absl::Time start_time = absl::Now();
     Index total_elements;
     std::atomic<Index> copied_elements{0};
     std::atomic<Index> committed_elements{0};
@@ -110,23 +131,23 @@ struct CopyState : public internal::AtomicReferenceCount<CopyState> {
 
     void UpdateReadProgress(Index num_elements) {
       if (!progress_function.value) return;
-      progress_function.value(
-          CopyProgress{total_elements, read_elements += num_elements,
-                       copied_elements, committed_elements});
+      progress_function.value(CopyProgress{
+          total_elements, read_elements += num_elements, copied_elements,
+          committed_elements, absl::Now() - start_time});
     }
 
     void UpdateCopyProgress(Index num_elements) {
       if (!progress_function.value) return;
-      progress_function.value(CopyProgress{total_elements, read_elements,
-                                           copied_elements += num_elements,
-                                           committed_elements});
+      progress_function.value(CopyProgress{
+          total_elements, read_elements, copied_elements += num_elements,
+          committed_elements, absl::Now() - start_time});
     }
 
     void UpdateCommitProgress(Index num_elements) {
       if (!progress_function.value) return;
-      progress_function.value(CopyProgress{total_elements, read_elements,
-                                           copied_elements,
-                                           committed_elements += num_elements});
+      progress_function.value(CopyProgress{
+          total_elements, read_elements, copied_elements,
+          committed_elements += num_elements, absl::Now() - start_time});
     }
   };
   Executor executor;
@@ -138,22 +159,56 @@ struct CopyState : public internal::AtomicReferenceCount<CopyState> {
   internal::OpenTransactionPtr target_transaction;
   IndexTransform<> target_transform;
   DomainAlignmentOptions alignment_options;
+  Index bytes_limit;
   Promise<void> copy_promise;
   Promise<void> commit_promise;
   IntrusivePtr<CommitState> commit_state{new CommitState};
+  std::atomic<bool> failed{false};
   internal_tracing::TraceSpan tspan{"tensorstore.Copy"};
 
   void SetError(absl::Status error) {
     SetDeferredResult(copy_promise, std::move(error));
+    failed = true;
   }
 };
 
+struct CopyScheduleState;
+
+/// Outstanding work for a single cell of a copy with a `CopyBytesLimit`.
+///
+/// Once all references have been released, the bytes of the cell are released
+/// and further cells are started using the executor.
+struct CopyCellState : public internal::AtomicReferenceCount<CopyCellState> {
+  IntrusivePtr<CopyScheduleState> schedule;
+  Index bytes;
+  ~CopyCellState();
+};
+
+/// Local state used to start the cells of a copy with a `CopyBytesLimit`.
+///
+/// The reference to `CopyState` is released once all cells have been started,
+/// such that `copy_promise` may become ready while the last cells are still
+/// being committed.
+struct CopyScheduleState
+    : public internal::AtomicReferenceCount<CopyScheduleState> {
+  Executor executor;
+  IndexTransform<> source_transform;
+  ChunkCellScheduler cells;
+  absl::Mutex mutex;
+  IntrusivePtr<CopyState> copy_state ABSL_GUARDED_BY(mutex);
+
+  /// Starts reading cells until the limit is reached.  `batch` is used only
+  /// for the initial cells.
+  void StartCells(Batch batch);
+};
+
 /// Callback invoked by `CopyWriteChunkReceiver` (using the executor) to copy
 /// data from the relevant portion of a single `ReadChunk` to a `WriteChunk`.
 struct CopyChunkOp {
   IntrusivePtr<CopyState> state;
   ReadChunk adjusted_read_chunk;
   WriteChunk write_chunk;
+  IntrusivePtr<CopyCellState> cell;
   void operator()() {
     DefaultNDIterableArena arena;
 
@@ -211,6 +266,13 @@ struct CopyChunkOp {
         // For transactional writes, `state->commit_promise` is null.
         LinkValue(CommitCallback{state->commit_state, num_elements},
                   state->commit_promise, commit_future);
+        if (cell) {
+          // The data of the cell remains in flight until it is committed,
+          // which must not wait for the caller to force `commit_promise`.
+          commit_future.Force();
+          commit_future.ExecuteWhenReady(
+              [cell = std::move(cell)](ReadyFuture<const void>) {});
+        }
       } else {
         state->commit_state->UpdateCommitProgress(num_elements);
       }
@@ -226,6 +288,7 @@ struct CopyChunkOp {
 struct CopyWriteChunkReceiver {
   IntrusivePtr<CopyState> state;
   ReadChunk read_chunk;
+  IntrusivePtr<CopyCellState> cell;
   FutureCallbackRegistration cancel_registration;
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration =
@@ -251,7 +314,7 @@ struct CopyWriteChunkReceiver {
     //
     // Don't move `state` since `set_value` may be called multiple times.
     state->executor(CopyChunkOp{state, std::move(adjusted_read_chunk),
-                                std::move(write_chunk)});
+                                std::move(write_chunk), cell});
   }
 };
 
@@ -262,6 +325,7 @@ struct CopyInitiateWriteOp {
   IntrusivePtr<CopyState> state;
   ReadChunk chunk;
   IndexTransform<> cell_transform;
+  IntrusivePtr<CopyCellState> cell;
   void operator()() {
     // Map the portion of the target TensorStore corresponding to this source
     // `chunk` to the index space expected by `chunk`.
@@ -278,7 +342,8 @@ struct CopyInitiateWriteOp {
     request.transaction = state->target_transaction;
     request.transform = std::move(write_transform);
     state->target_driver->Write(
-        std::move(request), CopyWriteChunkReceiver{state, std::move(chunk)});
+        std::move(request),
+        CopyWriteChunkReceiver{state, std::move(chunk), std::move(cell)});
   }
 };
 
@@ -287,6 +352,7 @@ struct CopyInitiateWriteOp {
 /// chunk received.
 struct CopyReadChunkReceiver {
   IntrusivePtr<CopyState> state;
+  IntrusivePtr<CopyCellState> cell;
   FutureCallbackRegistration cancel_registration;
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration =
@@ -300,10 +366,111 @@ struct CopyReadChunkReceiver {
     //
     // Don't move `state` since `set_value` may be called multiple times.
     state->executor(CopyInitiateWriteOp{state, std::move(chunk),
-                                        std::move(cell_transform)});
+                                        std::move(cell_transform), cell});
   }
 };
 
+CopyCellState::~CopyCellState() {
+  auto schedule = std::move(this->schedule);
+  schedule->cells.Release(bytes);
+  if (schedule->cells.done()) return;
+  Executor executor = schedule->executor;
+  executor([schedule = std::move(schedule)] {
+    schedule->StartCells(no_batch);
+  });
+}
+
+void CopyScheduleState::StartCells(Batch batch) {
+  IntrusivePtr<CopyState> state;
+  {
+    absl::MutexLock lock(&mutex);
+    state = copy_state;
+  }
+  if (!state) return;
+  if (state->failed || !state->copy_promise.result_needed()) cells.Stop();
+  cells.StartCells([&](Box<> cell, Index bytes) {
+    IntrusivePtr<CopyCellState> cell_state(new CopyCellState);
+    cell_state->schedule.reset(this);
+    cell_state->bytes = bytes;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto cell_transform,
+        ComposeTransforms(source_transform, IdentityTransform(cell)),
+        state->SetError(_));
+    Driver::ReadRequest request;
+    request.transaction = state->source_transaction;
+    request.batch = batch;
+    request.transform = std::move(cell_transform);
+    state->source_driver->Read(
+        std::move(request),
+        CopyReadChunkReceiver{state, std::move(cell_state)});
+  });
+  if (cells.done()) {
+    absl::MutexLock lock(&mutex);
+    copy_state.reset();
+  }
+}
+
+/// Computes the grid of cells for a copy with a `CopyBytesLimit`.
+///
+/// The commit of each cell is forced separately, so a target write chunk that
+/// intersects several cells is read-modify-written once per cell.  Cells are
+/// therefore aligned to the target write chunk grid, and enlarged to the least
+/// common multiple of the target write chunk grid and the source read chunk
+/// grid if the grids are aligned and the resultant cell fits within
+/// `bytes_limit`.  A source read chunk that intersects several cells only
+/// costs additional reads.
+///
+/// Dimensions not chunked by the target follow the source read chunk grid.
+/// `domain`, `source_layout` and `target_layout` must be in the same index
+/// space.
+void GetCopyCellGrid(BoxView<> domain, const ChunkLayout& source_layout,
+                     const ChunkLayout& target_layout, Index element_size,
+                     Index bytes_limit, span<Index> cell_shape,
+                     span<Index> grid_origin) {
+  const DimensionIndex rank = domain.rank();
+  const bool has_source_grid = source_layout.rank() == rank;
+  const bool has_target_grid = target_layout.rank() == rank;
+  std::vector<Index> combined_cell_shape(rank);
+  Index combined_bytes = element_size;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    Index read_size = has_source_grid ? source_layout.read_chunk_shape()[i] : 0;
+    Index read_origin =
+        has_source_grid ? source_layout.grid_origin()[i] : kImplicit;
+    if (read_size <= 0 || read_origin == kImplicit) {
+      read_size = 0;
+      read_origin = kImplicit;
+    }
+    Index write_size =
+        has_target_grid ? target_layout.write_chunk_shape()[i] : 0;
+    Index write_origin =
+        has_target_grid ? target_layout.grid_origin()[i] : kImplicit;
+    if (write_size <= 0 || write_origin == kImplicit) {
+      cell_shape[i] = combined_cell_shape[i] = read_size;
+      grid_origin[i] = read_origin;
+    } else {
+      cell_shape[i] = combined_cell_shape[i] = write_size;
+      grid_origin[i] = write_origin;
+      Index lcm;
+      if (read_size > 0 && (write_origin - read_origin) % read_size == 0 &&
+          !internal::MulOverflow(write_size / std::gcd(read_size, write_size),
+                                 read_size, &lcm)) {
+        combined_cell_shape[i] = lcm;
+      }
+    }
+    Index extent = domain[i].size();
+    if (combined_cell_shape[i] > 0) {
+      extent = std::min(extent, combined_cell_shape[i]);
+    }
+    if (internal::MulOverflow(combined_bytes, extent, &combined_bytes)) {
+      combined_bytes = std::numeric_limits<Index>::max();
+    }
+  }
+  if (combined_bytes <= bytes_limit) {
+    std::copy(combined_cell_shape.begin(), combined_cell_shape.end(),
+              cell_shape.begin());
+  }
+}
+
 /// Callback used by `DriverCopy` to initiate the copy operation once the bounds
 /// for the source and target transforms have been resolved.
 struct DriverCopyInitiateOp {
@@ -327,6 +494,11 @@ struct DriverCopyInitiateOp {
     state->copy_promise = std::move(promise);
     state->target_transform = std::move(target_transform);
 
+    if (state->bytes_limit > 0 && IsFinite(source_transform.domain())) {
+      InitiateCells(std::move(source_transform));
+      return;
+    }
+
     // Initiate the read operation on the source driver.
     auto source_driver = std::move(state->source_driver);
     Driver::ReadRequest request;
@@ -336,6 +508,35 @@ struct DriverCopyInitiateOp {
     source_driver->Read(std::move(request),
                         CopyReadChunkReceiver{std::move(state)});
   }
+
+  /// Initiates the read operations for a copy with a `CopyBytesLimit`.
+  void InitiateCells(IndexTransform<> source_transform) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto source_layout,
+        state->source_driver->GetChunkLayout(source_transform),
+        state->SetError(_));
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto target_layout,
+        state->target_driver->GetChunkLayout(state->target_transform),
+        state->SetError(_));
+    const BoxView<> domain = source_transform.domain().box();
+    const Index element_size = state->source_driver->dtype().size();
+    std::vector<Index> cell_shape(domain.rank());
+    std::vector<Index> grid_origin(domain.rank());
+    GetCopyCellGrid(domain, source_layout, target_layout, element_size,
+                    state->bytes_limit, cell_shape, grid_origin);
+    IntrusivePtr<CopyScheduleState> schedule(new CopyScheduleState);
+    schedule->executor = state->executor;
+    schedule->cells.Initialize(domain, cell_shape, grid_origin, element_size,
+                               state->bytes_limit);
+    schedule->source_transform = std::move(source_transform);
+    auto batch = std::move(state->source_batch);
+    {
+      absl::MutexLock lock(&schedule->mutex);
+      schedule->copy_state = std::move(state);
+    }
+    schedule->StartCells(std::move(batch));
+  }
 };
 
 }  // namespace
@@ -363,6 +564,7 @@ WriteFutures DriverCopy(Executor executor, DriverHandle source,
       state->target_transaction,
       internal::AcquireOpenTransactionPtrOrError(target.transaction));
   state->alignment_options = options.alignment_options;
+  state->bytes_limit = options.bytes_limit.value;
   state->commit_state->progress_function = std::move(options.progress_function);
   auto copy_pair = PromiseFuturePair<void>::Make(MakeResult());
   PromiseFuturePair<void> commit_pair;
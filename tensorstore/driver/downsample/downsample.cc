@@ -37,6 +37,7 @@
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/driver/downsample/downsample_kernels.h"
 #include "tensorstore/driver/downsample/downsample_method_json_binder.h"  // IWYU pragma: keep
 #include "tensorstore/driver/downsample/downsample_nditerable.h"
 #include "tensorstore/driver/downsample/downsample_util.h"
@@ -59,6 +60,7 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
 #include "tensorstore/internal/lock_collection.h"
+#include "tensorstore/internal/nditerable_array.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/json_serialization_options.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -680,6 +682,12 @@ struct BufferedReadChunkImpl {
     // The domain of `propagated.transform`, when downsampled by
     // `propagated.input_downsample_factors`, matches
     // `chunk_transform.domain()`.
+    const DownsampleMethod method = state_->self_->downsample_method_;
+    if (auto iterable = TryDownsampleWithKernel(
+            propagated.transform, propagated.input_downsample_factors,
+            method, chunk_transform.input_rank(), arena)) {
+      return iterable;
+    }
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto transformed_array,
         MakeTransformedArray(state_->data_buffer_,
@@ -693,9 +701,49 @@ struct BufferedReadChunkImpl {
     // `DownsampleNDIterable`.
     return internal_downsample::DownsampleNDIterable(
         std::move(base_nditerable), transformed_array.domain().box(),
-        propagated.input_downsample_factors, state_->self_->downsample_method_,
+        propagated.input_downsample_factors, method,
         chunk_transform.input_rank(), arena);
   }
+
+  /// Eagerly downsamples the region of `state_->data_buffer_` selected by
+  /// `transform` using a specialized kernel from
+  /// `DownsampleArrayWithKernel`.
+  ///
+  /// Returns `nullptr` if `transform` does not select a strided view of
+  /// `data_buffer_` with `request_rank` dimensions, or if no kernel applies, in
+  /// which case the generic `DownsampleNDIterable` is used instead.
+  NDIterable::Ptr TryDownsampleWithKernel(
+      IndexTransformView<> transform,
+      tensorstore::span<const Index> downsample_factors,
+      DownsampleMethod method, DimensionIndex request_rank,
+      internal::Arena* arena) const {
+    if (transform.input_rank() != request_rank) return {};
+    for (DimensionIndex output_dim = 0; output_dim < transform.output_rank();
+         ++output_dim) {
+      if (transform.output_index_maps()[output_dim].method() ==
+          OutputIndexMethod::array) {
+        return {};
+      }
+    }
+    // Without index array output maps, this returns a view of `data_buffer_`.
+    auto source_result = TransformArray(state_->data_buffer_, transform);
+    if (!source_result.ok()) return {};
+    auto& source = *source_result;
+    if (!internal_downsample::CanDownsampleArrayWithKernel(
+            source, downsample_factors, method)) {
+      return {};
+    }
+    Box<> target_domain(request_rank);
+    internal_downsample::DownsampleBounds(source.domain(), target_domain,
+                                          downsample_factors, method);
+    auto target = tensorstore::AllocateArray(target_domain, c_order,
+                                             default_init, source.dtype());
+    if (!internal_downsample::DownsampleArrayWithKernel(
+            source, target, downsample_factors, method)) {
+      return {};
+    }
+    return internal::GetArrayNDIterable(std::move(target), arena);
+  }
 };
 
 /// Returns an identity transform from `base_domain.rank()` to `request_rank`,
@@ -17,6 +17,7 @@
 #include "absl/status/status.h"
 #include "tensorstore/array.h"
 #include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/downsample/downsample_kernels.h"
 #include "tensorstore/driver/downsample/downsample_nditerable.h"
 #include "tensorstore/driver/downsample/downsample_util.h"
 #include "tensorstore/index.h"
@@ -86,6 +87,10 @@ absl::Status DownsampleArray(OffsetArrayView<const void> source,
         source | tensorstore::AllDims().Stride(downsample_factors), target);
   }
 
+  if (DownsampleArrayWithKernel(source, target, downsample_factors, method)) {
+    return absl::OkStatus();
+  }
+
   internal::DefaultNDIterableArena arena;
   auto base_iterable = GetArrayNDIterable(UnownedToShared(source), arena);
   auto target_iterable = GetArrayNDIterable(UnownedToShared(target), arena);
@@ -28,6 +28,9 @@ namespace internal_downsample {
 
 /// Downsamples `source` and stores the result in `target`.
 ///
+/// Common cases are computed by the specialized kernels of
+/// `DownsampleArrayWithKernel`; all other cases use `DownsampleNDIterable`.
+///
 /// \param source The source array to downsample.
 /// \param target The target array, the bounds must match the downsampled bounds
 ///     of `source`.
@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdint.h>
+
+#include <initializer_list>
 #include <vector>
 
 #include <benchmark/benchmark.h>
 #include "absl/log/absl_check.h"
 #include "absl/random/random.h"
+#include "absl/strings/str_join.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
@@ -24,6 +28,7 @@
 #include "tensorstore/driver/downsample/downsample_nditerable.h"
 #include "tensorstore/driver/downsample/downsample_util.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/data_type_random_generator.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/util/str_cat.h"
@@ -38,6 +43,7 @@ using ::tensorstore::DownsampleMethod;
 using ::tensorstore::Index;
 using ::tensorstore::internal_downsample::DownsampleArray;
 using ::tensorstore::internal_downsample::DownsampleBounds;
+using ::tensorstore::internal_downsample::DownsampleTransformedArray;
 
 void BenchmarkDownsample(::benchmark::State& state, DataType dtype,
                          DownsampleMethod downsample_method,
@@ -66,6 +72,47 @@ void BenchmarkDownsample(::benchmark::State& state, DataType dtype,
   state.SetItemsProcessed(total_elements);
 }
 
+/// Benchmarks downsampling a `block_size^rank` block by per-dimension
+/// `downsample_factors`.
+///
+/// If `use_kernels` is `false`, the specialized kernels used by
+/// `DownsampleArray` for common cases are bypassed, in order to compare them
+/// with the generic implementation.
+void BenchmarkDownsampleFactors(::benchmark::State& state, DataType dtype,
+                                DownsampleMethod downsample_method,
+                                std::vector<Index> downsample_factors,
+                                Index block_size, bool use_kernels) {
+  const DimensionIndex rank = downsample_factors.size();
+  std::vector<Index> block_shape(rank, block_size);
+  absl::BitGen gen;
+  BoxView<> base_domain(block_shape);
+  auto base_array =
+      tensorstore::internal::MakeRandomArray(gen, base_domain, dtype);
+  Box<> downsampled_domain(rank);
+  DownsampleBounds(base_domain, downsampled_domain, downsample_factors,
+                   downsample_method);
+  auto downsampled_array =
+      tensorstore::AllocateArray(downsampled_domain, tensorstore::c_order,
+                                 tensorstore::default_init, dtype);
+  const Index num_elements = base_domain.num_elements();
+  Index total_elements = 0;
+  while (state.KeepRunningBatch(num_elements)) {
+    if (use_kernels) {
+      ABSL_CHECK(DownsampleArray(base_array, downsampled_array,
+                                 downsample_factors, downsample_method)
+                     .ok());
+    } else {
+      ABSL_CHECK(DownsampleTransformedArray(
+                     tensorstore::TransformedArray(base_array),
+                     tensorstore::TransformedArray(downsampled_array),
+                     downsample_factors, downsample_method)
+                     .ok());
+    }
+    total_elements += num_elements;
+  }
+  state.SetItemsProcessed(total_elements);
+}
+
 TENSORSTORE_GLOBAL_INITIALIZER {
   for (const DataType dtype : tensorstore::kDataTypes) {
     for (const DownsampleMethod downsample_method :
@@ -95,6 +142,35 @@ TENSORSTORE_GLOBAL_INITIALIZER {
       }
     }
   }
+
+  // Common downsampling of image and volume data, which is handled by
+  // specialized kernels.
+  for (const DataType dtype : std::initializer_list<DataType>{
+           tensorstore::dtype_v<uint8_t>, tensorstore::dtype_v<uint16_t>,
+           tensorstore::dtype_v<float>}) {
+    for (const DownsampleMethod downsample_method :
+         {DownsampleMethod::kMean, DownsampleMethod::kMin,
+          DownsampleMethod::kMax, DownsampleMethod::kMode}) {
+      for (const std::vector<Index>& downsample_factors :
+           std::vector<std::vector<Index>>{{2, 2, 1}, {2, 2, 2}}) {
+        for (const Index block_size : {64, 128, 256}) {
+          for (const bool use_kernels : {true, false}) {
+            ::benchmark::RegisterBenchmark(
+                tensorstore::StrCat(
+                    "DownsampleFactors_", dtype, "_", downsample_method, "_",
+                    absl::StrJoin(downsample_factors, "x"), "_BlockSize",
+                    block_size, use_kernels ? "_Kernel" : "_Generic")
+                    .c_str(),
+                [=](auto& state) {
+                  BenchmarkDownsampleFactors(state, dtype, downsample_method,
+                                             downsample_factors, block_size,
+                                             use_kernels);
+                });
+          }
+        }
+      }
+    }
+  }
 }
 
 }  // namespace
@@ -0,0 +1,361 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/downsample/downsample_kernels.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/iterate_over_index_range.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+namespace {
+
+/// Maximum number of elements in a downsampling block handled by a kernel.
+constexpr size_t kMaxBlockElements = 8;
+
+/// Reducers compute the output value from the `N` elements of a block.
+///
+/// Each reducer defines an `Accumulator` type, and the member functions:
+///
+///     static Accumulator Initial();
+///     static void Accumulate(Accumulator &acc, T input);
+///     static T Finalize(Accumulator acc);
+///
+/// The elements of each block are accumulated in C order, which matches the
+/// order used by `DownsampleNDIterable` for C order arrays.
+
+template <typename T, size_t N>
+struct MeanReducer {
+  // The sum of `N <= 8` elements fits in an integer twice the width of `T`,
+  // which allows more elements to be processed per vector than the `uint64_t`
+  // accumulator used by the generic implementation.
+  using Accumulator =
+      std::conditional_t<std::is_integral_v<T>,
+                         std::conditional_t<sizeof(T) == 1, uint16_t, uint32_t>,
+                         float>;
+
+  static Accumulator Initial() { return 0; }
+
+  static void Accumulate(Accumulator& acc, T input) { acc += input; }
+
+  static T Finalize(Accumulator acc) {
+    if constexpr (std::is_integral_v<T>) {
+      // Round to nearest value, and round to even in case of a tie.
+      const Accumulator quotient = acc / N;
+      const Accumulator remainder = acc % N;
+      return static_cast<T>(quotient +
+                            (remainder * 2 + (quotient & 1) > N ? 1 : 0));
+    } else {
+      return acc / static_cast<Accumulator>(N);
+    }
+  }
+};
+
+template <typename T, size_t N>
+struct MinReducer {
+  using Accumulator = T;
+
+  static T Initial() {
+    if constexpr (std::is_integral_v<T>) {
+      return std::numeric_limits<T>::max();
+    } else {
+      return std::numeric_limits<T>::infinity();
+    }
+  }
+
+  static void Accumulate(T& acc, T input) { acc = std::min(acc, input); }
+
+  static T Finalize(T acc) { return acc; }
+};
+
+template <typename T, size_t N>
+struct MaxReducer {
+  using Accumulator = T;
+
+  static T Initial() {
+    if constexpr (std::is_integral_v<T>) {
+      return std::numeric_limits<T>::min();
+    } else {
+      return -std::numeric_limits<T>::infinity();
+    }
+  }
+
+  static void Accumulate(T& acc, T input) { acc = std::max(acc, input); }
+
+  static T Finalize(T acc) { return acc; }
+};
+
+template <typename T, size_t N>
+struct ModeReducer {
+  struct Accumulator {
+    T values[N];
+    size_t size;
+  };
+
+  static Accumulator Initial() {
+    Accumulator acc;
+    acc.size = 0;
+    return acc;
+  }
+
+  static void Accumulate(Accumulator& acc, T input) {
+    acc.values[acc.size++] = input;
+  }
+
+  static T Finalize(Accumulator acc) {
+    // Same as the generic implementation: the most frequent value, or the
+    // smallest of the most frequent values in case of a tie.
+    std::sort(acc.values, acc.values + N);
+    size_t most_frequent_index = 0;
+    size_t most_frequent_count = 1;
+    size_t cur_count = 1;
+    for (size_t i = 1; i < N; ++i) {
+      if (acc.values[i] == acc.values[i - 1]) {
+        ++cur_count;
+      } else {
+        if (cur_count > most_frequent_count) {
+          most_frequent_count = cur_count;
+          most_frequent_index = i - 1;
+        }
+        cur_count = 1;
+      }
+    }
+    if (cur_count > most_frequent_count) {
+      most_frequent_index = N - 1;
+    }
+    return acc.values[most_frequent_index];
+  }
+};
+
+/// Computes `n` output elements from `Rows` source rows, where each output
+/// element is computed from `Factor` adjacent elements of each row.
+///
+/// The block shape is a compile-time constant, so that the inner loops are
+/// fully unrolled and the outer loop may be vectorized.
+template <typename Reducer, size_t Rows, size_t Factor, typename T>
+void ReduceRows(const std::array<const T*, Rows>& rows, T* output, Index n) {
+  for (Index x = 0; x < n; ++x) {
+    auto acc = Reducer::Initial();
+    for (size_t r = 0; r < Rows; ++r) {
+      for (size_t f = 0; f < Factor; ++f) {
+        Reducer::Accumulate(acc, rows[r][x * Factor + f]);
+      }
+    }
+    output[x] = Reducer::Finalize(acc);
+  }
+}
+
+/// Parameters of a kernel invocation, computed by
+/// `DownsampleArrayWithKernel`.
+struct KernelParams {
+  const char* source;
+  char* target;
+  span<const Index> source_byte_strides;
+  span<const Index> target_byte_strides;
+  span<const Index> target_shape;
+  span<const Index> downsample_factors;
+
+  /// Byte offsets, relative to the first row of a block, of each source row
+  /// of the block, in C order.
+  std::array<Index, kMaxBlockElements> row_offsets;
+  size_t rows;
+
+  /// Downsample factor of the last dimension.
+  size_t factor;
+};
+
+template <template <typename, size_t> class Reducer, typename T, size_t Rows,
+          size_t Factor>
+void DownsampleBlocks(const KernelParams& p) {
+  const DimensionIndex outer_rank = p.target_shape.size() - 1;
+  const Index inner_size = p.target_shape[outer_rank];
+  IterateOverIndexRange(
+      p.target_shape.first(outer_rank), [&](span<const Index> indices) {
+        const char* source = p.source;
+        char* target = p.target;
+        for (DimensionIndex i = 0; i < outer_rank; ++i) {
+          source +=
+              indices[i] * p.downsample_factors[i] * p.source_byte_strides[i];
+          target += indices[i] * p.target_byte_strides[i];
+        }
+        std::array<const T*, Rows> rows;
+        for (size_t r = 0; r < Rows; ++r) {
+          rows[r] = reinterpret_cast<const T*>(source + p.row_offsets[r]);
+        }
+        ReduceRows<Reducer<T, Rows * Factor>, Rows, Factor>(
+            rows, reinterpret_cast<T*>(target), inner_size);
+      });
+}
+
+template <template <typename, size_t> class Reducer, typename T>
+bool DownsampleWithReducer(const KernelParams& p) {
+  if (p.factor == 2) {
+    switch (p.rows) {
+      case 1:
+        DownsampleBlocks<Reducer, T, 1, 2>(p);
+        return true;
+      case 2:
+        DownsampleBlocks<Reducer, T, 2, 2>(p);
+        return true;
+      case 4:
+        DownsampleBlocks<Reducer, T, 4, 2>(p);
+        return true;
+    }
+  } else {
+    switch (p.rows) {
+      case 2:
+        DownsampleBlocks<Reducer, T, 2, 1>(p);
+        return true;
+      case 4:
+        DownsampleBlocks<Reducer, T, 4, 1>(p);
+        return true;
+      case 8:
+        DownsampleBlocks<Reducer, T, 8, 1>(p);
+        return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool DownsampleWithMethod(const KernelParams& p, DownsampleMethod method) {
+  switch (method) {
+    case DownsampleMethod::kMean:
+      return DownsampleWithReducer<MeanReducer, T>(p);
+    case DownsampleMethod::kMin:
+      return DownsampleWithReducer<MinReducer, T>(p);
+    case DownsampleMethod::kMax:
+      return DownsampleWithReducer<MaxReducer, T>(p);
+    case DownsampleMethod::kMode:
+      return DownsampleWithReducer<ModeReducer, T>(p);
+    default:
+      return false;
+  }
+}
+
+/// Sets `p.rows` and `p.factor` to the block shape used to downsample
+/// `source`, or returns `false` if no kernel applies.
+bool GetKernelBlockShape(OffsetArrayView<const void> source,
+                         span<const Index> downsample_factors,
+                         DownsampleMethod method, KernelParams& p) {
+  switch (source.dtype().id()) {
+    case DataTypeId::uint8_t:
+    case DataTypeId::uint16_t:
+    case DataTypeId::float32_t:
+      break;
+    default:
+      return false;
+  }
+  switch (method) {
+    case DownsampleMethod::kMean:
+    case DownsampleMethod::kMin:
+    case DownsampleMethod::kMax:
+    case DownsampleMethod::kMode:
+      break;
+    default:
+      return false;
+  }
+  const DimensionIndex rank = source.rank();
+  if (rank == 0 || downsample_factors.size() != rank) return false;
+  const DimensionIndex inner_dim = rank - 1;
+  if (source.byte_strides()[inner_dim] != source.dtype().size()) return false;
+  p.rows = 1;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const Index factor = downsample_factors[i];
+    if (factor == 1) continue;
+    if (factor != 2 || source.origin()[i] % 2 != 0 ||
+        source.shape()[i] % 2 != 0) {
+      return false;
+    }
+    if (i != inner_dim) {
+      if (p.rows == kMaxBlockElements) return false;
+      p.rows *= 2;
+    }
+  }
+  p.factor = downsample_factors[inner_dim];
+  return p.rows * p.factor != 1 && p.rows * p.factor <= kMaxBlockElements;
+}
+
+}  // namespace
+
+bool CanDownsampleArrayWithKernel(OffsetArrayView<const void> source,
+                                  span<const Index> downsample_factors,
+                                  DownsampleMethod method) {
+  KernelParams p;
+  return GetKernelBlockShape(source, downsample_factors, method, p);
+}
+
+bool DownsampleArrayWithKernel(OffsetArrayView<const void> source,
+                               OffsetArrayView<void> target,
+                               span<const Index> downsample_factors,
+                               DownsampleMethod method) {
+  assert(source.dtype() == target.dtype());
+  KernelParams p;
+  if (!GetKernelBlockShape(source, downsample_factors, method, p)) {
+    return false;
+  }
+  const DimensionIndex inner_dim = source.rank() - 1;
+  if (target.byte_strides()[inner_dim] != target.dtype().size()) return false;
+
+  // Compute the row offsets in C order, such that the first dimension with a
+  // factor of `2` varies slowest.
+  size_t num_rows = 1;
+  p.row_offsets[0] = 0;
+  for (DimensionIndex i = 0; i < inner_dim; ++i) {
+    if (downsample_factors[i] == 1) continue;
+    for (size_t r = num_rows; r-- > 0;) {
+      p.row_offsets[2 * r] = p.row_offsets[r];
+      p.row_offsets[2 * r + 1] = p.row_offsets[r] + source.byte_strides()[i];
+    }
+    num_rows *= 2;
+  }
+  assert(num_rows == p.rows);
+
+  p.source = static_cast<const char*>(
+      static_cast<const void*>(source.byte_strided_origin_pointer().get()));
+  p.target = static_cast<char*>(
+      static_cast<void*>(target.byte_strided_origin_pointer().get()));
+  p.source_byte_strides = source.byte_strides();
+  p.target_byte_strides = target.byte_strides();
+  p.target_shape = target.shape();
+  p.downsample_factors = downsample_factors;
+
+  switch (source.dtype().id()) {
+    case DataTypeId::uint8_t:
+      return DownsampleWithMethod<uint8_t>(p, method);
+    case DataTypeId::uint16_t:
+      return DownsampleWithMethod<uint16_t>(p, method);
+    case DataTypeId::float32_t:
+      return DownsampleWithMethod<float>(p, method);
+    default:
+      return false;
+  }
+}
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
@@ -0,0 +1,75 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_KERNELS_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_KERNELS_H_
+
+#include "tensorstore/array.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+/// Downsamples `source` and stores the result in `target` using a specialized
+/// kernel, if one applies.
+///
+/// Kernels are provided for the common case of downsampling `uint8`, `uint16`
+/// or `float32` data by a factor of `2` along up to three dimensions (e.g.
+/// `2x2x1` or `2x2x2`) with `DownsampleMethod::kMean`, `kMin`, `kMax`, or
+/// `kMode`.  They apply only if:
+///
+/// - every downsample factor is `1` or `2`, and the product of the factors is
+///   between `2` and `8`;
+///
+/// - the bounds of `source` are aligned to the downsample factors, such that
+///   every downsampled element is computed from a complete block;
+///
+/// - the last dimension of both `source` and `target` is contiguous.
+///
+/// Each kernel computes the same result as the generic `DownsampleNDIterable`
+/// implementation, but uses loops over a fixed block shape that the compiler
+/// can vectorize.
+///
+/// The kernels are used by `DownsampleArray` and by the downsample driver for
+/// reads served from its buffer of base driver data.  Chunks that the
+/// downsample driver emits directly from base driver chunks (when a base chunk
+/// covers whole downsampled cells) are only available as an `NDIterable`, and
+/// still use the generic `DownsampleNDIterable` implementation.
+///
+/// \param source The source array to downsample.
+/// \param target The target array, the bounds must match the downsampled
+///     bounds of `source`.
+/// \param downsample_factors The downsample factors for each dimension of
+///     `source`.
+/// \param method Downsampling method to use.
+/// \dchecks `source.dtype() == target.dtype()`.
+/// \returns `true` if `target` was computed, or `false` if no kernel applies,
+///     in which case `target` is unmodified.
+bool DownsampleArrayWithKernel(OffsetArrayView<const void> source,
+                               OffsetArrayView<void> target,
+                               span<const Index> downsample_factors,
+                               DownsampleMethod method);
+
+/// Returns `true` if `DownsampleArrayWithKernel` applies to `source`, given a
+/// `target` array whose last dimension is contiguous.
+bool CanDownsampleArrayWithKernel(OffsetArrayView<const void> source,
+                                  span<const Index> downsample_factors,
+                                  DownsampleMethod method);
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_KERNELS_H_
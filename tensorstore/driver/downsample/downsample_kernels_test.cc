@@ -0,0 +1,157 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/downsample/downsample_kernels.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/random/bit_gen_ref.h"
+#include "absl/random/random.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::BoxView;
+using ::tensorstore::DownsampleMethod;
+using ::tensorstore::Index;
+using ::tensorstore::MakeArray;
+using ::tensorstore::SharedOffsetArray;
+using ::tensorstore::span;
+using ::tensorstore::internal_downsample::DownsampleArrayWithKernel;
+using ::tensorstore::internal_downsample::DownsampleTransformedArray;
+
+/// Returns a C order array over `domain` with random values in
+/// `[0, max_value]`.
+template <typename T>
+SharedOffsetArray<T> MakeTestArray(absl::BitGenRef gen, BoxView<> domain,
+                                   int max_value) {
+  auto array = tensorstore::AllocateArray<T>(domain);
+  T* data = array.byte_strided_origin_pointer().get();
+  for (Index i = 0; i < domain.num_elements(); ++i) {
+    data[i] = static_cast<T>(absl::Uniform<int>(absl::IntervalClosed, gen, 0,
+                                                max_value));
+  }
+  return array;
+}
+
+/// Checks that the kernels compute the same result as the generic
+/// implementation used by `DownsampleTransformedArray`.
+template <typename T>
+void TestMatchesGeneric(int max_value) {
+  absl::BitGen gen;
+  const std::vector<std::vector<Index>> all_factors = {
+      {2},          {2, 2},       {2, 1},       {1, 2},
+      {2, 2, 1},    {2, 2, 2},    {1, 2, 2},    {2, 1, 2},
+      {1, 2, 1, 2}, {2, 2, 1, 2}, {2, 2, 2, 1},
+  };
+  for (const auto& factors : all_factors) {
+    const size_t rank = factors.size();
+    std::vector<Index> origin(rank), shape(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      origin[i] = (i % 2 == 0) ? -4 : 6;
+      shape[i] = (i + 1 == rank) ? 38 : 2 * (i + 2);
+    }
+    auto source = MakeTestArray<T>(gen, BoxView<>(origin, shape), max_value);
+    for (const auto method :
+         {DownsampleMethod::kMean, DownsampleMethod::kMin,
+          DownsampleMethod::kMax, DownsampleMethod::kMode}) {
+      SCOPED_TRACE(tensorstore::StrCat("factors=", span(factors),
+                                       ", method=", method));
+      auto expected = DownsampleTransformedArray(
+          tensorstore::TransformedArray(source), factors, method);
+      ASSERT_TRUE(expected.ok());
+      auto target = tensorstore::AllocateArray(
+          expected->domain(), tensorstore::c_order, tensorstore::default_init,
+          source.dtype());
+      ASSERT_TRUE(DownsampleArrayWithKernel(source, target, factors, method));
+      EXPECT_EQ(*expected, target);
+    }
+  }
+}
+
+TEST(DownsampleKernelsTest, Uint8) {
+  TestMatchesGeneric<uint8_t>(3);
+  TestMatchesGeneric<uint8_t>(255);
+}
+
+TEST(DownsampleKernelsTest, Uint16) {
+  TestMatchesGeneric<uint16_t>(3);
+  TestMatchesGeneric<uint16_t>(65535);
+}
+
+TEST(DownsampleKernelsTest, Float32) {
+  // Integer values ensure that the mean does not depend on the order of
+  // summation.
+  TestMatchesGeneric<float>(3);
+  TestMatchesGeneric<float>(1000);
+}
+
+TEST(DownsampleKernelsTest, MeanRoundsToEven) {
+  auto source = MakeArray<uint8_t>({{1, 2, 5, 6}, {2, 1, 5, 5}});
+  auto target = tensorstore::AllocateArray<uint8_t>({1, 2});
+  ASSERT_TRUE(DownsampleArrayWithKernel(source, target, {{2, 2}},
+                                        DownsampleMethod::kMean));
+  // 6 / 4 rounds to 2, and 21 / 4 rounds to 5.
+  EXPECT_EQ(MakeArray<uint8_t>({{2, 5}}), target);
+}
+
+TEST(DownsampleKernelsTest, Unsupported) {
+  auto target = tensorstore::AllocateArray<uint8_t>({1, 2});
+  const auto method = DownsampleMethod::kMean;
+  // Downsample factor other than 1 or 2.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({2, 6}), target, {{2, 3}}, method));
+  // No downsampling.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({1, 2}), target, {{1, 1}}, method));
+  // Partial blocks.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({2, 3}), target, {{2, 2}}, method));
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>(BoxView({1, 0}, {2, 4})),
+      tensorstore::AllocateArray<uint8_t>(BoxView({0, 0}, {2, 2})), {{2, 2}},
+      method));
+  // Non-contiguous last dimension.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({2, 4}, tensorstore::fortran_order),
+      target, {{2, 2}}, method));
+  // Unsupported data type.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<int32_t>({2, 4}),
+      tensorstore::AllocateArray<int32_t>({1, 2}), {{2, 2}}, method));
+  // Unsupported method.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({2, 4}), target, {{2, 2}},
+      DownsampleMethod::kMedian));
+  // More than 8 elements per block.
+  EXPECT_FALSE(DownsampleArrayWithKernel(
+      tensorstore::AllocateArray<uint8_t>({2, 2, 2, 4}),
+      tensorstore::AllocateArray<uint8_t>({1, 1, 1, 2}), {{2, 2, 2, 2}},
+      method));
+}
+
+}  // namespace
@@ -0,0 +1,442 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/downsample/downsample_pyramid.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/chunk_cell_scheduler.h"
+#include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/driver/downsample/downsample_nditerable.h"
+#include "tensorstore/driver/downsample/downsample_util.h"
+#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/read.h"
+#include "tensorstore/driver/write.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/read_write_options.h"
+#include "tensorstore/resize_options.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/iterate_over_index_range.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+
+namespace {
+
+/// Downsampled data of a single write chunk of a level, accumulated from the
+/// cells of `base` that contribute to it.
+struct PendingChunk {
+  SharedOffsetArray<void> array;
+
+  /// Number of elements of `array` that have not yet been computed.
+  Index remaining;
+};
+
+/// Write chunk grid of a level, along with the chunks that have been
+/// partially computed.
+///
+/// Each cell of `base` generally contributes only a portion of a write chunk
+/// of the coarser levels.  Writing each portion separately would write back
+/// the chunk once per contributing cell, so instead the portions are
+/// accumulated until the chunk is complete, and then written once.
+struct LevelChunks {
+  /// Downsampled domain of `base`.
+  Box<> domain;
+
+  /// Shape and origin of the write chunk grid.  If empty, the level does not
+  /// have a write chunk grid, and the data is written as it is computed.
+  std::vector<Index> chunk_shape;
+  std::vector<Index> grid_origin;
+
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::vector<Index>, PendingChunk> pending
+      ABSL_GUARDED_BY(mutex);
+
+  /// Initializes the write chunk grid from the chunk layout of the level.
+  void Initialize(const ChunkLayout& layout);
+
+  /// Adds the downsampled data of a cell, and returns the regions that are
+  /// ready to be written.
+  Result<std::vector<TransformedSharedArray<const void>>> Add(
+      SharedOffsetArray<const void> array);
+};
+
+void LevelChunks::Initialize(const ChunkLayout& layout) {
+  const DimensionIndex rank = domain.rank();
+  if (layout.rank() != rank) return;
+  auto layout_chunk_shape = layout.write_chunk_shape();
+  auto layout_grid_origin = layout.grid_origin();
+  bool has_grid = false;
+  chunk_shape.resize(rank);
+  grid_origin.resize(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (layout_chunk_shape[i] > 0 && layout_grid_origin[i] != kImplicit) {
+      chunk_shape[i] = layout_chunk_shape[i];
+      grid_origin[i] = layout_grid_origin[i];
+      has_grid = true;
+    } else {
+      // A single chunk spans the dimension.
+      chunk_shape[i] = std::max(Index(1), domain.shape()[i]);
+      grid_origin[i] = domain.origin()[i];
+    }
+  }
+  if (!has_grid) {
+    chunk_shape.clear();
+    grid_origin.clear();
+  }
+}
+
+Result<std::vector<TransformedSharedArray<const void>>> LevelChunks::Add(
+    SharedOffsetArray<const void> array) {
+  std::vector<TransformedSharedArray<const void>> complete;
+  if (chunk_shape.empty()) {
+    complete.push_back(TransformedArray(std::move(array)));
+    return complete;
+  }
+  if (array.num_elements() == 0) return complete;
+  const DimensionIndex rank = array.rank();
+  Box<> chunk_indices(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const IndexInterval interval = array.domain()[i];
+    chunk_indices[i] = IndexInterval::UncheckedClosed(
+        FloorOfRatio(interval.inclusive_min() - grid_origin[i],
+                     chunk_shape[i]),
+        FloorOfRatio(interval.inclusive_max() - grid_origin[i],
+                     chunk_shape[i]));
+  }
+  absl::Status status;
+  Box<> chunk_box(rank);
+  Box<> overlap(rank);
+  IterateOverIndexRange(chunk_indices, [&](span<const Index> indices) {
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      chunk_box[i] = Intersect(
+          IndexInterval::UncheckedSized(
+              grid_origin[i] + indices[i] * chunk_shape[i], chunk_shape[i]),
+          domain[i]);
+      overlap[i] = Intersect(chunk_box[i], array.domain()[i]);
+    }
+    if (overlap == chunk_box) {
+      // The chunk is computed entirely from this cell.
+      auto region = array | AllDims().BoxSlice(overlap);
+      if (!region.ok()) {
+        status = region.status();
+        return false;
+      }
+      complete.push_back(*std::move(region));
+      return true;
+    }
+    std::vector<Index> key(indices.begin(), indices.end());
+    absl::MutexLock lock(&mutex);
+    auto& chunk = pending[key];
+    if (!chunk.array.valid()) {
+      chunk.array = AllocateArray(chunk_box, c_order, default_init,
+                                  array.dtype());
+      chunk.remaining = chunk_box.num_elements();
+    }
+    status = CopyTransformedArray(array | AllDims().BoxSlice(overlap),
+                                  chunk.array | AllDims().BoxSlice(overlap));
+    if (!status.ok()) return false;
+    chunk.remaining -= overlap.num_elements();
+    if (chunk.remaining == 0) {
+      complete.push_back(TransformedArray(std::move(chunk.array)));
+      pending.erase(key);
+    }
+    return true;
+  });
+  TENSORSTORE_RETURN_IF_ERROR(status);
+  return complete;
+}
+
+/// Local state for the asynchronous operation initiated by
+/// `DriverDownsamplePyramid`.
+///
+/// `DriverDownsamplePyramid` asynchronously performs the following steps:
+///
+/// 1. Resolves the bounds of `base` via `Driver::ResolveBounds`, and then
+///    continues with `PyramidInitiateOp`.
+///
+/// 2. Partitions the resolved domain into cells using `ChunkCellScheduler`,
+///    and calls `StartCells` to read as many cells as `bytes_limit` permits.
+///
+/// 3. Once a cell has been read, `ProcessCell` downsamples it to each level
+///    in turn, and writes the write chunks of each level that are complete,
+///    see `LevelChunks`.
+///
+/// 4. Once the writes of a cell have completed, its bytes are released and
+///    `StartCells` is called again to read the next cells.
+///
+/// 5. Once all cells have been written (or an error occurred, or all
+///    references to the future associated with `promise` were released), all
+///    references to `PyramidState` are released, which causes `promise` to
+///    become ready.
+struct PyramidState : public AtomicReferenceCount<PyramidState> {
+  Executor executor;
+  DriverHandle base;
+  std::vector<DriverHandle> levels;
+  std::vector<LevelChunks> level_chunks;
+  std::vector<std::vector<Index>> downsample_factors;
+  DownsampleMethod downsample_method;
+  Index bytes_limit;
+  Promise<void> promise;
+  ChunkCellScheduler cells;
+
+  void SetError(absl::Status error) {
+    SetDeferredResult(promise, std::move(error));
+    cells.Stop();
+  }
+
+  /// Reads cells until `bytes_limit` is reached.
+  void StartCells();
+
+  /// Downsamples and writes a cell of `base` that has been read.
+  void ProcessCell(SharedOffsetArray<const void> array, Index bytes);
+};
+
+void PyramidState::StartCells() {
+  if (!promise.result_needed()) {
+    cells.Stop();
+    return;
+  }
+  cells.StartCells([&](Box<> cell, Index bytes) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto cell_transform,
+        ComposeTransforms(base.transform, IdentityTransform(cell)),
+        SetError(_));
+    auto read_future = DriverReadIntoNewArray(
+        {base.driver, std::move(cell_transform), base.transaction}, {});
+    read_future.ExecuteWhenReady(WithExecutor(
+        executor, [state = IntrusivePtr<PyramidState>(this),
+                   bytes](ReadyFuture<SharedOffsetArray<void>> future) {
+          auto& result = future.result();
+          if (!result.ok()) {
+            state->SetError(result.status());
+            return;
+          }
+          state->ProcessCell(*result, bytes);
+        }));
+  });
+}
+
+void PyramidState::ProcessCell(SharedOffsetArray<const void> array,
+                               Index bytes) {
+  std::vector<AnyFuture> write_futures;
+  for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        array,
+        internal_downsample::DownsampleArray(
+            array, downsample_factors[level_i], downsample_method),
+        SetError(_));
+    TENSORSTORE_ASSIGN_OR_RETURN(auto regions,
+                                 level_chunks[level_i].Add(array),
+                                 SetError(_));
+    const auto& level = levels[level_i];
+    for (auto& region : regions) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto level_transform,
+          ComposeTransforms(level.transform,
+                            IdentityTransform(region.domain())),
+          SetError(_));
+      auto futures = DriverWrite(
+          executor, std::move(region),
+          {level.driver, std::move(level_transform), level.transaction},
+          DriverWriteOptions{});
+      if (level.transaction != no_transaction) {
+        // The writes are not committed until the transaction is committed.
+        write_futures.push_back(std::move(futures.copy_future));
+      } else {
+        // Wait for the writes to be committed, in order to bound the amount
+        // of data in flight.
+        futures.commit_future.Force();
+        write_futures.push_back(std::move(futures.commit_future));
+      }
+    }
+  }
+  WaitAllFuture(write_futures)
+      .ExecuteWhenReady([state = IntrusivePtr<PyramidState>(this),
+                         bytes](ReadyFuture<void> future) {
+        if (!future.result().ok()) {
+          state->SetError(future.result().status());
+          return;
+        }
+        state->cells.Release(bytes);
+        state->StartCells();
+      });
+}
+
+/// Callback used by `DriverDownsamplePyramid` to start reading the cells once
+/// the bounds of `base` have been resolved.
+struct PyramidInitiateOp {
+  IntrusivePtr<PyramidState> state;
+  void operator()(Promise<void> promise,
+                  ReadyFuture<IndexTransform<>> transform_future) {
+    IndexTransform<> transform = std::move(transform_future.value());
+    if (!IsFinite(transform.domain())) {
+      promise.SetResult(absl::InvalidArgumentError(tensorstore::StrCat(
+          "Downsample pyramid requires a finite domain, got ",
+          transform.domain())));
+      return;
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto base_layout, state->base.driver->GetChunkLayout(transform),
+        static_cast<void>(promise.SetResult(_)));
+
+    // Each cell must be a multiple of the product of the downsample factors
+    // of all levels, such that every block of every level is contained in a
+    // single cell.  Cells are additionally aligned to the base read chunk
+    // shape, when it is known, in order to avoid reading any chunk more than
+    // once.
+    const DimensionIndex rank = transform.input_rank();
+    auto base_chunk_shape = base_layout.read_chunk_shape();
+    std::vector<Index> cell_shape(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      Index total_factor = 1;
+      for (const auto& factors : state->downsample_factors) {
+        if (internal::MulOverflow(total_factor, factors[i], &total_factor)) {
+          promise.SetResult(absl::InvalidArgumentError(tensorstore::StrCat(
+              "Product of downsample factors for dimension ", i,
+              " overflows")));
+          return;
+        }
+      }
+      Index size = base_layout.rank() == rank ? base_chunk_shape[i] : 0;
+      if (size <= 0) size = transform.domain().shape()[i];
+      cell_shape[i] =
+          CeilOfRatio(std::max(Index(1), size), total_factor) * total_factor;
+    }
+    ChunkLayout cell_layout;
+    TENSORSTORE_RETURN_IF_ERROR(
+        cell_layout.Set(ChunkLayout::ReadChunkShape(cell_shape)),
+        static_cast<void>(promise.SetResult(_)));
+    TENSORSTORE_RETURN_IF_ERROR(
+        cell_layout.Set(
+            ChunkLayout::GridOrigin(std::vector<Index>(rank, Index(0)))),
+        static_cast<void>(promise.SetResult(_)));
+
+    // Determine the write chunk grid of each level, within the downsampled
+    // domain of `base`.
+    state->level_chunks = std::vector<LevelChunks>(state->levels.size());
+    Box<> level_domain(transform.domain().box());
+    for (size_t level_i = 0; level_i < state->levels.size(); ++level_i) {
+      auto& chunks = state->level_chunks[level_i];
+      chunks.domain = Box<>(rank);
+      internal_downsample::DownsampleBounds(
+          level_domain, chunks.domain, state->downsample_factors[level_i],
+          state->downsample_method);
+      level_domain = chunks.domain;
+      const auto& level = state->levels[level_i];
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto level_layout, level.driver->GetChunkLayout(level.transform),
+          static_cast<void>(promise.SetResult(_)));
+      chunks.Initialize(level_layout);
+    }
+
+    state->promise = std::move(promise);
+    state->cells.Initialize(transform.domain().box(), cell_layout,
+                            state->base.driver->dtype().size(),
+                            state->bytes_limit);
+    state->base.transform = std::move(transform);
+    state->StartCells();
+  }
+};
+
+}  // namespace
+
+Future<void> DriverDownsamplePyramid(
+    DriverHandle base, std::vector<DriverHandle> levels,
+    std::vector<std::vector<Index>> downsample_factors,
+    DownsampleMethod downsample_method, Index bytes_limit) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(base.driver.read_write_mode()));
+  if (levels.size() != downsample_factors.size()) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Number of levels (", levels.size(),
+        ") does not match number of downsample factors (",
+        downsample_factors.size(), ")"));
+  }
+  const DimensionIndex rank = base.transform.input_rank();
+  for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+    const auto& factors = downsample_factors[level_i];
+    if (factors.size() != rank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Number of downsample factors (", factors.size(), ") for level ",
+          level_i, " does not match TensorStore rank (", rank, ")"));
+    }
+    if (std::any_of(factors.begin(), factors.end(),
+                    [](Index factor) { return factor < 1; })) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Downsample factors ", span(factors),
+                              " for level ", level_i, " are not all positive"));
+    }
+    TENSORSTORE_RETURN_IF_ERROR(internal::ValidateSupportsWrite(
+        levels[level_i].driver.read_write_mode()));
+  }
+  TENSORSTORE_RETURN_IF_ERROR(internal_downsample::ValidateDownsampleMethod(
+      base.driver->dtype(), downsample_method));
+  if (levels.empty()) return MakeResult();
+
+  IntrusivePtr<PyramidState> state(new PyramidState);
+  state->executor = base.driver->data_copy_executor();
+  state->levels = std::move(levels);
+  state->downsample_factors = std::move(downsample_factors);
+  state->downsample_method = downsample_method;
+  state->bytes_limit = bytes_limit;
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+
+  // Resolve the bounds of `base`.
+  Driver::ResolveBoundsRequest request;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      request.transaction,
+      internal::AcquireOpenTransactionPtrOrError(base.transaction));
+  request.transform = std::move(base.transform);
+  request.options.Set(fix_resizable_bounds).IgnoreError();
+  auto transform_future = base.driver->ResolveBounds(std::move(request));
+  state->base = std::move(base);
+
+  // Start reading the cells once the bounds have been resolved.
+  auto executor = state->executor;
+  LinkValue(WithExecutor(std::move(executor),
+                         PyramidInitiateOp{std::move(state)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,67 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_PYRAMID_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_PYRAMID_H_
+
+#include <vector>
+
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Computes the levels of a multi-resolution pyramid from `base` in a single
+/// pass over `base`.
+///
+/// Level `k` is downsampled from level `k - 1` (or from `base`, for `k == 0`)
+/// by `downsample_factors[k]` and written to `levels[k]`.  The result is
+/// identical to that of chaining `MakeDownsampleDriver`, but each element of
+/// `base` is read only once.
+///
+/// The resolved domain of `base.transform` is partitioned into cells whose
+/// shape is a multiple of the product of all downsample factors, such that
+/// every downsampled element of every level is computed from a single cell.
+/// Where possible, the cells are also aligned to the read chunk grid of
+/// `base`.  Each cell is read and downsampled to all levels in memory, while
+/// the total size of the cells in flight does not exceed `bytes_limit` (or
+/// without limit, if `bytes_limit == 0`).  The downsampled data of each level
+/// is accumulated in memory until a write chunk of the level is complete, such
+/// that each write chunk is written only once.
+///
+/// \param base The base data, must support reading.
+/// \param levels The targets for each level, must support writing.  The domain
+///     of each level must contain the downsampled domain of the preceding
+///     level.
+/// \param downsample_factors The downsample factors of each level relative to
+///     the preceding level.
+/// \param downsample_method The downsampling method.
+/// \param bytes_limit Limit on the size of the base data being processed.
+/// \returns A future that becomes ready once all levels have been written
+///     (and, for non-transactional writes, committed), or an error occurs.
+/// \error `absl::StatusCode::kInvalidArgument` if `levels` and
+///     `downsample_factors` differ in size, if any factors are invalid, or if
+///     `downsample_method` is not supported for the data type of `base`.
+Future<void> DriverDownsamplePyramid(
+    DriverHandle base, std::vector<DriverHandle> levels,
+    std::vector<std::vector<Index>> downsample_factors,
+    DownsampleMethod downsample_method, Index bytes_limit);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_PYRAMID_H_
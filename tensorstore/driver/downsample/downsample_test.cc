@@ -152,6 +152,44 @@ TEST(DownsampleTest, Rank1MeanChunked) {
               Optional(MakeArray<uint8_t>({1, 6, 3, 5, 2, 5})));
 }
 
+// Base chunks do not cover whole downsampled cells, so the read is served from
+// the buffer of base driver data, which is downsampled by a specialized kernel.
+TEST(DownsampleTest, Rank2MeanChunkedBuffered) {
+  ::nlohmann::json base_spec{{"driver", "n5"},
+                             {"kvstore", {{"driver", "memory"}}},
+                             {"metadata",
+                              {{"dataType", "uint8"},
+                               {"dimensions", {4, 6}},
+                               {"blockSize", {3, 3}},
+                               {"compression", {{"type", "raw"}}}}}};
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::Open(base_spec, context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(MakeArray<uint8_t>({
+                                               {0, 4, 8, 0, 1, 3},
+                                               {4, 0, 0, 8, 3, 1},
+                                               {2, 2, 5, 5, 9, 9},
+                                               {2, 2, 3, 3, 1, 5},
+                                           }),
+                                           base_store));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store, tensorstore::Open({{"driver", "downsample"},
+                                                 {"base", base_spec},
+                                                 {"downsample_factors", {2, 2}},
+                                                 {"downsample_method", "mean"}},
+                                                context)
+                                  .result());
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({{2, 4, 2}, {2, 4, 6}})));
+  EXPECT_THAT(
+      tensorstore::Read(downsampled_store |
+                        tensorstore::Dims(1).TranslateSizedInterval(1, 2))
+          .result(),
+      Optional(MakeOffsetArray<uint8_t>({0, 1}, {{4, 2}, {4, 6}})));
+}
+
 TEST(DownsampleTest, Rank1MeanChunkedTranslated) {
   ::nlohmann::json base_spec{{"driver", "n5"},
                              {"kvstore", {{"driver", "memory"}}},
@@ -889,4 +927,144 @@ TEST(DownsampleTest, DimensionUnits) {
                   tensorstore::Unit("4nm"), tensorstore::Unit("10nm"))));
 }
 
+/// Returns a `uint16` zarr TensorStore with domain `[1, 12) x [0, 13)` and a
+/// chunk shape of `{3, 4}`, containing distinct values.
+TensorStore<> MakePyramidBaseStore() {
+  auto base_store =
+      tensorstore::Open(
+          {
+              {"driver", "zarr"},
+              {"kvstore", {{"driver", "memory"}}},
+              {"metadata", {{"dtype", "<u2"}, {"chunks", {3, 4}}}},
+          },
+          tensorstore::OpenMode::create, tensorstore::dtype_v<uint16_t>,
+          tensorstore::Schema::Shape({11, 13}))
+          .value();
+  auto array = tensorstore::AllocateArray<uint16_t>({11, 13});
+  for (Index i = 0; i < 11; ++i) {
+    for (Index j = 0; j < 13; ++j) {
+      array(i, j) = static_cast<uint16_t>(i * 13 + j * j);
+    }
+  }
+  TENSORSTORE_CHECK_OK(tensorstore::Write(array, base_store).result());
+  return (base_store | tensorstore::Dims(0).TranslateBy(1)).value();
+}
+
+TEST(DownsamplePyramidTest, MatchesChainedDownsample) {
+  auto base_store = MakePyramidBaseStore();
+  const std::vector<std::vector<Index>> downsample_factors = {
+      {2, 2}, {2, 3}, {1, 2}};
+  for (const auto method : {DownsampleMethod::kMean, DownsampleMethod::kMode,
+                            DownsampleMethod::kStride}) {
+    SCOPED_TRACE(tensorstore::StrCat("method=", method));
+    std::vector<TensorStore<>> chained_levels;
+    std::vector<TensorStore<>> levels;
+    TensorStore<> prev_level = base_store;
+    for (const auto& factors : downsample_factors) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto chained_level,
+          tensorstore::Downsample(prev_level, factors, method));
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto level, tensorstore::FromArray(tensorstore::AllocateArray(
+                          chained_level.domain().box(), tensorstore::c_order,
+                          tensorstore::value_init, chained_level.dtype())));
+      chained_levels.push_back(chained_level);
+      levels.push_back(level);
+      prev_level = chained_level;
+    }
+    tensorstore::DownsamplePyramidOptions options;
+    // Process a single cell at a time.
+    options.bytes_limit = 1;
+    TENSORSTORE_ASSERT_OK(tensorstore::DownsamplePyramid(
+                              base_store, levels, downsample_factors, method,
+                              options)
+                              .result());
+    for (size_t i = 0; i < levels.size(); ++i) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto expected, tensorstore::Read(chained_levels[i]).result());
+      EXPECT_THAT(tensorstore::Read(levels[i]).result(), Optional(expected))
+          << "level=" << i;
+    }
+  }
+}
+
+TEST(DownsamplePyramidTest, ChunkedLevels) {
+  auto base_store = MakePyramidBaseStore();
+  const std::vector<std::vector<Index>> downsample_factors = {{2, 2}, {2, 3}};
+  std::vector<TensorStore<>> chained_levels;
+  std::vector<TensorStore<>> levels;
+  TensorStore<> prev_level = base_store;
+  for (const auto& factors : downsample_factors) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto chained_level,
+        tensorstore::Downsample(prev_level, factors, DownsampleMethod::kMean));
+    // The domain of each level has an origin of zero, and the write chunks of
+    // each level span multiple cells of the base.
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto level,
+        tensorstore::Open(
+            {
+                {"driver", "zarr"},
+                {"kvstore", {{"driver", "memory"}}},
+                {"metadata", {{"dtype", "<u2"}, {"chunks", {5, 5}}}},
+            },
+            tensorstore::OpenMode::create, tensorstore::dtype_v<uint16_t>,
+            tensorstore::Schema::Shape(chained_level.domain().shape()))
+            .result());
+    chained_levels.push_back(chained_level);
+    levels.push_back(level);
+    prev_level = chained_level;
+  }
+  tensorstore::DownsamplePyramidOptions options;
+  options.bytes_limit = 1;
+  TENSORSTORE_ASSERT_OK(tensorstore::DownsamplePyramid(
+                            base_store, levels, downsample_factors,
+                            DownsampleMethod::kMean, options)
+                            .result());
+  for (size_t i = 0; i < levels.size(); ++i) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto expected, tensorstore::Read(chained_levels[i]).result());
+    EXPECT_THAT(tensorstore::Read(levels[i]).result(), Optional(expected))
+        << "level=" << i;
+  }
+}
+
+TEST(DownsamplePyramidTest, LevelDomainTooSmall) {
+  auto base_store = MakePyramidBaseStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto level, tensorstore::FromArray(
+                      tensorstore::AllocateArray<uint16_t>({2, 2})));
+  const std::vector<TensorStore<>> levels = {level};
+  const std::vector<std::vector<Index>> downsample_factors = {{2, 2}};
+  EXPECT_THAT(tensorstore::DownsamplePyramid(base_store, levels,
+                                             downsample_factors,
+                                             DownsampleMethod::kMean)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
+TEST(DownsamplePyramidTest, InvalidFactors) {
+  auto base_store = MakePyramidBaseStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto level, tensorstore::FromArray(
+                      tensorstore::AllocateArray<uint16_t>({6, 7})));
+  const std::vector<TensorStore<>> levels = {level};
+  EXPECT_THAT(
+      tensorstore::DownsamplePyramid(base_store, levels,
+                                     std::vector<std::vector<Index>>{},
+                                     DownsampleMethod::kMean)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Number of levels \\(1\\) does not match number of "
+                    "downsample factors \\(0\\)"));
+  EXPECT_THAT(
+      tensorstore::DownsamplePyramid(base_store, levels,
+                                     std::vector<std::vector<Index>>{{2}},
+                                     DownsampleMethod::kMean)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Number of downsample factors \\(1\\) for level 0 "
+                    "does not match TensorStore rank \\(2\\)"));
+}
+
 }  // namespace
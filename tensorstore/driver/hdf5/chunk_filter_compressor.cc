@@ -0,0 +1,147 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/endian.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+/// Buffers the decoded chunk, and encodes it to the base writer when closed.
+class ChunkFilterWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  explicit ChunkFilterWriter(
+      internal::IntrusivePtr<const ChunkFilterCompressor> filter,
+      riegeli::Writer& base_writer, size_t element_bytes)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        filter_(std::move(filter)),
+        base_writer_(base_writer),
+        element_bytes_(element_bytes) {}
+
+  void Done() override {
+    CordWriter::Done();
+    if (auto status = filter_->EncodeChunk(dest(), base_writer_,
+                                           element_bytes_);
+        !status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+    if (!base_writer_.Close()) {
+      Fail(base_writer_.status());
+    }
+  }
+
+ private:
+  internal::IntrusivePtr<const ChunkFilterCompressor> filter_;
+  riegeli::Writer& base_writer_;
+  size_t element_bytes_;
+};
+
+}  // namespace
+
+std::unique_ptr<riegeli::Writer> ChunkFilterCompressor::GetWriter(
+    riegeli::Writer& base_writer, size_t element_bytes) const {
+  return std::make_unique<ChunkFilterWriter>(
+      internal::IntrusivePtr<const ChunkFilterCompressor>(this), base_writer,
+      element_bytes);
+}
+
+std::unique_ptr<riegeli::Reader> ChunkFilterCompressor::GetReader(
+    riegeli::Reader& base_reader, size_t element_bytes) const {
+  auto decoded = DecodeChunk(base_reader, element_bytes);
+  auto reader = std::make_unique<riegeli::CordReader<absl::Cord>>(
+      decoded.ok() ? *std::move(decoded) : absl::Cord());
+  if (!decoded.ok()) reader->Fail(std::move(decoded).status());
+  return reader;
+}
+
+bool PackedBitWriter::Write(uint64_t value, int bits) {
+  if (bits > 56) {
+    // Split such that `buffer_` cannot overflow.
+    return Write(value >> 32, bits - 32) && Write(value, 32);
+  }
+  buffer_ = (buffer_ << bits) | (value & LowBitMask(bits));
+  buffered_bits_ += bits;
+  while (buffered_bits_ >= 8) {
+    buffered_bits_ -= 8;
+    if (!writer_.WriteByte(static_cast<uint8_t>(buffer_ >> buffered_bits_))) {
+      return false;
+    }
+  }
+  buffer_ &= LowBitMask(buffered_bits_);
+  return true;
+}
+
+bool PackedBitWriter::Flush() {
+  if (buffered_bits_ == 0) return true;
+  const uint8_t byte = static_cast<uint8_t>(buffer_ << (8 - buffered_bits_));
+  buffer_ = 0;
+  buffered_bits_ = 0;
+  return writer_.WriteByte(byte);
+}
+
+bool PackedBitReader::Read(int bits, uint64_t& value) {
+  if (bits > 56) {
+    uint64_t high, low;
+    if (!Read(bits - 32, high) || !Read(32, low)) return false;
+    value = (high << 32) | low;
+    return true;
+  }
+  while (buffered_bits_ < bits) {
+    uint8_t byte;
+    if (!reader_.ReadByte(byte)) return false;
+    buffer_ = (buffer_ << 8) | byte;
+    buffered_bits_ += 8;
+  }
+  buffered_bits_ -= bits;
+  value = (buffer_ >> buffered_bits_) & LowBitMask(bits);
+  buffer_ &= LowBitMask(buffered_bits_);
+  return true;
+}
+
+uint64_t LoadUnsigned(const char* data, size_t size, endian order) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const size_t byte_index = order == endian::little ? size - 1 - i : i;
+    value = (value << 8) | static_cast<uint8_t>(data[byte_index]);
+  }
+  return value;
+}
+
+void StoreUnsigned(uint64_t value, char* data, size_t size, endian order) {
+  for (size_t i = 0; i < size; ++i) {
+    const size_t byte_index = order == endian::little ? i : size - 1 - i;
+    data[byte_index] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,117 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_CHUNK_FILTER_COMPRESSOR_H_
+#define TENSORSTORE_DRIVER_HDF5_CHUNK_FILTER_COMPRESSOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/internal/compression/json_specified_compressor.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Base class for HDF5 filters that transform an entire chunk at once, such as
+/// filters that rearrange the bytes of the chunk or append a checksum.
+///
+/// Decoding consumes the encoded chunk directly from the base reader, which
+/// avoids flattening the (possibly fragmented) encoded `absl::Cord`.  Encoding
+/// buffers the decoded chunk, as `riegeli::CordWriter` does.
+class ChunkFilterCompressor : public internal::JsonSpecifiedCompressor {
+ public:
+  /// Decodes the entire chunk from `reader`.
+  ///
+  /// \param reader Reader positioned at the start of the encoded chunk.
+  /// \param element_bytes Size in bytes of a single array element.
+  virtual Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                         size_t element_bytes) const = 0;
+
+  /// Encodes the entire chunk `input` to `writer`.
+  ///
+  /// \param input The decoded chunk.
+  /// \param writer Writer to which the encoded chunk is written.  Must not be
+  ///     closed.
+  /// \param element_bytes Size in bytes of a single array element.
+  virtual absl::Status EncodeChunk(const absl::Cord& input,
+                                   riegeli::Writer& writer,
+                                   size_t element_bytes) const = 0;
+
+  std::unique_ptr<riegeli::Writer> GetWriter(
+      riegeli::Writer& base_writer, size_t element_bytes) const final;
+
+  std::unique_ptr<riegeli::Reader> GetReader(
+      riegeli::Reader& base_reader, size_t element_bytes) const final;
+};
+
+/// Writes a stream of unsigned integers of at most 64 bits each, with the bits
+/// of each value written from most to least significant, filling each byte
+/// starting from its most significant bit.
+///
+/// This is the bit packing used by the nbit and scaleoffset filters.
+class PackedBitWriter {
+ public:
+  explicit PackedBitWriter(riegeli::Writer& writer) : writer_(writer) {}
+
+  /// Writes the low `bits` bits of `value`.
+  bool Write(uint64_t value, int bits);
+
+  /// Writes the final partial byte, if any, padded with zero bits.
+  bool Flush();
+
+ private:
+  riegeli::Writer& writer_;
+  uint64_t buffer_ = 0;
+  int buffered_bits_ = 0;
+};
+
+/// Reads a stream written by `PackedBitWriter`.
+class PackedBitReader {
+ public:
+  explicit PackedBitReader(riegeli::Reader& reader) : reader_(reader) {}
+
+  /// Reads a value of `bits` bits.
+  bool Read(int bits, uint64_t& value);
+
+ private:
+  riegeli::Reader& reader_;
+  uint64_t buffer_ = 0;
+  int buffered_bits_ = 0;
+};
+
+/// Returns the unsigned integer of `size <= 8` bytes stored at `data` in the
+/// specified byte `order`.
+uint64_t LoadUnsigned(const char* data, size_t size, endian order);
+
+/// Stores the low `size <= 8` bytes of `value` at `data` in the specified byte
+/// `order`.
+void StoreUnsigned(uint64_t value, char* data, size_t size, endian order);
+
+/// Returns a mask of the low `bits <= 64` bits.
+constexpr uint64_t LowBitMask(int bits) {
+  return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_CHUNK_FILTER_COMPRESSOR_H_
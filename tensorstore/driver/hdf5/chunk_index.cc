@@ -0,0 +1,607 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_index.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/endian/endian_reading.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+/// Node type of v1 B-trees that index raw data chunks.
+constexpr uint8_t kBtreeV1ChunkNodeType = 1;
+
+uint64_t GetBtreeV1ChunkKeySize(DimensionIndex rank) {
+  return 4 + 4 + 8 * static_cast<uint64_t>(rank + 1);
+}
+
+bool ReadBtreeV1ChunkKey(riegeli::Reader& reader, DimensionIndex rank,
+                         BtreeV1ChunkKey& key) {
+  if (!riegeli::ReadLittleEndian<uint32_t>(reader, key.chunk_size) ||
+      !riegeli::ReadLittleEndian<uint32_t>(reader, key.filter_mask)) {
+    return false;
+  }
+  key.offsets.resize(rank + 1);
+  for (auto& offset : key.offsets) {
+    if (!riegeli::ReadLittleEndian<uint64_t>(reader, offset)) return false;
+  }
+  return true;
+}
+
+void AppendBtreeV1ChunkKey(std::string& out, const BtreeV1ChunkKey& key,
+                           DimensionIndex rank) {
+  assert(key.offsets.size() == rank + 1);
+  AppendUnsignedInteger(out, 4, key.chunk_size);
+  AppendUnsignedInteger(out, 4, key.filter_mask);
+  for (uint64_t offset : key.offsets) {
+    AppendUnsignedInteger(out, 8, offset);
+  }
+}
+
+bool CompareOffsets(span<const uint64_t> a, span<const uint64_t> b) {
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+}  // namespace
+
+uint64_t GetBtreeV1ChunkNodeSize(const FormatParameters& params,
+                                 DimensionIndex rank) {
+  const uint64_t max_children =
+      2 * static_cast<uint64_t>(params.indexed_storage_k);
+  return 4 + 1 + 1 + 2 + 2 * params.size_of_offsets +
+         max_children * params.size_of_offsets +
+         (max_children + 1) * GetBtreeV1ChunkKeySize(rank);
+}
+
+Result<BtreeV1ChunkNode> DecodeBtreeV1ChunkNode(const absl::Cord& encoded,
+                                                const FormatParameters& params,
+                                                DimensionIndex rank) {
+  BtreeV1ChunkNode node;
+  riegeli::CordReader<const absl::Cord*> reader(&encoded);
+  const auto decode = [&]() -> bool {
+    if (!ReadSignature(reader, "TREE")) return false;
+    uint8_t node_type;
+    if (!reader.ReadByte(node_type)) return false;
+    if (node_type != kBtreeV1ChunkNodeType) {
+      return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+          "Expected B-tree node type ", kBtreeV1ChunkNodeType, " but received ",
+          node_type)));
+    }
+    uint16_t entries_used;
+    if (!reader.ReadByte(node.level) ||
+        !riegeli::ReadLittleEndian<uint16_t>(reader, entries_used)) {
+      return false;
+    }
+    if (entries_used > 2 * params.indexed_storage_k) {
+      return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+          "B-tree node has ", entries_used,
+          " entries, but at most 2*K=", 2 * params.indexed_storage_k,
+          " are permitted")));
+    }
+    if (!ReadAddress(reader, params, node.left_sibling) ||
+        !ReadAddress(reader, params, node.right_sibling)) {
+      return false;
+    }
+    node.children.resize(entries_used);
+    node.keys.resize(entries_used + 1);
+    for (uint16_t i = 0; i < entries_used; ++i) {
+      if (!ReadBtreeV1ChunkKey(reader, rank, node.keys[i]) ||
+          !ReadAddress(reader, params, node.children[i])) {
+        return false;
+      }
+    }
+    return ReadBtreeV1ChunkKey(reader, rank, node.keys[entries_used]);
+  };
+  if (!decode()) {
+    absl::Status status = reader.status();
+    if (status.ok()) {
+      status = absl::DataLossError("Unexpected end of B-tree node");
+    }
+    return tensorstore::MaybeAnnotateStatus(
+        status, "Error decoding HDF5 chunk B-tree node");
+  }
+  return node;
+}
+
+absl::Cord EncodeBtreeV1ChunkNode(const BtreeV1ChunkNode& node,
+                                  const FormatParameters& params,
+                                  DimensionIndex rank) {
+  assert(node.keys.size() == node.children.size() + 1);
+  assert(node.children.size() <= 2 * params.indexed_storage_k);
+  std::string out = "TREE";
+  out.push_back(static_cast<char>(kBtreeV1ChunkNodeType));
+  out.push_back(static_cast<char>(node.level));
+  AppendUnsignedInteger(out, 2, node.children.size());
+  AppendAddress(out, params, node.left_sibling);
+  AppendAddress(out, params, node.right_sibling);
+  for (size_t i = 0; i < node.children.size(); ++i) {
+    AppendBtreeV1ChunkKey(out, node.keys[i], rank);
+    AppendAddress(out, params, node.children[i]);
+  }
+  AppendBtreeV1ChunkKey(out, node.keys.back(), rank);
+  out.resize(GetBtreeV1ChunkNodeSize(params, rank));
+  return absl::Cord(std::move(out));
+}
+
+ptrdiff_t FindBtreeV1Child(const BtreeV1ChunkNode& node,
+                           span<const uint64_t> offsets) {
+  // Keys are sorted; find the last child whose lower bound is `<= offsets`.
+  auto it = std::upper_bound(
+      node.keys.begin(), node.keys.begin() + node.children.size(), offsets,
+      [](span<const uint64_t> a, const BtreeV1ChunkKey& b) {
+        return CompareOffsets(a, b.offsets);
+      });
+  return (it - node.keys.begin()) - 1;
+}
+
+namespace {
+
+/// Verifies the size, signature, version and checksum of the first
+/// `encoded_size` bytes of `encoded`, which must contain a checksummed
+/// metadata structure.
+absl::Status ValidateStructure(std::string_view encoded, uint64_t encoded_size,
+                               std::string_view signature) {
+  if (encoded.size() < encoded_size) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Expected ", encoded_size, " bytes for ", signature,
+        " structure but received ", encoded.size()));
+  }
+  if (encoded.substr(0, 4) != signature) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Expected signature ", tensorstore::QuoteString(signature),
+        " but received ", tensorstore::QuoteString(encoded.substr(0, 4))));
+  }
+  if (encoded[4] != 0) {
+    return absl::DataLossError(
+        tensorstore::StrCat("Unsupported ", signature, " structure version ",
+                            static_cast<int>(encoded[4])));
+  }
+  return ValidateChecksum(encoded.substr(0, encoded_size));
+}
+
+/// Returns the number of bytes HDF5 uses to encode values up to `limit`.
+uint8_t GetLimitEncodedSize(uint64_t limit) {
+  int bits = 0;
+  while (limit >>= 1) ++bits;
+  return static_cast<uint8_t>(bits / 8 + 1);
+}
+
+absl::Status ValidateArrayElementSize(uint8_t client_id, uint8_t element_size,
+                                      const FormatParameters& params) {
+  const bool valid =
+      client_id == kArrayUnfilteredChunkClientId
+          ? element_size == params.size_of_offsets
+          : (client_id == kArrayFilteredChunkClientId &&
+             element_size > params.size_of_offsets + 4 &&
+             element_size <= params.size_of_offsets + 4 + 8);
+  if (!valid) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Invalid element size ", element_size, " for array client ",
+        client_id));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+uint64_t ChunkIndexParameters::GetUnfilteredChunkSize() const {
+  uint64_t size = element_size;
+  for (Index extent : chunk_shape) size *= static_cast<uint64_t>(extent);
+  return size;
+}
+
+std::vector<Index> GetVirtualChunkShape(LayoutClass layout_class,
+                                        span<const Index> shape,
+                                        uint64_t element_size) {
+  std::vector<Index> chunk_shape(shape.begin(), shape.end());
+  for (auto& extent : chunk_shape) extent = std::max(Index(1), extent);
+  if (layout_class != LayoutClass::kContiguous || chunk_shape.empty()) {
+    return chunk_shape;
+  }
+  uint64_t row_size = std::max(uint64_t{1}, element_size);
+  for (size_t i = 1; i < chunk_shape.size(); ++i) {
+    row_size *= static_cast<uint64_t>(chunk_shape[i]);
+  }
+  const uint64_t rows =
+      std::max(uint64_t{1}, kContiguousVirtualChunkSize / row_size);
+  chunk_shape[0] = static_cast<Index>(
+      std::min(rows, static_cast<uint64_t>(chunk_shape[0])));
+  return chunk_shape;
+}
+
+ChunkIndexEntry GetContiguousChunkEntry(const ChunkIndexParameters& params,
+                                        span<const Index> cell_indices) {
+  const auto& layout = params.layout;
+  assert(layout.layout_class == LayoutClass::kContiguous);
+  if (layout.address == kUndefinedAddress) return ChunkIndexEntry::Missing();
+  const Index cell = cell_indices.empty() ? 0 : cell_indices[0];
+  if (cell < 0) return ChunkIndexEntry::Missing();
+  for (size_t i = 1; i < cell_indices.size(); ++i) {
+    if (cell_indices[i] != 0) return ChunkIndexEntry::Missing();
+  }
+  const uint64_t chunk_size = params.GetUnfilteredChunkSize();
+  uint64_t offset;
+  if (internal::MulOverflow(static_cast<uint64_t>(cell), chunk_size,
+                            &offset) ||
+      offset >= layout.size) {
+    return ChunkIndexEntry::Missing();
+  }
+  ChunkIndexEntry entry;
+  entry.address = layout.address + offset;
+  entry.size = std::min(chunk_size, layout.size - offset);
+  return entry;
+}
+
+namespace {
+
+/// Returns the order of the dimensions in the linear chunk order, from
+/// outermost to innermost, see `GetLinearChunkIndex`.
+std::vector<DimensionIndex> GetLinearChunkOrder(
+    const ChunkIndexParameters& params, span<const Index> max_shape) {
+  const DimensionIndex rank = params.rank();
+  std::vector<DimensionIndex> order(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) order[i] = i;
+  if (params.layout.chunk_index_type == ChunkIndexType::kExtensibleArray) {
+    auto it = std::find_if(order.begin(), order.end(), [&](DimensionIndex i) {
+      return max_shape[i] == kInfSize;
+    });
+    if (it != order.end()) std::rotate(order.begin(), it, it + 1);
+  }
+  return order;
+}
+
+}  // namespace
+
+Index GetLinearChunkIndex(const ChunkIndexParameters& params,
+                          span<const Index> cell_indices) {
+  const DimensionIndex rank = params.rank();
+  assert(cell_indices.size() == rank);
+  const auto& max_shape = params.max_shape.empty() ? params.shape
+                                                   : params.max_shape;
+  const auto order = GetLinearChunkOrder(params, max_shape);
+  Index linear_index = 0;
+  for (DimensionIndex k = 0; k < rank; ++k) {
+    const DimensionIndex i = order[k];
+    const Index cell = cell_indices[i];
+    if (cell < 0) return -1;
+    if (max_shape[i] == kInfSize) {
+      // Only the leading dimension may be unbounded.
+      if (k != 0) return -1;
+      linear_index = cell;
+      continue;
+    }
+    const Index grid_extent = CeilOfRatio(max_shape[i], params.chunk_shape[i]);
+    if (cell >= grid_extent ||
+        internal::MulOverflow(linear_index, grid_extent, &linear_index) ||
+        internal::AddOverflow(linear_index, cell, &linear_index)) {
+      return -1;
+    }
+  }
+  return linear_index;
+}
+
+bool GetChunkCellIndices(const ChunkIndexParameters& params,
+                         Index linear_index, span<Index> cell_indices) {
+  const DimensionIndex rank = params.rank();
+  assert(cell_indices.size() == rank);
+  if (linear_index < 0) return false;
+  const auto& max_shape = params.max_shape.empty() ? params.shape
+                                                   : params.max_shape;
+  const auto order = GetLinearChunkOrder(params, max_shape);
+  for (DimensionIndex k = rank; k-- > 0;) {
+    const DimensionIndex i = order[k];
+    if (max_shape[i] == kInfSize) {
+      if (k != 0) return false;
+      cell_indices[i] = linear_index;
+      linear_index = 0;
+      continue;
+    }
+    const Index grid_extent = CeilOfRatio(max_shape[i], params.chunk_shape[i]);
+    if (grid_extent <= 0) return false;
+    cell_indices[i] = linear_index % grid_extent;
+    linear_index /= grid_extent;
+  }
+  return linear_index == 0;
+}
+
+uint64_t GetBtreeV2HeaderSize(const FormatParameters& params) {
+  return 4 + 1 + 1 + 4 + 2 + 2 + 1 + 1 + params.size_of_offsets + 2 +
+         params.size_of_lengths + 4;
+}
+
+Result<BtreeV2Header> DecodeBtreeV2Header(std::string_view encoded,
+                                          const FormatParameters& params) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      ValidateStructure(encoded, GetBtreeV2HeaderSize(params), "BTHD"),
+      tensorstore::MaybeAnnotateStatus(_, "Error decoding HDF5 B-tree header"));
+  const char* p = encoded.data();
+  BtreeV2Header header;
+  header.record_type = static_cast<uint8_t>(p[5]);
+  header.node_size = static_cast<uint32_t>(LoadUnsignedInteger(p + 6, 4));
+  header.record_size = static_cast<uint16_t>(LoadUnsignedInteger(p + 10, 2));
+  header.depth = static_cast<uint16_t>(LoadUnsignedInteger(p + 12, 2));
+  p += 16;
+  header.root_address = LoadAddress(p, params);
+  p += params.size_of_offsets;
+  header.root_num_records = static_cast<uint16_t>(LoadUnsignedInteger(p, 2));
+  header.total_num_records =
+      LoadUnsignedInteger(p + 2, params.size_of_lengths);
+  return header;
+}
+
+uint64_t BtreeV2NodeLayout::GetChildPointerSize(const FormatParameters& params,
+                                                uint16_t depth) const {
+  assert(depth > 0);
+  return params.size_of_offsets + num_records_size +
+         total_num_records_size[depth - 1];
+}
+
+Result<BtreeV2NodeLayout> GetBtreeV2NodeLayout(const BtreeV2Header& header,
+                                               const FormatParameters& params) {
+  // Size of the signature, version, type and checksum.
+  constexpr uint64_t kPrefixSize = 4 + 1 + 1 + 4;
+  BtreeV2NodeLayout layout;
+  if (header.record_size == 0 ||
+      header.node_size < kPrefixSize + header.record_size) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Invalid HDF5 B-tree node size ", header.node_size,
+        " for record size ", header.record_size));
+  }
+  layout.max_num_records.resize(header.depth + 1);
+  layout.total_num_records_size.resize(header.depth + 1);
+  layout.max_num_records[0] =
+      (header.node_size - kPrefixSize) / header.record_size;
+  layout.num_records_size = GetLimitEncodedSize(layout.max_num_records[0]);
+  uint64_t cumulative_max_num_records = layout.max_num_records[0];
+  for (uint16_t depth = 1; depth <= header.depth; ++depth) {
+    const uint64_t pointer_size = layout.GetChildPointerSize(params, depth);
+    if (header.node_size < kPrefixSize + pointer_size) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "HDF5 B-tree node size ", header.node_size,
+          " is too small for depth ", header.depth));
+    }
+    const uint64_t max_num_records =
+        (header.node_size - (kPrefixSize + pointer_size)) /
+        (header.record_size + pointer_size);
+    layout.max_num_records[depth] = max_num_records;
+    if (internal::MulOverflow(cumulative_max_num_records, max_num_records + 1,
+                              &cumulative_max_num_records) ||
+        internal::AddOverflow(cumulative_max_num_records, max_num_records,
+                              &cumulative_max_num_records)) {
+      cumulative_max_num_records = ~uint64_t(0);
+    }
+    layout.total_num_records_size[depth] =
+        GetLimitEncodedSize(cumulative_max_num_records);
+  }
+  return layout;
+}
+
+uint64_t GetBtreeV2NodeSize(const BtreeV2Header& header,
+                            const BtreeV2NodeLayout& layout,
+                            const FormatParameters& params, uint16_t depth,
+                            uint64_t num_records) {
+  uint64_t size = 4 + 1 + 1 + num_records * header.record_size + 4;
+  if (depth > 0) {
+    size += (num_records + 1) * layout.GetChildPointerSize(params, depth);
+  }
+  return size;
+}
+
+Result<BtreeV2ChunkNode> DecodeBtreeV2ChunkNode(
+    std::string_view encoded, const BtreeV2Header& header,
+    const BtreeV2NodeLayout& layout, const ChunkIndexParameters& params,
+    uint16_t depth, uint64_t num_records) {
+  const auto& format = params.format;
+  const DimensionIndex rank = params.rank();
+  const auto decode = [&]() -> Result<BtreeV2ChunkNode> {
+    if (depth > header.depth ||
+        num_records > layout.max_num_records[depth]) {
+      return absl::DataLossError(
+          tensorstore::StrCat("Invalid number of records ", num_records,
+                              " for node at depth ", depth));
+    }
+    TENSORSTORE_RETURN_IF_ERROR(ValidateStructure(
+        encoded,
+        GetBtreeV2NodeSize(header, layout, format, depth, num_records),
+        depth == 0 ? "BTLF" : "BTIN"));
+    if (static_cast<uint8_t>(encoded[5]) != header.record_type) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Expected record type ", header.record_type, " but received ",
+          static_cast<int>(encoded[5])));
+    }
+    const bool filtered =
+        header.record_type == kBtreeV2FilteredChunkRecordType;
+    const uint64_t fixed_size = format.size_of_offsets + 8 * rank +
+                                (filtered ? 4 : 0);
+    const uint64_t chunk_size_size =
+        filtered ? header.record_size - fixed_size : 0;
+    if (header.record_size < fixed_size ||
+        (filtered ? (chunk_size_size < 1 || chunk_size_size > 8)
+                  : header.record_size != fixed_size)) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Invalid record size ", header.record_size, " for record type ",
+          header.record_type, " of rank ", rank));
+    }
+    BtreeV2ChunkNode node;
+    const char* p = encoded.data() + 6;
+    node.records.resize(num_records);
+    for (auto& record : node.records) {
+      const char* r = p;
+      record.entry.address = LoadAddress(r, format);
+      r += format.size_of_offsets;
+      if (filtered) {
+        record.entry.size = LoadUnsignedInteger(r, chunk_size_size);
+        r += chunk_size_size;
+        record.entry.filter_mask =
+            static_cast<uint32_t>(LoadUnsignedInteger(r, 4));
+        r += 4;
+      } else {
+        record.entry.size = params.GetUnfilteredChunkSize();
+      }
+      record.cell_indices.resize(rank);
+      for (auto& cell : record.cell_indices) {
+        cell = LoadUnsignedInteger(r, 8);
+        r += 8;
+      }
+      p += header.record_size;
+    }
+    if (depth > 0) {
+      const uint8_t total_size = layout.total_num_records_size[depth - 1];
+      node.children.resize(num_records + 1);
+      for (auto& child : node.children) {
+        child.address = LoadAddress(p, format);
+        p += format.size_of_offsets;
+        child.num_records = LoadUnsignedInteger(p, layout.num_records_size);
+        p += layout.num_records_size + total_size;
+      }
+    }
+    return node;
+  };
+  auto result = decode();
+  if (!result.ok()) {
+    return tensorstore::MaybeAnnotateStatus(
+        result.status(), "Error decoding HDF5 chunk B-tree node");
+  }
+  return result;
+}
+
+uint64_t GetFixedArrayHeaderSize(const FormatParameters& params) {
+  return 4 + 1 + 1 + 1 + 1 + params.size_of_lengths + params.size_of_offsets +
+         4;
+}
+
+Result<FixedArrayHeader> DecodeFixedArrayHeader(
+    std::string_view encoded, const FormatParameters& params) {
+  const auto decode = [&]() -> Result<FixedArrayHeader> {
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidateStructure(encoded, GetFixedArrayHeaderSize(params), "FAHD"));
+    const char* p = encoded.data();
+    FixedArrayHeader header;
+    header.client_id = static_cast<uint8_t>(p[5]);
+    header.entry_size = static_cast<uint8_t>(p[6]);
+    header.page_bits = static_cast<uint8_t>(p[7]);
+    p += 8;
+    header.max_num_entries = LoadUnsignedInteger(p, params.size_of_lengths);
+    p += params.size_of_lengths;
+    header.data_block_address = LoadAddress(p, params);
+    TENSORSTORE_RETURN_IF_ERROR(ValidateArrayElementSize(
+        header.client_id, header.entry_size, params));
+    if (header.page_bits >= 32) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Invalid page bits ", header.page_bits));
+    }
+    return header;
+  };
+  auto result = decode();
+  if (!result.ok()) {
+    return tensorstore::MaybeAnnotateStatus(
+        result.status(), "Error decoding HDF5 fixed array header");
+  }
+  return result;
+}
+
+uint64_t GetExtensibleArrayHeaderSize(const FormatParameters& params) {
+  return 4 + 1 + 1 + 6 + 6 * params.size_of_lengths + params.size_of_offsets +
+         4;
+}
+
+Result<ExtensibleArrayHeader> DecodeExtensibleArrayHeader(
+    std::string_view encoded, const FormatParameters& params) {
+  const auto decode = [&]() -> Result<ExtensibleArrayHeader> {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateStructure(
+        encoded, GetExtensibleArrayHeaderSize(params), "EAHD"));
+    const char* p = encoded.data();
+    ExtensibleArrayHeader header;
+    header.client_id = static_cast<uint8_t>(p[5]);
+    header.element_size = static_cast<uint8_t>(p[6]);
+    header.max_num_elements_bits = static_cast<uint8_t>(p[7]);
+    header.index_block_elements = static_cast<uint8_t>(p[8]);
+    header.data_block_min_elements = static_cast<uint8_t>(p[9]);
+    header.secondary_block_min_data_pointers = static_cast<uint8_t>(p[10]);
+    header.max_data_block_page_bits = static_cast<uint8_t>(p[11]);
+    p += 12;
+    // Skip the number and size of the secondary and data blocks.
+    p += 4 * params.size_of_lengths;
+    header.max_index_set = LoadUnsignedInteger(p, params.size_of_lengths);
+    // Skip the number of realized elements.
+    p += 2 * params.size_of_lengths;
+    header.index_block_address = LoadAddress(p, params);
+    TENSORSTORE_RETURN_IF_ERROR(ValidateArrayElementSize(
+        header.client_id, header.element_size, params));
+    const auto is_power_of_two = [](uint8_t x) {
+      return x != 0 && (x & (x - 1)) == 0;
+    };
+    if (header.max_num_elements_bits == 0 ||
+        header.max_num_elements_bits > 64 ||
+        !is_power_of_two(header.data_block_min_elements) ||
+        !is_power_of_two(header.secondary_block_min_data_pointers) ||
+        header.max_data_block_page_bits >= 32 ||
+        (uint64_t{1} << (header.max_num_elements_bits - 1)) <
+            header.data_block_min_elements) {
+      return absl::DataLossError("Invalid creation parameters");
+    }
+    return header;
+  };
+  auto result = decode();
+  if (!result.ok()) {
+    return tensorstore::MaybeAnnotateStatus(
+        result.status(), "Error decoding HDF5 extensible array header");
+  }
+  return result;
+}
+
+ChunkIndexEntry LoadArrayChunkEntry(const char* data, uint8_t client_id,
+                                    uint8_t element_size,
+                                    const FormatParameters& params,
+                                    uint64_t unfiltered_chunk_size) {
+  ChunkIndexEntry entry;
+  entry.address = LoadAddress(data, params);
+  if (client_id == kArrayFilteredChunkClientId) {
+    const size_t size_size = element_size - params.size_of_offsets - 4;
+    data += params.size_of_offsets;
+    entry.size = LoadUnsignedInteger(data, size_size);
+    entry.filter_mask =
+        static_cast<uint32_t>(LoadUnsignedInteger(data + size_size, 4));
+  } else {
+    entry.size = unfiltered_chunk_size;
+  }
+  return entry;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,392 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_H_
+#define TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_H_
+
+/// \file
+///
+/// Decoding of the index that maps the grid cell of a chunked HDF5 dataset to
+/// the location of the chunk within the file.
+///
+/// Datasets using the contiguous layout are exposed as a virtual chunk grid,
+/// whose chunks are located arithmetically.
+///
+/// Lookups that read the index from storage are implemented by
+/// `chunk_index_cache.h`.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <string_view>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Location of a single stored chunk within the file.
+struct ChunkIndexEntry {
+  /// File address of the first byte of the (possibly filtered) chunk, or
+  /// `kUndefinedAddress` if the chunk has not been allocated.
+  uint64_t address = kUndefinedAddress;
+
+  /// Size in bytes of the chunk as stored.
+  uint64_t size = 0;
+
+  /// Bit `i` is set if filter `i` of the filter pipeline was skipped for this
+  /// chunk.
+  uint32_t filter_mask = 0;
+
+  static constexpr ChunkIndexEntry Missing() { return ChunkIndexEntry{}; }
+
+  bool IsMissing() const { return address == kUndefinedAddress; }
+
+  friend bool operator==(const ChunkIndexEntry& a, const ChunkIndexEntry& b) {
+    return a.address == b.address && a.size == b.size &&
+           a.filter_mask == b.filter_mask;
+  }
+  friend bool operator!=(const ChunkIndexEntry& a, const ChunkIndexEntry& b) {
+    return !(a == b);
+  }
+};
+
+/// Parameters required to interpret the chunk index of a dataset.
+struct ChunkIndexParameters {
+  FormatParameters format;
+
+  DataLayout layout;
+
+  /// Current shape of the dataset.
+  std::vector<Index> shape;
+
+  /// Maximum shape of the dataset, with `kInfSize` indicating an unlimited
+  /// dimension.  If empty, equal to `shape`.
+  ///
+  /// The fixed array, extensible array and implicit indexes are laid out
+  /// according to the maximum shape.
+  std::vector<Index> max_shape;
+
+  /// Shape of each chunk, in elements.
+  std::vector<Index> chunk_shape;
+
+  /// Size in bytes of a single element.
+  uint32_t element_size = 0;
+
+  DimensionIndex rank() const {
+    return static_cast<DimensionIndex>(chunk_shape.size());
+  }
+
+  /// Returns the size in bytes of an unfiltered chunk.
+  uint64_t GetUnfilteredChunkSize() const;
+};
+
+/// Returns the position of the chunk at `cell_indices` within the linear
+/// order used by the fixed array, extensible array and implicit indexes, or
+/// `-1` if `cell_indices` is outside the maximum shape of the dataset.
+///
+/// Chunks are ordered lexicographically over the grid of the maximum shape,
+/// except that for `ChunkIndexType::kExtensibleArray` the (single) unlimited
+/// dimension is moved to the front.
+Index GetLinearChunkIndex(const ChunkIndexParameters& params,
+                          span<const Index> cell_indices);
+
+/// Computes the grid cell indices of the chunk at position `linear_index`
+/// within the linear order used by `GetLinearChunkIndex`.
+///
+/// \returns `false` if `linear_index` is outside the maximum shape of the
+///     dataset.
+bool GetChunkCellIndices(const ChunkIndexParameters& params,
+                         Index linear_index, span<Index> cell_indices);
+
+/// Target size in bytes of the virtual chunks of a dataset using the
+/// contiguous layout.
+///
+/// This is large enough for a read of a single virtual chunk to be served by
+/// memory mapping when `file_io_memmap` is enabled.
+constexpr uint64_t kContiguousVirtualChunkSize = uint64_t{1} << 20;
+
+/// Returns the shape of the virtual chunk grid used to expose a dataset of the
+/// specified `shape` using the contiguous or compact layout.
+///
+/// The raw data of such a dataset is a single extent in C order, which is
+/// partitioned along the first dimension only, such that each virtual chunk
+/// is a contiguous byte range of approximately `kContiguousVirtualChunkSize`
+/// bytes.  The compact layout always uses a single virtual chunk.
+std::vector<Index> GetVirtualChunkShape(LayoutClass layout_class,
+                                        span<const Index> shape,
+                                        uint64_t element_size);
+
+/// Returns the location of the virtual chunk at `cell_indices` of a dataset
+/// using the contiguous layout, see `GetVirtualChunkShape`.
+///
+/// The returned `size` excludes the portion of the final virtual chunk that
+/// lies past the end of the raw data.
+ChunkIndexEntry GetContiguousChunkEntry(const ChunkIndexParameters& params,
+                                        span<const Index> cell_indices);
+
+/// Key of a version 1 B-tree node for raw data chunks (node type 1).
+struct BtreeV1ChunkKey {
+  /// Size in bytes of the chunk as stored.
+  uint32_t chunk_size = 0;
+
+  /// Filter mask of the chunk.
+  uint32_t filter_mask = 0;
+
+  /// Element offset of the chunk within the dataset.  The final element
+  /// corresponds to the implicit datatype dimension and is always zero.
+  std::vector<uint64_t> offsets;
+};
+
+/// Decoded version 1 B-tree node for raw data chunks.
+struct BtreeV1ChunkNode {
+  /// Level of the node, `0` for leaf nodes.
+  uint8_t level = 0;
+
+  /// Addresses of the sibling nodes at the same level, or
+  /// `kUndefinedAddress`.
+  uint64_t left_sibling = kUndefinedAddress;
+  uint64_t right_sibling = kUndefinedAddress;
+
+  /// Addresses of the child nodes (if `level > 0`) or of the chunks (if
+  /// `level == 0`).
+  std::vector<uint64_t> children;
+
+  /// Keys bounding the children, of size `children.size() + 1`.  The key at
+  /// index `i` is the lower bound of child `i`.
+  std::vector<BtreeV1ChunkKey> keys;
+};
+
+/// Returns the encoded size of a v1 B-tree chunk node with capacity for
+/// `2 * params.indexed_storage_k` children, which is the amount of space HDF5
+/// reserves for every node.
+uint64_t GetBtreeV1ChunkNodeSize(const FormatParameters& params,
+                                 DimensionIndex rank);
+
+/// Decodes a v1 B-tree chunk node for a dataset of the specified `rank`.
+///
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is not a valid node.
+Result<BtreeV1ChunkNode> DecodeBtreeV1ChunkNode(const absl::Cord& encoded,
+                                                const FormatParameters& params,
+                                                DimensionIndex rank);
+
+/// Encodes a v1 B-tree chunk node for a dataset of the specified `rank`.
+///
+/// The result is zero-padded to `GetBtreeV1ChunkNodeSize(params, rank)`.
+///
+/// \pre `node.keys.size() == node.children.size() + 1`
+/// \pre `node.children.size() <= 2 * params.indexed_storage_k`
+absl::Cord EncodeBtreeV1ChunkNode(const BtreeV1ChunkNode& node,
+                                  const FormatParameters& params,
+                                  DimensionIndex rank);
+
+/// Returns the index of the child of `node` whose key range may contain the
+/// chunk at element `offsets`, or `-1` if there is no such child.
+///
+/// \param offsets Element offset of the chunk, including the trailing zero of
+///     the datatype dimension.
+ptrdiff_t FindBtreeV1Child(const BtreeV1ChunkNode& node,
+                           span<const uint64_t> offsets);
+
+/// Record type of version 2 B-trees that index unfiltered chunks.
+constexpr uint8_t kBtreeV2UnfilteredChunkRecordType = 10;
+
+/// Record type of version 2 B-trees that index filtered chunks.
+constexpr uint8_t kBtreeV2FilteredChunkRecordType = 11;
+
+/// Decoded version 2 B-tree header ("BTHD").
+struct BtreeV2Header {
+  uint8_t record_type = 0;
+
+  /// Size in bytes allocated for every node.
+  uint32_t node_size = 0;
+
+  /// Size in bytes of a single record.
+  uint16_t record_size = 0;
+
+  /// Depth of the tree, `0` if the root node is a leaf.
+  uint16_t depth = 0;
+
+  uint64_t root_address = kUndefinedAddress;
+
+  /// Number of records in the root node.
+  uint16_t root_num_records = 0;
+
+  /// Number of records in the whole tree.
+  uint64_t total_num_records = 0;
+};
+
+/// Returns the encoded size of a version 2 B-tree header.
+uint64_t GetBtreeV2HeaderSize(const FormatParameters& params);
+
+/// Decodes a version 2 B-tree header, including the checksum.
+///
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is not a valid header.
+Result<BtreeV2Header> DecodeBtreeV2Header(std::string_view encoded,
+                                          const FormatParameters& params);
+
+/// Encoding parameters of the nodes of a version 2 B-tree, derived from the
+/// header.
+struct BtreeV2NodeLayout {
+  /// Maximum number of records of a node at each depth, where depth `0`
+  /// corresponds to leaf nodes.
+  std::vector<uint64_t> max_num_records;
+
+  /// Size in bytes of the "total number of records" field of child pointers
+  /// to nodes at each depth.
+  std::vector<uint8_t> total_num_records_size;
+
+  /// Size in bytes of the "number of records" field of child pointers.
+  uint8_t num_records_size = 0;
+
+  /// Returns the size of a child pointer in a node at `depth`.
+  uint64_t GetChildPointerSize(const FormatParameters& params,
+                               uint16_t depth) const;
+};
+
+/// Computes the node layout of the B-tree described by `header`.
+///
+/// \error `absl::StatusCode::kDataLoss` if the node size is too small.
+Result<BtreeV2NodeLayout> GetBtreeV2NodeLayout(const BtreeV2Header& header,
+                                               const FormatParameters& params);
+
+/// Returns the encoded size, including the checksum, of a version 2 B-tree
+/// node at `depth` containing `num_records` records.
+uint64_t GetBtreeV2NodeSize(const BtreeV2Header& header,
+                            const BtreeV2NodeLayout& layout,
+                            const FormatParameters& params, uint16_t depth,
+                            uint64_t num_records);
+
+/// Record of a version 2 B-tree chunk index.
+struct BtreeV2ChunkRecord {
+  /// Grid cell indices of the chunk.
+  std::vector<uint64_t> cell_indices;
+
+  ChunkIndexEntry entry;
+};
+
+/// Pointer from an internal version 2 B-tree node to a child node.
+struct BtreeV2ChildPointer {
+  uint64_t address = kUndefinedAddress;
+  uint64_t num_records = 0;
+};
+
+/// Decoded version 2 B-tree node for chunks.
+struct BtreeV2ChunkNode {
+  /// Records, sorted by `cell_indices`.
+  std::vector<BtreeV2ChunkRecord> records;
+
+  /// Child pointers, of size `records.size() + 1` for internal nodes and empty
+  /// for leaf nodes.  Child `i` contains the records that order between
+  /// record `i - 1` and record `i`.
+  std::vector<BtreeV2ChildPointer> children;
+};
+
+/// Decodes a version 2 B-tree node at `depth` containing `num_records`
+/// records, including the checksum.
+///
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is not a valid node.
+Result<BtreeV2ChunkNode> DecodeBtreeV2ChunkNode(
+    std::string_view encoded, const BtreeV2Header& header,
+    const BtreeV2NodeLayout& layout, const ChunkIndexParameters& params,
+    uint16_t depth, uint64_t num_records);
+
+/// Client ID of fixed and extensible arrays that index unfiltered chunks.
+constexpr uint8_t kArrayUnfilteredChunkClientId = 0;
+
+/// Client ID of fixed and extensible arrays that index filtered chunks.
+constexpr uint8_t kArrayFilteredChunkClientId = 1;
+
+/// Decoded fixed array header ("FAHD").
+struct FixedArrayHeader {
+  uint8_t client_id = 0;
+
+  /// Size in bytes of each entry.
+  uint8_t entry_size = 0;
+
+  /// Log2 of the number of entries per data block page.
+  uint8_t page_bits = 0;
+
+  uint64_t max_num_entries = 0;
+
+  uint64_t data_block_address = kUndefinedAddress;
+};
+
+/// Returns the encoded size of a fixed array header.
+uint64_t GetFixedArrayHeaderSize(const FormatParameters& params);
+
+/// Decodes a fixed array header, including the checksum.
+///
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is not a valid header.
+Result<FixedArrayHeader> DecodeFixedArrayHeader(
+    std::string_view encoded, const FormatParameters& params);
+
+/// Decoded extensible array header ("EAHD").
+struct ExtensibleArrayHeader {
+  uint8_t client_id = 0;
+
+  /// Size in bytes of each element.
+  uint8_t element_size = 0;
+
+  /// Log2 of the maximum number of elements.
+  uint8_t max_num_elements_bits = 0;
+
+  /// Number of elements stored directly in the index block.
+  uint8_t index_block_elements = 0;
+
+  /// Minimum number of elements per data block.
+  uint8_t data_block_min_elements = 0;
+
+  /// Minimum number of data block pointers per secondary block.
+  uint8_t secondary_block_min_data_pointers = 0;
+
+  /// Log2 of the number of elements per data block page.
+  uint8_t max_data_block_page_bits = 0;
+
+  /// One more than the largest element index that has been set.
+  uint64_t max_index_set = 0;
+
+  uint64_t index_block_address = kUndefinedAddress;
+};
+
+/// Returns the encoded size of an extensible array header.
+uint64_t GetExtensibleArrayHeaderSize(const FormatParameters& params);
+
+/// Decodes an extensible array header, including the checksum.
+///
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is not a valid header.
+Result<ExtensibleArrayHeader> DecodeExtensibleArrayHeader(
+    std::string_view encoded, const FormatParameters& params);
+
+/// Decodes a chunk entry of a fixed or extensible array with the specified
+/// `client_id` and `element_size`, stored at `data`.
+///
+/// \param unfiltered_chunk_size Size of unfiltered chunks, which is not stored
+///     in the array.
+ChunkIndexEntry LoadArrayChunkEntry(const char* data, uint8_t client_id,
+                                    uint8_t element_size,
+                                    const FormatParameters& params,
+                                    uint64_t unfiltered_chunk_size);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_H_
@@ -0,0 +1,1496 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_index_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_vector.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+/// Maximum number of memoized chunk locations per dataset.  When exceeded,
+/// all memoized locations are discarded.
+constexpr size_t kMaxMemoizedEntries = size_t{1} << 16;
+
+/// Location of a metadata block, as encoded by
+/// `ChunkIndexCache::EncodeBlockKey`.
+struct BlockKey {
+  uint64_t address;
+  uint64_t size;
+  uint64_t checksummed_size;
+};
+
+bool DecodeBlockKey(std::string_view key, BlockKey& block) {
+  if (key.size() != 24) return false;
+  block.address = absl::big_endian::Load64(key.data());
+  block.size = absl::big_endian::Load64(key.data() + 8);
+  block.checksummed_size = absl::big_endian::Load64(key.data() + 16);
+  return block.checksummed_size <= block.size;
+}
+
+/// Key-value store adapter used as the backing store of `ChunkIndexCache`,
+/// which maps each block key to a byte range read of the file.
+class BlockKeyValueStore : public kvstore::Driver {
+ public:
+  explicit BlockKeyValueStore(kvstore::DriverPtr base, std::string path,
+                              uint64_t base_address)
+      : base_(std::move(base)),
+        path_(std::move(path)),
+        base_address_(base_address) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override {
+    BlockKey block;
+    ABSL_CHECK(DecodeBlockKey(key, block));
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto byte_range,
+        options.byte_range.Validate(static_cast<int64_t>(block.size)));
+    const int64_t offset = static_cast<int64_t>(base_address_ + block.address);
+    options.byte_range.inclusive_min = byte_range.inclusive_min + offset;
+    options.byte_range.exclusive_max = byte_range.exclusive_max + offset;
+    return base_->Read(path_, std::move(options));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    BlockKey block;
+    ABSL_CHECK(DecodeBlockKey(key, block));
+    const int64_t offset = static_cast<int64_t>(base_address_ + block.address);
+    return tensorstore::StrCat(
+        "Byte range ",
+        ByteRange{offset, offset + static_cast<int64_t>(block.size)}, " of ",
+        base_->DescribeKey(path_));
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    garbage_collection::GarbageCollectionVisit(visitor, *base_);
+  }
+
+ private:
+  kvstore::DriverPtr base_;
+  std::string path_;
+  uint64_t base_address_;
+};
+
+std::string GetMemoKey(span<const Index> cell_indices) {
+  return std::string(reinterpret_cast<const char*>(cell_indices.data()),
+                     cell_indices.size() * sizeof(Index));
+}
+
+}  // namespace
+
+ChunkIndexCache::ChunkIndexCache(kvstore::DriverPtr base_kvstore,
+                                 std::string base_kvstore_path,
+                                 Executor executor,
+                                 ChunkIndexParameters index_params)
+    : Base(kvstore::DriverPtr(new BlockKeyValueStore(
+          base_kvstore, base_kvstore_path, index_params.format.base_address))),
+      base_kvstore_(std::move(base_kvstore)),
+      base_kvstore_path_(std::move(base_kvstore_path)),
+      executor_(std::move(executor)),
+      index_params_(std::move(index_params)) {}
+
+size_t ChunkIndexCache::Entry::ComputeReadDataSizeInBytes(
+    const void* read_data) {
+  return static_cast<const ReadData*>(read_data)->size();
+}
+
+void ChunkIndexCache::Entry::DoDecode(std::optional<absl::Cord> value,
+                                      DecodeReceiver receiver) {
+  if (!value) {
+    // The file does not exist.
+    execution::set_value(receiver, nullptr);
+    return;
+  }
+  BlockKey block;
+  ABSL_CHECK(DecodeBlockKey(this->key(), block));
+  GetOwningCache(*this).executor()(
+      [block, value = *std::move(value),
+       receiver = std::move(receiver)]() mutable {
+        if (value.size() != block.size) {
+          execution::set_error(
+              receiver,
+              absl::DataLossError(tensorstore::StrCat(
+                  "Expected ", block.size, " bytes at address ",
+                  block.address, " but received ", value.size())));
+          return;
+        }
+        const std::string_view flat = value.Flatten();
+        if (block.checksummed_size != 0) {
+          TENSORSTORE_RETURN_IF_ERROR(
+              ValidateChecksum(flat.substr(0, block.checksummed_size)),
+              static_cast<void>(execution::set_error(
+                  receiver,
+                  tensorstore::MaybeAnnotateStatus(
+                      _, tensorstore::StrCat("Error reading HDF5 metadata "
+                                             "block at address ",
+                                             block.address)))));
+        }
+        execution::set_value(receiver,
+                             std::make_shared<absl::Cord>(std::move(value)));
+      });
+}
+
+std::string ChunkIndexCache::EncodeBlockKey(uint64_t address, uint64_t size,
+                                            uint64_t checksummed_size) {
+  std::string key(24, '\0');
+  absl::big_endian::Store64(key.data(), address);
+  absl::big_endian::Store64(key.data() + 8, size);
+  absl::big_endian::Store64(key.data() + 16, checksummed_size);
+  return key;
+}
+
+std::optional<ChunkIndexEntry> ChunkIndexCache::GetMemoizedEntry(
+    const StorageGeneration& generation, span<const Index> cell_indices) {
+  absl::MutexLock lock(&memo_mutex_);
+  if (generation != memo_generation_) return std::nullopt;
+  auto it = memo_.find(GetMemoKey(cell_indices));
+  if (it == memo_.end()) return std::nullopt;
+  return it->second;
+}
+
+void ChunkIndexCache::MemoizeEntry(const StorageGeneration& generation,
+                                   span<const Index> cell_indices,
+                                   const ChunkIndexEntry& entry) {
+  absl::MutexLock lock(&memo_mutex_);
+  if (generation != memo_generation_ || memo_.size() >= kMaxMemoizedEntries) {
+    memo_.clear();
+    memo_generation_ = generation;
+  }
+  memo_[GetMemoKey(cell_indices)] = entry;
+}
+
+internal::CachePtr<ChunkIndexCache> GetChunkIndexCache(
+    internal::CachePool* pool, kvstore::DriverPtr base_kvstore,
+    std::string base_kvstore_path, Executor executor,
+    const ChunkIndexParameters& index_params) {
+  std::string cache_identifier;
+  const auto& layout = index_params.layout;
+  internal::EncodeCacheKey(
+      &cache_identifier, base_kvstore, base_kvstore_path,
+      index_params.format.size_of_offsets, index_params.format.size_of_lengths,
+      index_params.format.indexed_storage_k, index_params.format.base_address,
+      static_cast<int>(layout.layout_class),
+      static_cast<int>(layout.chunk_index_type), layout.address, layout.size,
+      index_params.shape, index_params.max_shape, index_params.chunk_shape,
+      index_params.element_size);
+  return internal::GetCache<ChunkIndexCache>(pool, cache_identifier, [&] {
+    return std::make_unique<ChunkIndexCache>(
+        std::move(base_kvstore), std::move(base_kvstore_path),
+        std::move(executor), index_params);
+  });
+}
+
+namespace {
+
+/// Returns an error if `block` does not start with the signature and version
+/// `0` of a structure of type `signature`.
+absl::Status ValidateBlockSignature(std::string_view block,
+                                    std::string_view signature) {
+  if (block.size() < 5 || block.substr(0, 4) != signature || block[4] != 0) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Expected HDF5 ", signature, " structure of version 0"));
+  }
+  return absl::OkStatus();
+}
+
+/// Returns the bit at `index` of an HDF5 bitmap, which is stored most
+/// significant bit first.
+bool GetBit(std::string_view bitmap, uint64_t index) {
+  return static_cast<uint8_t>(bitmap[index / 8]) & (0x80 >> (index % 8));
+}
+
+int Log2(uint64_t x) {
+  int bits = 0;
+  while (x >>= 1) ++bits;
+  return bits;
+}
+
+/// Returns the size of the data block of a fixed array.  If the data block is
+/// paged, the size excludes the pages, which follow the data block.
+uint64_t GetFixedArrayDataBlockSize(const FixedArrayHeader& header,
+                                    const FormatParameters& format) {
+  const uint64_t page_entries = uint64_t{1} << header.page_bits;
+  const uint64_t prefix_size = 6 + format.size_of_offsets;
+  uint64_t size = prefix_size + 4;
+  if (header.max_num_entries > page_entries) {
+    const uint64_t num_pages =
+        (header.max_num_entries + page_entries - 1) / page_entries;
+    size += (num_pages + 7) / 8;
+  } else {
+    size += header.max_num_entries * header.entry_size;
+  }
+  return size;
+}
+
+// Extensible array geometry.  Elements past those stored in the index block
+// are stored in data blocks, grouped by "super block" `u`: super block `u`
+// contains `2^floor(u/2)` data blocks of `2^ceil(u/2) * min` elements.  The
+// data blocks of the first super blocks are referenced directly from the
+// index block, those of the remaining super blocks through a secondary block
+// each.
+
+uint64_t GetNumIndexBlockDataBlocks(const ExtensibleArrayHeader& header) {
+  return 2 * (uint64_t{header.secondary_block_min_data_pointers} - 1);
+}
+
+uint64_t GetNumIndexBlockSuperBlocks(const ExtensibleArrayHeader& header) {
+  return 2 * Log2(header.secondary_block_min_data_pointers);
+}
+
+uint64_t GetNumIndexBlockSecondaryBlocks(const ExtensibleArrayHeader& header) {
+  const uint64_t num_super_blocks = 1 + header.max_num_elements_bits -
+                                    Log2(header.data_block_min_elements);
+  const uint64_t num_direct = GetNumIndexBlockSuperBlocks(header);
+  return num_super_blocks > num_direct ? num_super_blocks - num_direct : 0;
+}
+
+uint64_t GetExtensibleArrayIndexBlockSize(const ExtensibleArrayHeader& header,
+                                          const FormatParameters& format) {
+  return 6 + format.size_of_offsets +
+         header.index_block_elements * header.element_size +
+         (GetNumIndexBlockDataBlocks(header) +
+          GetNumIndexBlockSecondaryBlocks(header)) *
+             format.size_of_offsets +
+         4;
+}
+
+uint64_t GetArrayOffsetSize(const ExtensibleArrayHeader& header) {
+  return (header.max_num_elements_bits + 7) / 8;
+}
+
+uint64_t GetDataBlockPageElements(const ExtensibleArrayHeader& header) {
+  return uint64_t{1} << header.max_data_block_page_bits;
+}
+
+/// Returns the number of pages of a data block of `data_block_num_elements`
+/// elements, or `0` if the data block is not paged.
+uint64_t GetNumDataBlockPages(const ExtensibleArrayHeader& header,
+                              uint64_t data_block_num_elements) {
+  const uint64_t page_elements = GetDataBlockPageElements(header);
+  return data_block_num_elements > page_elements
+             ? data_block_num_elements / page_elements
+             : 0;
+}
+
+/// Returns the size of the page initialization bitmap of a secondary block
+/// referencing `num_data_blocks` data blocks of `data_block_num_elements`
+/// elements each.
+uint64_t GetSecondaryBlockBitmapSize(const ExtensibleArrayHeader& header,
+                                     uint64_t num_data_blocks,
+                                     uint64_t data_block_num_elements) {
+  return num_data_blocks *
+         ((GetNumDataBlockPages(header, data_block_num_elements) + 7) / 8);
+}
+
+/// Asynchronous state of a `LookupChunk` operation.
+///
+/// The lookup proceeds one block at a time, from the root of the index (a v1
+/// B-tree root node, or a v2 B-tree, fixed array or extensible array header)
+/// towards the block that contains the chunk entry.  Each block is read
+/// through `ChunkIndexCache` and then handled by a continuation that either
+/// completes the lookup or reads the next block.
+class LookupState : public internal::AtomicReferenceCount<LookupState> {
+ public:
+  using Ptr = internal::IntrusivePtr<LookupState>;
+
+  /// Handles a block that has been read.
+  using Continuation = void (*)(Ptr self, std::string_view block);
+
+  internal::CachePtr<ChunkIndexCache> cache_;
+  std::vector<Index> cell_indices_;
+  absl::Time staleness_bound_;
+  Batch batch_{no_batch};
+  Promise<ChunkLookupResult> promise_;
+
+  /// Generation at which all blocks are read.  Unknown until the root has
+  /// been read.
+  TimestampedStorageGeneration stamp_;
+
+  // State of the version 1 B-tree lookup.
+
+  /// Element offset of the chunk, including the trailing datatype dimension.
+  std::vector<uint64_t> offsets_;
+  int expected_level_ = -1;
+
+  // State of the version 2 B-tree lookup.
+  BtreeV2Header btree_v2_header_;
+  BtreeV2NodeLayout btree_v2_layout_;
+  uint16_t depth_ = 0;
+  uint64_t num_records_ = 0;
+
+  // State of the fixed and extensible array lookups.
+  Index linear_index_ = -1;
+  uint8_t client_id_ = 0;
+  uint8_t element_size_ = 0;
+  FixedArrayHeader fixed_array_header_;
+  ExtensibleArrayHeader extensible_array_header_;
+  /// Number of data blocks, and number of elements per data block, of the
+  /// extensible array super block that contains the chunk entry.
+  uint64_t num_data_blocks_ = 0;
+  uint64_t data_block_num_elements_ = 0;
+  uint64_t data_block_index_ = 0;
+  uint64_t element_index_ = 0;
+  std::string_view expected_signature_;
+  uint64_t element_offset_ = 0;
+
+  const ChunkIndexParameters& params() const { return cache_->index_params(); }
+  const FormatParameters& format() const { return params().format; }
+
+  static void Start(Ptr self) {
+    const auto& layout = self->params().layout;
+    const auto& format = self->format();
+    switch (layout.chunk_index_type) {
+      case ChunkIndexType::kBtreeV1:
+        self->expected_level_ = -1;
+        ReadBlock(std::move(self), layout.address,
+                  GetBtreeV1ChunkNodeSize(format, self->params().rank()),
+                  /*checksummed_size=*/0, &OnBtreeV1Node);
+        return;
+      case ChunkIndexType::kBtreeV2: {
+        const uint64_t size = GetBtreeV2HeaderSize(format);
+        ReadBlock(std::move(self), layout.address, size, size,
+                  &OnBtreeV2Header);
+        return;
+      }
+      case ChunkIndexType::kFixedArray: {
+        const uint64_t size = GetFixedArrayHeaderSize(format);
+        ReadBlock(std::move(self), layout.address, size, size,
+                  &OnFixedArrayHeader);
+        return;
+      }
+      case ChunkIndexType::kExtensibleArray: {
+        const uint64_t size = GetExtensibleArrayHeaderSize(format);
+        ReadBlock(std::move(self), layout.address, size, size,
+                  &OnExtensibleArrayHeader);
+        return;
+      }
+      default:
+        self->promise_.SetResult(absl::UnimplementedError(tensorstore::StrCat(
+            "HDF5 chunk index type ", static_cast<int>(layout.chunk_index_type),
+            " is not supported")));
+        return;
+    }
+  }
+
+  static void ReadBlock(Ptr self, uint64_t address, uint64_t size,
+                        uint64_t checksummed_size, Continuation continuation) {
+    if (!self->promise_.result_needed()) return;
+    auto entry = GetCacheEntry(
+        self->cache_,
+        ChunkIndexCache::EncodeBlockKey(address, size, checksummed_size));
+    auto batch = std::exchange(self->batch_, Batch{no_batch});
+    internal::AsyncCache::AsyncCacheReadRequest request;
+    request.staleness_bound = self->staleness_bound_;
+    request.batch = batch;
+    auto* entry_ptr = entry.get();
+    entry_ptr->Read(request).ExecuteWhenReady(
+        [self = std::move(self), entry = std::move(entry),
+         continuation](ReadyFuture<const void> future) mutable {
+          OnBlockReady(std::move(self), *entry, future.result(), continuation);
+        });
+  }
+
+  static void OnBlockReady(Ptr self, ChunkIndexCache::Entry& entry,
+                           const Result<void>& result,
+                           Continuation continuation) {
+    if (!result.ok()) {
+      self->promise_.SetResult(result.status());
+      return;
+    }
+    std::shared_ptr<const absl::Cord> block;
+    TimestampedStorageGeneration stamp;
+    {
+      internal::AsyncCache::ReadLock<absl::Cord> lock(entry);
+      block = lock.shared_data();
+      stamp = lock.stamp();
+    }
+    auto& self_stamp = self->stamp_;
+    if (StorageGeneration::IsUnknown(self_stamp.generation)) {
+      self_stamp = std::move(stamp);
+    } else if (stamp.generation != self_stamp.generation) {
+      // The file was modified between the reads of two blocks.  Restart from
+      // the root, excluding the older of the two generations.
+      self->staleness_bound_ = std::max(self_stamp.time, stamp.time);
+      self_stamp = TimestampedStorageGeneration{};
+      Start(std::move(self));
+      return;
+    } else {
+      self_stamp.time = std::max(self_stamp.time, stamp.time);
+    }
+    if (!block) {
+      // The file does not exist.
+      self->promise_.SetResult(
+          ChunkLookupResult{ChunkIndexEntry::Missing(), self->stamp_});
+      return;
+    }
+    continuation(std::move(self), *block->TryFlat());
+  }
+
+  /// Completes the lookup using a memoized result, if available.  Called
+  /// once the root of the index has been read.
+  bool UseMemoizedEntry() {
+    auto entry = cache_->GetMemoizedEntry(stamp_.generation, cell_indices_);
+    if (!entry) return false;
+    promise_.SetResult(ChunkLookupResult{*entry, stamp_});
+    return true;
+  }
+
+  void Done(const ChunkIndexEntry& entry) {
+    cache_->MemoizeEntry(stamp_.generation, cell_indices_, entry);
+    promise_.SetResult(ChunkLookupResult{entry, stamp_});
+  }
+
+  void Fail(absl::Status status) {
+    promise_.SetResult(tensorstore::MaybeAnnotateStatus(
+        std::move(status), "Error reading HDF5 chunk index"));
+  }
+
+  static void OnBtreeV1Node(Ptr self, std::string_view block) {
+    if (self->expected_level_ == -1 && self->UseMemoizedEntry()) return;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto node,
+        DecodeBtreeV1ChunkNode(absl::Cord(block), self->format(),
+                               self->params().rank()),
+        self->Fail(_));
+    if (self->expected_level_ != -1 && node.level != self->expected_level_) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Expected B-tree node at level ", self->expected_level_,
+          " but received level ", node.level)));
+      return;
+    }
+    const ptrdiff_t child = FindBtreeV1Child(node, self->offsets_);
+    if (child < 0) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    if (node.level != 0) {
+      self->expected_level_ = node.level - 1;
+      const uint64_t size =
+          GetBtreeV1ChunkNodeSize(self->format(), self->params().rank());
+      ReadBlock(std::move(self), node.children[child], size,
+                /*checksummed_size=*/0, &OnBtreeV1Node);
+      return;
+    }
+    const auto& key = node.keys[child];
+    if (key.offsets != self->offsets_) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    self->Done(
+        ChunkIndexEntry{node.children[child], key.chunk_size, key.filter_mask});
+  }
+
+  static void OnBtreeV2Header(Ptr self, std::string_view block) {
+    if (self->UseMemoizedEntry()) return;
+    TENSORSTORE_ASSIGN_OR_RETURN(self->btree_v2_header_,
+                                 DecodeBtreeV2Header(block, self->format()),
+                                 self->Fail(_));
+    const auto& header = self->btree_v2_header_;
+    if (header.record_type != kBtreeV2UnfilteredChunkRecordType &&
+        header.record_type != kBtreeV2FilteredChunkRecordType) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Expected B-tree of chunks but received record type ",
+          header.record_type)));
+      return;
+    }
+    if (header.root_address == kUndefinedAddress ||
+        header.total_num_records == 0) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        self->btree_v2_layout_,
+        GetBtreeV2NodeLayout(header, self->format()), self->Fail(_));
+    self->depth_ = header.depth;
+    self->num_records_ = header.root_num_records;
+    ReadBtreeV2Node(std::move(self), header.root_address);
+  }
+
+  static void ReadBtreeV2Node(Ptr self, uint64_t address) {
+    if (self->num_records_ >
+        self->btree_v2_layout_.max_num_records[self->depth_]) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Invalid number of records ", self->num_records_,
+          " for B-tree node at depth ", self->depth_)));
+      return;
+    }
+    const uint64_t size =
+        GetBtreeV2NodeSize(self->btree_v2_header_, self->btree_v2_layout_,
+                           self->format(), self->depth_, self->num_records_);
+    ReadBlock(std::move(self), address, size, size, &OnBtreeV2Node);
+  }
+
+  static void OnBtreeV2Node(Ptr self, std::string_view block) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto node,
+        DecodeBtreeV2ChunkNode(block, self->btree_v2_header_,
+                               self->btree_v2_layout_, self->params(),
+                               self->depth_, self->num_records_),
+        self->Fail(_));
+    span<const Index> key = self->cell_indices_;
+    const auto compare = [](const BtreeV2ChunkRecord& record,
+                            span<const Index> key) {
+      return std::lexicographical_compare(
+          record.cell_indices.begin(), record.cell_indices.end(), key.begin(),
+          key.end(), [](uint64_t a, Index b) {
+            return a < static_cast<uint64_t>(b);
+          });
+    };
+    auto it = std::lower_bound(node.records.begin(), node.records.end(), key,
+                               compare);
+    if (it != node.records.end() &&
+        std::equal(it->cell_indices.begin(), it->cell_indices.end(),
+                   key.begin(), key.end(), [](uint64_t a, Index b) {
+                     return a == static_cast<uint64_t>(b);
+                   })) {
+      self->Done(it->entry);
+      return;
+    }
+    if (self->depth_ == 0) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    const auto& child = node.children[it - node.records.begin()];
+    --self->depth_;
+    self->num_records_ = child.num_records;
+    ReadBtreeV2Node(std::move(self), child.address);
+  }
+
+  static void OnFixedArrayHeader(Ptr self, std::string_view block) {
+    if (self->UseMemoizedEntry()) return;
+    TENSORSTORE_ASSIGN_OR_RETURN(self->fixed_array_header_,
+                                 DecodeFixedArrayHeader(block, self->format()),
+                                 self->Fail(_));
+    const auto& header = self->fixed_array_header_;
+    if (header.data_block_address == kUndefinedAddress ||
+        self->linear_index_ < 0 ||
+        static_cast<uint64_t>(self->linear_index_) >= header.max_num_entries) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    self->client_id_ = header.client_id;
+    self->element_size_ = header.entry_size;
+    const uint64_t size = GetFixedArrayDataBlockSize(header, self->format());
+    ReadBlock(std::move(self), header.data_block_address, size, size,
+              &OnFixedArrayDataBlock);
+  }
+
+  static void OnFixedArrayDataBlock(Ptr self, std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "FADB"),
+                                self->Fail(_));
+    const auto& header = self->fixed_array_header_;
+    const uint64_t index = static_cast<uint64_t>(self->linear_index_);
+    const uint64_t prefix_size = 6 + self->format().size_of_offsets;
+    const uint64_t page_entries = uint64_t{1} << header.page_bits;
+    if (header.max_num_entries <= page_entries) {
+      self->element_offset_ = prefix_size + index * header.entry_size;
+      OnArrayElementBlock(std::move(self), block);
+      return;
+    }
+    const uint64_t num_pages =
+        (header.max_num_entries + page_entries - 1) / page_entries;
+    const uint64_t bitmap_size = (num_pages + 7) / 8;
+    const uint64_t page = index / page_entries;
+    if (!GetBit(block.substr(prefix_size, bitmap_size), page)) {
+      // The page has not been initialized.
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    const uint64_t full_page_size = page_entries * header.entry_size + 4;
+    const uint64_t page_size =
+        std::min(page_entries, header.max_num_entries - page * page_entries) *
+            header.entry_size +
+        4;
+    const uint64_t page_address = header.data_block_address + prefix_size +
+                                  bitmap_size + 4 + page * full_page_size;
+    self->expected_signature_ = {};
+    self->element_offset_ = (index % page_entries) * header.entry_size;
+    ReadBlock(std::move(self), page_address, page_size, page_size,
+              &OnArrayElementBlock);
+  }
+
+  static void OnExtensibleArrayHeader(Ptr self, std::string_view block) {
+    if (self->UseMemoizedEntry()) return;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        self->extensible_array_header_,
+        DecodeExtensibleArrayHeader(block, self->format()), self->Fail(_));
+    const auto& header = self->extensible_array_header_;
+    if (header.index_block_address == kUndefinedAddress ||
+        self->linear_index_ < 0 ||
+        static_cast<uint64_t>(self->linear_index_) >= header.max_index_set) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    self->client_id_ = header.client_id;
+    self->element_size_ = header.element_size;
+    const uint64_t size =
+        GetExtensibleArrayIndexBlockSize(header, self->format());
+    ReadBlock(std::move(self), header.index_block_address, size, size,
+              &OnExtensibleArrayIndexBlock);
+  }
+
+  uint64_t GetArrayOffsetSize() const {
+    return internal_hdf5::GetArrayOffsetSize(extensible_array_header_);
+  }
+
+  uint64_t GetDataBlockPageElements() const {
+    return internal_hdf5::GetDataBlockPageElements(extensible_array_header_);
+  }
+
+  static void OnExtensibleArrayIndexBlock(Ptr self, std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "EAIB"),
+                                self->Fail(_));
+    const auto& header = self->extensible_array_header_;
+    const uint64_t address_size = self->format().size_of_offsets;
+    const uint64_t prefix_size = 6 + address_size;
+    uint64_t index = static_cast<uint64_t>(self->linear_index_);
+    if (index < header.index_block_elements) {
+      self->element_offset_ = prefix_size + index * header.element_size;
+      OnArrayElementBlock(std::move(self), block);
+      return;
+    }
+    index -= header.index_block_elements;
+    const uint64_t min_elements = header.data_block_min_elements;
+    const int super_block = Log2(index / min_elements + 1);
+    const uint64_t element_in_super_block =
+        index - min_elements * ((uint64_t{1} << super_block) - 1);
+    self->data_block_num_elements_ = min_elements
+                                     << ((super_block + 1) / 2);
+    self->data_block_index_ =
+        element_in_super_block / self->data_block_num_elements_;
+    self->element_index_ =
+        element_in_super_block % self->data_block_num_elements_;
+    const char* addresses =
+        block.data() + prefix_size +
+        header.index_block_elements * header.element_size;
+    const uint64_t num_direct_super_blocks =
+        GetNumIndexBlockSuperBlocks(header);
+    if (super_block < num_direct_super_blocks) {
+      uint64_t data_block = self->data_block_index_;
+      for (int u = 0; u < super_block; ++u) {
+        data_block += uint64_t{1} << (u / 2);
+      }
+      const uint64_t address = LoadAddress(
+          addresses + data_block * address_size, self->format());
+      ReadExtensibleArrayDataBlock(std::move(self), address);
+      return;
+    }
+    const uint64_t secondary_block = super_block - num_direct_super_blocks;
+    if (secondary_block >= GetNumIndexBlockSecondaryBlocks(header)) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Element ", self->linear_index_, " exceeds extensible array size")));
+      return;
+    }
+    const uint64_t address = LoadAddress(
+        addresses +
+            (GetNumIndexBlockDataBlocks(header) + secondary_block) *
+                address_size,
+        self->format());
+    if (address == kUndefinedAddress) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    self->num_data_blocks_ = uint64_t{1} << (super_block / 2);
+    const uint64_t size =
+        prefix_size + self->GetArrayOffsetSize() +
+        self->GetSecondaryBlockBitmapSize(self->num_data_blocks_) +
+        self->num_data_blocks_ * address_size + 4;
+    ReadBlock(std::move(self), address, size, size,
+              &OnExtensibleArraySecondaryBlock);
+  }
+
+  /// Returns the number of pages of each data block of the current super
+  /// block, or `0` if the data blocks are not paged.
+  uint64_t GetNumDataBlockPages() const {
+    return internal_hdf5::GetNumDataBlockPages(extensible_array_header_,
+                                               data_block_num_elements_);
+  }
+
+  uint64_t GetSecondaryBlockBitmapSize(uint64_t num_data_blocks) const {
+    return internal_hdf5::GetSecondaryBlockBitmapSize(
+        extensible_array_header_, num_data_blocks, data_block_num_elements_);
+  }
+
+  static void OnExtensibleArraySecondaryBlock(Ptr self,
+                                              std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "EASB"),
+                                self->Fail(_));
+    const uint64_t address_size = self->format().size_of_offsets;
+    const uint64_t bitmap_offset =
+        6 + address_size + self->GetArrayOffsetSize();
+    const uint64_t num_pages = self->GetNumDataBlockPages();
+    const uint64_t bitmap_size =
+        self->GetSecondaryBlockBitmapSize(self->num_data_blocks_);
+    if (num_pages != 0) {
+      const uint64_t page =
+          self->element_index_ / self->GetDataBlockPageElements();
+      if (!GetBit(block.substr(bitmap_offset, bitmap_size),
+                  self->data_block_index_ * num_pages + page)) {
+        // The page has not been initialized.
+        self->Done(ChunkIndexEntry::Missing());
+        return;
+      }
+    }
+    const uint64_t address = LoadAddress(
+        block.data() + bitmap_offset + bitmap_size +
+            self->data_block_index_ * address_size,
+        self->format());
+    ReadExtensibleArrayDataBlock(std::move(self), address);
+  }
+
+  static void ReadExtensibleArrayDataBlock(Ptr self, uint64_t address) {
+    if (address == kUndefinedAddress) {
+      self->Done(ChunkIndexEntry::Missing());
+      return;
+    }
+    const uint64_t element_size = self->element_size_;
+    const uint64_t prefix_size =
+        6 + self->format().size_of_offsets + self->GetArrayOffsetSize();
+    if (self->GetNumDataBlockPages() == 0) {
+      const uint64_t size =
+          prefix_size + self->data_block_num_elements_ * element_size + 4;
+      self->expected_signature_ = "EADB";
+      self->element_offset_ = prefix_size + self->element_index_ * element_size;
+      ReadBlock(std::move(self), address, size, size, &OnArrayElementBlock);
+      return;
+    }
+    const uint64_t page_elements = self->GetDataBlockPageElements();
+    const uint64_t page = self->element_index_ / page_elements;
+    const uint64_t page_size = page_elements * element_size + 4;
+    self->expected_signature_ = {};
+    self->element_offset_ =
+        (self->element_index_ % page_elements) * element_size;
+    ReadBlock(std::move(self), address + prefix_size + 4 + page * page_size,
+              page_size, page_size, &OnArrayElementBlock);
+  }
+
+  /// Handles the array block (or data block page) that contains the chunk
+  /// entry at `element_offset_`.
+  static void OnArrayElementBlock(Ptr self, std::string_view block) {
+    if (!self->expected_signature_.empty()) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          ValidateBlockSignature(block, self->expected_signature_),
+          self->Fail(_));
+    }
+    if (self->element_offset_ + self->element_size_ > block.size()) {
+      self->Fail(absl::DataLossError("Array element is past end of block"));
+      return;
+    }
+    self->Done(LoadArrayChunkEntry(
+        block.data() + self->element_offset_, self->client_id_,
+        self->element_size_, self->format(),
+        self->params().GetUnfilteredChunkSize()));
+  }
+};
+
+/// Returns the location of the chunk at `cell_indices` for index types that
+/// are fully specified by the data layout message.
+ChunkIndexEntry GetDirectChunkEntry(const ChunkIndexParameters& params,
+                                    span<const Index> cell_indices) {
+  const auto& layout = params.layout;
+  ChunkIndexEntry entry;
+  entry.size = params.GetUnfilteredChunkSize();
+  if (layout.chunk_index_type == ChunkIndexType::kSingleChunk) {
+    if (std::any_of(cell_indices.begin(), cell_indices.end(),
+                    [](Index i) { return i != 0; })) {
+      return ChunkIndexEntry::Missing();
+    }
+    entry.address = layout.address;
+    if (layout.single_chunk_filtered_size) {
+      entry.size = *layout.single_chunk_filtered_size;
+      entry.filter_mask = layout.single_chunk_filter_mask;
+    }
+    return entry;
+  }
+  const Index linear_index = GetLinearChunkIndex(params, cell_indices);
+  if (linear_index < 0) return ChunkIndexEntry::Missing();
+  entry.address = layout.address + static_cast<uint64_t>(linear_index) *
+                                       entry.size;
+  return entry;
+}
+
+void AddListedChunk(ChunkListResult& result, span<const Index> cell_indices) {
+  result.cell_indices.insert(result.cell_indices.end(), cell_indices.begin(),
+                             cell_indices.end());
+  ++result.num_chunks;
+}
+
+/// Asynchronous state of a `ListChunks` operation.
+///
+/// The index is read one level at a time: all blocks of a level, such as the
+/// children of the B-tree nodes of the previous level or the data block pages
+/// of an array, are requested together within a single batch, and are then
+/// decoded to obtain the chunk entries and the blocks of the next level.
+class ListState : public internal::AtomicReferenceCount<ListState> {
+ public:
+  using Ptr = internal::IntrusivePtr<ListState>;
+
+  /// Index block to be read, along with the parameters required to decode it.
+  struct BlockRequest {
+    using Handler = absl::Status (ListState::*)(const BlockRequest& request,
+                                                std::string_view block);
+
+    uint64_t address;
+    uint64_t size;
+    uint64_t checksummed_size;
+    Handler handler;
+
+    /// Level of a version 1 B-tree node, or `-1` for the root node.  Depth of
+    /// a version 2 B-tree node.  Super block of an extensible array secondary
+    /// block.
+    int64_t level = -1;
+
+    /// Number of records of a version 2 B-tree node.
+    uint64_t num_records = 0;
+
+    /// Expected signature of an array data block, or empty for data block
+    /// pages.
+    std::string_view signature;
+
+    /// Offset within the block of the first array element.
+    uint64_t element_offset = 0;
+
+    /// Linear index of the first array element, and number of elements
+    /// stored in the block.  For extensible array secondary blocks, the
+    /// linear index of the first element of the super block.
+    uint64_t first_element = 0;
+    uint64_t num_elements = 0;
+  };
+
+  internal::CachePtr<ChunkIndexCache> cache_;
+  absl::Time staleness_bound_;
+  Promise<ChunkListResult> promise_;
+
+  /// Generation at which all blocks are read.  Unknown until the root has
+  /// been read.
+  TimestampedStorageGeneration stamp_;
+
+  /// Chunks found so far.
+  ChunkListResult result_;
+
+  /// Blocks of the next level.
+  std::vector<BlockRequest> pending_;
+
+  BtreeV2Header btree_v2_header_;
+  BtreeV2NodeLayout btree_v2_layout_;
+  uint8_t client_id_ = 0;
+  uint8_t element_size_ = 0;
+  FixedArrayHeader fixed_array_header_;
+  ExtensibleArrayHeader extensible_array_header_;
+
+  const ChunkIndexParameters& params() const { return cache_->index_params(); }
+  const FormatParameters& format() const { return params().format; }
+
+  static void Start(Ptr self) {
+    self->stamp_ = TimestampedStorageGeneration{};
+    self->result_ = ChunkListResult{};
+    self->pending_.clear();
+    const auto& layout = self->params().layout;
+    const auto& format = self->format();
+    switch (layout.chunk_index_type) {
+      case ChunkIndexType::kBtreeV1:
+        self->pending_.push_back(BlockRequest{
+            layout.address,
+            GetBtreeV1ChunkNodeSize(format, self->params().rank()),
+            /*checksummed_size=*/0, &ListState::OnBtreeV1Node});
+        break;
+      case ChunkIndexType::kBtreeV2: {
+        const uint64_t size = GetBtreeV2HeaderSize(format);
+        self->pending_.push_back(BlockRequest{layout.address, size, size,
+                                              &ListState::OnBtreeV2Header});
+        break;
+      }
+      case ChunkIndexType::kFixedArray: {
+        const uint64_t size = GetFixedArrayHeaderSize(format);
+        self->pending_.push_back(BlockRequest{layout.address, size, size,
+                                              &ListState::OnFixedArrayHeader});
+        break;
+      }
+      case ChunkIndexType::kExtensibleArray: {
+        const uint64_t size = GetExtensibleArrayHeaderSize(format);
+        self->pending_.push_back(BlockRequest{
+            layout.address, size, size, &ListState::OnExtensibleArrayHeader});
+        break;
+      }
+      default:
+        self->promise_.SetResult(absl::UnimplementedError(tensorstore::StrCat(
+            "HDF5 chunk index type ", static_cast<int>(layout.chunk_index_type),
+            " is not supported")));
+        return;
+    }
+    ReadPending(std::move(self));
+  }
+
+  /// Reads all pending blocks, or completes the listing if there are none.
+  static void ReadPending(Ptr self) {
+    if (!self->promise_.result_needed()) return;
+    if (self->pending_.empty()) {
+      self->result_.stamp = self->stamp_;
+      self->promise_.SetResult(std::move(self->result_));
+      return;
+    }
+    auto requests = std::exchange(self->pending_, {});
+    std::vector<internal::PinnedCacheEntry<ChunkIndexCache>> entries;
+    std::vector<AnyFuture> futures;
+    entries.reserve(requests.size());
+    futures.reserve(requests.size());
+    {
+      auto batch = Batch::New();
+      internal::AsyncCache::AsyncCacheReadRequest request;
+      request.staleness_bound = self->staleness_bound_;
+      request.batch = batch;
+      for (const auto& block : requests) {
+        entries.push_back(GetCacheEntry(
+            self->cache_,
+            ChunkIndexCache::EncodeBlockKey(block.address, block.size,
+                                            block.checksummed_size)));
+        futures.push_back(entries.back()->Read(request));
+      }
+    }
+    WaitAllFuture(futures)
+        .ExecuteWhenReady([self = std::move(self),
+                           requests = std::move(requests),
+                           entries = std::move(entries)](
+                              ReadyFuture<void> future) mutable {
+          OnBlocksReady(std::move(self), requests, entries, future.result());
+        });
+  }
+
+  static void OnBlocksReady(
+      Ptr self, span<const BlockRequest> requests,
+      span<const internal::PinnedCacheEntry<ChunkIndexCache>> entries,
+      const Result<void>& result) {
+    if (!result.ok()) {
+      self->promise_.SetResult(result.status());
+      return;
+    }
+    if (!self->promise_.result_needed()) return;
+    for (size_t i = 0; i < requests.size(); ++i) {
+      std::shared_ptr<const absl::Cord> block;
+      TimestampedStorageGeneration stamp;
+      {
+        internal::AsyncCache::ReadLock<absl::Cord> lock(*entries[i]);
+        block = lock.shared_data();
+        stamp = lock.stamp();
+      }
+      auto& self_stamp = self->stamp_;
+      if (StorageGeneration::IsUnknown(self_stamp.generation)) {
+        self_stamp = std::move(stamp);
+      } else if (stamp.generation != self_stamp.generation) {
+        // The file was modified between the reads of two blocks.  Restart
+        // from the root, excluding the older of the two generations.
+        self->staleness_bound_ = std::max(self_stamp.time, stamp.time);
+        Start(std::move(self));
+        return;
+      } else {
+        self_stamp.time = std::max(self_stamp.time, stamp.time);
+      }
+      if (!block) {
+        // The file does not exist.
+        ChunkListResult result;
+        result.stamp = self->stamp_;
+        self->promise_.SetResult(std::move(result));
+        return;
+      }
+      const auto& request = requests[i];
+      TENSORSTORE_RETURN_IF_ERROR(
+          (self.get()->*request.handler)(request, *block->TryFlat()),
+          static_cast<void>(self->promise_.SetResult(
+              tensorstore::MaybeAnnotateStatus(
+                  _, "Error reading HDF5 chunk index"))));
+    }
+    ReadPending(std::move(self));
+  }
+
+  void AddChunk(span<const Index> cell_indices) {
+    AddListedChunk(result_, cell_indices);
+  }
+
+  void AddLinearChunk(uint64_t linear_index) {
+    Index cell_indices[kMaxRank];
+    span<Index> cell_indices_span(&cell_indices[0], params().rank());
+    if (linear_index > static_cast<uint64_t>(kMaxFiniteIndex) ||
+        !GetChunkCellIndices(params(), static_cast<Index>(linear_index),
+                             cell_indices_span)) {
+      // Entries past the maximum shape are never allocated.
+      return;
+    }
+    AddChunk(cell_indices_span);
+  }
+
+  absl::Status OnBtreeV1Node(const BlockRequest& request,
+                             std::string_view block) {
+    const DimensionIndex rank = params().rank();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto node, DecodeBtreeV1ChunkNode(absl::Cord(block), format(), rank));
+    if (request.level != -1 && node.level != request.level) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Expected B-tree node at level ", request.level,
+          " but received level ", node.level));
+    }
+    const uint64_t size = GetBtreeV1ChunkNodeSize(format(), rank);
+    for (size_t i = 0; i < node.children.size(); ++i) {
+      if (node.level != 0) {
+        BlockRequest child{node.children[i], size, /*checksummed_size=*/0,
+                           &ListState::OnBtreeV1Node};
+        child.level = node.level - 1;
+        pending_.push_back(child);
+        continue;
+      }
+      const auto& offsets = node.keys[i].offsets;
+      Index cell_indices[kMaxRank];
+      for (DimensionIndex j = 0; j < rank; ++j) {
+        cell_indices[j] =
+            static_cast<Index>(offsets[j] / params().chunk_shape[j]);
+      }
+      AddChunk(span<const Index>(&cell_indices[0], rank));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status OnBtreeV2Header(const BlockRequest& request,
+                               std::string_view block) {
+    TENSORSTORE_ASSIGN_OR_RETURN(btree_v2_header_,
+                                 DecodeBtreeV2Header(block, format()));
+    const auto& header = btree_v2_header_;
+    if (header.record_type != kBtreeV2UnfilteredChunkRecordType &&
+        header.record_type != kBtreeV2FilteredChunkRecordType) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Expected B-tree of chunks but received record type ",
+          header.record_type));
+    }
+    if (header.root_address == kUndefinedAddress ||
+        header.total_num_records == 0) {
+      return absl::OkStatus();
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(btree_v2_layout_,
+                                 GetBtreeV2NodeLayout(header, format()));
+    return AddBtreeV2Node(header.root_address, header.depth,
+                          header.root_num_records);
+  }
+
+  absl::Status AddBtreeV2Node(uint64_t address, uint16_t depth,
+                              uint64_t num_records) {
+    if (num_records > btree_v2_layout_.max_num_records[depth]) {
+      return absl::DataLossError(
+          tensorstore::StrCat("Invalid number of records ", num_records,
+                              " for B-tree node at depth ", depth));
+    }
+    const uint64_t size = GetBtreeV2NodeSize(
+        btree_v2_header_, btree_v2_layout_, format(), depth, num_records);
+    BlockRequest request{address, size, size, &ListState::OnBtreeV2Node};
+    request.level = depth;
+    request.num_records = num_records;
+    pending_.push_back(request);
+    return absl::OkStatus();
+  }
+
+  absl::Status OnBtreeV2Node(const BlockRequest& request,
+                             std::string_view block) {
+    const auto depth = static_cast<uint16_t>(request.level);
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto node,
+        DecodeBtreeV2ChunkNode(block, btree_v2_header_, btree_v2_layout_,
+                               params(), depth, request.num_records));
+    const DimensionIndex rank = params().rank();
+    for (const auto& record : node.records) {
+      Index cell_indices[kMaxRank];
+      for (DimensionIndex j = 0; j < rank; ++j) {
+        cell_indices[j] = static_cast<Index>(record.cell_indices[j]);
+      }
+      AddChunk(span<const Index>(&cell_indices[0], rank));
+    }
+    if (depth == 0) return absl::OkStatus();
+    for (const auto& child : node.children) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          AddBtreeV2Node(child.address, depth - 1, child.num_records));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status OnFixedArrayHeader(const BlockRequest& request,
+                                  std::string_view block) {
+    TENSORSTORE_ASSIGN_OR_RETURN(fixed_array_header_,
+                                 DecodeFixedArrayHeader(block, format()));
+    const auto& header = fixed_array_header_;
+    if (header.data_block_address == kUndefinedAddress) {
+      return absl::OkStatus();
+    }
+    client_id_ = header.client_id;
+    element_size_ = header.entry_size;
+    const uint64_t size = GetFixedArrayDataBlockSize(header, format());
+    pending_.push_back(BlockRequest{header.data_block_address, size, size,
+                                    &ListState::OnFixedArrayDataBlock});
+    return absl::OkStatus();
+  }
+
+  absl::Status OnFixedArrayDataBlock(const BlockRequest& request,
+                                     std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "FADB"));
+    const auto& header = fixed_array_header_;
+    const uint64_t prefix_size = 6 + format().size_of_offsets;
+    const uint64_t page_entries = uint64_t{1} << header.page_bits;
+    if (header.max_num_entries <= page_entries) {
+      BlockRequest elements = request;
+      elements.element_offset = prefix_size;
+      elements.num_elements = header.max_num_entries;
+      return AddArrayElements(elements, block);
+    }
+    const uint64_t num_pages =
+        (header.max_num_entries + page_entries - 1) / page_entries;
+    const uint64_t bitmap_size = (num_pages + 7) / 8;
+    const std::string_view bitmap = block.substr(prefix_size, bitmap_size);
+    const uint64_t full_page_size = page_entries * header.entry_size + 4;
+    for (uint64_t page = 0; page < num_pages; ++page) {
+      // Pages that have not been initialized contain no chunks.
+      if (!GetBit(bitmap, page)) continue;
+      const uint64_t first_element = page * page_entries;
+      const uint64_t num_elements =
+          std::min(page_entries, header.max_num_entries - first_element);
+      const uint64_t page_size = num_elements * header.entry_size + 4;
+      BlockRequest page_request{
+          header.data_block_address + prefix_size + bitmap_size + 4 +
+              page * full_page_size,
+          page_size, page_size, &ListState::AddArrayElements};
+      page_request.first_element = first_element;
+      page_request.num_elements = num_elements;
+      pending_.push_back(page_request);
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status OnExtensibleArrayHeader(const BlockRequest& request,
+                                       std::string_view block) {
+    TENSORSTORE_ASSIGN_OR_RETURN(extensible_array_header_,
+                                 DecodeExtensibleArrayHeader(block, format()));
+    const auto& header = extensible_array_header_;
+    if (header.index_block_address == kUndefinedAddress ||
+        header.max_index_set == 0) {
+      return absl::OkStatus();
+    }
+    client_id_ = header.client_id;
+    element_size_ = header.element_size;
+    const uint64_t size = GetExtensibleArrayIndexBlockSize(header, format());
+    pending_.push_back(BlockRequest{header.index_block_address, size, size,
+                                    &ListState::OnExtensibleArrayIndexBlock});
+    return absl::OkStatus();
+  }
+
+  absl::Status OnExtensibleArrayIndexBlock(const BlockRequest& request,
+                                           std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "EAIB"));
+    const auto& header = extensible_array_header_;
+    const uint64_t address_size = format().size_of_offsets;
+    const uint64_t prefix_size = 6 + address_size;
+    BlockRequest elements = request;
+    elements.element_offset = prefix_size;
+    elements.num_elements = header.index_block_elements;
+    TENSORSTORE_RETURN_IF_ERROR(AddArrayElements(elements, block));
+    const char* addresses =
+        block.data() + prefix_size +
+        header.index_block_elements * header.element_size;
+    const uint64_t min_elements = header.data_block_min_elements;
+    const uint64_t num_direct_super_blocks =
+        GetNumIndexBlockSuperBlocks(header);
+    const uint64_t num_super_blocks =
+        num_direct_super_blocks + GetNumIndexBlockSecondaryBlocks(header);
+    uint64_t data_block = 0;
+    for (uint64_t u = 0; u < num_super_blocks; ++u) {
+      const uint64_t first_element =
+          header.index_block_elements +
+          min_elements * ((uint64_t{1} << u) - 1);
+      if (first_element >= header.max_index_set) break;
+      const uint64_t num_data_blocks = uint64_t{1} << (u / 2);
+      const uint64_t data_block_num_elements = min_elements
+                                               << ((u + 1) / 2);
+      if (u < num_direct_super_blocks) {
+        for (uint64_t j = 0; j < num_data_blocks; ++j, ++data_block) {
+          AddExtensibleArrayDataBlock(
+              LoadAddress(addresses + data_block * address_size, format()),
+              first_element + j * data_block_num_elements,
+              data_block_num_elements, /*bitmap=*/{});
+        }
+        continue;
+      }
+      const uint64_t address = LoadAddress(
+          addresses + (GetNumIndexBlockDataBlocks(header) + u -
+                       num_direct_super_blocks) *
+                          address_size,
+          format());
+      if (address == kUndefinedAddress) continue;
+      const uint64_t size =
+          prefix_size + GetArrayOffsetSize(header) +
+          GetSecondaryBlockBitmapSize(header, num_data_blocks,
+                                      data_block_num_elements) +
+          num_data_blocks * address_size + 4;
+      BlockRequest secondary{address, size, size,
+                             &ListState::OnExtensibleArraySecondaryBlock};
+      secondary.level = u;
+      secondary.first_element = first_element;
+      pending_.push_back(secondary);
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status OnExtensibleArraySecondaryBlock(const BlockRequest& request,
+                                               std::string_view block) {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateBlockSignature(block, "EASB"));
+    const auto& header = extensible_array_header_;
+    const uint64_t address_size = format().size_of_offsets;
+    const uint64_t u = request.level;
+    const uint64_t num_data_blocks = uint64_t{1} << (u / 2);
+    const uint64_t data_block_num_elements =
+        uint64_t{header.data_block_min_elements} << ((u + 1) / 2);
+    const uint64_t num_pages =
+        GetNumDataBlockPages(header, data_block_num_elements);
+    const uint64_t bitmap_offset =
+        6 + address_size + GetArrayOffsetSize(header);
+    const uint64_t bitmap_size = GetSecondaryBlockBitmapSize(
+        header, num_data_blocks, data_block_num_elements);
+    const std::string_view bitmap = block.substr(bitmap_offset, bitmap_size);
+    for (uint64_t j = 0; j < num_data_blocks; ++j) {
+      const uint64_t address = LoadAddress(
+          block.data() + bitmap_offset + bitmap_size + j * address_size,
+          format());
+      AddExtensibleArrayDataBlock(
+          address, request.first_element + j * data_block_num_elements,
+          data_block_num_elements,
+          num_pages == 0 ? std::string_view() : bitmap, j * num_pages);
+    }
+    return absl::OkStatus();
+  }
+
+  /// Requests the data block at `address`, or the initialized pages of the
+  /// data block if it is paged.
+  ///
+  /// \param bitmap Page initialization bitmap, or empty if all pages are
+  ///     assumed to be initialized.
+  /// \param first_page Index within `bitmap` of the first page.
+  void AddExtensibleArrayDataBlock(uint64_t address, uint64_t first_element,
+                                   uint64_t num_elements,
+                                   std::string_view bitmap,
+                                   uint64_t first_page = 0) {
+    const auto& header = extensible_array_header_;
+    if (address == kUndefinedAddress ||
+        first_element >= header.max_index_set) {
+      return;
+    }
+    const uint64_t prefix_size =
+        6 + format().size_of_offsets + GetArrayOffsetSize(header);
+    const uint64_t num_pages = GetNumDataBlockPages(header, num_elements);
+    if (num_pages == 0) {
+      const uint64_t size = prefix_size + num_elements * element_size_ + 4;
+      BlockRequest request{address, size, size, &ListState::AddArrayElements};
+      request.signature = "EADB";
+      request.element_offset = prefix_size;
+      request.first_element = first_element;
+      request.num_elements =
+          std::min(num_elements, header.max_index_set - first_element);
+      pending_.push_back(request);
+      return;
+    }
+    const uint64_t page_elements = GetDataBlockPageElements(header);
+    const uint64_t page_size = page_elements * element_size_ + 4;
+    for (uint64_t page = 0; page < num_pages; ++page) {
+      const uint64_t page_first_element = first_element + page * page_elements;
+      if (page_first_element >= header.max_index_set) break;
+      if (!bitmap.empty() && !GetBit(bitmap, first_page + page)) continue;
+      BlockRequest request{address + prefix_size + 4 + page * page_size,
+                           page_size, page_size, &ListState::AddArrayElements};
+      request.first_element = page_first_element;
+      request.num_elements =
+          std::min(page_elements, header.max_index_set - page_first_element);
+      pending_.push_back(request);
+    }
+  }
+
+  /// Adds the allocated chunks of the array elements stored in `block`.
+  absl::Status AddArrayElements(const BlockRequest& request,
+                                std::string_view block) {
+    if (!request.signature.empty()) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          ValidateBlockSignature(block, request.signature));
+    }
+    if (request.element_offset + request.num_elements * element_size_ >
+        block.size()) {
+      return absl::DataLossError("Array elements are past end of block");
+    }
+    const uint64_t unfiltered_chunk_size = params().GetUnfilteredChunkSize();
+    for (uint64_t i = 0; i < request.num_elements; ++i) {
+      const auto entry = LoadArrayChunkEntry(
+          block.data() + request.element_offset + i * element_size_,
+          client_id_, element_size_, format(), unfiltered_chunk_size);
+      if (!entry.IsMissing()) AddLinearChunk(request.first_element + i);
+    }
+    return absl::OkStatus();
+  }
+};
+
+/// Lists the chunks of a dataset using an index that is fully specified by
+/// the data layout message.
+ChunkListResult ListDirectChunks(const ChunkIndexParameters& params) {
+  const auto& layout = params.layout;
+  const DimensionIndex rank = params.rank();
+  ChunkListResult result;
+  result.stamp = TimestampedStorageGeneration{StorageGeneration::Unknown(),
+                                              absl::InfiniteFuture()};
+  std::vector<Index> cell_indices(rank);
+  if (layout.layout_class == LayoutClass::kContiguous) {
+    // Virtual chunks are only partitioned along the first dimension.
+    const uint64_t chunk_size = params.GetUnfilteredChunkSize();
+    const uint64_t num_chunks =
+        chunk_size == 0 ? 0 : (layout.size + chunk_size - 1) / chunk_size;
+    for (uint64_t i = 0; i < num_chunks; ++i) {
+      if (rank != 0) cell_indices[0] = static_cast<Index>(i);
+      AddListedChunk(result, cell_indices);
+      if (rank == 0) break;
+    }
+    return result;
+  }
+  if (layout.layout_class == LayoutClass::kCompact ||
+      layout.chunk_index_type == ChunkIndexType::kSingleChunk) {
+    AddListedChunk(result, cell_indices);
+    return result;
+  }
+  // All chunks of the implicit index are allocated.
+  for (Index i = 0; GetChunkCellIndices(params, i, cell_indices); ++i) {
+    AddListedChunk(result, cell_indices);
+    if (rank == 0) break;
+  }
+  return result;
+}
+
+}  // namespace
+
+Future<ChunkLookupResult> LookupChunk(internal::CachePtr<ChunkIndexCache> cache,
+                                      span<const Index> cell_indices,
+                                      absl::Time staleness_bound, Batch batch) {
+  const auto& params = cache->index_params();
+  const DimensionIndex rank = params.rank();
+  assert(cell_indices.size() == rank);
+  const auto& layout = params.layout;
+  if (layout.layout_class == LayoutClass::kCompact) {
+    return absl::InvalidArgumentError(
+        "Dataset using compact layout has no chunks within the file");
+  }
+  if (layout.address == kUndefinedAddress) {
+    // Chunk index or raw data has not been allocated, all chunks are missing.
+    return ChunkLookupResult{ChunkIndexEntry::Missing(),
+                             TimestampedStorageGeneration{
+                                 StorageGeneration::NoValue(), absl::Now()}};
+  }
+  if (layout.layout_class == LayoutClass::kContiguous) {
+    return ChunkLookupResult{
+        GetContiguousChunkEntry(params, cell_indices),
+        TimestampedStorageGeneration{StorageGeneration::Unknown(),
+                                     absl::InfiniteFuture()}};
+  }
+  if (layout.chunk_index_type == ChunkIndexType::kSingleChunk ||
+      layout.chunk_index_type == ChunkIndexType::kImplicit) {
+    // The location does not depend on any other metadata stored in the file.
+    return ChunkLookupResult{
+        GetDirectChunkEntry(params, cell_indices),
+        TimestampedStorageGeneration{StorageGeneration::Unknown(),
+                                     absl::InfiniteFuture()}};
+  }
+  auto state = internal::MakeIntrusivePtr<LookupState>();
+  state->cell_indices_.assign(cell_indices.begin(), cell_indices.end());
+  state->offsets_.resize(rank + 1);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    state->offsets_[i] =
+        static_cast<uint64_t>(cell_indices[i] * params.chunk_shape[i]);
+  }
+  if (layout.chunk_index_type == ChunkIndexType::kFixedArray ||
+      layout.chunk_index_type == ChunkIndexType::kExtensibleArray) {
+    state->linear_index_ = GetLinearChunkIndex(params, cell_indices);
+  }
+  state->cache_ = std::move(cache);
+  state->staleness_bound_ = staleness_bound;
+  state->batch_ = std::move(batch);
+  auto [promise, future] = PromiseFuturePair<ChunkLookupResult>::Make();
+  state->promise_ = std::move(promise);
+  LookupState::Start(std::move(state));
+  return std::move(future);
+}
+
+Future<ChunkListResult> ListChunks(internal::CachePtr<ChunkIndexCache> cache,
+                                   absl::Time staleness_bound) {
+  const auto& params = cache->index_params();
+  const auto& layout = params.layout;
+  if (layout.layout_class != LayoutClass::kCompact &&
+      layout.address == kUndefinedAddress) {
+    // Chunk index or raw data has not been allocated.
+    ChunkListResult result;
+    result.stamp = TimestampedStorageGeneration{StorageGeneration::NoValue(),
+                                                absl::Now()};
+    return result;
+  }
+  if (layout.layout_class != LayoutClass::kChunked ||
+      layout.chunk_index_type == ChunkIndexType::kSingleChunk ||
+      layout.chunk_index_type == ChunkIndexType::kImplicit) {
+    return ListDirectChunks(params);
+  }
+  auto state = internal::MakeIntrusivePtr<ListState>();
+  state->cache_ = std::move(cache);
+  state->staleness_bound_ = staleness_bound;
+  auto [promise, future] = PromiseFuturePair<ChunkListResult>::Make();
+  state->promise_ = std::move(promise);
+  ListState::Start(std::move(state));
+  return std::move(future);
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,199 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_CACHE_H_
+#define TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_CACHE_H_
+
+/// \file
+///
+/// Cached lookups in the chunk index of an HDF5 dataset.
+///
+/// The metadata blocks of the chunk index (version 1 and 2 B-tree nodes, and
+/// the headers and blocks of fixed and extensible arrays) are read lazily, as
+/// required by each lookup, and retained in a `ChunkIndexCache` within the
+/// cache pool.  Blocks are only re-read from the file when their cached
+/// generation does not satisfy the staleness bound of a lookup, such that
+/// repeated lookups normally perform no index I/O at all.
+///
+/// In addition, the results of lookups are memoized for the current
+/// generation of the file.  A memoized result is used once the root of the
+/// index, which is always read first, is found to be at the same generation.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Result of a chunk lookup.
+struct ChunkLookupResult {
+  /// Location of the chunk, or `ChunkIndexEntry::Missing()`.
+  ChunkIndexEntry entry;
+
+  /// Generation of the file from which the index was read.
+  ///
+  /// For the single chunk and implicit indexes, which are fully specified by
+  /// the dataset metadata, the generation is `StorageGeneration::Unknown()`.
+  TimestampedStorageGeneration stamp;
+};
+
+/// Result of listing the chunks of a dataset.
+struct ChunkListResult {
+  /// Grid cell indices of the allocated chunks, concatenated, such that chunk
+  /// `i` has cell indices `cell_indices[i * rank, (i + 1) * rank)`.  Chunks
+  /// are listed in index order rather than in any particular order of their
+  /// cell indices.
+  std::vector<Index> cell_indices;
+
+  /// Number of allocated chunks.
+  size_t num_chunks = 0;
+
+  /// Generation of the file from which the index was read, see
+  /// `ChunkLookupResult::stamp`.
+  TimestampedStorageGeneration stamp;
+};
+
+/// Cache of the metadata blocks of the chunk index of a single dataset.
+///
+/// Each entry corresponds to a single block, identified by its address, size
+/// and the size of the prefix covered by its checksum.
+class ChunkIndexCache
+    : public internal::KvsBackedCache<ChunkIndexCache, internal::AsyncCache> {
+  using Base = internal::KvsBackedCache<ChunkIndexCache, internal::AsyncCache>;
+
+ public:
+  /// Contents of the block, flattened.
+  using ReadData = absl::Cord;
+
+  explicit ChunkIndexCache(kvstore::DriverPtr base_kvstore,
+                           std::string base_kvstore_path, Executor executor,
+                           ChunkIndexParameters index_params);
+
+  class Entry : public Base::Entry {
+   public:
+    using OwningCache = ChunkIndexCache;
+
+    size_t ComputeReadDataSizeInBytes(const void* read_data) override;
+
+    void DoDecode(std::optional<absl::Cord> value,
+                  DecodeReceiver receiver) override;
+  };
+
+  using typename Base::TransactionNode;
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    return new TransactionNode(static_cast<Entry&>(entry));
+  }
+
+  /// Returns the cache entry key of the block at `address`.
+  ///
+  /// \param size Size in bytes of the block.
+  /// \param checksummed_size Size in bytes of the prefix of the block that
+  ///     ends with a checksum, or `0` if the block is not checksummed.
+  static std::string EncodeBlockKey(uint64_t address, uint64_t size,
+                                    uint64_t checksummed_size);
+
+  /// Returns the memoized location of the chunk at `cell_indices`, if the
+  /// chunk was previously looked up at `generation`.
+  std::optional<ChunkIndexEntry> GetMemoizedEntry(
+      const StorageGeneration& generation, span<const Index> cell_indices);
+
+  /// Memoizes the location of the chunk at `cell_indices`, as looked up at
+  /// `generation`.  Locations memoized for any other generation are
+  /// discarded.
+  void MemoizeEntry(const StorageGeneration& generation,
+                    span<const Index> cell_indices,
+                    const ChunkIndexEntry& entry);
+
+  kvstore::Driver* base_kvstore_driver() const { return base_kvstore_.get(); }
+  const std::string& base_kvstore_path() const { return base_kvstore_path_; }
+  const Executor& executor() const { return executor_; }
+  const ChunkIndexParameters& index_params() const { return index_params_; }
+
+ private:
+  kvstore::DriverPtr base_kvstore_;
+  std::string base_kvstore_path_;
+  Executor executor_;
+  ChunkIndexParameters index_params_;
+
+  absl::Mutex memo_mutex_;
+  StorageGeneration memo_generation_ ABSL_GUARDED_BY(memo_mutex_);
+  absl::flat_hash_map<std::string, ChunkIndexEntry> memo_
+      ABSL_GUARDED_BY(memo_mutex_);
+};
+
+/// Returns the chunk index cache for the dataset specified by `index_params`
+/// within the file at `base_kvstore_path` in `base_kvstore`.
+///
+/// Equivalent datasets share the same cache.
+internal::CachePtr<ChunkIndexCache> GetChunkIndexCache(
+    internal::CachePool* pool, kvstore::DriverPtr base_kvstore,
+    std::string base_kvstore_path, Executor executor,
+    const ChunkIndexParameters& index_params);
+
+/// Looks up the location of the chunk at `cell_indices`.
+///
+/// All index blocks are read at a single generation of the file; if the file
+/// is concurrently modified the lookup is restarted.
+///
+/// \param staleness_bound Cached index blocks older than `staleness_bound`
+///     are revalidated.
+/// \param batch Batch used for the first read of the lookup.
+Future<ChunkLookupResult> LookupChunk(internal::CachePtr<ChunkIndexCache> cache,
+                                      span<const Index> cell_indices,
+                                      absl::Time staleness_bound, Batch batch);
+
+/// Lists the grid cell indices of all allocated chunks.
+///
+/// The entire index is read once, one level at a time, with the blocks of
+/// each level requested within a single batch.  This is much cheaper than
+/// looking up each chunk of a region individually.  Blocks are shared with
+/// `LookupChunk` through `cache`.
+///
+/// For the contiguous and compact layouts, all virtual chunks of the raw
+/// data are listed.
+///
+/// \param staleness_bound Cached index blocks older than `staleness_bound`
+///     are revalidated.
+Future<ChunkListResult> ListChunks(internal::CachePtr<ChunkIndexCache> cache,
+                                   absl::Time staleness_bound);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_CHUNK_INDEX_CACHE_H_
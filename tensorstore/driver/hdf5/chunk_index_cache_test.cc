@@ -0,0 +1,476 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_index_cache.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/memory/memory_key_value_store.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::InlineExecutor;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::kInfSize;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::CachePool;
+using ::tensorstore::internal_hdf5::ChunkIndexCache;
+using ::tensorstore::internal_hdf5::ChunkIndexEntry;
+using ::tensorstore::internal_hdf5::ChunkIndexParameters;
+using ::tensorstore::internal_hdf5::ChunkIndexType;
+using ::tensorstore::internal_hdf5::ChunkLookupResult;
+using ::tensorstore::internal_hdf5::GetBtreeV1ChunkNodeSize;
+using ::tensorstore::internal_hdf5::GetChunkIndexCache;
+using ::tensorstore::internal_hdf5::kUndefinedAddress;
+using ::tensorstore::internal_hdf5::LayoutClass;
+using ::tensorstore::internal_hdf5::ListChunks;
+using ::tensorstore::internal_hdf5::LookupChunk;
+using ::tensorstore::internal_hdf5::Lookup3Checksum;
+using ::testing::ElementsAre;
+
+void AppendLittleEndian(std::string& out, uint64_t value, int size) {
+  for (int i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+// Appends the checksum of all bytes of `out` starting at `start`.
+void AppendChecksum(std::string& out, size_t start) {
+  AppendLittleEndian(out, Lookup3Checksum(std::string_view(out).substr(start)),
+                     4);
+}
+
+struct TestKey {
+  uint32_t chunk_size;
+  uint32_t filter_mask;
+  std::vector<uint64_t> offsets;
+};
+
+// Encodes a v1 B-tree chunk node with 8-byte addresses.
+std::string EncodeBtreeV1Node(uint8_t level, const std::vector<TestKey>& keys,
+                              const std::vector<uint64_t>& children) {
+  std::string out = "TREE";
+  out.push_back(1);
+  out.push_back(static_cast<char>(level));
+  AppendLittleEndian(out, children.size(), 2);
+  AppendLittleEndian(out, kUndefinedAddress, 8);
+  AppendLittleEndian(out, kUndefinedAddress, 8);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    AppendLittleEndian(out, keys[i].chunk_size, 4);
+    AppendLittleEndian(out, keys[i].filter_mask, 4);
+    for (uint64_t offset : keys[i].offsets) {
+      AppendLittleEndian(out, offset, 8);
+    }
+    if (i < children.size()) AppendLittleEndian(out, children[i], 8);
+  }
+  return out;
+}
+
+// Appends the prefix of a checksummed metadata structure.
+void AppendPrefix(std::string& out, std::string_view signature,
+                  uint8_t type) {
+  out += signature;
+  out.push_back(0);  // version
+  out.push_back(static_cast<char>(type));
+}
+
+class ChunkIndexCacheTest : public ::testing::Test {
+ protected:
+  ChunkIndexCacheTest() {
+    params_.format.indexed_storage_k = 2;
+    params_.layout.address = 0;
+    params_.shape = {8, 8};
+    params_.chunk_shape = {4, 4};
+    params_.element_size = 1;
+  }
+
+  void WriteFile(const std::string& file) {
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::kvstore::Write(store_, "a.h5", absl::Cord(file)));
+  }
+
+  Result<ChunkLookupResult> Lookup(
+      std::vector<Index> cell_indices,
+      absl::Time staleness_bound = absl::InfiniteFuture()) {
+    if (!cache_) {
+      cache_ = GetChunkIndexCache(pool_.get(), store_, "a.h5",
+                                  InlineExecutor{}, params_);
+    }
+    return LookupChunk(cache_, cell_indices, staleness_bound,
+                       tensorstore::no_batch)
+        .result();
+  }
+
+  Result<ChunkIndexEntry> LookupEntry(std::vector<Index> cell_indices) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto result, Lookup(cell_indices));
+    return result.entry;
+  }
+
+  // Returns the sorted cell indices of the chunks listed by `ListChunks`.
+  Result<std::vector<std::vector<Index>>> List() {
+    if (!cache_) {
+      cache_ = GetChunkIndexCache(pool_.get(), store_, "a.h5",
+                                  InlineExecutor{}, params_);
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto result, ListChunks(cache_, absl::InfiniteFuture()).result());
+    const size_t rank = params_.rank();
+    std::vector<std::vector<Index>> chunks;
+    for (size_t i = 0; i < result.num_chunks; ++i) {
+      chunks.emplace_back(result.cell_indices.begin() + i * rank,
+                          result.cell_indices.begin() + (i + 1) * rank);
+    }
+    std::sort(chunks.begin(), chunks.end());
+    return chunks;
+  }
+
+  CachePool::StrongPtr pool_ = CachePool::Make(CachePool::Limits{});
+  tensorstore::kvstore::DriverPtr store_ =
+      tensorstore::GetMemoryKeyValueStore();
+  ChunkIndexParameters params_;
+  tensorstore::internal::CachePtr<ChunkIndexCache> cache_;
+};
+
+// Returns a file with a two-level v1 B-tree, where the chunk at `(0, 1)` is
+// located at `chunk_address`.
+std::string GetBtreeV1File(uint64_t chunk_address) {
+  tensorstore::internal_hdf5::FormatParameters format;
+  format.indexed_storage_k = 2;
+  const uint64_t node_size = GetBtreeV1ChunkNodeSize(format, 2);
+  std::string file = EncodeBtreeV1Node(
+      1, {{0, 0, {0, 0, 0}}, {0, 0, {4, 0, 0}}, {0, 0, {8, 0, 0}}},
+      {node_size, 2 * node_size});
+  file.resize(node_size);
+  file += EncodeBtreeV1Node(
+      0, {{16, 0, {0, 0, 0}}, {12, 1, {0, 4, 0}}, {0, 0, {0, 8, 0}}},
+      {5000, chunk_address});
+  file.resize(2 * node_size);
+  file +=
+      EncodeBtreeV1Node(0, {{20, 0, {4, 4, 0}}, {0, 0, {8, 0, 0}}}, {7000});
+  file.resize(3 * node_size);
+  return file;
+}
+
+TEST_F(ChunkIndexCacheTest, BtreeV1) {
+  WriteFile(GetBtreeV1File(6000));
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry{6000, 12, 1}));
+  EXPECT_THAT(LookupEntry({1, 1}), IsOkAndHolds(ChunkIndexEntry{7000, 20, 0}));
+  EXPECT_THAT(LookupEntry({1, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(LookupEntry({0, 0}), IsOkAndHolds(ChunkIndexEntry{5000, 16, 0}));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(ElementsAre(0, 0),
+                                               ElementsAre(0, 1),
+                                               ElementsAre(1, 1))));
+}
+
+TEST_F(ChunkIndexCacheTest, Revalidation) {
+  WriteFile(GetBtreeV1File(6000));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result1, Lookup({0, 1}));
+  EXPECT_EQ((ChunkIndexEntry{6000, 12, 1}), result1.entry);
+
+  WriteFile(GetBtreeV1File(6500));
+  // Cached index blocks and memoized results satisfy an old staleness bound.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result2,
+                                   Lookup({0, 1}, absl::InfinitePast()));
+  EXPECT_EQ(result1.entry, result2.entry);
+  EXPECT_EQ(result1.stamp.generation, result2.stamp.generation);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result3, Lookup({0, 1}, absl::Now()));
+  EXPECT_EQ((ChunkIndexEntry{6500, 12, 1}), result3.entry);
+  EXPECT_NE(result1.stamp.generation, result3.stamp.generation);
+}
+
+TEST_F(ChunkIndexCacheTest, MissingFile) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, Lookup({0, 0}));
+  EXPECT_TRUE(result.entry.IsMissing());
+  EXPECT_TRUE(StorageGeneration::IsNoValue(result.stamp.generation));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre()));
+}
+
+TEST_F(ChunkIndexCacheTest, UnallocatedIndex) {
+  params_.layout.address = kUndefinedAddress;
+  EXPECT_THAT(LookupEntry({0, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+}
+
+TEST_F(ChunkIndexCacheTest, BtreeV2) {
+  params_.layout.chunk_index_type = ChunkIndexType::kBtreeV2;
+  params_.shape = {12, 8};
+  // Unfiltered records of 8 + 2 * 8 bytes, with 2 records per leaf node and
+  // 1 record per internal node.
+  constexpr uint32_t kNodeSize = 58;
+  std::string file;
+  AppendPrefix(file, "BTHD", 10);
+  AppendLittleEndian(file, kNodeSize, 4);
+  AppendLittleEndian(file, 24, 2);   // record size
+  AppendLittleEndian(file, 1, 2);    // depth
+  AppendLittleEndian(file, 100, 1);  // split percent
+  AppendLittleEndian(file, 40, 1);   // merge percent
+  AppendLittleEndian(file, 38, 8);   // root address
+  AppendLittleEndian(file, 1, 2);    // root number of records
+  AppendLittleEndian(file, 5, 8);    // total number of records
+  AppendChecksum(file, 0);
+  ASSERT_EQ(38, file.size());
+
+  const auto append_record = [&](uint64_t address, uint64_t i, uint64_t j) {
+    AppendLittleEndian(file, address, 8);
+    AppendLittleEndian(file, i, 8);
+    AppendLittleEndian(file, j, 8);
+  };
+  AppendPrefix(file, "BTIN", 10);
+  append_record(3000, 1, 0);
+  AppendLittleEndian(file, 90, 8);
+  AppendLittleEndian(file, 2, 1);
+  AppendLittleEndian(file, 148, 8);
+  AppendLittleEndian(file, 2, 1);
+  AppendChecksum(file, 38);
+  ASSERT_EQ(90, file.size());
+
+  AppendPrefix(file, "BTLF", 10);
+  append_record(1000, 0, 0);
+  append_record(2000, 0, 1);
+  AppendChecksum(file, 90);
+  ASSERT_EQ(148, file.size());
+
+  AppendPrefix(file, "BTLF", 10);
+  append_record(4000, 1, 1);
+  append_record(5000, 2, 0);
+  AppendChecksum(file, 148);
+  WriteFile(file);
+
+  EXPECT_THAT(LookupEntry({1, 0}), IsOkAndHolds(ChunkIndexEntry{3000, 16, 0}));
+  EXPECT_THAT(LookupEntry({0, 0}), IsOkAndHolds(ChunkIndexEntry{1000, 16, 0}));
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry{2000, 16, 0}));
+  EXPECT_THAT(LookupEntry({2, 0}), IsOkAndHolds(ChunkIndexEntry{5000, 16, 0}));
+  EXPECT_THAT(LookupEntry({2, 1}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(
+                          ElementsAre(0, 0), ElementsAre(0, 1),
+                          ElementsAre(1, 0), ElementsAre(1, 1),
+                          ElementsAre(2, 0))));
+
+  // Corrupt the checksum of the second leaf node.
+  file.back() ^= 1;
+  WriteFile(file);
+  EXPECT_THAT(LookupEntry({2, 0}),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*[Cc]hecksum.*"));
+}
+
+// Returns a fixed array header for 4 filtered entries with 2 bytes for the
+// chunk size, followed by the data block at address 28.
+std::string GetFixedArrayHeader(uint8_t page_bits) {
+  std::string file;
+  AppendPrefix(file, "FAHD", 1);
+  file.push_back(8 + 2 + 4);  // entry size
+  file.push_back(static_cast<char>(page_bits));
+  AppendLittleEndian(file, 4, 8);   // max number of entries
+  AppendLittleEndian(file, 28, 8);  // data block address
+  AppendChecksum(file, 0);
+  return file;
+}
+
+void AppendFilteredEntry(std::string& out, uint64_t address, uint64_t size,
+                         uint32_t filter_mask) {
+  AppendLittleEndian(out, address, 8);
+  AppendLittleEndian(out, size, 2);
+  AppendLittleEndian(out, filter_mask, 4);
+}
+
+TEST_F(ChunkIndexCacheTest, FixedArray) {
+  params_.layout.chunk_index_type = ChunkIndexType::kFixedArray;
+  std::string file = GetFixedArrayHeader(/*page_bits=*/10);
+  ASSERT_EQ(28, file.size());
+  AppendPrefix(file, "FADB", 1);
+  AppendLittleEndian(file, 0, 8);  // header address
+  for (uint64_t i = 0; i < 3; ++i) {
+    AppendFilteredEntry(file, 1000 + i, 10 + i, i);
+  }
+  AppendFilteredEntry(file, kUndefinedAddress, 0, 0);
+  AppendChecksum(file, 28);
+  WriteFile(file);
+
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry{1001, 11, 1}));
+  EXPECT_THAT(LookupEntry({1, 0}), IsOkAndHolds(ChunkIndexEntry{1002, 12, 2}));
+  EXPECT_THAT(LookupEntry({1, 1}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(LookupEntry({2, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(ElementsAre(0, 0),
+                                               ElementsAre(0, 1),
+                                               ElementsAre(1, 0))));
+}
+
+TEST_F(ChunkIndexCacheTest, FixedArrayPaged) {
+  params_.layout.chunk_index_type = ChunkIndexType::kFixedArray;
+  // Two pages of two entries, of which only the first is initialized.
+  std::string file = GetFixedArrayHeader(/*page_bits=*/1);
+  AppendPrefix(file, "FADB", 1);
+  AppendLittleEndian(file, 0, 8);  // header address
+  file.push_back(static_cast<char>(0x80));
+  AppendChecksum(file, 28);
+  const size_t page_start = file.size();
+  AppendFilteredEntry(file, 1000, 10, 0);
+  AppendFilteredEntry(file, 1001, 11, 0);
+  AppendChecksum(file, page_start);
+  WriteFile(file);
+
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry{1001, 11, 0}));
+  EXPECT_THAT(LookupEntry({1, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(ElementsAre(0, 0),
+                                               ElementsAre(0, 1))));
+}
+
+TEST_F(ChunkIndexCacheTest, ExtensibleArray) {
+  params_.layout.chunk_index_type = ChunkIndexType::kExtensibleArray;
+  params_.shape = {6, 4};
+  params_.max_shape = {kInfSize, 4};
+  params_.chunk_shape = {1, 2};
+  params_.element_size = 2;
+
+  std::string file;
+  AppendPrefix(file, "EAHD", 0);
+  file.push_back(8);   // element size
+  file.push_back(32);  // max number of elements bits
+  file.push_back(2);   // index block elements
+  file.push_back(2);   // data block min elements
+  file.push_back(2);   // secondary block min data pointers
+  file.push_back(10);  // max data block page bits
+  for (uint64_t stat : {1, 38, 2, 92, 12, 12}) {
+    AppendLittleEndian(file, stat, 8);
+  }
+  AppendLittleEndian(file, 72, 8);  // index block address
+  AppendChecksum(file, 0);
+  ASSERT_EQ(72, file.size());
+
+  // Index block with 2 elements, 2 data block addresses and 30 secondary
+  // block addresses.
+  AppendPrefix(file, "EAIB", 0);
+  AppendLittleEndian(file, 0, 8);
+  AppendLittleEndian(file, 500, 8);
+  AppendLittleEndian(file, 501, 8);
+  AppendLittleEndian(file, 362, 8);
+  AppendLittleEndian(file, kUndefinedAddress, 8);
+  AppendLittleEndian(file, 400, 8);
+  for (int i = 1; i < 30; ++i) {
+    AppendLittleEndian(file, kUndefinedAddress, 8);
+  }
+  AppendChecksum(file, 72);
+  ASSERT_EQ(362, file.size());
+
+  // Data block of super block 0, with 2 elements.
+  AppendPrefix(file, "EADB", 0);
+  AppendLittleEndian(file, 0, 8);
+  AppendLittleEndian(file, 2, 4);  // block offset
+  AppendLittleEndian(file, 502, 8);
+  AppendLittleEndian(file, 503, 8);
+  AppendChecksum(file, 362);
+  ASSERT_EQ(400, file.size());
+
+  // Secondary block of super block 2, with 2 data blocks.
+  AppendPrefix(file, "EASB", 0);
+  AppendLittleEndian(file, 0, 8);
+  AppendLittleEndian(file, 8, 4);  // block offset
+  AppendLittleEndian(file, 438, 8);
+  AppendLittleEndian(file, kUndefinedAddress, 8);
+  AppendChecksum(file, 400);
+  ASSERT_EQ(438, file.size());
+
+  // Data block of super block 2, with 4 elements.
+  AppendPrefix(file, "EADB", 0);
+  AppendLittleEndian(file, 0, 8);
+  AppendLittleEndian(file, 8, 4);  // block offset
+  for (uint64_t i = 0; i < 4; ++i) {
+    AppendLittleEndian(file, 508 + i, 8);
+  }
+  AppendChecksum(file, 438);
+  WriteFile(file);
+
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry{501, 4, 0}));
+  EXPECT_THAT(LookupEntry({1, 1}), IsOkAndHolds(ChunkIndexEntry{503, 4, 0}));
+  EXPECT_THAT(LookupEntry({2, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(LookupEntry({4, 1}), IsOkAndHolds(ChunkIndexEntry{509, 4, 0}));
+  EXPECT_THAT(LookupEntry({6, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(
+                          ElementsAre(0, 0), ElementsAre(0, 1),
+                          ElementsAre(1, 0), ElementsAre(1, 1),
+                          ElementsAre(4, 0), ElementsAre(4, 1),
+                          ElementsAre(5, 0), ElementsAre(5, 1))));
+}
+
+TEST_F(ChunkIndexCacheTest, SingleChunk) {
+  params_.layout.chunk_index_type = ChunkIndexType::kSingleChunk;
+  params_.layout.address = 100;
+  params_.chunk_shape = {8, 8};
+  params_.layout.single_chunk_filtered_size = 30;
+  params_.layout.single_chunk_filter_mask = 2;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, Lookup({0, 0}));
+  EXPECT_EQ((ChunkIndexEntry{100, 30, 2}), result.entry);
+  EXPECT_TRUE(StorageGeneration::IsUnknown(result.stamp.generation));
+  EXPECT_THAT(LookupEntry({0, 1}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+}
+
+TEST_F(ChunkIndexCacheTest, Implicit) {
+  params_.layout.chunk_index_type = ChunkIndexType::kImplicit;
+  params_.layout.address = 100;
+  params_.element_size = 2;
+  EXPECT_THAT(LookupEntry({1, 1}), IsOkAndHolds(ChunkIndexEntry{196, 32, 0}));
+  EXPECT_THAT(LookupEntry({2, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(
+                          ElementsAre(0, 0), ElementsAre(0, 1),
+                          ElementsAre(1, 0), ElementsAre(1, 1))));
+}
+
+TEST_F(ChunkIndexCacheTest, Contiguous) {
+  params_.layout.layout_class = LayoutClass::kContiguous;
+  params_.layout.address = 100;
+  params_.layout.size = 7 * 8 * 2;
+  params_.shape = {7, 8};
+  params_.chunk_shape = {4, 8};
+  params_.element_size = 2;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, Lookup({0, 0}));
+  EXPECT_EQ((ChunkIndexEntry{100, 64, 0}), result.entry);
+  EXPECT_TRUE(StorageGeneration::IsUnknown(result.stamp.generation));
+  EXPECT_THAT(LookupEntry({1, 0}), IsOkAndHolds(ChunkIndexEntry{164, 48, 0}));
+  EXPECT_THAT(LookupEntry({2, 0}), IsOkAndHolds(ChunkIndexEntry::Missing()));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(ElementsAre(0, 0),
+                                               ElementsAre(1, 0))));
+}
+
+TEST_F(ChunkIndexCacheTest, Compact) {
+  params_.layout.layout_class = LayoutClass::kCompact;
+  EXPECT_THAT(LookupEntry({0, 0}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(List(), IsOkAndHolds(ElementsAre(ElementsAre(0, 0))));
+}
+
+}  // namespace
@@ -0,0 +1,256 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_index.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/chunk_store.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::kInfSize;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_hdf5::BtreeV2Header;
+using ::tensorstore::internal_hdf5::ChunkIndexEntry;
+using ::tensorstore::internal_hdf5::ChunkIndexParameters;
+using ::tensorstore::internal_hdf5::ChunkIndexType;
+using ::tensorstore::internal_hdf5::ChunkIndicesToKey;
+using ::tensorstore::internal_hdf5::DecodeBtreeV1ChunkNode;
+using ::tensorstore::internal_hdf5::FindBtreeV1Child;
+using ::tensorstore::internal_hdf5::FormatParameters;
+using ::tensorstore::internal_hdf5::GetBtreeV2NodeLayout;
+using ::tensorstore::internal_hdf5::GetBtreeV2NodeSize;
+using ::tensorstore::internal_hdf5::GetChunkCellIndices;
+using ::tensorstore::internal_hdf5::GetContiguousChunkEntry;
+using ::tensorstore::internal_hdf5::GetLinearChunkIndex;
+using ::tensorstore::internal_hdf5::GetVirtualChunkShape;
+using ::tensorstore::internal_hdf5::KeyToChunkIndices;
+using ::tensorstore::internal_hdf5::kUndefinedAddress;
+using ::tensorstore::internal_hdf5::LayoutClass;
+
+void AppendLittleEndian(std::string& out, uint64_t value, int size) {
+  for (int i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+struct TestKey {
+  uint32_t chunk_size;
+  uint32_t filter_mask;
+  std::vector<uint64_t> offsets;
+};
+
+// Encodes a v1 B-tree chunk node with 8-byte addresses.
+std::string EncodeNode(uint8_t level, const std::vector<TestKey>& keys,
+                       const std::vector<uint64_t>& children) {
+  std::string out = "TREE";
+  out.push_back(1);
+  out.push_back(static_cast<char>(level));
+  AppendLittleEndian(out, children.size(), 2);
+  AppendLittleEndian(out, ~uint64_t(0), 8);
+  AppendLittleEndian(out, ~uint64_t(0), 8);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    AppendLittleEndian(out, keys[i].chunk_size, 4);
+    AppendLittleEndian(out, keys[i].filter_mask, 4);
+    for (uint64_t offset : keys[i].offsets) {
+      AppendLittleEndian(out, offset, 8);
+    }
+    if (i < children.size()) AppendLittleEndian(out, children[i], 8);
+  }
+  return out;
+}
+
+FormatParameters GetTestFormat() {
+  FormatParameters format;
+  format.indexed_storage_k = 2;
+  return format;
+}
+
+TEST(DecodeBtreeV1ChunkNodeTest, Basic) {
+  auto encoded = EncodeNode(0,
+                            {{16, 0, {0, 0, 0}},
+                             {12, 1, {0, 4, 0}},
+                             {0, 0, {0, 8, 0}}},
+                            {1000, 2000});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto node, DecodeBtreeV1ChunkNode(absl::Cord(encoded), GetTestFormat(),
+                                        /*rank=*/2));
+  EXPECT_EQ(0, node.level);
+  EXPECT_THAT(node.children, ::testing::ElementsAre(1000, 2000));
+  ASSERT_EQ(3, node.keys.size());
+  EXPECT_EQ(12, node.keys[1].chunk_size);
+  EXPECT_EQ(1, node.keys[1].filter_mask);
+  EXPECT_THAT(node.keys[1].offsets, ::testing::ElementsAre(0, 4, 0));
+
+  EXPECT_EQ(0, FindBtreeV1Child(node, std::vector<uint64_t>{0, 0, 0}));
+  EXPECT_EQ(0, FindBtreeV1Child(node, std::vector<uint64_t>{0, 2, 0}));
+  EXPECT_EQ(1, FindBtreeV1Child(node, std::vector<uint64_t>{0, 4, 0}));
+  EXPECT_EQ(1, FindBtreeV1Child(node, std::vector<uint64_t>{4, 0, 0}));
+}
+
+TEST(DecodeBtreeV1ChunkNodeTest, Invalid) {
+  EXPECT_THAT(
+      DecodeBtreeV1ChunkNode(absl::Cord("XXXX"), GetTestFormat(), 2),
+      MatchesStatus(absl::StatusCode::kDataLoss, ".*Expected signature.*"));
+  auto encoded = EncodeNode(0, {{16, 0, {0, 0, 0}}, {0, 0, {0, 8, 0}}}, {1000});
+  EXPECT_THAT(DecodeBtreeV1ChunkNode(absl::Cord(encoded.substr(0, 30)),
+                                     GetTestFormat(), 2),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+  // Too many entries for K=1.
+  FormatParameters format;
+  format.indexed_storage_k = 1;
+  encoded = EncodeNode(
+      0, {{16, 0, {0, 0, 0}}, {16, 0, {0, 4, 0}}, {16, 0, {0, 8, 0}},
+          {0, 0, {0, 12, 0}}},
+      {1000, 2000, 3000});
+  EXPECT_THAT(DecodeBtreeV1ChunkNode(absl::Cord(encoded), format, 2),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*at most 2\\*K.*"));
+}
+
+TEST(ChunkKeyTest, RoundTrip) {
+  const Index indices[] = {1, 0x12345678, 0};
+  auto key = ChunkIndicesToKey(indices);
+  EXPECT_EQ(24, key.size());
+  Index decoded[3];
+  ASSERT_TRUE(KeyToChunkIndices(key, decoded));
+  EXPECT_THAT(decoded, ::testing::ElementsAre(1, 0x12345678, 0));
+  EXPECT_FALSE(KeyToChunkIndices(key.substr(1), decoded));
+}
+
+TEST(GetLinearChunkIndexTest, Basic) {
+  ChunkIndexParameters params;
+  params.layout.chunk_index_type = ChunkIndexType::kFixedArray;
+  params.shape = {5, 8};
+  params.max_shape = {10, 8};
+  params.chunk_shape = {4, 4};
+  // The grid of the maximum shape is 3x2.
+  EXPECT_EQ(0, GetLinearChunkIndex(params, std::vector<Index>{0, 0}));
+  EXPECT_EQ(3, GetLinearChunkIndex(params, std::vector<Index>{1, 1}));
+  EXPECT_EQ(4, GetLinearChunkIndex(params, std::vector<Index>{2, 0}));
+  EXPECT_EQ(-1, GetLinearChunkIndex(params, std::vector<Index>{3, 0}));
+  EXPECT_EQ(-1, GetLinearChunkIndex(params, std::vector<Index>{0, 2}));
+
+  // The unlimited dimension of an extensible array is moved to the front.
+  params.layout.chunk_index_type = ChunkIndexType::kExtensibleArray;
+  params.max_shape = {10, kInfSize};
+  EXPECT_EQ(3 * 1 + 2, GetLinearChunkIndex(params, std::vector<Index>{2, 1}));
+  EXPECT_EQ(3 * 100, GetLinearChunkIndex(params, std::vector<Index>{0, 100}));
+}
+
+TEST(GetChunkCellIndicesTest, Basic) {
+  ChunkIndexParameters params;
+  params.layout.chunk_index_type = ChunkIndexType::kFixedArray;
+  params.shape = {5, 8};
+  params.max_shape = {10, 8};
+  params.chunk_shape = {4, 4};
+  std::vector<Index> cell_indices(2);
+  ASSERT_TRUE(GetChunkCellIndices(params, 3, cell_indices));
+  EXPECT_THAT(cell_indices, ::testing::ElementsAre(1, 1));
+  ASSERT_TRUE(GetChunkCellIndices(params, 4, cell_indices));
+  EXPECT_THAT(cell_indices, ::testing::ElementsAre(2, 0));
+  EXPECT_FALSE(GetChunkCellIndices(params, 6, cell_indices));
+  EXPECT_FALSE(GetChunkCellIndices(params, -1, cell_indices));
+
+  params.layout.chunk_index_type = ChunkIndexType::kExtensibleArray;
+  params.max_shape = {10, kInfSize};
+  ASSERT_TRUE(GetChunkCellIndices(params, 3 * 100 + 2, cell_indices));
+  EXPECT_THAT(cell_indices, ::testing::ElementsAre(2, 100));
+  EXPECT_EQ(3 * 100 + 2, GetLinearChunkIndex(params, cell_indices));
+}
+
+TEST(GetVirtualChunkShapeTest, Contiguous) {
+  // Rows of 1000 bytes are grouped into virtual chunks of at most 1 MiB.
+  EXPECT_THAT(GetVirtualChunkShape(LayoutClass::kContiguous,
+                                   std::vector<Index>{5000, 250}, 4),
+              ::testing::ElementsAre(1048, 250));
+  // A single row larger than the target size.
+  EXPECT_THAT(GetVirtualChunkShape(LayoutClass::kContiguous,
+                                   std::vector<Index>{3, 1 << 20}, 8),
+              ::testing::ElementsAre(1, 1 << 20));
+  // A dataset smaller than the target size.
+  EXPECT_THAT(GetVirtualChunkShape(LayoutClass::kContiguous,
+                                   std::vector<Index>{10, 0}, 2),
+              ::testing::ElementsAre(10, 1));
+  EXPECT_THAT(
+      GetVirtualChunkShape(LayoutClass::kContiguous, std::vector<Index>{}, 2),
+      ::testing::ElementsAre());
+}
+
+TEST(GetVirtualChunkShapeTest, Compact) {
+  EXPECT_THAT(GetVirtualChunkShape(LayoutClass::kCompact,
+                                   std::vector<Index>{5000, 250}, 4),
+              ::testing::ElementsAre(5000, 250));
+}
+
+TEST(GetContiguousChunkEntryTest, Basic) {
+  ChunkIndexParameters params;
+  params.layout.layout_class = LayoutClass::kContiguous;
+  params.layout.address = 1000;
+  params.layout.size = 5 * 8 * 2;
+  params.shape = {5, 8};
+  params.chunk_shape = {2, 8};
+  params.element_size = 2;
+  EXPECT_EQ((ChunkIndexEntry{1000, 32, 0}),
+            GetContiguousChunkEntry(params, std::vector<Index>{0, 0}));
+  EXPECT_EQ((ChunkIndexEntry{1032, 32, 0}),
+            GetContiguousChunkEntry(params, std::vector<Index>{1, 0}));
+  // The final virtual chunk is truncated to the end of the raw data.
+  EXPECT_EQ((ChunkIndexEntry{1064, 16, 0}),
+            GetContiguousChunkEntry(params, std::vector<Index>{2, 0}));
+  EXPECT_TRUE(
+      GetContiguousChunkEntry(params, std::vector<Index>{3, 0}).IsMissing());
+  EXPECT_TRUE(
+      GetContiguousChunkEntry(params, std::vector<Index>{0, 1}).IsMissing());
+
+  params.layout.address = kUndefinedAddress;
+  EXPECT_TRUE(
+      GetContiguousChunkEntry(params, std::vector<Index>{0, 0}).IsMissing());
+}
+
+TEST(BtreeV2NodeLayoutTest, Basic) {
+  BtreeV2Header header;
+  header.record_type = 10;
+  header.node_size = 512;
+  header.record_size = 8 + 2 * 8;
+  header.depth = 2;
+  FormatParameters format;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto layout,
+                                   GetBtreeV2NodeLayout(header, format));
+  // Leaf: (512 - 10) / 24 = 20 records, encoded in 1 byte.
+  EXPECT_THAT(layout.max_num_records, ::testing::ElementsAre(20, 16, 16));
+  EXPECT_EQ(1, layout.num_records_size);
+  EXPECT_EQ(8 + 1, layout.GetChildPointerSize(format, 1));
+  // 17 * 20 + 16 = 356 records below a depth 1 node, encoded in 2 bytes.
+  EXPECT_EQ(8 + 1 + 2, layout.GetChildPointerSize(format, 2));
+  EXPECT_EQ(6 + 3 * 24 + 4 * 11 + 4,
+            GetBtreeV2NodeSize(header, layout, format, 2, 3));
+
+  header.node_size = 20;
+  EXPECT_THAT(GetBtreeV2NodeLayout(header, format),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
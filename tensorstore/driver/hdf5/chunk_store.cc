@@ -0,0 +1,916 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_store.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/chunk_index_cache.h"
+#include "tensorstore/driver/hdf5/chunk_writer.h"
+#include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/filter_pipeline.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_modify_write.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/kvstore/transaction.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/flow_sender_operation_state.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+#include "tensorstore/util/execution/future_sender.h"  // IWYU pragma: keep
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+std::string ChunkIndicesToKey(span<const Index> cell_indices) {
+  std::string key;
+  key.resize(cell_indices.size() * 8);
+  for (DimensionIndex i = 0; i < cell_indices.size(); ++i) {
+    absl::big_endian::Store64(key.data() + i * 8, cell_indices[i]);
+  }
+  return key;
+}
+
+bool KeyToChunkIndices(std::string_view key, span<Index> cell_indices) {
+  if (key.size() != cell_indices.size() * 8) {
+    return false;
+  }
+  for (DimensionIndex i = 0; i < cell_indices.size(); ++i) {
+    const uint64_t index = absl::big_endian::Load64(key.data() + i * 8);
+    if (index > static_cast<uint64_t>(kMaxFiniteIndex)) return false;
+    cell_indices[i] = static_cast<Index>(index);
+  }
+  return true;
+}
+namespace {
+
+using ::tensorstore::internal_kvstore::DeleteRangeEntry;
+using ::tensorstore::internal_kvstore::kReadModifyWrite;
+
+using BufferedReadModifyWriteEntry =
+    internal_kvstore::AtomicMultiPhaseMutation::BufferedReadModifyWriteEntry;
+
+class ChunkKeyValueStore : public kvstore::Driver {
+ public:
+  explicit ChunkKeyValueStore(ChunkStoreParameters&& params)
+      : index_cache_(GetChunkIndexCache(
+            params.cache_pool.get(), params.base_kvstore,
+            std::move(params.base_kvstore_path), std::move(params.executor),
+            params.index_params)),
+        filters_(std::move(params.filters)) {
+    this->SetBatchNestingDepth(base()->BatchNestingDepth() + 1);
+  }
+
+  class TransactionNode;
+
+  Future<kvstore::ReadResult> Read(kvstore::Key key,
+                                   kvstore::ReadOptions options) override;
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override;
+
+  Future<TimestampedStorageGeneration> Write(
+      kvstore::Key key, std::optional<kvstore::Value> value,
+      kvstore::WriteOptions options) override {
+    return internal_kvstore::WriteViaTransaction(
+        this, std::move(key), std::move(value), std::move(options));
+  }
+
+  absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
+                               size_t& phase, kvstore::Key key,
+                               kvstore::ReadModifyWriteSource& source) override;
+
+  absl::Status TransactionalDeleteRange(
+      const internal::OpenTransactionPtr& transaction,
+      KeyRange range) override;
+
+  Future<const void> DeleteRange(KeyRange range) override;
+
+  std::string DescribeKey(std::string_view key) override {
+    std::vector<Index> cell_indices(index_params().rank());
+    if (!KeyToChunkIndices(key, cell_indices)) {
+      return tensorstore::StrCat("invalid key ", tensorstore::QuoteString(key),
+                                 " in ", DescribeFile());
+    }
+    return tensorstore::StrCat("chunk ", span<const Index>(cell_indices),
+                               " in ", DescribeFile());
+  }
+
+  std::string DescribeFile() { return base()->DescribeKey(base_path()); }
+
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    // Chunks are not stored as separate values of the base key-value store,
+    // so partial writes cannot be passed through.
+    return base()->GetSupportedFeatures(KeyRange::Singleton(base_path())) &
+           ~kvstore::SupportedFeatures::kPartialWrite;
+  }
+
+  Result<KvStore> GetBase(std::string_view path,
+                          const Transaction& transaction) const override {
+    return KvStore(kvstore::DriverPtr(base()), base_path(), transaction);
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    garbage_collection::GarbageCollectionVisit(visitor, *base());
+  }
+
+  kvstore::Driver* base() const { return index_cache_->base_kvstore_driver(); }
+  const std::string& base_path() const {
+    return index_cache_->base_kvstore_path();
+  }
+  const Executor& executor() const { return index_cache_->executor(); }
+  const ChunkIndexParameters& index_params() const {
+    return index_cache_->index_params();
+  }
+  span<const Compressor> filters() const { return filters_; }
+  const internal::CachePtr<ChunkIndexCache>& index_cache() const {
+    return index_cache_;
+  }
+
+ private:
+  internal::CachePtr<ChunkIndexCache> index_cache_;
+  std::vector<Compressor> filters_;
+};
+
+/// Reads the chunk with the specified `key` directly from the file.
+Future<kvstore::ReadResult> ReadChunk(
+    internal::IntrusivePtr<ChunkKeyValueStore> driver, std::string_view key,
+    kvstore::ReadOptions options);
+
+/// Asynchronous state of `ReadChunk`.
+///
+/// The chunk is located using the chunk index, and then read from the file
+/// conditioned on the file generation at which the index was read.  If the
+/// file is modified between the two reads, the whole operation is retried.
+///
+/// For index types where the location of the chunk does not depend on the
+/// contents of the file, the generation conditions of the request are instead
+/// applied directly to the read of the chunk.
+///
+/// Unfiltered chunks are returned as read from the base key-value store, such
+/// that reads served by memory mapping the file are not copied.
+struct ReadOperationState
+    : public internal::AtomicReferenceCount<ReadOperationState> {
+  using Ptr = internal::IntrusivePtr<ReadOperationState>;
+
+  internal::IntrusivePtr<ChunkKeyValueStore> driver_;
+  std::vector<Index> cell_indices_;
+  kvstore::ReadOptions options_;
+  Promise<kvstore::ReadResult> promise_;
+
+  /// Filter mask of the located chunk.
+  uint32_t filter_mask_ = 0;
+
+  /// Number of zero bytes appended to the value read, for the final virtual
+  /// chunk of a contiguous dataset.
+  size_t padding_ = 0;
+
+  static void Start(Ptr self) {
+    if (!self->promise_.result_needed()) return;
+    auto& driver = *self->driver_;
+    if (driver.index_params().layout.layout_class == LayoutClass::kCompact) {
+      ReadCompact(std::move(self));
+      return;
+    }
+    auto lookup_future =
+        LookupChunk(driver.index_cache(), self->cell_indices_,
+                    self->options_.staleness_bound,
+                    std::exchange(self->options_.batch, Batch{no_batch}));
+    std::move(lookup_future)
+        .ExecuteWhenReady([self = std::move(self)](
+                              ReadyFuture<ChunkLookupResult> future) mutable {
+          const auto& executor = self->driver_->executor();
+          executor([self = std::move(self), future = std::move(future)] {
+            OnChunkLocated(std::move(self), future.result());
+          });
+        });
+  }
+
+  static void OnChunkLocated(Ptr self, Result<ChunkLookupResult>& result) {
+    auto& promise = self->promise_;
+    if (!result.ok()) {
+      promise.SetResult(result.status());
+      return;
+    }
+    auto& stamp = result->stamp;
+    const auto& entry = result->entry;
+    const bool location_is_unconditional =
+        StorageGeneration::IsUnknown(stamp.generation);
+    if (!location_is_unconditional &&
+        !self->options_.generation_conditions.Matches(stamp.generation)) {
+      promise.SetResult(kvstore::ReadResult::Unspecified(std::move(stamp)));
+      return;
+    }
+    if (entry.IsMissing()) {
+      promise.SetResult(kvstore::ReadResult::Missing(std::move(stamp)));
+      return;
+    }
+    auto& driver = *self->driver_;
+    const auto& index_params = driver.index_params();
+    // Filtered chunks are read and decoded in full, and the requested byte
+    // range is then applied to the decoded chunk.
+    const int64_t stored_size = static_cast<int64_t>(entry.size);
+    ByteRange byte_range{0, stored_size};
+    if (driver.filters().empty()) {
+      // The final virtual chunk of a contiguous dataset may extend past the
+      // end of the raw data.
+      const int64_t chunk_size =
+          index_params.layout.layout_class == LayoutClass::kContiguous
+              ? static_cast<int64_t>(index_params.GetUnfilteredChunkSize())
+              : stored_size;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          byte_range, self->options_.byte_range.Validate(chunk_size),
+          static_cast<void>(promise.SetResult(_)));
+      if (byte_range.inclusive_min == byte_range.exclusive_max) {
+        promise.SetResult(
+            kvstore::ReadResult::Value(absl::Cord(), std::move(stamp)));
+        return;
+      }
+      const ByteRange stored_range{
+          std::min(byte_range.inclusive_min, stored_size),
+          std::min(byte_range.exclusive_max, stored_size)};
+      self->padding_ = byte_range.size() - stored_range.size();
+      byte_range = stored_range;
+    }
+    self->filter_mask_ = entry.filter_mask;
+    kvstore::ReadOptions read_options;
+    if (location_is_unconditional) {
+      read_options.generation_conditions =
+          std::move(self->options_.generation_conditions);
+    } else {
+      read_options.generation_conditions.if_equal = stamp.generation;
+    }
+    read_options.staleness_bound = self->options_.staleness_bound;
+    const uint64_t offset = index_params.format.base_address + entry.address;
+    read_options.byte_range =
+        OptionalByteRangeRequest::Range(offset + byte_range.inclusive_min,
+                                        offset + byte_range.exclusive_max);
+    driver.base()
+        ->Read(driver.base_path(), std::move(read_options))
+        .ExecuteWhenReady([self = std::move(self), location_is_unconditional](
+                              ReadyFuture<kvstore::ReadResult> future) mutable {
+          OnValueReady(std::move(self), location_is_unconditional,
+                       future.result());
+        });
+  }
+
+  static void OnValueReady(Ptr self, bool location_is_unconditional,
+                           Result<kvstore::ReadResult>& result) {
+    if (!location_is_unconditional && result.ok() && result->aborted()) {
+      // The file was modified after the chunk index was read.  Retry.
+      self->options_.staleness_bound = result->stamp.time;
+      Start(std::move(self));
+      return;
+    }
+    if (result.ok() && result->has_value() && self->padding_ != 0) {
+      result->value.Append(std::string(self->padding_, '\0'));
+    }
+    if (result.ok() && result->has_value() &&
+        !self->driver_->filters().empty()) {
+      const auto& executor = self->driver_->executor();
+      executor([self = std::move(self),
+                read_result = *std::move(result)]() mutable {
+        DecodeValue(std::move(self), std::move(read_result));
+      });
+      return;
+    }
+    self->promise_.SetResult(std::move(result));
+  }
+
+  /// Reads the single chunk of a dataset using the compact layout, which is
+  /// stored within the data layout message rather than as raw data.
+  ///
+  /// The file is still read, with an empty byte range, to obtain the
+  /// generation and apply the generation conditions of the request.
+  static void ReadCompact(Ptr self) {
+    auto& driver = *self->driver_;
+    kvstore::ReadOptions read_options;
+    read_options.generation_conditions =
+        std::move(self->options_.generation_conditions);
+    read_options.staleness_bound = self->options_.staleness_bound;
+    read_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+    read_options.batch = std::move(self->options_.batch);
+    driver.base()
+        ->Read(driver.base_path(), std::move(read_options))
+        .ExecuteWhenReady([self = std::move(self)](
+                              ReadyFuture<kvstore::ReadResult> future) mutable {
+          OnCompactReady(std::move(self), future.result());
+        });
+  }
+
+  static void OnCompactReady(Ptr self, Result<kvstore::ReadResult>& result) {
+    auto& promise = self->promise_;
+    if (!result.ok() || !result->has_value()) {
+      promise.SetResult(std::move(result));
+      return;
+    }
+    if (std::any_of(self->cell_indices_.begin(), self->cell_indices_.end(),
+                    [](Index i) { return i != 0; })) {
+      promise.SetResult(
+          kvstore::ReadResult::Missing(std::move(result->stamp)));
+      return;
+    }
+    const auto& data = self->driver_->index_params().layout.compact_data;
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto byte_range,
+        self->options_.byte_range.Validate(static_cast<int64_t>(data.size())),
+        static_cast<void>(promise.SetResult(_)));
+    result->value = data.Subcord(byte_range.inclusive_min, byte_range.size());
+    promise.SetResult(std::move(result));
+  }
+
+  static void DecodeValue(Ptr self, kvstore::ReadResult read_result) {
+    if (!self->promise_.result_needed()) return;
+    const auto& driver = *self->driver_;
+    const auto& index_params = driver.index_params();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto decoded,
+        DecodeFilteredChunk(std::move(read_result.value), driver.filters(),
+                            self->filter_mask_, index_params.element_size,
+                            index_params.GetUnfilteredChunkSize()),
+        static_cast<void>(self->promise_.SetResult(_)));
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto byte_range,
+        self->options_.byte_range.Validate(
+            static_cast<int64_t>(decoded.size())),
+        static_cast<void>(self->promise_.SetResult(_)));
+    read_result.value =
+        decoded.Subcord(byte_range.inclusive_min, byte_range.size());
+    self->promise_.SetResult(std::move(read_result));
+  }
+};
+
+Future<kvstore::ReadResult> ReadChunk(
+    internal::IntrusivePtr<ChunkKeyValueStore> driver, std::string_view key,
+    kvstore::ReadOptions options) {
+  auto state = internal::MakeIntrusivePtr<ReadOperationState>();
+  state->cell_indices_.resize(driver->index_params().rank());
+  if (!KeyToChunkIndices(key, state->cell_indices_)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Invalid HDF5 chunk key: ", tensorstore::QuoteString(key)));
+  }
+  state->driver_ = std::move(driver);
+  state->options_ = std::move(options);
+  auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
+  state->promise_ = std::move(promise);
+  ReadOperationState::Start(std::move(state));
+  return std::move(future);
+}
+
+// Asynchronous operation state for `ChunkKeyValueStore::ListImpl`.
+struct ListOperationState
+    : public internal::FlowSenderOperationState<kvstore::ListEntry> {
+  using Base = internal::FlowSenderOperationState<kvstore::ListEntry>;
+
+  using Base::Base;
+
+  kvstore::ListOptions options_;
+  DimensionIndex rank_;
+
+  static void Start(const ChunkKeyValueStore& driver,
+                    kvstore::ListOptions&& options,
+                    kvstore::ListReceiver&& receiver) {
+    auto self =
+        internal::MakeIntrusivePtr<ListOperationState>(std::move(receiver));
+    self->options_ = std::move(options);
+    self->rank_ = driver.index_params().rank();
+    auto future =
+        ListChunks(driver.index_cache(), self->options_.staleness_bound);
+    auto* self_ptr = self.get();
+    LinkValue(
+        WithExecutor(driver.executor(),
+                     [self = std::move(self)](
+                         Promise<void> promise,
+                         ReadyFuture<ChunkListResult> future) {
+                       if (self->cancelled()) return;
+                       self->OnChunksListed(future.value());
+                     }),
+        self_ptr->promise, std::move(future));
+  }
+
+  void OnChunksListed(const ChunkListResult& result) {
+    auto& receiver = shared_receiver->receiver;
+    const size_t rank = rank_;
+    for (size_t i = 0; i < result.num_chunks; ++i) {
+      auto key = ChunkIndicesToKey(
+          span<const Index>(result.cell_indices.data() + i * rank, rank));
+      if (!Contains(options_.range, key)) continue;
+      key.erase(0, options_.strip_prefix_length);
+      execution::set_value(receiver, kvstore::ListEntry{std::move(key), -1});
+    }
+  }
+};
+
+/// Transaction node that commits all chunk modifications of a transaction
+/// phase to the file together.
+///
+/// The commit does not read or rewrite the entire file.  The superblock and
+/// the B-tree nodes on the paths to the modified chunks are read through the
+/// `ChunkIndexCache`, `ApplyChunkUpdates` computes the modified extents of
+/// the file, and only those extents are written, conditioned on the
+/// generation of the file at which the index was read.  If the file is
+/// concurrently modified, the commit is retried.
+///
+/// If the base key-value store does not support `WriteOptions::byte_ranges`,
+/// the extents are instead applied to a conditional read of the full file.
+class ChunkKeyValueStore::TransactionNode
+    : public internal_kvstore::AtomicTransactionNode {
+  using Base = internal_kvstore::AtomicTransactionNode;
+
+ public:
+  using Base::Base;
+
+  ChunkKeyValueStore& store() {
+    return static_cast<ChunkKeyValueStore&>(*this->driver());
+  }
+
+  void AllEntriesDone(
+      internal_kvstore::SinglePhaseMutation& single_phase_mutation) override {
+    if (single_phase_mutation.remaining_entries_.HasError()) {
+      internal_kvstore::WritebackError(single_phase_mutation);
+      MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+      return;
+    }
+    store().executor()([this] { this->StartCommit(); });
+  }
+
+  // Collects the chunk modifications and generation conditions of the
+  // committing phase, and then reads the chunk index.
+  void StartCommit();
+
+  // Adds the generation condition of `entry`.  Returns `false` if it is
+  // inconsistent with a previously added condition.
+  bool AddCondition(BufferedReadModifyWriteEntry& entry);
+
+  // Starts or restarts reading the parts of the chunk index affected by the
+  // commit, at a single generation of the file.
+  void ReadIndex();
+
+  // Adds a deletion for each existing chunk within a deleted range.
+  void OnChunksListed(const Result<ChunkListResult>& result);
+
+  using BlockCallback =
+      void (TransactionNode::*)(span<const uint64_t> addresses,
+                                span<const absl::Cord> blocks);
+
+  // Reads the blocks of `size` bytes at `addresses` through the chunk index
+  // cache, within a single batch, and invokes `callback`.
+  void ReadBlocks(std::vector<uint64_t> addresses, uint64_t size,
+                  BlockCallback callback);
+
+  void OnSuperblockRead(span<const uint64_t> addresses,
+                        span<const absl::Cord> blocks);
+
+  // Reads the next level of B-tree nodes required by `ApplyChunkUpdates`, or
+  // writes the modified extents once all required nodes have been read.
+  void ReadNodes();
+
+  void OnNodesRead(span<const uint64_t> addresses,
+                   span<const absl::Cord> blocks);
+
+  void WriteExtents();
+
+  void OnWriteDone(const Result<TimestampedStorageGeneration>& result);
+
+  void CommitSuccessful(const TimestampedStorageGeneration& stamp);
+
+  void Fail(const absl::Status& error);
+
+  // Generation of the file on which all conditional entries depend, or
+  // `StorageGeneration::Unknown()`.
+  StorageGeneration condition_;
+
+  // New stored values of modified chunks, or `std::nullopt` for deleted
+  // chunks.
+  std::map<std::vector<Index>, std::optional<absl::Cord>> writes_;
+
+  // Ranges of chunk keys deleted by `DeleteRange`.
+  std::vector<KeyRange> deleted_ranges_;
+
+  // Staleness bound of the current attempt to read the chunk index.
+  absl::Time staleness_bound_;
+
+  // Generation of the file at which the chunk index was read.
+  TimestampedStorageGeneration stamp_;
+
+  // Chunk modifications of the current attempt, including deletions of
+  // chunks within `deleted_ranges_`.
+  std::vector<ChunkUpdate> updates_;
+
+  std::string superblock_;
+  BtreeV1NodeMap nodes_;
+};
+
+void ChunkKeyValueStore::TransactionNode::StartCommit() {
+  auto& single_phase_mutation = GetCommittingPhase();
+  const auto& index_params = store().index_params();
+  condition_ = StorageGeneration::Unknown();
+  writes_.clear();
+  deleted_ranges_.clear();
+  bool mismatch = false;
+  for (auto& entry : single_phase_mutation.entries_) {
+    if (entry.entry_type() != kReadModifyWrite) {
+      auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
+      deleted_ranges_.emplace_back(dr_entry.key_, dr_entry.exclusive_max_);
+      // `DeleteRangeEntry` imposes no constraints itself, but the superseded
+      // `ReadModifyWriteEntry` nodes may have constraints.
+      for (auto& deleted_entry : dr_entry.superseded_) {
+        if (!AddCondition(
+                static_cast<BufferedReadModifyWriteEntry&>(deleted_entry))) {
+          mismatch = true;
+        }
+      }
+      continue;
+    }
+    auto& buffered_entry = static_cast<BufferedReadModifyWriteEntry&>(entry);
+    if (!AddCondition(buffered_entry)) {
+      mismatch = true;
+      continue;
+    }
+    if (buffered_entry.value_state_ == kvstore::ReadResult::kUnspecified ||
+        !StorageGeneration::IsInnerLayerDirty(
+            buffered_entry.stamp().generation)) {
+      // This is a no-op mutation; ignore it, which has the effect of retaining
+      // the existing chunk, if present.
+      continue;
+    }
+    std::vector<Index> cell_indices(index_params.rank());
+    [[maybe_unused]] const bool valid_key =
+        KeyToChunkIndices(buffered_entry.key_, cell_indices);
+    assert(valid_key);
+    auto& value = writes_[std::move(cell_indices)];
+    if (buffered_entry.value_state_ == kvstore::ReadResult::kValue) {
+      // Values are written already encoded.
+      value = buffered_entry.value_;
+    }
+  }
+  if (mismatch) {
+    // Retry, requesting that all mutations be based on a new up-to-date
+    // generation of the file.
+    this->RetryAtomicWriteback(absl::Now());
+    return;
+  }
+  if (writes_.empty() && deleted_ranges_.empty() &&
+      StorageGeneration::IsUnknown(condition_)) {
+    CommitSuccessful(TimestampedStorageGeneration::Unconditional());
+    return;
+  }
+  staleness_bound_ = absl::Now();
+  ReadIndex();
+}
+
+bool ChunkKeyValueStore::TransactionNode::AddCondition(
+    BufferedReadModifyWriteEntry& entry) {
+  auto generation = StorageGeneration::Clean(entry.stamp().generation);
+  if (StorageGeneration::IsUnknown(generation)) return true;
+  if (StorageGeneration::IsUnknown(condition_)) {
+    condition_ = std::move(generation);
+    return true;
+  }
+  return generation == condition_;
+}
+
+void ChunkKeyValueStore::TransactionNode::ReadIndex() {
+  stamp_ = TimestampedStorageGeneration{};
+  updates_.clear();
+  superblock_.clear();
+  nodes_.clear();
+  for (const auto& [cell_indices, value] : writes_) {
+    updates_.push_back(ChunkUpdate{cell_indices, value});
+  }
+  if (deleted_ranges_.empty()) {
+    ReadBlocks({0}, GetSuperblockPrefixSize(store().index_params().format),
+               &TransactionNode::OnSuperblockRead);
+    return;
+  }
+  // Determining the chunks within the deleted ranges requires the entire
+  // index.
+  ListChunks(store().index_cache(), staleness_bound_)
+      .ExecuteWhenReady([this](ReadyFuture<ChunkListResult> future) {
+        this->OnChunksListed(future.result());
+      });
+}
+
+void ChunkKeyValueStore::TransactionNode::OnChunksListed(
+    const Result<ChunkListResult>& result) {
+  if (!result.ok()) {
+    Fail(result.status());
+    return;
+  }
+  stamp_ = result->stamp;
+  const size_t rank = store().index_params().rank();
+  for (size_t i = 0; i < result->num_chunks; ++i) {
+    std::vector<Index> cell_indices(
+        result->cell_indices.begin() + i * rank,
+        result->cell_indices.begin() + (i + 1) * rank);
+    if (writes_.count(cell_indices)) continue;
+    const auto key = ChunkIndicesToKey(cell_indices);
+    for (const auto& range : deleted_ranges_) {
+      if (Contains(range, key)) {
+        updates_.push_back(ChunkUpdate{std::move(cell_indices), std::nullopt});
+        break;
+      }
+    }
+  }
+  ReadBlocks({0}, GetSuperblockPrefixSize(store().index_params().format),
+             &TransactionNode::OnSuperblockRead);
+}
+
+void ChunkKeyValueStore::TransactionNode::ReadBlocks(
+    std::vector<uint64_t> addresses, uint64_t size, BlockCallback callback) {
+  std::vector<internal::PinnedCacheEntry<ChunkIndexCache>> entries;
+  std::vector<AnyFuture> futures;
+  entries.reserve(addresses.size());
+  futures.reserve(addresses.size());
+  {
+    auto batch = Batch::New();
+    internal::AsyncCache::AsyncCacheReadRequest request;
+    request.staleness_bound = staleness_bound_;
+    request.batch = batch;
+    for (const uint64_t address : addresses) {
+      entries.push_back(GetCacheEntry(
+          store().index_cache(),
+          ChunkIndexCache::EncodeBlockKey(address, size,
+                                          /*checksummed_size=*/0)));
+      futures.push_back(entries.back()->Read(request));
+    }
+  }
+  WaitAllFuture(futures).ExecuteWhenReady(
+      [this, addresses = std::move(addresses), entries = std::move(entries),
+       callback](ReadyFuture<void> future) {
+        if (!future.result().ok()) {
+          Fail(future.result().status());
+          return;
+        }
+        std::vector<absl::Cord> blocks;
+        blocks.reserve(entries.size());
+        for (const auto& entry : entries) {
+          std::shared_ptr<const absl::Cord> block;
+          TimestampedStorageGeneration stamp;
+          {
+            internal::AsyncCache::ReadLock<absl::Cord> lock(*entry);
+            block = lock.shared_data();
+            stamp = lock.stamp();
+          }
+          if (StorageGeneration::IsUnknown(stamp_.generation)) {
+            stamp_ = std::move(stamp);
+          } else if (stamp.generation != stamp_.generation) {
+            // The file was modified between the reads of two blocks.
+            // Restart, excluding the older of the two generations.
+            staleness_bound_ = std::max(stamp_.time, stamp.time);
+            ReadIndex();
+            return;
+          } else {
+            stamp_.time = std::max(stamp_.time, stamp.time);
+          }
+          if (!block) {
+            Fail(absl::NotFoundError(tensorstore::StrCat(
+                "HDF5 file ", store().DescribeFile(), " does not exist")));
+            return;
+          }
+          blocks.push_back(*block);
+        }
+        (this->*callback)(addresses, blocks);
+      });
+}
+
+void ChunkKeyValueStore::TransactionNode::OnSuperblockRead(
+    span<const uint64_t> addresses, span<const absl::Cord> blocks) {
+  if (!StorageGeneration::IsUnknown(condition_) &&
+      condition_ != stamp_.generation) {
+    // A conditional mutation was based on a prior generation of the file.
+    this->RetryAtomicWriteback(absl::Now());
+    return;
+  }
+  if (updates_.empty()) {
+    CommitSuccessful(stamp_);
+    return;
+  }
+  superblock_ = std::string(blocks[0]);
+  ReadNodes();
+}
+
+void ChunkKeyValueStore::TransactionNode::ReadNodes() {
+  const auto& index_params = store().index_params();
+  auto required = GetRequiredBtreeV1Nodes(index_params, nodes_, updates_);
+  if (!required.ok()) {
+    Fail(required.status());
+    return;
+  }
+  if (required->empty()) {
+    WriteExtents();
+    return;
+  }
+  ReadBlocks(
+      *std::move(required),
+      GetBtreeV1ChunkNodeSize(index_params.format, index_params.rank()),
+      &TransactionNode::OnNodesRead);
+}
+
+void ChunkKeyValueStore::TransactionNode::OnNodesRead(
+    span<const uint64_t> addresses, span<const absl::Cord> blocks) {
+  const auto& index_params = store().index_params();
+  for (ptrdiff_t i = 0; i < addresses.size(); ++i) {
+    auto node = DecodeBtreeV1ChunkNode(blocks[i], index_params.format,
+                                       index_params.rank());
+    if (!node.ok()) {
+      Fail(tensorstore::MaybeAnnotateStatus(node.status(),
+                                            "Error reading HDF5 chunk index"));
+      return;
+    }
+    nodes_.emplace(addresses[i], *std::move(node));
+  }
+  ReadNodes();
+}
+
+void ChunkKeyValueStore::TransactionNode::WriteExtents() {
+  auto& store = this->store();
+  auto update =
+      ApplyChunkUpdates(store.index_params(), superblock_, std::move(nodes_),
+                        std::move(updates_));
+  if (!update.ok()) {
+    Fail(update.status());
+    return;
+  }
+  kvstore::WriteOptions write_options;
+  write_options.generation_conditions.if_equal = stamp_.generation;
+  if ((store.base()->GetSupportedFeatures(
+           KeyRange::Singleton(store.base_path())) &
+       kvstore::SupportedFeatures::kPartialWrite) !=
+      kvstore::SupportedFeatures{}) {
+    write_options.byte_ranges = std::move(update->byte_ranges);
+    store.base()
+        ->Write(store.base_path(), std::move(update->value),
+                std::move(write_options))
+        .ExecuteWhenReady(
+            [this](ReadyFuture<TimestampedStorageGeneration> future) {
+              this->OnWriteDone(future.result());
+            });
+    return;
+  }
+  // The base key-value store can only replace the entire file.  Apply the
+  // modified extents to the current contents of the file.
+  kvstore::ReadOptions read_options;
+  read_options.generation_conditions.if_equal = stamp_.generation;
+  read_options.staleness_bound = stamp_.time;
+  store.base()
+      ->Read(store.base_path(), std::move(read_options))
+      .ExecuteWhenReady([this, update = *std::move(update),
+                         write_options = std::move(write_options)](
+                            ReadyFuture<kvstore::ReadResult> future) mutable {
+        auto& read_result = future.result();
+        if (!read_result.ok()) {
+          Fail(read_result.status());
+          return;
+        }
+        if (!read_result->has_value()) {
+          // The file was modified after the chunk index was read.
+          this->RetryAtomicWriteback(read_result->stamp.time);
+          return;
+        }
+        auto& store = this->store();
+        store.base()
+            ->Write(store.base_path(),
+                    internal::OverwriteByteRanges(read_result->value,
+                                                  update.byte_ranges,
+                                                  std::move(update.value)),
+                    std::move(write_options))
+            .ExecuteWhenReady(
+                [this](ReadyFuture<TimestampedStorageGeneration> future) {
+                  this->OnWriteDone(future.result());
+                });
+      });
+}
+
+void ChunkKeyValueStore::TransactionNode::OnWriteDone(
+    const Result<TimestampedStorageGeneration>& result) {
+  if (!result.ok()) {
+    Fail(result.status());
+    return;
+  }
+  if (StorageGeneration::IsUnknown(result->generation)) {
+    // The file was modified after the chunk index was read.
+    this->RetryAtomicWriteback(result->time);
+    return;
+  }
+  CommitSuccessful(*result);
+}
+
+void ChunkKeyValueStore::TransactionNode::CommitSuccessful(
+    const TimestampedStorageGeneration& stamp) {
+  auto& single_phase_mutation = GetCommittingPhase();
+  // Every entry is a chunk within the file, and therefore observes the new
+  // generation of the file.
+  for (auto& entry : single_phase_mutation.entries_) {
+    if (entry.entry_type() == kReadModifyWrite) {
+      static_cast<BufferedReadModifyWriteEntry&>(entry).stamp() = stamp;
+    }
+  }
+  this->AtomicCommitWritebackSuccess();
+  MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+}
+
+void ChunkKeyValueStore::TransactionNode::Fail(const absl::Status& error) {
+  SetError(error);
+  auto& single_phase_mutation = GetCommittingPhase();
+  internal_kvstore::WritebackError(single_phase_mutation);
+  MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+}
+
+Future<kvstore::ReadResult> ChunkKeyValueStore::Read(
+    kvstore::Key key, kvstore::ReadOptions options) {
+  return ReadChunk(internal::IntrusivePtr<ChunkKeyValueStore>(this), key,
+                   std::move(options));
+}
+
+void ChunkKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
+  ListOperationState::Start(*this, std::move(options), std::move(receiver));
+}
+
+absl::Status ChunkKeyValueStore::ReadModifyWrite(
+    internal::OpenTransactionPtr& transaction, size_t& phase, kvstore::Key key,
+    kvstore::ReadModifyWriteSource& source) {
+  std::vector<Index> cell_indices(index_params().rank());
+  if (!KeyToChunkIndices(key, cell_indices)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Invalid HDF5 chunk key: ", tensorstore::QuoteString(key)));
+  }
+  return internal_kvstore::AddReadModifyWrite<TransactionNode>(
+      this, transaction, phase, std::move(key), source);
+}
+
+absl::Status ChunkKeyValueStore::TransactionalDeleteRange(
+    const internal::OpenTransactionPtr& transaction, KeyRange range) {
+  return internal_kvstore::AddDeleteRange<TransactionNode>(this, transaction,
+                                                           std::move(range));
+}
+
+Future<const void> ChunkKeyValueStore::DeleteRange(KeyRange range) {
+  internal::OpenTransactionPtr transaction;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto node, internal_kvstore::GetTransactionNode<TransactionNode>(
+                     this, transaction));
+  {
+    absl::MutexLock lock(&node->mutex_);
+    node->DeleteRange(std::move(range));
+  }
+  return node->transaction()->future();
+}
+
+}  // namespace
+
+kvstore::DriverPtr GetChunkKeyValueStore(ChunkStoreParameters&& parameters) {
+  return kvstore::DriverPtr(new ChunkKeyValueStore(std::move(parameters)));
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,101 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_CHUNK_STORE_H_
+#define TENSORSTORE_DRIVER_HDF5_CHUNK_STORE_H_
+
+/// \file
+///
+/// Key-value store adapter that exposes the chunks of a single HDF5 dataset
+/// stored within a file in a base key-value store.
+///
+/// Each key encodes the grid cell indices of a chunk as a sequence of
+/// big-endian `uint64` values.  Reads of a key are mapped to a lookup in the
+/// chunk index of the dataset, see `chunk_index_cache.h`, followed by a byte
+/// range read of the file.  Listing the adapter enumerates the allocated
+/// chunks with a single scan of the chunk index, see `ListChunks`.
+///
+/// Writes are only supported within a transaction (possibly an implicit
+/// one).  All chunk writes of a transaction are committed together: the
+/// affected parts of the chunk index are read through the chunk index cache,
+/// and only the modified extents of the file are written, conditioned on the
+/// generation of the file, see `chunk_writer.h`.  Base key-value stores that
+/// do not support `kvstore::SupportedFeatures::kPartialWrite` fall back to
+/// rewriting the full file.
+///
+/// Values read through the adapter are unfiltered: the filter pipeline of the
+/// dataset is reversed when reading, taking into account the filter mask of
+/// each chunk.  Values written through the adapter must already have the full
+/// filter pipeline applied, see `EncodeFilteredChunk`, and are stored as is
+/// with a filter mask of 0.  This allows chunks to be encoded concurrently,
+/// before the commit.
+///
+/// Datasets using the contiguous or compact layout are exposed as the virtual
+/// chunk grid returned by `GetVirtualChunkShape`, and are read-only.  Virtual
+/// chunks of a contiguous dataset are byte range reads of the raw data, such
+/// that with `file_io_memmap` enabled the values reference the memory mapped
+/// file without copying.  The single chunk of a compact dataset is served
+/// from the data layout message.
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Returns the chunk store key corresponding to `cell_indices`.
+std::string ChunkIndicesToKey(span<const Index> cell_indices);
+
+/// Decodes a key returned by `ChunkIndicesToKey`.
+///
+/// \returns `false` if `key` is not a valid key of rank
+///     `cell_indices.size()`.
+bool KeyToChunkIndices(std::string_view key, span<Index> cell_indices);
+
+struct ChunkStoreParameters {
+  /// Key-value store containing the HDF5 file.
+  kvstore::DriverPtr base_kvstore;
+
+  /// Path of the HDF5 file within `base_kvstore`.
+  std::string base_kvstore_path;
+
+  Executor executor;
+
+  /// Cache pool used for the cache of the chunk index.
+  internal::CachePool::WeakPtr cache_pool;
+
+  ChunkIndexParameters index_params;
+
+  /// Filter pipeline of the dataset, see `filter_pipeline.h`.  Only used to
+  /// decode chunks when reading.
+  std::vector<Compressor> filters;
+};
+
+/// Returns a key-value store that provides access to the chunks of the dataset
+/// specified by `parameters`.
+kvstore::DriverPtr GetChunkKeyValueStore(ChunkStoreParameters&& parameters);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_CHUNK_STORE_H_
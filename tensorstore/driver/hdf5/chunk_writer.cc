@@ -0,0 +1,596 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_writer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+absl::Status ValidateChunkIndexType(const ChunkIndexParameters& params) {
+  if (params.layout.layout_class != LayoutClass::kChunked) {
+    return absl::UnimplementedError(
+        "Writing HDF5 datasets that do not use the chunked layout is not "
+        "supported");
+  }
+  if (params.layout.chunk_index_type != ChunkIndexType::kBtreeV1) {
+    return absl::UnimplementedError(
+        tensorstore::StrCat("HDF5 chunk index type ",
+                            static_cast<int>(params.layout.chunk_index_type),
+                            " is not supported"));
+  }
+  return absl::OkStatus();
+}
+
+/// Decodes the v1 B-tree node at `address`, and adds the chunks within its
+/// subtree to `index`.
+absl::Status DecodeBtreeV1Subtree(const absl::Cord& file,
+                                  const ChunkIndexParameters& params,
+                                  uint64_t address, int expected_level,
+                                  ChunkIndexMap& index) {
+  const DimensionIndex rank = params.rank();
+  const uint64_t node_size = GetBtreeV1ChunkNodeSize(params.format, rank);
+  const uint64_t offset = params.format.base_address + address;
+  if (offset > file.size() || file.size() - offset < node_size) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "B-tree node at address ", address, " is past the end of the file"));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto node,
+      DecodeBtreeV1ChunkNode(file.Subcord(offset, node_size), params.format,
+                             rank));
+  if (expected_level != -1 && node.level != expected_level) {
+    return absl::DataLossError(
+        tensorstore::StrCat("Expected B-tree node at level ", expected_level,
+                            " but received level ", node.level));
+  }
+  for (size_t i = 0; i < node.children.size(); ++i) {
+    if (node.level != 0) {
+      TENSORSTORE_RETURN_IF_ERROR(DecodeBtreeV1Subtree(
+          file, params, node.children[i], node.level - 1, index));
+      continue;
+    }
+    const auto& key = node.keys[i];
+    std::vector<Index> cell_indices(rank);
+    for (DimensionIndex j = 0; j < rank; ++j) {
+      const uint64_t chunk_size = static_cast<uint64_t>(params.chunk_shape[j]);
+      if (key.offsets[j] % chunk_size != 0) {
+        return absl::DataLossError(tensorstore::StrCat(
+            "Chunk offset ", key.offsets[j], " in dimension ", j,
+            " is not a multiple of the chunk size ", chunk_size));
+      }
+      cell_indices[j] = static_cast<Index>(key.offsets[j] / chunk_size);
+    }
+    index[std::move(cell_indices)] =
+        ChunkIndexEntry{node.children[i], key.chunk_size, key.filter_mask};
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ValidateChunkIndexForWriting(const ChunkIndexParameters& params) {
+  TENSORSTORE_RETURN_IF_ERROR(ValidateChunkIndexType(params));
+  if (params.layout.address == kUndefinedAddress) {
+    // Allocating the root node would require updating the data layout message
+    // in the object header of the dataset.
+    return absl::UnimplementedError(
+        "Writing to an HDF5 dataset without an allocated chunk index is not "
+        "supported");
+  }
+  return absl::OkStatus();
+}
+
+/// Returns the element offset of the chunk at `cell_indices`, including the
+/// trailing zero of the datatype dimension.
+std::vector<uint64_t> GetChunkOffsets(const ChunkIndexParameters& params,
+                                      span<const Index> cell_indices) {
+  std::vector<uint64_t> offsets(cell_indices.size() + 1);
+  for (DimensionIndex i = 0; i < cell_indices.size(); ++i) {
+    offsets[i] = static_cast<uint64_t>(cell_indices[i] * params.chunk_shape[i]);
+  }
+  return offsets;
+}
+
+/// Returns the child of the internal `node` to which a chunk at `offsets` is
+/// added.  Chunks that order before the first child are added to it.
+size_t GetChildForUpdate(const BtreeV1ChunkNode& node,
+                         span<const uint64_t> offsets) {
+  return static_cast<size_t>(
+      std::max<ptrdiff_t>(0, FindBtreeV1Child(node, offsets)));
+}
+
+bool KeysEqual(const BtreeV1ChunkKey& a, const BtreeV1ChunkKey& b) {
+  return a.chunk_size == b.chunk_size && a.filter_mask == b.filter_mask &&
+         a.offsets == b.offsets;
+}
+
+bool NodesEqual(const BtreeV1ChunkNode& a, const BtreeV1ChunkNode& b) {
+  return a.level == b.level && a.left_sibling == b.left_sibling &&
+         a.right_sibling == b.right_sibling && a.children == b.children &&
+         std::equal(a.keys.begin(), a.keys.end(), b.keys.begin(), b.keys.end(),
+                    KeysEqual);
+}
+
+/// Chunk update, keyed by the element offset of the chunk.
+struct PendingUpdate {
+  std::vector<uint64_t> offsets;
+  const std::optional<absl::Cord>* value;
+};
+
+/// Reference from a B-tree node to a child, along with the keys bounding the
+/// child.
+struct ChildReference {
+  BtreeV1ChunkKey lower;
+  uint64_t address;
+  BtreeV1ChunkKey upper;
+};
+
+/// Applies chunk updates to the B-tree nodes on the paths to the updated
+/// chunks, and accumulates the resultant writes.
+class BtreeV1Writer {
+ public:
+  explicit BtreeV1Writer(const ChunkIndexParameters& params,
+                         BtreeV1NodeMap nodes, uint64_t end_of_file_address)
+      : params_(params),
+        nodes_(std::move(nodes)),
+        end_of_file_address_(end_of_file_address),
+        node_size_(GetBtreeV1ChunkNodeSize(params.format, params.rank())),
+        max_children_(2 *
+                      static_cast<size_t>(params.format.indexed_storage_k)) {
+  }
+
+  absl::Status Apply(span<const PendingUpdate> updates) {
+    std::vector<ChildReference> replacement;
+    return UpdateSubtree(params_.layout.address, /*expected_level=*/-1,
+                         updates, replacement);
+  }
+
+  uint64_t end_of_file_address() const { return end_of_file_address_; }
+
+  /// Returns the writes of the chunks and of the modified nodes, keyed by
+  /// absolute offset.
+  std::map<uint64_t, absl::Cord> GetWrites() && {
+    const auto& format = params_.format;
+    for (uint64_t address : dirty_) {
+      if (removed_.count(address)) continue;
+      writes_[format.base_address + address] =
+          EncodeBtreeV1ChunkNode(nodes_.at(address), format, params_.rank());
+    }
+    // Sibling pointers of nodes that were not loaded are patched in place;
+    // v1 B-tree nodes are not checksummed.
+    const uint64_t left_sibling_offset = 8;
+    const uint64_t right_sibling_offset = 8 + format.size_of_offsets;
+    for (const auto& [address, patch] : patches_) {
+      if (patch.left) {
+        std::string encoded;
+        AppendAddress(encoded, format, *patch.left);
+        writes_[format.base_address + address + left_sibling_offset] =
+            absl::Cord(std::move(encoded));
+      }
+      if (patch.right) {
+        std::string encoded;
+        AppendAddress(encoded, format, *patch.right);
+        writes_[format.base_address + address + right_sibling_offset] =
+            absl::Cord(std::move(encoded));
+      }
+    }
+    return std::move(writes_);
+  }
+
+ private:
+  /// New sibling pointers of a node that was not loaded.
+  struct SiblingPatch {
+    std::optional<uint64_t> left;
+    std::optional<uint64_t> right;
+  };
+
+  uint64_t Allocate(uint64_t size) {
+    const uint64_t address = end_of_file_address_;
+    end_of_file_address_ += size;
+    return address;
+  }
+
+  void Write(uint64_t address, absl::Cord data) {
+    writes_[params_.format.base_address + address] = std::move(data);
+  }
+
+  void SetNode(uint64_t address, BtreeV1ChunkNode node) {
+    nodes_[address] = std::move(node);
+    dirty_.insert(address);
+  }
+
+  void SetLeftSibling(uint64_t address, uint64_t sibling) {
+    if (auto it = nodes_.find(address); it != nodes_.end()) {
+      it->second.left_sibling = sibling;
+      dirty_.insert(address);
+    } else {
+      patches_[address].left = sibling;
+    }
+  }
+
+  void SetRightSibling(uint64_t address, uint64_t sibling) {
+    if (auto it = nodes_.find(address); it != nodes_.end()) {
+      it->second.right_sibling = sibling;
+      dirty_.insert(address);
+    } else {
+      patches_[address].right = sibling;
+    }
+  }
+
+  /// Applies `updates` to the subtree rooted at `address`, and sets
+  /// `replacement` to the nodes that replace it in its parent.
+  absl::Status UpdateSubtree(uint64_t address, int expected_level,
+                             span<const PendingUpdate> updates,
+                             std::vector<ChildReference>& replacement) {
+    auto it = nodes_.find(address);
+    if (it == nodes_.end()) {
+      return absl::FailedPreconditionError(tensorstore::StrCat(
+          "B-tree node at address ", address, " has not been decoded"));
+    }
+    const BtreeV1ChunkNode& node = it->second;
+    if (expected_level != -1 && node.level != expected_level) {
+      return absl::DataLossError(
+          tensorstore::StrCat("Expected B-tree node at level ", expected_level,
+                              " but received level ", node.level));
+    }
+    BtreeV1ChunkNode updated;
+    updated.level = node.level;
+    if (node.level == 0) {
+      TENSORSTORE_RETURN_IF_ERROR(UpdateLeaf(node, updates, updated));
+    } else {
+      TENSORSTORE_RETURN_IF_ERROR(UpdateInternal(node, updates, updated));
+    }
+    return FinalizeNode(address, std::move(updated), replacement);
+  }
+
+  absl::Status UpdateLeaf(const BtreeV1ChunkNode& node,
+                          span<const PendingUpdate> updates,
+                          BtreeV1ChunkNode& updated) {
+    const size_t num_children = node.children.size();
+    size_t i = 0;
+    const auto retain = [&] {
+      updated.keys.push_back(node.keys[i]);
+      updated.children.push_back(node.children[i]);
+      ++i;
+    };
+    for (const auto& update : updates) {
+      while (i < num_children && node.keys[i].offsets < update.offsets) {
+        retain();
+      }
+      const bool exists =
+          i < num_children && node.keys[i].offsets == update.offsets;
+      if (!update.value->has_value()) {
+        if (exists) ++i;
+        continue;
+      }
+      const auto& value = **update.value;
+      if (value.size() > std::numeric_limits<uint32_t>::max()) {
+        return absl::InvalidArgumentError(
+            tensorstore::StrCat("Encoded chunk of ", value.size(),
+                                " bytes exceeds the HDF5 chunk size limit"));
+      }
+      BtreeV1ChunkKey key;
+      key.chunk_size = static_cast<uint32_t>(value.size());
+      key.offsets = update.offsets;
+      uint64_t chunk_address;
+      if (exists && value.size() <= node.keys[i].chunk_size) {
+        // Reuse the existing allocation.
+        chunk_address = node.children[i];
+      } else {
+        chunk_address = Allocate(value.size());
+      }
+      Write(chunk_address, value);
+      if (exists) ++i;
+      updated.keys.push_back(std::move(key));
+      updated.children.push_back(chunk_address);
+    }
+    while (i < num_children) retain();
+
+    // The upper bound must exceed the offset of the last chunk.  It is only
+    // changed if required, since it may equal the lower bound of the next
+    // leaf.
+    BtreeV1ChunkKey upper = node.keys.back();
+    if (!updated.keys.empty() &&
+        !(updated.keys.back().offsets < upper.offsets)) {
+      upper = BtreeV1ChunkKey{};
+      upper.offsets = updated.keys.back().offsets;
+      for (DimensionIndex j = 0; j < params_.rank(); ++j) {
+        upper.offsets[j] += static_cast<uint64_t>(params_.chunk_shape[j]);
+      }
+    }
+    updated.keys.push_back(std::move(upper));
+    return absl::OkStatus();
+  }
+
+  absl::Status UpdateInternal(const BtreeV1ChunkNode& node,
+                              span<const PendingUpdate> updates,
+                              BtreeV1ChunkNode& updated) {
+    const size_t num_children = node.children.size();
+    if (num_children == 0) {
+      return absl::DataLossError("Internal B-tree node has no children");
+    }
+    std::vector<ChildReference> children;
+    size_t begin = 0;
+    for (size_t i = 0; i < num_children; ++i) {
+      size_t end = begin;
+      while (end < updates.size() &&
+             GetChildForUpdate(node, updates[end].offsets) == i) {
+        ++end;
+      }
+      if (begin == end) {
+        children.push_back(
+            ChildReference{node.keys[i], node.children[i], node.keys[i + 1]});
+        continue;
+      }
+      std::vector<ChildReference> replacement;
+      TENSORSTORE_RETURN_IF_ERROR(
+          UpdateSubtree(node.children[i], node.level - 1,
+                        updates.subspan(begin, end - begin), replacement));
+      begin = end;
+      if (!replacement.empty() &&
+          replacement.back().upper.offsets < node.keys[i + 1].offsets) {
+        // Retain the existing bound, which remains valid.
+        replacement.back().upper = node.keys[i + 1];
+      }
+      for (auto& child : replacement) children.push_back(std::move(child));
+    }
+    assert(begin == updates.size());
+    for (auto& child : children) {
+      updated.keys.push_back(std::move(child.lower));
+      updated.children.push_back(child.address);
+    }
+    updated.keys.push_back(children.empty() ? node.keys.back()
+                                            : std::move(children.back().upper));
+    return absl::OkStatus();
+  }
+
+  /// Stores the `updated` node at `address`, splitting or removing it as
+  /// required.
+  absl::Status FinalizeNode(uint64_t address, BtreeV1ChunkNode updated,
+                            std::vector<ChildReference>& replacement) {
+    const BtreeV1ChunkNode& node = nodes_.at(address);
+    updated.left_sibling = node.left_sibling;
+    updated.right_sibling = node.right_sibling;
+    const bool is_root = address == params_.layout.address;
+    if (updated.children.empty()) {
+      if (is_root) {
+        // The root node is retained as an empty leaf.
+        updated.level = 0;
+        if (!NodesEqual(updated, node)) SetNode(address, std::move(updated));
+        return absl::OkStatus();
+      }
+      if (node.left_sibling != kUndefinedAddress) {
+        SetRightSibling(node.left_sibling, node.right_sibling);
+      }
+      if (node.right_sibling != kUndefinedAddress) {
+        SetLeftSibling(node.right_sibling, node.left_sibling);
+      }
+      removed_.insert(address);
+      return absl::OkStatus();
+    }
+    if (updated.children.size() <= max_children_) {
+      replacement.push_back(
+          ChildReference{updated.keys.front(), address, updated.keys.back()});
+      if (!NodesEqual(updated, node)) SetNode(address, std::move(updated));
+      return absl::OkStatus();
+    }
+    if (!is_root) {
+      // The first node retains the address of the original node.
+      const uint64_t right_sibling = node.right_sibling;
+      SplitNode(updated, address, replacement);
+      if (right_sibling != kUndefinedAddress) {
+        SetLeftSibling(right_sibling, replacement.back().address);
+      }
+      return absl::OkStatus();
+    }
+    // The root node must remain at the address stored in the object header of
+    // the dataset.  Its children are moved to new nodes, increasing the
+    // height of the tree.
+    while (updated.children.size() > max_children_) {
+      if (updated.level == std::numeric_limits<uint8_t>::max()) {
+        return absl::InvalidArgumentError("HDF5 chunk B-tree is too deep");
+      }
+      std::vector<ChildReference> children;
+      SplitNode(updated, /*first_address=*/kUndefinedAddress, children);
+      BtreeV1ChunkNode root;
+      root.level = updated.level + 1;
+      for (auto& child : children) {
+        root.keys.push_back(std::move(child.lower));
+        root.children.push_back(child.address);
+      }
+      root.keys.push_back(std::move(children.back().upper));
+      updated = std::move(root);
+    }
+    SetNode(address, std::move(updated));
+    return absl::OkStatus();
+  }
+
+  /// Stores the children of `node` as evenly filled nodes, the first of which
+  /// is stored at `first_address` if specified, and the remainder of which
+  /// are newly allocated.
+  void SplitNode(const BtreeV1ChunkNode& node, uint64_t first_address,
+                 std::vector<ChildReference>& pieces) {
+    const size_t num_children = node.children.size();
+    const size_t num_nodes = (num_children + max_children_ - 1) / max_children_;
+    std::vector<uint64_t> addresses(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+      addresses[i] = (i == 0 && first_address != kUndefinedAddress)
+                         ? first_address
+                         : Allocate(node_size_);
+    }
+    for (size_t i = 0; i < num_nodes; ++i) {
+      const size_t begin = num_children * i / num_nodes;
+      const size_t end = num_children * (i + 1) / num_nodes;
+      BtreeV1ChunkNode piece;
+      piece.level = node.level;
+      piece.left_sibling = i == 0 ? node.left_sibling : addresses[i - 1];
+      piece.right_sibling =
+          i + 1 == num_nodes ? node.right_sibling : addresses[i + 1];
+      piece.children.assign(node.children.begin() + begin,
+                            node.children.begin() + end);
+      piece.keys.assign(node.keys.begin() + begin, node.keys.begin() + end + 1);
+      pieces.push_back(
+          ChildReference{piece.keys.front(), addresses[i], piece.keys.back()});
+      SetNode(addresses[i], std::move(piece));
+    }
+  }
+
+  const ChunkIndexParameters& params_;
+  BtreeV1NodeMap nodes_;
+  uint64_t end_of_file_address_;
+  uint64_t node_size_;
+  size_t max_children_;
+
+  /// Addresses of nodes that must be written.
+  std::set<uint64_t> dirty_;
+
+  /// Addresses of nodes that were unlinked from the tree.
+  std::set<uint64_t> removed_;
+
+  std::map<uint64_t, SiblingPatch> patches_;
+  std::map<uint64_t, absl::Cord> writes_;
+};
+
+}  // namespace
+
+Result<ChunkIndexMap> DecodeChunkIndex(const absl::Cord& file,
+                                       const ChunkIndexParameters& params) {
+  TENSORSTORE_RETURN_IF_ERROR(ValidateChunkIndexType(params));
+  ChunkIndexMap index;
+  if (params.layout.address != kUndefinedAddress) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        DecodeBtreeV1Subtree(file, params, params.layout.address,
+                             /*expected_level=*/-1, index),
+        tensorstore::MaybeAnnotateStatus(_, "Error decoding HDF5 chunk index"));
+  }
+  return index;
+}
+
+Result<std::vector<uint64_t>> GetRequiredBtreeV1Nodes(
+    const ChunkIndexParameters& params, const BtreeV1NodeMap& nodes,
+    span<const ChunkUpdate> updates) {
+  TENSORSTORE_RETURN_IF_ERROR(ValidateChunkIndexForWriting(params));
+  std::vector<uint64_t> required;
+  for (const auto& update : updates) {
+    const auto offsets = GetChunkOffsets(params, update.cell_indices);
+    uint64_t address = params.layout.address;
+    int expected_level = -1;
+    while (true) {
+      auto it = nodes.find(address);
+      if (it == nodes.end()) {
+        required.push_back(address);
+        break;
+      }
+      const auto& node = it->second;
+      if (expected_level != -1 && node.level != expected_level) {
+        return absl::DataLossError(tensorstore::StrCat(
+            "Expected B-tree node at level ", expected_level,
+            " but received level ", node.level));
+      }
+      if (node.level == 0 || node.children.empty()) break;
+      expected_level = node.level - 1;
+      address = node.children[GetChildForUpdate(node, offsets)];
+    }
+  }
+  std::sort(required.begin(), required.end());
+  required.erase(std::unique(required.begin(), required.end()),
+                 required.end());
+  return required;
+}
+
+Result<FileUpdate> ApplyChunkUpdates(const ChunkIndexParameters& params,
+                                     std::string_view superblock,
+                                     BtreeV1NodeMap nodes,
+                                     std::vector<ChunkUpdate> updates) {
+  TENSORSTORE_RETURN_IF_ERROR(ValidateChunkIndexForWriting(params));
+  const auto& format = params.format;
+  TENSORSTORE_ASSIGN_OR_RETURN(const uint64_t end_of_file_address,
+                               GetEndOfFileAddress(superblock, format));
+
+  std::vector<PendingUpdate> pending;
+  pending.reserve(updates.size());
+  for (const auto& update : updates) {
+    pending.push_back(PendingUpdate{
+        GetChunkOffsets(params, update.cell_indices), &update.value});
+  }
+  std::sort(pending.begin(), pending.end(),
+            [](const PendingUpdate& a, const PendingUpdate& b) {
+              return a.offsets < b.offsets;
+            });
+
+  BtreeV1Writer writer(params, std::move(nodes), end_of_file_address);
+  TENSORSTORE_RETURN_IF_ERROR(
+      writer.Apply(pending),
+      tensorstore::MaybeAnnotateStatus(_, "Error updating HDF5 chunk index"));
+  const uint64_t new_end_of_file_address = writer.end_of_file_address();
+  auto writes = std::move(writer).GetWrites();
+  if (new_end_of_file_address != end_of_file_address) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto encoded,
+        SetEndOfFileAddress(superblock, format, new_end_of_file_address));
+    writes[format.base_address] = absl::Cord(std::move(encoded));
+  }
+
+  // Adjacent writes, such as those allocated at the end of the file, are
+  // coalesced into a single byte range.
+  FileUpdate file_update;
+  for (auto& [offset, data] : writes) {
+    const int64_t inclusive_min = static_cast<int64_t>(offset);
+    const int64_t exclusive_max =
+        inclusive_min + static_cast<int64_t>(data.size());
+    if (!file_update.byte_ranges.empty()) {
+      auto& last = file_update.byte_ranges.back();
+      if (inclusive_min < last.exclusive_max) {
+        return absl::DataLossError(tensorstore::StrCat(
+            "HDF5 file structures overlap at offset ", inclusive_min));
+      }
+      if (inclusive_min == last.exclusive_max) {
+        last.exclusive_max = exclusive_max;
+        file_update.value.Append(std::move(data));
+        continue;
+      }
+    }
+    file_update.byte_ranges.push_back(ByteRange{inclusive_min, exclusive_max});
+    file_update.value.Append(std::move(data));
+  }
+  return file_update;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,126 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_CHUNK_WRITER_H_
+#define TENSORSTORE_DRIVER_HDF5_CHUNK_WRITER_H_
+
+/// \file
+///
+/// Application of a batch of chunk modifications to an HDF5 file, as a set of
+/// byte range writes.
+///
+/// All modifications of a single commit are applied together.  Only the
+/// version 1 B-tree nodes on the paths to the modified chunks are decoded, see
+/// `GetRequiredBtreeV1Nodes`.  The file is then updated in place:
+///
+/// - A new chunk that fits within the existing allocation of the chunk is
+///   written in place; otherwise it is allocated at the end of the file.
+///
+/// - Modified B-tree nodes are rewritten in place.  Nodes that overflow are
+///   split, with the additional nodes allocated at the end of the file, and
+///   nodes that become empty are unlinked from their siblings.  Sibling
+///   pointers of nodes that are not otherwise modified are patched in place.
+///
+/// - The superblock "end of file address" is updated once.
+///
+/// Space previously occupied by replaced chunks and index nodes is not
+/// reclaimed, which matches the behavior of the HDF5 library when the file
+/// does not track free space.
+///
+/// The byte ranges are applied by a single conditional partial write of the
+/// base key-value store, such that the update is atomic if the base key-value
+/// store applies partial writes atomically, as the `file` driver does.
+
+#include <stdint.h>
+
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/index.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// In-memory representation of the chunk index of a dataset, keyed by grid
+/// cell indices.
+using ChunkIndexMap = std::map<std::vector<Index>, ChunkIndexEntry>;
+
+/// Decodes all entries of the chunk index of the dataset specified by
+/// `params` from the full contents of the file.
+///
+/// \error `absl::StatusCode::kUnimplemented` if the chunk index type is not
+///     supported.
+/// \error `absl::StatusCode::kDataLoss` if the chunk index is corrupt.
+Result<ChunkIndexMap> DecodeChunkIndex(const absl::Cord& file,
+                                       const ChunkIndexParameters& params);
+
+/// Modification of a single chunk.
+struct ChunkUpdate {
+  std::vector<Index> cell_indices;
+
+  /// New encoded chunk, or `std::nullopt` to delete the chunk.
+  std::optional<absl::Cord> value;
+};
+
+/// Decoded version 1 B-tree nodes of a chunk index, keyed by address.
+using BtreeV1NodeMap = std::map<uint64_t, BtreeV1ChunkNode>;
+
+/// Returns the addresses of the B-tree nodes, not already present in `nodes`,
+/// that must be decoded before `updates` can be applied.
+///
+/// This is called repeatedly, adding the returned nodes to `nodes`, until no
+/// further nodes are required.  Each call returns the nodes of the next level
+/// of the tree.
+///
+/// \error `absl::StatusCode::kUnimplemented` if the chunk index type is not
+///     supported for writing, or the chunk index has not been allocated.
+Result<std::vector<uint64_t>> GetRequiredBtreeV1Nodes(
+    const ChunkIndexParameters& params, const BtreeV1NodeMap& nodes,
+    span<const ChunkUpdate> updates);
+
+/// Byte range writes to a file.
+struct FileUpdate {
+  /// Absolute byte ranges of the file to overwrite, non-overlapping and in
+  /// increasing order, as required by `kvstore::WriteOptions::byte_ranges`.
+  std::vector<ByteRange> byte_ranges;
+
+  /// New contents of `byte_ranges`, concatenated.
+  absl::Cord value;
+};
+
+/// Applies `updates` to the chunks of the dataset specified by `params`.
+///
+/// \param superblock Prefix of the superblock of at least
+///     `GetSuperblockPrefixSize(params.format)` bytes.
+/// \param nodes B-tree nodes required by `GetRequiredBtreeV1Nodes`.
+/// \param updates Chunk modifications, with distinct `cell_indices`.
+/// \returns The writes that must be applied to the file.
+/// \error `absl::StatusCode::kUnimplemented` if the chunk index type is not
+///     supported for writing, or the chunk index has not been allocated.
+Result<FileUpdate> ApplyChunkUpdates(const ChunkIndexParameters& params,
+                                     std::string_view superblock,
+                                     BtreeV1NodeMap nodes,
+                                     std::vector<ChunkUpdate> updates);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_CHUNK_WRITER_H_
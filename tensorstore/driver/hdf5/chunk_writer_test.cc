@@ -0,0 +1,331 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/chunk_writer.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::internal_hdf5::ApplyChunkUpdates;
+using ::tensorstore::internal_hdf5::BtreeV1ChunkNode;
+using ::tensorstore::internal_hdf5::BtreeV1NodeMap;
+using ::tensorstore::internal_hdf5::ChunkIndexEntry;
+using ::tensorstore::internal_hdf5::ChunkIndexMap;
+using ::tensorstore::internal_hdf5::ChunkIndexParameters;
+using ::tensorstore::internal_hdf5::ChunkUpdate;
+using ::tensorstore::internal_hdf5::DecodeBtreeV1ChunkNode;
+using ::tensorstore::internal_hdf5::DecodeChunkIndex;
+using ::tensorstore::internal_hdf5::EncodeBtreeV1ChunkNode;
+using ::tensorstore::internal_hdf5::FileUpdate;
+using ::tensorstore::internal_hdf5::GetBtreeV1ChunkNodeSize;
+using ::tensorstore::internal_hdf5::GetEndOfFileAddress;
+using ::tensorstore::internal_hdf5::GetRequiredBtreeV1Nodes;
+using ::tensorstore::internal_hdf5::GetSuperblockPrefixSize;
+using ::tensorstore::internal_hdf5::kUndefinedAddress;
+using ::tensorstore::internal_hdf5::Lookup3Checksum;
+
+constexpr uint64_t kSuperblockSize = 48;
+
+// Returns a version 2 superblock with 8-byte offsets and lengths.
+std::string EncodeSuperblock(uint64_t end_of_file_address) {
+  std::string out("\x89HDF\r\n\x1a\n", 8);
+  out.push_back(2);  // version
+  out.push_back(8);  // size of offsets
+  out.push_back(8);  // size of lengths
+  out.push_back(0);  // file consistency flags
+  for (uint64_t address :
+       {uint64_t(0), kUndefinedAddress, end_of_file_address, uint64_t(0)}) {
+    for (int i = 0; i < 8; ++i) {
+      out.push_back(static_cast<char>((address >> (8 * i)) & 0xff));
+    }
+  }
+  const uint32_t checksum = Lookup3Checksum(out);
+  for (int i = 0; i < 4; ++i) {
+    out.push_back(static_cast<char>((checksum >> (8 * i)) & 0xff));
+  }
+  return out;
+}
+
+ChunkIndexParameters GetTestParameters() {
+  ChunkIndexParameters params;
+  params.format.indexed_storage_k = 2;
+  params.layout.address = kSuperblockSize;
+  params.shape = {100, 100};
+  params.chunk_shape = {4, 8};
+  params.element_size = 1;
+  return params;
+}
+
+// Returns a file containing an empty chunk index.
+absl::Cord GetEmptyFile(const ChunkIndexParameters& params) {
+  const uint64_t node_size = GetBtreeV1ChunkNodeSize(params.format, 2);
+  BtreeV1ChunkNode root;
+  root.keys.resize(1);
+  root.keys[0].offsets.resize(3);
+  absl::Cord file(EncodeSuperblock(kSuperblockSize + node_size));
+  file.Append(EncodeBtreeV1ChunkNode(root, params.format, 2));
+  return file;
+}
+
+std::string ReadChunk(const absl::Cord& file, const ChunkIndexEntry& entry) {
+  return std::string(file.Subcord(entry.address, entry.size));
+}
+
+// Decodes the B-tree nodes required to apply `updates` to `file`, and
+// returns the resultant writes.
+Result<FileUpdate> GetFileUpdate(const absl::Cord& file,
+                                 const ChunkIndexParameters& params,
+                                 std::vector<ChunkUpdate> updates) {
+  BtreeV1NodeMap nodes;
+  const uint64_t node_size = GetBtreeV1ChunkNodeSize(params.format, 2);
+  while (true) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto required, GetRequiredBtreeV1Nodes(params, nodes, updates));
+    if (required.empty()) break;
+    for (uint64_t address : required) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          nodes[address],
+          DecodeBtreeV1ChunkNode(file.Subcord(address, node_size),
+                                 params.format, 2));
+    }
+  }
+  const std::string superblock(
+      file.Subcord(0, GetSuperblockPrefixSize(params.format)));
+  return ApplyChunkUpdates(params, superblock, std::move(nodes),
+                           std::move(updates));
+}
+
+Result<absl::Cord> ApplyToFile(const absl::Cord& file,
+                               const ChunkIndexParameters& params,
+                               std::vector<ChunkUpdate> updates) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto update,
+                               GetFileUpdate(file, params, std::move(updates)));
+  return tensorstore::internal::OverwriteByteRanges(file, update.byte_ranges,
+                                                    update.value);
+}
+
+uint64_t GetEndOfFile(const absl::Cord& file,
+                      const ChunkIndexParameters& params) {
+  return GetEndOfFileAddress(
+             std::string(file.Subcord(0, GetSuperblockPrefixSize(
+                                             params.format))),
+             params.format)
+      .value();
+}
+
+// Verifies that the sibling pointers of each level of the B-tree of `file`
+// link the nodes of the level in order.
+void CheckSiblingPointers(const absl::Cord& file,
+                          const ChunkIndexParameters& params) {
+  const uint64_t node_size = GetBtreeV1ChunkNodeSize(params.format, 2);
+  std::vector<uint64_t> level = {params.layout.address};
+  while (!level.empty()) {
+    std::vector<uint64_t> next_level;
+    for (size_t i = 0; i < level.size(); ++i) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto node,
+          DecodeBtreeV1ChunkNode(file.Subcord(level[i], node_size),
+                                 params.format, 2));
+      EXPECT_EQ(i == 0 ? kUndefinedAddress : level[i - 1], node.left_sibling);
+      EXPECT_EQ(i + 1 == level.size() ? kUndefinedAddress : level[i + 1],
+                node.right_sibling);
+      if (node.level != 0) {
+        next_level.insert(next_level.end(), node.children.begin(),
+                          node.children.end());
+      }
+    }
+    level = std::move(next_level);
+  }
+}
+
+TEST(ChunkWriterTest, EmptyIndex) {
+  const auto params = GetTestParameters();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto index, DecodeChunkIndex(GetEmptyFile(params), params));
+  EXPECT_TRUE(index.empty());
+}
+
+TEST(ChunkWriterTest, WriteMultiLevel) {
+  const auto params = GetTestParameters();
+  const auto file = GetEmptyFile(params);
+  // More than 2*K chunks requires a second level.
+  std::vector<ChunkUpdate> updates;
+  for (Index i = 0; i < 7; ++i) {
+    updates.push_back(
+        ChunkUpdate{{i, 6 - i}, absl::Cord(std::string(i + 1, 'a' + i))});
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto new_file,
+                                   ApplyToFile(file, params, updates));
+  const uint64_t end_of_file_address = GetEndOfFile(new_file, params);
+  EXPECT_EQ(new_file.size(), end_of_file_address);
+  // The superblock checksum was updated.
+  const std::string superblock(new_file.Subcord(0, kSuperblockSize));
+  EXPECT_EQ(superblock, EncodeSuperblock(end_of_file_address));
+  CheckSiblingPointers(new_file, params);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index,
+                                   DecodeChunkIndex(new_file, params));
+  ASSERT_EQ(7, index.size());
+  for (Index i = 0; i < 7; ++i) {
+    auto it = index.find({i, 6 - i});
+    ASSERT_NE(it, index.end());
+    EXPECT_EQ(i + 1, it->second.size);
+    EXPECT_EQ(std::string(i + 1, 'a' + i), ReadChunk(new_file, it->second));
+  }
+
+  // Overwrite one chunk with a smaller value, which reuses its allocation, and
+  // delete another.  Nothing is allocated.
+  const auto old_entry = index[{2, 4}];
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto new_file2,
+      ApplyToFile(new_file, params,
+                  {ChunkUpdate{{2, 4}, absl::Cord("x")},
+                   ChunkUpdate{{3, 3}, std::nullopt}}));
+  EXPECT_EQ(new_file.size(), new_file2.size());
+  EXPECT_EQ(end_of_file_address, GetEndOfFile(new_file2, params));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index2,
+                                   DecodeChunkIndex(new_file2, params));
+  ASSERT_EQ(6, index2.size());
+  EXPECT_EQ(0, index2.count({3, 3}));
+  EXPECT_EQ((ChunkIndexEntry{old_entry.address, 1, 0}), (index2[{2, 4}]));
+  EXPECT_EQ("x", ReadChunk(new_file2, index2[{2, 4}]));
+  EXPECT_EQ((index[{6, 0}]), (index2[{6, 0}]));
+  EXPECT_EQ("ggggggg", ReadChunk(new_file2, index2[{6, 0}]));
+}
+
+TEST(ChunkWriterTest, WritesOnlyModifiedExtents) {
+  const auto params = GetTestParameters();
+  std::vector<ChunkUpdate> updates;
+  for (Index i = 0; i < 7; ++i) {
+    updates.push_back(ChunkUpdate{{i, 0}, absl::Cord(std::string(4, 'a' + i))});
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto file, ApplyToFile(GetEmptyFile(params), params, updates));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index, DecodeChunkIndex(file, params));
+
+  // A larger chunk is appended at the end of the file.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto update,
+      GetFileUpdate(file, params,
+                    {ChunkUpdate{{3, 0}, absl::Cord(std::string(10, 'z'))}}));
+  for (const auto& [cell_indices, entry] : index) {
+    for (const auto& range : update.byte_ranges) {
+      EXPECT_TRUE(range.exclusive_max <= static_cast<int64_t>(entry.address) ||
+                  range.inclusive_min >=
+                      static_cast<int64_t>(entry.address + entry.size))
+          << range;
+    }
+  }
+  // The new chunk is allocated at the previous end of the file, and only the
+  // superblock and the modified B-tree nodes are rewritten.
+  ASSERT_FALSE(update.byte_ranges.empty());
+  EXPECT_EQ(static_cast<int64_t>(file.size()) + 10,
+            update.byte_ranges.back().exclusive_max);
+  EXPECT_LT(update.value.size(), file.size());
+
+  auto new_file = tensorstore::internal::OverwriteByteRanges(
+      file, update.byte_ranges, update.value);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index2,
+                                   DecodeChunkIndex(new_file, params));
+  EXPECT_EQ(std::string(10, 'z'), ReadChunk(new_file, index2[{3, 0}]));
+  EXPECT_EQ("aaaa", ReadChunk(new_file, index2[{0, 0}]));
+}
+
+TEST(ChunkWriterTest, SplitAndRemoveNodes) {
+  const auto params = GetTestParameters();
+  auto file = GetEmptyFile(params);
+  std::map<std::vector<Index>, std::string> expected;
+  // Insert chunks in several batches, in an order that splits nodes at every
+  // level of a three-level tree.
+  for (Index batch = 0; batch < 4; ++batch) {
+    std::vector<ChunkUpdate> updates;
+    for (Index i = batch; i < 40; i += 4) {
+      std::string value(1 + i % 5, static_cast<char>('A' + i % 26));
+      updates.push_back(ChunkUpdate{{i / 8, i % 8}, absl::Cord(value)});
+      expected[{i / 8, i % 8}] = value;
+    }
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(file, ApplyToFile(file, params, updates));
+    CheckSiblingPointers(file, params);
+  }
+  // Delete a contiguous range of chunks, which removes entire nodes.
+  std::vector<ChunkUpdate> deletes;
+  for (Index i = 4; i < 30; ++i) {
+    deletes.push_back(ChunkUpdate{{i / 8, i % 8}, std::nullopt});
+    expected.erase({i / 8, i % 8});
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(file, ApplyToFile(file, params, deletes));
+  CheckSiblingPointers(file, params);
+  EXPECT_EQ(file.size(), GetEndOfFile(file, params));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index, DecodeChunkIndex(file, params));
+  ASSERT_EQ(expected.size(), index.size());
+  for (const auto& [cell_indices, value] : expected) {
+    auto it = index.find(cell_indices);
+    ASSERT_NE(it, index.end());
+    EXPECT_EQ(value, ReadChunk(file, it->second));
+  }
+
+  // Deleting all remaining chunks leaves an empty root node.
+  deletes.clear();
+  for (const auto& [cell_indices, value] : expected) {
+    deletes.push_back(ChunkUpdate{cell_indices, std::nullopt});
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(file, ApplyToFile(file, params, deletes));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(index, DecodeChunkIndex(file, params));
+  EXPECT_TRUE(index.empty());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      file, ApplyToFile(file, params, {ChunkUpdate{{1, 1}, absl::Cord("q")}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(index, DecodeChunkIndex(file, params));
+  ASSERT_EQ(1, index.size());
+  EXPECT_EQ("q", ReadChunk(file, index[{1, 1}]));
+}
+
+TEST(ChunkWriterTest, UnallocatedIndex) {
+  auto params = GetTestParameters();
+  const auto file = GetEmptyFile(params);
+  params.layout.address = kUndefinedAddress;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto index, DecodeChunkIndex(file, params));
+  EXPECT_TRUE(index.empty());
+  EXPECT_THAT(
+      GetFileUpdate(file, params, {ChunkUpdate{{0, 0}, absl::Cord("x")}}),
+      MatchesStatus(absl::StatusCode::kUnimplemented));
+}
+
+TEST(Lookup3ChecksumTest, Basic) {
+  EXPECT_EQ(0xdeadbeef, Lookup3Checksum(""));
+  EXPECT_EQ(0x17770551, Lookup3Checksum("Four score and seven years ago"));
+  EXPECT_EQ(0xcd628161, Lookup3Checksum("Four score and seven years ago", 1));
+}
+
+}  // namespace
@@ -36,14 +36,8 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(Compressor, [](auto is_loading,
                                                       const auto& options,
                                                       auto* obj,
                                                       ::nlohmann::json* j) {
-                                                        
   namespace jb = tensorstore::internal_json_binding;
   auto& registry = GetCompressorRegistry();
-  // return jb::MapValue(jb::Object(registry.MemberBinder("id")),
-  //                     // JSON value of `null` maps to default-initialized
-  //                     // `Compressor` (i.e. nullptr).
-  //                     std::make_pair(Compressor{}, nullptr))(is_loading,
-  //                                                            options, obj, j);
   return jb::Object(
       jb::Member("id",
                  jb::MapValue(registry.KeyBinder(),
@@ -0,0 +1,201 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// Tests of the HDF5-specific filters.  The filters that reuse the codecs
+/// under `internal/compression` are tested by `filter_pipeline_test`.
+
+#include "tensorstore/driver/hdf5/compressor.h"
+
+#include <stddef.h>
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesJson;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_hdf5::Compressor;
+
+absl::Cord Bytes(std::initializer_list<unsigned char> bytes) {
+  return absl::Cord(std::string(bytes.begin(), bytes.end()));
+}
+
+// Encodes `input` with `compressor`, checks the result against `expected`,
+// and checks that it decodes to `input`.
+void TestRoundTrip(const Compressor& compressor, const absl::Cord& input,
+                   const absl::Cord& expected, size_t element_bytes) {
+  absl::Cord encoded, decoded;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encoded, element_bytes));
+  EXPECT_EQ(expected, encoded);
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encoded, &decoded, element_bytes));
+  EXPECT_EQ(input, decoded);
+}
+
+TEST(ShuffleCompressorTest, RoundTrip) {
+  auto compressor = Compressor::FromJson({{"id", "shuffle"}}).value();
+  // The trailing byte does not form a complete element and is unchanged.
+  TestRoundTrip(compressor, Bytes({1, 2, 3, 4, 5, 6, 7}),
+                Bytes({1, 3, 5, 2, 4, 6, 7}), 2);
+  TestRoundTrip(compressor, Bytes({1, 2, 3}), Bytes({1, 2, 3}), 1);
+}
+
+TEST(Fletcher32CompressorTest, RoundTrip) {
+  auto compressor = Compressor::FromJson({{"id", "fletcher32"}}).value();
+  TestRoundTrip(compressor, absl::Cord("abcde"),
+                absl::Cord("abcde\xc7\x29\xf0\x4f"), 1);
+}
+
+TEST(Fletcher32CompressorTest, ByteSwappedChecksum) {
+  auto compressor = Compressor::FromJson({{"id", "fletcher32"}}).value();
+  absl::Cord decoded;
+  TENSORSTORE_EXPECT_OK(
+      compressor->Decode(absl::Cord("abcde\x4f\xf0\x29\xc7"), &decoded, 1));
+  EXPECT_EQ("abcde", decoded);
+}
+
+TEST(Fletcher32CompressorTest, Corrupt) {
+  auto compressor = Compressor::FromJson({{"id", "fletcher32"}}).value();
+  absl::Cord decoded;
+  EXPECT_THAT(
+      compressor->Decode(absl::Cord("abcdf\xc7\x29\xf0\x4f"), &decoded, 1),
+      MatchesStatus(absl::StatusCode::kDataLoss, ".*checksum mismatch.*"));
+  EXPECT_THAT(compressor->Decode(absl::Cord("abc"), &decoded, 1),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*too small.*"));
+}
+
+TEST(Lz4CompressorTest, UncompressibleBlock) {
+  auto compressor = Compressor::FromJson({{"id", "lz4"}}).value();
+  TestRoundTrip(compressor, absl::Cord("abcd"),
+                Bytes({0, 0, 0, 0, 0, 0, 0, 4,  // decoded size
+                       0, 0, 0, 4,              // block size
+                       0, 0, 0, 4,              // encoded block size
+                       'a', 'b', 'c', 'd'}),
+                1);
+}
+
+TEST(Lz4CompressorTest, MultipleBlocks) {
+  auto compressor =
+      Compressor::FromJson({{"id", "lz4"}, {"block_size", 64}}).value();
+  const absl::Cord input(std::string(200, 'x'));
+  absl::Cord encoded, decoded;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encoded, 1));
+  EXPECT_LT(encoded.size(), input.size());
+  EXPECT_EQ(Bytes({0, 0, 0, 0, 0, 0, 0, 200, 0, 0, 0, 64}),
+            encoded.Subcord(0, 12));
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encoded, &decoded, 1));
+  EXPECT_EQ(input, decoded);
+  EXPECT_THAT(compressor->Decode(encoded.Subcord(0, encoded.size() - 1),
+                                 &decoded, 1),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*"));
+}
+
+TEST(NbitCompressorTest, RoundTrip) {
+  auto compressor = Compressor::FromJson({{"id", "nbit"},
+                                          {"num_elements", 3},
+                                          {"precision", 4},
+                                          {"offset", 2}})
+                        .value();
+  // Significant bits 0b1111, 0b0001 and 0b0010.
+  TestRoundTrip(compressor, Bytes({0x3c, 0, 0x04, 0, 0x08, 0}),
+                Bytes({0xf1, 0x20}), 2);
+}
+
+TEST(NbitCompressorTest, BigEndian) {
+  auto compressor = Compressor::FromJson({{"id", "nbit"},
+                                          {"num_elements", 2},
+                                          {"precision", 12},
+                                          {"byte_order", "big"}})
+                        .value();
+  // A trailing zero byte is written if the packed bits fill the last byte.
+  TestRoundTrip(compressor, Bytes({0x0a, 0xbc, 0x0d, 0xef}),
+                Bytes({0xab, 0xcd, 0xef, 0x00}), 2);
+}
+
+TEST(NbitCompressorTest, Invalid) {
+  EXPECT_THAT(Compressor::FromJson({{"id", "nbit"}, {"precision", 4}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"num_elements\".*"));
+  auto compressor = Compressor::FromJson({{"id", "nbit"},
+                                          {"num_elements", 3},
+                                          {"precision", 4},
+                                          {"offset", 6}})
+                        .value();
+  absl::Cord encoded;
+  EXPECT_THAT(compressor->Encode(Bytes({1, 2, 3}), &encoded, 1),
+              MatchesStatus(absl::StatusCode::kInvalidArgument, ".*"));
+}
+
+TEST(ScaleOffsetCompressorTest, Signed) {
+  auto compressor = Compressor::FromJson({{"id", "scaleoffset"},
+                                          {"num_elements", 4},
+                                          {"signed", true}})
+                        .value();
+  // -2, 0, 1, 5 are stored as 0, 2, 3, 7 with 3 bits each.
+  TestRoundTrip(compressor, Bytes({0xfe, 0xff, 0, 0, 1, 0, 5, 0}),
+                Bytes({3, 0, 0, 0,                                // minbits
+                       8,                                         // size
+                       0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,  // minval
+                       0xff, 0, 0, 0, 0, 0, 0, 0, 0,              // padding
+                       0x09, 0xf0}),
+                2);
+}
+
+TEST(ScaleOffsetCompressorTest, FillValue) {
+  auto compressor = Compressor::FromJson({{"id", "scaleoffset"},
+                                          {"num_elements", 4},
+                                          {"signed", true},
+                                          {"fill_value", 5}})
+                        .value();
+  // -2, 0, 1 are stored as 0, 2, 3, and the fill value as all ones.
+  TestRoundTrip(compressor, Bytes({0xfe, 0xff, 0, 0, 1, 0, 5, 0}),
+                Bytes({3, 0, 0, 0, 8, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff,
+                       0xff, 0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0x09, 0xf0}),
+                2);
+}
+
+TEST(ScaleOffsetCompressorTest, Unpacked) {
+  auto compressor = Compressor::FromJson({{"id", "scaleoffset"},
+                                          {"num_elements", 2},
+                                          {"byte_order", "big"}})
+                        .value();
+  // The full range of values requires all bits, and the elements are stored
+  // unpacked in little endian order.
+  TestRoundTrip(compressor, Bytes({0, 0, 0xff, 0xfe}),
+                Bytes({16, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                       0, 0, 0, 0, 0, 0xfe, 0xff}),
+                2);
+}
+
+TEST(ScaleOffsetCompressorTest, ToJson) {
+  auto compressor = Compressor::FromJson({{"id", "scaleoffset"},
+                                          {"num_elements", 4},
+                                          {"fill_value", -1}})
+                        .value();
+  EXPECT_THAT(::nlohmann::json(compressor),
+              MatchesJson({{"id", "scaleoffset"},
+                           {"num_elements", 4},
+                           {"signed", false},
+                           {"byte_order", "little"},
+                           {"fill_value", -1}}));
+}
+
+}  // namespace
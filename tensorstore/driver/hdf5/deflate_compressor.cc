@@ -0,0 +1,48 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "deflate" filter (filter id 1), which stores each chunk
+/// in the zlib format.  Linking in this library automatically registers it.
+
+#include "tensorstore/internal/compression/zlib_compressor.h"
+
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+struct DeflateCompressor : public internal::ZlibCompressor {};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<DeflateCompressor>(
+        "deflate",
+        jb::Object(
+            jb::Initialize([](auto* obj) { obj->use_gzip_header = false; }),
+            jb::Member("level",
+                       jb::Projection(
+                           &DeflateCompressor::level,
+                           jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                               [](auto* v) { *v = 6; },
+                               jb::Integer<int>(0, 9))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -15,13 +15,16 @@
 #include "tensorstore/driver/driver.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/ascii.h"
@@ -42,8 +45,12 @@
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 #include "tensorstore/driver/registry.h"
-// #include "tensorstore/driver/zarr3/chunk_cache.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
+#include "tensorstore/driver/hdf5/chunk_store.h"
+#include "tensorstore/driver/hdf5/filter_pipeline.h"
 #include "tensorstore/driver/hdf5/metadata.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/driver/hdf5/object_header_store.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/dimension_units.h"
@@ -55,15 +62,22 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
+#include "tensorstore/internal/grid_partition.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
+#include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
@@ -72,7 +86,6 @@
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
-#include <iostream>
 
 namespace tensorstore {
 namespace internal_hdf5 {
@@ -88,8 +101,6 @@ namespace jb = tensorstore::internal_json_binding;
 
 using ::tensorstore::internal_kvs_backed_chunk_driver::KvsDriverSpec;
 
-constexpr const char kMetadataKey[] = "h5_meta.json";
-
 class HDF5DriverSpec
     : public internal::RegisteredDriverSpec<HDF5DriverSpec,
                                             /*Parent=*/KvsDriverSpec> {
@@ -101,22 +112,24 @@ class HDF5DriverSpec
 
   HDF5MetadataConstraints metadata_constraints;
 
+  /// Path of the dataset within the file, e.g. `"/group/data"`.
+  std::string dataset;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    std::cout << "HDF5DriverSpec::ApplyMembers --- x.metdata_constraints: "
-    << x.metadata_constraints.ToJson().value() << std::endl;
-    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints);
+    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints,
+             x.dataset);
   };
 
   static inline const auto default_json_binder = jb::Sequence(
       jb::Validate(
           [](const auto& options, auto* obj) {
             if (obj->schema.dtype().valid()) {
-              std::cout << "HDF5 default_json_binder's: " << (tensorstore::StrCat(obj->schema.dtype(), " is current dtype")) << std::endl;
               return ValidateDataType(obj->schema.dtype());
             }
             return absl::OkStatus();
           },
           internal_kvs_backed_chunk_driver::SpecJsonBinder),
+      jb::Member("dataset", jb::Projection<&HDF5DriverSpec::dataset>()),
       jb::Member(
           "metadata",
           jb::Validate(
@@ -132,7 +145,6 @@ class HDF5DriverSpec
       );
 
   absl::Status ApplyOptions(SpecOptions&& options) override {
-    std::cout << "HDF5DriverSpec::ApplyOptions options.minimal_spec = " << options.minimal_spec << std::endl;
     if (options.minimal_spec) {
       metadata_constraints = HDF5MetadataConstraints{};
     }
@@ -140,17 +152,14 @@ class HDF5DriverSpec
   }
 
   Result<IndexDomain<>> GetDomain() const override {
-    std::cout << "HDF5DriverSpec::GetDomain()" << std::endl;
     return GetEffectiveDomain(metadata_constraints, schema);
   }
 
   Result<CodecSpec> GetCodec() const override {
-    std::cout << "HDF5DriverSpec::GetCodec()" << std::endl;
     return Base::GetCodec();
   }
 
   Result<ChunkLayout> GetChunkLayout() const override {
-    std::cout << "HDF5DriverSpec::GetChunkLayout()" << std::endl;
     return Base::GetChunkLayout();
   }
 
@@ -158,47 +167,29 @@ class HDF5DriverSpec
       internal::DriverOpenRequest request) const override;
 };
 
-// Result<std::shared_ptr<const ZarrMetadata>> ParseEncodedMetadata(
-//     std::string_view encoded_value) {
-//   nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-//                                                   /*allow_exceptions=*/false);
-//   if (raw_data.is_discarded()) {
-//     return absl::DataLossError("Invalid JSON");
-//   }
-//   TENSORSTORE_ASSIGN_OR_RETURN(auto metadata,
-//                                ZarrMetadata::FromJson(std::move(raw_data)));
-//   return std::make_shared<ZarrMetadata>(std::move(metadata));
-// }
-
 class MetadataCache : public internal_kvs_backed_chunk_driver::MetadataCache {
   using Base = internal_kvs_backed_chunk_driver::MetadataCache;
 
  public:
   using Base::Base;
 
-  // TODO: Think how to do this for HDF5
-  //  Metadata is stored as JSON under the `hdf5_meta.json` key.
+  // Metadata is read through the `GetObjectHeaderKeyValueStore` adapter,
+  // which maps the entry key, as returned by `EncodeObjectHeaderKey`, to the
+  // object header messages of the dataset.
   std::string GetMetadataStorageKey(std::string_view entry_key) override {
-    std::cout << "HDF5 MetadataCache::GetMetadataStorageKey(): " << entry_key << "+" 
-      << kMetadataKey << std::endl;
-    return tensorstore::StrCat(entry_key, kMetadataKey);
+    return std::string(entry_key);
   }
 
   Result<MetadataPtr> DecodeMetadata(std::string_view entry_key,
                                      absl::Cord encoded_metadata) override {
-    std::cout << "HDF5 MetadataCache::DecodeMetadata() with key (" << entry_key 
-      << ")" << std::endl;
-    // return ParseEncodedMetadata(encoded_metadata.Flatten());
-    return std::make_shared<HDF5Metadata>();
+    TENSORSTORE_ASSIGN_OR_RETURN(auto header,
+                                 DecodeDatasetObjectHeader(encoded_metadata));
+    return GetMetadataFromObjectHeader(header);
   }
 
   Result<absl::Cord> EncodeMetadata(std::string_view entry_key,
                                     const void* metadata) override {
-    std::cout << "HDF5 MetadataCache::EncodeMetadata() for key (" << entry_key 
-      << ")" << std::endl;
-    // return absl::Cord(
-    //     ::nlohmann::json(*static_cast<const HDF5Metadata*>(metadata)).dump());
-    return absl::Cord();
+    return absl::UnimplementedError("Creating HDF5 datasets is not supported");
   }
 };
 
@@ -207,18 +198,18 @@ class DataCache : public internal_kvs_backed_chunk_driver::DataCache {
   using Base = internal_kvs_backed_chunk_driver::DataCache;
 
  public:
-  explicit DataCache(Initializer&& initializer, std::string key_prefix)
+  explicit DataCache(Initializer&& initializer, std::string key_prefix,
+                     std::string dataset)
       : Base(std::move(initializer),
              GetChunkGridSpecification(
                  *static_cast<const HDF5Metadata*>(initializer.metadata.get()))),
-        key_prefix_(std::move(key_prefix)) {
-          std::cout << "HDF5 DataCache::DataCache()" << std::endl;
+        key_prefix_(std::move(key_prefix)),
+        dataset_(std::move(dataset)) {
         }
 
   absl::Status ValidateMetadataCompatibility(
       const void* existing_metadata_ptr,
       const void* new_metadata_ptr) override {
-    std::cout << "HDF5 DataCache::ValidateMetadataCompatibility()" << std::endl;
     const auto& existing_metadata =
         *static_cast<const HDF5Metadata*>(existing_metadata_ptr);
     const auto& new_metadata =
@@ -234,107 +225,87 @@ class DataCache : public internal_kvs_backed_chunk_driver::DataCache {
   void GetChunkGridBounds(const void* metadata_ptr, MutableBoxView<> bounds,
                           DimensionSet& implicit_lower_bounds,
                           DimensionSet& implicit_upper_bounds) override {
-    // const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
-    // assert(bounds.rank() == static_cast<DimensionIndex>(metadata.shape.size()));
-    // std::fill(bounds.origin().begin(), bounds.origin().end(), Index(0));
-    // std::copy(metadata.shape.begin(), metadata.shape.end(),
-    //           bounds.shape().begin());
-    // implicit_lower_bounds = false;
-    // implicit_upper_bounds = true;
-    std::cout << "*****************HDF5 DataCache::GetChunkGridBounds()" << std::endl;
+    const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
+    assert(bounds.rank() == static_cast<DimensionIndex>(metadata.shape.size()));
+    std::fill(bounds.origin().begin(), bounds.origin().end(), Index(0));
+    std::copy(metadata.shape.begin(), metadata.shape.end(),
+              bounds.shape().begin());
+    implicit_lower_bounds = false;
+    implicit_upper_bounds = true;
   }
 
   Result<std::shared_ptr<const void>> GetResizedMetadata(
       const void* existing_metadata, span<const Index> new_inclusive_min,
       span<const Index> new_exclusive_max) override {
-    std::cout << "HDF5 DataCache::GetResizedMetadata()" << std::endl;
-    auto new_metadata = std::make_shared<HDF5Metadata>(
-        *static_cast<const HDF5Metadata*>(existing_metadata));
-    // const DimensionIndex rank = new_metadata->shape.size();
-    // assert(rank == new_inclusive_min.size());
-    // assert(rank == new_exclusive_max.size());
-    // for (DimensionIndex i = 0; i < rank; ++i) {
-    //   assert(ExplicitIndexOr(new_inclusive_min[i], 0) == 0);
-    //   const Index new_size = new_exclusive_max[i];
-    //   if (new_size == kImplicit) continue;
-    //   new_metadata->shape[i] = new_size;
-    // }
-    return new_metadata;
+    return absl::UnimplementedError(
+        "Resizing HDF5 datasets is not supported");
   }
 
   static internal::ChunkGridSpecification GetChunkGridSpecification(
       const HDF5Metadata& metadata) {
-    std::cout << "*****************HDF5 DataCache::GetChunkGridSpecification()" << std::endl;
-    std::cout << "HDF5 DataCache::GetChunkGridSpecification() metadata:\n"
-    << metadata.ToJson().value() << metadata.rank << std::endl;
-    // auto fill_value = BroadcastArray(AllocateArray(
-    //                                      /*shape=*/span<const Index>{}, c_order,
-    //                                      value_init, metadata.dtype),
-    //                                  BoxView<>(metadata.rank))
-    //                       .value();
+    // Chunks that have not been allocated are read as zero, which is the
+    // default fill value of HDF5 datasets.
+    auto fill_value = BroadcastArray(AllocateArray(
+                                         /*shape=*/span<const Index>{}, c_order,
+                                         value_init, metadata.dtype),
+                                     BoxView<>(metadata.rank))
+                          .value();
     internal::ChunkGridSpecification::ComponentList components;
-    // components.emplace_back(
-    //     internal::AsyncWriteArray::Spec{
-    //         std::move(fill_value),
-    //         // Since all dimensions are resizable, just specify
-    //         // unbounded `component_bounds`.
-    //         Box<>(metadata.rank), fortran_order},
-    //     metadata.chunk_shape);
+    components.emplace_back(
+        internal::AsyncWriteArray::Spec{
+            std::move(fill_value),
+            // Since all dimensions are resizable, just specify
+            // unbounded `component_bounds`.
+            Box<>(metadata.rank), c_order},
+        metadata.chunk_shape);
     return internal::ChunkGridSpecification(std::move(components));
   }
 
   const HDF5Metadata& metadata() {
-    std::cout << "*****************HDF5 DataCache::metadata()" << std::endl;
     return *static_cast<const HDF5Metadata*>(initial_metadata().get());
   }
 
   Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
       span<const Index> chunk_indices, absl::Cord data) override {
-    std::cout << "*****************HDF5 DataCache::DecodeChunk()" << std::endl;
-    // TENSORSTORE_ASSIGN_OR_RETURN(
-    //     auto array, internal_hdf5::DecodeChunk(metadata(), std::move(data)));
-    // absl::InlinedVector<SharedArray<const void>, 1> components;
-    // components.emplace_back(std::move(array));
-    // return components;
-    // return Base::DecodeChunk(chunk_indices, data);
-    return absl::InlinedVector<SharedArray<const void>, 1>();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto array, internal_hdf5::DecodeChunk(metadata(), std::move(data)));
+    absl::InlinedVector<SharedArray<const void>, 1> components;
+    components.emplace_back(std::move(array));
+    return components;
   }
 
   Result<absl::Cord> EncodeChunk(
       span<const Index> chunk_indices,
       span<const SharedArray<const void>> component_arrays) override {
-    // assert(component_arrays.size() == 1);
-    // return internal_hdf5::EncodeChunk(metadata(), component_arrays[0]);
-    std::cout << "*****************HDF5 DataCache::EncodeChunk()" << std::endl;
-    // return Base::EncodeChunk(chunk_indices, component_arrays);
-    return absl::Cord();
+    assert(component_arrays.size() == 1);
+    const auto& metadata = this->metadata();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto encoded,
+        internal_hdf5::EncodeChunk(metadata, component_arrays[0]));
+    // The filter pipeline is applied here, concurrently for each chunk, such
+    // that committing to the chunk store only places the stored bytes.
+    return internal_hdf5::EncodeFilteredChunk(
+        std::move(encoded), metadata.filters, metadata.dtype.size());
   }
 
   std::string GetChunkStorageKey(span<const Index> cell_indices) override {
-    // // Use "0" for rank 0 as a special case.
-    // std::string key = tensorstore::StrCat(
-    //     key_prefix_, cell_indices.empty() ? 0 : cell_indices[0]);
-    // for (DimensionIndex i = 1; i < cell_indices.size(); ++i) {
-    //   tensorstore::StrAppend(&key, "/", cell_indices[i]);
-    // }
-    // return key;
-    std::cout << "*****************HDF5 DataCache::GetChunkStorageKey()" << std::endl;
-    return "xxxxx";
+    // Chunks are stored within the HDF5 file, and are addressed by grid cell
+    // indices in the chunk key-value store.
+    return ChunkIndicesToKey(cell_indices);
   }
 
   Result<IndexTransform<>> GetExternalToInternalTransform(
       const void* metadata_ptr, size_t component_index) override {
-    std::cout << "*****************HDF5 DataCache::GetExternalToInternalTransform()" << std::endl;
     return Base::GetExternalToInternalTransform(metadata_ptr, component_index);
   }
 
   absl::Status GetBoundSpecData(KvsDriverSpec& spec_base,
                                 const void* metadata_ptr,
                                 size_t component_index) override {
-    std::cout << "*****************HDF5 DataCache::GetBoundSpecData()" << std::endl;
     assert(component_index == 0);
     auto& spec = static_cast<HDF5DriverSpec&>(spec_base);
     const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
+    spec.dataset = dataset_;
     auto& constraints = spec.metadata_constraints;
     constraints.shape = metadata.shape;
     constraints.dtype = metadata.dtype;
@@ -345,18 +316,18 @@ class DataCache : public internal_kvs_backed_chunk_driver::DataCache {
 
   Result<ChunkLayout> GetChunkLayoutFromMetadata(
       const void* metadata_ptr, size_t component_index) override {
-    std::cout << "*****************HDF5 DataCache::GetChunkLayoutFromMetadata()" << std::endl;
     const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
     ChunkLayout chunk_layout;
-    // TENSORSTORE_RETURN_IF_ERROR(SetChunkLayoutFromMetadata(
-    //     metadata.rank, metadata.chunk_shape, chunk_layout));
-    // TENSORSTORE_RETURN_IF_ERROR(chunk_layout.Finalize());
+    TENSORSTORE_RETURN_IF_ERROR(SetChunkLayoutFromMetadata(
+        metadata.rank, metadata.chunk_shape, chunk_layout));
+    TENSORSTORE_RETURN_IF_ERROR(chunk_layout.Finalize());
     return chunk_layout;
   }
 
   std::string GetBaseKvstorePath() override { return key_prefix_; }
 
   std::string key_prefix_;
+  std::string dataset_;
 };
 
 
@@ -371,7 +342,6 @@ class HDF5Driver : public HDF5DriverBase {
  public:
   using Base::Base;
   const HDF5Metadata& metadata() const {
-    std::cout << "*****HDF5Driver::metadata()" << std::endl;
     return *static_cast<const HDF5Metadata*>(cache()->initial_metadata().get());
   }
 
@@ -379,90 +349,174 @@ class HDF5Driver : public HDF5DriverBase {
       GetStorageStatisticsRequest request) override;
 
   Result<CodecSpec> GetCodec() override {
-    std::cout << "*******HDF5Driver::GetCodec()" << std::endl;
     return GetCodecFromMetadata(metadata());
   }
 
   void Read(ReadRequest request, 
           AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>> 
           receiver) override {
-    // return cache()->zarr_chunk_cache().Read(
-    //     {std::move(request), GetCurrentDataStalenessBound(),
-    //      this->fill_value_mode_.fill_missing_data_reads},
-    //     std::move(receiver));
-    std::cout << "****************HDF5Driver::Read" << std::endl;
-    return;
+    cache()->Read({std::move(request), component_index(),
+                   data_staleness_bound().time, fill_missing_data_reads()},
+                  std::move(receiver));
   }
 
   void Write(
       WriteRequest request,
       AnyFlowReceiver<absl::Status, internal::WriteChunk, IndexTransform<>>
           receiver) override {
-    // return cache()->zarr_chunk_cache().Write(
-    //     {std::move(request),
-    //      this->fill_value_mode_.store_data_equal_to_fill_value},
-    //     std::move(receiver));
-    std::cout << "****************HDF5Driver::Write" << std::endl;
-    return;
-  }
-
-  // absl::Time GetCurrentDataStalenessBound() {
-  //   absl::Time bound = this->data_staleness_bound().time;
-  //   if (bound != absl::InfinitePast()) {
-  //     bound = std::min(bound, absl::Now());
-  //   }
-  //   return bound;
-  // }
+    cache()->Write(
+        {std::move(request), component_index(),
+         store_data_equal_to_fill_value()},
+        std::move(receiver));
+  }
 
   class OpenState;
 };
 
-Future<ArrayStorageStatistics> HDF5Driver::GetStorageStatistics(
-    GetStorageStatisticsRequest request) {
-  std::cout << "****************HDF5Driver::GetStorageStatistics" << std::endl;
+/// Receives the chunks listed from the chunk key-value store, and counts those
+/// within the grid cell ranges covered by the request.
+struct StorageStatisticsListReceiver {
+  internal::IntrusivePtr<internal::GetStorageStatisticsAsyncOperationState>
+      state;
+  std::vector<Box<>> cell_ranges;
+  int64_t total_chunks = 0;
+  int64_t chunks_seen = 0;
+  FutureCallbackRegistration cancel_registration;
+
+  template <typename Cancel>
+  void set_starting(Cancel cancel) {
+    cancel_registration =
+        state->promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+
+  void set_stopping() { cancel_registration.Unregister(); }
+
+  void set_done() {
+    if (chunks_seen != total_chunks) state->ChunkMissing();
+  }
+
+  void set_value(kvstore::ListEntry entry) {
+    Index cell_indices[kMaxRank];
+    span<Index> cell_indices_span(&cell_indices[0],
+                                  cell_ranges.front().rank());
+    if (!KeyToChunkIndices(entry.key, cell_indices_span)) return;
+    const span<const Index> cell(cell_indices_span);
+    if (std::none_of(
+            cell_ranges.begin(), cell_ranges.end(),
+            [&](const Box<>& range) { return Contains(range, cell); })) {
+      return;
+    }
+    ++chunks_seen;
+    state->IncrementChunksPresent();
+  }
+
+  void set_error(absl::Status error) { state->SetError(std::move(error)); }
+};
+
+/// Computes the storage statistics of the region of the dataset specified by
+/// `transform`.
+///
+/// Rather than probing each chunk, the allocated chunks are listed from
+/// `chunk_kvstore`, which requires a single scan of the chunk index, and
+/// intersected with the ranges of grid cells covered by `transform`.
+/// Uncommitted writes within a transaction are not reflected.
+Future<ArrayStorageStatistics> GetStorageStatisticsFromChunkIndex(
+    kvstore::DriverPtr chunk_kvstore, IndexTransformView<> transform,
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> chunk_shape, span<const Index> shape,
+    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options) {
+  const DimensionIndex rank = grid_output_dimensions.size();
+  assert(rank == chunk_shape.size());
+  assert(rank == shape.size());
   Future<ArrayStorageStatistics> future;
   // Note: `future` is an output parameter.
   auto state = internal::MakeIntrusivePtr<
-      internal::GetStorageStatisticsAsyncOperationState>(future,
-                                                         request.options);
-  // auto* state_ptr = state.get();
-  // auto* cache = this->cache();
-  // auto transaction = request.transaction;
-  // LinkValue(
-  //     WithExecutor(cache->executor(),
-  //                  [state = std::move(state),
-  //                   cache = internal::CachePtr<DataCacheBase>(cache),
-  //                   transform = std::move(request.transform),
-  //                   transaction = std::move(request.transaction),
-  //                   staleness_bound = this->GetCurrentDataStalenessBound()](
-  //                      Promise<ArrayStorageStatistics> promise,
-  //                      ReadyFuture<MetadataCache::MetadataPtr> future) mutable {
-  //                    auto* metadata =
-  //                        static_cast<const HDF5Metadata*>(future.value().get());
-  //                    cache->zarr_chunk_cache().GetStorageStatistics(
-  //                        std::move(state),
-  //                        {std::move(transaction), metadata->shape,
-  //                         std::move(transform), staleness_bound});
-  //                  }),
-  //     state_ptr->promise,
-  //     ResolveMetadata(std::move(transaction), metadata_staleness_bound_.time));
+      internal::GetStorageStatisticsAsyncOperationState>(future, options);
+  Box<dynamic_rank(kMaxRank)> grid_bounds(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    grid_bounds[i] = IndexInterval::UncheckedSized(
+        0, CeilOfRatio(shape[i], chunk_shape[i]));
+  }
+  StorageStatisticsListReceiver receiver;
+  auto status = internal::GetGridCellRanges(
+      grid_output_dimensions, grid_bounds,
+      internal_grid_partition::RegularGridRef{chunk_shape}, transform,
+      [&](BoxView<> bounds) -> absl::Status {
+        const Index num_cells = bounds.num_elements();
+        if (num_cells == std::numeric_limits<Index>::max() ||
+            internal::AddOverflow(receiver.total_chunks, num_cells,
+                                  &receiver.total_chunks)) {
+          return absl::OutOfRangeError(
+              "Integer overflow computing number of chunks");
+        }
+        receiver.cell_ranges.emplace_back(bounds);
+        return absl::OkStatus();
+      });
+  if (!status.ok()) {
+    state->SetError(std::move(status));
+    return future;
+  }
+  state->total_chunks += receiver.total_chunks;
+  if (receiver.total_chunks == 0) return future;
+  receiver.state = state;
+  kvstore::ListOptions list_options;
+  list_options.staleness_bound = staleness_bound;
+  kvstore::List(KvStore(std::move(chunk_kvstore)), std::move(list_options),
+                std::move(receiver));
   return future;
 }
 
-//////////////////////////////////////////////////////////////////////////////
+Future<ArrayStorageStatistics> HDF5Driver::GetStorageStatistics(
+    GetStorageStatisticsRequest request) {
+  auto* cache = static_cast<DataCache*>(this->cache());
+  auto [promise, future] = PromiseFuturePair<ArrayStorageStatistics>::Make();
+  auto metadata_future =
+      ResolveMetadata(request.transaction, metadata_staleness_bound_.time);
+  LinkValue(
+      WithExecutor(
+          cache->executor(),
+          [cache = internal::CachePtr<DataCache>(cache),
+           request = std::move(request),
+           component_index = this->component_index(),
+           staleness_bound = this->data_staleness_bound().time](
+              Promise<ArrayStorageStatistics> promise,
+              ReadyFuture<MetadataCache::MetadataPtr> future) mutable {
+            auto* metadata =
+                static_cast<const HDF5Metadata*>(future.value().get());
+            auto& grid = cache->grid();
+            auto& component = grid.components[component_index];
+            LinkResult(std::move(promise),
+                       GetStorageStatisticsFromChunkIndex(
+                           kvstore::DriverPtr(cache->kvstore_driver()),
+                           request.transform,
+                           /*grid_output_dimensions=*/
+                           component.chunked_to_cell_dimensions,
+                           /*chunk_shape=*/grid.chunk_shape,
+                           /*shape=*/metadata->shape, staleness_bound,
+                           request.options));
+          }),
+      std::move(promise), std::move(metadata_future));
+  return std::move(future);
+}
+
 class HDF5Driver::OpenState : public HDF5Driver::OpenStateBase {
  public:
   using HDF5Driver::OpenStateBase::OpenStateBase;
 
   std::string GetPrefixForDeleteExisting() override {
-    std::cout << "****************HDF5Driver::OpenState::GetPrefixForDeleteExisting" << std::endl;
     return spec().store.path;
   }
 
-  std::string GetMetadataCacheEntryKey() override { 
-    std::cout << "****************HDF5Driver::OpenState::GetMetadataCacheEntryKey\n\t" 
-      << spec().store.path << std::endl;
-    return spec().store.path; 
+  std::string GetMetadataCacheEntryKey() override {
+    return EncodeObjectHeaderKey(spec().store.path, spec().dataset);
+  }
+
+  Result<kvstore::DriverPtr> GetMetadataKeyValueStore(
+      kvstore::DriverPtr base_kv_store) override {
+    // Datasets of the same file share the file-level metadata cache within
+    // the metadata cache pool.
+    return GetObjectHeaderKeyValueStore(std::move(base_kv_store),
+                                        *metadata_cache_pool());
   }
 
   // The metadata cache isn't parameterized by anything other than the
@@ -470,22 +524,20 @@ class HDF5Driver::OpenState : public HDF5Driver::OpenStateBase {
   // to encode the state.
   std::unique_ptr<internal_kvs_backed_chunk_driver::MetadataCache>
   GetMetadataCache(MetadataCache::Initializer initializer) override {
-    std::cout << "****************HDF5Driver::OpenState::GetMetadataCache" << std::endl;
     return std::make_unique<MetadataCache>(std::move(initializer));
   }
 
   std::string GetDataCacheKey(const void* metadata) override {
-    std::cout << "****************HDF5Driver::OpenState::GetDataCacheKey" << std::endl;
-    std::string result = "teststtststs-DataCacheKey";
-    // internal::EncodeCacheKey(
-    //     &result, spec().store.path,
-    //     static_cast<const HDF5Metadata*>(metadata)->GetCompatibilityKey());
+    std::string result;
+    const auto& hdf5_metadata = *static_cast<const HDF5Metadata*>(metadata);
+    internal::EncodeCacheKey(&result, spec().store.path, spec().dataset,
+                             hdf5_metadata.GetCompatibilityKey(),
+                             hdf5_metadata.layout.address);
     return result;
   }
 
   Result<std::shared_ptr<const void>> Create(const void* existing_metadata,
                                              CreateOptions options) override {
-    std::cout << "****************HDF5Driver::OpenState::Create" << std::endl;
     if (existing_metadata) {
       return absl::AlreadyExistsError("The metadata already exists");
     }
@@ -497,28 +549,43 @@ class HDF5Driver::OpenState : public HDF5Driver::OpenStateBase {
     return metadata;
   }
 
+  Result<kvstore::DriverPtr> GetDataKeyValueStore(
+      kvstore::DriverPtr base_kv_store, const void* metadata_ptr) override {
+    const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
+    ChunkStoreParameters params;
+    params.base_kvstore = std::move(base_kv_store);
+    params.base_kvstore_path = spec().store.path;
+    params.executor = executor();
+    params.cache_pool = *cache_pool();
+    params.index_params.format = metadata.format;
+    params.index_params.layout = metadata.layout;
+    params.index_params.shape = metadata.shape;
+    params.index_params.max_shape = metadata.max_shape;
+    params.index_params.chunk_shape = metadata.chunk_shape;
+    params.index_params.element_size = metadata.dtype.size();
+    params.filters = metadata.filters;
+    return GetChunkKeyValueStore(std::move(params));
+  }
+
   std::unique_ptr<internal_kvs_backed_chunk_driver::DataCacheBase> GetDataCache(
       DataCache::Initializer&& initializer) override {
-    std::cout << "****************HDF5Driver::OpenState::GetDataCache" << std::endl;
     return std::make_unique<DataCache>(std::move(initializer),
-                                       spec().store.path);
+                                       spec().store.path, spec().dataset);
   }
 
   Result<size_t> GetComponentIndex(const void* metadata_ptr,
                                    OpenMode open_mode) override {
-    std::cout << "****************HDF5Driver::OpenState::GetComponentIndex" << std::endl;
-    // const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
-    // TENSORSTORE_RETURN_IF_ERROR(
-    //     ValidateMetadata(metadata, spec().metadata_constraints));
-    // TENSORSTORE_RETURN_IF_ERROR(
-    //     ValidateMetadataSchema(metadata, spec().schema));
+    const auto& metadata = *static_cast<const HDF5Metadata*>(metadata_ptr);
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidateMetadata(metadata, spec().metadata_constraints));
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidateMetadataSchema(metadata, spec().schema));
     return 0;
   }
 };
 
 Future<internal::Driver::Handle> HDF5DriverSpec::Open(
     internal::DriverOpenRequest request) const {
-      std::cout << "*********HDF5DriverSpec::Open, request = " << request.read_write_mode << std::endl;
   return HDF5Driver::Open(this, std::move(request));
 }
 
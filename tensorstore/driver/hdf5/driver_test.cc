@@ -0,0 +1,174 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// End-to-end tests of the hdf5 driver.
+///
+/// Reads the datasets of `testdata/datasets.h5`, which is generated by
+/// `testdata/generate.py` using h5py.
+
+#include <stdint.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/path.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+ABSL_FLAG(std::string, tensorstore_test_data_dir, ".",
+          "Path to directory containing HDF5 test data.");
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
+
+std::string GetTestDataPath() {
+  return tensorstore::internal::JoinPath(
+      absl::GetFlag(FLAGS_tensorstore_test_data_dir), "datasets.h5");
+}
+
+::nlohmann::json GetSpec(const std::string& path, const std::string& dataset) {
+  return {{"driver", "hdf5"},
+          {"kvstore", {{"driver", "file"}, {"path", path}}},
+          {"dataset", dataset}};
+}
+
+/// Returns the array written by `generate.py`.
+tensorstore::SharedArray<uint16_t> GetExpectedArray() {
+  auto expected = tensorstore::AllocateArray<uint16_t>({5, 4});
+  for (Index i = 0; i < expected.num_elements(); ++i) {
+    expected.data()[i] = static_cast<uint16_t>(i);
+  }
+  return expected;
+}
+
+/// Copies the test data file to `dir` and returns the path of the copy.
+std::string CopyTestDataFile(const std::string& dir) {
+  std::ifstream in(GetTestDataPath(), std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  auto store =
+      tensorstore::kvstore::Open({{"driver", "file"}, {"path", dir + "/"}})
+          .value();
+  TENSORSTORE_CHECK_OK(tensorstore::kvstore::Write(store, "datasets.h5",
+                                                   absl::Cord(contents.str()))
+                           .result());
+  return tensorstore::internal::JoinPath(dir, "datasets.h5");
+}
+
+class ReadTest : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(ReadTest, Read) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open<uint16_t>(GetSpec(GetTestDataPath(), GetParam()),
+                                  tensorstore::Context::Default(),
+                                  tensorstore::OpenMode::open,
+                                  tensorstore::ReadWriteMode::read)
+          .result());
+  EXPECT_EQ(GetExpectedArray(), tensorstore::Read(store).value());
+  EXPECT_EQ(tensorstore::MakeArray<uint16_t>({{9, 10}, {13, 14}}),
+            tensorstore::Read(store | tensorstore::Dims(0, 1).HalfOpenInterval(
+                                          {2, 1}, {4, 3}))
+                .value());
+}
+
+INSTANTIATE_TEST_SUITE_P(Datasets, ReadTest,
+                         ::testing::Values("/chunked", "/gzip", "/contiguous",
+                                           "/compact", "/group/nested"));
+
+TEST(DriverTest, MissingDataset) {
+  EXPECT_THAT(tensorstore::Open(GetSpec(GetTestDataPath(), "/missing"),
+                                tensorstore::OpenMode::open,
+                                tensorstore::ReadWriteMode::read)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kNotFound));
+}
+
+TEST(DriverTest, ResizeUnimplemented) {
+  ScopedTemporaryDirectory tempdir;
+  const std::string path = CopyTestDataFile(tempdir.path());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(GetSpec(path, "/chunked"),
+                                    tensorstore::OpenMode::open,
+                                    tensorstore::ReadWriteMode::read_write)
+                      .result());
+  EXPECT_THAT(tensorstore::Resize(store, {{0, 0}}, {{5, 2}}).result(),
+              MatchesStatus(absl::StatusCode::kUnimplemented));
+}
+
+TEST(DriverTest, WriteRoundTrip) {
+  ScopedTemporaryDirectory tempdir;
+  const std::string path = CopyTestDataFile(tempdir.path());
+  auto expected = GetExpectedArray();
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store, tensorstore::Open<uint16_t>(
+                        GetSpec(path, "/chunked"),
+                        tensorstore::Context::Default(),
+                        tensorstore::OpenMode::open,
+                        tensorstore::ReadWriteMode::read_write)
+                        .result());
+    // Partially overwrites each of the four chunks at the center.
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::Write(
+            tensorstore::MakeArray<uint16_t>({{100, 101}, {102, 103}}),
+            store | tensorstore::Dims(0, 1).HalfOpenInterval({2, 1}, {4, 3}))
+            .commit_future.result());
+    expected(2, 1) = 100;
+    expected(2, 2) = 101;
+    expected(3, 1) = 102;
+    expected(3, 2) = 103;
+  }
+
+  // Reopens with a new context to bypass the cache.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open<uint16_t>(GetSpec(path, "/chunked"),
+                                  tensorstore::Context::Default(),
+                                  tensorstore::OpenMode::open,
+                                  tensorstore::ReadWriteMode::read)
+          .result());
+  EXPECT_EQ(expected, tensorstore::Read(store).value());
+
+  // The other datasets of the file are unaffected.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto other,
+      tensorstore::Open<uint16_t>(GetSpec(path, "/gzip"),
+                                  tensorstore::Context::Default(),
+                                  tensorstore::OpenMode::open,
+                                  tensorstore::ReadWriteMode::read)
+          .result());
+  EXPECT_EQ(GetExpectedArray(), tensorstore::Read(other).value());
+}
+
+}  // namespace
@@ -0,0 +1,180 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/file_metadata_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/internal/endian.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+/// Maximum number of memoized object addresses per file.  When exceeded, all
+/// memoized addresses are discarded.
+constexpr size_t kMaxMemoizedAddresses = size_t{1} << 16;
+
+/// Byte range of the file, as encoded by `FileMetadataCache::EncodeBlockKey`.
+struct BlockKey {
+  uint64_t offset;
+  uint64_t size;
+};
+
+bool DecodeBlockKey(std::string_view key, BlockKey& block) {
+  if (key.size() != 16) return false;
+  block.offset = absl::big_endian::Load64(key.data());
+  block.size = absl::big_endian::Load64(key.data() + 8);
+  return true;
+}
+
+/// Key-value store adapter used as the backing store of `FileMetadataCache`,
+/// which maps each block key to a byte range read of the file.
+class FileBlockKeyValueStore : public kvstore::Driver {
+ public:
+  explicit FileBlockKeyValueStore(kvstore::DriverPtr base, std::string path)
+      : base_(std::move(base)), path_(std::move(path)) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override {
+    BlockKey block;
+    ABSL_CHECK(DecodeBlockKey(key, block));
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto byte_range,
+        options.byte_range.Validate(static_cast<int64_t>(block.size)));
+    const int64_t offset = static_cast<int64_t>(block.offset);
+    options.byte_range.inclusive_min = byte_range.inclusive_min + offset;
+    options.byte_range.exclusive_max = byte_range.exclusive_max + offset;
+    return base_->Read(path_, std::move(options));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    BlockKey block;
+    ABSL_CHECK(DecodeBlockKey(key, block));
+    const int64_t offset = static_cast<int64_t>(block.offset);
+    return tensorstore::StrCat(
+        "Byte range ",
+        ByteRange{offset, offset + static_cast<int64_t>(block.size)}, " of ",
+        base_->DescribeKey(path_));
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    garbage_collection::GarbageCollectionVisit(visitor, *base_);
+  }
+
+ private:
+  kvstore::DriverPtr base_;
+  std::string path_;
+};
+
+}  // namespace
+
+FileMetadataCache::FileMetadataCache(kvstore::DriverPtr base_kvstore,
+                                     std::string base_kvstore_path)
+    : Base(kvstore::DriverPtr(
+          new FileBlockKeyValueStore(base_kvstore, base_kvstore_path))),
+      base_kvstore_(std::move(base_kvstore)),
+      base_kvstore_path_(std::move(base_kvstore_path)) {}
+
+size_t FileMetadataCache::Entry::ComputeReadDataSizeInBytes(
+    const void* read_data) {
+  return static_cast<const ReadData*>(read_data)->size();
+}
+
+void FileMetadataCache::Entry::DoDecode(std::optional<absl::Cord> value,
+                                        DecodeReceiver receiver) {
+  if (!value) {
+    // The file does not exist.
+    execution::set_value(receiver, nullptr);
+    return;
+  }
+  BlockKey block;
+  ABSL_CHECK(DecodeBlockKey(this->key(), block));
+  if (value->size() != block.size) {
+    execution::set_error(
+        receiver, absl::DataLossError(tensorstore::StrCat(
+                      "Expected ", block.size, " bytes at offset ",
+                      block.offset, " but received ", value->size())));
+    return;
+  }
+  value->Flatten();
+  execution::set_value(receiver,
+                       std::make_shared<absl::Cord>(*std::move(value)));
+}
+
+std::string FileMetadataCache::EncodeBlockKey(uint64_t offset, uint64_t size) {
+  std::string key(16, '\0');
+  absl::big_endian::Store64(key.data(), offset);
+  absl::big_endian::Store64(key.data() + 8, size);
+  return key;
+}
+
+std::optional<uint64_t> FileMetadataCache::GetMemoizedAddress(
+    const StorageGeneration& generation, std::string_view path) {
+  absl::MutexLock lock(&memo_mutex_);
+  if (generation != memo_generation_) return std::nullopt;
+  auto it = memo_.find(path);
+  if (it == memo_.end()) return std::nullopt;
+  return it->second;
+}
+
+void FileMetadataCache::MemoizeAddress(const StorageGeneration& generation,
+                                       std::string_view path,
+                                       uint64_t address) {
+  absl::MutexLock lock(&memo_mutex_);
+  if (generation != memo_generation_ ||
+      memo_.size() >= kMaxMemoizedAddresses) {
+    memo_.clear();
+    memo_generation_ = generation;
+  }
+  memo_[std::string(path)] = address;
+}
+
+internal::CachePtr<FileMetadataCache> GetFileMetadataCache(
+    internal::CachePool* pool, kvstore::DriverPtr base_kvstore,
+    std::string base_kvstore_path) {
+  std::string cache_identifier;
+  internal::EncodeCacheKey(&cache_identifier, base_kvstore, base_kvstore_path);
+  return internal::GetCache<FileMetadataCache>(pool, cache_identifier, [&] {
+    return std::make_unique<FileMetadataCache>(std::move(base_kvstore),
+                                               std::move(base_kvstore_path));
+  });
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,129 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_FILE_METADATA_CACHE_H_
+#define TENSORSTORE_DRIVER_HDF5_FILE_METADATA_CACHE_H_
+
+/// \file
+///
+/// Cache of the file-level metadata structures of an HDF5 file.
+///
+/// Resolving a dataset path reads the superblock, the object headers of the
+/// groups along the path, and the local heaps and B-tree nodes of
+/// "old-style" groups.  These structures are shared by all datasets of the
+/// file, and are retained in a single `FileMetadataCache` per file within the
+/// cache pool, such that opening many datasets of the same file reads and
+/// decodes them only once.
+///
+/// Since the generation of the file applies to all of its structures, a
+/// cached structure at the generation of a freshly read superblock is valid
+/// regardless of its age.  See `object_header_store.h` for how resolution
+/// uses the cache.
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Cache of the metadata structures of a single HDF5 file.
+///
+/// Each entry corresponds to a byte range of the file, identified by its
+/// absolute offset and size.
+class FileMetadataCache
+    : public internal::KvsBackedCache<FileMetadataCache, internal::AsyncCache> {
+  using Base =
+      internal::KvsBackedCache<FileMetadataCache, internal::AsyncCache>;
+
+ public:
+  /// Contents of the byte range, flattened.
+  using ReadData = absl::Cord;
+
+  explicit FileMetadataCache(kvstore::DriverPtr base_kvstore,
+                             std::string base_kvstore_path);
+
+  class Entry : public Base::Entry {
+   public:
+    using OwningCache = FileMetadataCache;
+
+    size_t ComputeReadDataSizeInBytes(const void* read_data) override;
+
+    void DoDecode(std::optional<absl::Cord> value,
+                  DecodeReceiver receiver) override;
+  };
+
+  using typename Base::TransactionNode;
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    return new TransactionNode(static_cast<Entry&>(entry));
+  }
+
+  /// Returns the cache entry key of the `size` bytes at absolute file offset
+  /// `offset`.
+  static std::string EncodeBlockKey(uint64_t offset, uint64_t size);
+
+  /// Returns the memoized object header address of the object at `path`
+  /// (relative to the root group, without a leading `/`), if it was
+  /// previously resolved at `generation`.
+  std::optional<uint64_t> GetMemoizedAddress(
+      const StorageGeneration& generation, std::string_view path);
+
+  /// Memoizes the object header address of the object at `path`, as resolved
+  /// at `generation`.  Addresses memoized for any other generation are
+  /// discarded.
+  void MemoizeAddress(const StorageGeneration& generation,
+                      std::string_view path, uint64_t address);
+
+  kvstore::Driver* base_kvstore_driver() const { return base_kvstore_.get(); }
+  const std::string& base_kvstore_path() const { return base_kvstore_path_; }
+
+ private:
+  kvstore::DriverPtr base_kvstore_;
+  std::string base_kvstore_path_;
+
+  absl::Mutex memo_mutex_;
+  StorageGeneration memo_generation_ ABSL_GUARDED_BY(memo_mutex_);
+  absl::flat_hash_map<std::string, uint64_t> memo_
+      ABSL_GUARDED_BY(memo_mutex_);
+};
+
+/// Returns the metadata cache of the file at `base_kvstore_path` in
+/// `base_kvstore`.
+///
+/// All datasets of the same file share the same cache.  Cached structures are
+/// retained subject to the `total_bytes_limit` of `pool`.
+internal::CachePtr<FileMetadataCache> GetFileMetadataCache(
+    internal::CachePool* pool, kvstore::DriverPtr base_kvstore,
+    std::string base_kvstore_path);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_FILE_METADATA_CACHE_H_
@@ -0,0 +1,194 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/filter_pipeline.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+/// Returns the JSON representation of the compressor that implements
+/// `filter`, or `nullptr` if the filter does not modify the data.
+Result<::nlohmann::json> GetFilterJson(const FilterDescription& filter) {
+  const auto& cd = filter.client_data;
+  const auto param = [&](size_t i, uint32_t default_value) {
+    return i < cd.size() ? cd[i] : default_value;
+  };
+  const auto require_params = [&](size_t n) -> absl::Status {
+    if (cd.size() >= n) return absl::OkStatus();
+    return absl::DataLossError(
+        tensorstore::StrCat("Expected at least ", n, " client data values"));
+  };
+  switch (filter.id) {
+    case kDeflateFilterId:
+      return ::nlohmann::json{{"id", "deflate"}, {"level", param(0, 6)}};
+    case kShuffleFilterId:
+      return ::nlohmann::json{{"id", "shuffle"}};
+    case kFletcher32FilterId:
+      return ::nlohmann::json{{"id", "fletcher32"}};
+    case kNbitFilterId: {
+      TENSORSTORE_RETURN_IF_ERROR(require_params(8));
+      // cd[1]: data does not need to be compressed
+      if (cd[1] != 0) return nullptr;
+      // cd[3]: datatype class, 1 for atomic datatypes
+      if (cd[3] != 1) {
+        return absl::UnimplementedError(
+            "Only atomic datatypes are supported");
+      }
+      return ::nlohmann::json{{"id", "nbit"},
+                              {"num_elements", cd[2]},
+                              {"byte_order", cd[5] == 0 ? "little" : "big"},
+                              {"precision", cd[6]},
+                              {"offset", cd[7]}};
+    }
+    case kScaleOffsetFilterId: {
+      TENSORSTORE_RETURN_IF_ERROR(require_params(8));
+      // cd[0]: scale type, 2 for integers; cd[3]: datatype class, 0 for
+      // integers.
+      if (cd[0] != 2 || cd[3] != 0) {
+        return absl::UnimplementedError(
+            "Only integer datatypes are supported");
+      }
+      ::nlohmann::json j{{"id", "scaleoffset"},
+                         {"num_elements", cd[2]},
+                         {"signed", cd[5] != 0},
+                         {"byte_order", cd[6] == 0 ? "little" : "big"}};
+      // cd[7]: fill value defined; cd[8..]: fill value, little endian.
+      if (cd[7] != 0) {
+        const uint64_t fill = uint64_t{param(8, 0)} |
+                              (uint64_t{param(9, 0)} << 32);
+        j["fill_value"] = static_cast<int64_t>(fill);
+      }
+      return j;
+    }
+    case kBloscFilterId: {
+      // cd[6]: compressor code, as defined by the blosc library.
+      constexpr const char* kBloscCodecNames[] = {"blosclz", "lz4", "lz4hc",
+                                                  "snappy",  "zlib", "zstd"};
+      const uint32_t codec = param(6, 0);
+      if (codec >= std::size(kBloscCodecNames)) {
+        return absl::DataLossError(
+            tensorstore::StrCat("Invalid blosc compressor code ", codec));
+      }
+      return ::nlohmann::json{{"id", "blosc"},
+                              {"cname", kBloscCodecNames[codec]},
+                              {"clevel", param(4, 5)},
+                              {"shuffle", param(5, 1)}};
+    }
+    case kLz4FilterId:
+      return ::nlohmann::json{{"id", "lz4"}, {"block_size", param(0, 0)}};
+    case kZstdFilterId:
+      return ::nlohmann::json{{"id", "zstd"}, {"level", param(0, 3)}};
+    default:
+      break;
+  }
+  return absl::UnimplementedError("Filter is not supported");
+}
+
+}  // namespace
+
+Result<Compressor> GetFilterCompressor(const FilterDescription& filter) {
+  auto compressor = [&]() -> Result<Compressor> {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto j, GetFilterJson(filter));
+    if (j.is_null()) return Compressor{};
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto result, Compressor::FromJson(std::move(j)),
+        absl::DataLossError(_.message()));
+    return result;
+  }();
+  if (!compressor.ok()) {
+    return tensorstore::MaybeAnnotateStatus(
+        compressor.status(),
+        tensorstore::StrCat("HDF5 filter ", filter.id, " ",
+                            tensorstore::QuoteString(filter.name)));
+  }
+  return compressor;
+}
+
+Result<absl::Cord> DecodeFilteredChunk(absl::Cord encoded,
+                                       span<const Compressor> filters,
+                                       uint32_t filter_mask,
+                                       size_t element_size,
+                                       uint64_t decoded_size) {
+  riegeli::CordReader<> base_reader(&encoded);
+  riegeli::Reader* reader = &base_reader;
+  // Filters are reversed starting from the last filter applied.
+  std::vector<std::unique_ptr<riegeli::Reader>> readers;
+  for (size_t i = filters.size(); i--;) {
+    if (!filters[i] || (i < 32 && (filter_mask >> i) & 1)) continue;
+    readers.push_back(filters[i]->GetReader(*reader, element_size));
+    reader = readers.back().get();
+  }
+  absl::Cord decoded;
+  if (!reader->Read(decoded_size, decoded) || !reader->VerifyEndAndClose()) {
+    // Errors of the underlying codecs are reported as data loss, since the
+    // encoded chunk is held in memory.
+    return absl::DataLossError(tensorstore::StrCat(
+        "Error decoding HDF5 filtered chunk: ",
+        reader->ok() ? tensorstore::StrCat("Expected decoded chunk of size ",
+                                           decoded_size)
+                     : reader->status().message()));
+  }
+  return decoded;
+}
+
+Result<absl::Cord> EncodeFilteredChunk(absl::Cord decoded,
+                                       span<const Compressor> filters,
+                                       size_t element_size) {
+  absl::Cord encoded;
+  riegeli::CordWriter<> base_writer(&encoded);
+  riegeli::Writer* writer = &base_writer;
+  // The first filter receives the decoded data, and therefore is the
+  // outermost writer.
+  std::vector<std::unique_ptr<riegeli::Writer>> writers;
+  for (size_t i = filters.size(); i--;) {
+    if (!filters[i]) continue;
+    writers.push_back(filters[i]->GetWriter(*writer, element_size));
+    writer = writers.back().get();
+  }
+  if (!writer->Write(std::move(decoded))) return writer->status();
+  // Closing each writer flushes its output to the next writer.
+  for (size_t i = writers.size(); i--;) {
+    if (!writers[i]->Close()) return writers[i]->status();
+  }
+  if (!base_writer.Close()) return base_writer.status();
+  return encoded;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
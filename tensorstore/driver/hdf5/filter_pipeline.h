@@ -0,0 +1,87 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_FILTER_PIPELINE_H_
+#define TENSORSTORE_DRIVER_HDF5_FILTER_PIPELINE_H_
+
+/// \file
+///
+/// Maps the filters of an HDF5 filter pipeline message to registered
+/// compressors, and applies them to chunks.
+///
+/// The following filters are supported:
+///
+/// - deflate (1), shuffle (2), fletcher32 (3), nbit (5), and scaleoffset (6)
+///   for integer datatypes;
+///
+/// - the registered blosc (32001), lz4 (32004) and zstd (32015) filters.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Filter identification values.
+constexpr uint16_t kDeflateFilterId = 1;
+constexpr uint16_t kShuffleFilterId = 2;
+constexpr uint16_t kFletcher32FilterId = 3;
+constexpr uint16_t kSzipFilterId = 4;
+constexpr uint16_t kNbitFilterId = 5;
+constexpr uint16_t kScaleOffsetFilterId = 6;
+constexpr uint16_t kBloscFilterId = 32001;
+constexpr uint16_t kLz4FilterId = 32004;
+constexpr uint16_t kZstdFilterId = 32015;
+
+/// Returns the compressor that implements `filter`.
+///
+/// \returns A null `Compressor` if `filter` does not modify the data, e.g. an
+///     nbit filter for which all bits are significant.
+/// \error `absl::StatusCode::kUnimplemented` if `filter` is not supported.
+/// \error `absl::StatusCode::kDataLoss` if the client data of `filter` is
+///     invalid.
+Result<Compressor> GetFilterCompressor(const FilterDescription& filter);
+
+/// Reverses a filter pipeline.
+///
+/// \param encoded The chunk as stored in the file.
+/// \param filters The filters of the pipeline, in the order in which they are
+///     applied when writing.  Null filters are skipped.
+/// \param filter_mask Bit `i` is set if `filters[i]` was not applied to this
+///     chunk.
+/// \param element_size Size in bytes of a single element.
+/// \param decoded_size Expected size of the decoded chunk.
+/// \error `absl::StatusCode::kDataLoss` if `encoded` is invalid, or does not
+///     decode to `decoded_size` bytes.
+Result<absl::Cord> DecodeFilteredChunk(absl::Cord encoded,
+                                       span<const Compressor> filters,
+                                       uint32_t filter_mask,
+                                       size_t element_size,
+                                       uint64_t decoded_size);
+
+/// Applies all of `filters` in order to `decoded`.
+Result<absl::Cord> EncodeFilteredChunk(absl::Cord decoded,
+                                       span<const Compressor> filters,
+                                       size_t element_size);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_FILTER_PIPELINE_H_
@@ -0,0 +1,158 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/filter_pipeline.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesJson;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_hdf5::Compressor;
+using ::tensorstore::internal_hdf5::DecodeFilteredChunk;
+using ::tensorstore::internal_hdf5::EncodeFilteredChunk;
+using ::tensorstore::internal_hdf5::FilterDescription;
+using ::tensorstore::internal_hdf5::GetFilterCompressor;
+
+::nlohmann::json GetFilterJson(uint16_t id,
+                               std::vector<uint32_t> client_data) {
+  FilterDescription filter;
+  filter.id = id;
+  filter.client_data = std::move(client_data);
+  auto compressor = GetFilterCompressor(filter);
+  if (!compressor.ok()) return compressor.status().ToString();
+  return ::nlohmann::json(*compressor);
+}
+
+TEST(GetFilterCompressorTest, Supported) {
+  EXPECT_THAT(GetFilterJson(1, {4}),
+              MatchesJson({{"id", "deflate"}, {"level", 4}}));
+  EXPECT_THAT(GetFilterJson(2, {4}), MatchesJson({{"id", "shuffle"}}));
+  EXPECT_THAT(GetFilterJson(3, {}), MatchesJson({{"id", "fletcher32"}}));
+  EXPECT_THAT(GetFilterJson(5, {8, 0, 100, 1, 4, 1, 20, 3}),
+              MatchesJson({{"id", "nbit"},
+                           {"num_elements", 100},
+                           {"byte_order", "big"},
+                           {"precision", 20},
+                           {"offset", 3}}));
+  EXPECT_THAT(GetFilterJson(6, {2, 0, 100, 0, 2, 1, 0, 1, 0xfffe, 0}),
+              MatchesJson({{"id", "scaleoffset"},
+                           {"num_elements", 100},
+                           {"signed", true},
+                           {"byte_order", "little"},
+                           {"fill_value", 0xfffe}}));
+  EXPECT_THAT(GetFilterJson(32001, {2, 2, 4, 400, 7, 2, 5}),
+              MatchesJson({{"id", "blosc"},
+                           {"cname", "zstd"},
+                           {"clevel", 7},
+                           {"shuffle", 2},
+                           {"blocksize", 0}}));
+  EXPECT_THAT(GetFilterJson(32004, {}),
+              MatchesJson({{"id", "lz4"}, {"block_size", 0}}));
+  EXPECT_THAT(GetFilterJson(32015, {9}),
+              MatchesJson({{"id", "zstd"}, {"level", 9}}));
+}
+
+TEST(GetFilterCompressorTest, NoOp) {
+  FilterDescription filter;
+  filter.id = 5;
+  filter.client_data = {8, 1, 100, 1, 4, 0, 32, 0};
+  auto compressor = GetFilterCompressor(filter);
+  TENSORSTORE_ASSERT_OK(compressor);
+  EXPECT_FALSE(*compressor);
+}
+
+TEST(GetFilterCompressorTest, Unsupported) {
+  FilterDescription filter;
+  filter.id = 4;
+  filter.name = "szip";
+  EXPECT_THAT(GetFilterCompressor(filter),
+              MatchesStatus(absl::StatusCode::kUnimplemented,
+                            "HDF5 filter 4 \"szip\": .*"));
+  // Floating-point scale-offset.
+  filter.id = 6;
+  filter.client_data = {0, 2, 100, 1, 4, 0, 0, 0};
+  EXPECT_THAT(GetFilterCompressor(filter),
+              MatchesStatus(absl::StatusCode::kUnimplemented, ".*integer.*"));
+  filter.id = 1;
+  filter.client_data = {12};
+  EXPECT_THAT(GetFilterCompressor(filter),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*\"level\".*"));
+}
+
+std::vector<Compressor> GetFilters(std::vector<::nlohmann::json> specs) {
+  std::vector<Compressor> filters;
+  for (auto& spec : specs) {
+    filters.push_back(Compressor::FromJson(spec).value());
+  }
+  return filters;
+}
+
+absl::Cord GetTestChunk() {
+  std::string data;
+  for (int i = 0; i < 256; ++i) {
+    data += static_cast<char>(i % 7);
+    data += static_cast<char>(0);
+  }
+  return absl::Cord(data);
+}
+
+TEST(FilterPipelineTest, RoundTrip) {
+  auto filters = GetFilters({{{"id", "shuffle"}},
+                             {{"id", "deflate"}, {"level", 6}},
+                             {{"id", "fletcher32"}}});
+  const auto chunk = GetTestChunk();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeFilteredChunk(chunk, filters, 2));
+  EXPECT_LT(encoded.size(), chunk.size());
+  EXPECT_THAT(DecodeFilteredChunk(encoded, filters, 0, 2, chunk.size()),
+              ::tensorstore::IsOkAndHolds(chunk));
+  EXPECT_THAT(DecodeFilteredChunk(encoded, filters, 0, 2, chunk.size() + 1),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Error decoding HDF5 filtered chunk: .*"));
+}
+
+TEST(FilterPipelineTest, FilterMask) {
+  auto filters = GetFilters({{{"id", "shuffle"}},
+                             {{"id", "zstd"}, {"level", 3}},
+                             {{"id", "fletcher32"}}});
+  // The zstd filter was skipped when writing the chunk.
+  std::vector<Compressor> applied{filters[0], Compressor{}, filters[2]};
+  const auto chunk = GetTestChunk();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeFilteredChunk(chunk, applied, 2));
+  EXPECT_THAT(DecodeFilteredChunk(encoded, filters, 0b010, 2, chunk.size()),
+              ::tensorstore::IsOkAndHolds(chunk));
+  EXPECT_THAT(DecodeFilteredChunk(encoded, filters, 0, 2, chunk.size()),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*"));
+  // With the checksum also skipped, the trailing checksum is unexpected.
+  EXPECT_THAT(DecodeFilteredChunk(encoded, filters, 0b110, 2, chunk.size()),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*"));
+}
+
+}  // namespace
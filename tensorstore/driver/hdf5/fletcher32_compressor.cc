@@ -0,0 +1,139 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "fletcher32" filter (filter id 3).  Linking in this
+/// library automatically registers it.
+///
+/// The filter appends the Fletcher-32 checksum of the chunk, as computed by
+/// `H5_checksum_fletcher32`, as a little-endian `uint32`.  For compatibility
+/// with files written by HDF5 1.6.2 and earlier, a byte-swapped checksum is
+/// also accepted when decoding.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "riegeli/endian/endian_writing.h"
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+constexpr size_t kChecksumSize = 4;
+
+/// Computes the Fletcher-32 checksum over big-endian 16-bit words, with an
+/// odd trailing byte treated as the high byte of a final word.
+///
+/// The sums are reduced every 360 words, which is the maximum number of words
+/// for which they cannot overflow.
+uint32_t ComputeFletcher32(const absl::Cord& data) {
+  uint32_t sum1 = 0, sum2 = 0;
+  size_t words_since_reduce = 0;
+  int pending_byte = -1;
+  const auto add_word = [&](uint32_t word) {
+    sum1 += word;
+    sum2 += sum1;
+    if (++words_since_reduce == 360) {
+      sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+      sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+      words_since_reduce = 0;
+    }
+  };
+  for (std::string_view chunk : data.Chunks()) {
+    for (char c : chunk) {
+      const uint8_t byte = static_cast<uint8_t>(c);
+      if (pending_byte < 0) {
+        pending_byte = byte;
+      } else {
+        add_word((static_cast<uint32_t>(pending_byte) << 8) | byte);
+        pending_byte = -1;
+      }
+    }
+  }
+  if (words_since_reduce != 0) {
+    sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+  }
+  if (pending_byte >= 0) {
+    sum1 += static_cast<uint32_t>(pending_byte) << 8;
+    sum2 += sum1;
+    sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+  }
+  sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+  sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+  return (sum2 << 16) | sum1;
+}
+
+class Fletcher32Compressor : public ChunkFilterCompressor {
+ public:
+  Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                 size_t element_bytes) const override {
+    absl::Cord input;
+    if (auto status = riegeli::ReadAll(reader, input); !status.ok()) {
+      return status;
+    }
+    if (input.size() < kChecksumSize) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Fletcher32 filtered chunk of size ", input.size(),
+          " is too small to contain a checksum"));
+    }
+    const size_t data_size = input.size() - kChecksumSize;
+    const uint32_t stored = absl::little_endian::Load32(
+        std::string(input.Subcord(data_size, kChecksumSize)).data());
+    input.RemoveSuffix(kChecksumSize);
+    const uint32_t computed = ComputeFletcher32(input);
+    if (stored != computed && stored != absl::gbswap_32(computed)) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Fletcher32 checksum mismatch: stored 0x", absl::Hex(stored),
+          " but computed 0x", absl::Hex(computed)));
+    }
+    return input;
+  }
+
+  absl::Status EncodeChunk(const absl::Cord& input, riegeli::Writer& writer,
+                           size_t element_bytes) const override {
+    if (!writer.Write(input) ||
+        !riegeli::WriteLittleEndian32(ComputeFletcher32(input), writer)) {
+      return writer.status();
+    }
+    return absl::OkStatus();
+  }
+};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<Fletcher32Compressor>("fletcher32", jb::Object());
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
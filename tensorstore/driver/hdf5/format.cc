@@ -0,0 +1,405 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/format.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_format.h"
+#include "riegeli/bytes/reader.h"
+#include "tensorstore/internal/json/value_as.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace jb = tensorstore::internal_json_binding;
+
+namespace {
+
+/// Binds the raw data of a compact layout as a base64-encoded string.
+constexpr auto Base64CordBinder =
+    [](auto is_loading, const auto& options, auto* obj,
+       ::nlohmann::json* j) -> absl::Status {
+  if constexpr (is_loading) {
+    std::string decoded;
+    if (!j->is_string() ||
+        !absl::Base64Unescape(j->get<std::string>(), &decoded)) {
+      return internal_json::ExpectedError(*j, "base64-encoded string");
+    }
+    *obj = absl::Cord(std::move(decoded));
+  } else {
+    std::string encoded;
+    absl::Base64Escape(std::string(*obj), &encoded);
+    *j = std::move(encoded);
+  }
+  return absl::OkStatus();
+};
+
+}  // namespace
+
+TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
+    DataLayout,
+    jb::Object(
+        jb::Member("class",
+                   jb::Projection<&DataLayout::layout_class>(
+                       jb::Enum<LayoutClass, std::string_view>({
+                           {LayoutClass::kCompact, "compact"},
+                           {LayoutClass::kContiguous, "contiguous"},
+                           {LayoutClass::kChunked, "chunked"},
+                       }))),
+        jb::Member("chunk_index",
+                   jb::Projection<&DataLayout::chunk_index_type>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = ChunkIndexType::kBtreeV1; },
+                           jb::Enum<ChunkIndexType, std::string_view>({
+                               {ChunkIndexType::kBtreeV1, "btree_v1"},
+                               {ChunkIndexType::kSingleChunk, "single_chunk"},
+                               {ChunkIndexType::kImplicit, "implicit"},
+                               {ChunkIndexType::kFixedArray, "fixed_array"},
+                               {ChunkIndexType::kExtensibleArray,
+                                "extensible_array"},
+                               {ChunkIndexType::kBtreeV2, "btree_v2"},
+                           })))),
+        jb::Member("address", jb::Projection<&DataLayout::address>(
+                                  jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                      [](auto* obj) {
+                                        *obj = kUndefinedAddress;
+                                      }))),
+        jb::Member("size", jb::Projection<&DataLayout::size>(
+                               jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                   [](auto* obj) { *obj = 0; }))),
+        jb::Member("compact_data",
+                   jb::Projection<&DataLayout::compact_data>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { obj->Clear(); },
+                           Base64CordBinder))),
+        jb::Member("filtered_chunk_size",
+                   jb::Projection<&DataLayout::single_chunk_filtered_size>()),
+        jb::Member("filter_mask",
+                   jb::Projection<&DataLayout::single_chunk_filter_mask>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = 0; })))))
+
+bool ReadUnsignedInteger(riegeli::Reader& reader, size_t size,
+                         uint64_t& value) {
+  assert(size >= 1 && size <= 8);
+  if (!reader.Pull(size)) {
+    if (reader.ok()) {
+      reader.Fail(absl::DataLossError(tensorstore::StrCat(
+          "Unexpected end of data reading ", size, "-byte integer")));
+    }
+    return false;
+  }
+  value = LoadUnsignedInteger(reader.cursor(), size);
+  reader.move_cursor(size);
+  return true;
+}
+
+namespace {
+uint64_t NormalizeAddress(const FormatParameters& params, uint64_t address) {
+  if (params.size_of_offsets < 8 &&
+      address == (uint64_t{1} << (8 * params.size_of_offsets)) - 1) {
+    return kUndefinedAddress;
+  }
+  return address;
+}
+}  // namespace
+
+bool ReadAddress(riegeli::Reader& reader, const FormatParameters& params,
+                 uint64_t& address) {
+  if (!ReadUnsignedInteger(reader, params.size_of_offsets, address)) {
+    return false;
+  }
+  address = NormalizeAddress(params, address);
+  return true;
+}
+
+bool ReadLength(riegeli::Reader& reader, const FormatParameters& params,
+                uint64_t& length) {
+  return ReadUnsignedInteger(reader, params.size_of_lengths, length);
+}
+
+bool ReadSignature(riegeli::Reader& reader, std::string_view signature) {
+  assert(signature.size() == 4);
+  if (!reader.Pull(signature.size())) {
+    if (reader.ok()) {
+      reader.Fail(absl::DataLossError("Unexpected end of data"));
+    }
+    return false;
+  }
+  if (std::string_view(reader.cursor(), signature.size()) != signature) {
+    return reader.Fail(absl::DataLossError(
+        tensorstore::StrCat("Expected signature ",
+                            tensorstore::QuoteString(signature))));
+  }
+  reader.move_cursor(signature.size());
+  return true;
+}
+
+uint64_t LoadUnsignedInteger(const char* data, size_t size) {
+  assert(size >= 1 && size <= 8);
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  uint64_t value = 0;
+  for (size_t i = size; i--;) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+uint64_t LoadAddress(const char* data, const FormatParameters& params) {
+  return NormalizeAddress(params,
+                          LoadUnsignedInteger(data, params.size_of_offsets));
+}
+
+void AppendUnsignedInteger(std::string& out, size_t size, uint64_t value) {
+  assert(size >= 1 && size <= 8);
+  for (size_t i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void AppendAddress(std::string& out, const FormatParameters& params,
+                   uint64_t address) {
+  AppendUnsignedInteger(out, params.size_of_offsets, address);
+}
+
+uint32_t Lookup3Checksum(std::string_view data, uint32_t initval) {
+  const auto rot = [](uint32_t x, int k) { return (x << k) | (x >> (32 - k)); };
+  const unsigned char* k = reinterpret_cast<const unsigned char*>(data.data());
+  size_t length = data.size();
+  uint32_t a, b, c;
+  a = b = c = 0xdeadbeef + static_cast<uint32_t>(length) + initval;
+  while (length > 12) {
+    a += k[0] + (uint32_t{k[1]} << 8) + (uint32_t{k[2]} << 16) +
+         (uint32_t{k[3]} << 24);
+    b += k[4] + (uint32_t{k[5]} << 8) + (uint32_t{k[6]} << 16) +
+         (uint32_t{k[7]} << 24);
+    c += k[8] + (uint32_t{k[9]} << 8) + (uint32_t{k[10]} << 16) +
+         (uint32_t{k[11]} << 24);
+    // mix(a, b, c)
+    a -= c;
+    a ^= rot(c, 4);
+    c += b;
+    b -= a;
+    b ^= rot(a, 6);
+    a += c;
+    c -= b;
+    c ^= rot(b, 8);
+    b += a;
+    a -= c;
+    a ^= rot(c, 16);
+    c += b;
+    b -= a;
+    b ^= rot(a, 19);
+    a += c;
+    c -= b;
+    c ^= rot(b, 4);
+    b += a;
+    length -= 12;
+    k += 12;
+  }
+  switch (length) {
+    case 12:
+      c += uint32_t{k[11]} << 24;
+      [[fallthrough]];
+    case 11:
+      c += uint32_t{k[10]} << 16;
+      [[fallthrough]];
+    case 10:
+      c += uint32_t{k[9]} << 8;
+      [[fallthrough]];
+    case 9:
+      c += k[8];
+      [[fallthrough]];
+    case 8:
+      b += uint32_t{k[7]} << 24;
+      [[fallthrough]];
+    case 7:
+      b += uint32_t{k[6]} << 16;
+      [[fallthrough]];
+    case 6:
+      b += uint32_t{k[5]} << 8;
+      [[fallthrough]];
+    case 5:
+      b += k[4];
+      [[fallthrough]];
+    case 4:
+      a += uint32_t{k[3]} << 24;
+      [[fallthrough]];
+    case 3:
+      a += uint32_t{k[2]} << 16;
+      [[fallthrough]];
+    case 2:
+      a += uint32_t{k[1]} << 8;
+      [[fallthrough]];
+    case 1:
+      a += k[0];
+      break;
+    case 0:
+      return c;
+  }
+  // final(a, b, c)
+  c ^= b;
+  c -= rot(b, 14);
+  a ^= c;
+  a -= rot(c, 11);
+  b ^= a;
+  b -= rot(a, 25);
+  c ^= b;
+  c -= rot(b, 16);
+  a ^= c;
+  a -= rot(c, 4);
+  b ^= a;
+  b -= rot(a, 14);
+  c ^= b;
+  c -= rot(b, 24);
+  return c;
+}
+
+absl::Status ValidateChecksum(std::string_view data) {
+  if (data.size() < 4) {
+    return absl::DataLossError("Unexpected end of data reading checksum");
+  }
+  const uint32_t expected = static_cast<uint32_t>(
+      LoadUnsignedInteger(data.data() + data.size() - 4, 4));
+  const uint32_t actual = Lookup3Checksum(data.substr(0, data.size() - 4));
+  if (expected != actual) {
+    return absl::DataLossError(absl::StrFormat(
+        "Checksum mismatch: expected 0x%08x but computed 0x%08x", expected,
+        actual));
+  }
+  return absl::OkStatus();
+}
+
+namespace {
+
+constexpr std::string_view kSuperblockSignature = "\x89HDF\r\n\x1a\n";
+
+/// Location of the "end of file address" field within the superblock.
+struct EndOfFileAddressField {
+  /// Superblock version.
+  uint8_t version;
+
+  /// Offset of the field relative to the start of the superblock.
+  size_t offset;
+};
+
+Result<EndOfFileAddressField> GetEndOfFileAddressField(
+    std::string_view superblock, const FormatParameters& params) {
+  if (superblock.size() < 16 ||
+      superblock.substr(0, kSuperblockSignature.size()) !=
+          kSuperblockSignature) {
+    return absl::DataLossError("Invalid HDF5 superblock signature");
+  }
+  EndOfFileAddressField field;
+  field.version = static_cast<uint8_t>(superblock[8]);
+  size_t size_of_offsets_offset;
+  switch (field.version) {
+    case 0:
+    case 1:
+      size_of_offsets_offset = 13;
+      field.offset = (field.version == 0 ? 24 : 28) +
+                     2 * static_cast<size_t>(params.size_of_offsets);
+      break;
+    case 2:
+    case 3:
+      size_of_offsets_offset = 9;
+      field.offset = 12 + 2 * static_cast<size_t>(params.size_of_offsets);
+      break;
+    default:
+      return absl::UnimplementedError(tensorstore::StrCat(
+          "HDF5 superblock version ", field.version, " is not supported"));
+  }
+  if (static_cast<uint8_t>(superblock[size_of_offsets_offset]) !=
+      params.size_of_offsets) {
+    return absl::DataLossError(
+        "HDF5 superblock does not match dataset format parameters");
+  }
+  if (superblock.size() < field.offset + params.size_of_offsets) {
+    return absl::DataLossError("Truncated HDF5 superblock");
+  }
+  return field;
+}
+
+}  // namespace
+
+uint64_t GetSuperblockPrefixSize(const FormatParameters& params) {
+  // Versions 0 and 1 end with the "end of file address" at offset
+  // `28 + 2 * size_of_offsets`, versions 2 and 3 with the checksum at offset
+  // `12 + 4 * size_of_offsets`.
+  const uint64_t size_of_offsets = params.size_of_offsets;
+  return std::max<uint64_t>(28 + 3 * size_of_offsets,
+                            16 + 4 * size_of_offsets);
+}
+
+Result<uint64_t> GetEndOfFileAddress(std::string_view superblock,
+                                     const FormatParameters& params) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto field,
+                               GetEndOfFileAddressField(superblock, params));
+  uint64_t address = 0;
+  for (size_t i = params.size_of_offsets; i--;) {
+    address = (address << 8) |
+              static_cast<unsigned char>(superblock[field.offset + i]);
+  }
+  return address;
+}
+
+Result<std::string> SetEndOfFileAddress(std::string_view superblock,
+                                        const FormatParameters& params,
+                                        uint64_t address) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto field,
+                               GetEndOfFileAddressField(superblock, params));
+  std::string modified(superblock);
+  std::string encoded;
+  AppendAddress(encoded, params, address);
+  modified.replace(field.offset, encoded.size(), encoded);
+  size_t modified_size = field.offset + encoded.size();
+  if (field.version >= 2) {
+    // The checksum follows the root group object header address.
+    const size_t checksum_offset =
+        12 + 4 * static_cast<size_t>(params.size_of_offsets);
+    if (modified.size() < checksum_offset + 4) {
+      return absl::DataLossError("Truncated HDF5 superblock");
+    }
+    std::string checksum;
+    AppendUnsignedInteger(checksum, 4,
+                          Lookup3Checksum(std::string_view(modified).substr(
+                              0, checksum_offset)));
+    modified.replace(checksum_offset, 4, checksum);
+    modified_size = checksum_offset + 4;
+  }
+  modified.resize(modified_size);
+  return modified;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,196 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_FORMAT_H_
+#define TENSORSTORE_DRIVER_HDF5_FORMAT_H_
+
+/// \file
+///
+/// Low-level definitions of the HDF5 on-disk format.
+///
+/// See https://docs.hdfgroup.org/hdf5/develop/_f_m_t3.html for the format
+/// specification.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/reader.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/json_serialization_options_base.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Address value used by HDF5 to indicate unallocated storage.
+constexpr uint64_t kUndefinedAddress = ~static_cast<uint64_t>(0);
+
+/// File-wide encoding parameters specified by the superblock.
+struct FormatParameters {
+  /// Number of bytes used to encode file addresses.
+  uint8_t size_of_offsets = 8;
+
+  /// Number of bytes used to encode object sizes.
+  uint8_t size_of_lengths = 8;
+
+  /// Node "K" value of version 1 B-trees that index raw data chunks.
+  uint16_t indexed_storage_k = 32;
+
+  /// Absolute file offset of the superblock.  All addresses stored in the file
+  /// are relative to this offset.
+  uint64_t base_address = 0;
+
+  friend bool operator==(const FormatParameters& a,
+                         const FormatParameters& b) {
+    return a.size_of_offsets == b.size_of_offsets &&
+           a.size_of_lengths == b.size_of_lengths &&
+           a.indexed_storage_k == b.indexed_storage_k &&
+           a.base_address == b.base_address;
+  }
+  friend bool operator!=(const FormatParameters& a,
+                         const FormatParameters& b) {
+    return !(a == b);
+  }
+};
+
+/// Storage layout class, as specified by the data layout message.
+enum class LayoutClass {
+  kCompact = 0,
+  kContiguous = 1,
+  kChunked = 2,
+};
+
+/// Chunk indexing type, as specified by a version 4 data layout message.
+///
+/// Version 1-3 data layout messages always use `kBtreeV1`.
+enum class ChunkIndexType {
+  kBtreeV1 = 0,
+  kSingleChunk = 1,
+  kImplicit = 2,
+  kFixedArray = 3,
+  kExtensibleArray = 4,
+  kBtreeV2 = 5,
+};
+
+/// Decoded representation of the data layout message.
+struct DataLayout {
+  LayoutClass layout_class = LayoutClass::kChunked;
+
+  ChunkIndexType chunk_index_type = ChunkIndexType::kBtreeV1;
+
+  /// Address of the chunk index (for the chunked layout), or of the raw data
+  /// (for the contiguous layout).
+  uint64_t address = kUndefinedAddress;
+
+  /// Size in bytes of the raw data, for the contiguous and compact layouts.
+  uint64_t size = 0;
+
+  /// Raw data of the compact layout, which is stored within the data layout
+  /// message itself.
+  absl::Cord compact_data;
+
+  /// Size in bytes of the chunk of a dataset using the single chunk index, if
+  /// the chunk is filtered.  Otherwise, the chunk is stored unfiltered.
+  std::optional<uint64_t> single_chunk_filtered_size;
+
+  /// Filter mask of the chunk of a dataset using the single chunk index, if
+  /// the chunk is filtered.
+  uint32_t single_chunk_filter_mask = 0;
+
+  TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(DataLayout,
+                                          internal_json_binding::NoOptions,
+                                          tensorstore::IncludeDefaults)
+};
+
+/// Decodes a little endian unsigned integer of `size` bytes, where
+/// `1 <= size <= 8`.
+[[nodiscard]] bool ReadUnsignedInteger(riegeli::Reader& reader, size_t size,
+                                       uint64_t& value);
+
+/// Decodes a file address, using `params.size_of_offsets` bytes.
+///
+/// The all-ones address of any size is normalized to `kUndefinedAddress`.
+[[nodiscard]] bool ReadAddress(riegeli::Reader& reader,
+                               const FormatParameters& params,
+                               uint64_t& address);
+
+/// Decodes an object size, using `params.size_of_lengths` bytes.
+[[nodiscard]] bool ReadLength(riegeli::Reader& reader,
+                              const FormatParameters& params, uint64_t& length);
+
+/// Reads a 4-byte structure signature, and fails `reader` if it is not equal
+/// to `signature`.
+[[nodiscard]] bool ReadSignature(riegeli::Reader& reader,
+                                 std::string_view signature);
+
+/// Decodes a little endian unsigned integer of `size` bytes from `data`, where
+/// `1 <= size <= 8`.
+uint64_t LoadUnsignedInteger(const char* data, size_t size);
+
+/// Decodes a file address of `params.size_of_offsets` bytes from `data`.
+///
+/// The all-ones address of any size is normalized to `kUndefinedAddress`.
+uint64_t LoadAddress(const char* data, const FormatParameters& params);
+
+/// Appends a little endian unsigned integer of `size` bytes to `out`.
+void AppendUnsignedInteger(std::string& out, size_t size, uint64_t value);
+
+/// Appends a file address using `params.size_of_offsets` bytes.
+void AppendAddress(std::string& out, const FormatParameters& params,
+                   uint64_t address);
+
+/// Computes the Jenkins "lookup3" hash used by HDF5 to checksum metadata
+/// structures of newer format versions.
+uint32_t Lookup3Checksum(std::string_view data, uint32_t initval = 0);
+
+/// Verifies that the last 4 bytes of `data` are the `Lookup3Checksum` of the
+/// preceding bytes, as for all checksummed metadata structures.
+///
+/// \error `absl::StatusCode::kDataLoss` if the checksum does not match.
+absl::Status ValidateChecksum(std::string_view data);
+
+/// Returns the size of the prefix of the superblock that contains the "end of
+/// file address" field, and for superblock versions 2 and 3 the checksum,
+/// for any superblock version.
+uint64_t GetSuperblockPrefixSize(const FormatParameters& params);
+
+/// Returns the "end of file address" recorded in `superblock`.
+///
+/// This is the address (relative to `params.base_address`) of the first byte
+/// past the space allocated within the file.
+///
+/// \param superblock Prefix of the superblock of at least
+///     `GetSuperblockPrefixSize(params)` bytes.
+Result<uint64_t> GetEndOfFileAddress(std::string_view superblock,
+                                     const FormatParameters& params);
+
+/// Returns the bytes to write at the start of `superblock` in order to set
+/// the "end of file address" to `address`, including the updated checksum if
+/// required.
+///
+/// \param superblock Prefix of the superblock of at least
+///     `GetSuperblockPrefixSize(params)` bytes.
+Result<std::string> SetEndOfFileAddress(std::string_view superblock,
+                                        const FormatParameters& params,
+                                        uint64_t address);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_FORMAT_H_
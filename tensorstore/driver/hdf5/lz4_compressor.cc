@@ -0,0 +1,161 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "lz4" filter (registered filter id 32004).  Linking in
+/// this library automatically registers it.
+///
+/// The encoded chunk consists of the decoded size as a big-endian `uint64`
+/// and the block size as a big-endian `uint32`, followed by the blocks.  Each
+/// block is stored as its encoded size as a big-endian `uint32`, followed by
+/// the LZ4-compressed block, or the uncompressed block if compression would
+/// not reduce its size.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <lz4.h>
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "riegeli/endian/endian_reading.h"
+#include "riegeli/endian/endian_writing.h"
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+/// Block size used if none is specified, as in the reference implementation.
+constexpr uint32_t kDefaultBlockSize = uint32_t{1} << 30;
+
+absl::Status Lz4DataLossError(riegeli::Reader& reader, std::string_view what) {
+  if (!reader.ok()) return reader.status();
+  return absl::DataLossError(
+      tensorstore::StrCat("Error decoding lz4 filtered chunk: ", what));
+}
+
+class Lz4Compressor : public ChunkFilterCompressor {
+ public:
+  /// Size of each independently compressed block, or `0` to use
+  /// `kDefaultBlockSize`.
+  uint32_t block_size;
+
+  Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                 size_t element_bytes) const override {
+    uint64_t decoded_size;
+    uint32_t stored_block_size;
+    if (!riegeli::ReadBigEndian<uint64_t>(reader, decoded_size) ||
+        !riegeli::ReadBigEndian<uint32_t>(reader, stored_block_size)) {
+      return Lz4DataLossError(reader, "truncated header");
+    }
+    if (stored_block_size > decoded_size) {
+      stored_block_size = static_cast<uint32_t>(decoded_size);
+    }
+    if (decoded_size != 0 &&
+        (stored_block_size == 0 || stored_block_size > LZ4_MAX_INPUT_SIZE)) {
+      return Lz4DataLossError(reader, tensorstore::StrCat("invalid block size ",
+                                                      stored_block_size));
+    }
+    std::string output(decoded_size, '\0');
+    for (uint64_t offset = 0; offset < decoded_size;) {
+      const size_t n =
+          std::min<uint64_t>(stored_block_size, decoded_size - offset);
+      uint32_t encoded_size;
+      if (!riegeli::ReadBigEndian<uint32_t>(reader, encoded_size) ||
+          !reader.Pull(encoded_size)) {
+        return Lz4DataLossError(reader, "truncated block");
+      }
+      if (encoded_size == n) {
+        std::memcpy(output.data() + offset, reader.cursor(), n);
+      } else if (encoded_size > LZ4_MAX_INPUT_SIZE ||
+                 LZ4_decompress_safe(reader.cursor(), output.data() + offset,
+                                     static_cast<int>(encoded_size),
+                                     static_cast<int>(n)) !=
+                     static_cast<int>(n)) {
+        return Lz4DataLossError(reader, "corrupt block");
+      }
+      reader.move_cursor(encoded_size);
+      offset += n;
+    }
+    return absl::Cord(std::move(output));
+  }
+
+  absl::Status EncodeChunk(const absl::Cord& input, riegeli::Writer& writer,
+                           size_t element_bytes) const override {
+    const uint64_t decoded_size = input.size();
+    uint32_t block_size =
+        this->block_size == 0 ? kDefaultBlockSize : this->block_size;
+    if (block_size > decoded_size) {
+      block_size = static_cast<uint32_t>(decoded_size);
+    }
+    if (!riegeli::WriteBigEndian<uint64_t>(decoded_size, writer) ||
+        !riegeli::WriteBigEndian<uint32_t>(block_size, writer)) {
+      return writer.status();
+    }
+    for (uint64_t offset = 0; offset < decoded_size;) {
+      const size_t n = std::min<uint64_t>(block_size, decoded_size - offset);
+      // Only blocks that span multiple fragments of `input` are copied.
+      absl::Cord block = input.Subcord(offset, n);
+      std::string_view source = block.Flatten();
+      const int bound = LZ4_compressBound(static_cast<int>(n));
+      if (!writer.Push(4 + static_cast<size_t>(bound))) {
+        return writer.status();
+      }
+      int encoded_size =
+          LZ4_compress_default(source.data(), writer.cursor() + 4,
+                               static_cast<int>(n), bound);
+      if (encoded_size <= 0 || static_cast<size_t>(encoded_size) >= n) {
+        std::memcpy(writer.cursor() + 4, source.data(), n);
+        encoded_size = static_cast<int>(n);
+      }
+      absl::big_endian::Store32(writer.cursor(),
+                                static_cast<uint32_t>(encoded_size));
+      writer.move_cursor(4 + static_cast<size_t>(encoded_size));
+      offset += n;
+    }
+    return absl::OkStatus();
+  }
+};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<Lz4Compressor>(
+        "lz4",
+        jb::Object(jb::Member(
+            "block_size",
+            jb::Projection(
+                &Lz4Compressor::block_size,
+                jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                    [](auto* v) { *v = 0; },
+                    jb::Integer<uint32_t>(0, LZ4_MAX_INPUT_SIZE))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -45,15 +45,21 @@
 #include "tensorstore/codec_spec_registry.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/hdf5/chunk_index.h"
 #include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/filter_pipeline.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/driver/hdf5/object_header.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dimension_units.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_domain_builder.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/json/same.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/data_type.h"
 #include "tensorstore/internal/json_binding/dimension_indexed.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/json_metadata_matching.h"
@@ -72,7 +78,6 @@
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 #include "tensorstore/util/unit.h"
-#include <iostream>
 
 namespace tensorstore {
 namespace internal_hdf5 {
@@ -100,12 +105,26 @@ std::string GetSupportedDataTypes() {
 }
 
 absl::Status ValidateMetadata(HDF5Metadata& metadata) {
-  std::cout << "HDF5=====ValidateMetadata(HDF5Metadata& metadata)" << std::endl;
   // Check if HDF5 has some limitation for the metadata
+  if (!metadata.max_shape.empty()) {
+    if (metadata.max_shape.size() != metadata.shape.size()) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "\"max_shape\" has rank ", metadata.max_shape.size(),
+          " but \"shape\" has rank ", metadata.shape.size()));
+    }
+    for (size_t i = 0; i < metadata.shape.size(); ++i) {
+      if (metadata.max_shape[i] < metadata.shape[i]) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "\"max_shape\" ", span(metadata.max_shape),
+            " is less than \"shape\" ", span(metadata.shape)));
+      }
+    }
+  }
   return absl::OkStatus();
 }
 
-constexpr auto MetadataJsonBinder = [](auto maybe_optional) {
+constexpr auto MetadataJsonBinder = [](auto maybe_optional,
+                                       auto... extra_members) {
   return [=](auto is_loading, const auto& options, auto* obj, auto* j) {
     using T = absl::remove_cvref_t<decltype(*obj)>;
     DimensionIndex* rank = nullptr;
@@ -132,7 +151,8 @@ constexpr auto MetadataJsonBinder = [](auto maybe_optional) {
                                           [](const auto& options, auto* obj) {
                                             return ValidateDataType(*obj);
                                           },
-                                          jb::DataTypeJsonBinder))))
+                                          jb::DataTypeJsonBinder)))),
+        extra_members...
         )(is_loading, options, obj, j);
   };
 };
@@ -141,12 +161,12 @@ constexpr auto MetadataJsonBinder = [](auto maybe_optional) {
 
 // Who Call this function?? Is it required??
 std::string HDF5Metadata::GetCompatibilityKey() const {
-  std::cout << "HDF5=====GetCompatibilityKey()" << std::endl;
   ::nlohmann::json::object_t obj; 
   obj.emplace("chunk_shape", ::nlohmann::json::array_t(chunk_shape.begin(),
                                                      chunk_shape.end()));
   obj.emplace("data_type", dtype.name());
   obj.emplace("compression", compressor);
+  if (!filters.empty()) obj.emplace("filters", filters);
   
   return ::nlohmann::json(obj).dump();
 }
@@ -154,7 +174,29 @@ std::string HDF5Metadata::GetCompatibilityKey() const {
 TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
     HDF5Metadata, jb::Validate([](const auto& options,
                                 auto* obj) { return ValidateMetadata(*obj); },
-                             MetadataJsonBinder(internal::identity{})))
+                             MetadataJsonBinder(
+                                 internal::identity{},
+                                 jb::Member("layout",
+                                            jb::Projection<
+                                                &HDF5Metadata::layout>()),
+                                 jb::Member(
+                                     "filters",
+                                     jb::Projection<&HDF5Metadata::filters>(
+                                         jb::DefaultValue<
+                                             jb::kNeverIncludeDefaults>(
+                                             [](auto* obj) { obj->clear(); }))),
+                                 jb::Member(
+                                     "max_shape",
+                                     jb::Projection<&HDF5Metadata::max_shape>(
+                                         jb::DefaultValue<
+                                             jb::kNeverIncludeDefaults>(
+                                             [](auto* obj) { obj->clear(); },
+                                             jb::Array(jb::MapValue(
+                                                 jb::Integer<Index>(
+                                                     0, kMaxFiniteIndex),
+                                                 std::make_pair(
+                                                     kInfSize,
+                                                     nullptr)))))))))
 
 TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(HDF5MetadataConstraints,
                                        MetadataJsonBinder([](auto binder) {
@@ -192,7 +234,6 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
 
 absl::Status ValidateMetadata(const HDF5Metadata& metadata,
                               const HDF5MetadataConstraints& constraints) {
-  std::cout << "HDF5=====ValidateMetadata(const HDF5Metadata& metadata, const HDF5MetadataConstraints& constraints)" << std::endl;
   if (constraints.shape && !absl::c_equal(metadata.shape, *constraints.shape)) {
     return MetadataMismatchError("shape", *constraints.shape,
                                  metadata.shape);
@@ -207,7 +248,6 @@ absl::Status ValidateMetadata(const HDF5Metadata& metadata,
                                  metadata.dtype.name());
   }
 
-  std::cout << "hhahahahah: " << ::nlohmann::json(metadata.compressor) << std::endl;
   if (constraints.compressor && ::nlohmann::json(*constraints.compressor) !=
                                     ::nlohmann::json(metadata.compressor)) {
     return MetadataMismatchError("compression", *constraints.compressor,
@@ -221,7 +261,6 @@ Result<IndexDomain<>> GetEffectiveDomain(
     DimensionIndex rank, std::optional<span<const Index>> shape,
     const Schema& schema) {
 
-  std::cout << "HDF5=====GetEffectiveDomain(DimensionIndex rank, std::optional<span<const Index>> shape, const Schema& schema)" << std::endl;
   auto domain = schema.domain();
   if (!shape && !domain.valid()) {
     if (schema.rank() == 0) return {std::in_place, 0};
@@ -250,7 +289,6 @@ Result<IndexDomain<>> GetEffectiveDomain(
 Result<IndexDomain<>> GetEffectiveDomain(
     const HDF5MetadataConstraints& metadata_constraints, const Schema& schema) {
   // This may has some problem, since I only have the shape.
-  std::cout << "HDF5=====GetEffectiveDomain(const HDF5MetadataConstraints& metadata_constraints, const Schema& schema)" << std::endl;
   return GetEffectiveDomain(metadata_constraints.rank,
                             metadata_constraints.shape,
                             schema);
@@ -259,7 +297,6 @@ Result<IndexDomain<>> GetEffectiveDomain(
 Result<std::shared_ptr<const HDF5Metadata>> GetNewMetadata(
     const HDF5MetadataConstraints& metadata_constraints, const Schema& schema) {
   
-  std::cout << "HDF5=====GetNewMetadata()" << std::endl;
   auto metadata = std::make_shared<HDF5Metadata>();
 
   // Set domain
@@ -294,10 +331,133 @@ Result<std::shared_ptr<const HDF5Metadata>> GetNewMetadata(
   return metadata;
 }
 
+namespace {
+
+/// Validates the size of the raw data of a dataset using the contiguous or
+/// compact layout, and sets it for version 1 and 2 data layout messages that
+/// do not record it.
+absl::Status ValidateRawDataSize(DataLayout& layout, span<const Index> shape,
+                                 Index element_size) {
+  Index num_bytes = element_size;
+  for (Index extent : shape) {
+    if (internal::MulOverflow(num_bytes, extent, &num_bytes)) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Dataset of shape ", shape, " is too large"));
+    }
+  }
+  const uint64_t expected_size = static_cast<uint64_t>(num_bytes);
+  if (layout.layout_class == LayoutClass::kContiguous && layout.size == 0) {
+    layout.size = expected_size;
+  }
+  if (layout.size != expected_size) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Raw data size ", layout.size, " does not match expected size ",
+        expected_size, " of dataset"));
+  }
+  if (layout.layout_class == LayoutClass::kCompact &&
+      layout.compact_data.size() != expected_size) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Compact data size ", layout.compact_data.size(),
+        " does not match expected size ", expected_size, " of dataset"));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+Result<std::shared_ptr<const HDF5Metadata>> GetMetadataFromObjectHeader(
+    const DatasetObjectHeader& header) {
+  const ObjectHeaderMessage* messages[3] = {};
+  const ObjectHeaderMessage* filter_pipeline = nullptr;
+  for (const auto& message : header.messages) {
+    const ObjectHeaderMessage** target;
+    switch (message.type) {
+      case kDataspaceMessage:
+        target = &messages[0];
+        break;
+      case kDatatypeMessage:
+        target = &messages[1];
+        break;
+      case kDataLayoutMessage:
+        target = &messages[2];
+        break;
+      case kFilterPipelineMessage:
+        target = &filter_pipeline;
+        break;
+      default:
+        continue;
+    }
+    if (message.flags & kSharedMessageFlag) {
+      return absl::UnimplementedError(tensorstore::StrCat(
+          "Shared object header messages (type ", message.type,
+          ") are not supported"));
+    }
+    *target = &message;
+  }
+  constexpr const char* kMessageNames[] = {"dataspace", "datatype",
+                                           "data layout"};
+  for (size_t i = 0; i < 3; ++i) {
+    if (!messages[i]) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Dataset object header has no ", kMessageNames[i], " message"));
+    }
+  }
+
+  auto metadata = std::make_shared<HDF5Metadata>();
+  metadata->format = header.format;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto dataspace, DecodeDataspaceMessage(messages[0]->body, header.format));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto datatype,
+                               DecodeDatatypeMessage(messages[1]->body));
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto layout, DecodeDataLayoutMessage(messages[2]->body, header.format));
+  metadata->rank = dataspace.shape.size();
+  metadata->shape = std::move(dataspace.shape);
+  metadata->max_shape = std::move(dataspace.max_shape);
+  TENSORSTORE_RETURN_IF_ERROR(ValidateDataType(datatype.dtype));
+  metadata->dtype = datatype.dtype;
+  metadata->byte_order = datatype.byte_order;
+  if (layout.layout.layout_class == LayoutClass::kChunked) {
+    if (layout.chunk_shape.size() != metadata->shape.size()) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Chunk shape ", span(layout.chunk_shape), " does not match rank ",
+          metadata->rank, " of dataspace"));
+    }
+    if (layout.element_size != static_cast<uint64_t>(metadata->dtype.size())) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Chunk element size ", layout.element_size,
+          " does not match datatype size ", metadata->dtype.size()));
+    }
+    metadata->chunk_shape = std::move(layout.chunk_shape);
+  } else {
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidateRawDataSize(layout.layout, metadata->shape,
+                            metadata->dtype.size()));
+    if (filter_pipeline) {
+      return absl::DataLossError(
+          "Filter pipeline is only valid for the chunked layout");
+    }
+    metadata->chunk_shape =
+        GetVirtualChunkShape(layout.layout.layout_class, metadata->shape,
+                             metadata->dtype.size());
+  }
+  metadata->layout = std::move(layout.layout);
+  if (filter_pipeline) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto filters, DecodeFilterPipelineMessage(filter_pipeline->body));
+    for (const auto& filter : filters) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto compressor,
+                                   GetFilterCompressor(filter));
+      metadata->filters.push_back(std::move(compressor));
+    }
+  }
+  TENSORSTORE_RETURN_IF_ERROR(ValidateMetadata(*metadata));
+  return metadata;
+}
+
 absl::Status ValidateMetadataSchema(const HDF5Metadata& metadata,
                                     const Schema& schema) {
   
-  std::cout << "HDF5=====ValidateMetadataSchema(const HDF5Metadata& metadata, const Schema& schema)" << std::endl;
   if (!RankConstraint::EqualOrUnspecified(metadata.rank, schema.rank())) {
     return absl::FailedPreconditionError(tensorstore::StrCat(
         "Rank specified by schema (", schema.rank(),
@@ -332,11 +492,9 @@ absl::Status ValidateMetadataSchema(const HDF5Metadata& metadata,
     // if (chunk_layout.codec_chunk_shape().hard_constraint) {
     //   return absl::InvalidArgumentError("codec_chunk_shape not supported");
     // }
-    std::cout << "Warning: schema.chunk_layout().rank() != dynamic_rank" << std::endl;
   }
 
   if (schema.fill_value().valid()) {
-    std::cout << "Warning: schema.fill_value().valid() not supported for hdf5...." << std::endl;
     return absl::InvalidArgumentError("fill_value not supported by HDF5 format");
   }
 
@@ -354,7 +512,6 @@ absl::Status ValidateMetadataSchema(const HDF5Metadata& metadata,
     //                           " do not match dimension units in schema ",
     //                           DimensionUnitsToString(schema_units)));
     // }
-    std::cout << "Warning: schema_units not supported for hdf5...." << std::endl;
   }
   return absl::OkStatus();
 }
@@ -368,9 +525,82 @@ absl::Status ValidateDataType(DataType dtype) {
   return absl::OkStatus();
 }
 
+absl::Status SetChunkLayoutFromMetadata(
+    DimensionIndex rank, std::optional<span<const Index>> chunk_shape,
+    ChunkLayout& chunk_layout) {
+  TENSORSTORE_RETURN_IF_ERROR(chunk_layout.Set(RankConstraint{rank}));
+  rank = chunk_layout.rank();
+  if (rank == dynamic_rank) return absl::OkStatus();
+
+  // HDF5 always stores chunks in C (lexicographic) order.
+  {
+    DimensionIndex inner_order[kMaxRank];
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      inner_order[i] = i;
+    }
+    TENSORSTORE_RETURN_IF_ERROR(
+        chunk_layout.Set(ChunkLayout::InnerOrder(span(inner_order, rank))));
+  }
+  if (chunk_shape) {
+    assert(chunk_shape->size() == rank);
+    TENSORSTORE_RETURN_IF_ERROR(
+        chunk_layout.Set(ChunkLayout::ChunkShape(*chunk_shape)));
+  }
+  TENSORSTORE_RETURN_IF_ERROR(chunk_layout.Set(
+      ChunkLayout::GridOrigin(GetConstantVector<Index, 0>(rank))));
+  return absl::OkStatus();
+}
+
+Result<SharedArray<const void>> DecodeChunk(const HDF5Metadata& metadata,
+                                            absl::Cord buffer) {
+  riegeli::CordReader<> base_reader(&buffer);
+  riegeli::Reader* reader = &base_reader;
+  std::unique_ptr<riegeli::Reader> compressed_reader;
+  if (metadata.compressor) {
+    compressed_reader =
+        metadata.compressor->GetReader(base_reader, metadata.dtype.size());
+    reader = compressed_reader.get();
+  }
+  // Chunks are always stored at their full size, including the portion that
+  // lies outside the bounds of the dataset.
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto decoded_array,
+      internal::DecodeArrayEndian(*reader, metadata.dtype, metadata.chunk_shape,
+                                  metadata.byte_order, c_order));
+  if (compressed_reader && !compressed_reader->VerifyEndAndClose()) {
+    return compressed_reader->status();
+  }
+  if (!base_reader.VerifyEndAndClose()) return base_reader.status();
+  return decoded_array;
+}
+
+Result<absl::Cord> EncodeChunk(const HDF5Metadata& metadata,
+                               SharedArrayView<const void> array) {
+  assert(absl::c_equal(metadata.chunk_shape, array.shape()));
+  absl::Cord encoded;
+  riegeli::CordWriter<> base_writer(&encoded);
+  riegeli::Writer* writer = &base_writer;
+  std::unique_ptr<riegeli::Writer> compressed_writer;
+  if (metadata.compressor) {
+    compressed_writer =
+        metadata.compressor->GetWriter(base_writer, metadata.dtype.size());
+    writer = compressed_writer.get();
+  }
+  // Always write chunks as full size, to avoid race conditions or data loss
+  // in the event of a concurrent resize.
+  if (!internal::EncodeArrayEndian(array, metadata.byte_order, c_order,
+                                   *writer)) {
+    return writer->status();
+  }
+  if (compressed_writer && !compressed_writer->Close()) {
+    return compressed_writer->status();
+  }
+  if (!base_writer.Close()) return base_writer.status();
+  return encoded;
+}
+
 Result<internal::CodecDriverSpec::PtrT<HDF5CodecSpec>> GetEffectiveCodec(
     const HDF5MetadataConstraints& metadata_constraints, const Schema& schema) {
-  std::cout << "HDF5=====GetEffectiveCodec(const HDF5MetadataConstraints& metadata_constraints, const Schema& schema)" << std::endl;
   auto codec_spec = internal::CodecDriverSpec::Make<HDF5CodecSpec>();
   if (metadata_constraints.compressor) {
     codec_spec->compressor = *metadata_constraints.compressor;
@@ -382,7 +612,6 @@ Result<internal::CodecDriverSpec::PtrT<HDF5CodecSpec>> GetEffectiveCodec(
 
 /// Returns the codec from the specified metadata.
 CodecSpec GetCodecFromMetadata(const HDF5Metadata& metadata) {
-  std::cout << "HDF5=====GetCodecFromMetadata(const HDF5Metadata& metadata)" << std::endl;
   auto codec_spec = internal::CodecDriverSpec::Make<HDF5CodecSpec>();
   codec_spec->compressor = metadata.compressor;
   return CodecSpec(std::move(codec_spec));
@@ -28,6 +28,8 @@
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/hdf5/compressor.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/driver/hdf5/object_header.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dimension_units.h"
 #include "tensorstore/index_space/index_domain.h"
@@ -38,6 +40,7 @@
 #include "tensorstore/serialization/fwd.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/endian.h"
 #include "tensorstore/util/span.h"
 
 namespace tensorstore {
@@ -52,12 +55,30 @@ namespace internal_hdf5 {
       /// Specifies the current shape of the full volume.
       std::vector<Index> shape;
 
+      /// Specifies the maximum shape of the full volume, with `kInfSize` for
+      /// unlimited dimensions.  If empty, equal to `shape`.
+      std::vector<Index> max_shape;
+
       /// Specifies the chunk size
       std::vector<Index> chunk_shape;
 
       Compressor compressor;
       DataType dtype;
 
+      /// Byte order of the stored array elements.
+      endian byte_order = endian::little;
+
+      /// File-wide format parameters from the superblock.
+      FormatParameters format;
+
+      /// Storage layout of the raw data of the dataset.
+      DataLayout layout;
+
+      /// Filter pipeline applied to each chunk, in the order in which the
+      /// filters are applied when writing.  A null filter leaves the data
+      /// unchanged.
+      std::vector<Compressor> filters;
+
       TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(HDF5Metadata,
                                               internal_json_binding::NoOptions,
                                               tensorstore::IncludeDefaults)
@@ -112,6 +133,13 @@ absl::Status ValidateMetadata(const HDF5Metadata& metadata,
 Result<std::shared_ptr<const HDF5Metadata>> GetNewMetadata(
     const HDF5MetadataConstraints& metadata_constraints, const Schema& schema);
 
+/// Converts the object header messages of an existing dataset to metadata.
+///
+/// \error `absl::StatusCode::kUnimplemented` if the dataset uses features
+///     that are not supported, such as shared messages.
+Result<std::shared_ptr<const HDF5Metadata>> GetMetadataFromObjectHeader(
+    const DatasetObjectHeader& header);
+
 /// Validates that `schema` is compatible with `metadata`.
 absl::Status ValidateMetadataSchema(const HDF5Metadata& metadata,
                                     const Schema& schema);
@@ -126,10 +154,10 @@ absl::Status ValidateMetadataSchema(const HDF5Metadata& metadata,
 Result<IndexDomain<>> GetEffectiveDomain(
     const HDF5MetadataConstraints& metadata_constraints, const Schema& schema);
 
-// /// Sets chunk layout constraints implied by `rank` and `chunk_shape`.
-// absl::Status SetChunkLayoutFromMetadata(
-//     DimensionIndex rank, std::optional<span<const Index>> chunk_shape,
-//     ChunkLayout& chunk_layout);
+/// Sets chunk layout constraints implied by `rank` and `chunk_shape`.
+absl::Status SetChunkLayoutFromMetadata(
+    DimensionIndex rank, std::optional<span<const Index>> chunk_shape,
+    ChunkLayout& chunk_layout);
 
 /// Returns the combined chunk layout from `metadata_constraints` and `schema`.
 ///
@@ -167,12 +195,14 @@ CodecSpec GetCodecFromMetadata(const HDF5Metadata& metadata);
 /// Decodes a chunk.
 ///
 /// The layout of the returned array is only valid as long as `metadata`.
-// Result<SharedArray<const void>> DecodeChunk(const HDF5Metadata& metadata,
-//                                             absl::Cord buffer);
+Result<SharedArray<const void>> DecodeChunk(const HDF5Metadata& metadata,
+                                            absl::Cord buffer);
 
-// /// Encodes a chunk.
-// Result<absl::Cord> EncodeChunk(const HDF5Metadata& metadata,
-//                                SharedArrayView<const void> array);
+/// Encodes a chunk.
+///
+/// \dchecks `array.shape() == metadata.chunk_shape`
+Result<absl::Cord> EncodeChunk(const HDF5Metadata& metadata,
+                               SharedArrayView<const void> array);
 
 /// Validates that `dtype` is supported by HDF5.
 ///
@@ -0,0 +1,148 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "nbit" filter (filter id 5).  Linking in this library
+/// automatically registers it.
+///
+/// For each element, only the `precision` bits starting at bit `offset` are
+/// stored, packed as by `PackedBitWriter`.  The remaining bits are zero when
+/// decoded.  Only atomic (integer and floating-point) datatypes are supported.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+class NbitCompressor : public ChunkFilterCompressor {
+ public:
+  /// Number of elements in each chunk.
+  uint64_t num_elements;
+
+  /// Number of significant bits of each element.
+  int precision;
+
+  /// Bit offset of the significant bits within each element.
+  int offset;
+
+  /// Byte order of the elements.
+  endian byte_order;
+
+  absl::Status ValidateElementSize(size_t element_bytes) const {
+    if (element_bytes > 8 ||
+        static_cast<size_t>(precision + offset) > element_bytes * 8) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "nbit precision ", precision, " and offset ", offset,
+          " are not valid for elements of ", element_bytes, " bytes"));
+    }
+    return absl::OkStatus();
+  }
+
+  Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                 size_t element_bytes) const override {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateElementSize(element_bytes));
+    std::string output(num_elements * element_bytes, '\0');
+    PackedBitReader bit_reader(reader);
+    for (uint64_t i = 0; i < num_elements; ++i) {
+      uint64_t value;
+      if (!bit_reader.Read(precision, value)) {
+        if (!reader.ok()) return reader.status();
+        return absl::DataLossError(tensorstore::StrCat(
+            "nbit filtered chunk is too small for ", num_elements,
+            " elements"));
+      }
+      StoreUnsigned(value << offset, output.data() + i * element_bytes,
+                    element_bytes, byte_order);
+    }
+    return absl::Cord(std::move(output));
+  }
+
+  absl::Status EncodeChunk(const absl::Cord& input, riegeli::Writer& writer,
+                           size_t element_bytes) const override {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateElementSize(element_bytes));
+    if (input.size() != num_elements * element_bytes) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "nbit filter expects ", num_elements, " elements but received ",
+          input.size(), " bytes"));
+    }
+    riegeli::CordReader<> reader(&input);
+    PackedBitWriter bit_writer(writer);
+    char element[8];
+    for (uint64_t i = 0; i < num_elements; ++i) {
+      if (!reader.Read(element_bytes, element)) return reader.status();
+      const uint64_t value =
+          LoadUnsigned(element, element_bytes, byte_order) >> offset;
+      if (!bit_writer.Write(value, precision)) return writer.status();
+    }
+    if (!bit_writer.Flush()) return writer.status();
+    // As in the reference implementation, the encoded size is always
+    // `floor(num_elements * precision / 8) + 1`.
+    if ((num_elements * precision) % 8 == 0 && !writer.WriteByte(0)) {
+      return writer.status();
+    }
+    return absl::OkStatus();
+  }
+};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<NbitCompressor>(
+        "nbit",
+        jb::Object(
+            jb::Member("num_elements",
+                       jb::Projection(&NbitCompressor::num_elements,
+                                      jb::Integer<uint64_t>())),
+            jb::Member("precision", jb::Projection(&NbitCompressor::precision,
+                                                   jb::Integer<int>(1, 64))),
+            jb::Member("offset",
+                       jb::Projection(&NbitCompressor::offset,
+                                      jb::DefaultValue<
+                                          jb::kAlwaysIncludeDefaults>(
+                                          [](auto* v) { *v = 0; },
+                                          jb::Integer<int>(0, 63)))),
+            jb::Member(
+                "byte_order",
+                jb::Projection(&NbitCompressor::byte_order,
+                               jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                                   [](auto* v) { *v = endian::little; },
+                                   jb::Enum<endian, std::string_view>({
+                                       {endian::little, "little"},
+                                       {endian::big, "big"},
+                                   }))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,874 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/object_header.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/string_reader.h"
+#include "riegeli/endian/endian_reading.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+constexpr std::string_view kSuperblockSignature = "\x89HDF\r\n\x1a\n";
+
+/// Decodes a structure of type `T` from `data` using `decode`, which returns
+/// `false` on failure.
+template <typename T, typename Decode>
+Result<T> DecodeStructure(std::string_view data, std::string_view description,
+                          Decode decode) {
+  riegeli::StringReader<> reader(data);
+  T value;
+  if (!decode(reader, value)) {
+    absl::Status status = reader.status();
+    if (status.ok()) {
+      status = absl::DataLossError("Unexpected end of data");
+    }
+    return tensorstore::MaybeAnnotateStatus(
+        status, tensorstore::StrCat("Error decoding HDF5 ", description));
+  }
+  return value;
+}
+
+bool ReadVersion(riegeli::Reader& reader, uint8_t min_version,
+                 uint8_t max_version, uint8_t& version) {
+  if (!reader.ReadByte(version)) return false;
+  if (version < min_version || version > max_version) {
+    return reader.Fail(absl::UnimplementedError(
+        tensorstore::StrCat("Version ", version, " is not supported")));
+  }
+  return true;
+}
+
+/// Returns `true` if `value` is the all-ones value of a `size`-byte integer,
+/// which HDF5 uses to indicate an unlimited or undefined value.
+bool IsAllOnes(uint64_t value, size_t size) {
+  return size >= 8 ? value == ~uint64_t{0}
+                   : value == (uint64_t{1} << (8 * size)) - 1;
+}
+
+bool ReadDimension(riegeli::Reader& reader, size_t size, bool allow_unlimited,
+                   Index& value) {
+  uint64_t encoded;
+  if (!ReadUnsignedInteger(reader, size, encoded)) return false;
+  if (allow_unlimited && IsAllOnes(encoded, size)) {
+    value = kInfSize;
+    return true;
+  }
+  if (encoded > static_cast<uint64_t>(kMaxFiniteIndex)) {
+    return reader.Fail(absl::DataLossError(
+        tensorstore::StrCat("Invalid dimension size: ", encoded)));
+  }
+  value = static_cast<Index>(encoded);
+  return true;
+}
+
+/// Reads the messages of an object header block, excluding any prefix,
+/// signature and checksum.
+bool ReadObjectHeaderMessages(riegeli::Reader& reader, uint64_t end,
+                              const ObjectHeaderPrefix& prefix,
+                              const FormatParameters& format,
+                              ObjectHeaderBlock& block) {
+  const size_t message_header_size =
+      prefix.version == 1 ? 8 : ((prefix.flags & 0x04) ? 6 : 4);
+  while (end - reader.pos() >= message_header_size) {
+    ObjectHeaderMessage message;
+    uint16_t size;
+    if (prefix.version == 1) {
+      if (!riegeli::ReadLittleEndian<uint16_t>(reader, message.type) ||
+          !riegeli::ReadLittleEndian<uint16_t>(reader, size) ||
+          !reader.ReadByte(message.flags) || !reader.Skip(3)) {
+        return false;
+      }
+    } else {
+      uint8_t type;
+      if (!reader.ReadByte(type) ||
+          !riegeli::ReadLittleEndian<uint16_t>(reader, size) ||
+          !reader.ReadByte(message.flags) ||
+          !reader.Skip(message_header_size - 4)) {
+        return false;
+      }
+      message.type = type;
+    }
+    if (size > end - reader.pos()) {
+      return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+          "Object header message of type ", message.type, " and size ", size,
+          " exceeds the object header block")));
+    }
+    if (!reader.Read(size, message.body)) return false;
+    if (message.type == kNilMessage) continue;
+    if (message.type == kContinuationMessage) {
+      riegeli::StringReader<> body_reader(message.body);
+      ObjectHeaderContinuation continuation;
+      if (!ReadAddress(body_reader, format, continuation.address) ||
+          !ReadLength(body_reader, format, continuation.length)) {
+        return reader.Fail(body_reader.status().ok()
+                               ? absl::DataLossError(
+                                     "Invalid continuation message")
+                               : body_reader.status());
+      }
+      block.continuations.push_back(continuation);
+      continue;
+    }
+    block.messages.push_back(std::move(message));
+  }
+  // Any remaining bytes are a gap too small to hold a message.
+  return reader.Seek(end);
+}
+
+}  // namespace
+
+Result<Superblock> DecodeSuperblock(std::string_view data, uint64_t offset) {
+  if (data.substr(0, kSuperblockSignature.size()) != kSuperblockSignature) {
+    return absl::NotFoundError("HDF5 superblock signature not found");
+  }
+  return DecodeStructure<Superblock>(
+      data.substr(0, kSuperblockReadSize), "superblock",
+      [&](riegeli::Reader& reader, Superblock& superblock) {
+        auto& format = superblock.format;
+        format.base_address = offset;
+        if (!reader.Skip(kSuperblockSignature.size()) ||
+            !ReadVersion(reader, 0, 3, superblock.version)) {
+          return false;
+        }
+        const auto read_sizes = [&] {
+          if (!reader.ReadByte(format.size_of_offsets) ||
+              !reader.ReadByte(format.size_of_lengths)) {
+            return false;
+          }
+          for (uint8_t size :
+               {format.size_of_offsets, format.size_of_lengths}) {
+            if (size != 2 && size != 4 && size != 8) {
+              return reader.Fail(absl::DataLossError(
+                  tensorstore::StrCat("Invalid size of offsets or lengths: ",
+                                      size)));
+            }
+          }
+          return true;
+        };
+        uint64_t base_address, free_space_address, driver_info_address;
+        if (superblock.version <= 1) {
+          // Free-space, root group symbol table entry, reserved and shared
+          // header message format versions.
+          if (!reader.Skip(4) || !read_sizes() || !reader.Skip(1) ||
+              !riegeli::ReadLittleEndian<uint16_t>(
+                  reader, superblock.group_leaf_node_k) ||
+              !riegeli::ReadLittleEndian<uint16_t>(
+                  reader, superblock.group_internal_node_k) ||
+              // File consistency flags.
+              !reader.Skip(4)) {
+            return false;
+          }
+          if (superblock.version == 1 &&
+              (!riegeli::ReadLittleEndian<uint16_t>(
+                   reader, format.indexed_storage_k) ||
+               !reader.Skip(2))) {
+            return false;
+          }
+          // The root group symbol table entry follows the addresses; only its
+          // object header address is required.
+          uint64_t link_name_offset;
+          if (!ReadAddress(reader, format, base_address) ||
+              !ReadAddress(reader, format, free_space_address) ||
+              !ReadAddress(reader, format, superblock.end_of_file_address) ||
+              !ReadAddress(reader, format, driver_info_address) ||
+              !ReadAddress(reader, format, link_name_offset) ||
+              !ReadAddress(reader, format,
+                           superblock.root_object_header_address)) {
+            return false;
+          }
+        } else {
+          // File consistency flags.
+          if (!read_sizes() || !reader.Skip(1) ||
+              !ReadAddress(reader, format, base_address) ||
+              !ReadAddress(reader, format, superblock.extension_address) ||
+              !ReadAddress(reader, format, superblock.end_of_file_address) ||
+              !ReadAddress(reader, format,
+                           superblock.root_object_header_address)) {
+            return false;
+          }
+          const size_t checksum_end = reader.pos() + 4;
+          if (checksum_end > data.size()) return false;
+          TENSORSTORE_RETURN_IF_ERROR(
+              ValidateChecksum(data.substr(0, checksum_end)),
+              reader.Fail(_));
+        }
+        if (superblock.group_leaf_node_k == 0 ||
+            superblock.group_internal_node_k == 0 ||
+            format.indexed_storage_k == 0) {
+          return reader.Fail(
+              absl::DataLossError("Invalid B-tree \"K\" value of 0"));
+        }
+        return true;
+      });
+}
+
+Result<size_t> GetObjectHeaderPrefixSize(std::string_view data) {
+  if (data.substr(0, 4) == "OHDR") {
+    if (data.size() < 6) {
+      return absl::DataLossError("Truncated HDF5 object header");
+    }
+    if (data[4] != 2) {
+      return absl::UnimplementedError(tensorstore::StrCat(
+          "HDF5 object header version ", static_cast<int>(data[4]),
+          " is not supported"));
+    }
+    const uint8_t flags = static_cast<uint8_t>(data[5]);
+    return size_t{6} + ((flags & 0x20) ? 16 : 0) + ((flags & 0x10) ? 4 : 0) +
+           (size_t{1} << (flags & 0x03));
+  }
+  if (!data.empty() && data[0] == 1) return size_t{16};
+  return absl::DataLossError("Invalid HDF5 object header");
+}
+
+Result<ObjectHeaderPrefix> DecodeObjectHeaderPrefix(std::string_view data) {
+  TENSORSTORE_ASSIGN_OR_RETURN(const size_t prefix_size,
+                               GetObjectHeaderPrefixSize(data));
+  if (data.size() < prefix_size) {
+    return absl::DataLossError("Truncated HDF5 object header");
+  }
+  ObjectHeaderPrefix prefix;
+  if (data[0] == 1) {
+    prefix.version = 1;
+    prefix.first_block_size =
+        prefix_size + LoadUnsignedInteger(data.data() + 8, 4);
+    return prefix;
+  }
+  prefix.version = 2;
+  prefix.flags = static_cast<uint8_t>(data[5]);
+  const size_t chunk_size_size = size_t{1} << (prefix.flags & 0x03);
+  prefix.first_block_size =
+      prefix_size +
+      LoadUnsignedInteger(data.data() + prefix_size - chunk_size_size,
+                          chunk_size_size) +
+      4;
+  return prefix;
+}
+
+Result<ObjectHeaderBlock> DecodeObjectHeaderBlock(
+    std::string_view data, const ObjectHeaderPrefix& prefix, bool first,
+    const FormatParameters& format) {
+  size_t begin = 0;
+  size_t end = data.size();
+  if (prefix.version == 2) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidateChecksum(data),
+        tensorstore::MaybeAnnotateStatus(_,
+                                         "Error decoding HDF5 object header"));
+    if (first) {
+      TENSORSTORE_ASSIGN_OR_RETURN(begin, GetObjectHeaderPrefixSize(data));
+    } else {
+      if (data.substr(0, 4) != "OCHK") {
+        return absl::DataLossError(
+            "Invalid HDF5 object header continuation block signature");
+      }
+      begin = 4;
+    }
+    end -= 4;
+  } else if (first) {
+    begin = 16;
+  }
+  if (begin > end) {
+    return absl::DataLossError("Truncated HDF5 object header");
+  }
+  return DecodeStructure<ObjectHeaderBlock>(
+      data.substr(0, end), "object header",
+      [&](riegeli::Reader& reader, ObjectHeaderBlock& block) {
+        return reader.Seek(begin) &&
+               ReadObjectHeaderMessages(reader, end, prefix, format, block);
+      });
+}
+
+Result<Dataspace> DecodeDataspaceMessage(std::string_view data,
+                                         const FormatParameters& format) {
+  return DecodeStructure<Dataspace>(
+      data, "dataspace message",
+      [&](riegeli::Reader& reader, Dataspace& dataspace) {
+        uint8_t version, rank, flags;
+        if (!ReadVersion(reader, 1, 2, version) || !reader.ReadByte(rank) ||
+            !reader.ReadByte(flags)) {
+          return false;
+        }
+        if (version == 1) {
+          if (!reader.Skip(5)) return false;
+        } else {
+          uint8_t type;
+          if (!reader.ReadByte(type)) return false;
+          if (type == 2) {
+            return reader.Fail(absl::UnimplementedError(
+                "Null dataspace is not supported"));
+          }
+        }
+        if (rank > kMaxRank) {
+          return reader.Fail(absl::UnimplementedError(tensorstore::StrCat(
+              "Rank ", rank, " exceeds maximum rank of ", kMaxRank)));
+        }
+        dataspace.shape.resize(rank);
+        for (auto& size : dataspace.shape) {
+          if (!ReadDimension(reader, format.size_of_lengths,
+                             /*allow_unlimited=*/false, size)) {
+            return false;
+          }
+        }
+        if (!(flags & 0x01)) {
+          dataspace.max_shape = dataspace.shape;
+          return true;
+        }
+        dataspace.max_shape.resize(rank);
+        for (auto& size : dataspace.max_shape) {
+          if (!ReadDimension(reader, format.size_of_lengths,
+                             /*allow_unlimited=*/true, size)) {
+            return false;
+          }
+        }
+        return true;
+      });
+}
+
+Result<Datatype> DecodeDatatypeMessage(std::string_view data) {
+  return DecodeStructure<Datatype>(
+      data, "datatype message", [&](riegeli::Reader& reader, Datatype& dtype) {
+        uint8_t class_and_version;
+        uint8_t bits[3];
+        uint32_t size;
+        if (!reader.ReadByte(class_and_version) || !reader.ReadByte(bits[0]) ||
+            !reader.ReadByte(bits[1]) || !reader.ReadByte(bits[2]) ||
+            !riegeli::ReadLittleEndian<uint32_t>(reader, size)) {
+          return false;
+        }
+        // Only the fixed-point (0) and floating-point (1) classes are
+        // supported.
+        const uint8_t type_class = class_and_version & 0x0f;
+        if (type_class > 1) {
+          return reader.Fail(absl::UnimplementedError(tensorstore::StrCat(
+              "Datatype class ", type_class, " is not supported")));
+        }
+        uint16_t bit_offset, precision;
+        if (!riegeli::ReadLittleEndian<uint16_t>(reader, bit_offset) ||
+            !riegeli::ReadLittleEndian<uint16_t>(reader, precision)) {
+          return false;
+        }
+        dtype.byte_order = (bits[0] & 0x01) ? endian::big : endian::little;
+        if (bit_offset != 0 || precision != 8 * size) {
+          return reader.Fail(absl::UnimplementedError(tensorstore::StrCat(
+              "Datatype with bit offset ", bit_offset, " and precision ",
+              precision, " is not supported")));
+        }
+        if (type_class == 0) {
+          // Fixed-point.
+          const bool is_signed = bits[0] & 0x08;
+          switch (size) {
+            case 1:
+              dtype.dtype = is_signed ? DataType(dtype_v<int8_t>)
+                                  : DataType(dtype_v<uint8_t>);
+              return true;
+            case 2:
+              dtype.dtype = is_signed ? DataType(dtype_v<int16_t>)
+                                  : DataType(dtype_v<uint16_t>);
+              return true;
+            case 4:
+              dtype.dtype = is_signed ? DataType(dtype_v<int32_t>)
+                                  : DataType(dtype_v<uint32_t>);
+              return true;
+            case 8:
+              dtype.dtype = is_signed ? DataType(dtype_v<int64_t>)
+                                  : DataType(dtype_v<uint64_t>);
+              return true;
+          }
+          return reader.Fail(absl::UnimplementedError(tensorstore::StrCat(
+              "Integer datatype of size ", size, " is not supported")));
+        }
+        // Floating-point.  Only the IEEE 754 binary32 and binary64 formats
+        // are supported.
+        uint8_t exponent_location, exponent_size, mantissa_location,
+            mantissa_size;
+        uint32_t exponent_bias;
+        if (!reader.ReadByte(exponent_location) ||
+            !reader.ReadByte(exponent_size) ||
+            !reader.ReadByte(mantissa_location) ||
+            !reader.ReadByte(mantissa_size) ||
+            !riegeli::ReadLittleEndian<uint32_t>(reader, exponent_bias)) {
+          return false;
+        }
+        const auto matches = [&](uint8_t e_loc, uint8_t e_size,
+                                 uint8_t m_size, uint32_t bias) {
+          return (bits[0] & 0x40) == 0 && ((bits[0] >> 4) & 0x03) == 2 &&
+                 bits[1] == size * 8 - 1 && exponent_location == e_loc &&
+                 exponent_size == e_size && mantissa_location == 0 &&
+                 mantissa_size == m_size && exponent_bias == bias;
+        };
+        if (size == 4 && matches(23, 8, 23, 127)) {
+          dtype.dtype = dtype_v<float>;
+          return true;
+        }
+        if (size == 8 && matches(52, 11, 52, 1023)) {
+          dtype.dtype = dtype_v<double>;
+          return true;
+        }
+        return reader.Fail(absl::UnimplementedError(tensorstore::StrCat(
+            "Non-IEEE floating-point datatype of size ", size,
+            " is not supported")));
+      });
+}
+
+Result<DataLayoutMessage> DecodeDataLayoutMessage(
+    std::string_view data, const FormatParameters& format) {
+  return DecodeStructure<DataLayoutMessage>(
+      data, "data layout message",
+      [&](riegeli::Reader& reader, DataLayoutMessage& message) {
+        auto& layout = message.layout;
+        uint8_t version, layout_class, dimensionality = 0;
+        if (!ReadVersion(reader, 1, 4, version)) return false;
+        if (version <= 2) {
+          if (!reader.ReadByte(dimensionality) ||
+              !reader.ReadByte(layout_class) || !reader.Skip(5)) {
+            return false;
+          }
+        } else if (!reader.ReadByte(layout_class)) {
+          return false;
+        }
+        switch (layout_class) {
+          case static_cast<uint8_t>(LayoutClass::kCompact): {
+            layout.layout_class = LayoutClass::kCompact;
+            // Version 1 and 2 messages also specify the dataset dimensions,
+            // which are redundant with the dataspace message.
+            if (version <= 2 && !reader.Skip(dimensionality * 4)) {
+              return false;
+            }
+            uint64_t size;
+            if (!ReadUnsignedInteger(reader, version <= 2 ? 4 : 2, size) ||
+                !reader.Read(size, layout.compact_data)) {
+              return false;
+            }
+            layout.size = size;
+            return true;
+          }
+          case static_cast<uint8_t>(LayoutClass::kContiguous):
+            layout.layout_class = LayoutClass::kContiguous;
+            if (!ReadAddress(reader, format, layout.address)) return false;
+            if (version <= 2) {
+              // The size is not recorded, and must be computed from the
+              // dataspace and datatype.
+              return reader.Skip(dimensionality * 4);
+            }
+            return ReadLength(reader, format, layout.size);
+          case static_cast<uint8_t>(LayoutClass::kChunked):
+            layout.layout_class = LayoutClass::kChunked;
+            break;
+          default:
+            return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+                "Invalid layout class: ", layout_class)));
+        }
+        uint8_t chunk_flags = 0;
+        size_t dimension_size = 4;
+        if (version <= 2) {
+          if (!ReadAddress(reader, format, layout.address)) return false;
+        } else if (version == 3) {
+          if (!reader.ReadByte(dimensionality) ||
+              !ReadAddress(reader, format, layout.address)) {
+            return false;
+          }
+        } else {
+          uint8_t encoded_dimension_size;
+          if (!reader.ReadByte(chunk_flags) ||
+              !reader.ReadByte(dimensionality) ||
+              !reader.ReadByte(encoded_dimension_size)) {
+            return false;
+          }
+          if (encoded_dimension_size < 1 || encoded_dimension_size > 8) {
+            return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+                "Invalid chunk dimension size encoding: ",
+                encoded_dimension_size)));
+          }
+          dimension_size = encoded_dimension_size;
+        }
+        // The final dimension is the size of the datatype.
+        if (dimensionality < 2 || dimensionality > kMaxRank + 1) {
+          return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+              "Invalid chunk dimensionality: ", dimensionality)));
+        }
+        message.chunk_shape.resize(dimensionality - 1);
+        for (auto& size : message.chunk_shape) {
+          if (!ReadDimension(reader, dimension_size,
+                             /*allow_unlimited=*/false, size)) {
+            return false;
+          }
+          if (size == 0) {
+            return reader.Fail(absl::DataLossError("Invalid chunk size of 0"));
+          }
+        }
+        if (!ReadUnsignedInteger(reader, dimension_size,
+                                 message.element_size)) {
+          return false;
+        }
+        if (version <= 3) {
+          layout.chunk_index_type = ChunkIndexType::kBtreeV1;
+          return true;
+        }
+        uint8_t index_type;
+        if (!reader.ReadByte(index_type)) return false;
+        switch (index_type) {
+          case static_cast<uint8_t>(ChunkIndexType::kSingleChunk):
+            if (chunk_flags & 0x02) {
+              uint64_t filtered_size;
+              if (!ReadLength(reader, format, filtered_size) ||
+                  !riegeli::ReadLittleEndian<uint32_t>(
+                      reader, layout.single_chunk_filter_mask)) {
+                return false;
+              }
+              layout.single_chunk_filtered_size = filtered_size;
+            }
+            break;
+          case static_cast<uint8_t>(ChunkIndexType::kImplicit):
+            break;
+          case static_cast<uint8_t>(ChunkIndexType::kFixedArray):
+            // Page bits.
+            if (!reader.Skip(1)) return false;
+            break;
+          case static_cast<uint8_t>(ChunkIndexType::kExtensibleArray):
+            // Maximum bits, index elements, minimum pointers, minimum
+            // elements and page bits.
+            if (!reader.Skip(5)) return false;
+            break;
+          case static_cast<uint8_t>(ChunkIndexType::kBtreeV2):
+            // Node size, split percent and merge percent.
+            if (!reader.Skip(6)) return false;
+            break;
+          default:
+            return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+                "Invalid chunk index type: ", index_type)));
+        }
+        layout.chunk_index_type = static_cast<ChunkIndexType>(index_type);
+        return ReadAddress(reader, format, layout.address);
+      });
+}
+
+Result<std::vector<FilterDescription>> DecodeFilterPipelineMessage(
+    std::string_view data) {
+  return DecodeStructure<std::vector<FilterDescription>>(
+      data, "filter pipeline message",
+      [&](riegeli::Reader& reader, std::vector<FilterDescription>& filters) {
+        uint8_t version, num_filters;
+        if (!ReadVersion(reader, 1, 2, version) ||
+            !reader.ReadByte(num_filters) ||
+            (version == 1 && !reader.Skip(6))) {
+          return false;
+        }
+        filters.resize(num_filters);
+        for (auto& filter : filters) {
+          uint16_t name_length = 0, num_client_data;
+          if (!riegeli::ReadLittleEndian<uint16_t>(reader, filter.id)) {
+            return false;
+          }
+          if ((version == 1 || filter.id >= 256) &&
+              !riegeli::ReadLittleEndian<uint16_t>(reader, name_length)) {
+            return false;
+          }
+          if (!riegeli::ReadLittleEndian<uint16_t>(reader, filter.flags) ||
+              !riegeli::ReadLittleEndian<uint16_t>(reader, num_client_data) ||
+              !reader.Read(name_length, filter.name)) {
+            return false;
+          }
+          // The name is null-terminated, and in version 1 padded to a
+          // multiple of 8 bytes.
+          if (const size_t end = filter.name.find('\0');
+              end != std::string::npos) {
+            filter.name.resize(end);
+          }
+          filter.client_data.resize(num_client_data);
+          for (auto& value : filter.client_data) {
+            if (!riegeli::ReadLittleEndian<uint32_t>(reader, value)) {
+              return false;
+            }
+          }
+          if (version == 1 && (num_client_data % 2) && !reader.Skip(4)) {
+            return false;
+          }
+        }
+        return true;
+      });
+}
+
+Result<SymbolTableMessage> DecodeSymbolTableMessage(
+    std::string_view data, const FormatParameters& format) {
+  return DecodeStructure<SymbolTableMessage>(
+      data, "symbol table message",
+      [&](riegeli::Reader& reader, SymbolTableMessage& message) {
+        return ReadAddress(reader, format, message.btree_address) &&
+               ReadAddress(reader, format, message.heap_address);
+      });
+}
+
+Result<LinkMessage> DecodeLinkMessage(std::string_view data,
+                                      const FormatParameters& format) {
+  return DecodeStructure<LinkMessage>(
+      data, "link message", [&](riegeli::Reader& reader, LinkMessage& link) {
+        uint8_t version, flags;
+        if (!ReadVersion(reader, 1, 1, version) || !reader.ReadByte(flags)) {
+          return false;
+        }
+        uint8_t type = 0;
+        uint64_t name_length;
+        if (((flags & 0x08) && !reader.ReadByte(type)) ||
+            // Creation order.
+            ((flags & 0x04) && !reader.Skip(8)) ||
+            // Character set.
+            ((flags & 0x10) && !reader.Skip(1)) ||
+            !ReadUnsignedInteger(reader, size_t{1} << (flags & 0x03),
+                                 name_length) ||
+            !reader.Read(name_length, link.name)) {
+          return false;
+        }
+        link.type = static_cast<LinkType>(type);
+        if (link.type == LinkType::kHard) {
+          return ReadAddress(reader, format, link.address);
+        }
+        return true;
+      });
+}
+
+Result<LinkInfoMessage> DecodeLinkInfoMessage(std::string_view data,
+                                              const FormatParameters& format) {
+  return DecodeStructure<LinkInfoMessage>(
+      data, "link info message",
+      [&](riegeli::Reader& reader, LinkInfoMessage& message) {
+        uint8_t version, flags;
+        if (!ReadVersion(reader, 0, 0, version) || !reader.ReadByte(flags) ||
+            // Maximum creation index.
+            ((flags & 0x01) && !reader.Skip(8))) {
+          return false;
+        }
+        return ReadAddress(reader, format, message.fractal_heap_address);
+      });
+}
+
+absl::Status DecodeBtreeKValuesMessage(std::string_view data,
+                                       Superblock& superblock) {
+  struct KValues {
+    uint16_t indexed_storage_k, group_internal_node_k, group_leaf_node_k;
+  };
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto k_values,
+      DecodeStructure<KValues>(
+          data, "B-tree K values message",
+          [&](riegeli::Reader& reader, KValues& k) {
+            uint8_t version;
+            return ReadVersion(reader, 0, 0, version) &&
+                   riegeli::ReadLittleEndian<uint16_t>(reader,
+                                                       k.indexed_storage_k) &&
+                   riegeli::ReadLittleEndian<uint16_t>(
+                       reader, k.group_internal_node_k) &&
+                   riegeli::ReadLittleEndian<uint16_t>(reader,
+                                                       k.group_leaf_node_k);
+          }));
+  if (k_values.indexed_storage_k == 0 || k_values.group_internal_node_k == 0 ||
+      k_values.group_leaf_node_k == 0) {
+    return absl::DataLossError("Invalid B-tree \"K\" value of 0");
+  }
+  superblock.format.indexed_storage_k = k_values.indexed_storage_k;
+  superblock.group_internal_node_k = k_values.group_internal_node_k;
+  superblock.group_leaf_node_k = k_values.group_leaf_node_k;
+  return absl::OkStatus();
+}
+
+uint64_t GetLocalHeapSize(const FormatParameters& format) {
+  return 8 + 2 * format.size_of_lengths + format.size_of_offsets;
+}
+
+Result<LocalHeap> DecodeLocalHeap(std::string_view data,
+                                  const FormatParameters& format) {
+  return DecodeStructure<LocalHeap>(
+      data, "local heap", [&](riegeli::Reader& reader, LocalHeap& heap) {
+        uint8_t version;
+        uint64_t free_list_offset;
+        return ReadSignature(reader, "HEAP") &&
+               ReadVersion(reader, 0, 0, version) && reader.Skip(3) &&
+               ReadLength(reader, format, heap.data_segment_size) &&
+               ReadLength(reader, format, free_list_offset) &&
+               ReadAddress(reader, format, heap.data_segment_address);
+      });
+}
+
+Result<std::string_view> GetLocalHeapString(std::string_view data_segment,
+                                            uint64_t offset) {
+  const size_t end = offset < data_segment.size()
+                         ? data_segment.find('\0', offset)
+                         : std::string_view::npos;
+  if (end == std::string_view::npos) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Invalid HDF5 local heap string offset: ", offset));
+  }
+  return data_segment.substr(offset, end - offset);
+}
+
+uint64_t GetBtreeV1GroupNodeSize(const Superblock& superblock) {
+  const auto& format = superblock.format;
+  const uint64_t max_children = 2 * uint64_t{superblock.group_internal_node_k};
+  return 8 + 2 * format.size_of_offsets +
+         max_children * format.size_of_offsets +
+         (max_children + 1) * format.size_of_lengths;
+}
+
+Result<BtreeV1GroupNode> DecodeBtreeV1GroupNode(std::string_view data,
+                                                const Superblock& superblock) {
+  const auto& format = superblock.format;
+  return DecodeStructure<BtreeV1GroupNode>(
+      data, "group B-tree node",
+      [&](riegeli::Reader& reader, BtreeV1GroupNode& node) {
+        uint8_t node_type;
+        uint16_t entries_used;
+        uint64_t left_sibling, right_sibling;
+        if (!ReadSignature(reader, "TREE") || !reader.ReadByte(node_type) ||
+            !reader.ReadByte(node.level) ||
+            !riegeli::ReadLittleEndian<uint16_t>(reader, entries_used) ||
+            !ReadAddress(reader, format, left_sibling) ||
+            !ReadAddress(reader, format, right_sibling)) {
+          return false;
+        }
+        if (node_type != 0) {
+          return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+              "Expected B-tree node type 0 but received ", node_type)));
+        }
+        if (entries_used > 2 * superblock.group_internal_node_k) {
+          return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+              "B-tree node has ", entries_used,
+              " entries, but at most 2*K=",
+              2 * superblock.group_internal_node_k, " are permitted")));
+        }
+        node.keys.resize(entries_used + 1);
+        node.children.resize(entries_used);
+        for (uint16_t i = 0; i < entries_used; ++i) {
+          if (!ReadLength(reader, format, node.keys[i]) ||
+              !ReadAddress(reader, format, node.children[i])) {
+            return false;
+          }
+        }
+        return ReadLength(reader, format, node.keys[entries_used]);
+      });
+}
+
+uint64_t GetSymbolTableNodeSize(const Superblock& superblock) {
+  return 8 + 2 * uint64_t{superblock.group_leaf_node_k} *
+                 (2 * superblock.format.size_of_offsets + 24);
+}
+
+Result<std::vector<SymbolTableEntry>> DecodeSymbolTableNode(
+    std::string_view data, const Superblock& superblock) {
+  const auto& format = superblock.format;
+  return DecodeStructure<std::vector<SymbolTableEntry>>(
+      data, "symbol table node",
+      [&](riegeli::Reader& reader, std::vector<SymbolTableEntry>& entries) {
+        uint8_t version;
+        uint16_t num_symbols;
+        if (!ReadSignature(reader, "SNOD") ||
+            !ReadVersion(reader, 1, 1, version) || !reader.Skip(1) ||
+            !riegeli::ReadLittleEndian<uint16_t>(reader, num_symbols)) {
+          return false;
+        }
+        if (num_symbols > 2 * superblock.group_leaf_node_k) {
+          return reader.Fail(absl::DataLossError(tensorstore::StrCat(
+              "Symbol table node has ", num_symbols,
+              " entries, but at most 2*K=", 2 * superblock.group_leaf_node_k,
+              " are permitted")));
+        }
+        entries.resize(num_symbols);
+        for (auto& entry : entries) {
+          // Cache type, reserved and scratch-pad space.
+          if (!ReadAddress(reader, format, entry.name_offset) ||
+              !ReadAddress(reader, format, entry.object_header_address) ||
+              !reader.Skip(24)) {
+            return false;
+          }
+        }
+        return true;
+      });
+}
+
+absl::Cord EncodeDatasetObjectHeader(const DatasetObjectHeader& header) {
+  std::string out;
+  AppendUnsignedInteger(out, 1, header.format.size_of_offsets);
+  AppendUnsignedInteger(out, 1, header.format.size_of_lengths);
+  AppendUnsignedInteger(out, 2, header.format.indexed_storage_k);
+  AppendUnsignedInteger(out, 8, header.format.base_address);
+  AppendUnsignedInteger(out, 4, header.messages.size());
+  for (const auto& message : header.messages) {
+    AppendUnsignedInteger(out, 2, message.type);
+    AppendUnsignedInteger(out, 1, message.flags);
+    AppendUnsignedInteger(out, 4, message.body.size());
+    out += message.body;
+  }
+  return absl::Cord(std::move(out));
+}
+
+Result<DatasetObjectHeader> DecodeDatasetObjectHeader(
+    const absl::Cord& encoded) {
+  DatasetObjectHeader header;
+  riegeli::CordReader<const absl::Cord*> reader(&encoded);
+  const auto decode = [&]() -> bool {
+    auto& format = header.format;
+    uint32_t num_messages;
+    if (!reader.ReadByte(format.size_of_offsets) ||
+        !reader.ReadByte(format.size_of_lengths) ||
+        !riegeli::ReadLittleEndian<uint16_t>(reader,
+                                             format.indexed_storage_k) ||
+        !riegeli::ReadLittleEndian<uint64_t>(reader, format.base_address) ||
+        !riegeli::ReadLittleEndian<uint32_t>(reader, num_messages)) {
+      return false;
+    }
+    header.messages.resize(num_messages);
+    for (auto& message : header.messages) {
+      uint32_t size;
+      if (!riegeli::ReadLittleEndian<uint16_t>(reader, message.type) ||
+          !reader.ReadByte(message.flags) ||
+          !riegeli::ReadLittleEndian<uint32_t>(reader, size) ||
+          !reader.Read(size, message.body)) {
+        return false;
+      }
+    }
+    return reader.VerifyEndAndClose();
+  };
+  if (!decode()) {
+    absl::Status status = reader.status();
+    if (status.ok()) {
+      status = absl::DataLossError("Unexpected end of data");
+    }
+    return tensorstore::MaybeAnnotateStatus(
+        status, "Error decoding HDF5 dataset object header");
+  }
+  return header;
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,317 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_H_
+#define TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_H_
+
+/// \file
+///
+/// Decoding of the superblock, object headers, and the object header messages
+/// and group structures required to locate and open a dataset.
+///
+/// Reading these structures from storage is implemented by
+/// `object_header_store.h`.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Number of bytes that suffice to decode any supported superblock version
+/// with 8-byte offsets and lengths.
+constexpr size_t kSuperblockReadSize = 100;
+
+/// Decoded representation of the superblock.
+struct Superblock {
+  uint8_t version = 0;
+
+  /// File-wide format parameters.  The `indexed_storage_k` value of version 2
+  /// and 3 superblocks is specified by the superblock extension, and is the
+  /// default of 32 until the extension has been read.
+  FormatParameters format;
+
+  /// Node "K" values of version 1 B-trees that index groups.
+  uint16_t group_leaf_node_k = 4;
+  uint16_t group_internal_node_k = 16;
+
+  /// Address of the superblock extension object header, or
+  /// `kUndefinedAddress`.
+  uint64_t extension_address = kUndefinedAddress;
+
+  uint64_t end_of_file_address = kUndefinedAddress;
+
+  /// Address of the object header of the root group.
+  uint64_t root_object_header_address = kUndefinedAddress;
+};
+
+/// Decodes a superblock found at absolute file offset `offset`.
+///
+/// \param data The bytes starting at `offset`, of which at most
+///     `kSuperblockReadSize` are used.
+/// \error `absl::StatusCode::kNotFound` if `data` does not start with the
+///     superblock signature.
+Result<Superblock> DecodeSuperblock(std::string_view data, uint64_t offset);
+
+/// Object header message types.
+enum ObjectHeaderMessageType : uint16_t {
+  kNilMessage = 0x0000,
+  kDataspaceMessage = 0x0001,
+  kLinkInfoMessage = 0x0002,
+  kDatatypeMessage = 0x0003,
+  kLinkMessage = 0x0006,
+  kDataLayoutMessage = 0x0008,
+  kFilterPipelineMessage = 0x000b,
+  kContinuationMessage = 0x0010,
+  kSymbolTableMessage = 0x0011,
+  kBtreeKValuesMessage = 0x0013,
+};
+
+/// Flag bit of an object header message indicating that the message is shared,
+/// and its body is a reference to the shared message.
+constexpr uint8_t kSharedMessageFlag = 0x02;
+
+struct ObjectHeaderMessage {
+  uint16_t type = kNilMessage;
+  uint8_t flags = 0;
+  std::string body;
+};
+
+/// Location of an object header continuation block.
+struct ObjectHeaderContinuation {
+  uint64_t address = kUndefinedAddress;
+  uint64_t length = 0;
+};
+
+/// Messages and continuations decoded from a single object header block.
+struct ObjectHeaderBlock {
+  std::vector<ObjectHeaderMessage> messages;
+  std::vector<ObjectHeaderContinuation> continuations;
+};
+
+/// Number of bytes that suffice to determine the prefix size of an object
+/// header with `GetObjectHeaderPrefixSize`.
+constexpr size_t kObjectHeaderMinReadSize = 16;
+
+/// Returns the size of the prefix of the object header that starts with
+/// `data`.
+///
+/// \param data At least the first 6 bytes of the object header.
+Result<size_t> GetObjectHeaderPrefixSize(std::string_view data);
+
+/// Prefix of an object header.
+struct ObjectHeaderPrefix {
+  /// Object header version, either `1` or `2`.
+  uint8_t version = 0;
+
+  /// Version 2 object header flags.
+  uint8_t flags = 0;
+
+  /// Total size of the first object header block, including the prefix and
+  /// the checksum.
+  uint64_t first_block_size = 0;
+};
+
+/// Decodes the object header prefix `data`, of the size returned by
+/// `GetObjectHeaderPrefixSize`.
+Result<ObjectHeaderPrefix> DecodeObjectHeaderPrefix(std::string_view data);
+
+/// Decodes the messages of an object header block.
+///
+/// \param data The complete block: the first block, of size
+///     `prefix.first_block_size`, if `first` is `true`, and otherwise a
+///     continuation block.
+Result<ObjectHeaderBlock> DecodeObjectHeaderBlock(
+    std::string_view data, const ObjectHeaderPrefix& prefix, bool first,
+    const FormatParameters& format);
+
+/// Decoded dataspace message.
+struct Dataspace {
+  std::vector<Index> shape;
+
+  /// Maximum shape, with `kInfSize` indicating an unlimited dimension.
+  std::vector<Index> max_shape;
+};
+
+Result<Dataspace> DecodeDataspaceMessage(std::string_view data,
+                                         const FormatParameters& format);
+
+/// Decoded datatype message.
+struct Datatype {
+  DataType dtype;
+  endian byte_order = endian::little;
+};
+
+/// Decodes a datatype message of the fixed-point or IEEE floating-point
+/// class.
+///
+/// \error `absl::StatusCode::kUnimplemented` for other datatypes.
+Result<Datatype> DecodeDatatypeMessage(std::string_view data);
+
+/// Decoded data layout message.
+struct DataLayoutMessage {
+  DataLayout layout;
+
+  /// Chunk shape of the chunked layout, excluding the trailing datatype
+  /// dimension.  Empty for the contiguous and compact layouts.
+  std::vector<Index> chunk_shape;
+
+  /// Element size specified by the trailing datatype dimension of the chunked
+  /// layout.
+  uint64_t element_size = 0;
+};
+
+Result<DataLayoutMessage> DecodeDataLayoutMessage(
+    std::string_view data, const FormatParameters& format);
+
+/// Filter of a filter pipeline message.
+struct FilterDescription {
+  /// Filter identification value, e.g. `1` for deflate.
+  uint16_t id = 0;
+
+  /// Bit `0` indicates that the filter is optional.
+  uint16_t flags = 0;
+
+  std::string name;
+
+  /// Filter-specific parameters.
+  std::vector<uint32_t> client_data;
+};
+
+Result<std::vector<FilterDescription>> DecodeFilterPipelineMessage(
+    std::string_view data);
+
+/// Decoded symbol table message of an "old-style" group.
+struct SymbolTableMessage {
+  /// Address of the version 1 B-tree that indexes the group members.
+  uint64_t btree_address = kUndefinedAddress;
+
+  /// Address of the local heap that stores the member names.
+  uint64_t heap_address = kUndefinedAddress;
+};
+
+Result<SymbolTableMessage> DecodeSymbolTableMessage(
+    std::string_view data, const FormatParameters& format);
+
+/// Link types of a link message.
+enum class LinkType : uint8_t {
+  kHard = 0,
+  kSoft = 1,
+  kExternal = 64,
+};
+
+/// Decoded link message of a "new-style" group with compact storage.
+struct LinkMessage {
+  LinkType type = LinkType::kHard;
+  std::string name;
+
+  /// Object header address of the target of a hard link.
+  uint64_t address = kUndefinedAddress;
+};
+
+Result<LinkMessage> DecodeLinkMessage(std::string_view data,
+                                      const FormatParameters& format);
+
+/// Decoded link info message of a "new-style" group.
+struct LinkInfoMessage {
+  /// Address of the fractal heap that stores the links of a group with dense
+  /// storage, or `kUndefinedAddress` for compact storage.
+  uint64_t fractal_heap_address = kUndefinedAddress;
+};
+
+Result<LinkInfoMessage> DecodeLinkInfoMessage(std::string_view data,
+                                              const FormatParameters& format);
+
+/// Decodes the version 1 B-tree "K" values message of the superblock
+/// extension, and updates `superblock` accordingly.
+absl::Status DecodeBtreeKValuesMessage(std::string_view data,
+                                       Superblock& superblock);
+
+/// Header of a local heap.
+struct LocalHeap {
+  uint64_t data_segment_size = 0;
+  uint64_t data_segment_address = kUndefinedAddress;
+};
+
+/// Returns the encoded size of a local heap header.
+uint64_t GetLocalHeapSize(const FormatParameters& format);
+
+Result<LocalHeap> DecodeLocalHeap(std::string_view data,
+                                  const FormatParameters& format);
+
+/// Returns the null-terminated string at `offset` within the local heap data
+/// segment `data_segment`.
+Result<std::string_view> GetLocalHeapString(std::string_view data_segment,
+                                            uint64_t offset);
+
+/// Version 1 B-tree node of a group (node type 0).
+struct BtreeV1GroupNode {
+  uint8_t level = 0;
+
+  /// Local heap offsets of the member names that bound each child.  Child `i`
+  /// contains the names greater than key `i` and less than or equal to key
+  /// `i + 1`.
+  std::vector<uint64_t> keys;
+
+  /// Addresses of the child nodes, or of the symbol table nodes if `level`
+  /// is `0`.
+  std::vector<uint64_t> children;
+};
+
+/// Returns the encoded size of a version 1 B-tree group node.
+uint64_t GetBtreeV1GroupNodeSize(const Superblock& superblock);
+
+Result<BtreeV1GroupNode> DecodeBtreeV1GroupNode(std::string_view data,
+                                                const Superblock& superblock);
+
+/// Entry of a symbol table node.
+struct SymbolTableEntry {
+  /// Local heap offset of the member name.
+  uint64_t name_offset = 0;
+  uint64_t object_header_address = kUndefinedAddress;
+};
+
+/// Returns the encoded size of a symbol table node.
+uint64_t GetSymbolTableNodeSize(const Superblock& superblock);
+
+Result<std::vector<SymbolTableEntry>> DecodeSymbolTableNode(
+    std::string_view data, const Superblock& superblock);
+
+/// Object header messages of a dataset, together with the format parameters
+/// required to interpret them.
+struct DatasetObjectHeader {
+  FormatParameters format;
+  std::vector<ObjectHeaderMessage> messages;
+};
+
+absl::Cord EncodeDatasetObjectHeader(const DatasetObjectHeader& header);
+
+Result<DatasetObjectHeader> DecodeDatasetObjectHeader(
+    const absl::Cord& encoded);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_H_
@@ -0,0 +1,563 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/object_header_store.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/time.h"
+#include "tensorstore/driver/hdf5/file_metadata_cache.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+namespace {
+
+/// Maximum number of object header blocks of a single object, as a safeguard
+/// against cyclic continuation messages.
+constexpr size_t kMaxObjectHeaderBlocks = 4096;
+
+Result<std::pair<std::string_view, std::string_view>> DecodeObjectHeaderKey(
+    std::string_view key) {
+  // Dataset paths cannot contain null characters.
+  const size_t separator = key.rfind('\0');
+  if (separator == std::string_view::npos) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Invalid HDF5 dataset key: ",
+                            tensorstore::QuoteString(key)));
+  }
+  return std::pair(key.substr(0, separator), key.substr(separator + 1));
+}
+
+/// Asynchronous state of a read of a dataset object header.
+///
+/// Each structure is read through the `FileMetadataCache` of the file, and
+/// handled by a continuation that either completes the read or requests the
+/// next structure.
+class ResolveState : public internal::AtomicReferenceCount<ResolveState> {
+ public:
+  using Ptr = internal::IntrusivePtr<ResolveState>;
+
+  /// Handles the bytes of a structure that has been read.
+  using Continuation = void (*)(Ptr self, std::string_view data);
+
+  /// Handles a complete object header in `messages_`.
+  using ObjectHeaderCallback = void (*)(Ptr self);
+
+  internal::CachePtr<FileMetadataCache> cache_;
+  std::string dataset_path_;
+  std::vector<std::string> components_;
+  kvstore::ReadOptions options_;
+  Promise<kvstore::ReadResult> promise_;
+
+  /// Generation at which all structures are read.  Unknown until the first
+  /// read completes.
+  TimestampedStorageGeneration stamp_;
+
+  uint64_t superblock_offset_ = 0;
+  Superblock superblock_;
+
+  /// Number of path components that have been resolved.
+  size_t num_resolved_ = 0;
+
+  // State of the object header read.
+  uint64_t object_header_address_ = kUndefinedAddress;
+  ObjectHeaderPrefix prefix_;
+  std::vector<ObjectHeaderMessage> messages_;
+  std::deque<ObjectHeaderContinuation> pending_continuations_;
+  size_t num_blocks_ = 0;
+  ObjectHeaderCallback on_object_header_ = nullptr;
+
+  // State of the lookup within an "old-style" group.
+  SymbolTableMessage symbol_table_;
+  std::string heap_data_;
+  int group_node_level_ = -1;
+
+  const FormatParameters& format() const { return superblock_.format; }
+  const std::string& component() const { return components_[num_resolved_]; }
+
+  /// Returns the path of the first `n` components.
+  std::string GetPath(size_t n) const {
+    return absl::StrJoin(components_.begin(), components_.begin() + n, "/");
+  }
+
+  static void Start(Ptr self) {
+    self->stamp_ = TimestampedStorageGeneration{};
+    self->superblock_offset_ = 0;
+    self->num_resolved_ = 0;
+    ReadBytes(std::move(self), 0, kSuperblockReadSize, &OnSuperblock);
+  }
+
+  /// Reads `size` bytes at absolute file offset `offset`.
+  ///
+  /// The first read, of the superblock, is subject to the staleness bound of
+  /// the request.  Once the generation of the file is known, any cached
+  /// structure at the same generation is used regardless of its age.
+  static void ReadBytes(Ptr self, uint64_t offset, uint64_t size,
+                        Continuation continuation) {
+    const absl::Time staleness_bound =
+        StorageGeneration::IsUnknown(self->stamp_.generation)
+            ? self->options_.staleness_bound
+            : absl::InfinitePast();
+    ReadBlock(std::move(self), offset, size, continuation, staleness_bound);
+  }
+
+  static void ReadBlock(Ptr self, uint64_t offset, uint64_t size,
+                        Continuation continuation,
+                        absl::Time staleness_bound) {
+    if (!self->promise_.result_needed()) return;
+    auto entry = GetCacheEntry(self->cache_,
+                               FileMetadataCache::EncodeBlockKey(offset, size));
+    internal::AsyncCache::AsyncCacheReadRequest request;
+    request.staleness_bound = staleness_bound;
+    request.batch = self->options_.batch;
+    auto* entry_ptr = entry.get();
+    entry_ptr->Read(request).ExecuteWhenReady(
+        [self = std::move(self), entry = std::move(entry), offset, size,
+         continuation](ReadyFuture<const void> future) mutable {
+          OnBlockReady(std::move(self), *entry, future.result(), offset, size,
+                       continuation);
+        });
+  }
+
+  /// Reads `size` bytes at `address`, relative to the base address.
+  static void ReadAddress(Ptr self, uint64_t address, uint64_t size,
+                          Continuation continuation) {
+    if (address == kUndefinedAddress) {
+      self->Fail(absl::DataLossError("Unexpected undefined address"));
+      return;
+    }
+    const uint64_t offset = self->format().base_address + address;
+    ReadBytes(std::move(self), offset, size, continuation);
+  }
+
+  static void OnBlockReady(Ptr self, FileMetadataCache::Entry& entry,
+                           const Result<void>& result, uint64_t offset,
+                           uint64_t size, Continuation continuation) {
+    if (!result.ok()) {
+      if (continuation == &OnSuperblock && self->superblock_offset_ != 0 &&
+          absl::IsOutOfRange(result.status())) {
+        self->Fail(absl::FailedPreconditionError("Not an HDF5 file"));
+        return;
+      }
+      self->Fail(result.status());
+      return;
+    }
+    std::shared_ptr<const absl::Cord> block;
+    TimestampedStorageGeneration stamp;
+    {
+      internal::AsyncCache::ReadLock<absl::Cord> lock(entry);
+      block = lock.shared_data();
+      stamp = lock.stamp();
+    }
+    auto& self_stamp = self->stamp_;
+    if (StorageGeneration::IsUnknown(self_stamp.generation)) {
+      self_stamp = stamp;
+      if (!self->options_.generation_conditions.Matches(stamp.generation)) {
+        self->promise_.SetResult(
+            kvstore::ReadResult::Unspecified(std::move(stamp)));
+        return;
+      }
+      if (!block) {
+        // The file does not exist.
+        self->Missing();
+        return;
+      }
+    } else if (stamp.generation != self_stamp.generation) {
+      if (stamp.time < self_stamp.time) {
+        // The cached structure predates the first read.  Revalidate it.
+        const absl::Time staleness_bound = self_stamp.time;
+        ReadBlock(std::move(self), offset, size, continuation,
+                  staleness_bound);
+        return;
+      }
+      // The file was modified or deleted since the first read.  Restart.
+      self->options_.staleness_bound = stamp.time;
+      Start(std::move(self));
+      return;
+    } else {
+      self_stamp.time = std::max(self_stamp.time, stamp.time);
+    }
+    continuation(std::move(self), *block->TryFlat());
+  }
+
+  void Fail(absl::Status status) {
+    promise_.SetResult(tensorstore::MaybeAnnotateStatus(
+        std::move(status),
+        tensorstore::StrCat("Error reading HDF5 dataset ",
+                            tensorstore::QuoteString(dataset_path_))));
+  }
+
+  void Missing() {
+    promise_.SetResult(kvstore::ReadResult::Missing(std::move(stamp_)));
+  }
+
+  static void OnSuperblock(Ptr self, std::string_view data) {
+    auto superblock = DecodeSuperblock(data, self->superblock_offset_);
+    if (absl::IsNotFound(superblock.status())) {
+      // The superblock may follow a user block with a size that is a power of
+      // 2 of at least 512 bytes.
+      self->superblock_offset_ = std::max<uint64_t>(
+          512, self->superblock_offset_ * 2);
+      const uint64_t offset = self->superblock_offset_;
+      ReadBytes(std::move(self), offset, kSuperblockReadSize, &OnSuperblock);
+      return;
+    }
+    TENSORSTORE_RETURN_IF_ERROR(superblock, self->Fail(_));
+    self->superblock_ = *std::move(superblock);
+    if (self->superblock_.extension_address != kUndefinedAddress) {
+      const uint64_t address = self->superblock_.extension_address;
+      ReadObjectHeader(std::move(self), address, &OnSuperblockExtension);
+      return;
+    }
+    ReadRootGroup(std::move(self));
+  }
+
+  static void OnSuperblockExtension(Ptr self) {
+    for (const auto& message : self->messages_) {
+      if (message.type != kBtreeKValuesMessage) continue;
+      TENSORSTORE_RETURN_IF_ERROR(
+          DecodeBtreeKValuesMessage(message.body, self->superblock_),
+          self->Fail(_));
+    }
+    ReadRootGroup(std::move(self));
+  }
+
+  static void ReadRootGroup(Ptr self) {
+    // Resume from the deepest object along the path whose address was
+    // memoized at the current generation, if any.
+    for (size_t n = self->components_.size(); n > 0; --n) {
+      if (auto address = self->cache_->GetMemoizedAddress(
+              self->stamp_.generation, self->GetPath(n))) {
+        self->num_resolved_ = n;
+        ReadObject(std::move(self), *address);
+        return;
+      }
+    }
+    const uint64_t address = self->superblock_.root_object_header_address;
+    ReadObject(std::move(self), address);
+  }
+
+  /// Reads the object header of the object at the next unresolved path
+  /// component.
+  static void ReadObject(Ptr self, uint64_t address) {
+    if (self->num_resolved_ == self->components_.size()) {
+      ReadObjectHeader(std::move(self), address, &OnDatasetObjectHeader);
+    } else {
+      ReadObjectHeader(std::move(self), address, &OnGroupObjectHeader);
+    }
+  }
+
+  static void ReadObjectHeader(Ptr self, uint64_t address,
+                               ObjectHeaderCallback on_object_header) {
+    self->object_header_address_ = address;
+    self->on_object_header_ = on_object_header;
+    self->messages_.clear();
+    self->pending_continuations_.clear();
+    self->num_blocks_ = 0;
+    ReadAddress(std::move(self), address, kObjectHeaderMinReadSize,
+                &OnObjectHeaderStart);
+  }
+
+  static void OnObjectHeaderStart(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(const size_t prefix_size,
+                                 GetObjectHeaderPrefixSize(data),
+                                 self->Fail(_));
+    if (prefix_size > data.size()) {
+      const uint64_t address = self->object_header_address_;
+      ReadAddress(std::move(self), address, prefix_size,
+                  &OnObjectHeaderPrefix);
+      return;
+    }
+    OnObjectHeaderPrefix(std::move(self), data.substr(0, prefix_size));
+  }
+
+  static void OnObjectHeaderPrefix(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(self->prefix_, DecodeObjectHeaderPrefix(data),
+                                 self->Fail(_));
+    const uint64_t address = self->object_header_address_;
+    const uint64_t size = self->prefix_.first_block_size;
+    ReadAddress(std::move(self), address, size, &OnObjectHeaderBlock);
+  }
+
+  static void OnObjectHeaderBlock(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto block,
+        DecodeObjectHeaderBlock(data, self->prefix_,
+                                /*first=*/self->num_blocks_ == 0,
+                                self->format()),
+        self->Fail(_));
+    ++self->num_blocks_;
+    for (auto& message : block.messages) {
+      self->messages_.push_back(std::move(message));
+    }
+    self->pending_continuations_.insert(self->pending_continuations_.end(),
+                                        block.continuations.begin(),
+                                        block.continuations.end());
+    if (self->pending_continuations_.empty()) {
+      self->on_object_header_(std::move(self));
+      return;
+    }
+    if (self->num_blocks_ >= kMaxObjectHeaderBlocks) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Object header at address ", self->object_header_address_,
+          " has more than ", kMaxObjectHeaderBlocks, " blocks")));
+      return;
+    }
+    const auto continuation = self->pending_continuations_.front();
+    self->pending_continuations_.pop_front();
+    ReadAddress(std::move(self), continuation.address, continuation.length,
+                &OnObjectHeaderBlock);
+  }
+
+  /// Resolves the next path component within the group whose object header
+  /// has been read.
+  static void OnGroupObjectHeader(Ptr self) {
+    bool is_group = false;
+    std::optional<SymbolTableMessage> symbol_table;
+    for (const auto& message : self->messages_) {
+      switch (message.type) {
+        case kLinkMessage: {
+          is_group = true;
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              auto link, DecodeLinkMessage(message.body, self->format()),
+              self->Fail(_));
+          if (link.name != self->component()) continue;
+          if (link.type != LinkType::kHard) {
+            self->Fail(absl::UnimplementedError(tensorstore::StrCat(
+                "Link ", tensorstore::QuoteString(link.name),
+                " is not a hard link")));
+            return;
+          }
+          ResolvedComponent(std::move(self), link.address);
+          return;
+        }
+        case kLinkInfoMessage: {
+          is_group = true;
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              auto link_info,
+              DecodeLinkInfoMessage(message.body, self->format()),
+              self->Fail(_));
+          if (link_info.fractal_heap_address != kUndefinedAddress) {
+            self->Fail(absl::UnimplementedError(
+                "Groups with dense link storage are not supported"));
+            return;
+          }
+          break;
+        }
+        case kSymbolTableMessage: {
+          is_group = true;
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              symbol_table,
+              DecodeSymbolTableMessage(message.body, self->format()),
+              self->Fail(_));
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    if (!is_group) {
+      self->Fail(absl::FailedPreconditionError(
+          tensorstore::StrCat("Parent of ",
+                              tensorstore::QuoteString(self->component()),
+                              " is not a group")));
+      return;
+    }
+    if (!symbol_table) {
+      self->Missing();
+      return;
+    }
+    self->symbol_table_ = *symbol_table;
+    self->group_node_level_ = -1;
+    ReadAddress(std::move(self), symbol_table->heap_address,
+                GetLocalHeapSize(self->format()), &OnLocalHeap);
+  }
+
+  static void ResolvedComponent(Ptr self, uint64_t address) {
+    ++self->num_resolved_;
+    self->cache_->MemoizeAddress(self->stamp_.generation,
+                                 self->GetPath(self->num_resolved_), address);
+    ReadObject(std::move(self), address);
+  }
+
+  static void OnLocalHeap(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto heap,
+                                 DecodeLocalHeap(data, self->format()),
+                                 self->Fail(_));
+    if (heap.data_segment_size == 0) {
+      OnLocalHeapData(std::move(self), {});
+      return;
+    }
+    ReadAddress(std::move(self), heap.data_segment_address,
+                heap.data_segment_size, &OnLocalHeapData);
+  }
+
+  static void OnLocalHeapData(Ptr self, std::string_view data) {
+    self->heap_data_ = std::string(data);
+    const uint64_t address = self->symbol_table_.btree_address;
+    ReadAddress(std::move(self), address,
+                GetBtreeV1GroupNodeSize(self->superblock_), &OnGroupNode);
+  }
+
+  static void OnGroupNode(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto node, DecodeBtreeV1GroupNode(data, self->superblock_),
+        self->Fail(_));
+    if (self->group_node_level_ != -1 &&
+        node.level != self->group_node_level_ - 1) {
+      self->Fail(absl::DataLossError(tensorstore::StrCat(
+          "Expected group B-tree node at level ", self->group_node_level_ - 1,
+          " but received level ", node.level)));
+      return;
+    }
+    self->group_node_level_ = node.level;
+    // Child `i` contains the names in the range `(keys[i], keys[i + 1]]`.
+    for (size_t i = 0; i < node.children.size(); ++i) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto key, GetLocalHeapString(self->heap_data_, node.keys[i + 1]),
+          self->Fail(_));
+      if (self->component() > key) continue;
+      if (node.level != 0) {
+        ReadAddress(std::move(self), node.children[i],
+                    GetBtreeV1GroupNodeSize(self->superblock_), &OnGroupNode);
+      } else {
+        ReadAddress(std::move(self), node.children[i],
+                    GetSymbolTableNodeSize(self->superblock_),
+                    &OnSymbolTableNode);
+      }
+      return;
+    }
+    self->Missing();
+  }
+
+  static void OnSymbolTableNode(Ptr self, std::string_view data) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto entries, DecodeSymbolTableNode(data, self->superblock_),
+        self->Fail(_));
+    for (const auto& entry : entries) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto name, GetLocalHeapString(self->heap_data_, entry.name_offset),
+          self->Fail(_));
+      if (name != self->component()) continue;
+      ResolvedComponent(std::move(self), entry.object_header_address);
+      return;
+    }
+    self->Missing();
+  }
+
+  static void OnDatasetObjectHeader(Ptr self) {
+    const bool is_dataset = std::any_of(
+        self->messages_.begin(), self->messages_.end(),
+        [](const auto& message) {
+          return message.type == kDataLayoutMessage;
+        });
+    if (!is_dataset) {
+      self->Fail(absl::FailedPreconditionError(
+          "HDF5 object is not a dataset"));
+      return;
+    }
+    DatasetObjectHeader header;
+    header.format = self->format();
+    header.messages = std::move(self->messages_);
+    self->promise_.SetResult(kvstore::ReadResult::Value(
+        EncodeDatasetObjectHeader(header), std::move(self->stamp_)));
+  }
+};
+
+class ObjectHeaderKeyValueStore : public kvstore::Driver {
+ public:
+  explicit ObjectHeaderKeyValueStore(kvstore::DriverPtr base,
+                                     internal::CachePool::WeakPtr cache_pool)
+      : base_(std::move(base)), cache_pool_(std::move(cache_pool)) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto paths, DecodeObjectHeaderKey(key));
+    auto state = internal::MakeIntrusivePtr<ResolveState>();
+    state->cache_ = GetFileMetadataCache(cache_pool_.get(), base_,
+                                         std::string(paths.first));
+    state->dataset_path_ = std::string(paths.second);
+    state->components_ = absl::StrSplit(paths.second, '/', absl::SkipEmpty());
+    options.byte_range = OptionalByteRangeRequest{};
+    state->options_ = std::move(options);
+    auto [promise, future] = PromiseFuturePair<ReadResult>::Make();
+    state->promise_ = std::move(promise);
+    ResolveState::Start(std::move(state));
+    return std::move(future);
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    auto paths = DecodeObjectHeaderKey(key);
+    if (!paths.ok()) return base_->DescribeKey(key);
+    return tensorstore::StrCat("HDF5 dataset ",
+                               tensorstore::QuoteString(paths->second), " in ",
+                               base_->DescribeKey(paths->first));
+  }
+
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const final {
+    garbage_collection::GarbageCollectionVisit(visitor, *base_);
+  }
+
+ private:
+  kvstore::DriverPtr base_;
+  internal::CachePool::WeakPtr cache_pool_;
+};
+
+}  // namespace
+
+std::string EncodeObjectHeaderKey(std::string_view file_path,
+                                  std::string_view dataset_path) {
+  return tensorstore::StrCat(file_path, std::string_view("\0", 1),
+                             dataset_path);
+}
+
+kvstore::DriverPtr GetObjectHeaderKeyValueStore(
+    kvstore::DriverPtr base, internal::CachePool::WeakPtr cache_pool) {
+  return kvstore::DriverPtr(
+      new ObjectHeaderKeyValueStore(std::move(base), std::move(cache_pool)));
+}
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,65 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_STORE_H_
+#define TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_STORE_H_
+
+/// \file
+///
+/// Key-value store adapter that locates datasets within HDF5 files.
+///
+/// A read of a dataset key resolves the dataset path from the root group of
+/// the file, using byte range reads of the superblock, object headers and
+/// group structures, and returns the object header messages of the dataset
+/// encoded by `EncodeDatasetObjectHeader`.  All structures are read at a
+/// single generation of the file; if the file is concurrently modified, the
+/// resolution is restarted.
+///
+/// The file is read directly, without the HDF5 library, such that any number
+/// of datasets may be opened concurrently.  The structures read are retained
+/// in the `FileMetadataCache` of the file, see `file_metadata_cache.h`, such
+/// that resolving further datasets of the same file normally only reads the
+/// object header of the dataset itself.
+
+#include <string>
+#include <string_view>
+
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/driver.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+
+/// Returns the key of the dataset at `dataset_path` (e.g. `"/group/data"`)
+/// within the file at `file_path`.
+std::string EncodeObjectHeaderKey(std::string_view file_path,
+                                  std::string_view dataset_path);
+
+/// Returns a read-only key-value store adapter of `base` that maps keys
+/// returned by `EncodeObjectHeaderKey` to the encoded object header of the
+/// dataset.
+///
+/// The value is missing if the file, or any component of the dataset path,
+/// does not exist.  The generation of the value is the generation of the
+/// file.
+///
+/// \param cache_pool Cache pool that retains the `FileMetadataCache` of each
+///     file, which is shared by all datasets of the file.
+kvstore::DriverPtr GetObjectHeaderKeyValueStore(
+    kvstore::DriverPtr base, internal::CachePool::WeakPtr cache_pool);
+
+}  // namespace internal_hdf5
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_HDF5_OBJECT_HEADER_STORE_H_
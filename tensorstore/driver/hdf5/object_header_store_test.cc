@@ -0,0 +1,377 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/object_header_store.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/driver/hdf5/object_header.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/memory/memory_key_value_store.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::CachePool;
+using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal_hdf5::DecodeDatasetObjectHeader;
+using ::tensorstore::internal_hdf5::EncodeObjectHeaderKey;
+using ::tensorstore::internal_hdf5::GetObjectHeaderKeyValueStore;
+using ::tensorstore::internal_hdf5::kDataLayoutMessage;
+using ::tensorstore::internal_hdf5::kDataspaceMessage;
+using ::tensorstore::internal_hdf5::kDatatypeMessage;
+using ::tensorstore::internal_hdf5::kLinkInfoMessage;
+using ::tensorstore::internal_hdf5::kLinkMessage;
+using ::tensorstore::internal_hdf5::kSymbolTableMessage;
+using ::tensorstore::internal_hdf5::kUndefinedAddress;
+using ::tensorstore::internal_hdf5::Lookup3Checksum;
+using ::tensorstore::internal_hdf5::ObjectHeaderMessage;
+
+void AppendLittleEndian(std::string& out, uint64_t value, int size) {
+  for (int i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+ObjectHeaderMessage Message(uint16_t type, std::string body) {
+  ObjectHeaderMessage message;
+  message.type = type;
+  message.body = std::move(body);
+  return message;
+}
+
+// Encodes the messages of a version 1 object header block.
+std::string EncodeV1Messages(const std::vector<ObjectHeaderMessage>& messages) {
+  std::string out;
+  for (const auto& message : messages) {
+    std::string body = message.body;
+    body.resize((body.size() + 7) / 8 * 8);
+    AppendLittleEndian(out, message.type, 2);
+    AppendLittleEndian(out, body.size(), 2);
+    out += std::string(4, '\0');
+    out += body;
+  }
+  return out;
+}
+
+std::string EncodeV1ObjectHeader(
+    const std::vector<ObjectHeaderMessage>& messages) {
+  std::string block = EncodeV1Messages(messages);
+  std::string out;
+  out.push_back(1);
+  out.push_back(0);
+  AppendLittleEndian(out, messages.size(), 2);
+  AppendLittleEndian(out, 1, 4);
+  AppendLittleEndian(out, block.size(), 4);
+  AppendLittleEndian(out, 0, 4);
+  return out + block;
+}
+
+std::string EncodeV2ObjectHeader(
+    const std::vector<ObjectHeaderMessage>& messages) {
+  std::string block;
+  for (const auto& message : messages) {
+    block.push_back(static_cast<char>(message.type));
+    AppendLittleEndian(block, message.body.size(), 2);
+    block.push_back(0);
+    block += message.body;
+  }
+  std::string out = "OHDR";
+  out.push_back(2);
+  out.push_back(0x02);  // 4-byte chunk size
+  AppendLittleEndian(out, block.size(), 4);
+  out += block;
+  AppendLittleEndian(out, Lookup3Checksum(out), 4);
+  return out;
+}
+
+std::string EncodeDataspace(uint64_t size) {
+  std::string out("\x01\x01", 2);
+  out += std::string(6, '\0');
+  AppendLittleEndian(out, size, 8);
+  return out;
+}
+
+std::string EncodeUint8Datatype() {
+  std::string out("\x10\x00\x00\x00", 4);
+  AppendLittleEndian(out, 1, 4);
+  AppendLittleEndian(out, 0, 2);
+  AppendLittleEndian(out, 8, 2);
+  return out;
+}
+
+std::string EncodeLayout(uint64_t chunk_size) {
+  std::string out("\x03\x02\x02", 3);
+  AppendLittleEndian(out, kUndefinedAddress, 8);
+  AppendLittleEndian(out, chunk_size, 4);
+  AppendLittleEndian(out, 1, 4);
+  return out;
+}
+
+std::string EncodeLink(uint8_t type, std::string_view name, uint64_t address) {
+  std::string out("\x01\x08", 2);
+  out.push_back(static_cast<char>(type));
+  out.push_back(static_cast<char>(name.size()));
+  out += name;
+  AppendLittleEndian(out, address, 8);
+  return out;
+}
+
+// Returns an HDF5 file, preceded by a user block of `base_address` bytes, with
+// the following structure:
+//
+//   /data          Dataset in an "old-style" group.
+//   /group         "New-style" group.
+//   /group/inner   Dataset with an object header continuation block.
+//   /group/soft    Soft link.
+std::string GetTestFile(uint64_t base_address = 0) {
+  std::string file(base_address + 3200, '\0');
+  const auto put = [&](uint64_t address, std::string_view data) {
+    file.replace(base_address + address, data.size(), data);
+  };
+
+  // Version 0 superblock.
+  std::string superblock("\x89HDF\r\n\x1a\n", 8);
+  superblock += std::string(5, '\0');
+  superblock += "\x08\x08";
+  superblock.push_back(0);
+  AppendLittleEndian(superblock, 4, 2);
+  AppendLittleEndian(superblock, 16, 2);
+  AppendLittleEndian(superblock, 0, 4);
+  AppendLittleEndian(superblock, base_address, 8);
+  AppendLittleEndian(superblock, kUndefinedAddress, 8);
+  AppendLittleEndian(superblock, 3200, 8);
+  AppendLittleEndian(superblock, kUndefinedAddress, 8);
+  AppendLittleEndian(superblock, 0, 8);
+  AppendLittleEndian(superblock, 128, 8);
+  put(0, superblock);
+
+  // Root group.
+  std::string symbol_table;
+  AppendLittleEndian(symbol_table, 256, 8);
+  AppendLittleEndian(symbol_table, 1024, 8);
+  put(128, EncodeV1ObjectHeader({Message(kSymbolTableMessage, symbol_table)}));
+
+  // Group B-tree with a single symbol table node.
+  std::string node = "TREE";
+  node += std::string("\x00\x00", 2);
+  AppendLittleEndian(node, 1, 2);
+  AppendLittleEndian(node, kUndefinedAddress, 8);
+  AppendLittleEndian(node, kUndefinedAddress, 8);
+  AppendLittleEndian(node, 0, 8);
+  AppendLittleEndian(node, 1200, 8);
+  AppendLittleEndian(node, 6, 8);  // "group"
+  put(256, node);
+
+  // Local heap.
+  std::string heap = "HEAP";
+  heap += std::string(4, '\0');
+  AppendLittleEndian(heap, 16, 8);
+  AppendLittleEndian(heap, kUndefinedAddress, 8);
+  AppendLittleEndian(heap, 1056, 8);
+  put(1024, heap);
+  put(1056, std::string("\0data\0group\0", 12));
+
+  // Symbol table node.
+  std::string snod = "SNOD";
+  snod += std::string("\x01\x00", 2);
+  AppendLittleEndian(snod, 2, 2);
+  for (auto [name_offset, address] : {std::pair(1, 1600), std::pair(6, 2000)}) {
+    AppendLittleEndian(snod, name_offset, 8);
+    AppendLittleEndian(snod, address, 8);
+    snod += std::string(24, '\0');
+  }
+  put(1200, snod);
+
+  put(1600, EncodeV2ObjectHeader({
+                Message(kDataspaceMessage, EncodeDataspace(10)),
+                Message(kDatatypeMessage, EncodeUint8Datatype()),
+                Message(kDataLayoutMessage, EncodeLayout(5)),
+            }));
+
+  std::string link_info("\x00\x00", 2);
+  AppendLittleEndian(link_info, kUndefinedAddress, 8);
+  AppendLittleEndian(link_info, kUndefinedAddress, 8);
+  put(2000, EncodeV2ObjectHeader({
+                Message(kLinkInfoMessage, link_info),
+                Message(kLinkMessage, EncodeLink(0, "inner", 2400)),
+                Message(kLinkMessage, EncodeLink(1, "soft", 0)),
+            }));
+
+  std::string continuation;
+  AppendLittleEndian(continuation, 2800, 8);
+  const std::string continuation_block =
+      EncodeV1Messages({Message(kDataLayoutMessage, EncodeLayout(4))});
+  AppendLittleEndian(continuation, continuation_block.size(), 8);
+  put(2400, EncodeV1ObjectHeader({
+                Message(kDataspaceMessage, EncodeDataspace(8)),
+                Message(kDatatypeMessage, EncodeUint8Datatype()),
+                Message(0x10, continuation),
+            }));
+  put(2800, continuation_block);
+  return file;
+}
+
+class ObjectHeaderStoreTest : public ::testing::Test {
+ protected:
+  void WriteFile(const std::string& file) {
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::kvstore::Write(base_, "a.h5", absl::Cord(file)));
+  }
+
+  tensorstore::Result<tensorstore::kvstore::ReadResult> Read(
+      std::string_view dataset) {
+    return store_->Read(EncodeObjectHeaderKey("a.h5", dataset), {}).result();
+  }
+
+  // Returns the types of the messages of `dataset`.
+  tensorstore::Result<std::vector<uint16_t>> GetMessageTypes(
+      std::string_view dataset) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto read_result, Read(dataset));
+    if (!read_result.has_value()) {
+      return absl::NotFoundError("Value is missing");
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(auto header,
+                                 DecodeDatasetObjectHeader(read_result.value));
+    std::vector<uint16_t> types;
+    for (const auto& message : header.messages) {
+      types.push_back(message.type);
+    }
+    return types;
+  }
+
+  tensorstore::kvstore::DriverPtr base_ =
+      tensorstore::GetMemoryKeyValueStore();
+  CachePool::StrongPtr pool_ = CachePool::Make(CachePool::Limits{1 << 20});
+  tensorstore::kvstore::DriverPtr store_ =
+      GetObjectHeaderKeyValueStore(base_, CachePool::WeakPtr(pool_));
+};
+
+TEST_F(ObjectHeaderStoreTest, OldStyleGroup) {
+  WriteFile(GetTestFile());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result, Read("/data"));
+  ASSERT_TRUE(read_result.has_value());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto file_read_result,
+      tensorstore::kvstore::Read(base_, "a.h5").result());
+  EXPECT_EQ(file_read_result.stamp.generation, read_result.stamp.generation);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto header, DecodeDatasetObjectHeader(read_result.value));
+  EXPECT_EQ(0, header.format.base_address);
+  EXPECT_THAT(GetMessageTypes("data"),
+              ::tensorstore::IsOkAndHolds(::testing::ElementsAre(
+                  kDataspaceMessage, kDatatypeMessage, kDataLayoutMessage)));
+}
+
+TEST_F(ObjectHeaderStoreTest, NewStyleGroup) {
+  WriteFile(GetTestFile());
+  EXPECT_THAT(GetMessageTypes("/group/inner"),
+              ::tensorstore::IsOkAndHolds(::testing::ElementsAre(
+                  kDataspaceMessage, kDatatypeMessage, kDataLayoutMessage)));
+  EXPECT_THAT(Read("/group/soft"),
+              MatchesStatus(absl::StatusCode::kUnimplemented,
+                            ".*not a hard link.*"));
+}
+
+TEST_F(ObjectHeaderStoreTest, UserBlock) {
+  WriteFile(GetTestFile(/*base_address=*/1024));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result, Read("/group/inner"));
+  ASSERT_TRUE(read_result.has_value());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto header, DecodeDatasetObjectHeader(read_result.value));
+  EXPECT_EQ(1024, header.format.base_address);
+}
+
+TEST_F(ObjectHeaderStoreTest, Missing) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result, Read("/data"));
+  EXPECT_TRUE(read_result.not_found());
+  EXPECT_EQ(StorageGeneration::NoValue(), read_result.stamp.generation);
+
+  WriteFile(GetTestFile());
+  for (std::string_view dataset : {"/missing", "/a", "/zzz", "/group/x"}) {
+    SCOPED_TRACE(dataset);
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(read_result, Read(dataset));
+    EXPECT_TRUE(read_result.not_found());
+  }
+}
+
+TEST_F(ObjectHeaderStoreTest, Invalid) {
+  WriteFile(GetTestFile());
+  EXPECT_THAT(Read("/group"),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*not a dataset.*"));
+  EXPECT_THAT(Read("/data/x"),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*not a group.*"));
+  WriteFile(std::string(4096, 'x'));
+  EXPECT_THAT(Read("/data"),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*Not an HDF5 file.*"));
+}
+
+TEST(ObjectHeaderStoreCacheTest, SharedFileMetadata) {
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  TENSORSTORE_ASSERT_OK(tensorstore::kvstore::Write(
+      memory_store, "a.h5", absl::Cord(GetTestFile())));
+  auto mock_store = MockKeyValueStore::Make();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  auto pool = CachePool::Make(CachePool::Limits{1 << 20});
+  // Separate adapters, as created for separate opens, that share the cache
+  // pool.
+  auto store1 =
+      GetObjectHeaderKeyValueStore(mock_store, CachePool::WeakPtr(pool));
+  auto store2 =
+      GetObjectHeaderKeyValueStore(mock_store, CachePool::WeakPtr(pool));
+  const auto key = EncodeObjectHeaderKey("a.h5", "/group/inner");
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result1,
+                                   store1->Read(key, {}).result());
+  ASSERT_TRUE(read_result1.has_value());
+  EXPECT_THAT(mock_store->request_log.pop_all(),
+              ::testing::SizeIs(::testing::Gt(1)));
+
+  // Only the superblock is revalidated.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result2,
+                                   store2->Read(key, {}).result());
+  EXPECT_EQ(read_result1.value, read_result2.value);
+  EXPECT_EQ(read_result1.stamp.generation, read_result2.stamp.generation);
+  EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+
+  // Structures cached at an older generation are revalidated.
+  TENSORSTORE_ASSERT_OK(tensorstore::kvstore::Write(
+      memory_store, "a.h5", absl::Cord(GetTestFile())));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result3,
+                                   store2->Read(key, {}).result());
+  EXPECT_EQ(read_result1.value, read_result3.value);
+  EXPECT_NE(read_result1.stamp.generation, read_result3.stamp.generation);
+}
+
+}  // namespace
@@ -0,0 +1,422 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/hdf5/object_header.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/hdf5/format.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::endian;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::kInfSize;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_hdf5::ChunkIndexType;
+using ::tensorstore::internal_hdf5::DatasetObjectHeader;
+using ::tensorstore::internal_hdf5::DecodeDataLayoutMessage;
+using ::tensorstore::internal_hdf5::DecodeDataspaceMessage;
+using ::tensorstore::internal_hdf5::DecodeDatasetObjectHeader;
+using ::tensorstore::internal_hdf5::DecodeDatatypeMessage;
+using ::tensorstore::internal_hdf5::DecodeFilterPipelineMessage;
+using ::tensorstore::internal_hdf5::DecodeLinkMessage;
+using ::tensorstore::internal_hdf5::DecodeObjectHeaderBlock;
+using ::tensorstore::internal_hdf5::DecodeObjectHeaderPrefix;
+using ::tensorstore::internal_hdf5::DecodeSuperblock;
+using ::tensorstore::internal_hdf5::EncodeDatasetObjectHeader;
+using ::tensorstore::internal_hdf5::FormatParameters;
+using ::tensorstore::internal_hdf5::GetObjectHeaderPrefixSize;
+using ::tensorstore::internal_hdf5::kDataspaceMessage;
+using ::tensorstore::internal_hdf5::kDatatypeMessage;
+using ::tensorstore::internal_hdf5::kUndefinedAddress;
+using ::tensorstore::internal_hdf5::LayoutClass;
+using ::tensorstore::internal_hdf5::LinkType;
+using ::tensorstore::internal_hdf5::Lookup3Checksum;
+
+void AppendLittleEndian(std::string& out, uint64_t value, int size) {
+  for (int i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+// Appends the checksum of all bytes of `out` starting at `start`.
+void AppendChecksum(std::string& out, size_t start) {
+  AppendLittleEndian(out, Lookup3Checksum(std::string_view(out).substr(start)),
+                     4);
+}
+
+constexpr std::string_view kSignature = "\x89HDF\r\n\x1a\n";
+
+TEST(DecodeSuperblockTest, Version0) {
+  std::string data(kSignature);
+  data += std::string(5, '\0');  // versions
+  data.push_back(8);             // size of offsets
+  data.push_back(8);             // size of lengths
+  data.push_back(0);
+  AppendLittleEndian(data, 4, 2);   // group leaf node K
+  AppendLittleEndian(data, 16, 2);  // group internal node K
+  AppendLittleEndian(data, 0, 4);   // flags
+  AppendLittleEndian(data, 0, 8);   // base address
+  AppendLittleEndian(data, kUndefinedAddress, 8);
+  AppendLittleEndian(data, 5000, 8);  // end of file address
+  AppendLittleEndian(data, kUndefinedAddress, 8);
+  AppendLittleEndian(data, 0, 8);   // link name offset
+  AppendLittleEndian(data, 96, 8);  // root object header address
+  data.resize(96);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto superblock,
+                                   DecodeSuperblock(data, 512));
+  EXPECT_EQ(0, superblock.version);
+  EXPECT_EQ(512, superblock.format.base_address);
+  EXPECT_EQ(32, superblock.format.indexed_storage_k);
+  EXPECT_EQ(4, superblock.group_leaf_node_k);
+  EXPECT_EQ(16, superblock.group_internal_node_k);
+  EXPECT_EQ(5000, superblock.end_of_file_address);
+  EXPECT_EQ(96, superblock.root_object_header_address);
+  EXPECT_EQ(kUndefinedAddress, superblock.extension_address);
+
+  EXPECT_THAT(DecodeSuperblock(data.substr(0, 40), 0),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+  EXPECT_THAT(DecodeSuperblock(std::string(96, '\0'), 0),
+              MatchesStatus(absl::StatusCode::kNotFound));
+}
+
+TEST(DecodeSuperblockTest, Version2) {
+  std::string data(kSignature);
+  data.push_back(2);
+  data.push_back(4);  // size of offsets
+  data.push_back(8);  // size of lengths
+  data.push_back(0);
+  AppendLittleEndian(data, 0, 4);     // base address
+  AppendLittleEndian(data, 200, 4);   // superblock extension address
+  AppendLittleEndian(data, 1000, 4);  // end of file address
+  AppendLittleEndian(data, 48, 4);    // root object header address
+  AppendChecksum(data, 0);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto superblock, DecodeSuperblock(data, 0));
+  EXPECT_EQ(2, superblock.version);
+  EXPECT_EQ(4, superblock.format.size_of_offsets);
+  EXPECT_EQ(8, superblock.format.size_of_lengths);
+  EXPECT_EQ(200, superblock.extension_address);
+  EXPECT_EQ(48, superblock.root_object_header_address);
+
+  data[12] ^= 1;
+  EXPECT_THAT(DecodeSuperblock(data, 0),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            ".*Checksum mismatch.*"));
+}
+
+TEST(DecodeObjectHeaderTest, Version1) {
+  std::string data;
+  data.push_back(1);
+  data.push_back(0);
+  AppendLittleEndian(data, 3, 2);   // number of messages
+  AppendLittleEndian(data, 1, 4);   // reference count
+  AppendLittleEndian(data, 48, 4);  // header size
+  AppendLittleEndian(data, 0, 4);
+  // Dataspace message.
+  AppendLittleEndian(data, kDataspaceMessage, 2);
+  AppendLittleEndian(data, 8, 2);
+  data += std::string(4, '\0');
+  data += "abcdefgh";
+  // Nil message.
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 0, 2);
+  data += std::string(4, '\0');
+  // Continuation message.
+  AppendLittleEndian(data, 0x10, 2);
+  AppendLittleEndian(data, 16, 2);
+  data += std::string(4, '\0');
+  AppendLittleEndian(data, 1000, 8);
+  AppendLittleEndian(data, 64, 8);
+
+  EXPECT_THAT(GetObjectHeaderPrefixSize(data), IsOkAndHolds(16));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto prefix, DecodeObjectHeaderPrefix(data.substr(0, 16)));
+  EXPECT_EQ(1, prefix.version);
+  EXPECT_EQ(64, prefix.first_block_size);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto block,
+      DecodeObjectHeaderBlock(data, prefix, /*first=*/true,
+                              FormatParameters{}));
+  ASSERT_EQ(1, block.messages.size());
+  EXPECT_EQ(kDataspaceMessage, block.messages[0].type);
+  EXPECT_EQ("abcdefgh", block.messages[0].body);
+  ASSERT_EQ(1, block.continuations.size());
+  EXPECT_EQ(1000, block.continuations[0].address);
+  EXPECT_EQ(64, block.continuations[0].length);
+}
+
+TEST(DecodeObjectHeaderTest, Version2) {
+  std::string data = "OHDR";
+  data.push_back(2);
+  data.push_back(0x04);  // attribute creation order tracked, 1-byte size
+  data.push_back(12);    // size of chunk 0
+  data.push_back(kDatatypeMessage);
+  AppendLittleEndian(data, 4, 2);
+  data.push_back(0);
+  AppendLittleEndian(data, 0, 2);  // creation order
+  data += "wxyz";
+  data += std::string(2, '\0');  // gap
+  AppendChecksum(data, 0);
+
+  EXPECT_THAT(GetObjectHeaderPrefixSize(data), IsOkAndHolds(7));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto prefix, DecodeObjectHeaderPrefix(data.substr(0, 7)));
+  EXPECT_EQ(2, prefix.version);
+  EXPECT_EQ(data.size(), prefix.first_block_size);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto block,
+      DecodeObjectHeaderBlock(data, prefix, /*first=*/true,
+                              FormatParameters{}));
+  ASSERT_EQ(1, block.messages.size());
+  EXPECT_EQ(kDatatypeMessage, block.messages[0].type);
+  EXPECT_EQ("wxyz", block.messages[0].body);
+  EXPECT_TRUE(block.continuations.empty());
+
+  data[10] ^= 1;
+  EXPECT_THAT(
+      DecodeObjectHeaderBlock(data, prefix, /*first=*/true,
+                              FormatParameters{}),
+      MatchesStatus(absl::StatusCode::kDataLoss, ".*Checksum mismatch.*"));
+}
+
+TEST(DecodeDataspaceMessageTest, Basic) {
+  std::string data;
+  data.push_back(1);
+  data.push_back(2);     // rank
+  data.push_back(0x01);  // maximum dimensions present
+  data += std::string(5, '\0');
+  AppendLittleEndian(data, 10, 8);
+  AppendLittleEndian(data, 20, 8);
+  AppendLittleEndian(data, 10, 8);
+  AppendLittleEndian(data, ~uint64_t(0), 8);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto dataspace, DecodeDataspaceMessage(data, FormatParameters{}));
+  EXPECT_THAT(dataspace.shape, ::testing::ElementsAre(10, 20));
+  EXPECT_THAT(dataspace.max_shape, ::testing::ElementsAre(10, kInfSize));
+
+  data = std::string("\x02\x01\x00\x01", 4);
+  AppendLittleEndian(data, 7, 8);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      dataspace, DecodeDataspaceMessage(data, FormatParameters{}));
+  EXPECT_THAT(dataspace.shape, ::testing::ElementsAre(7));
+  EXPECT_THAT(dataspace.max_shape, ::testing::ElementsAre(7));
+}
+
+TEST(DecodeDatatypeMessageTest, Basic) {
+  // Big endian signed 16-bit integer.
+  std::string data = "\x10\x09";
+  data += std::string(2, '\0');
+  AppendLittleEndian(data, 2, 4);
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 16, 2);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto datatype, DecodeDatatypeMessage(data));
+  EXPECT_EQ(dtype_v<int16_t>, datatype.dtype);
+  EXPECT_EQ(endian::big, datatype.byte_order);
+
+  // Little endian IEEE binary32.
+  data = "\x11\x20\x1f";
+  data.push_back(0);
+  AppendLittleEndian(data, 4, 4);
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 32, 2);
+  data += "\x17\x08";
+  data.push_back(0);
+  data.push_back(23);
+  AppendLittleEndian(data, 127, 4);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(datatype, DecodeDatatypeMessage(data));
+  EXPECT_EQ(dtype_v<float>, datatype.dtype);
+  EXPECT_EQ(endian::little, datatype.byte_order);
+
+  // String.
+  data = "\x13";
+  data += std::string(3, '\0');
+  AppendLittleEndian(data, 4, 4);
+  EXPECT_THAT(DecodeDatatypeMessage(data),
+              MatchesStatus(absl::StatusCode::kUnimplemented));
+}
+
+TEST(DecodeDataLayoutMessageTest, Version3) {
+  std::string data = "\x03\x02\x03";
+  AppendLittleEndian(data, 4096, 8);
+  AppendLittleEndian(data, 4, 4);
+  AppendLittleEndian(data, 5, 4);
+  AppendLittleEndian(data, 2, 4);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(ChunkIndexType::kBtreeV1, message.layout.chunk_index_type);
+  EXPECT_EQ(4096, message.layout.address);
+  EXPECT_THAT(message.chunk_shape, ::testing::ElementsAre(4, 5));
+  EXPECT_EQ(2, message.element_size);
+
+  // Contiguous layout.
+  data = "\x03\x01";
+  AppendLittleEndian(data, 4096, 8);
+  AppendLittleEndian(data, 100, 8);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(LayoutClass::kContiguous, message.layout.layout_class);
+  EXPECT_EQ(4096, message.layout.address);
+  EXPECT_EQ(100, message.layout.size);
+  EXPECT_THAT(message.chunk_shape, ::testing::ElementsAre());
+
+  // Compact layout.
+  data = "\x03\x00";
+  AppendLittleEndian(data, 3, 2);
+  data += "abc";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(LayoutClass::kCompact, message.layout.layout_class);
+  EXPECT_EQ(3, message.layout.size);
+  EXPECT_EQ("abc", message.layout.compact_data);
+
+  // Truncated compact data.
+  data = "\x03\x00";
+  AppendLittleEndian(data, 4, 2);
+  data += "abc";
+  EXPECT_THAT(DecodeDataLayoutMessage(data, FormatParameters{}),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+
+  // Invalid layout class.
+  data = "\x03\x03";
+  EXPECT_THAT(DecodeDataLayoutMessage(data, FormatParameters{}),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+}
+
+TEST(DecodeDataLayoutMessageTest, Version1) {
+  // Contiguous layout, with the dataset dimensions that are ignored.
+  std::string data = "\x01\x02\x01";
+  data += std::string(5, '\0');
+  AppendLittleEndian(data, 2048, 8);
+  AppendLittleEndian(data, 10, 4);
+  AppendLittleEndian(data, 20, 4);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(LayoutClass::kContiguous, message.layout.layout_class);
+  EXPECT_EQ(2048, message.layout.address);
+  EXPECT_EQ(0, message.layout.size);
+
+  // Compact layout.
+  data = "\x01\x01\x00";
+  data += std::string(5, '\0');
+  AppendLittleEndian(data, 2, 4);
+  AppendLittleEndian(data, 2, 4);
+  data += "xy";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(LayoutClass::kCompact, message.layout.layout_class);
+  EXPECT_EQ("xy", message.layout.compact_data);
+}
+
+TEST(DecodeDataLayoutMessageTest, Version4SingleChunk) {
+  std::string data = "\x04\x02\x02\x02\x02";
+  AppendLittleEndian(data, 8, 2);
+  AppendLittleEndian(data, 4, 2);
+  data.push_back(1);                // single chunk index
+  AppendLittleEndian(data, 30, 8);  // filtered size
+  AppendLittleEndian(data, 1, 4);   // filter mask
+  AppendLittleEndian(data, 2048, 8);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto message, DecodeDataLayoutMessage(data, FormatParameters{}));
+  EXPECT_EQ(ChunkIndexType::kSingleChunk, message.layout.chunk_index_type);
+  EXPECT_EQ(2048, message.layout.address);
+  EXPECT_THAT(message.chunk_shape, ::testing::ElementsAre(8));
+  EXPECT_EQ(4, message.element_size);
+  EXPECT_EQ(30, message.layout.single_chunk_filtered_size);
+  EXPECT_EQ(1, message.layout.single_chunk_filter_mask);
+}
+
+TEST(DecodeFilterPipelineMessageTest, Basic) {
+  // Version 1 with the deflate filter.
+  std::string data = "\x01\x01";
+  data += std::string(6, '\0');
+  AppendLittleEndian(data, 1, 2);
+  AppendLittleEndian(data, 8, 2);  // name length
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 1, 2);
+  data += std::string("deflate\0", 8);
+  AppendLittleEndian(data, 6, 4);
+  data += std::string(4, '\0');
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto filters,
+                                   DecodeFilterPipelineMessage(data));
+  ASSERT_EQ(1, filters.size());
+  EXPECT_EQ(1, filters[0].id);
+  EXPECT_EQ("deflate", filters[0].name);
+  EXPECT_THAT(filters[0].client_data, ::testing::ElementsAre(6));
+
+  // Version 2 with the shuffle filter and an unnamed registered filter.
+  data = "\x02\x02";
+  AppendLittleEndian(data, 2, 2);
+  AppendLittleEndian(data, 1, 2);
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 32001, 2);
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 0, 2);
+  AppendLittleEndian(data, 0, 2);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(filters, DecodeFilterPipelineMessage(data));
+  ASSERT_EQ(2, filters.size());
+  EXPECT_EQ(2, filters[0].id);
+  EXPECT_EQ(1, filters[0].flags);
+  EXPECT_EQ(32001, filters[1].id);
+}
+
+TEST(DecodeLinkMessageTest, Basic) {
+  std::string data("\x01\x00\x04", 3);
+  data += "data";
+  AppendLittleEndian(data, 800, 8);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto link,
+                                   DecodeLinkMessage(data, FormatParameters{}));
+  EXPECT_EQ(LinkType::kHard, link.type);
+  EXPECT_EQ("data", link.name);
+  EXPECT_EQ(800, link.address);
+}
+
+TEST(DatasetObjectHeaderTest, RoundTrip) {
+  DatasetObjectHeader header;
+  header.format.size_of_offsets = 4;
+  header.format.base_address = 512;
+  header.messages.resize(2);
+  header.messages[0].type = kDataspaceMessage;
+  header.messages[0].body = "abc";
+  header.messages[1].type = kDatatypeMessage;
+  header.messages[1].flags = 1;
+  header.messages[1].body = std::string("\0x", 2);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded,
+      DecodeDatasetObjectHeader(EncodeDatasetObjectHeader(header)));
+  EXPECT_EQ(header.format, decoded.format);
+  ASSERT_EQ(2, decoded.messages.size());
+  EXPECT_EQ(kDataspaceMessage, decoded.messages[0].type);
+  EXPECT_EQ("abc", decoded.messages[0].body);
+  EXPECT_EQ(1, decoded.messages[1].flags);
+  EXPECT_EQ(std::string("\0x", 2), decoded.messages[1].body);
+
+  EXPECT_THAT(DecodeDatasetObjectHeader(absl::Cord("abc")),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
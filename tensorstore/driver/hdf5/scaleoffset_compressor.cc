@@ -0,0 +1,261 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "scaleoffset" filter (filter id 6) for integer data.
+/// Linking in this library automatically registers it.
+///
+/// The encoded chunk starts with a 21-byte header containing the number of
+/// bits per packed value (`minbits`) as a little-endian `uint32`, followed by
+/// the size (`8`) and value of the minimum element as a little-endian
+/// `uint64`.  Each element is stored as its difference from the minimum,
+/// packed as by `PackedBitWriter`.  If a fill value is defined, elements equal
+/// to the fill value are stored as all one bits.
+///
+/// If `minbits` equals the element size in bits, the elements are instead
+/// stored unpacked, in little-endian byte order.
+///
+/// Encoding always determines `minbits` from the range of the data, such that
+/// encoding is lossless.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "riegeli/endian/endian_reading.h"
+#include "riegeli/endian/endian_writing.h"
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+constexpr size_t kHeaderSize = 21;
+
+/// Returns the number of bits needed to represent `n` distinct values.
+int CeilLog2(uint64_t n) {
+  int bits = 0;
+  while (bits < 64 && (uint64_t{1} << bits) < n) ++bits;
+  return bits;
+}
+
+/// Sign-extends the low `size` bytes of `value`.
+int64_t SignExtend(uint64_t value, size_t size) {
+  const int shift = 64 - static_cast<int>(size) * 8;
+  return static_cast<int64_t>(value << shift) >> shift;
+}
+
+class ScaleOffsetCompressor : public ChunkFilterCompressor {
+ public:
+  /// Number of elements in each chunk.
+  uint64_t num_elements;
+
+  /// Indicates whether the elements are signed integers.
+  bool is_signed;
+
+  /// Byte order of the elements.
+  endian byte_order;
+
+  /// Fill value of the dataset, if defined.
+  std::optional<int64_t> fill_value;
+
+  absl::Status ValidateElementSize(size_t element_bytes) const {
+    if (element_bytes == 0 || element_bytes > 8) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "scaleoffset filter does not support elements of ", element_bytes,
+          " bytes"));
+    }
+    return absl::OkStatus();
+  }
+
+  Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                 size_t element_bytes) const override {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateElementSize(element_bytes));
+    const auto data_loss_error = [&](std::string_view what) -> absl::Status {
+      if (!reader.ok()) return reader.status();
+      return absl::DataLossError(tensorstore::StrCat(
+          "Error decoding scaleoffset filtered chunk: ", what));
+    };
+    const int element_bits = static_cast<int>(element_bytes) * 8;
+    uint32_t minbits;
+    uint8_t minval_size;
+    char minval_bytes[8] = {};
+    if (!riegeli::ReadLittleEndian<uint32_t>(reader, minbits) ||
+        !reader.ReadByte(minval_size) || minval_size > 8 ||
+        !reader.Read(minval_size, minval_bytes) ||
+        !reader.Skip(kHeaderSize - 5 - minval_size)) {
+      return data_loss_error("invalid header");
+    }
+    if (minbits > static_cast<uint32_t>(element_bits)) {
+      return data_loss_error(tensorstore::StrCat("invalid minbits ", minbits));
+    }
+    const uint64_t decoded_size = num_elements * element_bytes;
+    if (minbits == static_cast<uint32_t>(element_bits)) {
+      absl::Cord output;
+      if (!reader.Read(decoded_size, output)) {
+        return data_loss_error("truncated data");
+      }
+      if (byte_order == endian::little || element_bytes == 1) return output;
+      std::string swapped(output);
+      for (uint64_t i = 0; i < num_elements; ++i) {
+        std::reverse(swapped.data() + i * element_bytes,
+                     swapped.data() + (i + 1) * element_bytes);
+      }
+      return absl::Cord(std::move(swapped));
+    }
+    const uint64_t minval = LoadUnsigned(minval_bytes, 8, endian::little);
+    const uint64_t fill_marker = LowBitMask(minbits);
+    std::string output(decoded_size, '\0');
+    PackedBitReader bit_reader(reader);
+    for (uint64_t i = 0; i < num_elements; ++i) {
+      uint64_t packed = 0;
+      if (!bit_reader.Read(minbits, packed)) {
+        return data_loss_error("truncated data");
+      }
+      const uint64_t value = (fill_value && packed == fill_marker)
+                                 ? static_cast<uint64_t>(*fill_value)
+                                 : packed + minval;
+      StoreUnsigned(value, output.data() + i * element_bytes, element_bytes,
+                    byte_order);
+    }
+    return absl::Cord(std::move(output));
+  }
+
+  absl::Status EncodeChunk(const absl::Cord& input, riegeli::Writer& writer,
+                           size_t element_bytes) const override {
+    TENSORSTORE_RETURN_IF_ERROR(ValidateElementSize(element_bytes));
+    if (input.size() != num_elements * element_bytes) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "scaleoffset filter expects ", num_elements,
+          " elements but received ", input.size(), " bytes"));
+    }
+    const int element_bits = static_cast<int>(element_bytes) * 8;
+    const uint64_t element_mask = LowBitMask(element_bits);
+    // Elements are compared after sign extension (if signed), and stored
+    // relative to the minimum modulo `2**element_bits`.
+    const auto get_element = [&](const char* data) -> uint64_t {
+      const uint64_t value = LoadUnsigned(data, element_bytes, byte_order);
+      return is_signed ? static_cast<uint64_t>(SignExtend(value, element_bytes))
+                       : value;
+    };
+    const auto less = [&](uint64_t a, uint64_t b) {
+      return is_signed ? static_cast<int64_t>(a) < static_cast<int64_t>(b)
+                       : a < b;
+    };
+    std::optional<uint64_t> fill;
+    if (fill_value) {
+      const uint64_t value = static_cast<uint64_t>(*fill_value) & element_mask;
+      fill = is_signed ? static_cast<uint64_t>(SignExtend(value, element_bytes))
+                       : value;
+    }
+
+    std::string data(input);
+    uint64_t min = 0, max = 0;
+    bool found = false;
+    for (uint64_t i = 0; i < num_elements; ++i) {
+      const uint64_t value = get_element(data.data() + i * element_bytes);
+      if (fill && value == *fill) continue;
+      if (!found || less(value, min)) min = value;
+      if (!found || less(max, value)) max = value;
+      found = true;
+    }
+    const uint64_t range = (max - min) & element_mask;
+    // One packed value is reserved to indicate the fill value.
+    const uint64_t reserved = fill ? 2 : 1;
+    int minbits = element_bits;
+    if (range <= element_mask - reserved) {
+      minbits = std::min(element_bits, CeilLog2(range + reserved));
+    }
+
+    char header[kHeaderSize] = {};
+    StoreUnsigned(minbits, header, 4, endian::little);
+    header[4] = 8;
+    StoreUnsigned(min, header + 5, 8, endian::little);
+    if (!writer.Write(std::string_view(header, kHeaderSize))) {
+      return writer.status();
+    }
+    if (minbits == element_bits) {
+      for (uint64_t i = 0; i < num_elements; ++i) {
+        char* element = data.data() + i * element_bytes;
+        StoreUnsigned(LoadUnsigned(element, element_bytes, byte_order),
+                      element, element_bytes, endian::little);
+      }
+      if (!writer.Write(absl::Cord(std::move(data)))) return writer.status();
+      return absl::OkStatus();
+    }
+    PackedBitWriter bit_writer(writer);
+    for (uint64_t i = 0; i < num_elements; ++i) {
+      const uint64_t value = get_element(data.data() + i * element_bytes);
+      const uint64_t packed = (fill && value == *fill)
+                                  ? LowBitMask(minbits)
+                                  : (value - min) & element_mask;
+      if (!bit_writer.Write(packed, minbits)) return writer.status();
+    }
+    if (!bit_writer.Flush()) return writer.status();
+    return absl::OkStatus();
+  }
+};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<ScaleOffsetCompressor>(
+        "scaleoffset",
+        jb::Object(
+            jb::Member("num_elements",
+                       jb::Projection(&ScaleOffsetCompressor::num_elements,
+                                      jb::Integer<uint64_t>())),
+            jb::Member("signed",
+                       jb::Projection(
+                           &ScaleOffsetCompressor::is_signed,
+                           jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                               [](auto* v) { *v = false; }))),
+            jb::Member(
+                "byte_order",
+                jb::Projection(&ScaleOffsetCompressor::byte_order,
+                               jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                                   [](auto* v) { *v = endian::little; },
+                                   jb::Enum<endian, std::string_view>({
+                                       {endian::little, "little"},
+                                       {endian::big, "big"},
+                                   })))),
+            jb::Member("fill_value",
+                       jb::Projection(
+                           &ScaleOffsetCompressor::fill_value,
+                           jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                               [](auto* v) { v->reset(); },
+                               jb::Optional(jb::Integer<int64_t>()))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,108 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// Defines the HDF5 "shuffle" filter (filter id 2).  Linking in this library
+/// automatically registers it.
+///
+/// The shuffle filter stores byte `i` of every element contiguously, for each
+/// `i` in `[0, element_bytes)`.  Any trailing bytes that do not form a
+/// complete element are stored unchanged at the end.
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/hdf5/chunk_filter_compressor.h"
+#include "tensorstore/driver/hdf5/compressor_registry.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_hdf5 {
+namespace {
+
+/// Calls `func(offset, byte)` for each byte of `input`, without flattening.
+template <typename Func>
+void ForEachByte(const absl::Cord& input, Func func) {
+  size_t offset = 0;
+  for (std::string_view chunk : input.Chunks()) {
+    for (char c : chunk) func(offset++, c);
+  }
+}
+
+class ShuffleCompressor : public ChunkFilterCompressor {
+ public:
+  Result<absl::Cord> DecodeChunk(riegeli::Reader& reader,
+                                 size_t element_bytes) const override {
+    absl::Cord input;
+    if (auto status = riegeli::ReadAll(reader, input); !status.ok()) {
+      return status;
+    }
+    if (element_bytes <= 1) return input;
+    const size_t num_elements = input.size() / element_bytes;
+    const size_t shuffled_size = num_elements * element_bytes;
+    std::string output(input.size(), '\0');
+    ForEachByte(input, [&](size_t offset, char c) {
+      if (offset >= shuffled_size) {
+        output[offset] = c;
+        return;
+      }
+      const size_t byte_index = offset / num_elements;
+      const size_t element_index = offset % num_elements;
+      output[element_index * element_bytes + byte_index] = c;
+    });
+    return absl::Cord(std::move(output));
+  }
+
+  absl::Status EncodeChunk(const absl::Cord& input, riegeli::Writer& writer,
+                           size_t element_bytes) const override {
+    if (element_bytes <= 1) {
+      if (!writer.Write(input)) return writer.status();
+      return absl::OkStatus();
+    }
+    const size_t num_elements = input.size() / element_bytes;
+    const size_t shuffled_size = num_elements * element_bytes;
+    std::string output(input.size(), '\0');
+    ForEachByte(input, [&](size_t offset, char c) {
+      if (offset >= shuffled_size) {
+        output[offset] = c;
+        return;
+      }
+      const size_t element_index = offset / element_bytes;
+      const size_t byte_index = offset % element_bytes;
+      output[byte_index * num_elements + element_index] = c;
+    });
+    if (!writer.Write(absl::Cord(std::move(output)))) return writer.status();
+    return absl::OkStatus();
+  }
+};
+
+struct Registration {
+  Registration() {
+    namespace jb = tensorstore::internal_json_binding;
+    RegisterCompressor<ShuffleCompressor>("shuffle", jb::Object());
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_hdf5
+}  // namespace tensorstore
@@ -0,0 +1,51 @@
+# Copyright 2026 The TensorStore Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Generates HDF5 test data using h5py.
+
+The file is written with `libver='earliest'` so that it uses the version 0
+superblock, version 1 object headers, symbol table groups and version 1
+B-tree chunk indices.
+"""
+
+import h5py
+import numpy as np
+
+
+def create_compact(parent, name, data):
+  dcpl = h5py.h5p.create(h5py.h5p.DATASET_CREATE)
+  dcpl.set_layout(h5py.h5d.COMPACT)
+  space = h5py.h5s.create_simple(data.shape)
+  dset_id = h5py.h5d.create(
+      parent.id,
+      name.encode(),
+      h5py.h5t.py_create(data.dtype),
+      space,
+      dcpl=dcpl)
+  dset_id.write(h5py.h5s.ALL, h5py.h5s.ALL, data)
+
+
+def main():
+  shape = (5, 4)
+  data = np.arange(np.prod(shape), dtype=np.uint16).reshape(shape)
+  with h5py.File('datasets.h5', 'w', libver='earliest') as f:
+    f.create_dataset('chunked', data=data, chunks=(3, 2))
+    f.create_dataset('gzip', data=data, chunks=(3, 2), compression='gzip')
+    f.create_dataset('contiguous', data=data)
+    create_compact(f, 'compact', data)
+    group = f.create_group('group')
+    group.create_dataset('nested', data=data, chunks=(3, 2))
+
+
+if __name__ == '__main__':
+  main()
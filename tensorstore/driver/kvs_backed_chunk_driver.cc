@@ -44,6 +44,8 @@
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/cache/disk_cache.h"
+#include "tensorstore/internal/cache/disk_cache_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
@@ -141,7 +143,8 @@ MetadataCache::MetadataCache(Initializer initializer)
 DataCacheBase::DataCacheBase(Initializer&& initializer)
     : metadata_cache_entry_(std::move(initializer.metadata_cache_entry)),
       initial_metadata_(std::move(initializer.metadata)),
-      cache_pool_(std::move(initializer.cache_pool)) {}
+      cache_pool_(std::move(initializer.cache_pool)),
+      disk_cache_(std::move(initializer.disk_cache)) {}
 
 DataCache::DataCache(Initializer&& initializer,
                      internal::ChunkGridSpecification&& grid)
@@ -732,6 +735,7 @@ Result<IndexTransform<>> KvsMetadataDriverBase::GetBoundSpecData(
   spec.store.path = cache->GetBaseKvstorePath();
   spec.data_copy_concurrency = metadata_cache->data_copy_concurrency_;
   spec.cache_pool = cache->cache_pool_;
+  spec.disk_cache = cache->disk_cache_;
   spec.fill_value_mode = fill_value_mode_;
   if (spec.cache_pool != metadata_cache->metadata_cache_pool_) {
     spec.metadata_cache_pool = metadata_cache->metadata_cache_pool_;
@@ -846,7 +850,8 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
                                // `true`. Note that the metadata cache is
                                // already implicitly part of the key due to the
                                // inclusion of `metadata_cache_entry_`.
-                               state->cache_pool()->get());
+                               state->cache_pool()->get(),
+                               state->disk_cache()->cache.get());
     }
   }
   absl::Status data_key_value_store_status;
@@ -866,9 +871,14 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
         }
         DataCacheInitializer initializer;
         initializer.store = *std::move(store_result);
+        if (auto& disk_cache = state->disk_cache()->cache) {
+          initializer.store = internal::MakeDiskCacheKvStore(
+              std::move(initializer.store), disk_cache);
+        }
         initializer.metadata_cache_entry = base.metadata_cache_entry_;
         initializer.metadata = metadata;
         initializer.cache_pool = state->cache_pool();
+        initializer.disk_cache = state->disk_cache();
         return state->GetDataCache(std::move(initializer));
       });
   TENSORSTORE_RETURN_IF_ERROR(data_key_value_store_status);
@@ -1483,6 +1493,8 @@ TENSORSTORE_DEFINE_JSON_BINDER(
                    jb::Projection<&KvsDriverSpec::cache_pool>()),
         jb::Member("metadata_cache_pool",
                    jb::Projection<&KvsDriverSpec::metadata_cache_pool>()),
+        jb::Member(internal::DiskCacheResource::id,
+                   jb::Projection<&KvsDriverSpec::disk_cache>()),
         jb::Projection<&KvsDriverSpec::store>(jb::KvStoreSpecAndPathJsonBinder),
         jb::Initialize([](auto* obj) {
           internal::EnsureDirectoryPath(obj->store.path);
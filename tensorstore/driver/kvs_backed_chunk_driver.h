@@ -36,6 +36,7 @@
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/disk_cache_resource.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
@@ -79,6 +80,7 @@ struct KvsDriverSpec : public internal::DriverSpec,
   Context::Resource<internal::CachePoolResource> cache_pool;
   std::optional<Context::Resource<internal::CachePoolResource>>
       metadata_cache_pool;
+  Context::Resource<internal::DiskCacheResource> disk_cache;
   StalenessBounds staleness;
   FillValueMode fill_value_mode;
 
@@ -87,7 +89,7 @@ struct KvsDriverSpec : public internal::DriverSpec,
     return f(internal::BaseCast<internal::DriverSpec>(x),
              internal::BaseCast<internal::OpenModeSpec>(x), x.store,
              x.data_copy_concurrency, x.cache_pool, x.metadata_cache_pool,
-             x.staleness, x.fill_value_mode);
+             x.disk_cache, x.staleness, x.fill_value_mode);
   };
 
   kvstore::Spec GetKvstore() const override;
@@ -309,6 +311,7 @@ class DataCacheBase {
     internal::PinnedCacheEntry<MetadataCache> metadata_cache_entry;
     MetadataPtr metadata;
     Context::Resource<internal::CachePoolResource> cache_pool;
+    Context::Resource<internal::DiskCacheResource> disk_cache;
   };
 
   explicit DataCacheBase(Initializer&& initializer);
@@ -404,6 +407,7 @@ class DataCacheBase {
   const internal::PinnedCacheEntry<MetadataCache> metadata_cache_entry_;
   const MetadataPtr initial_metadata_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
+  Context::Resource<internal::DiskCacheResource> disk_cache_;
 };
 
 /// Abstract base class for `Cache` types that are used with
@@ -730,6 +734,12 @@ class MetadataOpenState
     return spec_->metadata_cache_pool ? *spec_->metadata_cache_pool
                                       : spec_->cache_pool;
   }
+
+  /// Returns the secondary cache tier for encoded chunks, which is disabled
+  /// unless a path is specified.
+  const Context::Resource<internal::DiskCacheResource>& disk_cache() const {
+    return spec_->disk_cache;
+  }
 };
 
 /// Extends `MetadataOpenState` with integration with a "data cache"
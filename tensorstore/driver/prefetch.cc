@@ -0,0 +1,230 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/prefetch.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/chunk_cell_scheduler.h"
+#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/index_space/output_index_method.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/read_write_options.h"
+#include "tensorstore/resize_options.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+
+namespace {
+
+/// Local state for the asynchronous operation initiated by `DriverPrefetch`.
+///
+/// `DriverPrefetch` asynchronously performs the following steps:
+///
+/// 1. Resolves the bounds in `source` via `Driver::ResolveBounds`, and then
+///    continues with `PrefetchInitiateOp`.
+///
+/// 2. Partitions the resolved domain into cells of the read chunk grid using
+///    `ChunkCellScheduler`, and calls `IssueReads` to read as many cells as
+///    `bytes_limit` permits.
+///
+/// 3. As each read stops, `PrefetchReceiver` releases its bytes and calls
+///    `IssueReads` again to read the next cells.
+///
+/// 4. Once all cells have been read (or an error occurred, or all references
+///    to the future associated with `promise` were released), all references
+///    to `PrefetchState` are released, which causes `promise` to become ready.
+struct PrefetchState : public AtomicReferenceCount<PrefetchState> {
+  DriverPtr driver;
+  Batch batch{no_batch};
+  Index bytes_limit;
+  Promise<void> promise;
+  IndexTransform<> transform;
+  ChunkCellScheduler cells;
+
+  void SetError(absl::Status error) {
+    SetDeferredResult(promise, std::move(error));
+    cells.Stop();
+  }
+
+  /// Reads cells until `bytes_limit` is reached.
+  void IssueReads(Batch batch);
+};
+
+/// FlowReceiver used by `DriverPrefetch` to await the read of a single cell.
+///
+/// The chunks are discarded, since `Driver::Read` only emits a chunk after it
+/// has been read into the cache.
+struct PrefetchReceiver {
+  IntrusivePtr<PrefetchState> state;
+  Index bytes;
+  FutureCallbackRegistration cancel_registration;
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration =
+        state->promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+  void set_stopping() {
+    cancel_registration();
+    state->cells.Release(bytes);
+    state->IssueReads(no_batch);
+  }
+  void set_done() {}
+  void set_error(absl::Status error) { state->SetError(std::move(error)); }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {}
+};
+
+void PrefetchState::IssueReads(Batch batch) {
+  if (!promise.result_needed()) {
+    cells.Stop();
+    return;
+  }
+  cells.StartCells([&](Box<> cell, Index bytes) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto cell_transform,
+        ComposeTransforms(transform, IdentityTransform(cell)), SetError(_));
+    Driver::ReadRequest request;
+    request.batch = batch;
+    request.transform = std::move(cell_transform);
+    driver->Read(std::move(request),
+                 PrefetchReceiver{IntrusivePtr<PrefetchState>(this), bytes});
+  });
+}
+
+/// Callback used by `DriverPrefetch` to initiate the reads once the source
+/// transform bounds have been resolved.
+struct PrefetchInitiateOp {
+  IntrusivePtr<PrefetchState> state;
+  void operator()(Promise<void> promise,
+                  ReadyFuture<IndexTransform<>> transform_future) {
+    IndexTransform<> transform = std::move(transform_future.value());
+    if (!IsFinite(transform.domain())) {
+      promise.SetResult(absl::InvalidArgumentError(tensorstore::StrCat(
+          "Prefetch requires a finite domain, got ", transform.domain())));
+      return;
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto layout, state->driver->GetChunkLayout(transform),
+        static_cast<void>(promise.SetResult(_)));
+    state->promise = std::move(promise);
+    state->cells.Initialize(transform.domain().box(), layout,
+                            state->driver->dtype().size(), state->bytes_limit);
+    state->transform = std::move(transform);
+    auto batch = std::move(state->batch);
+    state->IssueReads(std::move(batch));
+  }
+};
+
+}  // namespace
+
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()));
+  IntrusivePtr<PrefetchState> state(new PrefetchState);
+  state->driver = std::move(source.driver);
+  state->batch = std::move(options.batch);
+  state->bytes_limit = options.bytes_limit.value;
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+
+  // Resolve the bounds for `source.transform`.
+  Driver::ResolveBoundsRequest request;
+  request.transform = std::move(source.transform);
+  request.options.Set(fix_resizable_bounds).IgnoreError();
+  auto transform_future = state->driver->ResolveBounds(std::move(request));
+
+  // Initiate the reads once the bounds have been resolved.
+  auto executor = state->driver->data_copy_executor();
+  LinkValue(WithExecutor(std::move(executor),
+                         PrefetchInitiateOp{std::move(state)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+void DriverReadAhead(DriverPtr driver, IndexTransformView<> transform,
+                     const ReadAhead& read_ahead) {
+  const DimensionIndex input_dim = read_ahead.dimension;
+  if (read_ahead.count <= 0 || input_dim < 0 ||
+      input_dim >= transform.input_rank()) {
+    return;
+  }
+  const Index extent = transform.input_shape()[input_dim];
+  if (extent <= 0) return;
+
+  // Compute the output range of `transform`, and shift it along the output
+  // dimensions that depend on `input_dim`.
+  Box<> range(transform.output_rank());
+  if (!GetOutputRange(transform, range).ok()) return;
+  bool shifted = false;
+  for (DimensionIndex output_dim = 0; output_dim < range.rank();
+       ++output_dim) {
+    const auto map = transform.output_index_maps()[output_dim];
+    if (map.method() != OutputIndexMethod::single_input_dimension ||
+        map.input_dimension() != input_dim || map.stride() == 0) {
+      continue;
+    }
+    Index first_offset, last_offset;
+    if (internal::MulOverflow(map.stride(), extent, &first_offset) ||
+        internal::MulOverflow(first_offset, read_ahead.count, &last_offset)) {
+      return;
+    }
+    auto first = ShiftInterval(range[output_dim], first_offset);
+    auto last = ShiftInterval(range[output_dim], last_offset);
+    if (!first.ok() || !last.ok()) return;
+    range[output_dim] = Hull(*first, *last);
+    shifted = true;
+  }
+  if (!shifted) return;
+
+  // Clip to the current bounds of `driver`.
+  Driver::ResolveBoundsRequest request;
+  request.transform = IdentityTransform(range.rank());
+  auto bounds_future = driver->ResolveBounds(std::move(request));
+  bounds_future.ExecuteWhenReady(
+      [driver = std::move(driver), range = std::move(range),
+       bytes_limit = read_ahead.bytes_limit](
+          ReadyFuture<IndexTransform<>> future) mutable {
+        if (!future.result().ok()) return;
+        auto bounds = future.value().domain().box();
+        for (DimensionIndex i = 0; i < range.rank(); ++i) {
+          range[i] = Intersect(range[i], bounds[i]);
+          if (range[i].empty()) return;
+        }
+        PrefetchOptions options;
+        options.bytes_limit = bytes_limit;
+        // Keep the prefetch alive until it completes.
+        DriverPrefetch({std::move(driver), IdentityTransform(range)},
+                       std::move(options))
+            .ExecuteWhenReady([](ReadyFuture<void> future) {});
+      });
+}
+
+}  // namespace internal
+}  // namespace tensorstore
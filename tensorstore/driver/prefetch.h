@@ -0,0 +1,61 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_PREFETCH_H_
+#define TENSORSTORE_DRIVER_PREFETCH_H_
+
+#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/read_write_options.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Reads the data in `source` in order to populate the driver's cache, without
+/// copying it anywhere.
+///
+/// The resolved domain of `source.transform` is partitioned into cells of the
+/// read chunk grid returned by `Driver::GetChunkLayout`, which are read in C
+/// order by separate calls to `Driver::Read`.  Reads are issued as long as the
+/// total size of the cells being read does not exceed
+/// `options.bytes_limit`; at least one cell is always read at a time.  The
+/// batch, if specified, is used only for the initial reads.
+///
+/// Since prefetching only warms the cache, `source.transaction` is ignored.
+///
+/// The returned future becomes ready once all cells have been read, or after
+/// the first error.  Releasing all references to the future cancels any reads
+/// that have not yet been issued.
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options);
+
+/// Prefetches, in the background, the data that follows the read of
+/// `transform` according to `read_ahead`.
+///
+/// The output range of `transform` is shifted along each output dimension
+/// that depends only on input dimension `read_ahead.dimension`, by `k` times
+/// the amount that `transform` covers along that dimension, for `k` from `1`
+/// to `read_ahead.count`.  The hull of the shifted ranges, clipped to the
+/// current bounds of `driver`, is prefetched as if by `DriverPrefetch`.
+///
+/// Has no effect if `read_ahead.count <= 0`, or if the output range of
+/// `transform` cannot be shifted along the specified dimension.
+void DriverReadAhead(DriverPtr driver, IndexTransformView<> transform,
+                     const ReadAhead& read_ahead);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_PREFETCH_H_
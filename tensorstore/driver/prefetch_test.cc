@@ -0,0 +1,219 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/prefetch.h"
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/read_write_options.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::BoxView;
+using ::tensorstore::ChunkLayout;
+using ::tensorstore::IdentityTransform;
+using ::tensorstore::IndexTransform;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::PrefetchBytesLimit;
+using ::tensorstore::PrefetchOptions;
+using ::tensorstore::ReadAhead;
+using ::tensorstore::internal::DriverPrefetch;
+using ::tensorstore::internal::DriverReadAhead;
+
+/// Driver with bounds `[0, 5) x [0, 7)` and a read chunk grid of `{2, 3}`,
+/// which records the reads requested of it without completing them.
+class RecordingDriver : public tensorstore::internal::Driver {
+ public:
+  tensorstore::DataType dtype() override { return tensorstore::dtype_v<int>; }
+  tensorstore::DimensionIndex rank() override { return 2; }
+
+  tensorstore::Result<ChunkLayout> GetChunkLayout(
+      tensorstore::IndexTransformView<> transform) override {
+    ChunkLayout layout;
+    TENSORSTORE_RETURN_IF_ERROR(
+        layout.Set(ChunkLayout::ReadChunkShape({2, 3})));
+    TENSORSTORE_RETURN_IF_ERROR(layout.Set(ChunkLayout::GridOrigin({0, 0})));
+    return ApplyIndexTransform(transform, std::move(layout));
+  }
+
+  tensorstore::Future<IndexTransform<>> ResolveBounds(
+      ResolveBoundsRequest request) override {
+    return tensorstore::PropagateExplicitBoundsToTransform(
+        BoxView({5, 7}), std::move(request.transform));
+  }
+
+  void Read(ReadRequest request, ReadChunkReceiver receiver) override {
+    tensorstore::execution::set_starting(receiver, [] {});
+    if (fail_reads) {
+      tensorstore::execution::set_error(receiver,
+                                        absl::UnknownError("Read error"));
+      tensorstore::execution::set_stopping(receiver);
+      return;
+    }
+    Box<> box(request.transform.output_rank());
+    TENSORSTORE_CHECK_OK(GetOutputRange(request.transform, box));
+    absl::MutexLock lock(&mutex);
+    boxes.push_back(std::move(box));
+    receivers.push_back(std::move(receiver));
+  }
+
+  /// Completes the `i`-th read.
+  void Complete(size_t i) {
+    ReadChunkReceiver receiver;
+    {
+      absl::MutexLock lock(&mutex);
+      receiver = std::move(receivers[i]);
+    }
+    tensorstore::execution::set_done(receiver);
+    tensorstore::execution::set_stopping(receiver);
+  }
+
+  std::vector<Box<>> GetBoxes() {
+    absl::MutexLock lock(&mutex);
+    return boxes;
+  }
+
+  void GarbageCollectionVisit(
+      tensorstore::garbage_collection::GarbageCollectionVisitor& visitor)
+      const final {
+    // No-op
+  }
+  tensorstore::Executor data_copy_executor() override {
+    return tensorstore::InlineExecutor{};
+  }
+
+  bool fail_reads = false;
+  absl::Mutex mutex;
+  std::vector<Box<>> boxes;
+  std::vector<ReadChunkReceiver> receivers;
+};
+
+tensorstore::internal::ReadWritePtr<RecordingDriver> MakeDriver() {
+  return tensorstore::internal::MakeReadWritePtr<RecordingDriver>(
+      tensorstore::ReadWriteMode::read);
+}
+
+TEST(PrefetchTest, ReadsChunkGridCells) {
+  auto driver = MakeDriver();
+  auto future = DriverPrefetch(
+      {driver, IdentityTransform(BoxView({1, 1}, {4, 5}))}, {});
+  EXPECT_THAT(driver->GetBoxes(),
+              ::testing::ElementsAre(
+                  Box({1, 1}, {1, 2}), Box({1, 3}, {1, 3}),
+                  Box({2, 1}, {2, 2}), Box({2, 3}, {2, 3}),
+                  Box({4, 1}, {1, 2}), Box({4, 3}, {1, 3})));
+  EXPECT_FALSE(future.ready());
+  for (size_t i = 0; i < 6; ++i) driver->Complete(i);
+  TENSORSTORE_EXPECT_OK(future.result());
+}
+
+TEST(PrefetchTest, BytesLimit) {
+  auto driver = MakeDriver();
+  PrefetchOptions options;
+  options.bytes_limit = PrefetchBytesLimit{6 * sizeof(int)};
+  auto future = DriverPrefetch(
+      {driver, IdentityTransform(BoxView({1, 1}, {4, 5}))}, options);
+  // The first two cells contain 2 and 3 elements; the third contains 4.
+  EXPECT_EQ(2, driver->GetBoxes().size());
+  driver->Complete(0);
+  EXPECT_EQ(2, driver->GetBoxes().size());
+  driver->Complete(1);
+  EXPECT_EQ(3, driver->GetBoxes().size());
+  driver->Complete(2);
+  EXPECT_EQ(4, driver->GetBoxes().size());
+  driver->Complete(3);
+  EXPECT_EQ(6, driver->GetBoxes().size());
+  driver->Complete(4);
+  driver->Complete(5);
+  TENSORSTORE_EXPECT_OK(future.result());
+}
+
+TEST(PrefetchTest, Cancel) {
+  auto driver = MakeDriver();
+  PrefetchOptions options;
+  options.bytes_limit = PrefetchBytesLimit{1};
+  auto future = DriverPrefetch({driver, IdentityTransform(BoxView({5, 7}))},
+                               options);
+  EXPECT_EQ(1, driver->GetBoxes().size());
+  future = tensorstore::Future<void>();
+  driver->Complete(0);
+  EXPECT_EQ(1, driver->GetBoxes().size());
+}
+
+TEST(PrefetchTest, Error) {
+  auto driver = MakeDriver();
+  driver->fail_reads = true;
+  EXPECT_THAT(
+      DriverPrefetch({driver, IdentityTransform(BoxView({5, 7}))}, {})
+          .result(),
+      MatchesStatus(absl::StatusCode::kUnknown, "Read error"));
+}
+
+TEST(PrefetchTest, OutOfBounds) {
+  auto driver = MakeDriver();
+  EXPECT_THAT(
+      DriverPrefetch({driver, IdentityTransform(BoxView({6, 7}))}, {})
+          .result(),
+      MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
+TEST(ReadAheadTest, PrefetchesFollowingRegion) {
+  auto driver = MakeDriver();
+  ReadAhead read_ahead;
+  read_ahead.dimension = 0;
+  read_ahead.count = 2;
+  DriverReadAhead(driver, IdentityTransform(BoxView({0, 1}, {2, 6})),
+                  read_ahead);
+  // Rows `[2, 6)` are clipped to the bounds.
+  EXPECT_THAT(driver->GetBoxes(),
+              ::testing::ElementsAre(
+                  Box({2, 1}, {2, 2}), Box({2, 3}, {2, 3}),
+                  Box({2, 6}, {2, 1}), Box({4, 1}, {1, 2}),
+                  Box({4, 3}, {1, 3}), Box({4, 6}, {1, 1})));
+}
+
+TEST(ReadAheadTest, NoFollowingRegion) {
+  auto driver = MakeDriver();
+  ReadAhead read_ahead;
+  read_ahead.dimension = 1;
+  read_ahead.count = 1;
+  DriverReadAhead(driver, IdentityTransform(BoxView({0, 4}, {5, 3})),
+                  read_ahead);
+  EXPECT_THAT(driver->GetBoxes(), ::testing::ElementsAre());
+}
+
+}  // namespace
@@ -30,6 +30,7 @@
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/prefetch.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
@@ -82,7 +83,8 @@ namespace {
 /// 3. Calls `Driver::Read` with a `ReadChunkReceiver` to initiate the actual
 ///    read over the resolved `source.transform` bounds.  `ReadChunkReceiver`
 ///    ensures that the read is canceled if `promise.result_needed()` becomes
-///    `false`.
+///    `false`.  If `read_ahead` is specified, the data that follows is also
+///    prefetched in the background via `DriverReadAhead`.
 ///
 /// 4. For each `ReadChunk` received, `ReadChunkReceiver` invokes `ReadChunkOp`
 ///    using `executor` to copy the data from the `ReadChunk` to the appropriate
@@ -107,6 +109,7 @@ struct ReadState
   TransformedArray<Shared<void>> target;
   DomainAlignmentOptions alignment_options;
   ReadProgressFunction read_progress_function;
+  ReadAhead read_ahead;
   Promise<PromiseValue> promise;
   std::atomic<Index> copied_elements{0};
   Index total_elements;
@@ -189,6 +192,7 @@ struct DriverReadIntoExistingInitiateOp {
 
     // Initiate the read on the driver.
     auto source_driver = std::move(state->source_driver);
+    DriverReadAhead(source_driver, source_transform, state->read_ahead);
     Driver::ReadRequest request;
     request.transaction = std::move(state->source_transaction);
     request.batch = std::move(state->source_batch);
@@ -225,6 +229,7 @@ struct DriverReadIntoNewInitiateOp {
 
     // Initiate the read on the driver.
     auto source_driver = std::move(state->source_driver);
+    DriverReadAhead(source_driver, source_transform, state->read_ahead);
     Driver::ReadRequest request;
     request.transaction = std::move(state->source_transaction);
     request.batch = std::move(state->source_batch);
@@ -257,6 +262,7 @@ Future<void> DriverRead(Executor executor, DriverHandle source,
   state->target = std::move(target);
   state->alignment_options = options.alignment_options;
   state->read_progress_function = std::move(options.progress_function);
+  state->read_ahead = options.read_ahead;
   auto pair = PromiseFuturePair<void>::Make(MakeResult());
 
   // Resolve the bounds for `source.transform`.
@@ -299,6 +305,7 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
       internal::AcquireOpenTransactionPtrOrError(source.transaction));
   state->source_batch = std::move(options.batch);
   state->read_progress_function = std::move(options.progress_function);
+  state->read_ahead = options.read_ahead;
   auto pair = PromiseFuturePair<SharedOffsetArray<void>>::Make();
 
   // Resolve the bounds for `source.transform`.
@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
@@ -39,6 +40,8 @@
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/arena.h"
+#include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
@@ -48,21 +51,30 @@
 #include "tensorstore/internal/grid_storage_statistics.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
+#include "tensorstore/internal/lock_collection.h"
+#include "tensorstore/internal/nditerable.h"
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/internal/storage_statistics.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/zarr3_sharding_indexed/zarr3_sharding_indexed.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal_zarr3 {
@@ -74,9 +86,180 @@ ZarrLeafChunkCache::ZarrLeafChunkCache(
     internal::CachePool::WeakPtr /*data_cache_pool*/)
     : Base(std::move(store)), codec_state_(std::move(codec_state)) {}
 
+namespace {
+
+// Grid cell of a read that is satisfied by reading only the byte range of the
+// encoded chunk that is required to decode the requested region.
+struct RegionReadCell {
+  internal::PinnedCacheEntry<ZarrLeafChunkCache> entry;
+  IndexTransform<> cell_transform;
+  IndexTransform<> cell_to_source;
+  // Requested region of the chunk, in the index space of the array.
+  Box<> domain;
+  // Requested region of the chunk, relative to the origin of the chunk.
+  Box<> region;
+  ByteRange byte_range;
+};
+
+// ReadChunk implementation for a region of a chunk that was decoded directly
+// from a partial read of the kvstore, bypassing the cache entry.
+//
+// This implements the `tensorstore::internal::ReadChunk::Impl` Poly interface.
+struct RegionReadChunkImpl {
+  internal::PinnedCacheEntry<ZarrLeafChunkCache> entry;
+  Box<> domain;
+  // Decoded region with a shape of `domain.shape()`, or a null array if the
+  // chunk is missing.
+  SharedArray<const void> array;
+  bool fill_missing_data_reads;
+
+  absl::Status operator()(internal::LockCollection& lock_collection) const {
+    // No locks are required, since `array` is immutable.
+    return absl::OkStatus();
+  }
+
+  Result<internal::NDIterable::Ptr> operator()(
+      internal::ReadChunk::BeginRead, IndexTransform<> chunk_transform,
+      internal::Arena* arena) const {
+    if (!fill_missing_data_reads && !array.valid()) {
+      return absl::NotFoundError(
+          tensorstore::StrCat(entry->DescribeChunk(), " is missing"));
+    }
+    return GetOwningCache(*entry)
+        .grid()
+        .components[0]
+        .array_spec.GetReadNDIterable(array, domain, std::move(chunk_transform),
+                                      arena);
+  }
+};
+
+// Determines whether the non-transactional read of `transform` can be
+// satisfied by reading only part of each chunk.
+//
+// This is the case if no chunk has cached data, none is read completely, and
+// the codec chain can decode a region from a byte range of the encoded chunk,
+// which requires that there are no "bytes -> bytes" codecs.  Complete chunks
+// and cached chunks are read through the cache instead.
+bool GetRegionReadCells(ZarrLeafChunkCache& cache, IndexTransform<> transform,
+                        std::vector<RegionReadCell>& cells) {
+  const auto& grid = cache.grid();
+  const auto& component_spec = grid.components[0];
+  internal_grid_partition::RegularGridRef regular_grid{grid.chunk_shape};
+  auto status = internal::PartitionIndexTransformOverGrid(
+      component_spec.chunked_to_cell_dimensions, regular_grid, transform,
+      [&](span<const Index> grid_cell_indices,
+          IndexTransformView<> cell_transform) -> absl::Status {
+        // Any error, including one that would also be encountered by the
+        // normal read path, results in falling back to that path.
+        const auto fallback = [] { return absl::CancelledError(""); };
+        auto entry = GetEntryForGridCell(cache, grid_cell_indices);
+        if (internal::AsyncCache::ReadLock<internal::ChunkCache::ReadData>(
+                *entry)
+                .stamp()
+                .time != absl::InfinitePast()) {
+          return fallback();
+        }
+        RegionReadCell cell;
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            cell.cell_to_source, ComposeTransforms(transform, cell_transform));
+        auto cell_domain = grid.GetCellDomain(0, grid_cell_indices);
+        const DimensionIndex rank = cell_domain.rank();
+        cell.domain = Box<>(rank);
+        TENSORSTORE_RETURN_IF_ERROR(
+            GetOutputRange(cell.cell_to_source, cell.domain));
+        cell.region = Box<>(rank);
+        bool complete = true;
+        for (DimensionIndex i = 0; i < rank; ++i) {
+          cell.domain[i] = Intersect(cell.domain[i], cell_domain[i]);
+          cell.region[i] = IndexInterval::UncheckedSized(
+              cell.domain.origin()[i] - cell_domain.origin()[i],
+              cell.domain.shape()[i]);
+          complete = complete && cell.domain[i] == cell_domain[i];
+        }
+        if (complete || cell.domain.is_empty()) return fallback();
+        auto byte_range = cache.codec_state_->GetDecodeByteRange(
+            cell_domain.shape(), cell.region);
+        if (!byte_range.IsRange()) return fallback();
+        cell.byte_range = byte_range.AsByteRange();
+        cell.entry = std::move(entry);
+        cell.cell_transform = IndexTransform<>(cell_transform);
+        cells.push_back(std::move(cell));
+        return absl::OkStatus();
+      });
+  return status.ok();
+}
+
+// Reads each of `cells` by reading just its byte range from the kvstore, and
+// decoding the requested region.
+void ReadRegions(ZarrLeafChunkCache& cache,
+                 ZarrChunkCache::ReadRequest request,
+                 std::vector<RegionReadCell> cells,
+                 AnyFlowReceiver<absl::Status, internal::ReadChunk,
+                                 IndexTransform<>>&& receiver) {
+  using State = internal::ChunkOperationState<internal::ReadChunk>;
+  auto state = internal::MakeIntrusivePtr<State>(std::move(receiver));
+  for (auto& cell : cells) {
+    if (state->cancelled()) {
+      state->SetError(absl::CancelledError(""));
+      return;
+    }
+    kvstore::ReadOptions options;
+    options.staleness_bound = request.staleness_bound;
+    options.byte_range = cell.byte_range;
+    options.batch = request.batch;
+    auto read_future = cache.GetKvStoreDriver()->Read(
+        cell.entry->GetKeyValueStoreKey(), std::move(options));
+    LinkValue(
+        [state, cell = std::move(cell),
+         fill_missing_data_reads = request.fill_missing_data_reads](
+            Promise<void> promise,
+            ReadyFuture<kvstore::ReadResult> future) mutable {
+          auto& cache = GetOwningCache(*cell.entry);
+          cache.executor()([state = std::move(state), cell = std::move(cell),
+                            fill_missing_data_reads,
+                            read_result = std::move(future.value())]() mutable {
+            auto& cache = GetOwningCache(*cell.entry);
+            SharedArray<const void> array;
+            if (read_result.has_value()) {
+              auto decoded = cache.codec_state_->DecodeArrayRegion(
+                  cache.grid().components[0].shape(), cell.region,
+                  std::move(read_result.value));
+              if (!decoded.ok()) {
+                state->SetError(cell.entry->AnnotateError(
+                    internal::ConvertInvalidArgumentToFailedPrecondition(
+                        std::move(decoded).status()),
+                    /*reading=*/true));
+                return;
+              }
+              array = *std::move(decoded);
+            }
+            internal::ReadChunk chunk;
+            chunk.transform = std::move(cell.cell_to_source);
+            chunk.impl = RegionReadChunkImpl{
+                std::move(cell.entry), std::move(cell.domain),
+                std::move(array), fill_missing_data_reads};
+            execution::set_value(state->shared_receiver->receiver,
+                                 std::move(chunk),
+                                 std::move(cell.cell_transform));
+          });
+        },
+        state->promise, std::move(read_future));
+  }
+}
+
+}  // namespace
+
 void ZarrLeafChunkCache::Read(ZarrChunkCache::ReadRequest request,
                               AnyFlowReceiver<absl::Status, internal::ReadChunk,
                                               IndexTransform<>>&& receiver) {
+  if (!request.transaction) {
+    std::vector<RegionReadCell> cells;
+    if (GetRegionReadCells(*this, request.transform, cells)) {
+      ReadRegions(*this, std::move(request), std::move(cells),
+                  std::move(receiver));
+      return;
+    }
+  }
   return internal::ChunkCache::Read(
       {static_cast<internal::DriverReadRequest&&>(request),
        /*component_index=*/0, request.staleness_bound,
@@ -450,10 +633,7 @@ void ZarrShardedChunkCache::Entry::DoInitialize() {
   }
   const auto& sharding_state = cache.sharding_codec_state();
 
-  auto sharding_kvstore = sharding_state.GetSubChunkKvstore(
-      cache.base_kvstore_,
-      cache.GetChunkStorageKeyParser().FormatKey(cell_indices()),
-      cache.executor(), internal::CachePool::WeakPtr(cache.pool()));
+  auto sharding_kvstore = cache.GetShardKvstore(*this);
   ZarrChunkCache* zarr_chunk_cache;
   internal::GetCache<internal::Cache>(
       // `cache.pool()` is the metadata cache pool, which may or may not be
@@ -486,6 +666,23 @@ kvstore::Driver* ZarrShardedChunkCache::GetKvStoreDriver() {
   return this->base_kvstore_.get();
 }
 
+kvstore::DriverPtr ZarrShardedChunkCache::GetShardKvstore(Entry& entry) {
+  auto make_kvstore = [&] {
+    return sharding_codec_state().GetSubChunkKvstore(
+        base_kvstore_,
+        GetChunkStorageKeyParser().FormatKey(entry.cell_indices()),
+        executor(), internal::CachePool::WeakPtr(pool()),
+        index_cache_pool_ ? index_cache_pool_
+                          : internal::CachePool::WeakPtr(pool()),
+        pin_index_);
+  };
+  if (!pin_index_) return make_kvstore();
+  absl::MutexLock lock(&shard_kvstores_mutex_);
+  auto& kvstore = shard_kvstores_[entry.key()];
+  if (!kvstore) kvstore = make_kvstore();
+  return kvstore;
+}
+
 Future<const void> ZarrShardedChunkCache::DeleteCell(
     span<const Index> grid_cell_indices,
     internal::OpenTransactionPtr transaction) {
@@ -494,5 +691,26 @@ Future<const void> ZarrShardedChunkCache::DeleteCell(
                               transaction, KeyRange{});
 }
 
+Future<const void> ZarrShardedChunkCache::PrefetchShardIndexes(
+    IndexTransform<> transform, absl::Time staleness_bound) {
+  const auto& grid = this->grid();
+  internal_grid_partition::RegularGridRef regular_grid{grid.chunk_shape};
+  std::vector<kvstore::DriverPtr> shard_kvstores;
+  TENSORSTORE_RETURN_IF_ERROR(internal::PartitionIndexTransformOverGrid(
+      grid.components[0].chunked_to_cell_dimensions, regular_grid, transform,
+      [&](span<const Index> grid_cell_indices,
+          IndexTransformView<> cell_transform) {
+        auto entry = GetEntryForGridCell(*this, grid_cell_indices);
+        if (!entry->sharding_error.ok()) {
+          return entry->sharding_error;
+        }
+        shard_kvstores.emplace_back(
+            entry->sub_chunk_cache->GetKvStoreDriver());
+        return absl::OkStatus();
+      }));
+  return zarr3_sharding_indexed::PrefetchShardIndexes(shard_kvstores,
+                                                      staleness_bound);
+}
+
 }  // namespace internal_zarr3
 }  // namespace tensorstore
@@ -21,6 +21,8 @@
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -213,6 +215,15 @@ class ZarrShardedChunkCache : public internal::Cache, public ZarrChunkCache {
   Future<const void> DeleteCell(span<const Index> grid_cell_indices,
                                 internal::OpenTransactionPtr transaction);
 
+  // Reads the shard indexes of all shards that intersect the output range of
+  // `transform` into the shard index cache of each shard, as a single batch.
+  //
+  // Only the indexes of the outermost level of sharding are read.  The
+  // indexes remain cached only if `pin_index_` is `true`, or if
+  // `index_cache_pool_` (or the metadata cache pool) has room for them.
+  Future<const void> PrefetchShardIndexes(IndexTransform<> transform,
+                                          absl::Time staleness_bound);
+
   class Entry : public internal::Cache::Entry {
    public:
     using OwningCache = ZarrShardedChunkCache;
@@ -237,12 +248,33 @@ class ZarrShardedChunkCache : public internal::Cache, public ZarrChunkCache {
 
   kvstore::Driver* GetKvStoreDriver() override;
 
+  // Returns the kvstore for the sub-chunks of the shard corresponding to
+  // `entry`.
+  //
+  // If `pin_index_` is `true`, the kvstore is retained by this cache, such
+  // that the shard index remains cached after `entry` is evicted.
+  kvstore::DriverPtr GetShardKvstore(Entry& entry);
+
   kvstore::DriverPtr base_kvstore_;
   ZarrCodecChain::PreparedState::Ptr codec_state_;
 
   // Data cache pool, if it differs from `this->pool()` (which is equal to the
   // metadata cache pool).
   internal::CachePool::WeakPtr data_cache_pool_;
+
+  // Cache pool for shard indexes.  If null, `this->pool()` is used.
+  internal::CachePool::WeakPtr index_cache_pool_;
+
+  // Indicates that shard indexes are kept cached for the lifetime of this
+  // cache once read.  Only applies to the outermost level of sharding.
+  bool pin_index_ = false;
+
+  absl::Mutex shard_kvstores_mutex_;
+
+  // Kvstore for each shard that has been accessed, keyed by the cache entry
+  // key.  Only used if `pin_index_` is `true`.
+  absl::flat_hash_map<std::string, kvstore::DriverPtr> shard_kvstores_
+      ABSL_GUARDED_BY(shard_kvstores_mutex_);
 };
 
 /// Chunk cache mixin for a chunk cache where the entire chunk cache corresponds
@@ -17,6 +17,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -28,7 +29,9 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include <blosc.h>
+#include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/string_reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
@@ -38,6 +41,8 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
@@ -53,23 +58,49 @@ class BloscCodec : public ZarrBytesToBytesCodec {
    public:
     Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
         riegeli::Writer& encoded_writer) const final {
-      return std::make_unique<blosc::BloscWriter>(
+      auto reservation = ZarrCodecThreadBudget::Acquire(budget_, nthreads_);
+      const int nthreads = reservation.threads();
+      return std::make_unique<WithCodecThreads<blosc::BloscWriter>>(
+          std::move(reservation),
           blosc::Options{codec_->cname.c_str(), codec_->clevel, codec_->shuffle,
-                         codec_->blocksize, codec_->typesize},
+                         codec_->blocksize, codec_->typesize, nthreads},
           encoded_writer);
     }
 
     Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
         riegeli::Reader& encoded_reader) const final {
-      return std::make_unique<blosc::BloscReader>(encoded_reader);
+      auto reservation = ZarrCodecThreadBudget::Acquire(budget_, nthreads_);
+      const int nthreads = reservation.threads();
+      return std::make_unique<WithCodecThreads<blosc::BloscReader>>(
+          std::move(reservation), encoded_reader, nthreads);
+    }
+
+    // Decodes only the blosc blocks that overlap `decoded_range`.
+    Result<std::unique_ptr<riegeli::Reader>> GetDecodeRangeReader(
+        riegeli::Reader& encoded_reader,
+        ByteRange decoded_range) const final {
+      absl::string_view encoded;
+      TENSORSTORE_RETURN_IF_ERROR(riegeli::ReadAll(encoded_reader, encoded));
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto decoded,
+          blosc::DecodeRange(encoded, decoded_range.inclusive_min,
+                             decoded_range.size()));
+      return std::make_unique<riegeli::StringReader<std::string>>(
+          std::move(decoded));
     }
 
     const BloscCodec* codec_;
+    int nthreads_;
+    ZarrCodecThreadBudget::Ptr budget_;
   };
 
-  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+  Result<PreparedState::Ptr> Prepare(
+      int64_t decoded_size,
+      const ZarrCodecConcurrency& concurrency) const final {
     auto state = internal::MakeIntrusivePtr<State>();
     state->codec_ = this;
+    state->nthreads_ = std::max(1, concurrency.threads.value_or(nthreads));
+    state->budget_ = concurrency.budget;
     return state;
   }
 
@@ -78,6 +109,7 @@ class BloscCodec : public ZarrBytesToBytesCodec {
   int shuffle;
   size_t typesize;
   size_t blocksize;
+  int nthreads;
 };
 
 constexpr auto ShuffleBinder() {
@@ -103,6 +135,8 @@ absl::Status BloscCodecSpec::MergeFrom(const ZarrCodecSpec& other,
       MergeConstraint<&Options::typesize>("typesize", options, other_options));
   TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::blocksize>(
       "blocksize", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(
+      MergeConstraint<&Options::nthreads>("nthreads", options, other_options));
   return absl::OkStatus();
 }
 
@@ -139,6 +173,9 @@ Result<ZarrBytesToBytesCodec::Ptr> BloscCodecSpec::Resolve(
   codec->shuffle =
       shuffle.value_or(codec->typesize == 1 ? BLOSC_BITSHUFFLE : BLOSC_SHUFFLE);
   codec->blocksize = options.blocksize.value_or(0);
+  codec->nthreads = options.nthreads.value_or(1);
+  // `nthreads` is excluded from the resolved spec since it does not affect the
+  // encoded representation.
   if (resolved_spec) {
     auto spec = internal::MakeIntrusivePtr<BloscCodecSpec>();
     auto& resolved_options = spec->options;
@@ -203,7 +240,10 @@ TENSORSTORE_GLOBAL_INITIALIZER {
           jb::Member(
               "blocksize",
               jb::Projection<&Options::blocksize>(OptionalIfConstraintsBinder(
-                  jb::Integer<size_t>(0, BLOSC_MAX_BLOCKSIZE))))
+                  jb::Integer<size_t>(0, BLOSC_MAX_BLOCKSIZE)))),
+          jb::Member("nthreads",
+                     jb::Projection<&Options::nthreads>(jb::Optional(
+                         jb::Integer<int>(1, BLOSC_MAX_THREADS))))
           //
           )));
 }
@@ -37,6 +37,11 @@ class BloscCodecSpec : public ZarrBytesToBytesCodecSpec {
     std::optional<int> shuffle;
     std::optional<size_t> typesize;
     std::optional<size_t> blocksize;
+
+    // Number of threads used to encode and decode each chunk.  This only
+    // affects how chunks are encoded and decoded, and is not included in the
+    // resolved spec.
+    std::optional<int> nthreads;
   };
   BloscCodecSpec() = default;
   BloscCodecSpec(Options&& options) : options(std::move(options)) {}
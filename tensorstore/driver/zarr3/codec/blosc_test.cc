@@ -18,8 +18,10 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/util/status_testutil.h"
 
@@ -34,7 +36,9 @@ using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::TestCodecMerge;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal::MakeIntrusivePtr;
 using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+using ::tensorstore::internal_zarr3::ZarrCodecThreadBudget;
 
 TEST(BloscTest, Precise) {
   CodecSpecRoundTripTestParams p;
@@ -99,6 +103,60 @@ TEST(BloscTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+TEST(BloscTest, NthreadsNotResolved) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "blosc"},
+       {"configuration",
+        {
+            {"cname", "lz4"},
+            {"clevel", 4},
+            {"shuffle", "noshuffle"},
+            {"blocksize", 128},
+            {"nthreads", 4},
+        }}},
+  };
+  p.expected_spec = {GetDefaultBytesCodecJson(),
+                     {{"name", "blosc"},
+                      {"configuration",
+                       {
+                           {"cname", "lz4"},
+                           {"clevel", 4},
+                           {"shuffle", "noshuffle"},
+                           {"blocksize", 128},
+                       }}}};
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BloscTest, RoundTripNthreads) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "blosc"}, {"configuration", {{"nthreads", 4}}}}};
+  TestCodecRoundTrip(p);
+}
+
+TEST(BloscTest, RoundTripThreadsFromBudget) {
+  CodecRoundTripTestParams p;
+  p.spec = {"blosc"};
+  p.concurrency.threads = 4;
+  p.concurrency.budget = MakeIntrusivePtr<ZarrCodecThreadBudget>(2);
+  TestCodecRoundTrip(p);
+}
+
+TEST(ZarrCodecThreadBudgetTest, Acquire) {
+  auto budget = MakeIntrusivePtr<ZarrCodecThreadBudget>(4);
+  auto a = ZarrCodecThreadBudget::Acquire(budget, 3);
+  EXPECT_EQ(3, a.threads());
+  auto b = ZarrCodecThreadBudget::Acquire(budget, 3);
+  EXPECT_EQ(1, b.threads());
+  // Once the budget is exhausted, only the calling thread is granted.
+  auto c = ZarrCodecThreadBudget::Acquire(budget, 3);
+  EXPECT_EQ(1, c.threads());
+  a = ZarrCodecThreadBudget::Reservation();
+  auto d = ZarrCodecThreadBudget::Acquire(budget, 3);
+  EXPECT_EQ(2, d.threads());
+  EXPECT_EQ(5, ZarrCodecThreadBudget::Acquire(nullptr, 5).threads());
+}
+
 TEST(BloscTest, MergeCnameMismatch) {
   EXPECT_THAT(
       TestCodecMerge({{{"name", "blosc"},
@@ -20,11 +20,13 @@
 #include <optional>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
@@ -40,8 +42,12 @@
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/riegeli/array_endian_codec.h"
 #include "tensorstore/internal/unaligned_data_type_functions.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/strided_layout.h"
+#include "tensorstore/util/element_pointer.h"
 #include "tensorstore/util/endian.h"
+#include "tensorstore/util/iterate_over_index_range.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -62,7 +68,8 @@ class BytesCodec : public ZarrArrayToBytesCodec {
       : dtype_(decoded_dtype), endianness_(endianness) {}
 
   Result<PreparedState::Ptr> Prepare(
-      span<const Index> decoded_shape) const final;
+      span<const Index> decoded_shape,
+      const ZarrCodecConcurrency& concurrency) const final;
 
  private:
   DataType dtype_;
@@ -195,6 +202,74 @@ class BytesCodecPreparedState : public ZarrArrayToBytesCodec::PreparedState {
                                        endianness_, c_order);
   }
 
+  OptionalByteRangeRequest GetDecodeByteRange(
+      span<const Index> decoded_shape, BoxView<> region) const final {
+    if (region.is_empty()) return OptionalByteRangeRequest::Range(0, 0);
+    // The encoded representation is in C order, and the byte range extends
+    // from the first to the last element of `region`.
+    Index inclusive_min = 0;
+    Index last = 0;
+    Index byte_stride = dtype_.size();
+    for (DimensionIndex i = region.rank(); i--;) {
+      inclusive_min += region.origin()[i] * byte_stride;
+      last += (region.origin()[i] + region.shape()[i] - 1) * byte_stride;
+      byte_stride *= decoded_shape[i];
+    }
+    return OptionalByteRangeRequest::Range(inclusive_min,
+                                           last + dtype_.size());
+  }
+
+  Result<SharedArray<const void>> DecodeArrayRegion(
+      span<const Index> decoded_shape, BoxView<> region,
+      riegeli::Reader& reader) const final {
+    const DimensionIndex rank = region.rank();
+    auto decoded = AllocateArray(region.shape(), c_order, default_init, dtype_);
+    if (decoded.num_elements() == 0) return decoded;
+    std::vector<Index> encoded_byte_strides(rank);
+    ComputeStrides(c_order, dtype_.size(), decoded_shape,
+                   encoded_byte_strides);
+
+    // Each run of elements that is contiguous in both the encoded
+    // representation and `decoded` is read separately.  The inner dimensions
+    // that `region` covers completely are part of a single run.
+    DimensionIndex run_dim = rank;
+    Index run_elements = 1;
+    while (run_dim > 0) {
+      const DimensionIndex i = run_dim - 1;
+      run_elements *= region.shape()[i];
+      run_dim = i;
+      if (region.shape()[i] != decoded_shape[i]) break;
+    }
+    const Index element_size = dtype_.size();
+    const riegeli::Position start_pos = reader.pos();
+    absl::Status status;
+    IterateOverIndexRange(
+        span<const Index>(region.shape().data(), run_dim),
+        [&](span<const Index> indices) {
+          Index encoded_offset = 0;
+          Index decoded_offset = 0;
+          for (DimensionIndex i = 0; i < run_dim; ++i) {
+            encoded_offset += indices[i] * encoded_byte_strides[i];
+            decoded_offset += indices[i] * decoded.byte_strides()[i];
+          }
+          if (!reader.Seek(start_pos + encoded_offset)) {
+            status = reader.ok() ? absl::DataLossError("Unexpected end of data")
+                                 : reader.status();
+            return false;
+          }
+          ArrayView<void> run(
+              ElementPointer<void>(
+                  AddByteOffset(decoded.data(), decoded_offset), dtype_),
+              StridedLayoutView<>(span<const Index>(&run_elements, 1),
+                                  span<const Index>(&element_size, 1)));
+          status = internal::DecodeArrayEndian(reader, endianness_, c_order,
+                                               run);
+          return status.ok();
+        });
+    TENSORSTORE_RETURN_IF_ERROR(status);
+    return decoded;
+  }
+
   DataType dtype_;
   endian endianness_;
   int64_t encoded_size_;
@@ -202,7 +277,8 @@ class BytesCodecPreparedState : public ZarrArrayToBytesCodec::PreparedState {
 }  // namespace
 
 Result<ZarrArrayToBytesCodec::PreparedState::Ptr> BytesCodec::Prepare(
-    span<const Index> decoded_shape) const {
+    span<const Index> decoded_shape,
+    const ZarrCodecConcurrency& concurrency) const {
   int64_t bytes = dtype_.size();
   for (auto size : decoded_shape) {
     if (internal::MulOverflow(size, bytes, &bytes)) {
@@ -14,30 +14,62 @@
 
 #include <stdint.h>
 
+#include <utility>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/index.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status_testutil.h"
 
 namespace {
 
+using ::tensorstore::BoxView;
+using ::tensorstore::DimensionIndex;
 using ::tensorstore::dtype_v;
+using ::tensorstore::Index;
 using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::Result;
+using ::tensorstore::span;
 using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChain;
 using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
 
+Result<ZarrCodecChain::Ptr> ResolveCodecChain(::nlohmann::json spec,
+                                              DimensionIndex rank) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto codec_chain_spec,
+                               ZarrCodecChainSpec::FromJson(spec));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.rank = rank;
+  decoded_params.dtype = dtype_v<uint16_t>;
+  decoded_params.fill_value =
+      tensorstore::AllocateArray(span<const Index>{}, tensorstore::c_order,
+                                 tensorstore::value_init, decoded_params.dtype);
+  BytesCodecResolveParameters encoded_params;
+  return codec_chain_spec.Resolve(std::move(decoded_params), encoded_params);
+}
+
 TEST(BytesTest, SpecRoundTrip) {
   CodecSpecRoundTripTestParams p;
   p.orig_spec = {"bytes"};
@@ -61,6 +93,50 @@ TEST(BytesTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+// Tests that only the byte range that overlaps the region is required to
+// decode a region.
+TEST(BytesTest, DecodeByteRange) {
+  const Index shape[] = {30, 40, 50};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain, ResolveCodecChain(GetDefaultBytesCodecJson(), 3));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto state, codec_chain->Prepare(shape));
+  EXPECT_EQ(OptionalByteRangeRequest::Range(15 * 4000, 16 * 4000),
+            state->GetDecodeByteRange(shape, BoxView({15, 0, 0}, {1, 40, 50})));
+  EXPECT_EQ(
+      OptionalByteRangeRequest::Range(15 * 4000 + 2 * 100 + 2 * 3,
+                                      15 * 4000 + 4 * 100 + 2 * 8),
+      state->GetDecodeByteRange(shape, BoxView({15, 2, 3}, {1, 3, 5})));
+  EXPECT_EQ(OptionalByteRangeRequest::Range(0, 0),
+            state->GetDecodeByteRange(shape, BoxView({15, 0, 0}, {0, 40, 50})));
+}
+
+// Tests that a slice along the last dimension is contiguous if the "bytes"
+// codec is preceded by a "transpose" codec that reverses the dimensions.
+TEST(BytesTest, DecodeByteRangeTranspose) {
+  const Index shape[] = {30, 40, 50};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain,
+      ResolveCodecChain({{{"name", "transpose"},
+                          {"configuration", {{"order", {2, 1, 0}}}}},
+                         GetDefaultBytesCodecJson()},
+                        3));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto state, codec_chain->Prepare(shape));
+  EXPECT_EQ(OptionalByteRangeRequest::Range(10 * 2400, 11 * 2400),
+            state->GetDecodeByteRange(shape, BoxView({0, 0, 10}, {30, 40, 1})));
+}
+
+// Tests that the complete encoded representation is required if there is a
+// "bytes -> bytes" codec.
+TEST(BytesTest, DecodeByteRangeCompressed) {
+  const Index shape[] = {30, 40, 50};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain,
+      ResolveCodecChain({GetDefaultBytesCodecJson(), {{"name", "gzip"}}}, 3));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto state, codec_chain->Prepare(shape));
+  EXPECT_EQ(OptionalByteRangeRequest(),
+            state->GetDecodeByteRange(shape, BoxView({15, 0, 0}, {1, 40, 50})));
+}
+
 TEST(BytesTest, AutomaticTranspose) {
   ArrayCodecResolveParameters p;
   p.dtype = dtype_v<uint16_t>;
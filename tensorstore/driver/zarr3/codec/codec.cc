@@ -17,8 +17,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
@@ -26,9 +30,12 @@
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/strided_layout.h"
+#include "tensorstore/util/element_pointer.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -44,6 +51,42 @@ ZarrArrayToArrayCodec::PreparedState::~PreparedState() = default;
 ZarrArrayToBytesCodec::PreparedState::~PreparedState() = default;
 ZarrBytesToBytesCodec::PreparedState::~PreparedState() = default;
 
+ZarrCodecThreadBudget::Reservation&
+ZarrCodecThreadBudget::Reservation::operator=(Reservation&& other) noexcept {
+  if (this != &other) {
+    Reservation released(std::move(*this));
+    budget_ = std::move(other.budget_);
+    threads_ = other.threads_;
+  }
+  return *this;
+}
+
+ZarrCodecThreadBudget::Reservation::~Reservation() {
+  if (budget_) {
+    budget_->in_use_.fetch_sub(threads_, std::memory_order_acq_rel);
+  }
+}
+
+ZarrCodecThreadBudget::Reservation ZarrCodecThreadBudget::Acquire(
+    const Ptr& budget, int threads) {
+  Reservation reservation;
+  threads = std::max(1, threads);
+  if (!budget) {
+    reservation.threads_ = threads;
+    return reservation;
+  }
+  // The chunk's own thread is always granted, even if the budget is exhausted.
+  int in_use = budget->in_use_.load(std::memory_order_relaxed);
+  int granted;
+  do {
+    granted = std::max(1, std::min(threads, budget->limit_ - in_use));
+  } while (!budget->in_use_.compare_exchange_weak(
+      in_use, in_use + granted, std::memory_order_acq_rel));
+  reservation.budget_ = budget;
+  reservation.threads_ = granted;
+  return reservation;
+}
+
 int64_t ZarrArrayToBytesCodec::PreparedState::encoded_size() const {
   return -1;
 }
@@ -52,6 +95,55 @@ int64_t ZarrBytesToBytesCodec::PreparedState::encoded_size() const {
   return -1;
 }
 
+namespace {
+// Returns a zero-origin view of `region` of `array`.
+SharedArray<const void> GetArrayRegion(SharedArray<const void> array,
+                                       BoxView<> region) {
+  assert(array.rank() == region.rank());
+  SharedArray<const void> result;
+  result.layout().set_rank(region.rank());
+  Index byte_offset = 0;
+  for (DimensionIndex i = 0; i < region.rank(); ++i) {
+    byte_offset += region.origin()[i] * array.byte_strides()[i];
+    result.shape()[i] = region.shape()[i];
+    result.byte_strides()[i] = array.byte_strides()[i];
+  }
+  result.element_pointer() =
+      AddByteOffset(std::move(array.element_pointer()), byte_offset);
+  return result;
+}
+}  // namespace
+
+bool ZarrArrayToArrayCodec::PreparedState::GetEncodedRegion(
+    BoxView<> decoded_region, MutableBoxView<> encoded_region) const {
+  return false;
+}
+
+OptionalByteRangeRequest
+ZarrArrayToBytesCodec::PreparedState::GetDecodeByteRange(
+    span<const Index> decoded_shape, BoxView<> region) const {
+  return {};
+}
+
+Result<SharedArray<const void>>
+ZarrArrayToBytesCodec::PreparedState::DecodeArrayRegion(
+    span<const Index> decoded_shape, BoxView<> region,
+    riegeli::Reader& reader) const {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto array, DecodeArray(decoded_shape, reader));
+  return GetArrayRegion(std::move(array), region);
+}
+
+Result<std::unique_ptr<riegeli::Reader>>
+ZarrBytesToBytesCodec::PreparedState::GetDecodeRangeReader(
+    riegeli::Reader& encoded_reader, ByteRange decoded_range) const {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto reader, GetDecodeReader(encoded_reader));
+  if (!reader->Skip(decoded_range.inclusive_min)) {
+    return reader->ok() ? absl::DataLossError("Unexpected end of data")
+                        : reader->status();
+  }
+  return reader;
+}
+
 bool ZarrShardingCodec::is_sharding_codec() const { return true; }
 
 absl::Status ZarrCodecChain::PreparedState::EncodeArray(
@@ -148,8 +240,105 @@ Result<SharedArray<const void>> ZarrCodecChain::PreparedState::DecodeArray(
   return array;
 }
 
+bool ZarrCodecChain::PreparedState::GetEncodedRegions(
+    BoxView<> region, std::vector<Box<>>& regions) const {
+  regions.clear();
+  regions.reserve(array_to_array.size() + 1);
+  regions.emplace_back(region);
+  for (const auto& codec : array_to_array) {
+    Box<> encoded_region(codec->encoded_shape().size());
+    if (!codec->GetEncodedRegion(regions.back(), encoded_region)) {
+      return false;
+    }
+    regions.push_back(std::move(encoded_region));
+  }
+  return true;
+}
+
+OptionalByteRangeRequest ZarrCodecChain::PreparedState::GetDecodeByteRange(
+    span<const Index> decoded_shape, BoxView<> region) const {
+  std::vector<Box<>> regions;
+  if (!bytes_to_bytes.empty() || !GetEncodedRegions(region, regions)) {
+    return {};
+  }
+  return array_to_bytes->GetDecodeByteRange(
+      array_to_array.empty() ? decoded_shape
+                             : array_to_array.back()->encoded_shape(),
+      regions.back());
+}
+
+Result<SharedArray<const void>>
+ZarrCodecChain::PreparedState::DecodeArrayRegion(
+    span<const Index> decoded_shape, BoxView<> region,
+    riegeli::Reader& reader) const {
+  assert(region.rank() == decoded_shape.size());
+  std::vector<Box<>> regions;
+  if (!GetEncodedRegions(region, regions)) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto array,
+                                 DecodeArray(decoded_shape, reader));
+    return GetArrayRegion(std::move(array), region);
+  }
+  const span<const Index> encoded_shape =
+      array_to_array.empty() ? decoded_shape
+                             : array_to_array.back()->encoded_shape();
+
+  constexpr size_t kNumInlineCodecs = 8;
+  // Compose the bytes -> bytes readers.  Only the innermost codec, which
+  // produces the input to the array -> bytes codec, can be restricted to a
+  // byte range.
+  absl::InlinedVector<std::unique_ptr<riegeli::Reader>, kNumInlineCodecs>
+      readers;
+  readers.reserve(bytes_to_bytes.size());
+  riegeli::Reader* outer_reader = &reader;
+  for (size_t i = bytes_to_bytes.size(); i--;) {
+    std::unique_ptr<riegeli::Reader> new_reader;
+    if (i == 0) {
+      auto byte_range =
+          array_to_bytes->GetDecodeByteRange(encoded_shape, regions.back());
+      if (byte_range.IsRange()) {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            new_reader, bytes_to_bytes[i]->GetDecodeRangeReader(
+                            *outer_reader, byte_range.AsByteRange()));
+      }
+    }
+    if (!new_reader) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          new_reader, bytes_to_bytes[i]->GetDecodeReader(*outer_reader));
+      new_reader->SetReadAllHint(true);
+    }
+    outer_reader = new_reader.get();
+    readers.push_back(std::move(new_reader));
+  }
+
+  // Decode from composed `outer_reader` using array -> bytes codec.
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto array, array_to_bytes->DecodeArrayRegion(
+                      encoded_shape, regions.back(), *outer_reader));
+
+  // Unlike for `DecodeArray`, the readers are not required to reach the end.
+  for (size_t i = readers.size(); i--;) {
+    auto& r = *readers[i];
+    if (!r.Close()) {
+      return r.status();
+    }
+  }
+
+  if (!reader.Close()) {
+    return reader.status();
+  }
+
+  // Decode using array -> array codecs.
+  for (size_t i = array_to_array.size(); i--;) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        array, array_to_array[i]->DecodeArray(std::move(array),
+                                              regions[i].shape()));
+  }
+  return array;
+}
+
 Result<ZarrCodecChain::PreparedState::Ptr> ZarrCodecChain::Prepare(
-    span<const Index> decoded_shape) const {
+    span<const Index> decoded_shape,
+    const ZarrCodecConcurrency& concurrency) const {
   auto state = internal::MakeIntrusivePtr<PreparedState>();
   for (const auto& codec : array_to_array) {
     TENSORSTORE_ASSIGN_OR_RETURN(auto codec_state,
@@ -158,11 +347,12 @@ Result<ZarrCodecChain::PreparedState::Ptr> ZarrCodecChain::Prepare(
     state->array_to_array.push_back(std::move(codec_state));
   }
   TENSORSTORE_ASSIGN_OR_RETURN(state->array_to_bytes,
-                               array_to_bytes->Prepare(decoded_shape));
+                               array_to_bytes->Prepare(decoded_shape,
+                                                       concurrency));
   int64_t encoded_size = state->array_to_bytes->encoded_size();
   for (const auto& codec : bytes_to_bytes) {
     TENSORSTORE_ASSIGN_OR_RETURN(auto codec_state,
-                                 codec->Prepare(encoded_size));
+                                 codec->Prepare(encoded_size, concurrency));
     encoded_size = codec_state->encoded_size();
     state->bytes_to_bytes.push_back(std::move(codec_state));
   }
@@ -184,5 +374,12 @@ Result<SharedArray<const void>> ZarrCodecChain::PreparedState::DecodeArray(
   return this->DecodeArray(decoded_shape, reader);
 }
 
+Result<SharedArray<const void>>
+ZarrCodecChain::PreparedState::DecodeArrayRegion(
+    span<const Index> decoded_shape, BoxView<> region, absl::Cord cord) const {
+  riegeli::CordReader reader{&cord};
+  return this->DecodeArrayRegion(decoded_shape, region, reader);
+}
+
 }  // namespace internal_zarr3
 }  // namespace tensorstore
@@ -44,9 +44,12 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -54,6 +57,7 @@
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_transform.h"
@@ -62,6 +66,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/executor.h"
@@ -71,6 +76,80 @@
 namespace tensorstore {
 namespace internal_zarr3 {
 
+// Shared limit on the number of threads used by codecs that encode or decode a
+// single chunk with multiple threads, such as "blosc" and "zstd".
+//
+// Each chunk being encoded or decoded by such a codec counts its own thread,
+// and obtains additional threads only while the total is below the limit.
+// Since the `data_copy_concurrency` executor encodes and decodes at most
+// `limit` chunks at once, the threads used by all chunks sharing a budget are
+// bounded by `limit`, rather than by `limit * limit` as with a per-chunk cap.
+class ZarrCodecThreadBudget
+    : public internal::AtomicReferenceCount<ZarrCodecThreadBudget> {
+ public:
+  using Ptr = internal::IntrusivePtr<ZarrCodecThreadBudget>;
+
+  explicit ZarrCodecThreadBudget(int limit) : limit_(limit) {}
+
+  // Threads reserved to encode or decode a single chunk, which are returned to
+  // the budget when the reservation is destroyed.
+  class Reservation {
+   public:
+    Reservation() = default;
+    Reservation(Reservation&& other) noexcept
+        : budget_(std::move(other.budget_)), threads_(other.threads_) {}
+    Reservation& operator=(Reservation&& other) noexcept;
+    ~Reservation();
+
+    // Number of threads, including the calling thread, that may be used.
+    int threads() const { return threads_; }
+
+   private:
+    friend class ZarrCodecThreadBudget;
+    Ptr budget_;
+    int threads_ = 1;
+  };
+
+  // Reserves between 1 and `threads` threads from `budget`, depending on how
+  // many are available.  Never blocks.  If `budget` is null, all `threads` are
+  // reserved.
+  static Reservation Acquire(const Ptr& budget, int threads);
+
+  int limit() const { return limit_; }
+
+ private:
+  int limit_;
+  std::atomic<int> in_use_{0};
+};
+
+// Controls the threads used by codecs that encode or decode a single chunk
+// with multiple threads.  None of these options affect the encoded
+// representation.
+struct ZarrCodecConcurrency {
+  // Number of threads used to encode or decode each chunk, overriding the
+  // number specified by the codec ("nthreads" for "blosc", "nb_workers" for
+  // "zstd").
+  std::optional<int> threads;
+
+  // Budget from which the threads are reserved.  If null, the number of
+  // threads is not limited.
+  ZarrCodecThreadBudget::Ptr budget;
+};
+
+// Writer or reader of type `T` that holds a thread reservation for as long as
+// it exists.
+template <typename T>
+class WithCodecThreads : public T {
+ public:
+  template <typename... Args>
+  explicit WithCodecThreads(ZarrCodecThreadBudget::Reservation reservation,
+                            Args&&... args)
+      : T(std::forward<Args>(args)...), reservation_(std::move(reservation)) {}
+
+ private:
+  ZarrCodecThreadBudget::Reservation reservation_;
+};
+
 // "Array -> array" codec interface.
 class ZarrArrayToArrayCodec
     : public internal::AtomicReferenceCount<ZarrArrayToArrayCodec> {
@@ -104,6 +183,23 @@ class ZarrArrayToArrayCodec
         SharedArrayView<const void> encoded,
         span<const Index> decoded_shape) const = 0;
 
+    // Computes the region of the encoded array that is required to decode
+    // `decoded_region` of the decoded array.
+    //
+    // This is used only when this codec is followed by a non-sharding "array ->
+    // bytes" codec.  If this returns `true`, `DecodeArray` may be called with
+    // the `encoded_region` of the encoded array (translated to a zero origin)
+    // and a `decoded_shape` of `decoded_region.shape()`.
+    //
+    // The default implementation returns `false`, which indicates that only
+    // complete arrays may be decoded.
+    //
+    // \pre `decoded_region` is contained in the `decoded_shape` passed when
+    //     creating this prepared state.
+    // \pre `encoded_region.rank() == encoded_shape().size()`.
+    virtual bool GetEncodedRegion(BoxView<> decoded_region,
+                                  MutableBoxView<> encoded_region) const;
+
     // TODO(jbms): Add NDIterable or similar encode/decode interface.
 
     using NextReader =
@@ -199,6 +295,30 @@ class ZarrArrayToBytesCodec
     virtual Result<SharedArray<const void>> DecodeArray(
         span<const Index> decoded_shape, riegeli::Reader& reader) const = 0;
 
+    // Returns the byte range of the encoded representation that is required to
+    // decode `region` of an array of shape `decoded_shape` via
+    // `DecodeArrayRegion`.
+    //
+    // The default implementation returns the full range.
+    //
+    // This is not called for sharding codecs.
+    virtual OptionalByteRangeRequest GetDecodeByteRange(
+        span<const Index> decoded_shape, BoxView<> region) const;
+
+    // Decodes the sub-region `region` of an array of shape `decoded_shape`.
+    //
+    // `reader` supplies the encoded representation starting at
+    // `GetDecodeByteRange(decoded_shape, region).inclusive_min`.  The returned
+    // array has a zero origin and a shape of `region.shape()`.
+    //
+    // The default implementation decodes the complete array using
+    // `DecodeArray`.
+    //
+    // This is not called for sharding codecs.
+    virtual Result<SharedArray<const void>> DecodeArrayRegion(
+        span<const Index> decoded_shape, BoxView<> region,
+        riegeli::Reader& reader) const;
+
     // Note: For sharding codecs, the methods defined by
     // `ZarrShardingCodec::PreparedState` are used instead.
 
@@ -211,8 +331,12 @@ class ZarrArrayToBytesCodec
   // Indicates if this is a sharding codec.
   virtual bool is_sharding_codec() const { return false; }
 
+  // Returns a prepared state that may be used to encode and decode arrays of
+  // the specified shape.  Any nested codecs are prepared with the same
+  // `concurrency`.
   virtual Result<PreparedState::Ptr> Prepare(
-      span<const Index> decoded_shape) const = 0;
+      span<const Index> decoded_shape,
+      const ZarrCodecConcurrency& concurrency) const = 0;
 };
 
 // "Bytes -> bytes" codec interface.
@@ -249,10 +373,29 @@ class ZarrBytesToBytesCodec
     virtual Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
         riegeli::Reader& encoded_reader) const = 0;
 
+    // Returns a reader that must return the decoded representation starting at
+    // `decoded_range.inclusive_min`, and reads the encoded representation from
+    // `encoded_reader`.
+    //
+    // The caller reads at most until `decoded_range.exclusive_max`, and then
+    // closes `encoded_reader` without verifying that all data was read.
+    //
+    // The default implementation skips to `decoded_range.inclusive_min` in the
+    // reader returned by `GetDecodeReader`.  Codecs that support random access
+    // may instead decode only the portion of the encoded representation that
+    // corresponds to `decoded_range`.
+    virtual Result<std::unique_ptr<riegeli::Reader>> GetDecodeRangeReader(
+        riegeli::Reader& encoded_reader, ByteRange decoded_range) const;
+
     virtual ~PreparedState();
   };
 
-  virtual Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const = 0;
+  // Returns a prepared state that may be used to encode and decode values of
+  // `decoded_size` bytes, or of variable size if `decoded_size == -1`.  Codecs
+  // that use multiple threads to encode or decode a single value reserve them
+  // as specified by `concurrency` for each value.
+  virtual Result<PreparedState::Ptr> Prepare(
+      int64_t decoded_size, const ZarrCodecConcurrency& concurrency) const = 0;
 };
 
 // Composes zero or more "array -> array" codecs, one "array -> bytes" codec,
@@ -295,16 +438,65 @@ class ZarrCodecChain : public internal::AtomicReferenceCount<ZarrCodecChain> {
     Result<SharedArray<const void>> DecodeArray(
         span<const Index> decoded_shape, riegeli::Reader& reader) const final;
 
+    // Returns the byte range of the encoded representation that is required to
+    // decode `region` of an array of shape `decoded_shape` via
+    // `DecodeArrayRegion`.
+    //
+    // A byte range other than the full range is returned only if there are no
+    // "bytes -> bytes" codecs and all "array -> array" codecs support partial
+    // decoding.  Otherwise, the complete encoded representation is required,
+    // but the "bytes -> bytes" codecs may still decode only a portion of it.
+    //
+    // This is not used if `array_to_bytes` is a sharding codec.
+    OptionalByteRangeRequest GetDecodeByteRange(
+        span<const Index> decoded_shape, BoxView<> region) const final;
+
+    // Decodes the sub-region `region` of an array of shape `decoded_shape`.
+    //
+    // `cord` must contain the byte range of the encoded representation returned
+    // by `GetDecodeByteRange`.  The returned array has a zero origin and a
+    // shape of `region.shape()`.
+    //
+    // If supported by the codecs, only the portion of the encoded
+    // representation that overlaps `region` is decoded.
+    //
+    // This is not used if `array_to_bytes` is a sharding codec.
+    Result<SharedArray<const void>> DecodeArrayRegion(
+        span<const Index> decoded_shape, BoxView<> region,
+        absl::Cord cord) const;
+
+    // Decodes the sub-region `region` of an array of shape `decoded_shape`.
+    //
+    // This is not used if `array_to_bytes` is a sharding codec.
+    Result<SharedArray<const void>> DecodeArrayRegion(
+        span<const Index> decoded_shape, BoxView<> region,
+        riegeli::Reader& reader) const final;
+
     std::vector<ZarrArrayToArrayCodec::PreparedState::Ptr> array_to_array;
     ZarrArrayToBytesCodec::PreparedState::Ptr array_to_bytes;
     std::vector<ZarrBytesToBytesCodec::PreparedState::Ptr> bytes_to_bytes;
 
    private:
     friend class ZarrCodecChain;
+
+    // Computes the regions of the intermediate arrays that are required to
+    // decode `region`.  On success, `regions[i]` is the region of the array
+    // decoded by `array_to_array[i]`, and `regions.back()` is the region of
+    // the array decoded by `array_to_bytes`.
+    //
+    // Returns `false` if an "array -> array" codec does not support partial
+    // decoding.
+    bool GetEncodedRegions(BoxView<> region, std::vector<Box<>>& regions) const;
+
     int64_t encoded_size_;
   };
 
-  Result<PreparedState::Ptr> Prepare(span<const Index> decoded_shape) const;
+  // Prepares each codec in sequence.  `concurrency` controls the threads used
+  // by any one codec to encode or decode a single chunk.  The driver reserves
+  // them from a budget sized by its `data_copy_concurrency` limit.
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape,
+      const ZarrCodecConcurrency& concurrency = {}) const;
 
   bool is_sharding_chain() const { return array_to_bytes->is_sharding_codec(); }
 
@@ -323,10 +515,15 @@ class ZarrShardingCodec : public ZarrArrayToBytesCodec {
     using Ptr = internal::IntrusivePtr<const PreparedState>;
 
     // Returns a KvStore adapter for reading and writing sub-chunks.
+    //
+    // The shard index is cached in `index_cache_pool`, or in `cache_pool` if
+    // `index_cache_pool` is null.  If `pin_index` is `true`, the shard index
+    // is not evicted once read for the lifetime of the returned kvstore.
     virtual kvstore::DriverPtr GetSubChunkKvstore(
         kvstore::DriverPtr parent, std::string parent_key,
-        const Executor& executor,
-        internal::CachePool::WeakPtr cache_pool) const = 0;
+        const Executor& executor, internal::CachePool::WeakPtr cache_pool,
+        internal::CachePool::WeakPtr index_cache_pool,
+        bool pin_index) const = 0;
 
     // Returns the key formatter/parser for use with the kvstore returned by
     // `GetSubChunkKvstore`.
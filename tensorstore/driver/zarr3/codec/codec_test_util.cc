@@ -15,6 +15,7 @@
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
 
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -22,19 +23,24 @@
 #include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
 #include "tensorstore/array_testutil.h"
+#include "tensorstore/box.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/data_type_random_generator.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/util/endian.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal_zarr3 {
@@ -106,7 +112,8 @@ void TestCodecRoundTrip(const CodecRoundTripTestParams& params) {
       auto codec_chain,
       codec_chain_spec.Resolve(std::move(decoded_params), encoded_params));
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto prepared_state,
-                                   codec_chain->Prepare(params.shape));
+                                   codec_chain->Prepare(params.shape,
+                                                        params.concurrency));
   absl::BitGen gen;
   auto data =
       internal::MakeRandomArray(gen, params.shape, params.dtype, c_order);
@@ -116,6 +123,40 @@ void TestCodecRoundTrip(const CodecRoundTripTestParams& params) {
   EXPECT_THAT(prepared_state->DecodeArray(params.shape, encoded),
               ::testing::Optional(MatchesArrayIdentically(data)))
       << "data=" << data;
+
+  // Test decoding the complete array, a single slice along each dimension,
+  // and an interior region, from just the required byte range.
+  const DimensionIndex rank = params.shape.size();
+  std::vector<Box<>> regions;
+  regions.emplace_back(params.shape);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    Box<> region(params.shape);
+    region.origin()[i] = params.shape[i] / 2;
+    region.shape()[i] = params.shape[i] == 0 ? 0 : 1;
+    regions.push_back(std::move(region));
+  }
+  {
+    Box<> region(params.shape);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      region.origin()[i] = params.shape[i] / 4;
+      region.shape()[i] = params.shape[i] / 2;
+    }
+    regions.push_back(std::move(region));
+  }
+  for (const auto& region : regions) {
+    SCOPED_TRACE(tensorstore::StrCat("region=", region));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto expected,
+        data | AllDims().TranslateBoxSlice(region) | Materialize());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto byte_range,
+        prepared_state->GetDecodeByteRange(params.shape, region).Validate(
+            encoded.size()));
+    EXPECT_THAT(prepared_state->DecodeArrayRegion(
+                    params.shape, region,
+                    internal::GetSubCord(encoded, byte_range)),
+                ::testing::Optional(MatchesArray(expected)));
+  }
 }
 
 Result<::nlohmann::json> TestCodecMerge(::nlohmann::json a, ::nlohmann::json b,
@@ -21,6 +21,7 @@
 
 #include <nlohmann/json.hpp>
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/index.h"
@@ -50,6 +51,7 @@ struct CodecRoundTripTestParams {
   ::nlohmann::json spec;
   std::vector<Index> shape{30, 40, 50};
   DataType dtype = dtype_v<uint16_t>;
+  ZarrCodecConcurrency concurrency;
 };
 
 void TestCodecRoundTrip(const CodecRoundTripTestParams& params);
@@ -77,7 +77,9 @@ class DigestCodec : public ZarrBytesToBytesCodec {
     int64_t encoded_size_;
   };
 
-  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+  Result<PreparedState::Ptr> Prepare(
+      int64_t decoded_size,
+      const ZarrCodecConcurrency& concurrency) const final {
     return internal::MakeIntrusivePtr<State>(decoded_size);
   }
 };
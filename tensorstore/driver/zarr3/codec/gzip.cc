@@ -64,7 +64,9 @@ class GzipCodec : public ZarrBytesToBytesCodec {
     int level_;
   };
 
-  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+  Result<PreparedState::Ptr> Prepare(
+      int64_t decoded_size,
+      const ZarrCodecConcurrency& concurrency) const final {
     auto state = internal::MakeIntrusivePtr<State>();
     state->level_ = level_;
     return state;
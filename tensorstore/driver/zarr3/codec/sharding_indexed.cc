@@ -81,27 +81,38 @@ class ShardingIndexedCodec : public ZarrShardingCodec {
       internal::ChunkGridSpecification&& sub_chunk_grid)
       : sub_chunk_grid_(std::move(sub_chunk_grid)) {}
 
+  // Sharded chunks are never encoded or decoded as a whole.  Instead, the
+  // zarr3 driver accesses each sub-chunk as a separate entry of the kvstore
+  // returned by `GetSubChunkKvstore`, and sub-chunks are encoded and decoded
+  // independently by their own cache entries, on the `data_copy_concurrency`
+  // executor.  Reading or writing an entire shard therefore already processes
+  // its sub-chunks in parallel, bounded by the `data_copy_concurrency` limit.
   class State : public ZarrShardingCodec::PreparedState,
                 public internal::LexicographicalGridIndexKeyParser {
    public:
     absl::Status EncodeArray(SharedArrayView<const void> decoded,
                              riegeli::Writer& writer) const final {
-      return absl::InternalError("");
+      return absl::InternalError(
+          "sharding_indexed chunks must be encoded by sub-chunk");
     }
     Result<SharedArray<const void>> DecodeArray(
         span<const Index> decoded_shape, riegeli::Reader& reader) const final {
-      return absl::InternalError("");
+      return absl::InternalError(
+          "sharding_indexed chunks must be decoded by sub-chunk");
     }
 
     kvstore::DriverPtr GetSubChunkKvstore(
         kvstore::DriverPtr parent, std::string parent_key,
-        const Executor& executor,
-        internal::CachePool::WeakPtr cache_pool) const override {
+        const Executor& executor, internal::CachePool::WeakPtr cache_pool,
+        internal::CachePool::WeakPtr index_cache_pool,
+        bool pin_index) const override {
       zarr3_sharding_indexed::ShardedKeyValueStoreParameters params;
       params.base_kvstore = std::move(parent);
       params.base_kvstore_path = std::move(parent_key);
       params.executor = executor;
       params.cache_pool = std::move(cache_pool);
+      params.index_cache_pool = std::move(index_cache_pool);
+      params.pin_index = pin_index;
       params.index_params = shard_index_params_;
       return zarr3_sharding_indexed::GetShardedKeyValueStore(std::move(params));
     }
@@ -134,7 +145,8 @@ class ShardingIndexedCodec : public ZarrShardingCodec {
   };
 
   Result<ZarrArrayToBytesCodec::PreparedState::Ptr> Prepare(
-      span<const Index> decoded_shape) const final {
+      span<const Index> decoded_shape,
+      const ZarrCodecConcurrency& concurrency) const final {
     span<const Index> sub_chunk_shape = sub_chunk_grid_.components[0].shape();
     if (decoded_shape.size() != sub_chunk_shape.size()) {
       return SubChunkRankMismatch(sub_chunk_shape, decoded_shape.size());
@@ -151,7 +163,8 @@ class ShardingIndexedCodec : public ZarrShardingCodec {
       sub_chunk_grid_shape[i] = grid_size;
     }
     TENSORSTORE_ASSIGN_OR_RETURN(
-        state->codec_state_, sub_chunk_codec_chain_->Prepare(sub_chunk_shape));
+        state->codec_state_,
+        sub_chunk_codec_chain_->Prepare(sub_chunk_shape, concurrency));
     state->sub_chunk_grid = &sub_chunk_grid_;
     state->sub_chunk_codec_chain = sub_chunk_codec_chain_.get();
     state->sub_chunk_codec_state = state->codec_state_.get();
@@ -24,6 +24,7 @@
 
 #include "absl/status/status.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
@@ -162,6 +163,18 @@ class TransposeCodec : public ZarrArrayToArrayCodec {
       return decoded;
     }
 
+    bool GetEncodedRegion(BoxView<> decoded_region,
+                          MutableBoxView<> encoded_region) const final {
+      span<const DimensionIndex> inverse_order = codec_->inverse_order_;
+      assert(decoded_region.rank() == inverse_order.size());
+      for (DimensionIndex decoded_dim = 0; decoded_dim < decoded_region.rank();
+           ++decoded_dim) {
+        encoded_region[inverse_order[decoded_dim]] =
+            decoded_region[decoded_dim];
+      }
+      return true;
+    }
+
     void Read(const NextReader& next, span<const Index> decoded_shape,
               IndexTransform<> transform,
               AnyFlowReceiver<absl::Status, internal::ReadChunk,
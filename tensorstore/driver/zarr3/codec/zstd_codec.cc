@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
@@ -26,9 +27,11 @@
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/compression/zstd_compressor.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 
@@ -40,13 +43,28 @@ using ::riegeli::ZstdWriterBase;
 
 class ZstdCodec : public ZarrBytesToBytesCodec {
  public:
-  explicit ZstdCodec(int level, bool checksum)
-      : level_(level), checksum_(checksum) {}
+  explicit ZstdCodec(int level, bool checksum, int nb_workers)
+      : level_(level), checksum_(checksum), nb_workers_(nb_workers) {}
 
   class State : public ZarrBytesToBytesCodec::PreparedState {
    public:
     Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
         riegeli::Writer& encoded_writer) const final {
+      if (nb_workers_ > 0) {
+        // The calling thread waits while the workers compress, so only the
+        // workers are counted.  A single worker provides no parallelism.
+        auto reservation =
+            ZarrCodecThreadBudget::Acquire(budget_, nb_workers_);
+        const int nb_workers = reservation.threads();
+        if (nb_workers > 1) {
+          return std::make_unique<
+              WithCodecThreads<internal::ZstdParallelWriter>>(
+              std::move(reservation),
+              internal::ZstdParallelWriter::Options{level_, checksum_,
+                                                    nb_workers},
+              encoded_writer);
+        }
+      }
       using Writer = riegeli::ZstdWriter<riegeli::Writer*>;
       Writer::Options options;
       options.set_compression_level(level_);
@@ -66,13 +84,23 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
 
     int level_;
     bool checksum_;
+    int nb_workers_;
+    ZarrCodecThreadBudget::Ptr budget_;
     int64_t decoded_size_;
   };
 
-  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+  Result<PreparedState::Ptr> Prepare(
+      int64_t decoded_size,
+      const ZarrCodecConcurrency& concurrency) const final {
     auto state = internal::MakeIntrusivePtr<State>();
     state->level_ = level_;
     state->checksum_ = checksum_;
+    // An overriding thread count of 1 compresses on the calling thread.
+    state->nb_workers_ = concurrency.threads
+                             ? (*concurrency.threads > 1 ? *concurrency.threads
+                                                         : 0)
+                             : nb_workers_;
+    state->budget_ = concurrency.budget;
     state->decoded_size_ = decoded_size;
     return state;
   }
@@ -80,6 +108,7 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
  private:
   int level_;
   bool checksum_;
+  int nb_workers_;
 };
 
 }  // namespace
@@ -91,6 +120,8 @@ absl::Status ZstdCodecSpec::MergeFrom(const ZarrCodecSpec& other, bool strict) {
       MergeConstraint<&Options::level>("level", options, other_options));
   TENSORSTORE_RETURN_IF_ERROR(
       MergeConstraint<&Options::checksum>("checksum", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::nb_workers>(
+      "nb_workers", options, other_options));
   return absl::OkStatus();
 }
 
@@ -105,15 +136,17 @@ Result<ZarrBytesToBytesCodec::Ptr> ZstdCodecSpec::Resolve(
       options.level.value_or(ZstdWriterBase::Options::kDefaultCompressionLevel);
   auto resolved_checksum = options.checksum.value_or(false);
   if (resolved_spec) {
-    if (options.level && options.checksum) {
+    // `nb_workers` is excluded from the resolved spec since it does not affect
+    // the encoded representation.
+    if (options.level && options.checksum && !options.nb_workers) {
       resolved_spec->reset(this);
     } else {
       resolved_spec->reset(
           new ZstdCodecSpec(Options{resolved_level, resolved_checksum}));
     }
   }
-  return internal::MakeIntrusivePtr<ZstdCodec>(resolved_level,
-                                               resolved_checksum);
+  return internal::MakeIntrusivePtr<ZstdCodec>(
+      resolved_level, resolved_checksum, options.nb_workers.value_or(0));
 }
 
 TENSORSTORE_GLOBAL_INITIALIZER {
@@ -130,7 +163,10 @@ TENSORSTORE_GLOBAL_INITIALIZER {
                              ZstdWriterBase::Options::kMaxCompressionLevel)))),
           jb::Member("checksum",
                      jb::Projection<&Options::checksum>(
-                         OptionalIfConstraintsBinder())))  //
+                         OptionalIfConstraintsBinder())),
+          jb::Member("nb_workers",
+                     jb::Projection<&Options::nb_workers>(
+                         jb::Optional(jb::Integer<int>(0)))))  //
                                      ));
 }
 
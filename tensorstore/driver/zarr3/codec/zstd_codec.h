@@ -30,6 +30,10 @@ class ZstdCodecSpec : public ZarrBytesToBytesCodecSpec {
   struct Options {
     std::optional<int> level;
     std::optional<bool> checksum;
+
+    // Number of worker threads used to compress each chunk.  This only affects
+    // how chunks are encoded, and is not included in the resolved spec.
+    std::optional<int> nb_workers;
   };
   ZstdCodecSpec() = default;
   explicit ZstdCodecSpec(const Options& options) : options(options) {}
@@ -13,15 +13,19 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/internal/intrusive_ptr.h"
 
 namespace {
 
+using ::tensorstore::internal::MakeIntrusivePtr;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecThreadBudget;
 
 TEST(ZstdTest, EndianInferred) {
   CodecSpecRoundTripTestParams p;
@@ -61,10 +65,39 @@ TEST(ZstdTest, DefaultLevel) {
   TestCodecSpecRoundTrip(p);
 }
 
+TEST(ZstdTest, NbWorkersNotResolved) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "zstd"},
+       {"configuration",
+        {{"level", 7}, {"checksum", true}, {"nb_workers", 2}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "zstd"}, {"configuration", {{"level", 7}, {"checksum", true}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
 TEST(ZstdTest, RoundTrip) {
   CodecRoundTripTestParams p;
   p.spec = {"zstd"};
   TestCodecRoundTrip(p);
 }
 
+TEST(ZstdTest, RoundTripNbWorkers) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "zstd"},
+             {"configuration", {{"checksum", true}, {"nb_workers", 2}}}}};
+  TestCodecRoundTrip(p);
+}
+
+TEST(ZstdTest, RoundTripWorkersFromBudget) {
+  CodecRoundTripTestParams p;
+  p.spec = {"zstd"};
+  p.concurrency.threads = 4;
+  p.concurrency.budget = MakeIntrusivePtr<ZarrCodecThreadBudget>(3);
+  TestCodecRoundTrip(p);
+}
+
 }  // namespace
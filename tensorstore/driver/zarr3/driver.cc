@@ -12,15 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/zarr3/driver.h"
 
 #include <stddef.h>
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "absl/status/status.h"
@@ -36,9 +39,12 @@
 #include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
+#include "tensorstore/context.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/driver.h"
+#include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/driver/driver_spec.h"
 #include "tensorstore/driver/kvs_backed_chunk_driver.h"
 #include "tensorstore/driver/registry.h"
@@ -52,11 +58,14 @@
 #include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
 #include "tensorstore/open_mode.h"
@@ -73,6 +82,11 @@
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
+// specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
+
 namespace tensorstore {
 namespace internal_zarr3 {
 
@@ -89,6 +103,9 @@ using ::tensorstore::internal_kvs_backed_chunk_driver::KvsDriverSpec;
 
 constexpr const char kMetadataKey[] = "zarr.json";
 
+// Maximum value of "codec_threads", which is the limit of the blosc library.
+constexpr int kMaxCodecThreads = 256;
+
 class ZarrDriverSpec
     : public internal::RegisteredDriverSpec<ZarrDriverSpec,
                                             /*Parent=*/KvsDriverSpec> {
@@ -100,8 +117,22 @@ class ZarrDriverSpec
 
   ZarrMetadataConstraints metadata_constraints;
 
+  // Cache pool for the shard indexes of the outermost level of sharding.  If
+  // not specified, the metadata cache pool is used.
+  std::optional<Context::Resource<internal::CachePoolResource>>
+      index_cache_pool;
+
+  // Keep the shard indexes of the outermost level of sharding cached while the
+  // array is open, once read.
+  bool pin_index = false;
+
+  // Number of threads used by the "blosc" and "zstd" codecs to encode or
+  // decode each chunk, overriding the number specified by the codecs.
+  std::optional<int> codec_threads;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints);
+    return f(internal::BaseCast<KvsDriverSpec>(x), x.metadata_constraints,
+             x.index_cache_pool, x.pin_index, x.codec_threads);
   };
 
   static inline const auto default_json_binder = jb::Sequence(
@@ -124,7 +155,14 @@ class ZarrDriverSpec
                 return absl::OkStatus();
               },
               jb::Projection<&ZarrDriverSpec::metadata_constraints>(
-                  jb::DefaultInitializedValue()))));
+                  jb::DefaultInitializedValue()))),
+      jb::Member("index_cache_pool",
+                 jb::Projection<&ZarrDriverSpec::index_cache_pool>()),
+      jb::Member("pin_index", jb::Projection<&ZarrDriverSpec::pin_index>(
+                                  jb::DefaultInitializedValue())),
+      jb::Member("codec_threads",
+                 jb::Projection<&ZarrDriverSpec::codec_threads>(
+                     jb::Optional(jb::Integer<int>(1, kMaxCodecThreads)))));
 
   absl::Status ApplyOptions(SpecOptions&& options) override {
     if (options.minimal_spec) {
@@ -181,6 +219,19 @@ Result<std::shared_ptr<const ZarrMetadata>> ParseEncodedMetadata(
   return std::make_shared<ZarrMetadata>(std::move(metadata));
 }
 
+// Returns the number of threads of the `data_copy_concurrency` executor, which
+// is the size of the budget of threads used by codecs to encode or decode the
+// chunks of an array.
+//
+// The default shared executor has one thread per CPU core.
+int GetMaxCodecThreads(
+    const internal::DataCopyConcurrencyResource::Resource& resource) {
+  const size_t limit = resource.spec.limit.value_or(
+      std::max(size_t(1), size_t(std::thread::hardware_concurrency())));
+  return static_cast<int>(
+      std::min(limit, static_cast<size_t>(std::numeric_limits<int>::max())));
+}
+
 class MetadataCache : public internal_kvs_backed_chunk_driver::MetadataCache {
   using Base = internal_kvs_backed_chunk_driver::MetadataCache;
 
@@ -386,6 +437,9 @@ class DataCacheBase
     auto& spec = static_cast<ZarrDriverSpec&>(spec_base);
     const auto& metadata = *static_cast<const ZarrMetadata*>(metadata_ptr);
     spec.metadata_constraints = ZarrMetadataConstraints(metadata);
+    spec.index_cache_pool = index_cache_pool_;
+    spec.pin_index = pin_index_;
+    spec.codec_threads = codec_threads_;
     return absl::OkStatus();
   }
 
@@ -403,6 +457,15 @@ class DataCacheBase
   std::string GetBaseKvstorePath() override { return key_prefix_; }
 
   std::string key_prefix_;
+
+  // Shard index caching options from the spec, which are part of the data
+  // cache key.
+  std::optional<Context::Resource<internal::CachePoolResource>>
+      index_cache_pool_;
+  bool pin_index_ = false;
+
+  // Codec thread count from the spec, which is part of the data cache key.
+  std::optional<int> codec_threads_;
 };
 
 using internal_kvs_backed_chunk_driver::DataCacheInitializer;
@@ -560,7 +623,8 @@ class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
     std::string result;
     internal::EncodeCacheKey(
         &result, spec().store.path,
-        static_cast<const ZarrMetadata*>(metadata)->GetCompatibilityKey());
+        static_cast<const ZarrMetadata*>(metadata)->GetCompatibilityKey(),
+        spec().index_cache_pool, spec().pin_index, spec().codec_threads);
     return result;
   }
 
@@ -587,9 +651,39 @@ class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
       DataCacheInitializer&& initializer) override {
     const auto& metadata =
         *static_cast<const ZarrMetadata*>(initializer.metadata.get());
-    return internal_zarr3::MakeZarrChunkCache<DataCacheBase, ZarrDataCache>(
-        *metadata.codecs, std::move(initializer), spec().store.path,
-        metadata.codec_state, /*data_cache_pool=*/*cache_pool());
+    // Chunks are encoded and decoded on the executor of the metadata cache.
+    // Codecs that use multiple threads per chunk reserve them from a budget
+    // shared by all chunks of the array, sized by its `data_copy_concurrency`
+    // limit, such that concurrently encoded chunks do not multiply the number
+    // of threads.  The concurrency does not affect validation, so this only
+    // fails if `metadata.codec_state` also failed to prepare.
+    ZarrCodecConcurrency concurrency;
+    concurrency.threads = spec().codec_threads;
+    concurrency.budget = internal::MakeIntrusivePtr<ZarrCodecThreadBudget>(
+        GetMaxCodecThreads(
+            *internal::GetOwningCache(*initializer.metadata_cache_entry)
+                 .data_copy_concurrency_));
+    ZarrCodecChain::PreparedState::Ptr codec_state = metadata.codec_state;
+    if (auto prepared =
+            metadata.codecs->Prepare(metadata.chunk_shape, concurrency);
+        prepared.ok()) {
+      codec_state = *std::move(prepared);
+    }
+    auto cache =
+        internal_zarr3::MakeZarrChunkCache<DataCacheBase, ZarrDataCache>(
+            *metadata.codecs, std::move(initializer), spec().store.path,
+            std::move(codec_state), /*data_cache_pool=*/*cache_pool());
+    cache->index_cache_pool_ = spec().index_cache_pool;
+    cache->pin_index_ = spec().pin_index;
+    cache->codec_threads_ = spec().codec_threads;
+    if (auto* sharded_cache = dynamic_cast<ZarrShardedChunkCache*>(
+            &cache->zarr_chunk_cache())) {
+      if (spec().index_cache_pool) {
+        sharded_cache->index_cache_pool_ = **spec().index_cache_pool;
+      }
+      sharded_cache->pin_index_ = spec().pin_index;
+    }
+    return cache;
   }
 
   Result<size_t> GetComponentIndex(const void* metadata_ptr,
@@ -612,6 +706,16 @@ Future<internal::Driver::Handle> ZarrDriverSpec::Open(
 }  // namespace
 #endif
 
+Future<const void> PrefetchShardIndexes(const internal::DriverHandle& handle) {
+  auto* driver = dynamic_cast<ZarrDriver*>(handle.driver.get().get());
+  if (!driver) return MakeReadyFuture();
+  auto* sharded_cache = dynamic_cast<ZarrShardedChunkCache*>(
+      &driver->cache()->zarr_chunk_cache());
+  if (!sharded_cache) return MakeReadyFuture();
+  return sharded_cache->PrefetchShardIndexes(
+      handle.transform, driver->GetCurrentDataStalenessBound());
+}
+
 }  // namespace internal_zarr3
 }  // namespace tensorstore
 
@@ -0,0 +1,42 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_DRIVER_H_
+#define TENSORSTORE_DRIVER_ZARR3_DRIVER_H_
+
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+/// Reads the shard indexes of all shards that intersect the domain of
+/// `handle` into the cache, as a single batch.
+///
+/// Shard indexes are cached in the ``index_cache_pool`` of the spec, which
+/// defaults to the ``metadata_cache_pool``.  The indexes remain cached if the
+/// array was opened with ``pin_index``, or as long as the cache pool has room
+/// for them.  Subsequent reads of the region then only need to read the
+/// sub-chunks themselves, as long as the indexes satisfy the data staleness
+/// bound of the read.
+///
+/// \param handle Handle to a zarr3 array.  If the array is not sharded, or is
+///     not a zarr3 array, this has no effect.
+/// \returns A future that becomes ready once all shard indexes have been read.
+Future<const void> PrefetchShardIndexes(const internal::DriverHandle& handle);
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_DRIVER_H_
@@ -37,6 +37,7 @@
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/driver_testutil.h"
+#include "tensorstore/driver/zarr3/driver.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dim_expression.h"
@@ -70,6 +71,7 @@ using ::tensorstore::Context;
 using ::tensorstore::DataType;
 using ::tensorstore::dtype_v;
 using ::tensorstore::Index;
+using ::tensorstore::JsonSubValueMatches;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::Schema;
@@ -80,6 +82,7 @@ using ::tensorstore::internal::TestSpecSchema;
 using ::tensorstore::internal::TestTensorStoreCreateCheckSchema;
 using ::tensorstore::internal::TestTensorStoreCreateWithSchema;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::PrefetchShardIndexes;
 
 ::nlohmann::json GetJsonSpec() {
   return {
@@ -144,7 +147,7 @@ TEST(ZarrDriverTest, ShardedTranspose) {
           tensorstore::OpenMode::create)
           .result());
   TENSORSTORE_ASSERT_OK(tensorstore::Write(array, store));
-  EXPECT_THAT(tensorstore::Read(store).result(), ::testing::Optional(array));
+  EXPECT_THAT(tensorstore::Read(store).result(), array);
 }
 
 TENSORSTORE_GLOBAL_INITIALIZER {
@@ -1208,6 +1211,159 @@ TEST(ZarrDriverTest, ShardingBatchRead) {
   EXPECT_THAT(mock_kvstore->request_log.pop_all(), ::testing::SizeIs(4));
 }
 
+// Returns the number of reads of a shard index in `log`.  The shard index is
+// stored at the end of the shard, and is therefore read as a suffix byte range.
+template <typename Log>
+size_t CountShardIndexReads(const Log& log) {
+  size_t count = 0;
+  auto count_request = [&](const ::nlohmann::json& request) {
+    auto it = request.find("byte_range_inclusive_min");
+    if (it != request.end() && it->get<int64_t>() < 0) ++count;
+  };
+  for (const auto& entry : log) {
+    if (entry["type"] == "batch_read") {
+      for (const auto& request : entry["requests"]) count_request(request);
+    } else if (entry["type"] == "read") {
+      count_request(entry);
+    }
+  }
+  return count;
+}
+
+TEST(ZarrDriverTest, PrefetchShardIndexes) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_kvstore_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_kvstore = *mock_kvstore_resource;
+  mock_kvstore->forward_to = tensorstore::GetMemoryKeyValueStore();
+  mock_kvstore->log_requests = true;
+  mock_kvstore->handle_batch_requests = true;
+  // With the default `cache_pool` of size 0, the prefetched shard indexes
+  // remain cached only because they are pinned.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr3"},
+                         {"kvstore", {{"driver", "mock_key_value_store"}}},
+                         {"pin_index", true},
+                         {"recheck_cached_data", "open"}},
+                        tensorstore::OpenMode::create, context,
+                        dtype_v<uint16_t>, Schema::Shape({8, 8}),
+                        ChunkLayout::ReadChunkShape({2, 2}),
+                        ChunkLayout::WriteChunkShape({4, 4}))
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint16_t>(42), store));
+  mock_kvstore->request_log.pop_all();
+
+  // Only the two shards that intersect the region are read.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto region, store | tensorstore::Dims(0).HalfOpenInterval(0, 4));
+  const auto& handle =
+      tensorstore::internal::TensorStoreAccess::handle(region);
+  TENSORSTORE_ASSERT_OK(PrefetchShardIndexes(handle).result());
+  auto prefetch_log = mock_kvstore->request_log.pop_all();
+  EXPECT_THAT(prefetch_log, ::testing::SizeIs(2));
+  EXPECT_EQ(2, CountShardIndexReads(prefetch_log));
+
+  // Reading part of the prefetched region only reads the sub-chunks, as one
+  // batch per shard.  Only part of each shard is read, since reading an entire
+  // shard obtains the index from the shard data rather than separately.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Read(store | tensorstore::Dims(0).HalfOpenInterval(0, 2)));
+  auto read_log = mock_kvstore->request_log.pop_all();
+  EXPECT_THAT(read_log, ::testing::SizeIs(2));
+  EXPECT_EQ(0, CountShardIndexReads(read_log));
+}
+
+TEST(ZarrDriverTest, UncompressedPartialChunkReadUsesByteRange) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_kvstore_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_kvstore = *mock_kvstore_resource;
+  mock_kvstore->forward_to = tensorstore::GetMemoryKeyValueStore();
+  mock_kvstore->log_requests = true;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr3"},
+                         {"kvstore", {{"driver", "mock_key_value_store"}}},
+                         {"recheck_cached_metadata", false}},
+                        tensorstore::OpenMode::create, context,
+                        dtype_v<uint16_t>, Schema::Shape({4, 4}),
+                        ChunkLayout::ReadChunkShape({4, 4}))
+          .result());
+  auto array = tensorstore::MakeArray<uint16_t>(
+      {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}, {12, 13, 14, 15}});
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(array, store));
+  mock_kvstore->request_log.pop_all();
+
+  // Only the bytes from element (1, 1) through element (2, 2) are read.
+  EXPECT_THAT(tensorstore::Read(store | tensorstore::Dims(0, 1).SizedInterval(
+                                            {1, 1}, {2, 2}))
+                  .result(),
+              tensorstore::MakeOffsetArray<uint16_t>({1, 1},
+                                                     {{5, 6}, {9, 10}}));
+  auto log = mock_kvstore->request_log.pop_all();
+  ASSERT_THAT(log, ::testing::SizeIs(1));
+  EXPECT_EQ("c/0/0", log[0]["key"]);
+  EXPECT_EQ(10, log[0]["byte_range_inclusive_min"]);
+  EXPECT_EQ(22, log[0]["byte_range_exclusive_max"]);
+
+  // A complete chunk is read through the cache.
+  EXPECT_THAT(tensorstore::Read(store).result(), ::testing::Optional(array));
+  log = mock_kvstore->request_log.pop_all();
+  ASSERT_THAT(log, ::testing::SizeIs(1));
+  EXPECT_EQ("c/0/0", log[0]["key"]);
+  EXPECT_FALSE(log[0].contains("byte_range_exclusive_max"));
+
+  // Missing chunks are filled with the fill value.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::kvstore::Delete(store.kvstore(), "c/0/0").result());
+  EXPECT_THAT(
+      tensorstore::Read(store | tensorstore::Dims(0).IndexSlice(3)).result(),
+      tensorstore::MakeArray<uint16_t>({0, 0, 0, 0}));
+}
+
+TEST(ZarrDriverTest, CodecThreads) {
+  auto context = Context::Default();
+  auto array = tensorstore::MakeArray<uint16_t>({{1, 2, 3}, {4, 5, 6}});
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store,
+        tensorstore::Open({{"driver", "zarr3"},
+                           {"kvstore", "memory://"},
+                           {"metadata", {{"codecs", {"blosc"}}}},
+                           {"codec_threads", 2}},
+                          tensorstore::OpenMode::create, context,
+                          dtype_v<uint16_t>, Schema::Shape({2, 3}))
+            .result());
+    TENSORSTORE_ASSERT_OK(tensorstore::Write(array, store));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+    EXPECT_THAT(spec.ToJson(), ::testing::Optional(JsonSubValueMatches(
+                                   "/codec_threads", 2)));
+  }
+
+  // The option is not stored in the metadata, and applies when opening an
+  // existing array.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open({{"driver", "zarr3"},
+                                     {"kvstore", "memory://"},
+                                     {"codec_threads", 3}},
+                                    tensorstore::OpenMode::open, context)
+                      .result());
+  EXPECT_THAT(tensorstore::Read(store).result(), array);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, store.spec());
+  EXPECT_THAT(spec.ToJson(),
+              ::testing::Optional(JsonSubValueMatches("/codec_threads", 3)));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvs, tensorstore::kvstore::Open("memory://", context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto metadata, tensorstore::kvstore::Read(kvs, "zarr.json").result());
+  EXPECT_THAT(metadata.value.Flatten(),
+              ::testing::Not(::testing::HasSubstr("threads")));
+}
+
 TEST(ZarrDriverTest, CodecLifetime) {
   tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
   tensorstore::Future<const void> future;
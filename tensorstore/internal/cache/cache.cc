@@ -17,10 +17,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bitset>
 #include <cassert>
+#include <chrono>  // NOLINT
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -79,7 +81,10 @@ CachePoolImpl::CachePoolImpl(const CachePool::Limits& limits)
       total_bytes_(0),
       strong_references_(1),
       weak_references_(1) {
-  Initialize(LruListAccessor{}, &eviction_queue_);
+  for (auto& shard : lru_shards_) {
+    Initialize(LruListAccessor{}, &shard.eviction_queue);
+    Initialize(LruListAccessor{}, &shard.protected_queue);
+  }
 }
 
 namespace {
@@ -125,27 +130,127 @@ void UnlinkListNode(LruListNode* node) noexcept {
   Initialize(LruListAccessor{}, node);
 }
 
-void UnregisterEntryFromPool(CacheEntryImpl* entry,
-                             CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
+using LruShard = CachePoolImpl::LruShard;
+
+// Updates the cached front sequence numbers of the queues of `shard`.
+void UpdateQueueFronts(LruShard& shard) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  const auto front = [](LruListNode* queue) {
+    return queue->next == queue
+               ? CachePoolImpl::kEmptyQueue
+               : static_cast<CacheEntryImpl*>(queue->next)->eviction_sequence_;
+  };
+  shard.eviction_queue_front.store(front(&shard.eviction_queue),
+                                   std::memory_order_relaxed);
+  shard.protected_queue_front.store(front(&shard.protected_queue),
+                                    std::memory_order_relaxed);
+}
+
+// Removes `entry` from whichever eviction queue of `shard` it is linked into,
+// if any.
+void UnlinkFromEvictionQueue(CachePoolImpl* pool, LruShard& shard,
+                             CacheEntryImpl* entry) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  if (entry->protected_) {
+    entry->protected_ = false;
+    pool->protected_bytes_.fetch_sub(entry->protected_bytes_,
+                                     std::memory_order_relaxed);
+  }
   UnlinkListNode(entry);
+}
+
+void UnregisterEntryFromPool(CacheEntryImpl* entry, LruShard& shard,
+                             CachePoolImpl* pool) noexcept {
+  UnlinkFromEvictionQueue(pool, shard, entry);
   pool->total_bytes_.fetch_sub(entry->num_bytes_, std::memory_order_relaxed);
 }
 
-void AddToEvictionQueue(CachePoolImpl* pool, CacheEntryImpl* entry) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-  auto* eviction_queue = &pool->eviction_queue_;
-  if (!OnlyContainsNode(LruListAccessor{}, entry)) {
-    Remove(LruListAccessor{}, entry);
+// Appends `entry` to the back of `queue`, one of the queues of `shard`.
+void InsertIntoQueue(LruShard& shard, LruListNode* queue,
+                     CacheEntryImpl* entry) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  // The sequence number is derived from a monotonic clock, rather than from a
+  // pool-wide counter, to avoid contention between shards.  It is strictly
+  // increasing within the shard.
+  const uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+  shard.last_eviction_sequence =
+      std::max(now, shard.last_eviction_sequence + 1);
+  entry->eviction_sequence_ = shard.last_eviction_sequence;
+  InsertBefore(LruListAccessor{}, queue, entry);
+}
+
+void AddToEvictionQueue(CachePoolImpl* pool, LruShard& shard,
+                        CacheEntryImpl* entry) noexcept {
+  DebugAssertMutexHeld(&shard.mutex);
+  const bool accessed =
+      entry->accessed_.exchange(false, std::memory_order_relaxed);
+  const bool was_protected = entry->protected_;
+  UnlinkFromEvictionQueue(pool, shard, entry);
+  if (pool->limits_.eviction_policy == CacheEvictionPolicy::kTwoQueue &&
+      (accessed || was_protected)) {
+    entry->protected_ = true;
+    entry->protected_bytes_ = entry->num_bytes_;
+    pool->protected_bytes_.fetch_add(entry->protected_bytes_,
+                                     std::memory_order_relaxed);
+    InsertIntoQueue(shard, &shard.protected_queue, entry);
+  } else {
+    InsertIntoQueue(shard, &shard.eviction_queue, entry);
+  }
+  UpdateQueueFronts(shard);
+}
+
+// Returns the shard whose `protected_queue` (if `protected_queue == true`) or
+// `eviction_queue` (otherwise) has the least recently added front entry, or
+// `nullptr` if all of those queues are empty.
+//
+// The result may be stale by the time the shard mutex is acquired.
+LruShard* FindOldestShard(CachePoolImpl* pool, bool protected_queue) noexcept {
+  LruShard* oldest_shard = nullptr;
+  uint64_t oldest = CachePoolImpl::kEmptyQueue;
+  for (auto& shard : pool->lru_shards_) {
+    const uint64_t front =
+        (protected_queue ? shard.protected_queue_front
+                         : shard.eviction_queue_front)
+            .load(std::memory_order_relaxed);
+    if (front < oldest) {
+      oldest = front;
+      oldest_shard = &shard;
+    }
+  }
+  return oldest_shard;
+}
+
+// With `CacheEvictionPolicy::kTwoQueue`, the protected queues are limited to
+// `kProtectedQueueFraction` of `total_bytes_limit`; the least recently used
+// protected entries in excess of that limit are demoted back to the
+// probationary queue.
+void DemoteProtectedEntries(CachePoolImpl* pool) noexcept {
+  constexpr double kProtectedQueueFraction = 0.75;
+  const size_t max_protected_bytes = static_cast<size_t>(
+      pool->limits_.total_bytes_limit * kProtectedQueueFraction);
+  while (pool->protected_bytes_.load(std::memory_order_relaxed) >
+         max_protected_bytes) {
+    auto* shard = FindOldestShard(pool, /*protected_queue=*/true);
+    if (!shard) break;
+    absl::MutexLock lock(&shard->mutex);
+    auto* queue = &shard->protected_queue;
+    if (queue->next == queue) continue;
+    auto* entry = static_cast<CacheEntryImpl*>(queue->next);
+    UnlinkFromEvictionQueue(pool, *shard, entry);
+    InsertIntoQueue(*shard, &shard->eviction_queue, entry);
+    UpdateQueueFronts(*shard);
   }
-  InsertBefore(LruListAccessor{}, eviction_queue, entry);
 }
 
 void DestroyCache(CachePoolImpl* pool, CacheImpl* cache);
 
+// Evicts entries until `total_bytes_` is within `total_bytes_limit`, or no
+// unused entries remain.
+//
+// Must be called without holding any LRU shard mutex.
 void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-
   constexpr size_t kBufferSize = 64;
   std::array<CacheEntryImpl*, kBufferSize> entries_to_delete;
   // Indicates for each entry in `entries_to_delete` whether its cache should
@@ -154,7 +259,6 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
   size_t num_entries_to_delete = 0;
 
   const auto destroy_entries = [&] {
-    internal::ScopedWriterUnlock unlock(pool->lru_mutex_);
     for (size_t i = 0; i < num_entries_to_delete; ++i) {
       auto* entry = entries_to_delete[i];
       if (should_delete_cache_for_entry[i]) {
@@ -164,54 +268,79 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
       entry->cache_ = nullptr;
       delete Access::StaticCast<CacheEntry>(entry);
     }
+    num_entries_to_delete = 0;
   };
 
+  const bool two_queue =
+      pool->limits_.eviction_policy == CacheEvictionPolicy::kTwoQueue;
   while (pool->total_bytes_.load(std::memory_order_acquire) >
          pool->limits_.total_bytes_limit) {
-    auto* queue = &pool->eviction_queue_;
-    if (queue->next == queue) {
-      // Queue empty.
+    if (two_queue) DemoteProtectedEntries(pool);
+    bool protected_queue = false;
+    auto* lru_shard = FindOldestShard(pool, protected_queue);
+    if (!lru_shard && two_queue) {
+      protected_queue = true;
+      lru_shard = FindOldestShard(pool, protected_queue);
+    }
+    if (!lru_shard) {
+      // All queues empty.
       break;
     }
-    auto* entry = static_cast<CacheEntryImpl*>(queue->next);
-    auto* cache = entry->cache_;
-    bool evict = false;
-    bool should_delete_cache = false;
-    auto& shard = cache->ShardForKey(entry->key_);
-    if (absl::MutexLock lock(&shard.mutex);
-        entry->reference_count_.load(std::memory_order_acquire) == 0) {
-      [[maybe_unused]] size_t erase_count = shard.entries.erase(entry);
-      assert(erase_count == 1);
-      if (shard.entries.empty()) {
-        if (DecrementCacheReferenceCount(cache,
-                                         CacheImpl::kNonEmptyShardIncrement)
-                .should_delete()) {
-          should_delete_cache = true;
+    {
+      absl::MutexLock lru_lock(&lru_shard->mutex);
+      auto* queue = protected_queue ? &lru_shard->protected_queue
+                                    : &lru_shard->eviction_queue;
+      if (queue->next == queue) {
+        // Queue was concurrently emptied.
+        continue;
+      }
+      auto* entry = static_cast<CacheEntryImpl*>(queue->next);
+      auto* cache = entry->cache_;
+      bool evict = false;
+      bool should_delete_cache = false;
+      auto& shard = cache->ShardForKey(entry->key_);
+      if (absl::MutexLock lock(&shard.mutex);
+          entry->reference_count_.load(std::memory_order_acquire) == 0) {
+        [[maybe_unused]] size_t erase_count = shard.entries.erase(entry);
+        assert(erase_count == 1);
+        if (shard.entries.empty()) {
+          if (DecrementCacheReferenceCount(cache,
+                                           CacheImpl::kNonEmptyShardIncrement)
+                  .should_delete()) {
+            should_delete_cache = true;
+          }
         }
+        evict = true;
       }
-      evict = true;
-    }
-    if (!evict) {
-      // Entry is still in use, remove it from LRU eviction list.  For
-      // efficiency, entries aren't removed from the eviction list when the
-      // reference count increases.  It will be put back on the eviction list
-      // the next time the reference count becomes 0.  There is no race
-      // condition here because both `cache->entries_mutex_` and
-      // `pool->lru_mutex_` are held, and the reference count cannot increase
-      // from zero except while holding `cache->entries_mutex_`, and the
-      // reference count cannot decrease to zero except while holding
-      // `pool->lru_mutex_`.
-      UnlinkListNode(entry);
-      continue;
+      if (!evict) {
+        // Entry is still in use, remove it from LRU eviction list.  For
+        // efficiency, entries aren't removed from the eviction list when the
+        // reference count increases.  It will be put back on the eviction
+        // list the next time the reference count becomes 0.  There is no race
+        // condition here because both `cache->entries_mutex_` and the LRU
+        // shard mutex are held, and the reference count cannot increase from
+        // zero except while holding `cache->entries_mutex_`, and the
+        // reference count cannot decrease to zero except while holding the
+        // LRU shard mutex.
+        //
+        // A protected entry that is still in use keeps its protected status.
+        if (entry->protected_) {
+          entry->accessed_.store(true, std::memory_order_relaxed);
+        }
+        UnlinkFromEvictionQueue(pool, *lru_shard, entry);
+        UpdateQueueFronts(*lru_shard);
+        continue;
+      }
+      UnregisterEntryFromPool(entry, *lru_shard, pool);
+      UpdateQueueFronts(*lru_shard);
+      evict_count.Increment();
+      // Enqueue entry to be destroyed with the LRU shard mutex released.
+      should_delete_cache_for_entry[num_entries_to_delete] =
+          should_delete_cache;
+      entries_to_delete[num_entries_to_delete++] = entry;
     }
-    UnregisterEntryFromPool(entry, pool);
-    evict_count.Increment();
-    // Enqueue entry to be destroyed with `pool->lru_mutex_` released.
-    should_delete_cache_for_entry[num_entries_to_delete] = should_delete_cache;
-    entries_to_delete[num_entries_to_delete++] = entry;
     if (num_entries_to_delete == entries_to_delete.size()) {
       destroy_entries();
-      num_entries_to_delete = 0;
     }
   }
   destroy_entries();
@@ -239,7 +368,9 @@ void DestroyCache(CachePoolImpl* pool,
       }
     }
     if (HasLruCache(pool)) {
-      absl::MutexLock lru_lock(&pool->lru_mutex_);
+      for (auto& lru_shard : pool->lru_shards_) {
+        lru_shard.mutex.Lock();
+      }
       for (auto& shard : cache->shards_) {
         absl::MutexLock lock(&shard.mutex);
         for (CacheEntryImpl* entry : shard.entries) {
@@ -248,9 +379,13 @@ void DestroyCache(CachePoolImpl* pool,
           // concurrent attempt to return `entry` back to the eviction list.
           entry->reference_count_.fetch_add(2, std::memory_order_acq_rel);
           // Ensure entry is not on LRU list.
-          UnregisterEntryFromPool(entry, pool);
+          UnregisterEntryFromPool(entry, pool->LruShardForEntry(entry), pool);
         }
       }
+      for (auto& lru_shard : pool->lru_shards_) {
+        UpdateQueueFronts(lru_shard);
+        lru_shard.mutex.Unlock();
+      }
       // At this point, no external references to any entry are possible, and
       // the entries can safely be destroyed without holding any locks.
     } else {
@@ -368,16 +503,18 @@ void StrongPtrTraitsCacheEntry::decrement_impl(
         delete entry_impl;
       }
     } else {
+      auto& lru_shard = pool_impl->LruShardForEntry(entry_impl);
       auto lock = DecrementReferenceCountWithLock(
           entry_impl->reference_count_,
-          [pool_impl]() -> absl::Mutex& { return pool_impl->lru_mutex_; },
+          [&lru_shard]() -> absl::Mutex& { return lru_shard.mutex; },
           new_count,
           /*decrease_amount=*/2, /*lock_threshold=*/1);
       TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement",
                                                 entry_impl, new_count);
       if (!lock) return;
       if (new_count == 0) {
-        AddToEvictionQueue(pool_impl, entry_impl);
+        AddToEvictionQueue(pool_impl, lru_shard, entry_impl);
+        lock = {};
         MaybeEvictEntries(pool_impl);
       }
     }
@@ -503,6 +640,7 @@ PinnedCacheEntry<Cache> GetCacheEntryInternal(internal::Cache* cache,
     if (it != shard.entries.end()) {
       hit_count.Increment();
       auto* entry_impl = *it;
+      entry_impl->accessed_.store(true, std::memory_order_relaxed);
       auto old_count =
           entry_impl->reference_count_.fetch_add(2, std::memory_order_acq_rel);
       TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:increment",
@@ -672,19 +810,21 @@ void intrusive_ptr_decrement(CacheEntryWeakState* p)
     }
     return;
   }
-  auto pool_lock = DecrementReferenceCountWithLock(
+  auto& lru_shard = pool->LruShardForEntry(entry);
+  auto lru_lock = DecrementReferenceCountWithLock(
       entry->reference_count_,
-      [pool]() -> absl::Mutex& { return pool->lru_mutex_; }, new_count,
+      [&lru_shard]() -> absl::Mutex& { return lru_shard.mutex; }, new_count,
       /*decrease_amount=*/1,
       /*lock_threshold=*/0);
   TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement", entry,
                                             new_count);
-  if (!pool_lock) return;
+  if (!lru_lock) return;
 
   // There are also no remaining strong references.  Update the entry's queue
   // state if applicable.
   weak_lock = {};
-  AddToEvictionQueue(pool, entry);
+  AddToEvictionQueue(pool, lru_shard, entry);
+  lru_lock = {};
   MaybeEvictEntries(pool);
 }
 
@@ -731,7 +871,6 @@ void UpdateTotalBytes(CachePoolImpl& pool, ptrdiff_t change) {
       change <= 0) {
     return;
   }
-  absl::MutexLock lock(&pool.lru_mutex_);
   MaybeEvictEntries(&pool);
 }
 
@@ -98,7 +98,10 @@ using CachePtr = internal_cache::CachePtr<CacheType>;
 /// once the user-specified `CachePool:Limits` are reached, entries are evicted
 /// in order to attempt to free memory.  The limits apply to the aggregate
 /// memory usage of all caches managed by the pool, and a single LRU eviction
-/// queue is used for all managed caches.
+/// queue is used for all managed caches.  With
+/// `CacheEvictionPolicy::kTwoQueue`, entries that are accessed again while
+/// cached are moved to a separate protected queue, which is only evicted from
+/// once the LRU eviction queue is empty.
 class CachePool : private internal_cache::CachePoolImpl {
  public:
   using Limits = CachePoolLimits;
@@ -53,6 +53,7 @@ namespace internal_cache {
 using internal::Cache;
 using internal::CacheEntry;
 using internal::CachePool;
+using internal::CacheEvictionPolicy;
 using internal::CachePoolLimits;
 
 #define TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT(method, p, new_count) \
@@ -79,8 +80,8 @@ struct CacheEntryWeakState {
   // of `entry->reference_count_` is set to 1.
   std::atomic<size_t> weak_references;
 
-  // Mutex that protects access to `entry`.  If locked along with the cache
-  // pool's mutex, this mutex must be locked first.
+  // Mutex that protects access to `entry`.  If locked along with an LRU shard
+  // mutex of the cache pool, this mutex must be locked first.
   absl::Mutex mutex;
 
   // Pointer to the entry for which this is a weak reference.
@@ -119,6 +120,24 @@ class CacheEntryImpl : public internal_cache::LruListNode {
   // LRU cache state.
   size_t num_bytes_;
 
+  // Set when the entry is looked up while already present in the cache.  With
+  // `CacheEvictionPolicy::kTwoQueue`, the entry is promoted to the protected
+  // queue the next time it becomes unused.
+  std::atomic<bool> accessed_{false};
+
+  // Indicates that the entry is linked into the `protected_queue` rather than
+  // the `eviction_queue` of its `CachePoolImpl::LruShard`.  Protected by the
+  // mutex of the LRU shard.
+  bool protected_ = false;
+
+  // Value of `num_bytes_` accounted in `CachePoolImpl::protected_bytes_` while
+  // `protected_` is set.  Protected by the mutex of the LRU shard.
+  size_t protected_bytes_ = 0;
+
+  // `CachePoolImpl::LruShard::last_eviction_sequence` when the entry was last
+  // added to an eviction queue.  Protected by the mutex of the LRU shard.
+  uint64_t eviction_sequence_ = 0;
+
   // Each strong reference adds 2 to the reference count.  The least-significant
   // bit (LSB) indicates if there is at least one weak reference,
   // `weak_state_.load()->reference_count.load() > 0`.
@@ -218,7 +237,7 @@ class CacheImpl {
   /// If a thread causes the reference count to reach a ``ShouldDelete == true`
   /// state from a `ShouldDelete == false` state, then the thread must destroy
   /// the cache immediately. However, because of the use of multiple mutexes
-  /// (per shard mutexes on the cache entries hash table, `pool_->lru mutex_`,
+  /// (per shard mutexes on the cache entries hash table, `pool_->lru_shards_`,
   /// `pool_->caches_mutex_`), it is possible for another thread that is
   /// modifying `reference_count` to encounter a cache already in the
   /// `ShouldDelete == true`. In this case, the other thread is NOT responsible
@@ -273,14 +292,59 @@ class CachePoolImpl {
   CachePoolLimits limits_;
   std::atomic<size_t> total_bytes_;
 
-  // Protects access to `eviction_queue_`.  If `lru_mutex_` is held at the same
-  // time as `caches_mutex_`, `caches_mutex_` must be acquired first.  If
-  // `lru_mutex_` is held at the same time as `entries_mutex_`, `lru_mutex_`
-  // must be acquired first.
-  absl::Mutex lru_mutex_;
+  constexpr static size_t kNumLruShards = 16;
+
+  // Value of `LruShard::eviction_queue_front` and
+  // `LruShard::protected_queue_front` for an empty queue.
+  constexpr static uint64_t kEmptyQueue = ~uint64_t(0);
+
+  // Eviction queues for the subset of entries assigned to the shard by
+  // `LruShardForEntry`.  Sharding the queues avoids contention on a single
+  // mutex when many threads concurrently release cache entries.
+  //
+  // Entries are added to the queues in order of a sequence number derived
+  // from a monotonic clock, and evicted from the shard with the smallest
+  // sequence number at the front of its queue, such that eviction
+  // approximates a single pool-wide queue up to the resolution of the clock.
+  struct ABSL_CACHELINE_ALIGNED LruShard {
+    // Protects access to the queues.  If held at the same time as
+    // `caches_mutex_`, `caches_mutex_` must be acquired first.  If held at the
+    // same time as the mutex of a cache shard, this must be acquired first.
+    // Only `DestroyCache` holds more than one LRU shard mutex at a time, and
+    // acquires them in order.
+    absl::Mutex mutex;
+
+    // next points to the front of the queue, which is the first to be
+    // evicted.
+    //
+    // With `CacheEvictionPolicy::kTwoQueue`, this is the probationary queue.
+    LruListNode eviction_queue;
+
+    // Queue of entries that were accessed again while cached, only used with
+    // `CacheEvictionPolicy::kTwoQueue`.  Entries are evicted from the
+    // protected queues only once all `eviction_queue` lists are empty.
+    LruListNode protected_queue;
+
+    // `eviction_sequence_` of the front entry of each queue, or `kEmptyQueue`.
+    // Only modified while holding `mutex`, but read without it in order to
+    // select the shard from which to evict.
+    std::atomic<uint64_t> eviction_queue_front{kEmptyQueue};
+    std::atomic<uint64_t> protected_queue_front{kEmptyQueue};
+
+    // Sequence number of the entry most recently added to either queue.
+    // Protected by `mutex`.
+    uint64_t last_eviction_sequence = 0;
+  };
+
+  LruShard lru_shards_[kNumLruShards];
+
+  LruShard& LruShardForEntry(CacheEntryImpl* entry) {
+    absl::Hash<CacheEntryImpl*> h;
+    return lru_shards_[h(entry) % kNumLruShards];
+  }
 
-  // next points to the front of the queue, which is the first to be evicted.
-  LruListNode eviction_queue_;
+  // Total size of the entries in the `protected_queue` lists.
+  std::atomic<size_t> protected_bytes_{0};
 
   // Protects access to `caches_`.
   absl::Mutex caches_mutex_;
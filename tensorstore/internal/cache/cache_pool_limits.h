@@ -16,16 +16,32 @@
 #define TENSORSTORE_INTERNAL_CACHE_CACHE_POOL_LIMITS_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 namespace tensorstore {
 namespace internal {
 
+/// Policy used to select the entries evicted from a cache pool when its
+/// `total_bytes_limit` is exceeded.
+enum class CacheEvictionPolicy : uint8_t {
+  /// Evicts the least recently used entry first.
+  kLru = 0,
+
+  /// Simplified 2Q policy.  Entries start out in a probationary queue, and are
+  /// promoted to a protected queue if they are accessed again while cached.
+  /// Entries are evicted from the probationary queue first, such that a scan
+  /// that accesses each entry only once does not displace the working set.
+  kTwoQueue = 1,
+};
+
 /// Memory limit parameters for a cache pool.
 struct CachePoolLimits {
   size_t total_bytes_limit = 0;
 
+  CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::kLru;
+
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.total_bytes_limit);
+    return f(x.total_bytes_limit, x.eviction_policy);
   };
 };
 
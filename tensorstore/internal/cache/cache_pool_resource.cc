@@ -14,12 +14,15 @@
 
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 
+#include <string_view>
+
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/util/result.h"
 
@@ -37,7 +40,17 @@ struct CachePoolResourceTraits
     return jb::Object(
         jb::Member("total_bytes_limit",
                    jb::Projection(&Spec::total_bytes_limit,
-                                  jb::DefaultValue([](auto* v) { *v = 0; }))));
+                                  jb::DefaultValue([](auto* v) { *v = 0; }))),
+        jb::Member(
+            "eviction_policy",
+            jb::Projection(
+                &Spec::eviction_policy,
+                jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                    [](auto* v) { *v = CacheEvictionPolicy::kLru; },
+                    jb::Enum<CacheEvictionPolicy, std::string_view>({
+                        {CacheEvictionPolicy::kLru, "lru"},
+                        {CacheEvictionPolicy::kTwoQueue, "2q"},
+                    })))));
   }
   static Result<Resource> Create(const Spec& limits,
                                  ContextResourceCreationContext context) {
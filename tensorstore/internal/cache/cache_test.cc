@@ -27,6 +27,7 @@
 #include <gtest/gtest.h>
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
@@ -36,6 +37,7 @@ namespace {
 
 using ::tensorstore::UniqueWriterLock;
 using ::tensorstore::internal::Cache;
+using ::tensorstore::internal::CacheEvictionPolicy;
 using ::tensorstore::internal::CachePool;
 using ::tensorstore::internal::CachePtr;
 using ::tensorstore::internal::GetCache;
@@ -163,7 +165,27 @@ void AssertInvariants(const CachePool::StrongPtr& pool,
                       absl::flat_hash_set<Cache*> expected_caches)
     ABSL_NO_THREAD_SAFETY_ANALYSIS {
   auto* pool_impl = GetPoolImpl(pool);
-  auto eviction_queue_entries = GetEntrySet(&pool_impl->eviction_queue_);
+  absl::flat_hash_set<EntryIdentifier> eviction_queue_entries;
+  size_t expected_protected_bytes = 0;
+  for (auto& lru_shard : pool_impl->lru_shards_) {
+    auto shard_entries = GetEntrySet(&lru_shard.eviction_queue);
+    auto protected_entries = GetEntrySet(&lru_shard.protected_queue);
+    for (const auto& entry : shard_entries) {
+      auto* entry_impl = static_cast<CacheEntryImpl*>(entry.second);
+      EXPECT_FALSE(entry_impl->protected_);
+      EXPECT_EQ(&lru_shard, &pool_impl->LruShardForEntry(entry_impl));
+    }
+    for (const auto& entry : protected_entries) {
+      auto* entry_impl = static_cast<CacheEntryImpl*>(entry.second);
+      EXPECT_TRUE(entry_impl->protected_);
+      EXPECT_EQ(&lru_shard, &pool_impl->LruShardForEntry(entry_impl));
+      expected_protected_bytes += entry_impl->protected_bytes_;
+    }
+    eviction_queue_entries.insert(shard_entries.begin(), shard_entries.end());
+    eviction_queue_entries.insert(protected_entries.begin(),
+                                  protected_entries.end());
+  }
+  EXPECT_EQ(expected_protected_bytes, pool_impl->protected_bytes_.load());
 
   absl::flat_hash_set<EntryIdentifier> expected_eviction_queue_entries;
 
@@ -817,6 +839,32 @@ TEST(CacheTest, ConcurrentGetReleaseCacheEntry) {
       concurrent_op, concurrent_op, concurrent_op);
 }
 
+TEST(CacheTest, ConcurrentGetReleaseCacheEntriesEvict) {
+  CachePool::Limits limits = {};
+  limits.total_bytes_limit = 4;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache");
+  const auto concurrent_op = [&](int thread) {
+    // Get then release entries that map to different LRU shards, such that
+    // releasing an entry concurrently evicts entries of other shards.
+    for (int i = 0; i < 8; ++i) {
+      auto entry = GetCacheEntry(cache, std::to_string(thread * 8 + i));
+    }
+  };
+  TestConcurrent(
+      kDefaultIterations,
+      /*initialize=*/
+      [&] {},
+      /*finalize=*/
+      [&] {
+        TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+        EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), 4);
+      },
+      // Concurrent operations:
+      [&] { concurrent_op(0); }, [&] { concurrent_op(1); },
+      [&] { concurrent_op(2); });
+}
+
 TEST(CacheTest, ConcurrentDestroyCacheEvictEntries) {
   CachePool::Limits limits = {};
   limits.total_bytes_limit = 1;
@@ -1103,6 +1151,58 @@ TEST(CacheTest, PoolWithNonZeroBytesLimit) {
   EXPECT_THAT(log->entry_destroy_log, ElementsAre(Pair("cache", "a")));
 }
 
+// Accesses "hot" twice, such that it is considered part of the working set,
+// and then scans 10 other entries once each.  Returns `true` if "hot" is still
+// cached.
+bool HotEntrySurvivesScan(CachePool::Limits limits) {
+  limits.total_bytes_limit = 10000;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache");
+  for (int i = 0; i < 2; ++i) {
+    auto entry = GetCacheEntry(cache, "hot");
+    entry->data = "hot";
+    entry->ChangeSize(2000);
+  }
+  for (int i = 0; i < 10; ++i) {
+    auto entry = GetCacheEntry(cache, absl::StrCat("scan", i));
+    entry->data = "scan";
+    entry->ChangeSize(2000);
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+  return GetCacheEntry(cache, "hot")->data == "hot";
+}
+
+TEST(CacheTest, LruEvictionPolicyScan) {
+  CachePool::Limits limits;
+  limits.eviction_policy = CacheEvictionPolicy::kLru;
+  EXPECT_FALSE(HotEntrySurvivesScan(limits));
+}
+
+TEST(CacheTest, TwoQueueEvictionPolicyScan) {
+  CachePool::Limits limits;
+  limits.eviction_policy = CacheEvictionPolicy::kTwoQueue;
+  EXPECT_TRUE(HotEntrySurvivesScan(limits));
+}
+
+TEST(CacheTest, TwoQueueEvictionPolicyDemotesProtectedEntries) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  limits.eviction_policy = CacheEvictionPolicy::kTwoQueue;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache", log);
+  // Promote "a" through "e" to the protected queue, which exceeds the share of
+  // the protected queue and causes "a" to be demoted and evicted.
+  for (auto key : {"a", "b", "c", "d", "e"}) {
+    for (int i = 0; i < 2; ++i) {
+      auto entry = GetCacheEntry(cache, key);
+      entry->ChangeSize(2500);
+    }
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+  EXPECT_THAT(log->entry_destroy_log, ElementsAre(Pair("cache", "a")));
+}
+
 TEST(CacheTest, WeakRefOwnedByEntry) {
   auto log = std::make_shared<TestCache::RequestLog>();
   auto pool = CachePool::Make(kSmallCacheLimits);
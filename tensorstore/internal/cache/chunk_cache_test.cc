@@ -41,6 +41,7 @@
 #include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/context.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
@@ -96,6 +97,7 @@ namespace kvstore = tensorstore::kvstore;
 using ::tensorstore::ArrayView;
 using ::tensorstore::Box;
 using ::tensorstore::BoxView;
+using ::tensorstore::ChunkLayout;
 using ::tensorstore::DimensionIndex;
 using ::tensorstore::Executor;
 using ::tensorstore::Future;
@@ -229,6 +231,26 @@ class TestCache
 class TestDriver : public tensorstore::internal::ChunkCacheDriver {
  public:
   using ::tensorstore::internal::ChunkCacheDriver::ChunkCacheDriver;
+
+  Result<ChunkLayout> GetChunkLayout(
+      tensorstore::IndexTransformView<> transform) override {
+    const auto& grid = cache()->grid();
+    const auto& component = grid.components[component_index()];
+    std::vector<Index> chunk_shape(component.rank(), 0);
+    for (size_t i = 0; i < grid.chunk_shape.size(); ++i) {
+      chunk_shape[component.chunked_to_cell_dimensions[i]] =
+          grid.chunk_shape[i];
+    }
+    ChunkLayout layout;
+    TENSORSTORE_RETURN_IF_ERROR(layout.Set(ChunkLayout::GridOrigin(
+        tensorstore::GetConstantVector<Index, 0>(component.rank()))));
+    TENSORSTORE_RETURN_IF_ERROR(
+        layout.Set(ChunkLayout::ReadChunkShape(chunk_shape)));
+    TENSORSTORE_RETURN_IF_ERROR(
+        layout.Set(ChunkLayout::WriteChunkShape(chunk_shape)));
+    return ApplyIndexTransform(transform, std::move(layout));
+  }
+
   void GarbageCollectionVisit(
       tensorstore::garbage_collection::GarbageCollectionVisitor& visitor)
       const final {
@@ -1777,6 +1799,88 @@ TEST_F(ChunkCacheTest, SelfCopySameChunkSeparateCachesWithExistingData) {
   EXPECT_THAT(GetChunk({0}), ElementsAre(MakeArray<int>({42, 42})));
 }
 
+TEST_F(ChunkCacheTest, CopyBytesLimit) {
+  // Dimension 0 is chunked with a size of 2.
+  grid = GetSimple1DGrid();
+  auto source_cache = MakeChunkCache("source");
+  auto target_cache = MakeChunkCache("target");
+
+  // Copies chunks 0 and 1 to chunks 2 and 3, with a limit of one chunk.
+  auto write_future = tensorstore::Copy(
+      GetTensorStore(source_cache) | tensorstore::Dims(0).SizedInterval(0, 4),
+      GetTensorStore(target_cache) | tensorstore::Dims(0).SizedInterval(4, 4),
+      tensorstore::CopyBytesLimit{2 * sizeof(int)});
+  {
+    auto r = mock_store->read_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(0));
+    r(memory_store);
+  }
+  // Chunk 1 is not read until the copy of chunk 0 has been committed.
+  {
+    auto r = mock_store->write_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(2));
+    EXPECT_TRUE(mock_store->read_requests.empty());
+    r(memory_store);
+  }
+  {
+    auto r = mock_store->read_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(1));
+    r(memory_store);
+  }
+  {
+    auto r = mock_store->write_requests.pop();
+    EXPECT_THAT(ParseKey(r.key), ElementsAre(3));
+    r(memory_store);
+  }
+  TENSORSTORE_EXPECT_OK(write_future);
+  EXPECT_THAT(GetChunk({2}), ElementsAre(MakeArray<int>({0, 1})));
+  EXPECT_THAT(GetChunk({3}), ElementsAre(MakeArray<int>({2, 3})));
+}
+
+TEST_F(ChunkCacheTest, CopyBytesLimitAlignsToTargetWriteChunks) {
+  // The source is chunked with a size of 2, and filled with sequential values.
+  grid = GetSimple1DGrid();
+  auto source_store = MockKeyValueStore::Make();
+  source_store->forward_to = tensorstore::GetMemoryKeyValueStore();
+  auto pool = CachePool::Make(CachePool::Limits{10000000});
+  CachePtr<ChunkCache> source_cache =
+      GetCache<TestCache>(pool.get(), "source", [&] {
+        return std::make_unique<TestCache>(source_store, *grid, thread_pool);
+      });
+  auto source = GetTensorStore(source_cache);
+
+  // The target is chunked with a size of 4, and filled with zeros.
+  grid = ChunkGridSpecification({ChunkGridSpecification::Component{
+      AsyncWriteArray::Spec{
+          tensorstore::AllocateArray<int>(BoxView<>({0}, {10}),
+                                          tensorstore::c_order,
+                                          tensorstore::value_init),
+          Box<>(1)},
+      /*chunk_shape=*/{4}}});
+  auto target_cache = MakeChunkCache("target");
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+
+  // With a limit of one source chunk, the copy still proceeds in units of
+  // target chunks, such that each target chunk is written once.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Copy(
+          source | tensorstore::Dims(0).SizedInterval(0, 8),
+          GetTensorStore(target_cache) |
+              tensorstore::Dims(0).SizedInterval(0, 8),
+          tensorstore::CopyBytesLimit{2 * sizeof(int)})
+          .commit_future.result());
+  std::vector<std::string> written_keys;
+  for (const auto& entry : mock_store->request_log.pop_all()) {
+    if (entry["type"] == "write") {
+      written_keys.push_back(entry["key"].get<std::string>());
+    }
+  }
+  EXPECT_THAT(written_keys, ::testing::UnorderedElementsAre("0", "1"));
+  EXPECT_THAT(GetChunk({0}), ElementsAre(MakeArray<int>({0, 1, 2, 3})));
+  EXPECT_THAT(GetChunk({1}), ElementsAre(MakeArray<int>({4, 5, 6, 7})));
+}
+
 TEST_F(ChunkCacheTest, SeparateCachesTransactionalReadThenWrite) {
   // Dimension 0 is chunked with a size of 2.
   grid = GetSimple1DGrid();
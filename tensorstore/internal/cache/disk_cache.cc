@@ -0,0 +1,710 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/disk_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/crc/crc32c.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/digest/sha256.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/os/file_lister.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_modify_write.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/garbage_collection.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag disk_cache_logging("disk_cache");
+
+using ::tensorstore::internal_os::FileInfo;
+using ::tensorstore::internal_os::UniqueFileDescriptor;
+
+constexpr std::string_view kFileMagic = "TSDC0001";
+constexpr std::string_view kTempSuffix = ".tmp";
+
+/// Number of threads used to access the cache files.
+constexpr size_t kDiskCacheThreads = 4;
+
+/// Number of bytes of the SHA256 digest of the key used as the file name.
+constexpr size_t kFileNameDigestBytes = 16;
+
+std::string GetFileName(std::string_view key) {
+  SHA256Digester digester;
+  digester.Write(key);
+  auto digest = digester.Digest();
+  return absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), kFileNameDigestBytes));
+}
+
+absl::crc32c_t ComputeCrc32c(const absl::Cord& cord) {
+  absl::crc32c_t crc{0};
+  for (std::string_view chunk : cord.Chunks()) {
+    crc = absl::ExtendCrc32c(crc, chunk);
+  }
+  return crc;
+}
+
+void AppendLengthPrefixed(std::string& out, std::string_view s) {
+  char size[4];
+  absl::little_endian::Store32(size, static_cast<uint32_t>(s.size()));
+  out.append(size, 4);
+  out.append(s);
+}
+
+/// Encodes the header of a cache file, which precedes the value.
+std::string EncodeHeader(std::string_view key,
+                         const StorageGeneration& generation,
+                         const absl::Cord& value) {
+  std::string header(kFileMagic);
+  AppendLengthPrefixed(header, key);
+  AppendLengthPrefixed(header, generation.value);
+  char crc[4];
+  absl::little_endian::Store32(crc,
+                               static_cast<uint32_t>(ComputeCrc32c(value)));
+  header.append(crc, 4);
+  return header;
+}
+
+bool ConsumeLengthPrefixed(std::string_view& in, std::string_view& s) {
+  if (in.size() < 4) return false;
+  const uint32_t size = absl::little_endian::Load32(in.data());
+  in.remove_prefix(4);
+  if (in.size() < size) return false;
+  s = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+/// Decodes a cache file.
+///
+/// \returns `false` if `contents` is not a valid cache file.
+bool DecodeFile(std::string_view contents, std::string_view& key,
+                StorageGeneration& generation, absl::Cord& value) {
+  if (!absl::ConsumePrefix(&contents, kFileMagic)) return false;
+  std::string_view generation_value;
+  if (!ConsumeLengthPrefixed(contents, key) ||
+      !ConsumeLengthPrefixed(contents, generation_value) ||
+      contents.size() < 4) {
+    return false;
+  }
+  const uint32_t crc = absl::little_endian::Load32(contents.data());
+  contents.remove_prefix(4);
+  if (static_cast<uint32_t>(absl::ComputeCrc32c(contents)) != crc) {
+    return false;
+  }
+  generation.value = std::string(generation_value);
+  value = absl::Cord(contents);
+  return true;
+}
+
+Result<std::string> ReadFileContents(const std::string& path) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto fd,
+                               internal_os::OpenExistingFileForReading(path));
+  FileInfo info;
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::GetFileInfo(fd.get(), &info));
+  std::string contents(internal_os::GetSize(info), '\0');
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n, internal_os::ReadFromFile(fd.get(), contents.data() + offset,
+                                          contents.size() - offset, offset));
+    if (n == 0) break;
+    offset += n;
+  }
+  contents.resize(offset);
+  return contents;
+}
+
+/// Writes a new file, which is returned open for use with `RenameOpenFile`.
+Result<UniqueFileDescriptor> WriteFile(const std::string& path,
+                                       absl::Cord data) {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto fd, internal_os::OpenFileWrapper(
+                   path, internal_os::OpenFlags::OpenWriteOnly |
+                             internal_os::OpenFlags::Create |
+                             internal_os::OpenFlags::Exclusive));
+  while (!data.empty()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto n,
+                                 internal_os::WriteCordToFile(fd.get(), data));
+    data.RemovePrefix(n);
+  }
+  return fd;
+}
+
+/// Caches opened by this process, such that multiple contexts that specify
+/// the same directory share a single index.
+struct DiskCacheRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, std::weak_ptr<DiskCache>> caches
+      ABSL_GUARDED_BY(mutex);
+};
+
+DiskCacheRegistry& GetDiskCacheRegistry() {
+  static absl::NoDestructor<DiskCacheRegistry> registry;
+  return *registry;
+}
+
+}  // namespace
+
+DiskCache::DiskCache(Options options)
+    : options_(std::move(options)),
+      executor_(DetachedThreadPool(kDiskCacheThreads)) {}
+
+Result<std::shared_ptr<DiskCache>> DiskCache::Open(Options options) {
+  auto& registry = GetDiskCacheRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  auto& weak_cache = registry.caches[options.path];
+  if (auto cache = weak_cache.lock()) {
+    if (cache->options_.total_bytes_limit != options.total_bytes_limit) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Disk cache ", QuoteString(options.path),
+          " is already open with a total_bytes_limit of ",
+          cache->options_.total_bytes_limit));
+    }
+    return cache;
+  }
+  auto cache = std::make_shared<DiskCache>(std::move(options));
+  TENSORSTORE_RETURN_IF_ERROR(cache->LoadIndex());
+  weak_cache = cache;
+  return cache;
+}
+
+std::string DiskCache::GetFilePath(std::string_view file_name) const {
+  return absl::StrCat(options_.path, "/", file_name);
+}
+
+absl::Status DiskCache::LoadIndex() {
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::MakeDirectory(options_.path));
+  struct LoadedFile {
+    std::string file_name;
+    size_t size;
+    absl::Time mtime;
+  };
+  std::vector<LoadedFile> files;
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::RecursiveFileList(
+      options_.path,
+      /*recurse_into=*/[](std::string_view) { return false; },
+      /*on_item=*/
+      [&](internal_os::ListerEntry entry) -> absl::Status {
+        if (entry.IsDirectory()) return absl::OkStatus();
+        std::string_view name = entry.GetPathComponent();
+        if (absl::EndsWith(name, kTempSuffix)) {
+          // Incomplete write of a previous process.
+          entry.Delete().IgnoreError();
+          return absl::OkStatus();
+        }
+        FileInfo info;
+        if (!internal_os::GetFileInfo(entry.GetFullPath(), &info).ok()) {
+          return absl::OkStatus();
+        }
+        files.push_back({std::string(name),
+                         static_cast<size_t>(internal_os::GetSize(info)),
+                         internal_os::GetMTime(info)});
+        return absl::OkStatus();
+      }));
+  std::sort(files.begin(), files.end(),
+            [](const LoadedFile& a, const LoadedFile& b) {
+              return a.mtime < b.mtime;
+            });
+  absl::MutexLock lock(&mutex_);
+  for (auto& file : files) {
+    lru_.push_back(file.file_name);
+    total_bytes_ += file.size;
+    index_.emplace(std::move(file.file_name),
+                   IndexEntry{file.size, StorageGeneration::Unknown(),
+                              absl::InfinitePast(), std::prev(lru_.end())});
+  }
+  EvictLocked();
+  return absl::OkStatus();
+}
+
+std::optional<DiskCache::Entry> DiskCache::Read(std::string_view key) {
+  const std::string file_name = GetFileName(key);
+  StorageGeneration indexed_generation;
+  absl::Time time;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(file_name);
+    if (it == index_.end()) return std::nullopt;
+    lru_.splice(lru_.end(), lru_, it->second.lru_position);
+    indexed_generation = it->second.generation;
+    time = it->second.time;
+  }
+  std::optional<Entry> entry;
+  std::string_view stored_key;
+  auto contents = ReadFileContents(GetFilePath(file_name));
+  if (contents.ok()) {
+    entry.emplace();
+    if (!DecodeFile(*contents, stored_key, entry->generation, entry->value)) {
+      ABSL_LOG_IF(WARNING, disk_cache_logging)
+          << "Deleting invalid disk cache file "
+          << QuoteString(GetFilePath(file_name));
+      entry.reset();
+    }
+  }
+  absl::MutexLock lock(&mutex_);
+  if (!entry) {
+    EraseLocked(file_name);
+    return std::nullopt;
+  }
+  // Files may differ in key only due to a hash collision.
+  if (stored_key != key) return std::nullopt;
+  auto it = index_.find(file_name);
+  if (it == index_.end()) return std::nullopt;
+  if (StorageGeneration::IsUnknown(it->second.generation)) {
+    // Written by a previous process.
+    it->second.generation = entry->generation;
+  }
+  // The file may have been replaced after the index was checked, in which
+  // case the time recorded for the previous generation does not apply.
+  if (entry->generation == indexed_generation) {
+    entry->time = time;
+  } else {
+    entry->time = absl::InfinitePast();
+  }
+  return entry;
+}
+
+void DiskCache::Write(std::string_view key, const absl::Cord& value,
+                      const StorageGeneration& generation, absl::Time time) {
+  const std::string file_name = GetFileName(key);
+  absl::Cord data(EncodeHeader(key, generation, value));
+  data.Append(value);
+  const size_t size = data.size();
+  if (size > options_.total_bytes_limit) {
+    Erase(key);
+    return;
+  }
+  uint64_t temp_id;
+  {
+    absl::MutexLock lock(&mutex_);
+    temp_id = next_temp_id_++;
+  }
+  const std::string temp_path =
+      GetFilePath(absl::StrCat(file_name, ".", temp_id, kTempSuffix));
+  auto fd = WriteFile(temp_path, std::move(data));
+  if (!fd.ok()) {
+    ABSL_LOG_IF(WARNING, disk_cache_logging)
+        << "Failed to write disk cache file: " << fd.status();
+    internal_os::DeleteFile(temp_path).IgnoreError();
+    Erase(key);
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  // Renaming while holding the lock ensures the index is consistent with the
+  // files in the directory.
+  if (auto status = internal_os::RenameOpenFile(fd->get(), temp_path,
+                                                GetFilePath(file_name));
+      !status.ok()) {
+    internal_os::DeleteFile(temp_path).IgnoreError();
+    EraseLocked(file_name);
+    return;
+  }
+  auto [it, inserted] = index_.try_emplace(file_name);
+  if (inserted) {
+    lru_.push_back(file_name);
+    it->second.lru_position = std::prev(lru_.end());
+  } else {
+    total_bytes_ -= it->second.size;
+    lru_.splice(lru_.end(), lru_, it->second.lru_position);
+  }
+  it->second.size = size;
+  it->second.generation = generation;
+  it->second.time = time;
+  total_bytes_ += size;
+  EvictLocked();
+}
+
+void DiskCache::MarkValidated(std::string_view key,
+                              const StorageGeneration& generation,
+                              absl::Time time) {
+  const std::string file_name = GetFileName(key);
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(file_name);
+  if (it == index_.end() || it->second.generation != generation) return;
+  it->second.time = std::max(it->second.time, time);
+}
+
+void DiskCache::Erase(std::string_view key) {
+  const std::string file_name = GetFileName(key);
+  absl::MutexLock lock(&mutex_);
+  EraseLocked(file_name);
+}
+
+size_t DiskCache::total_bytes() {
+  absl::MutexLock lock(&mutex_);
+  return total_bytes_;
+}
+
+void DiskCache::EraseLocked(std::string_view file_name) {
+  auto it = index_.find(file_name);
+  if (it == index_.end()) return;
+  internal_os::DeleteFile(GetFilePath(file_name)).IgnoreError();
+  total_bytes_ -= it->second.size;
+  lru_.erase(it->second.lru_position);
+  index_.erase(it);
+}
+
+void DiskCache::EvictLocked() {
+  while (total_bytes_ > options_.total_bytes_limit && !lru_.empty()) {
+    EraseLocked(std::string(lru_.front()));
+  }
+}
+
+namespace {
+
+class DiskCacheKvStore;
+
+/// Forwards to the `ReadModifyWriteSource` of a read-modify-write operation
+/// on the base kvstore, and erases the cache entry once it is committed.
+class InvalidatingReadModifyWriteSource
+    : public kvstore::ReadModifyWriteSource {
+ public:
+  InvalidatingReadModifyWriteSource(
+      internal::IntrusivePtr<DiskCacheKvStore> driver, std::string cache_key,
+      kvstore::ReadModifyWriteSource& source)
+      : driver_(std::move(driver)),
+        cache_key_(std::move(cache_key)),
+        source_(source) {}
+
+  void KvsSetTarget(kvstore::ReadModifyWriteTarget& target) override {
+    source_.KvsSetTarget(target);
+  }
+  void KvsInvalidateReadState() override { source_.KvsInvalidateReadState(); }
+  void KvsWriteback(WritebackOptions options,
+                    WritebackReceiver receiver) override {
+    source_.KvsWriteback(std::move(options), std::move(receiver));
+  }
+  void KvsWritebackSuccess(TimestampedStorageGeneration new_stamp) override;
+  void KvsWritebackError() override;
+  void KvsRevoke() override { source_.KvsRevoke(); }
+  void* IsSpecialSource() override { return source_.IsSpecialSource(); }
+
+ private:
+  internal::IntrusivePtr<DiskCacheKvStore> driver_;
+  std::string cache_key_;
+  kvstore::ReadModifyWriteSource& source_;
+};
+
+class DiskCacheKvStore final : public kvstore::Driver {
+ public:
+  explicit DiskCacheKvStore(kvstore::DriverPtr base,
+                            std::shared_ptr<DiskCache> cache,
+                            std::string cache_key_prefix)
+      : base_(std::move(base)),
+        cache_(std::move(cache)),
+        cache_key_prefix_(std::move(cache_key_prefix)) {}
+
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override {
+    std::string cache_key = GetCacheKey(key);
+    auto future =
+        base_->Write(std::move(key), std::move(value), std::move(options));
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+         cache_key = std::move(cache_key)](
+            ReadyFuture<TimestampedStorageGeneration>) {
+          self->Invalidate(cache_key);
+        });
+    return future;
+  }
+
+  absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
+                               size_t& phase, Key key,
+                               ReadModifyWriteSource& source) override {
+    auto* wrapper = new InvalidatingReadModifyWriteSource(
+        internal::IntrusivePtr<DiskCacheKvStore>(this), GetCacheKey(key),
+        source);
+    auto status =
+        base_->ReadModifyWrite(transaction, phase, std::move(key), *wrapper);
+    if (!status.ok()) delete wrapper;
+    return status;
+  }
+
+  absl::Status TransactionalDeleteRange(
+      const internal::OpenTransactionPtr& transaction,
+      KeyRange range) override {
+    // The commit of the transaction is not observable here, so all entries
+    // must be revalidated from now on.
+    invalidated_before_.store(std::numeric_limits<int64_t>::max());
+    return base_->TransactionalDeleteRange(transaction, std::move(range));
+  }
+
+  Future<const void> DeleteRange(KeyRange range) override {
+    auto future = base_->DeleteRange(std::move(range));
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<DiskCacheKvStore>(this)](
+            ReadyFuture<const void>) {
+          self->write_epoch_.fetch_add(1);
+          const int64_t now = absl::ToUnixNanos(absl::Now());
+          int64_t before = self->invalidated_before_.load();
+          while (before < now &&
+                 !self->invalidated_before_.compare_exchange_weak(before,
+                                                                  now)) {
+          }
+        });
+    return future;
+  }
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    return base_->ListImpl(std::move(options), std::move(receiver));
+  }
+  std::string DescribeKey(std::string_view key) override {
+    return base_->DescribeKey(key);
+  }
+  Result<kvstore::DriverSpecPtr> GetBoundSpec() const override {
+    return base_->GetBoundSpec();
+  }
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    return base_->GetSupportedFeatures(key_range);
+  }
+  void GarbageCollectionVisit(
+      garbage_collection::GarbageCollectionVisitor& visitor) const override {
+    return base_->GarbageCollectionVisit(visitor);
+  }
+
+  /// Returns the key of the cache entry for `key`.
+  std::string GetCacheKey(std::string_view key) const {
+    return absl::StrCat(cache_key_prefix_, key);
+  }
+
+  /// Erases the entry for `cache_key` after a write has completed.
+  void Invalidate(const std::string& cache_key) {
+    write_epoch_.fetch_add(1);
+    cache_->Erase(cache_key);
+  }
+
+  /// Stores a value read from `base_`, unless a write through this adapter
+  /// completed since the read was issued.
+  void MaybeWriteToCache(const std::string& cache_key, const absl::Cord& value,
+                         const TimestampedStorageGeneration& stamp,
+                         uint64_t write_epoch) {
+    if (write_epoch_.load() != write_epoch) return;
+    cache_->Write(cache_key, value, stamp.generation, stamp.time);
+    // A write that completed concurrently may have invalidated the entry
+    // before it was stored.
+    if (write_epoch_.load() != write_epoch) cache_->Erase(cache_key);
+  }
+
+ private:
+  /// Completes a read of `cache_key` using the result of a read from `base_`.
+  void HandleBaseReadResult(Promise<ReadResult> promise, std::string cache_key,
+                            OptionalByteRangeRequest byte_range,
+                            uint64_t write_epoch,
+                            std::optional<DiskCache::Entry> entry,
+                            const StorageGeneration& if_not_equal,
+                            ReadyFuture<ReadResult> future);
+
+  kvstore::DriverPtr base_;
+  std::shared_ptr<DiskCache> cache_;
+
+  /// Result of `GetDiskCacheKeyPrefix(*base_)`.
+  std::string cache_key_prefix_;
+
+  /// Incremented whenever a write through this adapter completes, such that
+  /// values read from `base_` concurrently with a write are not cached.
+  std::atomic<uint64_t> write_epoch_{0};
+
+  /// Entries validated before this time, in nanoseconds since the Unix
+  /// epoch, must be revalidated.
+  std::atomic<int64_t> invalidated_before_{
+      std::numeric_limits<int64_t>::min()};
+};
+
+void InvalidatingReadModifyWriteSource::KvsWritebackSuccess(
+    TimestampedStorageGeneration new_stamp) {
+  driver_->Invalidate(cache_key_);
+  source_.KvsWritebackSuccess(std::move(new_stamp));
+  delete this;
+}
+
+void InvalidatingReadModifyWriteSource::KvsWritebackError() {
+  source_.KvsWritebackError();
+  delete this;
+}
+
+/// Returns the result of a read with the specified conditions and byte range
+/// from a cached entry.
+Result<kvstore::ReadResult> ReadFromEntry(
+    const DiskCache::Entry& entry, const StorageGeneration& if_not_equal,
+    OptionalByteRangeRequest byte_range, TimestampedStorageGeneration stamp) {
+  if (entry.generation == if_not_equal) {
+    return kvstore::ReadResult::Unspecified(std::move(stamp));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto range,
+                               byte_range.Validate(entry.value.size()));
+  return kvstore::ReadResult::Value(
+      internal::GetSubCord(entry.value, range), std::move(stamp));
+}
+
+Future<kvstore::ReadResult> DiskCacheKvStore::Read(Key key,
+                                                   ReadOptions options) {
+  if (!StorageGeneration::IsUnknown(
+          options.generation_conditions.if_equal)) {
+    return base_->Read(std::move(key), std::move(options));
+  }
+  if (options.staleness_bound == absl::InfiniteFuture()) {
+    options.staleness_bound = absl::Now();
+  }
+  auto [promise, future] = PromiseFuturePair<ReadResult>::Make();
+  cache_->executor()([self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+                      promise = std::move(promise), key = std::move(key),
+                      options = std::move(options)]() mutable {
+    if (!promise.result_needed()) return;
+    std::string cache_key = self->GetCacheKey(key);
+    const uint64_t write_epoch = self->write_epoch_.load();
+    auto entry = self->cache_->Read(cache_key);
+    const StorageGeneration if_not_equal =
+        options.generation_conditions.if_not_equal;
+    if (entry) {
+      if (entry->time >= options.staleness_bound &&
+          absl::ToUnixNanos(entry->time) >=
+              self->invalidated_before_.load()) {
+        ABSL_LOG_IF(INFO, disk_cache_logging)
+            << "Read from disk cache: " << self->base_->DescribeKey(key);
+        promise.SetResult(ReadFromEntry(*entry, if_not_equal,
+                                        options.byte_range,
+                                        {entry->generation, entry->time}));
+        return;
+      }
+      // Revalidate the cached entry, without transferring the value if it is
+      // unchanged.
+      if (StorageGeneration::IsUnknown(if_not_equal)) {
+        options.generation_conditions.if_not_equal = entry->generation;
+      }
+    }
+    const auto byte_range = options.byte_range;
+    auto read_future = self->base_->Read(std::move(key), std::move(options));
+    read_future.ExecuteWhenReady(
+        [self = std::move(self), promise = std::move(promise),
+         cache_key = std::move(cache_key), byte_range, write_epoch,
+         entry = std::move(entry),
+         if_not_equal](ReadyFuture<ReadResult> read_future) mutable {
+          self->HandleBaseReadResult(std::move(promise), std::move(cache_key),
+                                     byte_range, write_epoch,
+                                     std::move(entry), if_not_equal,
+                                     std::move(read_future));
+        });
+  });
+  return std::move(future);
+}
+
+void DiskCacheKvStore::HandleBaseReadResult(
+    Promise<ReadResult> promise, std::string cache_key,
+    OptionalByteRangeRequest byte_range, uint64_t write_epoch,
+    std::optional<DiskCache::Entry> entry,
+    const StorageGeneration& if_not_equal, ReadyFuture<ReadResult> future) {
+  auto& r = future.result();
+  if (!r.ok()) {
+    promise.SetResult(r.status());
+    return;
+  }
+  if (entry && r->stamp.generation == entry->generation) {
+    // Revalidated.
+    cache_->executor()([cache = cache_, cache_key = std::move(cache_key),
+                        stamp = r->stamp] {
+      cache->MarkValidated(cache_key, stamp.generation, stamp.time);
+    });
+    promise.SetResult(
+        ReadFromEntry(*entry, if_not_equal, byte_range, r->stamp));
+    return;
+  }
+  if (r->has_value() && byte_range.IsFull() &&
+      StorageGeneration::IsClean(r->stamp.generation)) {
+    cache_->executor()([self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+                        cache_key = std::move(cache_key), value = r->value,
+                        stamp = r->stamp, write_epoch] {
+      self->MaybeWriteToCache(cache_key, value, stamp, write_epoch);
+    });
+  } else if (entry && r->state != kvstore::ReadResult::kUnspecified) {
+    cache_->executor()([cache = cache_, cache_key = std::move(cache_key)] {
+      cache->Erase(cache_key);
+    });
+  }
+  promise.SetResult(std::move(r));
+}
+
+}  // namespace
+
+std::optional<std::string> GetDiskCacheKeyPrefix(const kvstore::Driver& base) {
+  auto spec = base.GetBoundSpec();
+  if (!spec.ok()) return std::nullopt;
+  // Bound context resources encode their address, which does not identify
+  // the kvstore across processes.
+  spec->StripContext();
+  std::string prefix;
+  internal::EncodeCacheKey(&prefix, *spec);
+  return prefix;
+}
+
+kvstore::DriverPtr MakeDiskCacheKvStore(kvstore::DriverPtr base,
+                                        std::shared_ptr<DiskCache> cache) {
+  auto cache_key_prefix = GetDiskCacheKeyPrefix(*base);
+  if (!cache_key_prefix) return base;
+  return kvstore::DriverPtr(new DiskCacheKvStore(
+      std::move(base), std::move(cache), *std::move(cache_key_prefix)));
+}
+
+}  // namespace internal
+}  // namespace tensorstore
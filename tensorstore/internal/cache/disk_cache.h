@@ -0,0 +1,185 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_H_
+#define TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_H_
+
+/// \file
+///
+/// Secondary cache tier that stores encoded values in files within a local
+/// directory, with its own limit on the total size of the stored values.
+///
+/// The in-memory `CachePool` holds decoded chunks; once they are evicted,
+/// reading them again normally requires a round trip to the underlying
+/// kvstore, which may have high latency (e.g. GCS or S3).  The kvstore
+/// adapter returned by `MakeDiskCacheKvStore` writes the encoded values it
+/// reads from the base kvstore through to a `DiskCache`, and serves
+/// subsequent reads from the local files.  Entries are stored along with their
+/// `StorageGeneration`, such that they can be revalidated against the base
+/// kvstore with a conditional read that does not transfer the value.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Least-recently-used cache of encoded values stored as individual files
+/// within a local directory.
+///
+/// Each entry is stored in a file named by a hash of the key, which also
+/// stores the full key, the `StorageGeneration`, and a checksum of the value.
+/// Files that fail to parse or verify are treated as missing and deleted.
+///
+/// An in-memory index of the files, in least-recently-used order, is built
+/// when the cache is opened; the files of previous processes are ordered by
+/// their modification time, and are considered to have last been validated
+/// at `absl::InfinitePast()`.
+///
+/// All member functions are thread safe.  The functions that access files
+/// block, and should be called from `executor()`.
+class DiskCache {
+ public:
+  struct Options {
+    /// Directory containing the cache files; created if it does not exist.
+    std::string path;
+
+    /// Limit on the total size of the stored values.  Once exceeded, the
+    /// least-recently-used entries are deleted.
+    size_t total_bytes_limit = 0;
+  };
+
+  /// Entry returned by `Read`.
+  struct Entry {
+    absl::Cord value;
+    StorageGeneration generation;
+
+    /// Time at which `generation` was known to be current.
+    absl::Time time;
+  };
+
+  /// Opens the cache in `options.path`, deleting any incomplete files left by
+  /// previous processes.
+  static Result<std::shared_ptr<DiskCache>> Open(Options options);
+
+  /// Returns the entry for `key`, or `std::nullopt` if not present.
+  std::optional<Entry> Read(std::string_view key);
+
+  /// Stores `value` as the entry for `key`, replacing any existing entry.
+  ///
+  /// Errors are not reported, since failing to write the cache only affects
+  /// performance; the entry is simply left missing.
+  void Write(std::string_view key, const absl::Cord& value,
+             const StorageGeneration& generation, absl::Time time);
+
+  /// Records that the entry for `key` with the specified `generation` was
+  /// known to be current at `time`.  Has no effect if the stored generation
+  /// differs.
+  void MarkValidated(std::string_view key, const StorageGeneration& generation,
+                     absl::Time time);
+
+  /// Deletes the entry for `key`, if present.
+  void Erase(std::string_view key);
+
+  /// Returns the total size of the stored values.
+  size_t total_bytes();
+
+  const Options& options() const { return options_; }
+
+  /// Executor used by `MakeDiskCacheKvStore` to access the cache files.
+  const Executor& executor() const { return executor_; }
+
+  explicit DiskCache(Options options);
+
+ private:
+  struct IndexEntry {
+    size_t size;
+    StorageGeneration generation;
+    absl::Time time;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  std::string GetFilePath(std::string_view file_name) const;
+  void EraseLocked(std::string_view file_name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void EvictLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  absl::Status LoadIndex();
+
+  Options options_;
+  Executor executor_;
+  absl::Mutex mutex_;
+
+  /// Maps file names to entries.
+  absl::flat_hash_map<std::string, IndexEntry> index_ ABSL_GUARDED_BY(mutex_);
+
+  /// File names, from least to most recently used.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mutex_);
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  /// Sequence number used to generate unique temporary file names.
+  uint64_t next_temp_id_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+/// Returns the encoded spec of `base`, with context resources stripped, that
+/// prefixes the keys of its entries in a `DiskCache`.
+///
+/// Returns `std::nullopt` if `base` does not support a JSON representation.
+/// Since context resources are not included, kvstores whose identity is
+/// determined by a context resource, such as the "memory" kvstore, are not
+/// distinguished.
+std::optional<std::string> GetDiskCacheKeyPrefix(const kvstore::Driver& base);
+
+/// Returns a kvstore adapter that serves reads of entire values from `cache`,
+/// falling back to `base`.
+///
+/// Cached entries that are older than the `staleness_bound` of a read are
+/// revalidated with a read of `base` conditioned on the cached generation.
+/// Values read from `base` are written to `cache`; writes and deletions
+/// through the adapter erase the affected entries.  Reads conditioned on
+/// `if_equal` are forwarded to `base`.
+///
+/// Only reads of entire values populate `cache`.  A byte range read is served
+/// from an existing entry, but on a miss is forwarded to `base` without
+/// caching the partial value, since reading the entire value instead could
+/// transfer far more data than requested.  Consequently, values that are only
+/// ever read in parts, such as sharded ``zarr3`` and
+/// ``neuroglancer_precomputed`` shards, are not cached.
+///
+/// Cache entries are keyed by `GetDiskCacheKeyPrefix(*base)` followed by the
+/// key, such that a single `DiskCache` may be shared by adapters of different
+/// base kvstores.  If `base` does not support a JSON representation, it is
+/// returned unchanged.
+kvstore::DriverPtr MakeDiskCacheKvStore(kvstore::DriverPtr base,
+                                        std::shared_ptr<DiskCache> cache);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_H_
@@ -0,0 +1,46 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/disk_cache_resource.h"
+
+#include "absl/status/status.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache/disk_cache.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal {
+
+Result<DiskCacheResource::Resource> DiskCacheResource::Create(
+    Spec v, internal::ContextResourceCreationContext context) {
+  Resource resource{v, nullptr};
+  if (!v.path.empty()) {
+    if (v.total_bytes_limit == 0) {
+      return absl::InvalidArgumentError(
+          "\"total_bytes_limit\" must be positive when \"path\" is specified");
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        resource.cache, DiskCache::Open({v.path, v.total_bytes_limit}));
+  }
+  return resource;
+}
+
+namespace {
+
+const ContextResourceRegistration<DiskCacheResource> registration;
+
+}  // namespace
+}  // namespace internal
+}  // namespace tensorstore
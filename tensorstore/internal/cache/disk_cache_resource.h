@@ -0,0 +1,85 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_RESOURCE_H_
+#define TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_RESOURCE_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache/disk_cache.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Context resource corresponding to a `DiskCache`, which is used as a
+/// secondary cache tier for the chunks of kvstore-backed drivers.
+struct DiskCacheResource
+    : public internal::ContextResourceTraits<DiskCacheResource> {
+  static constexpr char id[] = "disk_cache";
+
+  struct Spec {
+    /// Directory of the cache, or empty to disable the cache.
+    std::string path;
+
+    /// Limit on the total size of the cache files.
+    size_t total_bytes_limit = 0;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.path, x.total_bytes_limit);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+
+    /// Cache shared by all users of the resource, or `nullptr` if not
+    /// enabled.
+    std::shared_ptr<DiskCache> cache;
+  };
+
+  static Spec Default() { return Spec{}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = internal_json_binding;
+    return jb::Object(
+        jb::Member(
+            "path",
+            jb::Projection<&Spec::path>(
+                jb::DefaultInitializedValue<jb::kNeverIncludeDefaults>())),
+        jb::Member("total_bytes_limit",
+                   jb::Projection<&Spec::total_bytes_limit>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* v) { *v = 0; }))));
+  }
+
+  static Result<Resource> Create(
+      Spec v, internal::ContextResourceCreationContext context);
+
+  static Spec GetSpec(const Resource& v,
+                      const internal::ContextSpecBuilder& builder) {
+    return v.spec;
+  }
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_DISK_CACHE_RESOURCE_H_
@@ -0,0 +1,64 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/disk_cache_resource.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::DiskCacheResource;
+using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
+
+TEST(DiskCacheResourceTest, Default) {
+  auto resource_spec = Context::Resource<DiskCacheResource>::DefaultSpec();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, Context::Default().GetResource(resource_spec));
+  EXPECT_EQ(nullptr, resource->cache);
+}
+
+TEST(DiskCacheResourceTest, PathAndLimit) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DiskCacheResource>::FromJson(
+          {{"path", tempdir.path()}, {"total_bytes_limit", 1000}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, Context::Default().GetResource(resource_spec));
+  ASSERT_NE(nullptr, resource->cache);
+  EXPECT_EQ(1000, resource->cache->options().total_bytes_limit);
+  EXPECT_THAT(resource_spec.ToJson(),
+              ::testing::Optional(::nlohmann::json(
+                  {{"path", tempdir.path()}, {"total_bytes_limit", 1000}})));
+}
+
+TEST(DiskCacheResourceTest, PathWithoutLimit) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<DiskCacheResource>::FromJson(
+                              {{"path", tempdir.path()}}));
+  EXPECT_THAT(Context::Default().GetResource(resource_spec),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*total_bytes_limit.*"));
+}
+
+}  // namespace
@@ -0,0 +1,157 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/disk_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::DiskCache;
+using ::tensorstore::internal::MakeDiskCacheKvStore;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
+
+TEST(DiskCacheTest, WriteReadErase) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cache,
+                                   DiskCache::Open({tempdir.path(), 1000}));
+  EXPECT_EQ(std::nullopt, cache->Read("a"));
+  const absl::Time time = absl::Now();
+  cache->Write("a", absl::Cord("abc"), StorageGeneration::FromString("1"),
+               time);
+  auto entry = cache->Read("a");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("abc", entry->value);
+  EXPECT_EQ(StorageGeneration::FromString("1"), entry->generation);
+  EXPECT_EQ(time, entry->time);
+
+  cache->MarkValidated("a", StorageGeneration::FromString("2"),
+                       time + absl::Seconds(1));
+  EXPECT_EQ(time, cache->Read("a")->time);
+  cache->MarkValidated("a", StorageGeneration::FromString("1"),
+                       time + absl::Seconds(1));
+  EXPECT_EQ(time + absl::Seconds(1), cache->Read("a")->time);
+
+  cache->Erase("a");
+  EXPECT_EQ(std::nullopt, cache->Read("a"));
+  EXPECT_EQ(0, cache->total_bytes());
+}
+
+TEST(DiskCacheTest, EvictsLeastRecentlyUsed) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cache,
+                                   DiskCache::Open({tempdir.path(), 350}));
+  const std::string value(100, 'x');
+  const auto generation = StorageGeneration::FromString("1");
+  cache->Write("a", absl::Cord(value), generation, absl::Now());
+  cache->Write("b", absl::Cord(value), generation, absl::Now());
+  cache->Write("c", absl::Cord(value), generation, absl::Now());
+  // Mark "a" as recently used.
+  EXPECT_TRUE(cache->Read("a"));
+  cache->Write("d", absl::Cord(value), generation, absl::Now());
+  EXPECT_LE(cache->total_bytes(), 350);
+  EXPECT_TRUE(cache->Read("a"));
+  EXPECT_FALSE(cache->Read("b"));
+  EXPECT_TRUE(cache->Read("d"));
+}
+
+TEST(DiskCacheTest, Reopen) {
+  ScopedTemporaryDirectory tempdir;
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cache,
+                                     DiskCache::Open({tempdir.path(), 1000}));
+    cache->Write("a", absl::Cord("abc"), StorageGeneration::FromString("1"),
+                 absl::Now());
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cache,
+                                   DiskCache::Open({tempdir.path(), 1000}));
+  EXPECT_NE(0, cache->total_bytes());
+  auto entry = cache->Read("a");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("abc", entry->value);
+  EXPECT_EQ(StorageGeneration::FromString("1"), entry->generation);
+  // Entries of a previous process must be revalidated.
+  EXPECT_EQ(absl::InfinitePast(), entry->time);
+}
+
+TEST(DiskCacheKvStoreTest, ServesAndRevalidatesCachedValues) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cache,
+                                   DiskCache::Open({tempdir.path(), 1000}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, tensorstore::kvstore::Open({{"driver", "memory"}}).result());
+  tensorstore::KvStore store(MakeDiskCacheKvStore(base.driver, cache));
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::kvstore::Write(base, "a", absl::Cord("ab")));
+  const absl::Time time = absl::Now();
+  EXPECT_THAT(tensorstore::kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("ab")));
+  // The value is written to the cache asynchronously.
+  auto cache_key_prefix =
+      tensorstore::internal::GetDiskCacheKeyPrefix(*base.driver);
+  ASSERT_TRUE(cache_key_prefix);
+  while (!cache->Read(*cache_key_prefix + "a")) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+
+  // Modify the value without going through the adapter.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::kvstore::Write(base, "a", absl::Cord("cd")));
+
+  // Reads that permit cached values are served from the disk cache.
+  {
+    tensorstore::kvstore::ReadOptions options;
+    options.staleness_bound = time;
+    EXPECT_THAT(tensorstore::kvstore::Read(store, "a", options).result(),
+                MatchesKvsReadResult(absl::Cord("ab")));
+    options.byte_range = OptionalByteRangeRequest::Suffix(1);
+    EXPECT_THAT(tensorstore::kvstore::Read(store, "a", options).result(),
+                MatchesKvsReadResult(absl::Cord("b")));
+  }
+
+  // Other reads are revalidated.
+  EXPECT_THAT(tensorstore::kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("cd")));
+
+  // Deletes through the adapter are not served from the disk cache.
+  TENSORSTORE_ASSERT_OK(tensorstore::kvstore::Delete(store, "a"));
+  {
+    tensorstore::kvstore::ReadOptions options;
+    options.staleness_bound = time;
+    EXPECT_THAT(tensorstore::kvstore::Read(store, "a", options).result(),
+                MatchesKvsReadResultNotFound());
+  }
+}
+
+}  // namespace
@@ -65,7 +65,7 @@ Result<size_t> EncodeWithCallback(
   const int n = blosc_compress_ctx(
       options.clevel, shuffle, options.element_size, input.size(), input.data(),
       output_buffer, output_buffer_size, options.compressor, options.blocksize,
-      /*numinternalthreads=*/1);
+      /*numinternalthreads=*/options.nthreads);
   if (n < 0) {
     return absl::InternalError(
         tensorstore::StrCat("Internal blosc error: ", n));
@@ -73,25 +73,28 @@ Result<size_t> EncodeWithCallback(
   return n;
 }
 
-Result<std::string> Decode(std::string_view input) {
+Result<std::string> Decode(std::string_view input, int nthreads) {
   std::string output;
-  auto result = DecodeWithCallback(input, [&](size_t n) {
-    output.resize(n);
-    return output.data();
-  });
+  auto result = DecodeWithCallback(
+      input,
+      [&](size_t n) {
+        output.resize(n);
+        return output.data();
+      },
+      nthreads);
   if (!result.ok()) return result.status();
   return output;
 }
 
 Result<size_t> DecodeWithCallback(
-    std::string_view input,
-    absl::FunctionRef<char*(size_t)> get_output_buffer) {
+    std::string_view input, absl::FunctionRef<char*(size_t)> get_output_buffer,
+    int nthreads) {
   TENSORSTORE_ASSIGN_OR_RETURN(size_t nbytes, GetDecodedSize(input));
   char* output_buffer = get_output_buffer(nbytes);
   if (!output_buffer) return 0;
   if (nbytes > 0) {
     const int n = blosc_decompress_ctx(input.data(), output_buffer, nbytes,
-                                       /*numinternalthreads=*/1);
+                                       /*numinternalthreads=*/nthreads);
     if (n <= 0) {
       return absl::InvalidArgumentError(
           tensorstore::StrCat("Blosc error: ", n));
@@ -108,6 +111,40 @@ Result<size_t> GetDecodedSize(std::string_view input) {
   return nbytes;
 }
 
+Result<std::string> DecodeRange(std::string_view input, size_t offset,
+                                size_t length) {
+  TENSORSTORE_ASSIGN_OR_RETURN(size_t nbytes, GetDecodedSize(input));
+  if (offset > nbytes || length > nbytes - offset) {
+    return absl::OutOfRangeError(tensorstore::StrCat(
+        "Requested byte range [", offset, ", ", offset + length,
+        ") is not contained in decoded size of ", nbytes));
+  }
+  std::string output;
+  if (length == 0) return output;
+  size_t typesize;
+  int flags;
+  blosc_cbuffer_metainfo(input.data(), &typesize, &flags);
+  if (typesize == 0 || nbytes % typesize != 0) {
+    // `blosc_getitem` cannot access trailing bytes that do not form a complete
+    // item.
+    TENSORSTORE_ASSIGN_OR_RETURN(output, Decode(input));
+    return output.substr(offset, length);
+  }
+  // `blosc_getitem` operates on whole items of `typesize` bytes.
+  const size_t start_item = offset / typesize;
+  const size_t end_item = (offset + length + typesize - 1) / typesize;
+  output.resize((end_item - start_item) * typesize);
+  const int n = blosc_getitem(input.data(), static_cast<int>(start_item),
+                              static_cast<int>(end_item - start_item),
+                              output.data());
+  if (n < 0) {
+    return absl::InvalidArgumentError(tensorstore::StrCat("Blosc error: ", n));
+  }
+  output.erase(0, offset - start_item * typesize);
+  output.resize(length);
+  return output;
+}
+
 BloscWriter::BloscWriter(const blosc::Options& options,
                          riegeli::Writer& base_writer)
     : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
@@ -140,8 +177,8 @@ void BloscWriter::Done() {
   }
 }
 
-BloscReader::BloscReader(riegeli::Reader& base_reader)
-    : base_reader_(base_reader) {
+BloscReader::BloscReader(riegeli::Reader& base_reader, int nthreads)
+    : base_reader_(base_reader), nthreads_(nthreads) {
   if (auto status = riegeli::ReadAll(base_reader_, encoded_data_);
       !status.ok()) {
     Fail(std::move(status));
@@ -162,14 +199,17 @@ bool BloscReader::PullSlow(size_t min_length, size_t recommended_length) {
     // for this method implies that `min_length` would exceed EOF.
     return false;
   }
-  auto result = blosc::DecodeWithCallback(encoded_data_, [&](size_t n) {
-    assert(n == decoded_size_);
-    auto* buffer = new char[n];
-    buffer_.reset(buffer);
-    set_buffer(buffer, n);
-    move_limit_pos(n);
-    return buffer;
-  });
+  auto result = blosc::DecodeWithCallback(
+      encoded_data_,
+      [&](size_t n) {
+        assert(n == decoded_size_);
+        auto* buffer = new char[n];
+        buffer_.reset(buffer);
+        set_buffer(buffer, n);
+        move_limit_pos(n);
+        return buffer;
+      },
+      nthreads_);
   if (!result.ok()) {
     Fail(std::move(result).status());
     return false;
@@ -183,8 +223,8 @@ bool BloscReader::ReadSlow(size_t length, char* dest) {
     // Use default implementation which may call `PullSlow`.
     return Reader::ReadSlow(length, dest);
   }
-  if (auto result = blosc::DecodeWithCallback(encoded_data_,
-                                              [&](size_t n) { return dest; });
+  if (auto result = blosc::DecodeWithCallback(
+          encoded_data_, [&](size_t n) { return dest; }, nthreads_);
       !result.ok()) {
     Fail(std::move(result).status());
     return false;
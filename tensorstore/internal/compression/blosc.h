@@ -65,6 +65,11 @@ struct Options {
   /// Specifies that `input` is a sequence of elements of `element_size` bytes.
   /// This only affects shuffling.
   size_t element_size;
+
+  /// Number of threads used to compress the blocks of `input` in parallel,
+  /// must be in the range `[1, BLOSC_MAX_THREADS]`.  The threads are in
+  /// addition to the calling thread, which waits for them to finish.
+  int nthreads = 1;
 };
 
 /// Compresses `input`.
@@ -87,19 +92,36 @@ Result<size_t> EncodeWithCallback(
 /// Decompresses `input`.
 ///
 /// \param input The input data to decompress.
+/// \param nthreads Number of threads used to decompress the blocks of `input`
+///     in parallel.
 /// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
-Result<std::string> Decode(std::string_view input);
+Result<std::string> Decode(std::string_view input, int nthreads = 1);
 
 // Same as above, but calls `get_output_buffer` to obtain the output buffer, and
 // returns the size of the decoded data. If `get_output_buffer` returns
 // `nullptr`, then decoding is skipped and `0` is returned. On success, the
 // decoded size is always equal to the size passed to `get_output_buffer`.
 Result<size_t> DecodeWithCallback(
-    std::string_view input, absl::FunctionRef<char*(size_t)> get_output_buffer);
+    std::string_view input, absl::FunctionRef<char*(size_t)> get_output_buffer,
+    int nthreads = 1);
 
 // Returns the decoded size of the input.
 Result<size_t> GetDecodedSize(std::string_view input);
 
+/// Decompresses the bytes `[offset, offset + length)` of the decoded
+/// representation of `input`.
+///
+/// Only the blosc blocks that overlap the requested range are decompressed.
+///
+/// \param input The input data to decompress.
+/// \param offset Starting offset within the decoded representation.
+/// \param length Number of decoded bytes to return.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+/// \error `absl::StatusCode::kOutOfRange` if the range exceeds the decoded
+///     size.
+Result<std::string> DecodeRange(std::string_view input, size_t offset,
+                                size_t length);
+
 // Writes blosc-encoded data to an underlying writer.
 //
 // Because the c-blosc library does not support streaming, this buffers the
@@ -126,7 +148,8 @@ class BloscWriter : public riegeli::CordWriter<absl::Cord> {
 // entire encoded value.
 class BloscReader : public riegeli::Reader {
  public:
-  explicit BloscReader(riegeli::Reader& base_reader);
+  // Decodes using `nthreads` threads, see `Decode`.
+  explicit BloscReader(riegeli::Reader& base_reader, int nthreads = 1);
   BloscReader(BloscReader&&) = delete;
   bool ToleratesReadingAhead() override;
   bool SupportsSize() override;
@@ -142,6 +165,7 @@ class BloscReader : public riegeli::Reader {
   riegeli::Reader& base_reader_;
   absl::string_view encoded_data_;
   size_t decoded_size_;
+  int nthreads_;
   std::unique_ptr<char[]> buffer_;
 };
 
@@ -88,6 +88,54 @@ TEST(BloscTest, EncodeDecode) {
   }
 }
 
+// Tests encoding and decoding with multiple threads.  The order of the
+// compressed blocks may differ from the single-threaded encoding, but the
+// encoded representations must be interchangeable.
+TEST(BloscTest, EncodeDecodeMultithreaded) {
+  std::string array(1000000, '\0');
+  for (size_t i = 0; i < array.size(); ++i) {
+    array[i] = static_cast<char>((i * 7) % 251);
+  }
+  blosc::Options options{/*.compressor==*/"lz4", /*.clevel=*/5,
+                         /*.shuffle=*/-1, /*.blocksize=*/4096,
+                         /*.element_size=*/2};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto single_encoded,
+                                   blosc::Encode(array, options));
+  options.nthreads = 4;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   blosc::Encode(array, options));
+  EXPECT_THAT(blosc::Decode(encoded), ::testing::Optional(array));
+  EXPECT_THAT(blosc::Decode(encoded, /*nthreads=*/4),
+              ::testing::Optional(array));
+  EXPECT_THAT(blosc::Decode(single_encoded, /*nthreads=*/4),
+              ::testing::Optional(array));
+}
+
+// Tests decoding sub-ranges of the decoded representation.
+TEST(BloscTest, DecodeRange) {
+  for (blosc::Options options : GetTestOptions()) {
+    for (const auto& array : GetTestArrays()) {
+      for (const size_t element_size : {1, 2, 10}) {
+        options.element_size = element_size;
+        TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                         blosc::Encode(array, options));
+        for (size_t offset = 0; offset <= array.size(); offset += 3) {
+          for (size_t length : {size_t(0), size_t(1), size_t(7),
+                                array.size() - offset}) {
+            if (length > array.size() - offset) continue;
+            TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+                auto decoded, blosc::DecodeRange(encoded, offset, length));
+            EXPECT_EQ(array.substr(offset, length), decoded)
+                << "offset=" << offset << ", length=" << length;
+          }
+        }
+        EXPECT_THAT(blosc::DecodeRange(encoded, array.size(), 1),
+                    MatchesStatus(absl::StatusCode::kOutOfRange));
+      }
+    }
+  }
+}
+
 // Tests that the compressed data has the expected blosc complib.
 TEST(BloscTest, CheckComplib) {
   const std::string_view array =
@@ -16,16 +16,65 @@
 
 #include <stddef.h>
 
+#include <limits>
 #include <memory>
+#include <string_view>
 #include <utility>
 
+#include "absl/status/status.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/writer.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/util/str_cat.h"
+#include <zstd.h>
 
 namespace tensorstore {
 namespace internal {
 
+namespace {
+struct ZstdCCtxDeleter {
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+}  // namespace
+
+ZstdParallelWriter::ZstdParallelWriter(const Options& options,
+                                       riegeli::Writer& base_writer)
+    : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+          std::numeric_limits<size_t>::max())),
+      options_(options),
+      base_writer_(base_writer) {}
+
+void ZstdParallelWriter::Done() {
+  CordWriter::Done();
+  if (!ok()) return;
+  std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter> ctx(ZSTD_createCCtx());
+  if (!ctx) {
+    Fail(absl::ResourceExhaustedError("Failed to create zstd context"));
+    return;
+  }
+  ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_compressionLevel, options_.level);
+  ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_checksumFlag,
+                         options_.store_checksum ? 1 : 0);
+  // This fails if the zstd library was built without multithreading support,
+  // in which case the data is compressed by this thread.
+  ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_nbWorkers, options_.nb_workers);
+  const std::string_view input = dest().Flatten();
+  if (!base_writer_.Push(ZSTD_compressBound(input.size()))) {
+    Fail(base_writer_.status());
+    return;
+  }
+  const size_t n =
+      ZSTD_compress2(ctx.get(), base_writer_.cursor(), base_writer_.available(),
+                     input.data(), input.size());
+  if (ZSTD_isError(n)) {
+    Fail(absl::InternalError(
+        tensorstore::StrCat("Zstd error: ", ZSTD_getErrorName(n))));
+    return;
+  }
+  base_writer_.move_cursor(n);
+}
+
 std::unique_ptr<riegeli::Writer> ZstdCompressor::GetWriter(
     riegeli::Writer& base_writer, size_t element_bytes) const {
   using Writer = riegeli::ZstdWriter<riegeli::Writer*>;
@@ -21,6 +21,8 @@
 
 #include <memory>
 
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/internal/compression/json_specified_compressor.h"
@@ -32,6 +34,33 @@ struct ZstdOptions {
   int level = 0;
 };
 
+// Writes zstd-compressed data to an underlying writer, using worker threads to
+// compress the data in parallel.
+//
+// The zstd library divides the input into jobs that are compressed by the
+// workers, which requires that the entire decoded value is available.
+// Therefore, like `blosc::BloscWriter`, this buffers the entire decoded value.
+//
+// If the zstd library was built without multithreading support, the data is
+// compressed by the thread that closes this writer.
+class ZstdParallelWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  struct Options {
+    int level = 0;
+    bool store_checksum = false;
+    int nb_workers = 1;
+  };
+
+  explicit ZstdParallelWriter(const Options& options,
+                              riegeli::Writer& base_writer);
+
+  void Done() override;
+
+ private:
+  Options options_;
+  riegeli::Writer& base_writer_;
+};
+
 class ZstdCompressor : public JsonSpecifiedCompressor, public ZstdOptions {
  public:
   std::unique_ptr<riegeli::Writer> GetWriter(
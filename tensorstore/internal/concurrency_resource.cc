@@ -19,11 +19,14 @@
 
 #include <stddef.h>
 
+#include <string_view>
+
 #include "absl/base/call_once.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/concurrency_resource_provider.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/thread/thread_pool.h"
@@ -37,10 +40,22 @@ AnyContextResourceJsonBinder<ConcurrencyResource::Spec>
 ConcurrencyResourceTraits::JsonBinder() {
   namespace jb = tensorstore::internal_json_binding;
   return [](auto is_loading, const auto& options, auto* obj, auto* j) {
-    return jb::Object(jb::Member(
-        "limit", jb::DefaultInitializedValue(jb::Optional(
-                     jb::Integer<size_t>(1), [] { return "shared"; }))))(
-        is_loading, options, obj, j);
+    return jb::Object(
+        jb::Member("limit",
+                   jb::Projection<&Spec::limit>(
+                       jb::DefaultInitializedValue(jb::Optional(
+                           jb::Integer<size_t>(1), [] { return "shared"; })))),
+        jb::Member(
+            "priority",
+            jb::Projection<&Spec::priority>(
+                jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                    [](auto* obj) { *obj = TaskPriority::kNormal; },
+                    jb::Enum<TaskPriority, std::string_view>({
+                        {TaskPriority::kInteractive, "interactive"},
+                        {TaskPriority::kNormal, "normal"},
+                        {TaskPriority::kBackground, "background"},
+                    }))))
+        /**/)(is_loading, options, obj, j);
   };
 }
 
@@ -48,13 +63,13 @@ Result<ConcurrencyResource::Resource> ConcurrencyResourceTraits::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
   Resource value;
   value.spec = spec;
-  if (spec) {
-    value.executor = DetachedThreadPool(*spec);
+  if (spec.limit) {
+    value.executor = DetachedThreadPool(*spec.limit, spec.priority);
   } else {
     absl::call_once(shared_executor_once_, [&] {
-      shared_executor_ = DetachedThreadPool(shared_limit_);
+      shared_executor_ = DetachedThreadPools(shared_limit_);
     });
-    value.executor = shared_executor_;
+    value.executor = shared_executor_[static_cast<size_t>(spec.priority)];
   }
   return value;
 }
@@ -19,6 +19,7 @@
 
 #include <optional>
 
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/util/executor.h"
 
 namespace tensorstore {
@@ -49,10 +50,23 @@ namespace internal {
 ///    constructor.
 ///
 /// 3. Register the `Traits` type using a `ContextResourceRegistration` object.
+///
+/// The resource specification may also specify a `TaskPriority`, such that
+/// latency-critical work (e.g. interactive reads) is assigned threads ahead of
+/// bulk work (e.g. writeback) sharing the process.  Resources with the default
+/// (shared) limit and different priorities use separate shared thread pools
+/// that together respect the shared limit.
 struct ConcurrencyResource {
-  using Spec = std::optional<size_t>;
-  struct Resource {
+  struct Spec {
     // If equal to `nullopt`, indicates that the shared executor is used.
+    std::optional<size_t> limit;
+    TaskPriority priority = TaskPriority::kNormal;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.limit, x.priority);
+    };
+  };
+  struct Resource {
     Spec spec;
     Executor executor;
   };
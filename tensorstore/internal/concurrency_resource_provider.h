@@ -15,6 +15,9 @@
 #ifndef TENSORSTORE_INTERNAL_CONCURRENCY_RESOURCE_PROVIDER_H_
 #define TENSORSTORE_INTERNAL_CONCURRENCY_RESOURCE_PROVIDER_H_
 
+#include <stddef.h>
+
+#include <array>
 #include <optional>
 
 #include "absl/base/call_once.h"
@@ -25,6 +28,7 @@
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/result.h"
 
@@ -40,7 +44,7 @@ class ConcurrencyResourceTraits {
   ConcurrencyResourceTraits(size_t shared_limit)
       : shared_limit_(shared_limit) {}
 
-  static Spec Default() { return std::nullopt; }
+  static Spec Default() { return Spec{}; }
 
   static AnyContextResourceJsonBinder<Spec> JsonBinder();
 
@@ -49,13 +53,15 @@ class ConcurrencyResourceTraits {
   Spec GetSpec(const Resource& value, const ContextSpecBuilder& builder) const;
 
  private:
-  /// Size of thread pool referenced by `shared_executor_`.
+  /// Total number of threads of the thread pools referenced by
+  /// `shared_executor_`.
   size_t shared_limit_;
   /// Protects initialization of `shared_executor_`.
   mutable absl::once_flag shared_executor_once_;
-  /// Lazily-initialization shared thread pool used in the case of a default
-  /// resource specification.
-  mutable Executor shared_executor_;
+  /// Lazily-initialization shared thread pools, indexed by priority, used in
+  /// the case of a default limit.
+  mutable std::array<Executor, internal_thread_impl::kNumTaskPriorities>
+      shared_executor_;
 };
 
 }  // namespace internal
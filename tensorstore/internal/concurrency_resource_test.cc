@@ -0,0 +1,86 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/concurrency_resource.h"
+
+#include <optional>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesJson;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::DataCopyConcurrencyResource;
+using ::tensorstore::internal::TaskPriority;
+
+TEST(ConcurrencyResourceTest, PriorityRoundtrip) {
+  const ::nlohmann::json json{{"limit", 4}, {"priority", "background"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson(json));
+  EXPECT_THAT(resource_spec.ToJson(), IsOkAndHolds(MatchesJson(json)));
+
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto resource,
+                                   context.GetResource(resource_spec));
+  EXPECT_EQ(4, resource->spec.limit);
+  EXPECT_EQ(TaskPriority::kBackground, resource->spec.priority);
+  EXPECT_THAT(resource.ToJson(), IsOkAndHolds(MatchesJson(json)));
+}
+
+TEST(ConcurrencyResourceTest, SharedLimitPriority) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson(
+          {{"limit", "shared"}, {"priority", "interactive"}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto resource,
+                                   context.GetResource(resource_spec));
+  EXPECT_EQ(std::nullopt, resource->spec.limit);
+  EXPECT_EQ(TaskPriority::kInteractive, resource->spec.priority);
+}
+
+TEST(ConcurrencyResourceTest, DefaultPriority) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson(
+          {{"limit", 2}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto resource,
+                                   context.GetResource(resource_spec));
+  EXPECT_EQ(TaskPriority::kNormal, resource->spec.priority);
+  // The default priority is not included in the JSON representation.
+  EXPECT_THAT(resource_spec.ToJson(),
+              IsOkAndHolds(MatchesJson({{"limit", 2}})));
+}
+
+TEST(ConcurrencyResourceTest, InvalidPriority) {
+  EXPECT_THAT(Context::Resource<DataCopyConcurrencyResource>::FromJson(
+                  {{"priority", "urgent"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"priority\".*"));
+}
+
+}  // namespace
@@ -195,6 +195,16 @@ Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
 /// \returns Number of bytes written or a failure absl::Status code.
 Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf, size_t count);
 
+/// Writes to an open file at the specified offset.
+///
+/// \param fd Open file descriptor.
+/// \param buf[in] Pointer to data to write.
+/// \param count Maximum number of bytes to write.
+/// \param offset Byte offset within file at which to start writing.
+/// \returns Number of bytes written or a failure absl::Status code.
+Result<ptrdiff_t> WriteToFileAt(FileDescriptor fd, const void* buf,
+                                size_t count, int64_t offset);
+
 /// Writes an absl::Cord to an open file.
 ///
 /// \param fd Open file descriptor.
@@ -203,6 +213,11 @@ Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf, size_t count);
 /// \returns Number of bytes written or a failure absl::Status code.
 Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value);
 
+/// Sets the last modified time of an open file.
+///
+/// \returns `absl::OkStatus` on success, or a failure absl::Status code.
+absl::Status SetFileModificationTime(FileDescriptor fd, absl::Time time);
+
 /// Truncates an open file.
 ///
 /// \returns `absl::OkStatus` on success, or a failure absl::Status code.
@@ -234,6 +249,26 @@ absl::Status DeleteFile(const std::string& path);
 /// \returns `absl::OkStatus` on success, or a failure absl::Status code.
 absl::Status FsyncFile(FileDescriptor fd);
 
+/// Syncs the entire filesystem containing an open file descriptor, which may
+/// be cheaper than syncing many files individually.
+///
+/// \returns `absl::OkStatus` on success, `absl::StatusCode::kUnimplemented` if
+///     not supported by the platform, or another failure absl::Status code.
+absl::Status SyncFilesystem(FileDescriptor fd);
+
+/// Enables or disables direct I/O, which bypasses the page cache, for reads
+/// and writes of an open file descriptor.
+///
+/// While enabled, on Linux (O_DIRECT), the buffer address, file offset and
+/// size of each read and write must be multiples of the logical block size of
+/// the underlying device, for which `GetDefaultPageSize()` is sufficient.
+///
+/// \returns `absl::OkStatus` on success, `absl::StatusCode::kUnimplemented` if
+///     direct I/O is not supported by the platform, or another failure
+///     absl::Status code (e.g. `kInvalidArgument` if not supported by the
+///     filesystem).
+absl::Status SetDirectIo(FileDescriptor fd, bool enable);
+
 /// Acquires a lock on an open file descriptor.
 ///
 /// \returns An unlock function on success, or an error status.
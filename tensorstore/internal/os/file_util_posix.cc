@@ -291,6 +291,25 @@ Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
   return std::move(tspan).EndWithStatus(std::move(status));
 }
 
+Result<ptrdiff_t> WriteToFileAt(FileDescriptor fd, const void* buf,
+                                size_t count, int64_t offset) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1),
+                        {{"fd", fd}, {"count", count}, {"offset", offset}});
+
+  ssize_t n;
+  do {
+    PotentiallyBlockingRegion region;
+    n = ::pwrite(fd, buf, count, static_cast<off_t>(offset));
+  } while ((n < 0) && (errno == EINTR || errno == EAGAIN));
+  if (count != 0 && n == 0) {
+    errno = ENOSPC;
+  } else if (n >= 0) {
+    return n;
+  }
+  auto status = StatusFromOsError(errno, "Failed to write to file");
+  return std::move(tspan).EndWithStatus(std::move(status));
+}
+
 Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1),
                         {{"fd", fd}, {"count", value.size()}});
@@ -318,6 +337,21 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return std::move(tspan).EndWithStatus(std::move(status));
 }
 
+absl::Status SetFileModificationTime(FileDescriptor fd, absl::Time time) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"fd", fd}});
+  struct ::timespec times[2];
+  times[0].tv_sec = 0;
+  times[0].tv_nsec = UTIME_OMIT;
+  times[1] = absl::ToTimespec(time);
+  PotentiallyBlockingRegion region;
+  if (::futimens(fd, times) == 0) {
+    return absl::OkStatus();
+  }
+  auto status =
+      StatusFromOsError(errno, "Failed to set file modification time");
+  return std::move(tspan).EndWithStatus(std::move(status));
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"fd", fd}});
   PotentiallyBlockingRegion region;
@@ -441,6 +475,42 @@ absl::Status FsyncFile(FileDescriptor fd) {
   return std::move(tspan).EndWithStatus(std::move(status));
 }
 
+absl::Status SyncFilesystem(FileDescriptor fd) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"fd", fd}});
+#if defined(__linux__)
+  PotentiallyBlockingRegion region;
+  if (::syncfs(fd) == 0) {
+    return absl::OkStatus();
+  }
+  auto status = StatusFromOsError(errno, "Failed to sync filesystem");
+  return std::move(tspan).EndWithStatus(std::move(status));
+#else
+  return absl::UnimplementedError("syncfs is not supported");
+#endif
+}
+
+absl::Status SetDirectIo(FileDescriptor fd, bool enable) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1),
+                        {{"fd", fd}, {"enable", enable}});
+#if defined(O_DIRECT)
+  int flags = ::fcntl(fd, F_GETFL);
+  if (flags != -1) {
+    flags = enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (::fcntl(fd, F_SETFL, flags) == 0) {
+      return absl::OkStatus();
+    }
+  }
+#elif defined(F_NOCACHE)
+  if (::fcntl(fd, F_NOCACHE, enable ? 1 : 0) != -1) {
+    return absl::OkStatus();
+  }
+#else
+  return absl::UnimplementedError("Direct I/O is not supported");
+#endif
+  auto status = StatusFromOsError(errno, "Failed to set direct I/O");
+  return std::move(tspan).EndWithStatus(std::move(status));
+}
+
 absl::Status GetFileInfo(FileDescriptor fd, FileInfo* info) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"fd", fd}});
 
@@ -49,9 +49,11 @@ using ::tensorstore::internal_os::OpenFileWrapper;
 using ::tensorstore::internal_os::OpenFlags;
 using ::tensorstore::internal_os::ReadFromFile;
 using ::tensorstore::internal_os::RenameOpenFile;
+using ::tensorstore::internal_os::SetFileModificationTime;
 using ::tensorstore::internal_os::TruncateFile;
 using ::tensorstore::internal_os::WriteCordToFile;
 using ::tensorstore::internal_os::WriteToFile;
+using ::tensorstore::internal_os::WriteToFileAt;
 using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
 
 TEST(FileUtilTest, Basics) {
@@ -149,6 +151,27 @@ TEST(FileUtilTest, ExclusiveFile) {
   }
 }
 
+TEST(FileUtilTest, WriteToFileAt) {
+  ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  auto f =
+      OpenFileWrapper(foo_txt, OpenFlags::Create | OpenFlags::OpenReadWrite);
+  ASSERT_THAT(f, IsOk());
+  EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord("abcdef")), IsOkAndHolds(6));
+  EXPECT_THAT(WriteToFileAt(f->get(), "XY", 2, 1), IsOkAndHolds(2));
+  EXPECT_THAT(WriteToFileAt(f->get(), "Z", 1, 7), IsOkAndHolds(1));
+
+  char buf[16];
+  EXPECT_THAT(ReadFromFile(f->get(), buf, sizeof(buf), 0), IsOkAndHolds(8));
+  EXPECT_EQ(std::string("aXYdef\0Z", 8), std::string(buf, 8));
+
+  const absl::Time mtime = absl::FromUnixSeconds(1600000000);
+  EXPECT_THAT(SetFileModificationTime(f->get(), mtime), IsOk());
+  FileInfo info;
+  ASSERT_THAT(GetFileInfo(f->get(), &info), IsOk());
+  EXPECT_EQ(mtime, GetMTime(info));
+}
+
 TEST(FileUtilTest, LockFile) {
   ScopedTemporaryDirectory tempdir;
   std::string foo_txt = absl::StrCat(tempdir.path(), "/foo.txt",
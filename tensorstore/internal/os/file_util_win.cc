@@ -311,6 +311,24 @@ Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
   return std::move(tspan).EndWithStatus(std::move(status));
 }
 
+Result<ptrdiff_t> WriteToFileAt(FileDescriptor fd, const void* buf,
+                                size_t count, int64_t offset) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1),
+                        {{"handle", fd}, {"size", count}, {"offset", offset}});
+
+  auto overlapped = GetOverlappedWithOffset(static_cast<uint64_t>(offset));
+  if (count > std::numeric_limits<DWORD>::max()) {
+    count = std::numeric_limits<DWORD>::max();
+  }
+  DWORD num_written;
+  if (::WriteFile(fd, buf, static_cast<DWORD>(count), &num_written,
+                  &overlapped)) {
+    return static_cast<size_t>(num_written);
+  }
+  auto status = StatusFromOsError(::GetLastError(), "Failed to write to file");
+  return std::move(tspan).EndWithStatus(std::move(status));
+}
+
 Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1),
                         {{"handle", fd}, {"size", value.size()}});
@@ -331,6 +349,25 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return value.size();
 }
 
+absl::Status SetFileModificationTime(FileDescriptor fd, absl::Time time) {
+  LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"handle", fd}});
+
+  // Inverse of the conversion in `GetMTime`.
+  const uint64_t windows_ticks =
+      static_cast<uint64_t>(absl::ToUnixNanos(time) / 100) +
+      11644473600ULL * 10000000;
+  ::FILETIME last_write_time;
+  last_write_time.dwLowDateTime = static_cast<DWORD>(windows_ticks);
+  last_write_time.dwHighDateTime = static_cast<DWORD>(windows_ticks >> 32);
+  if (::SetFileTime(fd, /*lpCreationTime=*/nullptr,
+                    /*lpLastAccessTime=*/nullptr, &last_write_time)) {
+    return absl::OkStatus();
+  }
+  auto status = StatusFromOsError(::GetLastError(),
+                                  "Failed to set file modification time");
+  return std::move(tspan).EndWithStatus(std::move(status));
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"handle", fd}});
 
@@ -536,6 +573,15 @@ absl::Status FsyncFile(FileDescriptor fd) {
   return std::move(tspan).EndWithStatus(std::move(status));
 }
 
+absl::Status SyncFilesystem(FileDescriptor fd) {
+  return absl::UnimplementedError("syncfs is not supported");
+}
+
+absl::Status SetDirectIo(FileDescriptor fd, bool enable) {
+  // FILE_FLAG_NO_BUFFERING may only be specified when opening a file.
+  return absl::UnimplementedError("Direct I/O is not supported");
+}
+
 absl::Status GetFileInfo(FileDescriptor fd, FileInfo* info) {
   LoggedTraceSpan tspan(__func__, detail_logging.Level(1), {{"handle", fd}});
 
@@ -0,0 +1,353 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/internal/os/potentially_blocking_region.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+// Include system headers last to reduce impact of macros.
+#include "tensorstore/internal/os/file_util.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define TENSORSTORE_INTERNAL_OS_HAVE_IO_URING 1
+#endif
+#endif
+
+using ::tensorstore::internal::PotentiallyBlockingRegion;
+using ::tensorstore::internal::StatusFromOsError;
+
+namespace tensorstore {
+namespace internal_os {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag io_uring_logging("io_uring");
+
+}  // namespace
+
+#ifdef TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+namespace {
+
+/// Memory mapped region owned by an `IoUring::Impl`.
+struct RingMapping {
+  void* data = MAP_FAILED;
+  size_t size = 0;
+
+  RingMapping() = default;
+  RingMapping(const RingMapping&) = delete;
+  RingMapping& operator=(const RingMapping&) = delete;
+  ~RingMapping() {
+    if (data != MAP_FAILED) ::munmap(data, size);
+  }
+
+  absl::Status Map(int ring_fd, size_t map_size, uint64_t offset) {
+    size = map_size;
+    data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    if (data == MAP_FAILED) {
+      return StatusFromOsError(errno, "Failed to map io_uring");
+    }
+    return absl::OkStatus();
+  }
+
+  template <typename T>
+  T* at(uint32_t offset) const {
+    return reinterpret_cast<T*>(static_cast<char*>(data) + offset);
+  }
+};
+
+}  // namespace
+
+struct IoUring::Impl {
+  UniqueFileDescriptor ring_fd;
+  RingMapping sq_region;
+  RingMapping cq_region;
+  RingMapping sqe_region;
+
+  // Submission queue.
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned sq_entries;
+  io_uring_sqe* sqes;
+
+  // Completion queue.
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  io_uring_cqe* cqes;
+
+  absl::Status Init(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      // `EINVAL` indicates a kernel that does not support the requested
+      // parameters.  Other errors, such as `ENOMEM` or `EMFILE`, may be
+      // transient.
+      if (errno == ENOSYS || errno == EPERM || errno == EINVAL) {
+        return absl::UnimplementedError("io_uring is not supported");
+      }
+      return StatusFromOsError(errno, "Failed to create io_uring");
+    }
+    ring_fd.reset(fd);
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    RingMapping* cq_mapping = &cq_region;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      // The submission and completion rings share a single mapping.
+      sq_size = std::max(sq_size, cq_size);
+      cq_mapping = &sq_region;
+    }
+    TENSORSTORE_RETURN_IF_ERROR(
+        sq_region.Map(fd, sq_size, IORING_OFF_SQ_RING));
+    if (cq_mapping == &cq_region) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          cq_region.Map(fd, cq_size, IORING_OFF_CQ_RING));
+    }
+    TENSORSTORE_RETURN_IF_ERROR(sqe_region.Map(
+        fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+
+    sq_tail = sq_region.at<unsigned>(params.sq_off.tail);
+    sq_mask = sq_region.at<unsigned>(params.sq_off.ring_mask);
+    sq_array = sq_region.at<unsigned>(params.sq_off.array);
+    sq_entries = params.sq_entries;
+    sqes = sqe_region.at<io_uring_sqe>(0);
+
+    cq_head = cq_mapping->at<unsigned>(params.cq_off.head);
+    cq_tail = cq_mapping->at<unsigned>(params.cq_off.tail);
+    cq_mask = cq_mapping->at<unsigned>(params.cq_off.ring_mask);
+    cqes = cq_mapping->at<io_uring_cqe>(params.cq_off.cqes);
+    return absl::OkStatus();
+  }
+
+  /// Queues a read of the unread remainder of `read`, using `iov` which must
+  /// remain valid until the read completes.  The caller must ensure that
+  /// fewer than `sq_entries` reads are in flight.
+  void Prepare(int fd, IoUringRead& read, iovec& iov, uint64_t user_data) {
+    iov.iov_base = static_cast<char*>(read.buf) + read.bytes_read;
+    iov.iov_len = read.count - read.bytes_read;
+
+    // This thread is the only producer, so the tail may be read relaxed.
+    unsigned tail = __atomic_load_n(sq_tail, __ATOMIC_RELAXED);
+    unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    // IORING_OP_READV, unlike IORING_OP_READ, is supported by all kernel
+    // versions that support io_uring.
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&iov);
+    sqe->len = 1;
+    sqe->off = static_cast<uint64_t>(read.offset + read.bytes_read);
+    sqe->user_data = user_data;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /// Submits up to `to_submit` queued entries and waits for at least
+  /// `wait_for` completions.
+  ///
+  /// \returns The number of entries consumed by the kernel.
+  Result<unsigned> Enter(unsigned to_submit, unsigned wait_for) {
+    while (true) {
+      int n;
+      {
+        PotentiallyBlockingRegion region;
+        n = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd.get(),
+                                       to_submit, wait_for,
+                                       IORING_ENTER_GETEVENTS, nullptr, 0));
+      }
+      if (n >= 0) return static_cast<unsigned>(n);
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        return StatusFromOsError(errno, "Failed to submit to io_uring");
+      }
+    }
+  }
+
+  /// Invokes `callback(cqe)` for each available completion.
+  template <typename Callback>
+  void Reap(Callback callback) {
+    unsigned head = __atomic_load_n(cq_head, __ATOMIC_RELAXED);
+    unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      callback(cqes[head & *cq_mask]);
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+  }
+};
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUring::~IoUring() = default;
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(unsigned entries) {
+  auto impl = std::make_unique<Impl>();
+  TENSORSTORE_RETURN_IF_ERROR(impl->Init(entries));
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl)));
+}
+
+void IoUring::ReadAll(FileDescriptor fd, span<IoUringRead> reads) {
+  auto& impl = *impl_;
+  std::vector<iovec> iovs(reads.size());
+  // Indices of reads that have yet to be queued, in reverse order.
+  std::vector<size_t> pending;
+  pending.reserve(reads.size());
+  for (size_t i = reads.size(); i-- > 0;) {
+    reads[i].bytes_read = 0;
+    reads[i].status = absl::OkStatus();
+    if (reads[i].count != 0) pending.push_back(i);
+  }
+
+  // Number of reads queued but not yet consumed by the kernel.
+  unsigned queued = 0;
+  // Number of reads queued but not yet completed, including `queued`.
+  unsigned in_flight = 0;
+  absl::Status ring_status;
+  auto on_completion = [&](const io_uring_cqe& cqe) {
+    size_t i = static_cast<size_t>(cqe.user_data);
+    auto& read = reads[i];
+    --in_flight;
+    if (cqe.res < 0) {
+      if ((cqe.res == -EINTR || cqe.res == -EAGAIN) && ring_status.ok()) {
+        pending.push_back(i);
+      } else {
+        read.status = StatusFromOsError(-cqe.res, "Failed to read from file");
+      }
+      return;
+    }
+    read.bytes_read += cqe.res;
+    const size_t min_count = read.min_count ? read.min_count : read.count;
+    if (cqe.res != 0 && read.bytes_read < min_count && ring_status.ok()) {
+      // Partial read; read the remainder.
+      pending.push_back(i);
+    }
+  };
+
+  while (!pending.empty() || in_flight != 0) {
+    while (!pending.empty() && in_flight < impl.sq_entries) {
+      size_t i = pending.back();
+      pending.pop_back();
+      impl.Prepare(fd, reads[i], iovs[i], i);
+      ++queued;
+      ++in_flight;
+    }
+    ABSL_LOG_IF(INFO, io_uring_logging)
+        << "io_uring submit " << queued << ", in flight " << in_flight;
+    auto consumed = impl.Enter(queued, 1);
+    if (!consumed.ok()) {
+      ring_status = consumed.status();
+      break;
+    }
+    queued -= *consumed;
+    impl.Reap(on_completion);
+  }
+
+  if (ring_status.ok()) return;
+
+  // The ring is in an unknown state.  Wait for reads already consumed by the
+  // kernel, since they write to the caller's buffers, then fail all reads
+  // that have not completed.  The ring is discarded by `IoUringPool`.
+  while (in_flight > queued) {
+    if (!impl.Enter(0, 1).ok()) break;
+    impl.Reap(on_completion);
+  }
+  for (auto& read : reads) {
+    if (read.status.ok() && read.bytes_read < read.count) {
+      read.status = ring_status;
+    }
+  }
+  impl_.reset();
+}
+
+#else  // TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+struct IoUring::Impl {};
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUring::~IoUring() = default;
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(unsigned entries) {
+  return absl::UnimplementedError("io_uring is not supported");
+}
+
+void IoUring::ReadAll(FileDescriptor fd, span<IoUringRead> reads) {
+  for (auto& read : reads) {
+    read.status = absl::UnimplementedError("io_uring is not supported");
+  }
+}
+
+#endif  // TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+std::unique_ptr<IoUring> IoUringPool::Acquire() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (unsupported_) return nullptr;
+    if (!idle_.empty()) {
+      auto ring = std::move(idle_.back());
+      idle_.pop_back();
+      return ring;
+    }
+  }
+  auto ring = IoUring::Create(entries_);
+  if (!ring.ok()) {
+    ABSL_LOG_IF(INFO, io_uring_logging || !absl::IsUnimplemented(ring.status()))
+        << "Falling back to pread: " << ring.status();
+    // Only a lack of support is permanent; after a transient failure, such as
+    // exhausting memory or file descriptors, just this batch falls back.
+    if (absl::IsUnimplemented(ring.status())) {
+      absl::MutexLock lock(&mutex_);
+      unsupported_ = true;
+    }
+    return nullptr;
+  }
+  return *std::move(ring);
+}
+
+void IoUringPool::Release(std::unique_ptr<IoUring> ring) {
+  // A ring whose `ReadAll` failed to submit is discarded.
+  if (!ring || !ring->impl_) return;
+  absl::MutexLock lock(&mutex_);
+  idle_.push_back(std::move(ring));
+}
+
+}  // namespace internal_os
+}  // namespace tensorstore
@@ -0,0 +1,117 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_OS_IO_URING_H_
+#define TENSORSTORE_INTERNAL_OS_IO_URING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+// Include system headers last to reduce impact of macros.
+#include "tensorstore/internal/os/file_util.h"
+
+namespace tensorstore {
+namespace internal_os {
+
+/// Positional read submitted to an `IoUring`.
+struct IoUringRead {
+  /// Destination buffer of at least `count` bytes.
+  void* buf;
+  size_t count;
+  int64_t offset;
+
+  /// Partial reads are continued until at least `min_count` bytes (or `count`
+  /// bytes, if zero) have been read, or the end of the file is reached.  With
+  /// direct I/O, where `count` is rounded up to the block size, this avoids
+  /// continuing at an unaligned offset past the end of the file.
+  size_t min_count = 0;
+
+  /// Set by `IoUring::ReadAll`.  If `bytes_read < count` and `status` is ok,
+  /// the end of the file was reached.
+  size_t bytes_read = 0;
+  absl::Status status;
+};
+
+/// Minimal io_uring instance used to issue a batch of positional reads with a
+/// single `io_uring_enter` system call, rather than one `pread` per read.
+///
+/// Only supported on Linux 5.1 or later; on other platforms, or if the kernel
+/// does not support io_uring (or it is disabled by seccomp), `Create` returns
+/// an error.
+///
+/// An `IoUring` is not thread safe; concurrent users should acquire separate
+/// instances from an `IoUringPool`.
+class IoUring {
+ public:
+  /// Creates a ring with room for at least `entries` in-flight reads.
+  ///
+  /// \error `absl::StatusCode::kUnimplemented` if io_uring is not supported.
+  static Result<std::unique_ptr<IoUring>> Create(unsigned entries);
+
+  ~IoUring();
+
+  /// Reads each of `reads` from `fd`, blocking until all have completed.
+  ///
+  /// Up to the ring size, all reads are submitted together; partial reads are
+  /// resubmitted as specified by `IoUringRead::min_count`.
+  void ReadAll(FileDescriptor fd, span<IoUringRead> reads);
+
+  struct Impl;
+
+ private:
+  friend class IoUringPool;
+  explicit IoUring(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+/// Pool of `IoUring` instances, which avoids the cost of setting up a ring
+/// for each batch while still allowing concurrent batches.
+class IoUringPool {
+ public:
+  /// \param entries Ring size of each `IoUring` created by the pool.
+  explicit IoUringPool(unsigned entries) : entries_(entries) {}
+
+  /// Returns an idle ring, or a newly created one.
+  ///
+  /// Returns `nullptr` if io_uring is not supported, or a ring could not be
+  /// created, in which case callers should fall back to `ReadFromFile`.  Only
+  /// if io_uring is not supported are later calls to `Acquire` also
+  /// unsuccessful.
+  std::unique_ptr<IoUring> Acquire();
+
+  /// Returns a ring obtained from `Acquire` to the pool.
+  void Release(std::unique_ptr<IoUring> ring);
+
+  unsigned entries() const { return entries_; }
+
+ private:
+  unsigned entries_;
+  absl::Mutex mutex_;
+  bool unsupported_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::unique_ptr<IoUring>> idle_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_os
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_OS_IO_URING_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/util/status_testutil.h"
+
+// Include system headers last to reduce impact of macros.
+#include "tensorstore/internal/os/file_util.h"
+
+namespace {
+
+using ::tensorstore::IsOk;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::internal_os::IoUring;
+using ::tensorstore::internal_os::IoUringPool;
+using ::tensorstore::internal_os::IoUringRead;
+using ::tensorstore::internal_os::OpenExistingFileForReading;
+using ::tensorstore::internal_os::OpenFileWrapper;
+using ::tensorstore::internal_os::OpenFlags;
+using ::tensorstore::internal_os::WriteCordToFile;
+using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
+
+TEST(IoUringTest, ReadAll) {
+  auto ring = IoUring::Create(4);
+  if (absl::IsUnimplemented(ring.status())) {
+    GTEST_SKIP() << ring.status();
+  }
+  ASSERT_THAT(ring, IsOk());
+
+  ScopedTemporaryDirectory tempdir;
+  std::string path = tempdir.path() + "/data";
+  std::string contents;
+  for (int i = 0; i < 4096; ++i) contents += static_cast<char>('a' + i % 26);
+  {
+    auto f = OpenFileWrapper(path, OpenFlags::DefaultWrite);
+    ASSERT_THAT(f, IsOk());
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord(contents)),
+                IsOkAndHolds(contents.size()));
+  }
+  auto f = OpenExistingFileForReading(path);
+  ASSERT_THAT(f, IsOk());
+
+  // More reads than ring entries, including one past the end of the file.
+  std::vector<std::string> buffers(10, std::string(100, '\0'));
+  std::vector<IoUringRead> reads;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    reads.push_back({buffers[i].data(), buffers[i].size(),
+                     static_cast<int64_t>(i * 400)});
+  }
+  reads.back().offset = 4050;
+  (*ring)->ReadAll(f->get(), reads);
+  for (size_t i = 0; i + 1 < reads.size(); ++i) {
+    EXPECT_THAT(reads[i].status, IsOk());
+    EXPECT_EQ(100, reads[i].bytes_read);
+    EXPECT_EQ(contents.substr(i * 400, 100), buffers[i]) << i;
+  }
+  EXPECT_THAT(reads.back().status, IsOk());
+  EXPECT_EQ(46, reads.back().bytes_read);
+  EXPECT_EQ(contents.substr(4050), buffers.back().substr(0, 46));
+}
+
+TEST(IoUringPoolTest, Reuse) {
+  IoUringPool pool(4);
+  auto ring = pool.Acquire();
+  if (!ring) GTEST_SKIP() << "io_uring is not supported";
+  IoUring* ptr = ring.get();
+  pool.Release(std::move(ring));
+  EXPECT_EQ(ptr, pool.Acquire().get());
+}
+
+}  // namespace
@@ -0,0 +1,117 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/numa.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+// Include system headers last to reduce impact of macros.
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace tensorstore {
+namespace internal_os {
+namespace {
+
+#ifdef __linux__
+constexpr char kNodeDirectory[] = "/sys/devices/system/node";
+
+/// Reads a list from a sysfs file, returning an empty list on error.
+std::vector<int> ReadCpuList(const std::string& path) {
+  std::ifstream file(path);
+  std::string contents;
+  if (!file.is_open() || !std::getline(file, contents)) return {};
+  auto list = ParseCpuList(contents);
+  return list.ok() ? *std::move(list) : std::vector<int>{};
+}
+#endif
+
+}  // namespace
+
+Result<std::vector<int>> ParseCpuList(std::string_view list) {
+  std::vector<int> cpus;
+  list = absl::StripAsciiWhitespace(list);
+  if (list.empty()) return cpus;
+  for (std::string_view range : absl::StrSplit(list, ',')) {
+    std::pair<std::string_view, std::string_view> bounds =
+        absl::StrSplit(range, absl::MaxSplits('-', 1));
+    int first, last;
+    if (!absl::SimpleAtoi(bounds.first, &first) ||
+        !absl::SimpleAtoi(bounds.second.empty() ? bounds.first : bounds.second,
+                          &last) ||
+        first < 0 || last < first) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid CPU list: ", QuoteString(list)));
+    }
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+std::vector<NumaNode> GetNumaNodes() {
+  std::vector<NumaNode> nodes;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return nodes;
+  for (int id : ReadCpuList(absl::StrCat(kNodeDirectory, "/online"))) {
+    NumaNode node{id, {}};
+    for (int cpu :
+         ReadCpuList(absl::StrCat(kNodeDirectory, "/node", id, "/cpulist"))) {
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+        node.cpus.push_back(cpu);
+      }
+    }
+    if (!node.cpus.empty()) nodes.push_back(std::move(node));
+  }
+#endif
+  return nodes;
+}
+
+absl::Status SetCurrentThreadCpuAffinity(span<const int> cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  if (int error = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+      error != 0) {
+    return internal::StatusFromOsError(error,
+                                       "Failed to set thread CPU affinity");
+  }
+  return absl::OkStatus();
+#else
+  return absl::UnimplementedError("Not implemented on this platform.");
+#endif
+}
+
+}  // namespace internal_os
+}  // namespace tensorstore
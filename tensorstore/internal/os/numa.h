@@ -0,0 +1,51 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_OS_NUMA_H_
+#define TENSORSTORE_INTERNAL_OS_NUMA_H_
+
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_os {
+
+/// NUMA node and the CPUs on the node that the process may run on.
+struct NumaNode {
+  int id;
+  std::vector<int> cpus;
+};
+
+/// Parses a CPU or node list in the Linux sysfs format, such as "0-3,8,10-11".
+Result<std::vector<int>> ParseCpuList(std::string_view list);
+
+/// Returns the NUMA nodes with at least one CPU that the process may run on.
+///
+/// Returns an empty vector if the topology is unknown, which is always the
+/// case on platforms other than Linux.
+std::vector<NumaNode> GetNumaNodes();
+
+/// Restricts the calling thread to run on `cpus`.
+///
+/// \error `absl::StatusCode::kUnimplemented` on platforms other than Linux.
+absl::Status SetCurrentThreadCpuAffinity(span<const int> cpus);
+
+}  // namespace internal_os
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_OS_NUMA_H_
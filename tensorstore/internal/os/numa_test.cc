@@ -0,0 +1,58 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/numa.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_os::GetNumaNodes;
+using ::tensorstore::internal_os::ParseCpuList;
+using ::tensorstore::internal_os::SetCurrentThreadCpuAffinity;
+using ::testing::ElementsAre;
+
+TEST(ParseCpuListTest, Valid) {
+  EXPECT_THAT(ParseCpuList(""), IsOkAndHolds(ElementsAre()));
+  EXPECT_THAT(ParseCpuList("0\n"), IsOkAndHolds(ElementsAre(0)));
+  EXPECT_THAT(ParseCpuList("0-3,8,10-11"),
+              IsOkAndHolds(ElementsAre(0, 1, 2, 3, 8, 10, 11)));
+}
+
+TEST(ParseCpuListTest, Invalid) {
+  EXPECT_THAT(ParseCpuList("a"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseCpuList("3-1"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseCpuList("1,,2"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(NumaTest, SetAffinityToNode) {
+  // The topology may be unavailable, e.g. in containers without sysfs.
+  auto nodes = GetNumaNodes();
+  for (const auto& node : nodes) {
+    EXPECT_FALSE(node.cpus.empty());
+  }
+  if (!nodes.empty()) {
+    TENSORSTORE_EXPECT_OK(SetCurrentThreadCpuAffinity(nodes[0].cpus));
+  }
+}
+
+}  // namespace
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
@@ -32,6 +33,7 @@
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/gauge.h"
 #include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/os/numa.h"
 #include "tensorstore/internal/thread/task_provider.h"
 #include "tensorstore/internal/thread/thread.h"
 
@@ -45,6 +47,7 @@ constexpr absl::Duration kThreadStartDelay = absl::Milliseconds(5);
 constexpr absl::Duration kThreadExitDelay = absl::Milliseconds(5);
 constexpr absl::Duration kThreadIdleBeforeExit = absl::Seconds(20);
 constexpr absl::Duration kOverseerIdleBeforeExit = absl::Seconds(20);
+constexpr absl::Duration kMaxPriorityStarvation = absl::Milliseconds(100);
 
 auto& thread_pool_started = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/thread_pool/started",
@@ -60,17 +63,31 @@ auto& thread_pool_task_providers = internal_metrics::Gauge<int64_t>::New(
 
 ABSL_CONST_INIT internal_log::VerboseFlag thread_pool_logging("thread_pool");
 
+thread_local int current_worker_numa_node = -1;
+
 }  // namespace
 
-SharedThreadPool::SharedThreadPool() : waiting_(128) {
-  ABSL_LOG_IF(INFO, thread_pool_logging) << "SharedThreadPool: " << this;
+int CurrentWorkerNumaNode() { return current_worker_numa_node; }
+
+SharedThreadPool::SharedThreadPool()
+    : SharedThreadPool(std::vector<internal_os::NumaNode>{}) {}
+
+SharedThreadPool::SharedThreadPool(
+    std::vector<internal_os::NumaNode> numa_nodes)
+    : numa_nodes_(std::move(numa_nodes)),
+      numa_node_workers_(numa_nodes_.size()) {
+  ABSL_LOG_IF(INFO, thread_pool_logging)
+      << "SharedThreadPool: " << this << " numa_nodes=" << numa_nodes_.size();
 }
 
 void SharedThreadPool::NotifyWorkAvailable(
     internal::IntrusivePtr<TaskProvider> task_provider) {
   absl::MutexLock lock(&mutex_);
   if (in_queue_.insert(task_provider.get()).second) {
-    waiting_.push_back(std::move(task_provider));
+    auto& waiting = waiting_[static_cast<size_t>(task_provider->priority())];
+    if (waiting.queue.empty()) waiting.last_assignment_time = absl::Now();
+    waiting.queue.push_back(std::move(task_provider));
+    UpdateWaiting();
   }
 
   if (!overseer_running_) {
@@ -80,11 +97,40 @@ void SharedThreadPool::NotifyWorkAvailable(
   }
 }
 
-internal::IntrusivePtr<TaskProvider>
-SharedThreadPool::FindActiveTaskProvider() {
-  for (int i = waiting_.size(); i > 0; i--) {
-    internal::IntrusivePtr<TaskProvider> ptr = std::move(waiting_.front());
-    waiting_.pop_front();
+void SharedThreadPool::UpdateWaiting() {
+  size_t most_urgent = kNumTaskPriorities;
+  size_t total = 0;
+  for (size_t i = kNumTaskPriorities; i-- > 0;) {
+    if (waiting_[i].queue.empty()) continue;
+    most_urgent = i;
+    total += waiting_[i].queue.size();
+  }
+  most_urgent_waiting_.store(most_urgent, std::memory_order_relaxed);
+  thread_pool_task_providers.Set(total);
+}
+
+internal::IntrusivePtr<TaskProvider> SharedThreadPool::FindActiveTaskProvider(
+    absl::Time now) {
+  // Serve starved less urgent classes first.
+  for (size_t i = kNumTaskPriorities - 1; i > 0; --i) {
+    auto& waiting = waiting_[i];
+    if (waiting.queue.empty() ||
+        now < waiting.last_assignment_time + kMaxPriorityStarvation) {
+      continue;
+    }
+    if (auto ptr = FindActiveTaskProvider(waiting, now)) return ptr;
+  }
+  for (auto& waiting : waiting_) {
+    if (auto ptr = FindActiveTaskProvider(waiting, now)) return ptr;
+  }
+  return nullptr;
+}
+
+internal::IntrusivePtr<TaskProvider> SharedThreadPool::FindActiveTaskProvider(
+    WaitingQueue& waiting, absl::Time now) {
+  for (int i = waiting.queue.size(); i > 0; i--) {
+    internal::IntrusivePtr<TaskProvider> ptr = std::move(waiting.queue.front());
+    waiting.queue.pop_front();
     auto work = ptr->EstimateThreadsRequired();
     if (work == 0) {
       in_queue_.erase(ptr.get());
@@ -93,11 +139,13 @@ SharedThreadPool::FindActiveTaskProvider() {
     if (work == 1) {
       in_queue_.erase(ptr.get());
     } else {
-      waiting_.push_back(ptr);
+      waiting.queue.push_back(ptr);
     }
-    thread_pool_task_providers.Set(waiting_.size());
+    waiting.last_assignment_time = now;
+    UpdateWaiting();
     return ptr;
   }
+  UpdateWaiting();
   return nullptr;
 }
 
@@ -143,7 +191,7 @@ void SharedThreadPool::Overseer::OverseerBody() {
 }
 
 absl::Time SharedThreadPool::Overseer::MaybeStartWorker(absl::Time now) {
-  if (pool_->idle_threads_ || pool_->waiting_.empty()) {
+  if (pool_->idle_threads_ || !pool_->HasWaiting()) {
     return idle_start_time_ + kOverseerIdleBeforeExit;
   }
   if (now < pool_->last_thread_start_time_ + kThreadStartDelay) {
@@ -153,7 +201,7 @@ absl::Time SharedThreadPool::Overseer::MaybeStartWorker(absl::Time now) {
     return pool_->queue_assignment_time_ + kThreadStartDelay;
   }
 
-  auto task_provider = pool_->FindActiveTaskProvider();
+  auto task_provider = pool_->FindActiveTaskProvider(now);
   if (!task_provider) {
     return idle_start_time_ + kOverseerIdleBeforeExit;
   }
@@ -167,6 +215,8 @@ absl::Time SharedThreadPool::Overseer::MaybeStartWorker(absl::Time now) {
 struct SharedThreadPool::Worker {
   internal::IntrusivePtr<SharedThreadPool> pool_;
   internal::IntrusivePtr<TaskProvider> task_provider_;
+  // Index of the NUMA node to which the worker is pinned, or -1.
+  int numa_node_;
 
   void operator()() const;
   void WorkerBody();
@@ -177,9 +227,16 @@ void SharedThreadPool::StartWorker(
   last_thread_start_time_ = now;
   worker_threads_++;
   thread_pool_started.Increment();
+  int numa_node = -1;
+  if (!numa_node_workers_.empty()) {
+    numa_node = std::min_element(numa_node_workers_.begin(),
+                                 numa_node_workers_.end()) -
+                numa_node_workers_.begin();
+    numa_node_workers_[numa_node]++;
+  }
   tensorstore::internal::Thread::StartDetached(
       {"ts_pool_worker"}, Worker{internal::IntrusivePtr<SharedThreadPool>(this),
-                                 std::move(task_provider)});
+                                 std::move(task_provider), numa_node});
 }
 
 void SharedThreadPool::Worker::operator()() const {
@@ -196,6 +253,13 @@ void SharedThreadPool::Worker::WorkerBody() {
   thread_pool_active.Increment();
   ABSL_LOG_IF(INFO, thread_pool_logging.Level(1)) << "Worker: " << this;
 
+  if (numa_node_ >= 0) {
+    auto status = internal_os::SetCurrentThreadCpuAffinity(
+        pool_->numa_nodes_[numa_node_].cpus);
+    ABSL_LOG_IF(INFO, !status.ok() && thread_pool_logging) << status;
+    current_worker_numa_node = numa_node_;
+  }
+
   while (true) {
     // Get a TaskProvider assignment.
     if (task_provider_) {
@@ -214,13 +278,12 @@ void SharedThreadPool::Worker::WorkerBody() {
       while (!task_provider_) {
         bool active = pool_->mutex_.AwaitWithDeadline(
             absl::Condition(
-                +[](SharedThreadPool* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
-                     self->mutex_) { return !self->waiting_.empty(); },
+                +[](SharedThreadPool* self) { return self->HasWaiting(); },
                 pool_.get()),
             deadline);
         now = absl::Now();
         if (active) {
-          task_provider_ = pool_->FindActiveTaskProvider();
+          task_provider_ = pool_->FindActiveTaskProvider(now);
         } else {
           deadline = std::max(deadline,
                               pool_->last_thread_exit_time_ + kThreadExitDelay);
@@ -235,6 +298,7 @@ void SharedThreadPool::Worker::WorkerBody() {
         pool_->queue_assignment_time_ = now;
       } else {
         pool_->worker_threads_--;
+        if (numa_node_ >= 0) pool_->numa_node_workers_[numa_node_]--;
         pool_->last_thread_exit_time_ = now;
         break;
       }
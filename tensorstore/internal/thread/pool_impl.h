@@ -17,7 +17,10 @@
 
 #include <stddef.h>
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
@@ -25,6 +28,7 @@
 #include "absl/time/time.h"
 #include "tensorstore/internal/container/circular_queue.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/os/numa.h"
 #include "tensorstore/internal/thread/task_provider.h"
 
 namespace tensorstore {
@@ -39,26 +43,67 @@ namespace internal_thread_impl {
 /// Both worker threads and the overseer thread automatically terminate after
 /// they are idle for longer than `kThreadIdleBeforeExit` or
 /// `kOverseerIdleBeforeExit`, respectively.
+///
+/// Waiting TaskProviders are queued by `TaskPriority`, and threads are
+/// assigned to the most urgent class first.  To bound starvation, a less
+/// urgent class that has not been assigned a thread for
+/// `kMaxPriorityStarvation` is served ahead of more urgent classes.
+///
+/// Optionally, worker threads are pinned to NUMA nodes, such that memory
+/// allocated (and first touched) by a task is local to the node, see
+/// `CurrentWorkerNumaNode`.
 class SharedThreadPool
     : public internal::AtomicReferenceCount<SharedThreadPool> {
  public:
   SharedThreadPool();
 
+  /// Constructs a pool that pins each worker thread to the CPUs of one of
+  /// `numa_nodes`, balancing the number of workers across the nodes.
+  explicit SharedThreadPool(std::vector<internal_os::NumaNode> numa_nodes);
+
   /// TaskProviderMethod:  Notify that there is work available.
   /// If the task provider identified by the token is not in the waiting_
   /// queue, add it.
   void NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  /// TaskProvider Method: Returns whether TaskProviders of a more urgent class
+  /// than `priority` are waiting for a thread, in which case a provider of
+  /// class `priority` should return its thread to the pool.
+  bool HasMoreUrgentWork(TaskPriority priority) const {
+    return most_urgent_waiting_.load(std::memory_order_relaxed) <
+           static_cast<size_t>(priority);
+  }
+
  private:
   struct Overseer;
   struct Worker;
 
-  // Gets the next TaskProvider with work available where the last thread
-  // assignment time was before the deadline.
-  internal::IntrusivePtr<TaskProvider> FindActiveTaskProvider()
+  struct WaitingQueue {
+    internal_container::CircularQueue<internal::IntrusivePtr<TaskProvider>>
+        queue{32};
+    // Last time a thread was assigned to this class, or the time at which the
+    // class last became non-empty.
+    absl::Time last_assignment_time = absl::InfinitePast();
+  };
+
+  // Gets the next TaskProvider with work available, in priority order.
+  internal::IntrusivePtr<TaskProvider> FindActiveTaskProvider(absl::Time now)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Gets the next TaskProvider of a single class with work available.
+  internal::IntrusivePtr<TaskProvider> FindActiveTaskProvider(
+      WaitingQueue& waiting, absl::Time now)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Updates `most_urgent_waiting_` after a change to `waiting_`.
+  void UpdateWaiting() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool HasWaiting() const {
+    return most_urgent_waiting_.load(std::memory_order_relaxed) <
+           kNumTaskPriorities;
+  }
+
   /// Starts the overseer thread.
   void StartOverseer() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
@@ -66,9 +111,13 @@ class SharedThreadPool
   void StartWorker(internal::IntrusivePtr<TaskProvider>, absl::Time now)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  const std::vector<internal_os::NumaNode> numa_nodes_;
+
   absl::Mutex mutex_;
   size_t worker_threads_ ABSL_GUARDED_BY(mutex_) = 0;
   size_t idle_threads_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of worker threads pinned to each of `numa_nodes_`.
+  std::vector<size_t> numa_node_workers_ ABSL_GUARDED_BY(mutex_);
 
   // Overseer state.
   absl::CondVar overseer_condvar_;
@@ -83,10 +132,18 @@ class SharedThreadPool
       absl::InfinitePast();
 
   absl::flat_hash_set<TaskProvider*> in_queue_ ABSL_GUARDED_BY(mutex_);
-  internal_container::CircularQueue<internal::IntrusivePtr<TaskProvider>>
-      waiting_ ABSL_GUARDED_BY(mutex_);
+  std::array<WaitingQueue, kNumTaskPriorities> waiting_ ABSL_GUARDED_BY(mutex_);
+
+  // Index of the most urgent non-empty `waiting_` queue, or
+  // `kNumTaskPriorities`.  Written under `mutex_`.
+  std::atomic<size_t> most_urgent_waiting_{kNumTaskPriorities};
 };
 
+/// Returns the index, within the NUMA nodes of its pool, of the node to which
+/// the calling worker thread is pinned, or -1 if the calling thread is not a
+/// pinned worker thread.
+int CurrentWorkerNumaNode();
+
 }  // namespace internal_thread_impl
 }  // namespace tensorstore
 
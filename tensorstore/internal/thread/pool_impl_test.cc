@@ -28,6 +28,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/os/numa.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_provider.h"
 #include "tensorstore/internal/tracing/trace_context.h"
@@ -36,6 +37,8 @@ namespace {
 
 using ::tensorstore::internal::IntrusivePtr;
 using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal_os::GetNumaNodes;
+using ::tensorstore::internal_thread_impl::CurrentWorkerNumaNode;
 using ::tensorstore::internal_thread_impl::InFlightTask;
 using ::tensorstore::internal_thread_impl::SharedThreadPool;
 using ::tensorstore::internal_thread_impl::TaskProvider;
@@ -132,4 +135,27 @@ TEST(SharedThreadPoolTest, LotsOfProviders) {
   }
 }
 
+// Tests that the workers of a NUMA-aware pool are pinned to a node.
+TEST(SharedThreadPoolTest, NumaNodes) {
+  auto nodes = GetNumaNodes();
+  if (nodes.empty()) GTEST_SKIP() << "NUMA topology unavailable";
+  const int num_nodes = nodes.size();
+  auto pool = MakeIntrusivePtr<SharedThreadPool>(std::move(nodes));
+  EXPECT_EQ(-1, CurrentWorkerNumaNode());
+
+  absl::Notification notification;
+  int numa_node = -1;
+  auto provider = SingleTaskProvider::Make(
+      pool, std::make_unique<InFlightTask>(
+                [&] {
+                  numa_node = CurrentWorkerNumaNode();
+                  notification.Notify();
+                },
+                TC(TC::kThread)));
+  provider->Trigger();
+  notification.WaitForNotification();
+  EXPECT_LE(0, numa_node);
+  EXPECT_GT(num_nodes, numa_node);
+}
+
 }  // namespace
@@ -22,6 +22,7 @@
 #include <cassert>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
 #include "absl/synchronization/mutex.h"
@@ -63,10 +64,22 @@ auto& thread_pool_steal_count = internal_metrics::Counter<double>::New(
     "/tensorstore/thread_pool/steal_count",
     MetricMetadata("DetachedThreadPool steal count"));
 
+auto& thread_pool_yield_count = internal_metrics::Counter<double>::New(
+    "/tensorstore/thread_pool/yield_count",
+    MetricMetadata("DetachedThreadPool threads returned to the pool for more "
+                   "urgent work"));
+
 constexpr absl::Duration kThreadAssignmentLifetime = absl::Milliseconds(20);
 
+// Same as the `SharedThreadPool` limit, see `ThreadBudget`.
+constexpr int64_t kMaxPriorityStarvationNs = 100000000;  // 100ms
+
 thread_local TaskGroup::PerThreadData* per_thread_data = nullptr;
 
+// Whether the current thread was handed off by `TaskGroup::ReleaseBudget`,
+// which is not done recursively.
+thread_local bool in_budget_handoff = false;
+
 // Tunable parameter: Steal up to 1/2 the pending items (max 16) and move
 // them to the global queue_.
 inline size_t ItemsToMigrateToGlobalQueue(size_t available) {
@@ -128,12 +141,17 @@ struct TaskGroup::PerThreadData {
   size_t default_assign = 1;
   InFlightTaskQueue queue{128};
   size_t slot = 0;
+  // See `CurrentWorkerNumaNode`.
+  int numa_node = -1;
 };
 
 TaskGroup::TaskGroup(private_t, internal::IntrusivePtr<SharedThreadPool> pool,
-                     size_t thread_limit)
+                     size_t thread_limit, TaskPriority priority,
+                     std::shared_ptr<ThreadBudget> budget)
     : pool_(std::move(pool)),
       thread_limit_(thread_limit),
+      priority_(priority),
+      budget_(std::move(budget)),
       threads_blocked_(0),
       threads_in_use_(0),
       steal_index_(0) {}
@@ -145,19 +163,29 @@ TaskGroup::~TaskGroup() {
 
 int64_t TaskGroup::EstimateThreadsRequired() {
   size_t n = thread_limit_ - threads_in_use_.load(std::memory_order_relaxed);
-  if (n == 0 || threads_blocked_.load(std::memory_order_relaxed) != 0) {
-    return 0;
-  }
-
-  // Otherwise check the available tasks.
-  absl::MutexLock lock(&mutex_);
-  if (!queue_.empty()) {
-    return std::min(n, queue_.size());
+  size_t work = 0;
+  if (n != 0 && threads_blocked_.load(std::memory_order_relaxed) == 0) {
+    // Check the available tasks.
+    absl::MutexLock lock(&mutex_);
+    if (!queue_.empty()) {
+      work = std::min(n, queue_.size());
+    } else {
+      for (auto* p : thread_queues_) {
+        if (!p->queue.empty()) {
+          work = std::min(n, p->queue.size());
+          break;
+        }
+      }
+    }
   }
-  for (auto* p : thread_queues_) {
-    if (!p->queue.empty()) return std::min(n, p->queue.size());
+  if (budget_) {
+    if (work == 0) {
+      budget_->RemoveWaiting(this);
+    } else {
+      work = std::min(work, budget_->Available(this));
+    }
   }
-  return 0;
+  return work;
 }
 
 void TaskGroup::DoWorkOnThread() {
@@ -165,12 +193,17 @@ void TaskGroup::DoWorkOnThread() {
 
   auto data = std::make_shared<PerThreadData>();
   data->owner = this;
+  data->numa_node = CurrentWorkerNumaNode();
 
   {
     absl::MutexLock lock(&mutex_);
     if (threads_in_use_.load(std::memory_order_relaxed) == thread_limit_) {
       return;
     }
+    if (budget_ && !budget_->TryAcquire(this)) {
+      // Notified again when a thread is released.
+      return;
+    }
     threads_in_use_.fetch_add(1, std::memory_order_relaxed);
     thread_queues_.push_back(data.get());
     data->slot = thread_queues_.size() - 1;
@@ -179,6 +212,7 @@ void TaskGroup::DoWorkOnThread() {
 
   int64_t last_run_ns = absl::GetCurrentTimeNanos();
   ThreadMetrics metrics;
+  bool yielded = false;
 
   // As long as there is work available, do it on this thread.
   while (true) {
@@ -188,6 +222,13 @@ void TaskGroup::DoWorkOnThread() {
       metrics.OnStart(task->start_nanos);
       task->Run();
       last_run_ns = metrics.OnStop();
+      if (pool_->HasMoreUrgentWork(priority_) ||
+          (budget_ && budget_->ShouldYield(priority_, last_run_ns))) {
+        // Return the thread to the pool for the more urgent work.
+        thread_pool_yield_count.IncrementBy(1);
+        yielded = true;
+        break;
+      }
       continue;
     }
 
@@ -203,6 +244,7 @@ void TaskGroup::DoWorkOnThread() {
   // Update stats.
   metrics.Update();
 
+  bool work_remaining;
   {
     absl::MutexLock lock(&mutex_);
     threads_in_use_.fetch_sub(1, std::memory_order_relaxed);
@@ -211,9 +253,181 @@ void TaskGroup::DoWorkOnThread() {
       thread_queues_[data->slot]->slot = data->slot;
     }
     thread_queues_.pop_back();
+    // Tasks self-assigned by a yielding thread move to the global queue.
+    while (auto* t = data->queue.try_pop()) {
+      queue_.push_back(std::unique_ptr<InFlightTask>(t));
+    }
+    work_remaining = !queue_.empty();
   }
 
   per_thread_data = nullptr;
+
+  if (budget_) {
+    ReleaseBudget(yielded && work_remaining);
+  } else if (yielded && work_remaining) {
+    // Request a thread for the remaining tasks, which is assigned once the
+    // more urgent work has been assigned threads.
+    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+  }
+}
+
+void TaskGroup::NotifyWorkAvailable() {
+  if (budget_ && budget_->Full() && budget_->Available(this) == 0) {
+    // Notified again when a thread is released.
+    return;
+  }
+  pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+}
+
+void TaskGroup::ReleaseBudget(bool work_remaining) {
+  internal::IntrusivePtr<TaskGroup> handoff;
+  if (work_remaining) {
+    // Wait for a thread from the budget, rather than from the pool, such that
+    // the waiting groups are notified together.
+    budget_->AddWaiting(this);
+    if (!in_budget_handoff) {
+      handoff = budget_->FindHandoff(priority_, absl::GetCurrentTimeNanos());
+    }
+  }
+  auto waiting = budget_->Release();
+  if (handoff && handoff->EstimateThreadsRequired() > 0) {
+    // Work on the preferred group directly, since the released thread would
+    // otherwise be claimed by whichever waiting group the pool assigns a
+    // thread first.
+    in_budget_handoff = true;
+    handoff->DoWorkOnThread();
+    in_budget_handoff = false;
+    // `handoff` may not have acquired the thread, and has since released it.
+    waiting = budget_->GetWaiting();
+  }
+  for (auto& group : waiting) {
+    pool_->NotifyWorkAvailable(std::move(group));
+  }
+}
+
+// `in_use_` is updated without holding `mutex_`.  A group that is denied a
+// thread is recorded as waiting, and then checks `in_use_` again; a release
+// decrements `in_use_`, and then checks for waiting groups.  Since both use
+// sequentially consistent operations, either the group observes the release
+// or the release observes the waiting group.
+
+size_t ThreadBudget::Available(TaskGroup* group) {
+  size_t in_use = in_use_.load();
+  if (in_use < limit_) return limit_ - in_use;
+  absl::MutexLock lock(&mutex_);
+  AddWaitingLocked(group);
+  in_use = in_use_.load();
+  return in_use < limit_ ? limit_ - in_use : 0;
+}
+
+bool ThreadBudget::TryAcquire(TaskGroup* group) {
+  while (true) {
+    size_t in_use = in_use_.load();
+    while (in_use < limit_) {
+      if (in_use_.compare_exchange_weak(in_use, in_use + 1)) {
+        RemoveWaiting(group);
+        return true;
+      }
+    }
+    absl::MutexLock lock(&mutex_);
+    AddWaitingLocked(group);
+    if (in_use_.load() >= limit_) return false;
+  }
+}
+
+std::vector<internal::IntrusivePtr<TaskGroup>> ThreadBudget::Release() {
+  [[maybe_unused]] const size_t in_use = in_use_.fetch_sub(1);
+  assert(in_use > 0);
+  if (!HasWaiting()) return {};
+  absl::MutexLock lock(&mutex_);
+  return GetWaitingLocked();
+}
+
+bool ThreadBudget::HasWaiting() const {
+  for (const auto& start : wait_start_ns_) {
+    if (start.load() != 0) return true;
+  }
+  return false;
+}
+
+std::vector<internal::IntrusivePtr<TaskGroup>> ThreadBudget::GetWaiting() {
+  absl::MutexLock lock(&mutex_);
+  return GetWaitingLocked();
+}
+
+std::vector<internal::IntrusivePtr<TaskGroup>>
+ThreadBudget::GetWaitingLocked() {
+  std::vector<internal::IntrusivePtr<TaskGroup>> groups;
+  for (const auto& waiting : waiting_) {
+    groups.insert(groups.end(), waiting.begin(), waiting.end());
+  }
+  return groups;
+}
+
+void ThreadBudget::AddWaiting(TaskGroup* group) {
+  absl::MutexLock lock(&mutex_);
+  AddWaitingLocked(group);
+}
+
+void ThreadBudget::RemoveWaiting(TaskGroup* group) {
+  const size_t i = static_cast<size_t>(group->priority());
+  if (wait_start_ns_[i].load(std::memory_order_relaxed) == 0) return;
+  absl::MutexLock lock(&mutex_);
+  RemoveWaitingLocked(group);
+}
+
+void ThreadBudget::AddWaitingLocked(TaskGroup* group) {
+  const size_t i = static_cast<size_t>(group->priority());
+  auto& waiting = waiting_[i];
+  for (const auto& g : waiting) {
+    if (g.get() == group) return;
+  }
+  if (waiting.empty()) {
+    wait_start_ns_[i].store(absl::GetCurrentTimeNanos());
+  }
+  waiting.emplace_back(group);
+}
+
+void ThreadBudget::RemoveWaitingLocked(TaskGroup* group) {
+  const size_t i = static_cast<size_t>(group->priority());
+  auto& waiting = waiting_[i];
+  auto it = std::find_if(waiting.begin(), waiting.end(),
+                         [&](const auto& g) { return g.get() == group; });
+  if (it == waiting.end()) return;
+  waiting.erase(it);
+  wait_start_ns_[i].store(waiting.empty() ? 0 : absl::GetCurrentTimeNanos(),
+                          std::memory_order_relaxed);
+}
+
+bool ThreadBudget::ShouldYield(TaskPriority priority, int64_t now_ns) const {
+  const size_t p = static_cast<size_t>(priority);
+  for (size_t i = 0; i < kNumTaskPriorities; ++i) {
+    if (i == p) continue;
+    const int64_t start = wait_start_ns_[i].load(std::memory_order_relaxed);
+    if (start != 0 &&
+        (i < p || now_ns - start >= kMaxPriorityStarvationNs)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+internal::IntrusivePtr<TaskGroup> ThreadBudget::FindHandoff(
+    TaskPriority priority, int64_t now_ns) {
+  const size_t p = static_cast<size_t>(priority);
+  absl::MutexLock lock(&mutex_);
+  // Serve starved less urgent classes first.
+  for (size_t i = kNumTaskPriorities; i-- > 0;) {
+    if (i == p || waiting_[i].empty()) continue;
+    if (now_ns - wait_start_ns_[i].load(std::memory_order_relaxed) >=
+        kMaxPriorityStarvationNs) {
+      return waiting_[i].front();
+    }
+  }
+  for (size_t i = 0; i < p; ++i) {
+    if (!waiting_[i].empty()) return waiting_[i].front();
+  }
+  return nullptr;
 }
 
 /// Acquire a task.
@@ -255,23 +469,31 @@ std::unique_ptr<InFlightTask> TaskGroup::AcquireTask(PerThreadData* thread_data,
 
     thread_data->default_assign = 1;
 
-    // Third, migrate tasks from per-thread queues.
-    for (size_t i = 0; i < thread_queues_.size(); ++i, ++steal_index_) {
-      if (steal_index_ >= thread_queues_.size()) steal_index_ = 0;
-      auto* other_data = thread_queues_[steal_index_];
-      if (!other_data || other_data == thread_data) continue;
-      std::unique_ptr<InFlightTask> task(other_data->queue.try_steal());
-      if (!task) continue;
-      // Tunable parameter: Items to steal and move to the global queue.
-      size_t x = ItemsToMigrateToGlobalQueue(other_data->queue.size());
-      while (x--) {
-        std::unique_ptr<InFlightTask> t(other_data->queue.try_steal());
-        if (!t) break;
-        queue_.push_back(std::move(t));
-      }
+    // Third, migrate tasks from per-thread queues.  Threads pinned to a NUMA
+    // node first steal from threads on the same node, since those tasks were
+    // enqueued by (and likely access memory allocated by) a thread on the
+    // node.
+    for (int pass = thread_data->numa_node < 0 ? 1 : 0; pass < 2; ++pass) {
+      for (size_t i = 0; i < thread_queues_.size(); ++i, ++steal_index_) {
+        if (steal_index_ >= thread_queues_.size()) steal_index_ = 0;
+        auto* other_data = thread_queues_[steal_index_];
+        if (!other_data || other_data == thread_data) continue;
+        if (pass == 0 && other_data->numa_node != thread_data->numa_node) {
+          continue;
+        }
+        std::unique_ptr<InFlightTask> task(other_data->queue.try_steal());
+        if (!task) continue;
+        // Tunable parameter: Items to steal and move to the global queue.
+        size_t x = ItemsToMigrateToGlobalQueue(other_data->queue.size());
+        while (x--) {
+          std::unique_ptr<InFlightTask> t(other_data->queue.try_steal());
+          if (!t) break;
+          queue_.push_back(std::move(t));
+        }
 
-      thread_pool_steal_count.IncrementBy(1);
-      return task;
+        thread_pool_steal_count.IncrementBy(1);
+        return task;
+      }
     }
 
     // No tasks acquired; wait until more work appears on the global queue.
@@ -321,7 +543,7 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
   }
 
   if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
-    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+    NotifyWorkAvailable();
   }
 }
 
@@ -334,7 +556,7 @@ void TaskGroup::BulkAddTask(
     }
   }
   if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
-    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+    NotifyWorkAvailable();
   }
 }
 
@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <memory>
@@ -42,9 +43,17 @@ namespace internal_thread_impl {
 using InFlightTaskQueue =
     internal_container::SingleProducerQueue<InFlightTask*, false>;
 
+class ThreadBudget;
+
 /// TaskGroup is TaskProvider which allows adding additional tasks to a
 /// task provider, and allowing up to a specific number of threads to
 /// work on the tasks concurrently.
+///
+/// Threads working on a TaskGroup return to the pool between tasks when
+/// TaskProviders of a more urgent `TaskPriority` are waiting.
+///
+/// Optionally, the threads of multiple TaskGroups are additionally limited by
+/// a shared `ThreadBudget`.
 class TaskGroup : public TaskProvider {
   struct private_t {};
 
@@ -52,13 +61,17 @@ class TaskGroup : public TaskProvider {
   struct PerThreadData;
 
   static internal::IntrusivePtr<TaskGroup> Make(
-      internal::IntrusivePtr<SharedThreadPool> pool, size_t thread_limit) {
-    return internal::MakeIntrusivePtr<TaskGroup>(private_t{}, std::move(pool),
-                                                 thread_limit);
+      internal::IntrusivePtr<SharedThreadPool> pool, size_t thread_limit,
+      TaskPriority priority = TaskPriority::kNormal,
+      std::shared_ptr<ThreadBudget> budget = nullptr) {
+    return internal::MakeIntrusivePtr<TaskGroup>(
+        private_t{}, std::move(pool), thread_limit, priority,
+        std::move(budget));
   }
 
   TaskGroup(private_t, internal::IntrusivePtr<SharedThreadPool> pool,
-            size_t thread_limit);
+            size_t thread_limit, TaskPriority priority,
+            std::shared_ptr<ThreadBudget> budget);
 
   ~TaskGroup() override;
 
@@ -78,13 +91,25 @@ class TaskGroup : public TaskProvider {
   /// Worker method: Assign a thread to this task provider.
   void DoWorkOnThread() override;
 
+  TaskPriority priority() const override { return priority_; }
+
  private:
   /// Worker method: Acquire work from the global queue or another thread.
   std::unique_ptr<InFlightTask> AcquireTask(PerThreadData* thread_data,
                                             absl::Duration timeout);
 
+  /// Requests a thread from the pool, or waits on `budget_` if it has no
+  /// threads available.
+  void NotifyWorkAvailable();
+
+  /// Worker method: Release the thread to `budget_`, handing it off to a
+  /// waiting TaskGroup if appropriate.
+  void ReleaseBudget(bool work_remaining);
+
   const internal::IntrusivePtr<SharedThreadPool> pool_;
   const size_t thread_limit_;
+  const TaskPriority priority_;
+  const std::shared_ptr<ThreadBudget> budget_;
 
   // worker thread state counters; updated under lock, read without locks.
   ABSL_CACHELINE_ALIGNED std::atomic<int64_t> threads_blocked_;
@@ -97,6 +122,80 @@ class TaskGroup : public TaskProvider {
   size_t steal_index_ ABSL_GUARDED_BY(mutex_);
 };
 
+/// Limit on the total number of threads working on a set of TaskGroups, in
+/// addition to the limit of each group.
+///
+/// A TaskGroup that is denied a thread waits on the budget, and is notified
+/// again when a thread is released.  As in `SharedThreadPool`, threads are
+/// preferentially assigned to the most urgent class: a thread working on a
+/// TaskGroup is handed off, between tasks, to a waiting TaskGroup of a more
+/// urgent class, or of a less urgent class that has not been assigned a
+/// thread for `kMaxPriorityStarvation`.
+///
+/// Acquiring and releasing a thread only updates an atomic counter; the mutex
+/// is acquired only while groups are waiting.
+class ThreadBudget {
+ public:
+  explicit ThreadBudget(size_t limit) : limit_(limit) {}
+
+  /// Returns the number of threads available, recording `group` as waiting
+  /// if there are none.
+  size_t Available(TaskGroup* group);
+
+  /// Returns whether no threads are available, without acquiring a lock.
+  bool Full() const {
+    return in_use_.load(std::memory_order_relaxed) >= limit_;
+  }
+
+  /// Acquires a thread for `group`, or records `group` as waiting.
+  bool TryAcquire(TaskGroup* group);
+
+  /// Releases a thread acquired by `TryAcquire`.
+  ///
+  /// \returns The waiting groups, which must be notified.
+  std::vector<internal::IntrusivePtr<TaskGroup>> Release();
+
+  /// Returns the waiting groups.
+  std::vector<internal::IntrusivePtr<TaskGroup>> GetWaiting();
+
+  void AddWaiting(TaskGroup* group);
+  void RemoveWaiting(TaskGroup* group);
+
+  /// Returns whether a thread working on a group of class `priority` should
+  /// be handed off to a waiting group, see `FindHandoff`.
+  ///
+  /// Called between tasks; does not acquire a lock.
+  bool ShouldYield(TaskPriority priority, int64_t now_ns) const;
+
+  /// Returns the waiting group to which a thread working on a group of class
+  /// `priority` should be handed off, or `nullptr`.
+  internal::IntrusivePtr<TaskGroup> FindHandoff(TaskPriority priority,
+                                                int64_t now_ns);
+
+ private:
+  void AddWaitingLocked(TaskGroup* group) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RemoveWaitingLocked(TaskGroup* group)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  std::vector<internal::IntrusivePtr<TaskGroup>> GetWaitingLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Returns whether any group is waiting, without acquiring a lock.
+  bool HasWaiting() const;
+
+  const size_t limit_;
+
+  absl::Mutex mutex_;
+  std::atomic<size_t> in_use_{0};
+  std::array<std::vector<internal::IntrusivePtr<TaskGroup>>,
+             kNumTaskPriorities>
+      waiting_ ABSL_GUARDED_BY(mutex_);
+
+  // For each class, the time at which a waiting group was last assigned a
+  // thread or the class became non-empty, or 0 if no group of the class is
+  // waiting.  Written under `mutex_`.
+  std::array<std::atomic<int64_t>, kNumTaskPriorities> wait_start_ns_{};
+};
+
 }  // namespace internal_thread_impl
 }  // namespace tensorstore
 
@@ -15,6 +15,7 @@
 #ifndef TENSORSTORE_INTERNAL_THREAD_TASK_PROVIDER_H_
 #define TENSORSTORE_INTERNAL_THREAD_TASK_PROVIDER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -22,6 +23,21 @@
 namespace tensorstore {
 namespace internal_thread_impl {
 
+/// Scheduling class of a `TaskProvider`.
+///
+/// `SharedThreadPool` assigns threads to providers of a more urgent class
+/// first, and providers of a less urgent class return their threads to the
+/// pool when providers of a more urgent class are waiting.
+enum class TaskPriority : uint8_t {
+  /// Latency-critical work, such as reads on behalf of an interactive user.
+  kInteractive = 0,
+  kNormal = 1,
+  /// Throughput-oriented work, such as bulk writeback or downsampling.
+  kBackground = 2,
+};
+
+constexpr size_t kNumTaskPriorities = 3;
+
 /// In conjunction with SharedThreadPool
 class TaskProvider : public internal::AtomicReferenceCount<TaskProvider> {
  public:
@@ -32,6 +48,9 @@ class TaskProvider : public internal::AtomicReferenceCount<TaskProvider> {
 
   /// Worker Method: Assign a thread to this task provider.
   virtual void DoWorkOnThread() = 0;
+
+  /// Returns the scheduling class, which must not change.
+  virtual TaskPriority priority() const { return TaskPriority::kNormal; }
 };
 
 }  // namespace internal_thread_impl
@@ -16,25 +16,48 @@
 
 #include <stddef.h>
 
+#include <array>
 #include <cassert>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/base/no_destructor.h"
+#include "absl/flags/flag.h"
 #include "absl/log/absl_log.h"
+#include "tensorstore/internal/env.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/os/numa.h"
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_group_impl.h"
 #include "tensorstore/internal/tracing/trace_context.h"
 #include "tensorstore/util/executor.h"
 
+ABSL_FLAG(std::optional<bool>, tensorstore_thread_pool_numa, std::nullopt,
+          "Pin thread pool workers to NUMA nodes. "
+          "Overrides TENSORSTORE_THREAD_POOL_NUMA.");
+
 namespace tensorstore {
 namespace internal {
 namespace {
 
+/// Returns the NUMA nodes to which thread pool workers are pinned, if enabled
+/// and the machine has more than one node.
+std::vector<internal_os::NumaNode> GetThreadPoolNumaNodes() {
+  if (!GetFlagOrEnvValue(FLAGS_tensorstore_thread_pool_numa,
+                         "TENSORSTORE_THREAD_POOL_NUMA")
+           .value_or(false)) {
+    return {};
+  }
+  auto nodes = internal_os::GetNumaNodes();
+  if (nodes.size() < 2) return {};
+  return nodes;
+}
+
 struct DetachedPoolImpl {
   internal::IntrusivePtr<internal_thread_impl::TaskGroup> task_group;
 
@@ -48,9 +71,7 @@ struct DetachedPoolImpl {
   }
 };
 
-Executor DefaultThreadPool(size_t num_threads) {
-  static absl::NoDestructor<internal_thread_impl::SharedThreadPool> pool_;
-  intrusive_ptr_increment(pool_.get());
+size_t GetThreadLimit(size_t num_threads) {
   if (num_threads == 0 || num_threads == std::numeric_limits<size_t>::max()) {
     // Threads are "unbounded"; that doesn't work so well, so put a bound on it.
     num_threads = std::thread::hardware_concurrency() * 16;
@@ -59,17 +80,38 @@ Executor DefaultThreadPool(size_t num_threads) {
         << "DetachedThreadPool should specify num_threads; using "
         << num_threads;
   }
+  return num_threads;
+}
 
+Executor DefaultThreadPool(
+    size_t num_threads, TaskPriority priority,
+    std::shared_ptr<internal_thread_impl::ThreadBudget> budget = nullptr) {
+  static absl::NoDestructor<internal_thread_impl::SharedThreadPool> pool_(
+      GetThreadPoolNumaNodes());
+  intrusive_ptr_increment(pool_.get());
   return DetachedPoolImpl{internal_thread_impl::TaskGroup::Make(
       internal::IntrusivePtr<internal_thread_impl::SharedThreadPool>(
           pool_.get()),
-      num_threads)};
+      num_threads, priority, std::move(budget))};
 }
 
 }  // namespace
 
-Executor DetachedThreadPool(size_t num_threads) {
-  return DefaultThreadPool(num_threads);
+Executor DetachedThreadPool(size_t num_threads, TaskPriority priority) {
+  return DefaultThreadPool(GetThreadLimit(num_threads), priority);
+}
+
+std::array<Executor, internal_thread_impl::kNumTaskPriorities>
+DetachedThreadPools(size_t num_threads) {
+  num_threads = GetThreadLimit(num_threads);
+  auto budget =
+      std::make_shared<internal_thread_impl::ThreadBudget>(num_threads);
+  std::array<Executor, internal_thread_impl::kNumTaskPriorities> executors;
+  for (size_t i = 0; i < executors.size(); ++i) {
+    executors[i] = DefaultThreadPool(
+        num_threads, static_cast<TaskPriority>(i), budget);
+  }
+  return executors;
 }
 
 }  // namespace internal
@@ -17,18 +17,33 @@
 
 #include <stddef.h>
 
+#include <array>
+
+#include "tensorstore/internal/thread/task_provider.h"
 #include "tensorstore/util/executor.h"
 
 namespace tensorstore {
 namespace internal {
 
+using TaskPriority = internal_thread_impl::TaskPriority;
+
 /// Returns a detached thread pool executor.
 ///
 /// The thread pool remains alive until the last copy of the returned executor
 /// is destroyed and all queued work has finished.
 ///
+/// All detached thread pools share a single set of threads; threads are
+/// assigned to pools of a more urgent `priority` first.
+///
 /// \param num_threads Maximum number of threads to use.
-Executor DetachedThreadPool(size_t num_threads);
+/// \param priority Scheduling class of the tasks.
+Executor DetachedThreadPool(size_t num_threads,
+                            TaskPriority priority = TaskPriority::kNormal);
+
+/// Returns a thread pool for each `TaskPriority`, indexed by priority, that
+/// together use at most `num_threads` threads.
+std::array<Executor, internal_thread_impl::kNumTaskPriorities>
+DetachedThreadPools(size_t num_threads);
 
 }  // namespace internal
 }  // namespace tensorstore
@@ -14,15 +14,19 @@
 
 #include "tensorstore/kvstore/byte_range.h"
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "tensorstore/serialization/serialization.h"
 #include "tensorstore/serialization/std_optional.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
@@ -59,6 +63,37 @@ Result<ByteRange> OptionalByteRangeRequest::Validate(int64_t size) const {
   return ByteRange{inclusive_min, exclusive_max};
 }
 
+namespace internal {
+
+absl::Cord OverwriteByteRanges(const absl::Cord& s, span<const ByteRange> ranges,
+                               absl::Cord data) {
+  absl::Cord result;
+  int64_t position = 0;
+  const int64_t size = static_cast<int64_t>(s.size());
+  for (const auto& range : ranges) {
+    assert(range.SatisfiesInvariants() && range.inclusive_min >= position);
+    if (position < size) {
+      result.Append(
+          s.Subcord(position, std::min(range.inclusive_min, size) - position));
+    }
+    // Fill any gap past the end of `s` with zero bytes.
+    const int64_t result_size = static_cast<int64_t>(result.size());
+    if (range.inclusive_min > result_size) {
+      result.Append(std::string(range.inclusive_min - result_size, '\0'));
+    }
+    result.Append(data.Subcord(0, range.size()));
+    data.RemovePrefix(range.size());
+    position = range.exclusive_max;
+  }
+  assert(data.empty());
+  if (position < size) {
+    result.Append(s.Subcord(position, size - position));
+  }
+  return result;
+}
+
+}  // namespace internal
+
 }  // namespace tensorstore
 
 TENSORSTORE_DEFINE_SERIALIZER_SPECIALIZATION(
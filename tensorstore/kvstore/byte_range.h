@@ -24,6 +24,7 @@
 #include "absl/strings/cord.h"
 #include "tensorstore/serialization/fwd.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 
@@ -199,6 +200,14 @@ inline absl::Cord GetSubCord(const absl::Cord& s, ByteRange r) {
   return s.Subcord(r.inclusive_min, r.size());
 }
 
+/// Returns `s` with each of `ranges` replaced by the corresponding consecutive
+/// bytes of `data`, as specified by `kvstore::WriteOptions::byte_ranges`.
+///
+/// \pre `ranges` are non-overlapping and in increasing order, and their total
+///     size equals `data.size()`.
+absl::Cord OverwriteByteRanges(const absl::Cord& s, span<const ByteRange> ranges,
+                               absl::Cord data);
+
 }  // namespace internal
 }  // namespace tensorstore
 
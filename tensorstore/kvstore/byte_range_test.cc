@@ -32,6 +32,7 @@ using ::tensorstore::MatchesStatus;
 using ::tensorstore::OptionalByteRangeRequest;
 using ::tensorstore::StrCat;
 using ::tensorstore::internal::GetSubCord;
+using ::tensorstore::internal::OverwriteByteRanges;
 using ::tensorstore::serialization::TestSerializationRoundTrip;
 
 TEST(ByteRangeTest, SatisfiesInvariants) {
@@ -174,6 +175,23 @@ TEST(GetSubStringTest, Basic) {
   EXPECT_EQ("abcde", GetSubCord(absl::Cord("abcde"), {0, 5}));
 }
 
+TEST(OverwriteByteRangesTest, Basic) {
+  const absl::Cord s("abcdef");
+  EXPECT_EQ("abcdef", OverwriteByteRanges(s, {}, absl::Cord()));
+  EXPECT_EQ("aXYdZf",
+            OverwriteByteRanges(s, {{ByteRange{1, 3}, ByteRange{4, 5}}},
+                                absl::Cord("XYZ")));
+  EXPECT_EQ("XbcdefY",
+            OverwriteByteRanges(s, {{ByteRange{0, 1}, ByteRange{6, 7}}},
+                                absl::Cord("XY")));
+  EXPECT_EQ(std::string("abcdeX\0\0Y", 9),
+            OverwriteByteRanges(s, {{ByteRange{5, 6}, ByteRange{8, 9}}},
+                                absl::Cord("XY")));
+  EXPECT_EQ(std::string("\0\0X", 3),
+            OverwriteByteRanges(absl::Cord(), {{ByteRange{2, 3}}},
+                                absl::Cord("X")));
+}
+
 TEST(ByteRangeSerializationTest, Basic) {
   TestSerializationRoundTrip(ByteRange{1, 5});
 }
@@ -0,0 +1,152 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/file/aligned_buffer_pool.h"
+
+#include <stddef.h>
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal_file_kvstore {
+
+struct AlignedBufferPool::Impl {
+  size_t alignment;
+  size_t max_cached_bytes;
+  absl::Mutex mutex;
+  // Set when the pool is destroyed; buffers released later are freed.
+  bool closed ABSL_GUARDED_BY(mutex) = false;
+  size_t cached_bytes ABSL_GUARDED_BY(mutex) = 0;
+  absl::flat_hash_map<size_t, std::vector<char*>> idle ABSL_GUARDED_BY(mutex);
+
+  char* New(size_t size) {
+    return static_cast<char*>(
+        ::operator new(size, std::align_val_t(alignment)));
+  }
+
+  void Delete(char* data, size_t size) {
+    ::operator delete(data, size, std::align_val_t(alignment));
+  }
+
+  char* Acquire(size_t size) {
+    {
+      absl::MutexLock lock(&mutex);
+      auto it = idle.find(size);
+      if (it != idle.end()) {
+        char* data = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty()) idle.erase(it);
+        cached_bytes -= size;
+        return data;
+      }
+    }
+    return New(size);
+  }
+
+  void Release(char* data, size_t size) {
+    {
+      absl::MutexLock lock(&mutex);
+      if (!closed && cached_bytes + size <= max_cached_bytes) {
+        idle[size].push_back(data);
+        cached_bytes += size;
+        return;
+      }
+    }
+    Delete(data, size);
+  }
+
+  void Close() {
+    absl::flat_hash_map<size_t, std::vector<char*>> to_free;
+    {
+      absl::MutexLock lock(&mutex);
+      closed = true;
+      cached_bytes = 0;
+      to_free.swap(idle);
+    }
+    for (auto& [size, buffers] : to_free) {
+      for (char* data : buffers) Delete(data, size);
+    }
+  }
+};
+
+AlignedBufferPool::AlignedBufferPool(size_t alignment, size_t max_cached_bytes)
+    : impl_(std::make_shared<Impl>()) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  impl_->alignment = alignment;
+  impl_->max_cached_bytes = max_cached_bytes;
+}
+
+AlignedBufferPool::~AlignedBufferPool() { impl_->Close(); }
+
+size_t AlignedBufferPool::alignment() const { return impl_->alignment; }
+
+AlignedBufferPool::Buffer AlignedBufferPool::Allocate(size_t size) {
+  const size_t alignment = impl_->alignment;
+  size = (size + alignment - 1) & ~(alignment - 1);
+  Buffer buffer;
+  if (size == 0) return buffer;
+  buffer.pool_ = impl_;
+  buffer.data_ = impl_->Acquire(size);
+  buffer.size_ = size;
+  return buffer;
+}
+
+AlignedBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : pool_(std::move(other.pool_)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+AlignedBufferPool::Buffer& AlignedBufferPool::Buffer::operator=(
+    Buffer&& other) noexcept {
+  if (this != &other) {
+    if (data_) pool_->Release(data_, size_);
+    pool_ = std::move(other.pool_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+AlignedBufferPool::Buffer::~Buffer() {
+  if (data_) pool_->Release(data_, size_);
+}
+
+absl::Cord AlignedBufferPool::Buffer::ToCord(size_t offset,
+                                             size_t length) && {
+  assert(offset + length <= size_);
+  if (length == 0) return absl::Cord();
+  struct Releaser {
+    std::shared_ptr<Impl> pool;
+    char* data;
+    size_t size;
+    void operator()(std::string_view) const { pool->Release(data, size); }
+  };
+  std::string_view value(data_ + offset, length);
+  Releaser releaser{std::move(pool_), std::exchange(data_, nullptr),
+                    std::exchange(size_, 0)};
+  return absl::MakeCordFromExternal(value, std::move(releaser));
+}
+
+}  // namespace internal_file_kvstore
+}  // namespace tensorstore
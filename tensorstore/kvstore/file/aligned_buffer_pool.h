@@ -0,0 +1,82 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_FILE_ALIGNED_BUFFER_POOL_H_
+#define TENSORSTORE_KVSTORE_FILE_ALIGNED_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "absl/strings/cord.h"
+
+namespace tensorstore {
+namespace internal_file_kvstore {
+
+/// Pool of aligned buffers, as required for direct I/O.
+///
+/// Buffers are recycled by exact capacity, since the sizes of chunk reads of a
+/// dataset tend to repeat, and are returned to the pool when released, which
+/// for a buffer converted to an `absl::Cord` happens when the last reference
+/// to the cord is dropped.  The pool may be destroyed while buffers are still
+/// outstanding.
+class AlignedBufferPool {
+ public:
+  class Buffer;
+
+  /// \param alignment Alignment of buffer addresses and capacities, must be a
+  ///     power of 2.
+  /// \param max_cached_bytes Maximum total capacity of idle buffers retained
+  ///     for reuse.
+  AlignedBufferPool(size_t alignment, size_t max_cached_bytes);
+  ~AlignedBufferPool();
+
+  size_t alignment() const;
+
+  /// Returns a buffer with a capacity of `size` rounded up to a multiple of
+  /// `alignment()`.
+  Buffer Allocate(size_t size);
+
+  struct Impl;
+
+ private:
+  std::shared_ptr<Impl> impl_;
+};
+
+/// Buffer obtained from `AlignedBufferPool::Allocate`.
+class AlignedBufferPool::Buffer {
+ public:
+  Buffer() = default;
+  Buffer(Buffer&& other) noexcept;
+  Buffer& operator=(Buffer&& other) noexcept;
+  ~Buffer();
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /// Returns a cord that references `[offset, offset + length)` of the
+  /// buffer, which is returned to the pool when the cord is destroyed.
+  absl::Cord ToCord(size_t offset, size_t length) &&;
+
+ private:
+  friend class AlignedBufferPool;
+  std::shared_ptr<Impl> pool_;
+  char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace internal_file_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_FILE_ALIGNED_BUFFER_POOL_H_
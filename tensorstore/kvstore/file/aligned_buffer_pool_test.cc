@@ -0,0 +1,71 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/file/aligned_buffer_pool.h"
+
+#include <stdint.h>
+
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+
+namespace {
+
+using ::tensorstore::internal_file_kvstore::AlignedBufferPool;
+
+TEST(AlignedBufferPoolTest, Allocate) {
+  AlignedBufferPool pool(4096, 1 << 20);
+  auto buffer = pool.Allocate(5000);
+  EXPECT_EQ(8192, buffer.size());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(buffer.data()) % 4096);
+  EXPECT_EQ(0, pool.Allocate(0).size());
+}
+
+TEST(AlignedBufferPoolTest, Reuse) {
+  AlignedBufferPool pool(512, 1 << 20);
+  char* data;
+  {
+    auto buffer = pool.Allocate(1000);
+    data = buffer.data();
+  }
+  // Only reused for the same capacity.
+  EXPECT_NE(data, pool.Allocate(2000).data());
+  EXPECT_EQ(data, pool.Allocate(1024).data());
+}
+
+TEST(AlignedBufferPoolTest, ToCord) {
+  std::optional<absl::Cord> cord;
+  char* data;
+  {
+    AlignedBufferPool pool(512, 1 << 20);
+    auto buffer = pool.Allocate(1024);
+    data = buffer.data();
+    std::memset(buffer.data(), 'x', buffer.size());
+    std::memcpy(buffer.data() + 100, "abc", 3);
+    cord = std::move(buffer).ToCord(100, 600);
+    EXPECT_EQ(600, cord->size());
+    EXPECT_EQ("abcxx", cord->Subcord(0, 5));
+
+    // The buffer is not reused while referenced by the cord.
+    EXPECT_NE(data, pool.Allocate(1024).data());
+    cord = absl::Cord(*cord).Subcord(1, 2);
+  }
+  // Outlives the pool.
+  EXPECT_EQ("bc", *cord);
+}
+
+}  // namespace
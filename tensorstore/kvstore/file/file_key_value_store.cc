@@ -80,6 +80,12 @@
 /// 8. `fsync` the parent directory of the file (to ensure the `unlink` or
 ///    `rename` operations are durable).  This step is skipped on MS Windows,
 ///    where `fsync` is not supported for directories.
+///
+/// When `file_io_group_commit` specifies a log directory, the write or delete
+/// is instead committed to a write-ahead log after step 4, and the `fsync`
+/// calls of steps 6b and 8 are skipped.  Concurrent writes are committed to
+/// the log together, and the applied files are synced in the background
+/// before the log is truncated, see `write_ahead_log.h`.
 
 #include <stddef.h>
 #include <stdint.h>
@@ -87,15 +93,19 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>  // IWYU pragma: keep for std::get<>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"  // IWYU pragma: keep
 #include "absl/log/absl_log.h"
@@ -115,15 +125,19 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/os/cwd.h"
 #include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/internal/os/io_uring.h"
 #include "tensorstore/internal/os/unique_handle.h"
 #include "tensorstore/internal/path.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/common_metrics.h"
+#include "tensorstore/kvstore/file/aligned_buffer_pool.h"
 #include "tensorstore/kvstore/file/file_resource.h"
 #include "tensorstore/kvstore/file/util.h"
+#include "tensorstore/kvstore/file/write_ahead_log.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/operations.h"
@@ -205,10 +219,14 @@ struct FileKeyValueStoreSpecData {
   Context::Resource<FileIoSyncResource> file_io_sync;
   Context::Resource<FileIoMemmapResource> file_io_memmap;
   Context::Resource<FileIoLockingResource> file_io_locking;
+  Context::Resource<FileIoUringResource> file_io_uring;
+  Context::Resource<FileIoDirectResource> file_io_direct;
+  Context::Resource<FileIoGroupCommitResource> file_io_group_commit;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(x.file_io_concurrency, x.file_io_sync, x.file_io_memmap,
-             x.file_io_locking);
+             x.file_io_locking, x.file_io_uring, x.file_io_direct,
+             x.file_io_group_commit);
   };
 
   // TODO(jbms): Storing a UNIX path as a JSON string presents a challenge
@@ -235,7 +253,14 @@ struct FileKeyValueStoreSpecData {
       jb::Member(FileIoMemmapResource::id,
                  jb::Projection<&FileKeyValueStoreSpecData::file_io_memmap>()),
       jb::Member(FileIoLockingResource::id,
-                 jb::Projection<&FileKeyValueStoreSpecData::file_io_locking>())
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_locking>()),
+      jb::Member(FileIoUringResource::id,
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_uring>()),
+      jb::Member(FileIoDirectResource::id,
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_direct>()),
+      jb::Member(
+          FileIoGroupCommitResource::id,
+          jb::Projection<&FileKeyValueStoreSpecData::file_io_group_commit>())
       //
   );
 };
@@ -290,12 +315,36 @@ class FileKeyValueStore
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
     return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+           SupportedFeatures::kAtomicWriteWithoutOverwrite |
+           SupportedFeatures::kPartialWrite;
   }
 
   bool sync() const { return *spec_.file_io_sync; }
   bool memmap() const { return *spec_.file_io_memmap; }
 
+  /// Returns the io_uring pool used for batch reads, or `nullptr`.
+  internal_os::IoUringPool* io_uring_pool() const {
+    return spec_.file_io_uring->pool.get();
+  }
+
+  /// Returns the buffer pool used for direct I/O, or `nullptr` if direct I/O
+  /// is not enabled.
+  const std::shared_ptr<AlignedBufferPool>& direct_io_pool() const {
+    return spec_.file_io_direct->pool;
+  }
+
+  /// Returns the write-ahead log used for group commit, or `nullptr` if group
+  /// commit is not enabled.
+  const std::shared_ptr<WriteAheadLog>& write_ahead_log() const {
+    return spec_.file_io_group_commit->log;
+  }
+
+  /// Returns the write-ahead log through which writes are made durable, or
+  /// `nullptr` if writes are synced individually (or not synced).
+  std::shared_ptr<WriteAheadLog> sync_write_ahead_log() const {
+    return sync() ? write_ahead_log() : nullptr;
+  }
+
   FileIoLockingResource::Spec file_io_locking() const {
     return *spec_.file_io_locking;
   }
@@ -433,6 +482,49 @@ Result<absl::Cord> ReadFromFileDescriptor(FileDescriptor fd,
   return std::move(buffer).Build();
 }
 
+/// Returns `byte_range` widened to a multiple of `alignment`, as required for
+/// direct I/O.
+ByteRange GetDirectIoReadRange(ByteRange byte_range, int64_t alignment) {
+  return ByteRange{
+      byte_range.inclusive_min / alignment * alignment,
+      (byte_range.exclusive_max + alignment - 1) / alignment * alignment};
+}
+
+/// Same as `ReadFromFileDescriptor`, but for a file descriptor with direct I/O
+/// enabled.  The aligned read range is read into a buffer from `pool`, and
+/// the returned cord references the requested portion of it.
+Result<absl::Cord> ReadDirectFromFileDescriptor(FileDescriptor fd,
+                                                ByteRange byte_range,
+                                                AlignedBufferPool& pool) {
+  assert(fd != internal_os::FileDescriptorTraits::Invalid());
+  if (byte_range.size() == 0) return absl::Cord();
+  file_metrics.batch_read.Increment();
+  absl::Time start_time = absl::Now();
+  const int64_t alignment = pool.alignment();
+  const ByteRange read_range = GetDirectIoReadRange(byte_range, alignment);
+  auto buffer = pool.Allocate(read_range.size());
+  // The aligned range may extend past the end of the file.
+  const size_t min_size = byte_range.exclusive_max - read_range.inclusive_min;
+  size_t offset = 0;
+  while (offset < min_size) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n, internal_os::ReadFromFile(fd, buffer.data() + offset,
+                                          read_range.size() - offset,
+                                          read_range.inclusive_min + offset));
+    file_metrics.bytes_read.IncrementBy(n);
+    offset += n;
+    // Direct I/O cannot continue at an unaligned offset, which only results
+    // from reaching the end of the file.
+    if (n == 0 || (offset < min_size && offset % alignment != 0)) {
+      return absl::UnavailableError("Length changed while reading");
+    }
+  }
+  file_metrics.read_latency_ms.Observe(
+      absl::ToInt64Milliseconds(absl::Now() - start_time));
+  return std::move(buffer).ToCord(
+      byte_range.inclusive_min - read_range.inclusive_min, byte_range.size());
+}
+
 class BatchReadTask;
 using BatchReadTaskBase = internal_kvstore_batch::BatchReadEntry<
     FileKeyValueStore,
@@ -448,6 +540,8 @@ class BatchReadTask final
   TimestampedStorageGeneration stamp_;
   UniqueFileDescriptor fd_;
   int64_t size_;
+  // Set if direct I/O is enabled for `fd_`.
+  AlignedBufferPool* direct_io_pool_ = nullptr;
 
  public:
   BatchReadTask(BatchEntryKey&& batch_entry_key_)
@@ -467,7 +561,10 @@ class BatchReadTask final
   Result<kvstore::ReadResult> DoByteRangeRead(ByteRange byte_range) {
     absl::Cord value;
     TENSORSTORE_ASSIGN_OR_RETURN(
-        value, ReadFromFileDescriptor(fd_.get(), byte_range),
+        value,
+        direct_io_pool_ ? ReadDirectFromFileDescriptor(fd_.get(), byte_range,
+                                                       *direct_io_pool_)
+                        : ReadFromFileDescriptor(fd_.get(), byte_range),
         tensorstore::MaybeAnnotateStatus(_, "Error reading from open file"));
     return kvstore::ReadResult::Value(std::move(value), stamp_);
   }
@@ -495,7 +592,19 @@ class BatchReadTask final
 
     if (requests.empty()) return;
 
-    if (driver().memmap()) {
+    if (auto* pool = driver().direct_io_pool().get()) {
+      if (auto status = internal_os::SetDirectIo(fd_.get(), true);
+          status.ok()) {
+        direct_io_pool_ = pool;
+      } else {
+        // Fall back to buffered reads, e.g. if not supported by the
+        // filesystem.
+        ABSL_LOG_IF(INFO, verbose_logging)
+            << "Direct I/O not enabled: " << status;
+      }
+    }
+
+    if (driver().memmap() && !direct_io_pool_) {
       // Extract the bounds for all requests.
       int64_t exclusive_max = 0;
       int64_t inclusive_min = std::numeric_limits<int64_t>::max();
@@ -552,10 +661,19 @@ class BatchReadTask final
       return;
     }
 
-    const auto& executor = driver().executor();
-
     internal_kvstore_batch::CoalescingOptions coalescing_options;
     coalescing_options.max_extra_read_bytes = 255;
+
+    if (auto* pool = driver().io_uring_pool()) {
+      if (auto ring = pool->Acquire()) {
+        ProcessIoUringReads(*ring, coalescing_options);
+        pool->Release(std::move(ring));
+        return;
+      }
+      // Otherwise, io_uring is not supported; fall back to the ::read path.
+    }
+
+    const auto& executor = driver().executor();
     internal_kvstore_batch::ForEachCoalescedRequest<Request>(
         requests, coalescing_options,
         [&](ByteRange coalesced_byte_range,
@@ -569,6 +687,89 @@ class BatchReadTask final
         });
   }
 
+  /// Reads all coalesced byte ranges of the batch with a single io_uring
+  /// submission (per `queue_depth` reads), and resolves the requests from
+  /// the completions.
+  void ProcessIoUringReads(
+      internal_os::IoUring& ring,
+      const internal_kvstore_batch::CoalescingOptions& coalescing_options) {
+    struct CoalescedRead {
+      ByteRange byte_range;
+      tensorstore::span<Request> requests;
+      // Range actually read, which differs from `byte_range` for direct I/O.
+      ByteRange read_range;
+      // Only one of the buffers is used, depending on `direct_io_pool_`.
+      internal::FlatCordBuilder buffer;
+      AlignedBufferPool::Buffer aligned_buffer;
+    };
+    std::vector<CoalescedRead> coalesced_reads;
+    internal_kvstore_batch::ForEachCoalescedRequest<Request>(
+        request_batch.requests, coalescing_options,
+        [&](ByteRange coalesced_byte_range,
+            tensorstore::span<Request> coalesced_requests) {
+          auto& coalesced_read = coalesced_reads.emplace_back();
+          coalesced_read.byte_range = coalesced_byte_range;
+          coalesced_read.requests = coalesced_requests;
+          if (direct_io_pool_) {
+            coalesced_read.read_range = GetDirectIoReadRange(
+                coalesced_byte_range, direct_io_pool_->alignment());
+            coalesced_read.aligned_buffer =
+                direct_io_pool_->Allocate(coalesced_read.read_range.size());
+          } else {
+            coalesced_read.read_range = coalesced_byte_range;
+            coalesced_read.buffer =
+                internal::FlatCordBuilder(coalesced_byte_range.size(), false);
+          }
+        });
+
+    std::vector<internal_os::IoUringRead> reads(coalesced_reads.size());
+    for (size_t i = 0; i < coalesced_reads.size(); ++i) {
+      auto& coalesced_read = coalesced_reads[i];
+      reads[i].buf = direct_io_pool_ ? coalesced_read.aligned_buffer.data()
+                                     : coalesced_read.buffer.data();
+      reads[i].count = coalesced_read.read_range.size();
+      reads[i].offset = coalesced_read.read_range.inclusive_min;
+      reads[i].min_count = coalesced_read.byte_range.exclusive_max -
+                           coalesced_read.read_range.inclusive_min;
+    }
+
+    file_metrics.batch_read.IncrementBy(reads.size());
+    absl::Time start_time = absl::Now();
+    ring.ReadAll(fd_.get(), reads);
+    file_metrics.read_latency_ms.Observe(
+        absl::ToInt64Milliseconds(absl::Now() - start_time));
+
+    for (size_t i = 0; i < coalesced_reads.size(); ++i) {
+      auto& coalesced_read = coalesced_reads[i];
+      auto& read = reads[i];
+      file_metrics.bytes_read.IncrementBy(read.bytes_read);
+      absl::Status status = read.status;
+      if (status.ok() && read.bytes_read < read.min_count) {
+        status = absl::UnavailableError("Length changed while reading");
+      }
+      if (!status.ok()) {
+        internal_kvstore_batch::SetCommonResult(
+            coalesced_read.requests,
+            tensorstore::MaybeAnnotateStatus(status,
+                                             "Error reading from open file"));
+        continue;
+      }
+      absl::Cord value;
+      if (direct_io_pool_) {
+        value = std::move(coalesced_read.aligned_buffer)
+                    .ToCord(coalesced_read.byte_range.inclusive_min -
+                                coalesced_read.read_range.inclusive_min,
+                            coalesced_read.byte_range.size());
+      } else {
+        coalesced_read.buffer.set_inuse(read.bytes_read);
+        value = std::move(coalesced_read.buffer).Build();
+      }
+      internal_kvstore_batch::ResolveCoalescedRequests(
+          coalesced_read.byte_range, coalesced_read.requests,
+          kvstore::ReadResult::Value(std::move(value), stamp_));
+    }
+  }
+
   void ProcessCoalescedRead(ByteRange coalesced_byte_range,
                             tensorstore::span<Request> coalesced_requests) {
     TENSORSTORE_ASSIGN_OR_RETURN(auto read_result,
@@ -593,10 +794,53 @@ Future<ReadResult> FileKeyValueStore::Read(Key key, ReadOptions options) {
 
 /// ----------------------------------------------------------------------------
 
+/// Writes the largest prefix of `value` that is a multiple of the alignment of
+/// `pool` with direct I/O, and removes it from `value`.  The remainder must be
+/// written with buffered I/O, since a direct I/O write cannot write a partial
+/// block.  If direct I/O is not supported, nothing is written.
+absl::Status WriteDirectPrefix(FileDescriptor fd, absl::Cord& value,
+                               AlignedBufferPool& pool) {
+  // Limits the size of the aligned buffer used to copy `value`.
+  constexpr size_t kMaxDirectWriteSize = 4 * 1024 * 1024;
+  const size_t alignment = pool.alignment();
+  const size_t size = value.size() / alignment * alignment;
+  if (size == 0) return absl::OkStatus();
+  if (auto status = internal_os::SetDirectIo(fd, true); !status.ok()) {
+    ABSL_LOG_IF(INFO, verbose_logging) << "Direct I/O not enabled: " << status;
+    return absl::OkStatus();
+  }
+  auto buffer = pool.Allocate(std::min(size, kMaxDirectWriteSize));
+  for (size_t offset = 0; offset < size;) {
+    const size_t n = std::min(buffer.size(), size - offset);
+    size_t buffer_offset = 0;
+    for (std::string_view chunk : value.Subcord(offset, n).Chunks()) {
+      std::memcpy(buffer.data() + buffer_offset, chunk.data(), chunk.size());
+      buffer_offset += chunk.size();
+    }
+    for (size_t written = 0; written < n;) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto m, internal_os::WriteToFile(fd, buffer.data() + written,
+                                           n - written));
+      file_metrics.bytes_written.IncrementBy(m);
+      written += m;
+    }
+    offset += n;
+  }
+  value.RemovePrefix(size);
+  return internal_os::SetDirectIo(fd, false);
+}
+
 absl::Status WriteWithSync(FileDescriptor fd, const std::string& fd_path,
-                           absl::Cord value, bool sync) {
+                           absl::Cord value, bool sync,
+                           AlignedBufferPool* direct_io_pool) {
   assert(fd != internal_os::FileDescriptorTraits::Invalid());
   auto start_write = absl::Now();
+  if (direct_io_pool) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        WriteDirectPrefix(fd, value, *direct_io_pool),
+        MaybeAnnotateStatus(
+            _, absl::StrCat("Failed writing: ", QuoteString(fd_path))));
+  }
   while (!value.empty()) {
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto n, internal_os::WriteCordToFile(fd, value),
@@ -614,6 +858,61 @@ absl::Status WriteWithSync(FileDescriptor fd, const std::string& fd_path,
   return absl::OkStatus();
 }
 
+/// Returns the absolute, normalized form of `path`, as recorded in the
+/// write-ahead log, which may be replayed by a process with a different
+/// working directory.
+Result<std::string> GetWriteAheadLogPath(std::string_view path) {
+  bool absolute = absl::StartsWith(path, "/");
+#ifdef _WIN32
+  absolute = absolute || absl::StartsWith(path, "\\") ||
+             (path.size() >= 2 && path[1] == ':');
+#endif
+  if (absolute) return internal::LexicalNormalizePath(std::string(path));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto cwd, internal_os::GetCwd());
+  return internal::LexicalNormalizePath(internal::JoinPath(cwd, path));
+}
+
+/// Commits a record to `wal` indicating that the record for `wal_path`
+/// committed to `segment` failed to apply, such that it is not replayed after
+/// a crash.
+void AbortWriteAheadLogRecord(WriteAheadLog& wal, uint64_t segment,
+                              const std::string& wal_path,
+                              const Executor& executor) {
+  auto abort_segment =
+      wal.Commit(WriteAheadLogRecord{wal_path, std::nullopt, segment});
+  if (!abort_segment.ok()) {
+    ABSL_LOG(WARNING) << "Failed to abort write-ahead log record for "
+                      << QuoteString(wal_path) << ": "
+                      << abort_segment.status();
+    return;
+  }
+  wal.Applied(*abort_segment, executor);
+}
+
+/// Acquires the lock file of `full_path`, which also serves as the temporary
+/// file to which a new value is written before it is renamed to `full_path`.
+Result<internal_os::FileLock> AcquireWriteLock(
+    const std::string& full_path,
+    const FileIoLockingResource::Spec& file_io_locking) {
+  switch (file_io_locking.mode) {
+    case FileIoLockingResource::LockingMode::none: {
+      // This will generate a unique "lock" file without waiting or
+      // attempting to cleanup.
+      absl::InsecureBitGen rng;
+      uint64_t x = absl::Uniform<uint64_t>(rng);
+      return AcquireExclusiveFile(
+          absl::StrCat(full_path, "_", absl::Hex(x), kLockSuffix),
+          absl::ZeroDuration());
+    }
+    case FileIoLockingResource::LockingMode::os:
+      return AcquireFileLock(absl::StrCat(full_path, kLockSuffix));
+    case FileIoLockingResource::LockingMode::lockfile:
+      return AcquireExclusiveFile(absl::StrCat(full_path, kLockSuffix),
+                                  file_io_locking.acquire_timeout);
+  }
+  ABSL_UNREACHABLE();
+}
+
 /// Implements `FileKeyValueStore::Write`.
 struct WriteTask {
   std::string full_path;
@@ -621,34 +920,28 @@ struct WriteTask {
   kvstore::WriteOptions options;
   bool sync;
   FileIoLockingResource::Spec file_io_locking;
+  std::shared_ptr<AlignedBufferPool> direct_io_pool;
+
+  /// Log to which the write is committed before it is applied, in place of
+  /// syncing the file and its parent directory.
+  std::shared_ptr<WriteAheadLog> wal;
+  Executor executor;
 
   Result<TimestampedStorageGeneration> operator()() const {
     ABSL_LOG_IF(INFO, verbose_logging) << "WriteTask " << full_path;
     TimestampedStorageGeneration r;
     r.time = absl::Now();
     TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
+    std::string wal_path;
+    if (wal) {
+      TENSORSTORE_ASSIGN_OR_RETURN(wal_path, GetWriteAheadLogPath(full_path));
+    }
 
-    TENSORSTORE_ASSIGN_OR_RETURN(
-        auto lock_helper, [&]() -> Result<internal_os::FileLock> {
-          switch (file_io_locking.mode) {
-            case FileIoLockingResource::LockingMode::none: {
-              // This will generate a unique "lock" file without waiting or
-              // attempting to cleanup.
-              absl::InsecureBitGen rng;
-              uint64_t x = absl::Uniform<uint64_t>(rng);
-              return AcquireExclusiveFile(
-                  absl::StrCat(full_path, "_", absl::Hex(x), kLockSuffix),
-                  absl::ZeroDuration());
-            }
-            case FileIoLockingResource::LockingMode::os:
-              return AcquireFileLock(absl::StrCat(full_path, kLockSuffix));
-            case FileIoLockingResource::LockingMode::lockfile:
-              return AcquireExclusiveFile(absl::StrCat(full_path, kLockSuffix),
-                                          file_io_locking.acquire_timeout);
-          }
-        }());
+    TENSORSTORE_ASSIGN_OR_RETURN(auto lock_helper,
+                                 AcquireWriteLock(full_path, file_io_locking));
 
     bool delete_lock_file = true;
+    std::optional<uint64_t> wal_segment;
 
     absl::Status status = [&]() {
       // Check condition.
@@ -662,18 +955,31 @@ struct WriteTask {
           return absl::OkStatus();
         }
       }
-      TENSORSTORE_RETURN_IF_ERROR(WriteWithSync(
-          lock_helper.fd(), lock_helper.lock_path(), value, sync));
+      TENSORSTORE_RETURN_IF_ERROR(
+          WriteWithSync(lock_helper.fd(), lock_helper.lock_path(), value,
+                        sync && !wal, direct_io_pool.get()));
       // Stat and Rename
       FileInfo info;
       TENSORSTORE_RETURN_IF_ERROR(
           internal_os::GetFileInfo(lock_helper.fd(), &info));
-      TENSORSTORE_RETURN_IF_ERROR(internal_os::RenameOpenFile(
-          lock_helper.fd(), lock_helper.lock_path(), full_path));
+      if (wal) {
+        // The record is committed only once the new contents have been
+        // written, such that only the rename remains to be replayed.
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            wal_segment, wal->Commit(WriteAheadLogRecord{wal_path, value}));
+      }
+      auto rename_status = internal_os::RenameOpenFile(
+          lock_helper.fd(), lock_helper.lock_path(), full_path);
+      if (!rename_status.ok()) {
+        if (wal_segment) {
+          AbortWriteAheadLogRecord(*wal, *wal_segment, wal_path, executor);
+        }
+        return rename_status;
+      }
 
       delete_lock_file = false;
       r.generation = GetFileGeneration(info);
-      if (sync) {
+      if (sync && !wal) {
         // fsync the parent directory to ensure the `rename` is durable.
         TENSORSTORE_RETURN_IF_ERROR(
             internal_os::FsyncDirectory(dir_fd.get()),
@@ -695,6 +1001,9 @@ struct WriteTask {
       // Close the lock file.
       std::move(lock_helper).Close();
     }
+    if (wal_segment) {
+      wal->Applied(*wal_segment, executor);
+    }
     if (!status.ok()) {
       // If status is absl::NotFound error, that likely means that the rename
       // failed.
@@ -704,6 +1013,149 @@ struct WriteTask {
   }
 };
 
+/// Copies the first `size` bytes of `source` to the current position of
+/// `dest`.
+absl::Status CopyFileContents(FileDescriptor source, FileDescriptor dest,
+                              int64_t size) {
+  constexpr size_t kBufferSize = 1024 * 1024;
+  std::unique_ptr<char[]> buffer(
+      new char[std::min<int64_t>(kBufferSize, std::max<int64_t>(size, 1))]);
+  int64_t offset = 0;
+  while (offset < size) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n, internal_os::ReadFromFile(
+                    source, buffer.get(),
+                    std::min<int64_t>(kBufferSize, size - offset), offset));
+    if (n == 0) break;
+    for (ptrdiff_t written = 0; written < n;) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto m,
+          internal_os::WriteToFile(dest, buffer.get() + written, n - written));
+      file_metrics.bytes_written.IncrementBy(m);
+      written += m;
+    }
+    offset += n;
+  }
+  return absl::OkStatus();
+}
+
+/// Implements `FileKeyValueStore::Write` with `WriteOptions::byte_ranges`.
+///
+/// The existing file is copied to the temporary (lock) file, the byte ranges
+/// are written to the copy, and the copy is renamed over the existing file,
+/// as for a write of the entire value.  Readers, and the file after a crash or
+/// a failed write, therefore observe either the old or the new contents, never
+/// a partially updated file.  The caller still avoids reading and re-encoding
+/// the unmodified parts of the value.
+struct PartialWriteTask {
+  std::string full_path;
+  absl::Cord value;
+  kvstore::WriteOptions options;
+  bool sync;
+  FileIoLockingResource::Spec file_io_locking;
+
+  /// Log that is checkpointed before the file is replaced, if group commit is
+  /// enabled.  The partial write itself is not logged, and is instead made
+  /// durable before it completes.
+  std::shared_ptr<WriteAheadLog> wal;
+
+  Result<TimestampedStorageGeneration> operator()() const {
+    ABSL_LOG_IF(INFO, verbose_logging) << "PartialWriteTask " << full_path;
+    TimestampedStorageGeneration r;
+    r.time = absl::Now();
+    TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
+    TENSORSTORE_ASSIGN_OR_RETURN(auto lock_helper,
+                                 AcquireWriteLock(full_path, file_io_locking));
+
+    bool delete_lock_file = true;
+    absl::Status status = [&]() {
+      if (wal) {
+        // Retire any logged write of the file, which would otherwise be
+        // replayed over the partial write after a crash.
+        TENSORSTORE_ASSIGN_OR_RETURN(auto wal_path,
+                                     GetWriteAheadLogPath(full_path));
+        TENSORSTORE_RETURN_IF_ERROR(wal->Checkpoint(
+            [&](std::string_view path) { return path == wal_path; }));
+      }
+      StorageGeneration generation;
+      int64_t size;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor value_fd,
+          OpenValueFile(full_path, &generation, &size));
+      if (!value_fd.valid()) {
+        if (!StorageGeneration::IsUnknown(
+                options.generation_conditions.if_equal)) {
+          r.generation = StorageGeneration::Unknown();
+          return absl::OkStatus();
+        }
+        return absl::NotFoundError(
+            absl::StrCat("File not found: ", QuoteString(full_path)));
+      }
+      if (!options.generation_conditions.Matches(generation)) {
+        r.generation = StorageGeneration::Unknown();
+        return absl::OkStatus();
+      }
+      TENSORSTORE_RETURN_IF_ERROR(
+          CopyFileContents(value_fd.get(), lock_helper.fd(), size),
+          MaybeAnnotateStatus(_, absl::StrCat("Failed copying: ",
+                                              QuoteString(full_path))));
+      absl::Cord remaining = value;
+      for (const auto& range : options.byte_ranges) {
+        int64_t offset = range.inclusive_min;
+        for (std::string_view chunk :
+             remaining.Subcord(0, range.size()).Chunks()) {
+          while (!chunk.empty()) {
+            TENSORSTORE_ASSIGN_OR_RETURN(
+                auto n,
+                internal_os::WriteToFileAt(lock_helper.fd(), chunk.data(),
+                                           chunk.size(), offset),
+                MaybeAnnotateStatus(
+                    _, absl::StrCat("Failed writing: ",
+                                    QuoteString(lock_helper.lock_path()))));
+            file_metrics.bytes_written.IncrementBy(n);
+            chunk.remove_prefix(n);
+            offset += n;
+          }
+        }
+        remaining.RemovePrefix(range.size());
+      }
+      // The write is not logged, so it must be durable before the rename
+      // whenever the log is, too.
+      const bool sync_value = sync || wal;
+      if (sync_value) {
+        TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFile(lock_helper.fd()));
+      }
+      FileInfo info;
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_os::GetFileInfo(lock_helper.fd(), &info));
+      TENSORSTORE_RETURN_IF_ERROR(internal_os::RenameOpenFile(
+          lock_helper.fd(), lock_helper.lock_path(), full_path));
+      delete_lock_file = false;
+      r.generation = GetFileGeneration(info);
+      if (sync_value) {
+        // fsync the parent directory to ensure the `rename` is durable.
+        TENSORSTORE_RETURN_IF_ERROR(
+            internal_os::FsyncDirectory(dir_fd.get()),
+            MaybeAnnotateStatus(
+                _, absl::StrCat("Error calling fsync on parent directory of: ",
+                                full_path)));
+      }
+      return absl::OkStatus();
+    }();
+
+    if (delete_lock_file) {
+      // Delete the temporary file, leaving the existing file unmodified.
+      auto delete_status = std::move(lock_helper).Delete();
+      ABSL_LOG_IF(INFO, !delete_status.ok() && verbose_logging)
+          << "PartialWrite: " << delete_status;
+    } else {
+      std::move(lock_helper).Close();
+    }
+    if (!status.ok()) return status;
+    return r;
+  }
+};
+
 /// Implements `FileKeyValueStore::Delete`.
 struct DeleteTask {
   std::string full_path;
@@ -711,12 +1163,21 @@ struct DeleteTask {
   bool sync;
   FileIoLockingResource::Spec file_io_locking;
 
+  /// Log to which the delete is committed before it is applied, in place of
+  /// syncing the parent directory.
+  std::shared_ptr<WriteAheadLog> wal;
+  Executor executor;
+
   Result<TimestampedStorageGeneration> operator()() const {
     ABSL_LOG_IF(INFO, verbose_logging) << "DeleteTask " << full_path;
     TimestampedStorageGeneration r;
     r.time = absl::Now();
 
     TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
+    std::string wal_path;
+    if (wal) {
+      TENSORSTORE_ASSIGN_OR_RETURN(wal_path, GetWriteAheadLogPath(full_path));
+    }
 
     std::optional<internal_os::FileLock> lock_helper;
     if (file_io_locking.mode == FileIoLockingResource::LockingMode::lockfile) {
@@ -730,6 +1191,7 @@ struct DeleteTask {
     }
 
     bool fsync_directory = false;
+    std::optional<uint64_t> wal_segment;
     auto generation_result = [&]() -> Result<StorageGeneration> {
       // Check condition.
       if (!StorageGeneration::IsUnknown(
@@ -741,13 +1203,24 @@ struct DeleteTask {
           return StorageGeneration::Unknown();
         }
       }
+      if (wal) {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            wal_segment,
+            wal->Commit(WriteAheadLogRecord{wal_path, std::nullopt}));
+      }
       auto status = internal_os::DeleteFile(full_path);
       if (!status.ok() && !absl::IsNotFound(status)) {
+        if (wal_segment) {
+          AbortWriteAheadLogRecord(*wal, *wal_segment, wal_path, executor);
+        }
         return status;
       }
-      fsync_directory = sync;
+      fsync_directory = sync && !wal;
       return StorageGeneration::NoValue();
     }();
+    if (wal_segment) {
+      wal->Applied(*wal_segment, executor);
+    }
 
     // Delete the lock file.
     if (lock_helper) {
@@ -770,17 +1243,41 @@ struct DeleteTask {
   }
 };
 
+/// Durably applies a record that remains in the write-ahead log after a
+/// crash.
+absl::Status ReplayWriteAheadLogRecord(
+    const WriteAheadLogRecord& record,
+    FileIoLockingResource::Spec file_io_locking) {
+  if (record.value) {
+    return WriteTask{record.path, *record.value, {}, /*sync=*/true,
+                     file_io_locking}()
+        .status();
+  }
+  return DeleteTask{record.path, {}, /*sync=*/true, file_io_locking}()
+      .status();
+}
+
 Future<TimestampedStorageGeneration> FileKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   file_metrics.write.Increment();
   TENSORSTORE_RETURN_IF_ERROR(ValidateKey(key));
-  if (value) {
+  if (value && !options.byte_ranges.empty()) {
     return MapFuture(executor(),
-                     WriteTask{std::move(key), std::move(*value),
-                               std::move(options), sync(), file_io_locking()});
+                     PartialWriteTask{std::move(key), std::move(*value),
+                                      std::move(options), sync(),
+                                      file_io_locking(), write_ahead_log()});
+  }
+  if (value) {
+    return MapFuture(
+        executor(),
+        WriteTask{std::move(key), std::move(*value), std::move(options), sync(),
+                  file_io_locking(), direct_io_pool(), sync_write_ahead_log(),
+                  executor()});
   } else {
-    return MapFuture(executor(), DeleteTask{std::move(key), std::move(options),
-                                            sync(), file_io_locking()});
+    return MapFuture(executor(),
+                     DeleteTask{std::move(key), std::move(options), sync(),
+                                file_io_locking(), sync_write_ahead_log(),
+                                executor()});
   }
 }
 
@@ -789,11 +1286,23 @@ Future<TimestampedStorageGeneration> FileKeyValueStore::Write(
 /// Implements `FileKeyValueStore::DeleteRange`.
 struct DeleteRangeTask {
   KeyRange range;
+  std::shared_ptr<WriteAheadLog> wal;
 
   // TODO(jbms): Add fsync support
 
   void operator()(Promise<void> promise) {
     ABSL_LOG_IF(INFO, verbose_logging) << "DeleteRangeTask " << range;
+    if (wal) {
+      // Retire logged writes, which would otherwise be replayed after a
+      // crash, undoing the deletions.  The logged paths are absolute, so all
+      // records are treated as affected rather than matched against `range`.
+      if (auto status =
+              wal->Checkpoint([](std::string_view path) { return true; });
+          !status.ok()) {
+        promise.SetResult(MakeResult(std::move(status)));
+        return;
+      }
+    }
     std::string prefix(internal_file_util::LongestDirectoryPrefix(range));
     absl::Status delete_status;
     auto status = internal_os::RecursiveFileList(
@@ -834,7 +1343,8 @@ Future<const void> FileKeyValueStore::DeleteRange(KeyRange range) {
   if (range.empty()) return absl::OkStatus();  // Converted to a ReadyFuture.
   TENSORSTORE_RETURN_IF_ERROR(ValidateKeyRange(range));
   return PromiseFuturePair<void>::Link(
-             WithExecutor(executor(), DeleteRangeTask{std::move(range)}))
+             WithExecutor(executor(), DeleteRangeTask{std::move(range),
+                                                      write_ahead_log()}))
       .future;
 }
 
@@ -903,7 +1413,18 @@ Future<kvstore::DriverPtr> FileKeyValueStoreSpec::DoOpen() const {
   std::cout << "FileKeyValueStoreSpec:: DoOpen" << std::endl;
   auto driver_ptr = internal::MakeIntrusivePtr<FileKeyValueStore>();
   driver_ptr->spec_ = data_;
-  return driver_ptr;
+  if (!driver_ptr->write_ahead_log()) return driver_ptr;
+  // Replay any writes that remain in the log from a previous process.
+  return MapFuture(
+      driver_ptr->executor(),
+      [driver_ptr]() -> Result<kvstore::DriverPtr> {
+        TENSORSTORE_RETURN_IF_ERROR(driver_ptr->write_ahead_log()->Recover(
+            [&](const WriteAheadLogRecord& record) {
+              return ReplayWriteAheadLogRecord(record,
+                                               driver_ptr->file_io_locking());
+            }));
+        return driver_ptr;
+      });
 }
 
 Result<kvstore::Spec> ParseFileUrl(std::string_view url) {
@@ -925,6 +1446,12 @@ Result<kvstore::Spec> ParseFileUrl(std::string_view url) {
       Context::Resource<FileIoMemmapResource>::DefaultSpec();
   driver_spec->data_.file_io_locking =
       Context::Resource<FileIoLockingResource>::DefaultSpec();
+  driver_spec->data_.file_io_uring =
+      Context::Resource<FileIoUringResource>::DefaultSpec();
+  driver_spec->data_.file_io_direct =
+      Context::Resource<FileIoDirectResource>::DefaultSpec();
+  driver_spec->data_.file_io_group_commit =
+      Context::Resource<FileIoGroupCommitResource>::DefaultSpec();
 
   return {std::in_place, std::move(driver_spec), std::move(path)};
 }
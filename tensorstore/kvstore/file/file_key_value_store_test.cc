@@ -42,6 +42,7 @@
 #include "tensorstore/context.h"
 #include "tensorstore/internal/os/filesystem.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/kvstore/file/write_ahead_log.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -56,6 +57,8 @@
 
 // Include system headers last to reduce impact of macros.
 #ifndef _WIN32
+#include <signal.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -69,9 +72,12 @@ using ::tensorstore::KeyRange;
 using ::tensorstore::KvStore;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 using ::tensorstore::internal::MatchesListEntry;
 using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
+using ::tensorstore::internal_file_kvstore::EncodeWriteAheadLogSegment;
+using ::tensorstore::internal_file_kvstore::WriteAheadLogRecord;
 using ::tensorstore::internal_os::GetDirectoryContents;
 using ::tensorstore::internal_testing::ScopedCurrentWorkingDirectory;
 using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
@@ -375,6 +381,87 @@ TEST(FileKeyValueStoreTest, DeleteRangeFromBeginning) {
   tensorstore::internal::TestKeyValueStoreDeleteRangeFromBeginning(store);
 }
 
+TEST(FileKeyValueStoreTest, PartialWrite) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetStore(root);
+  tensorstore::internal::TestKeyValueStorePartialWrite(store);
+  EXPECT_THAT(GetDirectoryContents(root), ::testing::UnorderedElementsAre("a"));
+}
+
+TEST(FileKeyValueStoreTest, PartialWritelockfileLocking) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_locking", {{"mode", "lockfile"}}},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueStorePartialWrite(store);
+  EXPECT_THAT(GetDirectoryContents(root), ::testing::UnorderedElementsAre("a"));
+}
+
+TEST(FileKeyValueStoreTest, PartialWriteGroupCommit) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  std::string log_directory = tempdir.path() + "/wal";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_sync", true},
+                                 {"file_io_group_commit",
+                                  {{"log_directory", log_directory}}},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueStorePartialWrite(store);
+}
+
+#ifndef _WIN32
+TEST(FileKeyValueStoreTest, PartialWriteFailureLeavesFileUnmodified) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetStore(root);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a", absl::Cord("abcdef")).result());
+
+  // Inject a failure after the first byte range has been written by limiting
+  // the file size, which also applies to root.  The limit is checked by
+  // `write`, which fails with `EFBIG` rather than raising `SIGXFSZ` if the
+  // signal is ignored.
+  struct rlimit old_limit;
+  ASSERT_EQ(0, ::getrlimit(RLIMIT_FSIZE, &old_limit))
+      << "Error " << errno << ": " << ::strerror(errno);
+  auto old_handler = ::signal(SIGXFSZ, SIG_IGN);
+  struct RestoreFileSizeLimit {
+    struct rlimit limit;
+    void (*handler)(int);
+    ~RestoreFileSizeLimit() {
+      EXPECT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limit))
+          << "Error " << errno << ": " << ::strerror(errno);
+      ::signal(SIGXFSZ, handler);
+    }
+  };
+  RestoreFileSizeLimit restore{old_limit, old_handler};
+  struct rlimit limit = old_limit;
+  limit.rlim_cur = 64;
+  ASSERT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limit))
+      << "Error " << errno << ": " << ::strerror(errno);
+
+  kvstore::WriteOptions options;
+  options.byte_ranges = {tensorstore::ByteRange{0, 2},
+                         tensorstore::ByteRange{100, 102}};
+  EXPECT_THAT(
+      kvstore::Write(store, "a", absl::Cord("XYZW"), options).result(),
+      ::testing::Not(tensorstore::IsOk()));
+
+  // Neither range is visible, and the temporary file has been removed.
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abcdef"), stamp.generation));
+  EXPECT_THAT(GetDirectoryContents(root), ::testing::UnorderedElementsAre("a"));
+}
+#endif
+
 #if 0
 TEST(FileKeyValueStoreTest, CopyRange) {
   ScopedTemporaryDirectory tempdir;
@@ -433,6 +520,9 @@ TEST(FileKeyValueStoreTest, SpecRoundtripSync) {
            {"file_io_concurrency", ::nlohmann::json::object_t()},
            {"file_io_memmap", false},
            {"file_io_locking", {{"mode", "lockfile"}}},
+           {"file_io_uring", ::nlohmann::json::object_t()},
+           {"file_io_direct", false},
+           {"file_io_group_commit", ::nlohmann::json::object_t()},
        }},
   };
   options.spec_request_options.Set(tensorstore::retain_context).IgnoreError();
@@ -497,6 +587,92 @@ TEST(FileKeyValueStoreTest, InvalidUri) {
                             ".*Invalid file path.*"));
 }
 
+TEST(FileKeyValueStoreTest, BasicIoUring) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_uring", {{"enabled", true}}},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+// Values larger than the direct I/O alignment are written partly with direct
+// I/O.  Falls back to buffered I/O if direct I/O is not supported by the
+// filesystem containing the temporary directory.
+TEST(FileKeyValueStoreTest, BasicDirect) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_direct", true},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store, 256 * 1024);
+}
+
+TEST(FileKeyValueStoreTest, BasicDirectIoUring) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_direct", true},
+                                 {"file_io_uring", {{"enabled", true}}},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store, 256 * 1024);
+}
+
+TEST(FileKeyValueStoreTest, BasicGroupCommit) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  std::string log_directory = tempdir.path() + "/wal";
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_sync", true},
+                                 {"file_io_group_commit",
+                                  {{"log_directory", log_directory}}},
+                             })
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+// Writes that remain in the log are replayed when the kvstore is opened.
+TEST(FileKeyValueStoreTest, GroupCommitReplay) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  std::string log_directory = tempdir.path() + "/wal";
+  {
+    WriteAheadLogRecord a{root + "/a", absl::Cord("abc")};
+    WriteAheadLogRecord b{root + "/b", std::nullopt};
+    const WriteAheadLogRecord* records[] = {&a, &b};
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(GetStore(root), "b", absl::Cord("def")).result());
+    TENSORSTORE_ASSERT_OK(
+        kvstore::Write(GetStore(log_directory), "00000000000000000001.wal",
+                       EncodeWriteAheadLogSegment(records))
+            .result());
+  }
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", root + "/"},
+                                 {"file_io_group_commit",
+                                  {{"log_directory", log_directory}}},
+                             })
+                   .value();
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abc")));
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(GetDirectoryContents(log_directory),
+              ::testing::UnorderedElementsAre("LOCK"));
+}
+
 TEST(FileKeyValueStoreTest, RelativePath) {
   ScopedTemporaryDirectory tempdir;
   ScopedCurrentWorkingDirectory scoped_cwd(tempdir.path());
@@ -515,6 +691,26 @@ TEST(FileKeyValueStoreTest, BatchRead) {
   tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
 }
 
+// With a queue depth smaller than the number of coalesced reads, the reads are
+// split across multiple submissions.  Falls back to ::pread if io_uring is not
+// supported, in which case the same results are expected.
+TEST(FileKeyValueStoreTest, BatchReadIoUring) {
+  ScopedTemporaryDirectory tempdir;
+  auto store = kvstore::Open({
+                                 {"driver", "file"},
+                                 {"path", tempdir.path() + "/"},
+                                 {"file_io_uring",
+                                  {{"enabled", true}, {"queue_depth", 2}}},
+                             })
+                   .value();
+
+  tensorstore::internal::BatchReadGenericCoalescingTestOptions options;
+  options.coalescing_options.max_extra_read_bytes = 255;
+  options.metric_prefix = "/tensorstore/kvstore/file/";
+  options.has_file_open_metric = true;
+  tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
+}
+
 #if 0
 // TODO: Make this test reasonable for mmap cases.
 TEST(FileKeyValueStoreTest, BatchReadMemmap) {
@@ -14,9 +14,48 @@
 
 #include "tensorstore/kvstore/file/file_resource.h"
 
+#include <stddef.h>
+
+#include <memory>
+
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache_key/absl_time.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/kvstore/file/aligned_buffer_pool.h"
+#include "tensorstore/kvstore/file/write_ahead_log.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+// Include these last to reduce impact of macros.
+#include "tensorstore/internal/os/file_util.h"
+
+namespace tensorstore {
+namespace internal_file_kvstore {
+
+Result<FileIoDirectResource::Resource> FileIoDirectResource::Create(
+    Spec v, internal::ContextResourceCreationContext context) {
+  // Maximum total size of idle buffers retained by the pool.
+  constexpr size_t kMaxCachedBytes = 64 * 1024 * 1024;
+  Resource resource{v, nullptr};
+  if (v) {
+    resource.pool = std::make_shared<AlignedBufferPool>(
+        internal_os::GetDefaultPageSize(), kMaxCachedBytes);
+  }
+  return resource;
+}
+
+Result<FileIoGroupCommitResource::Resource> FileIoGroupCommitResource::Create(
+    Spec v, internal::ContextResourceCreationContext context) {
+  Resource resource{v, nullptr};
+  if (!v.log_directory.empty()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(resource.log,
+                                 WriteAheadLog::Open(v.log_directory));
+  }
+  return resource;
+}
+
+}  // namespace internal_file_kvstore
+}  // namespace tensorstore
 
 namespace {
 
@@ -28,6 +67,18 @@ const tensorstore::internal::ContextResourceRegistration<
     tensorstore::internal_file_kvstore::FileIoMemmapResource>
     file_io_memmap_registration;
 
+const tensorstore::internal::ContextResourceRegistration<
+    tensorstore::internal_file_kvstore::FileIoDirectResource>
+    file_io_direct_registration;
+
+const tensorstore::internal::ContextResourceRegistration<
+    tensorstore::internal_file_kvstore::FileIoUringResource>
+    file_io_uring_registration;
+
+const tensorstore::internal::ContextResourceRegistration<
+    tensorstore::internal_file_kvstore::FileIoGroupCommitResource>
+    file_io_group_commit_registration;
+
 const tensorstore::internal::ContextResourceRegistration<
     tensorstore::internal_file_kvstore::FileIoLockingResource>
     file_io_registration;
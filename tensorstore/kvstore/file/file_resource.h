@@ -15,6 +15,10 @@
 #ifndef TENSORSTORE_KVSTORE_FILE_FILE_RESOURCE_H_
 #define TENSORSTORE_KVSTORE_FILE_FILE_RESOURCE_H_
 
+#include <stddef.h>
+
+#include <memory>
+#include <string>
 #include <string_view>
 
 #include "absl/time/time.h"
@@ -24,6 +28,9 @@
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/os/io_uring.h"
+#include "tensorstore/kvstore/file/aligned_buffer_pool.h"
+#include "tensorstore/kvstore/file/write_ahead_log.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
@@ -74,6 +81,148 @@ struct FileIoMemmapResource
   }
 };
 
+/// When set, the "file" kvstore uses direct I/O (O_DIRECT on Linux), which
+/// bypasses the page cache, for reads and writes.
+///
+/// Reads are widened to the alignment required for direct I/O, using buffers
+/// from a pool shared by all users of the resource, and the returned values
+/// reference the requested portion of the buffer without copying.  Falls back
+/// to buffered I/O if not supported by the platform or filesystem.
+struct FileIoDirectResource
+    : public internal::ContextResourceTraits<FileIoDirectResource> {
+  static constexpr char id[] = "file_io_direct";
+
+  using Spec = bool;
+
+  struct Resource {
+    Spec enabled;
+
+    /// Aligned buffers used for reads and writes, or `nullptr` if not enabled.
+    std::shared_ptr<AlignedBufferPool> pool;
+  };
+
+  static Spec Default() { return false; }
+  static constexpr auto JsonBinder() {
+    return internal_json_binding::DefaultBinder<>;
+  }
+  static Result<Resource> Create(
+      Spec v, internal::ContextResourceCreationContext context);
+  static Spec GetSpec(const Resource& v,
+                      const internal::ContextSpecBuilder& builder) {
+    return v.enabled;
+  }
+};
+
+/// When enabled, the "file" kvstore submits the reads of a batch to the file
+/// using io_uring, with a single system call rather than one ::pread per
+/// read.  Falls back to ::pread if io_uring is not supported.
+///
+/// Reads are performed by the thread processing the batch, which waits for
+/// all of them to complete, rather than by separate `file_io_concurrency`
+/// tasks.
+struct FileIoUringResource
+    : public internal::ContextResourceTraits<FileIoUringResource> {
+  static constexpr char id[] = "file_io_uring";
+
+  struct Spec {
+    bool enabled;
+
+    /// Maximum number of reads in flight per batch.
+    size_t queue_depth;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.enabled, x.queue_depth);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+
+    /// Rings shared by all batches, or `nullptr` if not enabled.
+    std::shared_ptr<internal_os::IoUringPool> pool;
+  };
+
+  static Spec Default() { return Spec{false, 64}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = internal_json_binding;
+    return jb::Object(
+        jb::Member("enabled", jb::Projection<&Spec::enabled>(
+                                  jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                                      [](auto* obj) {
+                                        *obj = Default().enabled;
+                                      }))),
+        jb::Member("queue_depth",
+                   jb::Projection<&Spec::queue_depth>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = Default().queue_depth; },
+                           jb::Integer<size_t>(1, 4096))))
+        /**/);
+  }
+
+  static Result<Resource> Create(
+      Spec v, internal::ContextResourceCreationContext context) {
+    Resource resource{v, nullptr};
+    if (v.enabled) {
+      resource.pool = std::make_shared<internal_os::IoUringPool>(
+          static_cast<unsigned>(v.queue_depth));
+    }
+    return resource;
+  }
+
+  static Spec GetSpec(const Resource& v,
+                      const internal::ContextSpecBuilder& builder) {
+    return v.spec;
+  }
+};
+
+/// When a log directory is specified, and `file_io_sync` is enabled, the
+/// "file" kvstore makes writes and deletes durable by committing them to a
+/// write-ahead log in that directory, rather than by syncing each file and its
+/// parent directory.  Concurrent writes are committed together, with a single
+/// sync, see `write_ahead_log.h`.
+///
+/// The log directory must not be shared by multiple processes, and must
+/// remain available across restarts: any writes that remain in the log after
+/// a crash are replayed the next time a kvstore using the log is opened.
+struct FileIoGroupCommitResource
+    : public internal::ContextResourceTraits<FileIoGroupCommitResource> {
+  static constexpr char id[] = "file_io_group_commit";
+
+  struct Spec {
+    /// Directory of the log, or empty to disable group commit.
+    std::string log_directory;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.log_directory);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+
+    /// Log shared by all kvstores using the resource, or `nullptr` if not
+    /// enabled.
+    std::shared_ptr<WriteAheadLog> log;
+  };
+
+  static Spec Default() { return Spec{}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = internal_json_binding;
+    return jb::Object(jb::Member(
+        "log_directory",
+        jb::Projection<&Spec::log_directory>(
+            jb::DefaultInitializedValue<jb::kNeverIncludeDefaults>())));
+  }
+
+  static Result<Resource> Create(
+      Spec v, internal::ContextResourceCreationContext context);
+
+  static Spec GetSpec(const Resource& v,
+                      const internal::ContextSpecBuilder& builder) {
+    return v.spec;
+  }
+};
+
 /// When set, allows choosing how the "file" kvstore uses file locking, which
 /// ensures that only one process is writing to a kvstore key at a time.
 struct FileIoLockingResource
@@ -0,0 +1,533 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/file/write_ahead_log.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/crc/crc32c.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/path.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+
+// Include these last to reduce impact of macros.
+#include "tensorstore/internal/os/file_lister.h"
+#include "tensorstore/internal/os/file_lock.h"
+#include "tensorstore/internal/os/file_util.h"
+
+namespace tensorstore {
+namespace internal_file_kvstore {
+namespace {
+
+using ::tensorstore::internal_os::FileInfo;
+using ::tensorstore::internal_os::UniqueFileDescriptor;
+
+constexpr std::string_view kSegmentMagic = "TSWAL001";
+constexpr std::string_view kSegmentSuffix = ".wal";
+constexpr size_t kRecordHeaderSize = 12;
+
+enum RecordKind : uint8_t {
+  kDelete = 0,
+  kWrite = 1,
+  kAbort = 2,
+};
+
+absl::crc32c_t ComputeCrc32c(const absl::Cord& cord) {
+  absl::crc32c_t crc{0};
+  for (std::string_view chunk : cord.Chunks()) {
+    crc = absl::ExtendCrc32c(crc, chunk);
+  }
+  return crc;
+}
+
+Result<std::string> ReadFileContents(const std::string& path) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto fd,
+                               internal_os::OpenExistingFileForReading(path));
+  FileInfo info;
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::GetFileInfo(fd.get(), &info));
+  std::string contents(internal_os::GetSize(info), '\0');
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n, internal_os::ReadFromFile(fd.get(), contents.data() + offset,
+                                          contents.size() - offset, offset));
+    if (n == 0) break;
+    offset += n;
+  }
+  contents.resize(offset);
+  return contents;
+}
+
+/// Logs opened by this process, such that multiple contexts that specify the
+/// same log directory share a single log.
+struct LogRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, std::weak_ptr<WriteAheadLog>> logs
+      ABSL_GUARDED_BY(mutex);
+};
+
+LogRegistry& GetLogRegistry() {
+  static absl::NoDestructor<LogRegistry> registry;
+  return *registry;
+}
+
+}  // namespace
+
+absl::Cord EncodeWriteAheadLogSegment(
+    span<const WriteAheadLogRecord* const> records) {
+  absl::Cord segment(kSegmentMagic);
+  for (const auto* record : records) {
+    const size_t path_end = 5 + record->path.size();
+    std::string payload_header(
+        path_end + (record->aborted_segment ? 8 : 0), '\0');
+    payload_header[0] = record->aborted_segment ? kAbort
+                        : record->value         ? kWrite
+                                                : kDelete;
+    absl::little_endian::Store32(payload_header.data() + 1,
+                                 record->path.size());
+    std::copy(record->path.begin(), record->path.end(),
+              payload_header.begin() + 5);
+    if (record->aborted_segment) {
+      absl::little_endian::Store64(payload_header.data() + path_end,
+                                   *record->aborted_segment);
+    }
+    absl::Cord payload(std::move(payload_header));
+    if (record->value && !record->aborted_segment) {
+      payload.Append(*record->value);
+    }
+
+    char header[kRecordHeaderSize];
+    absl::little_endian::Store64(header, payload.size());
+    absl::little_endian::Store32(
+        header + 8, static_cast<uint32_t>(ComputeCrc32c(payload)));
+    segment.Append(std::string_view(header, kRecordHeaderSize));
+    segment.Append(std::move(payload));
+  }
+  return segment;
+}
+
+Result<std::vector<WriteAheadLogRecord>> DecodeWriteAheadLogSegment(
+    std::string_view segment) {
+  if (!absl::StartsWith(segment, kSegmentMagic)) {
+    return absl::DataLossError("Invalid write-ahead log segment header");
+  }
+  segment.remove_prefix(kSegmentMagic.size());
+  std::vector<WriteAheadLogRecord> records;
+  while (segment.size() >= kRecordHeaderSize) {
+    const uint64_t payload_size = absl::little_endian::Load64(segment.data());
+    const uint32_t crc = absl::little_endian::Load32(segment.data() + 8);
+    if (payload_size > segment.size() - kRecordHeaderSize) break;
+    std::string_view payload =
+        segment.substr(kRecordHeaderSize, payload_size);
+    if (static_cast<uint32_t>(absl::ComputeCrc32c(payload)) != crc ||
+        payload.size() < 5) {
+      break;
+    }
+    const uint8_t kind = payload[0];
+    const uint32_t path_size = absl::little_endian::Load32(payload.data() + 1);
+    if ((kind != kWrite && kind != kDelete && kind != kAbort) ||
+        path_size > payload.size() - 5 ||
+        (kind == kDelete && path_size != payload.size() - 5) ||
+        (kind == kAbort && path_size + 8 != payload.size() - 5)) {
+      break;
+    }
+    auto& record = records.emplace_back();
+    record.path = std::string(payload.substr(5, path_size));
+    if (kind == kWrite) {
+      record.value = absl::Cord(payload.substr(5 + path_size));
+    } else if (kind == kAbort) {
+      record.aborted_segment =
+          absl::little_endian::Load64(payload.data() + 5 + path_size);
+    }
+    segment.remove_prefix(kRecordHeaderSize + payload_size);
+  }
+  return records;
+}
+
+struct WriteAheadLog::Impl {
+  std::string directory;
+  UniqueFileDescriptor dir_fd;
+  std::optional<internal_os::FileLock> lock;
+
+  absl::Mutex mutex;
+
+  // Segments remaining from a previous process, in order.
+  std::vector<uint64_t> recovery_segments ABSL_GUARDED_BY(mutex);
+  std::optional<absl::Status> recover_status ABSL_GUARDED_BY(mutex);
+
+  // Record waiting to be committed by `Commit`.
+  struct PendingCommit {
+    const WriteAheadLogRecord* record;
+    uint64_t segment = 0;
+    absl::Status status;
+    bool done = false;
+  };
+
+  // Set while a caller of `Commit` is writing a segment.
+  bool committing ABSL_GUARDED_BY(mutex) = false;
+  std::vector<PendingCommit*> queue ABSL_GUARDED_BY(mutex);
+  uint64_t next_segment ABSL_GUARDED_BY(mutex) = 1;
+
+  // Segments that have been (or are being) written and not yet retired.
+  struct Segment {
+    size_t unapplied = 0;
+    // Paths of the records of the segment.
+    std::vector<std::string> paths;
+  };
+  std::map<uint64_t, Segment> segments ABSL_GUARDED_BY(mutex);
+  bool retiring ABSL_GUARDED_BY(mutex) = false;
+
+  ~Impl() {
+    if (lock) std::move(*lock).Close();
+  }
+
+  std::string SegmentPath(uint64_t segment) const {
+    return absl::StrCat(directory, "/", absl::Dec(segment, absl::kZeroPad20),
+                        kSegmentSuffix);
+  }
+
+  absl::Status WriteSegment(uint64_t segment,
+                            span<PendingCommit* const> commits) {
+    std::vector<const WriteAheadLogRecord*> records;
+    records.reserve(commits.size());
+    for (auto* commit : commits) records.push_back(commit->record);
+    absl::Cord data = EncodeWriteAheadLogSegment(records);
+
+    const std::string path = SegmentPath(segment);
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto fd, internal_os::OpenFileWrapper(
+                     path, internal_os::OpenFlags::OpenWriteOnly |
+                               internal_os::OpenFlags::Create |
+                               internal_os::OpenFlags::Exclusive));
+    auto status = [&]() -> absl::Status {
+      while (!data.empty()) {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto n, internal_os::WriteCordToFile(fd.get(), data));
+        data.RemovePrefix(n);
+      }
+      TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFile(fd.get()));
+      // Ensure the new segment file is durable.
+      return internal_os::FsyncDirectory(dir_fd.get());
+    }();
+    if (!status.ok()) {
+      internal_os::DeleteFile(path).IgnoreError();
+      return MaybeAnnotateStatus(
+          status, absl::StrCat("Failed to write ", QuoteString(path)));
+    }
+    return absl::OkStatus();
+  }
+
+  /// Returns the segments that may be retired, which are the longest prefix of
+  /// `segments` of which all records have been applied.
+  std::vector<uint64_t> GetRetirableSegments(std::vector<std::string>& paths)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    std::vector<uint64_t> ids;
+    for (const auto& [id, segment] : segments) {
+      if (segment.unapplied != 0) break;
+      ids.push_back(id);
+      paths.insert(paths.end(), segment.paths.begin(), segment.paths.end());
+    }
+    return ids;
+  }
+
+  /// Syncs the files at `paths`, and their parent directories, then deletes
+  /// the segments `ids`.
+  absl::Status Retire(span<const uint64_t> ids,
+                      span<const std::string> paths) {
+    // Applied files grouped by parent directory.
+    absl::flat_hash_map<std::string, std::vector<std::string_view>> dirs;
+    for (const auto& path : paths) {
+      auto dir = internal::PathDirnameBasename(path).first;
+      dirs[dir.empty() ? std::string_view(".") : dir].push_back(path);
+    }
+
+    // A single `syncfs` covers all files on the same filesystem as the log.
+    FileInfo log_info;
+    TENSORSTORE_RETURN_IF_ERROR(
+        internal_os::GetFileInfo(dir_fd.get(), &log_info));
+    const bool synced_log_filesystem =
+        internal_os::SyncFilesystem(dir_fd.get()).ok();
+
+    for (const auto& [dir, dir_paths] : dirs) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto fd,
+                                   internal_os::OpenDirectoryDescriptor(dir));
+      if (synced_log_filesystem) {
+        FileInfo info;
+        TENSORSTORE_RETURN_IF_ERROR(internal_os::GetFileInfo(fd.get(), &info));
+        if (internal_os::GetDeviceId(info) ==
+            internal_os::GetDeviceId(log_info)) {
+          continue;
+        }
+      }
+      for (std::string_view path : dir_paths) {
+        auto file_fd =
+            internal_os::OpenExistingFileForReading(std::string(path));
+        if (absl::IsNotFound(file_fd.status())) continue;  // Deleted.
+        TENSORSTORE_RETURN_IF_ERROR(file_fd.status());
+        TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFile(file_fd->get()));
+      }
+      TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncDirectory(fd.get()));
+    }
+
+    for (uint64_t id : ids) {
+      auto status = internal_os::DeleteFile(SegmentPath(id));
+      if (!status.ok() && !absl::IsNotFound(status)) return status;
+    }
+    // Ensure the deletions are durable, such that retired segments are not
+    // replayed after newer writes.
+    return internal_os::FsyncDirectory(dir_fd.get());
+  }
+
+  void FinishRetire(span<const uint64_t> ids, const absl::Status& status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    retiring = false;
+    if (!status.ok()) {
+      // The segments are retried when another record is applied.
+      ABSL_LOG(WARNING) << "Failed to retire write-ahead log segments in "
+                        << QuoteString(directory) << ": " << status;
+      return;
+    }
+    for (uint64_t id : ids) segments.erase(id);
+  }
+};
+
+WriteAheadLog::WriteAheadLog(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+WriteAheadLog::~WriteAheadLog() = default;
+
+const std::string& WriteAheadLog::directory() const {
+  return impl_->directory;
+}
+
+Result<std::shared_ptr<WriteAheadLog>> WriteAheadLog::Open(
+    std::string directory) {
+  auto& registry = GetLogRegistry();
+  absl::MutexLock registry_lock(&registry.mutex);
+  auto& entry = registry.logs[directory];
+  if (auto log = entry.lock()) return log;
+
+  auto impl = std::make_unique<Impl>();
+  impl->directory = directory;
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::MakeDirectory(directory));
+  TENSORSTORE_ASSIGN_OR_RETURN(impl->dir_fd,
+                               internal_os::OpenDirectoryDescriptor(directory));
+  // Blocks while the log is in use by another process.
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      impl->lock,
+      internal_os::AcquireFileLock(absl::StrCat(directory, "/LOCK")));
+
+  std::vector<uint64_t> segments;
+  TENSORSTORE_RETURN_IF_ERROR(internal_os::RecursiveFileList(
+      directory, [&](std::string_view path) { return path == directory; },
+      [&](internal_os::ListerEntry entry) -> absl::Status {
+        if (entry.IsDirectory()) return absl::OkStatus();
+        std::string_view name = entry.GetPathComponent();
+        uint64_t id;
+        if (absl::ConsumeSuffix(&name, kSegmentSuffix) &&
+            absl::SimpleAtoi(name, &id)) {
+          segments.push_back(id);
+        }
+        return absl::OkStatus();
+      }));
+  std::sort(segments.begin(), segments.end());
+  {
+    absl::MutexLock lock(&impl->mutex);
+    if (!segments.empty()) impl->next_segment = segments.back() + 1;
+    impl->recovery_segments = std::move(segments);
+  }
+
+  auto log = std::shared_ptr<WriteAheadLog>(new WriteAheadLog(std::move(impl)));
+  entry = log;
+  return log;
+}
+
+absl::Status WriteAheadLog::Recover(ApplyFunction apply) {
+  auto& impl = *impl_;
+  absl::MutexLock lock(&impl.mutex);
+  if (impl.recover_status) return *impl.recover_status;
+  auto status = [&]() -> absl::Status {
+    // All segments are decoded before any record is applied, since an abort
+    // record may follow the aborted record in a later segment.
+    std::vector<std::vector<WriteAheadLogRecord>> segment_records;
+    absl::flat_hash_set<std::pair<uint64_t, std::string>> aborted;
+    for (uint64_t segment : impl.recovery_segments) {
+      const std::string path = impl.SegmentPath(segment);
+      TENSORSTORE_ASSIGN_OR_RETURN(auto contents, ReadFileContents(path));
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto records, DecodeWriteAheadLogSegment(contents),
+          MaybeAnnotateStatus(_, absl::StrCat("Failed to replay ",
+                                              QuoteString(path))));
+      for (const auto& record : records) {
+        if (record.aborted_segment) {
+          aborted.emplace(*record.aborted_segment, record.path);
+        }
+      }
+      segment_records.push_back(std::move(records));
+    }
+    for (size_t i = 0; i < impl.recovery_segments.size(); ++i) {
+      const uint64_t segment = impl.recovery_segments[i];
+      const std::string path = impl.SegmentPath(segment);
+      ABSL_LOG(INFO) << "Replaying write-ahead log segment "
+                     << QuoteString(path);
+      for (const auto& record : segment_records[i]) {
+        if (record.aborted_segment ||
+            aborted.erase(std::make_pair(segment, record.path))) {
+          continue;
+        }
+        TENSORSTORE_RETURN_IF_ERROR(apply(record));
+      }
+      TENSORSTORE_RETURN_IF_ERROR(internal_os::DeleteFile(path));
+    }
+    if (impl.recovery_segments.empty()) return absl::OkStatus();
+    return internal_os::FsyncDirectory(impl.dir_fd.get());
+  }();
+  impl.recovery_segments.clear();
+  impl.recover_status = status;
+  return status;
+}
+
+Result<uint64_t> WriteAheadLog::Commit(const WriteAheadLogRecord& record) {
+  auto& impl = *impl_;
+  Impl::PendingCommit commit{&record};
+  absl::MutexLock lock(&impl.mutex);
+  impl.queue.push_back(&commit);
+  const auto done_or_idle = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl.mutex) {
+    return commit.done || !impl.committing;
+  };
+  impl.mutex.Await(absl::Condition(&done_or_idle));
+  if (!commit.done) {
+    // Write all queued records, including `record`, to a new segment.
+    impl.committing = true;
+    std::vector<Impl::PendingCommit*> batch;
+    batch.swap(impl.queue);
+    const uint64_t segment = impl.next_segment++;
+    auto& new_segment = impl.segments[segment];
+    new_segment.unapplied = batch.size();
+    for (auto* pending : batch) {
+      new_segment.paths.push_back(pending->record->path);
+    }
+    impl.mutex.Unlock();
+    auto status = impl.WriteSegment(segment, batch);
+    impl.mutex.Lock();
+    if (!status.ok()) impl.segments.erase(segment);
+    for (auto* pending : batch) {
+      pending->segment = segment;
+      pending->status = status;
+      pending->done = true;
+    }
+    impl.committing = false;
+  }
+  TENSORSTORE_RETURN_IF_ERROR(commit.status);
+  return commit.segment;
+}
+
+void WriteAheadLog::Applied(uint64_t segment, const Executor& executor) {
+  {
+    absl::MutexLock lock(&impl_->mutex);
+    auto it = impl_->segments.find(segment);
+    assert(it != impl_->segments.end() && it->second.unapplied > 0);
+    if (--it->second.unapplied != 0) return;
+  }
+  MaybeRetire(executor);
+}
+
+void WriteAheadLog::MaybeRetire(const Executor& executor) {
+  std::vector<uint64_t> ids;
+  std::vector<std::string> paths;
+  {
+    absl::MutexLock lock(&impl_->mutex);
+    if (impl_->retiring) return;
+    ids = impl_->GetRetirableSegments(paths);
+    if (ids.empty()) return;
+    impl_->retiring = true;
+  }
+  executor([self = shared_from_this(), ids = std::move(ids),
+            paths = std::move(paths), executor = executor] {
+    auto status = self->impl_->Retire(ids, paths);
+    {
+      absl::MutexLock lock(&self->impl_->mutex);
+      self->impl_->FinishRetire(ids, status);
+    }
+    // Retire any segments that became retirable in the meantime.
+    if (status.ok()) self->MaybeRetire(executor);
+  });
+}
+
+absl::Status WriteAheadLog::Checkpoint(
+    absl::FunctionRef<bool(std::string_view path)> affected) {
+  auto& impl = *impl_;
+  absl::MutexLock lock(&impl.mutex);
+  // Segments are retired in order, so all segments up to the last one that
+  // holds an affected record must be retired, even if an earlier segment
+  // holds a record that is not yet applied.
+  std::optional<uint64_t> last;
+  for (const auto& [id, segment] : impl.segments) {
+    if (std::any_of(segment.paths.begin(), segment.paths.end(),
+                    [&](const std::string& path) { return affected(path); })) {
+      last = id;
+    }
+  }
+  if (!last) return absl::OkStatus();
+  const auto checkpointed = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl.mutex) {
+    return impl.segments.empty() || impl.segments.begin()->first > *last;
+  };
+  const auto ready = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl.mutex) {
+    return !impl.retiring &&
+           (checkpointed() || impl.segments.begin()->second.unapplied == 0);
+  };
+  while (true) {
+    impl.mutex.Await(absl::Condition(&ready));
+    if (checkpointed()) return absl::OkStatus();
+    std::vector<std::string> paths;
+    auto ids = impl.GetRetirableSegments(paths);
+    if (ids.empty()) return absl::OkStatus();
+    impl.retiring = true;
+    impl.mutex.Unlock();
+    auto status = impl.Retire(ids, paths);
+    impl.mutex.Lock();
+    impl.FinishRetire(ids, status);
+    TENSORSTORE_RETURN_IF_ERROR(status);
+  }
+}
+
+}  // namespace internal_file_kvstore
+}  // namespace tensorstore
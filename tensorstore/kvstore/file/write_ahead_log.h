@@ -0,0 +1,160 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_FILE_WRITE_AHEAD_LOG_H_
+#define TENSORSTORE_KVSTORE_FILE_WRITE_AHEAD_LOG_H_
+
+/// \file
+///
+/// Write-ahead log used by the "file" kvstore for group commit.
+///
+/// Rather than syncing each written file and its parent directory, writes and
+/// deletes are made durable by appending them to the log: all records
+/// committed concurrently are written to a single new log segment, which is
+/// synced once.  The records are then applied to their files without syncing.
+/// Once all records of a segment, and of all earlier segments, have been
+/// applied, the segment is retired in the background: the applied files are
+/// synced (with a single `syncfs` call for files on the same filesystem as the
+/// log, on Linux) and the segment is deleted.
+///
+/// If the process crashes, the segments that remain are replayed, in order,
+/// by `Recover` the next time the log is opened.
+///
+/// Each segment consists of a header followed by a sequence of records:
+///
+///     segment := magic:"TSWAL001" record*
+///     record := payload_size:uint64le crc32c(payload):uint32le payload
+///     payload := kind:uint8 path_size:uint32le path value
+///
+/// where `kind` is 0 for a delete and 1 for a write, in which case `value` is
+/// the remainder of the payload.  A `kind` of 2 marks an abort, in which case
+/// `value` is the `segment:uint64le` of an earlier record for `path` that
+/// failed to apply and must not be replayed.  Replay stops at the first
+/// incomplete or corrupt record, which can only be a record that was not
+/// acknowledged.
+///
+/// Paths are recorded as given; callers record absolute paths such that replay
+/// does not depend on the working directory.
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_file_kvstore {
+
+/// Write of the file at `path`.
+struct WriteAheadLogRecord {
+  std::string path;
+
+  /// New contents of the file, or `std::nullopt` to delete it.
+  std::optional<absl::Cord> value;
+
+  /// If specified, this record instead indicates that the record for `path`
+  /// committed to the specified segment failed to apply, and must not be
+  /// replayed.  `value` is ignored.
+  std::optional<uint64_t> aborted_segment;
+};
+
+/// Encodes the log segment containing `records`.
+absl::Cord EncodeWriteAheadLogSegment(
+    span<const WriteAheadLogRecord* const> records);
+
+/// Decodes a log segment, ignoring any incomplete or corrupt trailing data.
+///
+/// \error `absl::StatusCode::kDataLoss` if `segment` is not a log segment.
+Result<std::vector<WriteAheadLogRecord>> DecodeWriteAheadLogSegment(
+    std::string_view segment);
+
+class WriteAheadLog : public std::enable_shared_from_this<WriteAheadLog> {
+ public:
+  using ApplyFunction =
+      absl::FunctionRef<absl::Status(const WriteAheadLogRecord& record)>;
+
+  /// Opens the log in `directory`, creating the directory (but not its
+  /// parents) if it does not exist.
+  ///
+  /// The log is locked for exclusive use by a single process; within the
+  /// process, opening the same `directory` again returns the same log.
+  static Result<std::shared_ptr<WriteAheadLog>> Open(std::string directory);
+
+  ~WriteAheadLog();
+
+  /// Durably applies, in order, the records of any segments that remain from
+  /// a previous process, other than aborted records, and deletes the
+  /// segments.
+  ///
+  /// Must be called before the first call to `Commit`.  Only the first call
+  /// has any effect; later calls return the same status.
+  absl::Status Recover(ApplyFunction apply);
+
+  /// Appends `record` to the log, blocking until it is durable.
+  ///
+  /// While one caller writes a segment, records committed by other callers are
+  /// queued, and are written together to the next segment.
+  ///
+  /// \returns The segment to which `record` was written, which must be passed
+  ///     to `Applied`.
+  Result<uint64_t> Commit(const WriteAheadLogRecord& record);
+
+  /// Indicates that the record committed to `segment` has been applied (or
+  /// failed to apply).
+  ///
+  /// A record that failed to apply after it was committed must additionally
+  /// be aborted, by committing a record with `aborted_segment` set, since it
+  /// would otherwise be replayed after a crash.
+  ///
+  /// Must be called exactly once for each successful `Commit`; retirement of
+  /// the segment, which is done using `executor`, is blocked until then.
+  void Applied(uint64_t segment, const Executor& executor);
+
+  /// Synchronously retires all segments up to and including the last
+  /// currently committed segment that holds a record for a path for which
+  /// `affected` returns `true`, waiting for the records of those segments to
+  /// be applied.  On success, no segment that could be replayed after a crash
+  /// holds a record for an affected path, other than records committed after
+  /// the call.
+  ///
+  /// Used before operations that bypass the log, such as partial writes and
+  /// `DeleteRange`, which would otherwise be undone by replaying the log after
+  /// a crash.  The caller must not hold up the application of records that
+  /// were committed before the call.
+  absl::Status Checkpoint(absl::FunctionRef<bool(std::string_view path)>
+                              affected);
+
+  const std::string& directory() const;
+
+  struct Impl;
+
+ private:
+  explicit WriteAheadLog(std::unique_ptr<Impl> impl);
+  void MaybeRetire(const Executor& executor);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace internal_file_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_FILE_WRITE_AHEAD_LOG_H_
@@ -0,0 +1,217 @@
+// Copyright 2026 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/file/write_ahead_log.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::InlineExecutor;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_file_kvstore::DecodeWriteAheadLogSegment;
+using ::tensorstore::internal_file_kvstore::EncodeWriteAheadLogSegment;
+using ::tensorstore::internal_file_kvstore::WriteAheadLog;
+using ::tensorstore::internal_file_kvstore::WriteAheadLogRecord;
+using ::tensorstore::internal_testing::ScopedTemporaryDirectory;
+
+std::vector<std::string> DescribeRecords(
+    const std::vector<WriteAheadLogRecord>& records) {
+  std::vector<std::string> result;
+  for (const auto& record : records) {
+    if (record.aborted_segment) {
+      result.push_back(record.path + "=<abort " +
+                       std::to_string(*record.aborted_segment) + ">");
+      continue;
+    }
+    result.push_back(record.path + "=" +
+                     (record.value ? std::string(*record.value) : "<delete>"));
+  }
+  return result;
+}
+
+TEST(WriteAheadLogSegmentTest, Roundtrip) {
+  WriteAheadLogRecord a{"a/b", absl::Cord("abc")};
+  WriteAheadLogRecord b{"c", std::nullopt};
+  WriteAheadLogRecord c{"d", absl::Cord()};
+  WriteAheadLogRecord d{"e", std::nullopt, 42};
+  const WriteAheadLogRecord* records[] = {&a, &b, &c, &d};
+  std::string segment(EncodeWriteAheadLogSegment(records));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded,
+                                   DecodeWriteAheadLogSegment(segment));
+  EXPECT_THAT(DescribeRecords(decoded),
+              ::testing::ElementsAre("a/b=abc", "c=<delete>", "d=",
+                                     "e=<abort 42>"));
+}
+
+TEST(WriteAheadLogSegmentTest, TornTail) {
+  WriteAheadLogRecord a{"a", absl::Cord("abc")};
+  WriteAheadLogRecord b{"b", absl::Cord("def")};
+  const WriteAheadLogRecord* records[] = {&a, &b};
+  std::string segment(EncodeWriteAheadLogSegment(records));
+
+  // Truncated record.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded,
+      DecodeWriteAheadLogSegment(
+          std::string_view(segment).substr(0, segment.size() - 1)));
+  EXPECT_THAT(DescribeRecords(decoded), ::testing::ElementsAre("a=abc"));
+
+  // Corrupt record.
+  segment.back() = 'x';
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(decoded,
+                                   DecodeWriteAheadLogSegment(segment));
+  EXPECT_THAT(DescribeRecords(decoded), ::testing::ElementsAre("a=abc"));
+}
+
+TEST(WriteAheadLogSegmentTest, InvalidHeader) {
+  EXPECT_THAT(DecodeWriteAheadLogSegment("TSWAL"),
+              MatchesStatus(absl::StatusCode::kDataLoss));
+}
+
+TEST(WriteAheadLogTest, RecoverUnapplied) {
+  ScopedTemporaryDirectory tempdir;
+  const std::string directory = tempdir.path() + "/wal";
+  std::vector<WriteAheadLogRecord> replayed;
+  const auto apply = [&](const WriteAheadLogRecord& record) {
+    replayed.push_back(record);
+    return absl::OkStatus();
+  };
+
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+    TENSORSTORE_ASSERT_OK(log->Recover(apply));
+    EXPECT_TRUE(replayed.empty());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto segment1, log->Commit({"a", absl::Cord("abc")}));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto segment2,
+                                     log->Commit({"b", std::nullopt}));
+    EXPECT_LT(segment1, segment2);
+
+    // Only the first record is applied before the simulated crash.
+    log->Applied(segment1, InlineExecutor{});
+    TENSORSTORE_ASSERT_OK(
+        log->Checkpoint([](std::string_view path) { return path == "a"; }));
+  }
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+  TENSORSTORE_ASSERT_OK(log->Recover(apply));
+  EXPECT_THAT(DescribeRecords(replayed), ::testing::ElementsAre("b=<delete>"));
+
+  // Replayed segments are deleted.
+  TENSORSTORE_ASSERT_OK(log->Recover(apply));
+  log.reset();
+  replayed.clear();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(log, WriteAheadLog::Open(directory));
+  TENSORSTORE_ASSERT_OK(log->Recover(apply));
+  EXPECT_TRUE(replayed.empty());
+}
+
+TEST(WriteAheadLogTest, CheckpointWaitsForEarlierSegments) {
+  ScopedTemporaryDirectory tempdir;
+  const std::string directory = tempdir.path() + "/wal";
+  std::vector<WriteAheadLogRecord> replayed;
+  const auto apply = [&](const WriteAheadLogRecord& record) {
+    replayed.push_back(record);
+    return absl::OkStatus();
+  };
+
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+    TENSORSTORE_ASSERT_OK(log->Recover(apply));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto segment1, log->Commit({"a", absl::Cord("abc")}));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto segment2, log->Commit({"b", absl::Cord("old")}));
+    log->Applied(segment2, InlineExecutor{});
+    // A later segment that does not hold a record for "b" is not waited for.
+    TENSORSTORE_ASSERT_OK(log->Commit({"c", absl::Cord("def")}));
+
+    // The segment holding the record for "b" cannot be retired before the
+    // earlier segment, whose record is not yet applied.
+    absl::Notification checkpointed;
+    std::thread thread([&] {
+      TENSORSTORE_EXPECT_OK(
+          log->Checkpoint([](std::string_view path) { return path == "b"; }));
+      checkpointed.Notify();
+    });
+    EXPECT_FALSE(
+        checkpointed.WaitForNotificationWithTimeout(absl::Milliseconds(100)));
+    log->Applied(segment1, InlineExecutor{});
+    thread.join();
+    EXPECT_TRUE(checkpointed.HasBeenNotified());
+  }
+
+  // After a crash, the record for "b" is not replayed over a subsequent
+  // modification of the file that bypassed the log.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+  TENSORSTORE_ASSERT_OK(log->Recover(apply));
+  EXPECT_THAT(DescribeRecords(replayed), ::testing::ElementsAre("c=def"));
+}
+
+TEST(WriteAheadLogTest, RecoverSkipsAborted) {
+  ScopedTemporaryDirectory tempdir;
+  const std::string directory = tempdir.path() + "/wal";
+  std::vector<WriteAheadLogRecord> replayed;
+  const auto apply = [&](const WriteAheadLogRecord& record) {
+    replayed.push_back(record);
+    return absl::OkStatus();
+  };
+
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+    TENSORSTORE_ASSERT_OK(log->Recover(apply));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto segment1, log->Commit({"a", absl::Cord("abc")}));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto segment2, log->Commit({"b", absl::Cord("def")}));
+    // The write of "a" fails to apply; the crash occurs before any segment is
+    // retired.
+    TENSORSTORE_ASSERT_OK(log->Commit({"a", std::nullopt, segment1}));
+    EXPECT_LT(segment1, segment2);
+  }
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log, WriteAheadLog::Open(directory));
+  TENSORSTORE_ASSERT_OK(log->Recover(apply));
+  EXPECT_THAT(DescribeRecords(replayed), ::testing::ElementsAre("b=def"));
+}
+
+TEST(WriteAheadLogTest, OpenShared) {
+  ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log1,
+                                   WriteAheadLog::Open(tempdir.path()));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto log2,
+                                   WriteAheadLog::Open(tempdir.path()));
+  EXPECT_EQ(log1, log2);
+}
+
+}  // namespace
@@ -56,6 +56,7 @@
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -221,7 +222,8 @@ class MemoryDriver
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
     return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+           SupportedFeatures::kAtomicWriteWithoutOverwrite |
+           SupportedFeatures::kPartialWrite;
   }
 
   /// In simple cases, such as the "memory" driver, the `Driver` can simply
@@ -404,6 +406,14 @@ Future<TimestampedStorageGeneration> MemoryDriver::Write(
   auto it = values.find(key);
   if (it == values.end()) {
     // Key does not already exist.
+    if (!options.byte_ranges.empty()) {
+      if (!StorageGeneration::IsUnknown(
+              options.generation_conditions.if_equal)) {
+        return GenerationNow(StorageGeneration::Unknown());
+      }
+      return absl::NotFoundError(tensorstore::StrCat(
+          "Partial write of missing key: ", QuoteString(key)));
+    }
     if (!options.generation_conditions.MatchesNoValue()) {
       // Write is conditioned on there being an existing key with a
       // generation of `if_equal`.  Abort.
@@ -436,7 +446,12 @@ Future<TimestampedStorageGeneration> MemoryDriver::Write(
   // Set the generation number to the next unused generation number.
   it->second.generation_number = data.next_generation_number++;
   // Update the value.
-  it->second.value = *std::move(value);
+  if (!options.byte_ranges.empty()) {
+    it->second.value = internal::OverwriteByteRanges(
+        it->second.value, options.byte_ranges, *std::move(value));
+  } else {
+    it->second.value = *std::move(value);
+  }
   return GenerationNow(it->second.generation());
 }
 
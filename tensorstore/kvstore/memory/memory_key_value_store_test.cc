@@ -70,6 +70,11 @@ TEST(MemoryKeyValueStoreTest, DeleteRangeFromBeginning) {
   tensorstore::internal::TestKeyValueStoreDeleteRangeFromBeginning(store);
 }
 
+TEST(MemoryKeyValueStoreTest, PartialWrite) {
+  auto store = tensorstore::GetMemoryKeyValueStore();
+  tensorstore::internal::TestKeyValueStorePartialWrite(store);
+}
+
 #if 0
 TEST(MemoryKeyValueStoreTest, CopyRange) {
   auto store = tensorstore::GetMemoryKeyValueStore();
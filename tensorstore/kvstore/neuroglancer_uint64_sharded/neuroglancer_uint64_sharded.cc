@@ -1119,8 +1119,11 @@ class ShardedKeyValueStore
 
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
+    // Chunks are not stored as separate values of the base key-value store,
+    // so partial writes cannot be passed through.
     return base_kvstore_driver()->GetSupportedFeatures(
-        KeyRange::Prefix(key_prefix()));
+               KeyRange::Prefix(key_prefix())) &
+           ~SupportedFeatures::kPartialWrite;
   }
 
   Result<KvStore> GetBase(std::string_view path,
@@ -15,6 +15,7 @@
 #include "tensorstore/kvstore/operations.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <cassert>
 #include <optional>
@@ -24,12 +25,14 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/transaction.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
@@ -107,11 +110,60 @@ Future<ReadResult> Read(const KvStore& store, std::string_view key,
       std::move(transactional_read_options));
 }
 
+namespace {
+
+/// Validates a write with `WriteOptions::byte_ranges` specified.
+absl::Status ValidatePartialWrite(const KvStore& store,
+                                  std::string_view full_key,
+                                  const std::optional<Value>& value,
+                                  const WriteOptions& options) {
+  if (store.transaction != no_transaction) {
+    return absl::UnimplementedError(
+        "byte_ranges not supported for transactional writes");
+  }
+  if (!value) {
+    return absl::InvalidArgumentError("byte_ranges not supported for deletes");
+  }
+  if (StorageGeneration::IsNoValue(options.generation_conditions.if_equal)) {
+    return absl::InvalidArgumentError(
+        "byte_ranges requires an existing value");
+  }
+  int64_t position = 0;
+  int64_t size = 0;
+  for (const auto& range : options.byte_ranges) {
+    if (!range.SatisfiesInvariants() || range.inclusive_min < position) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "byte_ranges must be non-overlapping and in increasing order: ",
+          range));
+    }
+    position = range.exclusive_max;
+    size += range.size();
+  }
+  if (size != static_cast<int64_t>(value->size())) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "byte_ranges specify ", size, " bytes but value has ", value->size(),
+        " bytes"));
+  }
+  if ((store.driver->GetSupportedFeatures(
+           KeyRange::Singleton(std::string(full_key))) &
+       SupportedFeatures::kPartialWrite) == SupportedFeatures{}) {
+    return absl::UnimplementedError(tensorstore::StrCat(
+        "byte_ranges not supported for ", store.driver->DescribeKey(full_key)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
 Future<TimestampedStorageGeneration> Write(const KvStore& store,
                                            std::string_view key,
                                            std::optional<Value> value,
                                            WriteOptions options) {
   auto full_key = tensorstore::StrCat(store.path, key);
+  if (!options.byte_ranges.empty()) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidatePartialWrite(store, full_key, value, options));
+  }
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
     return store.driver->Write(std::move(full_key), std::move(value),
@@ -143,6 +195,10 @@ Future<TimestampedStorageGeneration> WriteCommitted(const KvStore& store,
                                                     std::optional<Value> value,
                                                     WriteOptions options) {
   auto full_key = tensorstore::StrCat(store.path, key);
+  if (!options.byte_ranges.empty()) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        ValidatePartialWrite(store, full_key, value, options));
+  }
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
     return store.driver->Write(std::move(full_key), std::move(value),
@@ -191,6 +191,23 @@ struct WriteGenerationConditions {
 struct WriteOptions {
   /// Specifies conditions for the write.
   WriteGenerationConditions generation_conditions;
+
+  /// Byte ranges of the existing value to overwrite, non-overlapping and in
+  /// increasing order.
+  ///
+  /// If non-empty, the value specifies the new contents of these ranges,
+  /// concatenated, and all other bytes of the existing value are retained.  A
+  /// range may extend past the end of the existing value, which is then
+  /// extended, filling any gap with zero bytes.  The existing value must be
+  /// present; otherwise, the write fails with `absl::StatusCode::kNotFound`,
+  /// or is aborted if `generation_conditions.if_equal` is specified.
+  ///
+  /// Only supported by drivers that report `SupportedFeatures::kPartialWrite`,
+  /// and not within a transaction.  Whether the ranges are updated atomically
+  /// with respect to concurrent readers and a crash of the writer depends on
+  /// the driver; the `file` driver atomically replaces the file with a
+  /// modified copy.
+  std::vector<ByteRange> byte_ranges;
 };
 
 /// Options for `ListFuture`.
@@ -919,6 +919,48 @@ void TestKeyValueStoreDeleteRangeFromBeginning(const KvStore& store) {
                   MatchesListEntry("b/b"))));
 }
 
+void TestKeyValueStorePartialWrite(const KvStore& store) {
+  const auto write = [&](std::string_view key, std::vector<ByteRange> ranges,
+                         std::string_view value,
+                         StorageGeneration if_equal = {}) {
+    kvstore::WriteOptions options;
+    options.byte_ranges = std::move(ranges);
+    options.generation_conditions.if_equal = std::move(if_equal);
+    return kvstore::Write(store, key, absl::Cord(value), std::move(options))
+        .result();
+  };
+  // The existing value is required.
+  EXPECT_THAT(write("a", {{0, 1}}, "x"),
+              MatchesStatus(absl::StatusCode::kNotFound));
+  EXPECT_THAT(write("a", {{0, 1}}, "x", StorageGeneration::NoValue()),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(write("a", {{0, 2}}, "x"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(write("a", {{2, 3}, {1, 2}}, "xy"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a", absl::Cord("abcdef")).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stamp2,
+                                   write("a", {{1, 3}, {4, 5}}, "XYZ"));
+  EXPECT_NE(stamp.generation, stamp2.generation);
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("aXYdZf"), stamp2.generation));
+
+  // Conditional write with an out-of-date generation is aborted.
+  EXPECT_THAT(write("a", {{0, 1}}, "Q", stamp.generation),
+              IsOkAndHolds(MatchesTimestampedStorageGeneration(
+                  StorageGeneration::Unknown())));
+
+  // Ranges past the end extend the value, filling the gap with zero bytes.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp3, write("a", {{5, 6}, {8, 10}}, "Quv", stamp2.generation));
+  EXPECT_NE(stamp2.generation, stamp3.generation);
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord(std::string("aXYdZQ\0\0uv", 10)),
+                                   stamp3.generation));
+}
+
 void TestKeyValueStoreCopyRange(const KvStore& store) {
   TENSORSTORE_ASSERT_OK(kvstore::Write(store, "w/a", absl::Cord("w_a")));
   TENSORSTORE_ASSERT_OK(kvstore::Write(store, "x/a", absl::Cord("value_a")));
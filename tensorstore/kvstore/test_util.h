@@ -83,6 +83,10 @@ void TestKeyValueStoreDeleteRangeFromBeginning(const KvStore& store);
 /// Tests CopyRange on `store`, which should be empty.
 void TestKeyValueStoreCopyRange(const KvStore& store);
 
+/// Tests writes with `WriteOptions::byte_ranges` on `store`, which must
+/// support `SupportedFeatures::kPartialWrite` and should be empty.
+void TestKeyValueStorePartialWrite(const KvStore& store);
+
 /// Tests List on `store`, which should be empty.
 void TestKeyValueStoreList(const KvStore& store, bool match_size = true);
 
@@ -80,11 +80,14 @@
 #include "tensorstore/util/str_cat.h"
 
 // specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/cache_key/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/internal/estimate_heap_usage/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/estimate_heap_usage/std_vector.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/serialization/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/util/execution/result_sender.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/util/garbage_collection/std_vector.h"  // IWYU pragma: keep
 
 namespace tensorstore {
@@ -726,6 +729,9 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::WritebackError() {
 
 struct ShardedKeyValueStoreSpecData {
   Context::Resource<internal::CachePoolResource> cache_pool;
+  std::optional<Context::Resource<internal::CachePoolResource>>
+      index_cache_pool;
+  bool pin_index;
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
   kvstore::Spec base;
@@ -738,8 +744,9 @@ struct ShardedKeyValueStoreSpecData {
                                           ::nlohmann::json::object_t)
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.cache_pool, x.data_copy_concurrency, x.base, x.grid_shape,
-             x.index_codecs, x.index_location);
+    return f(x.cache_pool, x.index_cache_pool, x.pin_index,
+             x.data_copy_concurrency, x.base, x.grid_shape, x.index_codecs,
+             x.index_location);
   };
 };
 
@@ -768,6 +775,12 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                 }))),
         jb::Member(internal::CachePoolResource::id,
                    jb::Projection<&ShardedKeyValueStoreSpecData::cache_pool>()),
+        jb::Member(
+            "index_cache_pool",
+            jb::Projection<&ShardedKeyValueStoreSpecData::index_cache_pool>()),
+        jb::Member("pin_index",
+                   jb::Projection<&ShardedKeyValueStoreSpecData::pin_index>(
+                       jb::DefaultValue([](auto* x) { *x = false; }))),
         jb::Member(
             internal::DataCopyConcurrencyResource::id,
             jb::Projection<
@@ -842,8 +855,13 @@ class ShardedKeyValueStore
 
   internal::CachePtr<ShardedKeyValueStoreWriteCache> write_cache_;
 
+  // Shard index cache entry, if pinned for the lifetime of the kvstore.
+  internal::PinnedCacheEntry<ShardIndexCache> pinned_shard_index_entry_;
+
   struct DataForSpec {
     Context::Resource<internal::CachePoolResource> cache_pool_resource;
+    std::optional<Context::Resource<internal::CachePoolResource>>
+        index_cache_pool_resource;
     Context::Resource<internal::DataCopyConcurrencyResource>
         data_copy_concurrency_resource;
     ZarrCodecChainSpec index_codecs;
@@ -858,7 +876,9 @@ ShardedKeyValueStore::ShardedKeyValueStore(
       params.cache_pool.get(), shared_cache_key, [&] {
         return std::make_unique<ShardedKeyValueStoreWriteCache>(
             internal::GetCache<ShardIndexCache>(
-                params.cache_pool.get(), "", [&] {
+                params.index_cache_pool ? params.index_cache_pool.get()
+                                        : params.cache_pool.get(),
+                "", [&] {
                   return std::make_unique<ShardIndexCache>(
                       std::move(params.base_kvstore),
                       std::move(params.base_kvstore_path),
@@ -866,6 +886,10 @@ ShardedKeyValueStore::ShardedKeyValueStore(
                       std::move(params.index_params));
                 }));
       });
+  if (params.pin_index) {
+    pinned_shard_index_entry_ =
+        GetCacheEntry(shard_index_cache(), std::string_view{});
+  }
   this->SetBatchNestingDepth(
       this->base_kvstore_driver()->BatchNestingDepth() +
       1 +  // for queuing entry requests
@@ -1289,8 +1313,11 @@ std::string ShardedKeyValueStore::DescribeKey(std::string_view key) {
 
 kvstore::SupportedFeatures ShardedKeyValueStore::GetSupportedFeatures(
     const KeyRange& key_range) const {
+  // Entries are not stored as separate values of the base key-value store, so
+  // partial writes cannot be passed through.
   return base_kvstore_driver()->GetSupportedFeatures(
-      KeyRange::Singleton(base_kvstore_path()));
+             KeyRange::Singleton(base_kvstore_path())) &
+         ~kvstore::SupportedFeatures::kPartialWrite;
 }
 
 Result<KvStore> ShardedKeyValueStore::GetBase(
@@ -1324,6 +1351,8 @@ absl::Status ShardedKeyValueStore::GetBoundSpecData(
   spec.base.path = base_kvstore_path();
   spec.data_copy_concurrency = data_for_spec_->data_copy_concurrency_resource;
   spec.cache_pool = data_for_spec_->cache_pool_resource;
+  spec.index_cache_pool = data_for_spec_->index_cache_pool_resource;
+  spec.pin_index = static_cast<bool>(pinned_shard_index_entry_);
   spec.index_codecs = data_for_spec_->index_codecs;
   const auto& shard_index_params = this->shard_index_params();
   spec.index_location = shard_index_params.index_location;
@@ -1346,18 +1375,23 @@ Future<kvstore::DriverPtr> ShardedKeyValueStoreSpec::DoOpen() const {
         std::string cache_key;
         internal::EncodeCacheKey(
             &cache_key, base_kvstore.driver, base_kvstore.path,
-            spec->data_.data_copy_concurrency, spec->data_.grid_shape,
-            spec->data_.index_codecs);
+            spec->data_.data_copy_concurrency, spec->data_.index_cache_pool,
+            spec->data_.grid_shape, spec->data_.index_codecs);
         ShardedKeyValueStoreParameters params;
         params.base_kvstore = std::move(base_kvstore.driver);
         params.base_kvstore_path = std::move(base_kvstore.path);
         params.executor = spec->data_.data_copy_concurrency->executor;
         params.cache_pool = *spec->data_.cache_pool;
+        if (spec->data_.index_cache_pool) {
+          params.index_cache_pool = **spec->data_.index_cache_pool;
+        }
+        params.pin_index = spec->data_.pin_index;
         params.index_params = std::move(index_params);
         auto driver = internal::MakeIntrusivePtr<ShardedKeyValueStore>(
             std::move(params), cache_key);
         driver->data_for_spec_.reset(new ShardedKeyValueStore::DataForSpec{
             spec->data_.cache_pool,
+            spec->data_.index_cache_pool,
             spec->data_.data_copy_concurrency,
             spec->data_.index_codecs,
         });
@@ -1371,6 +1405,24 @@ kvstore::DriverPtr GetShardedKeyValueStore(
   return kvstore::DriverPtr(new ShardedKeyValueStore(std::move(parameters)));
 }
 
+Future<const void> PrefetchShardIndexes(span<const kvstore::DriverPtr> stores,
+                                        absl::Time staleness_bound) {
+  std::vector<Future<const void>> futures;
+  futures.reserve(stores.size());
+  {
+    // The batch is submitted once it is destroyed.
+    Batch batch = Batch::New();
+    for (const auto& store : stores) {
+      auto* sharded_store = dynamic_cast<ShardedKeyValueStore*>(store.get());
+      if (!sharded_store) continue;
+      auto entry = GetCacheEntry(sharded_store->shard_index_cache(),
+                                 std::string_view{});
+      futures.push_back(entry->Read({staleness_bound, batch}));
+    }
+  }
+  return WaitAllFuture(span(futures));
+}
+
 }  // namespace zarr3_sharding_indexed
 }  // namespace tensorstore
 
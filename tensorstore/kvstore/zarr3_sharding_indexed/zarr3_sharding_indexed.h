@@ -45,7 +45,16 @@
 /// To read an entry, the shard index must first be read and decoded, and then
 /// the byte range indicated by the shard index is read.  Depending on the cache
 /// pool configuration, the shard index may be cached to reduce overhead for
-/// repeated read requests to the same shard.
+/// repeated read requests to the same shard.  The shard index may be cached in
+/// a separate `index_cache_pool`, such that it is not evicted by bulk data, and
+/// may be pinned for the lifetime of the kvstore.  `PrefetchShardIndexes` reads
+/// the indexes of multiple shards as a single batch.
+///
+/// The zarr3 driver opens a separate kvstore for each shard, and forwards its
+/// own `index_cache_pool` and `pin_index` options to them.  With `pin_index`,
+/// the zarr3 driver retains the kvstore of each shard that has been accessed
+/// while the array is open; see `internal_zarr3::PrefetchShardIndexes` for
+/// prefetching the shard indexes of a region of a zarr3 array.
 ///
 /// To write an entry or otherwise make any changes to a shard, the entire shard
 /// is re-written.
@@ -55,11 +64,14 @@
 #include <string>
 #include <string_view>
 
+#include "absl/time/time.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/zarr3_sharding_indexed/shard_format.h"  // IWYU pragma: export
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace zarr3_sharding_indexed {
@@ -69,12 +81,31 @@ struct ShardedKeyValueStoreParameters {
   std::string base_kvstore_path;
   Executor executor;
   internal::CachePool::WeakPtr cache_pool;
+  // Cache pool for the shard index.  If null, `cache_pool` is used.
+  internal::CachePool::WeakPtr index_cache_pool;
+  // If `true`, the shard index cache entry is pinned for the lifetime of the
+  // kvstore, such that it is never evicted once read.
+  bool pin_index = false;
   ShardIndexParameters index_params;
 };
 
 kvstore::DriverPtr GetShardedKeyValueStore(
     ShardedKeyValueStoreParameters&& parameters);
 
+/// Reads the shard index of each of `stores` into its cache, if not already
+/// cached with a timestamp of at least `staleness_bound`.
+///
+/// The reads are submitted as a single batch, such that the base kvstore may
+/// issue them together.
+///
+/// \param stores The sharded kvstores, as returned by `GetShardedKeyValueStore`
+///     or opened from a ``zarr3_sharding_indexed`` spec.  Other kvstores are
+///     ignored.
+/// \param staleness_bound Cached shard indexes older than this are re-read.
+/// \returns A future that becomes ready once all shard indexes have been read.
+Future<const void> PrefetchShardIndexes(span<const kvstore::DriverPtr> stores,
+                                        absl::Time staleness_bound);
+
 }  // namespace zarr3_sharding_indexed
 }  // namespace tensorstore
 
@@ -99,6 +99,7 @@ using ::tensorstore::kvstore::ReadResult;
 using ::tensorstore::zarr3_sharding_indexed::EntryId;
 using ::tensorstore::zarr3_sharding_indexed::EntryIdToKey;
 using ::tensorstore::zarr3_sharding_indexed::GetShardedKeyValueStore;
+using ::tensorstore::zarr3_sharding_indexed::PrefetchShardIndexes;
 using ::tensorstore::zarr3_sharding_indexed::ShardedKeyValueStoreParameters;
 using ::tensorstore::zarr3_sharding_indexed::ShardIndexLocation;
 
@@ -159,12 +160,16 @@ kvstore::DriverPtr GetDefaultStore(kvstore::DriverPtr base_kvstore,
                                    std::string base_kvstore_path,
                                    Executor executor,
                                    CachePool::StrongPtr cache_pool,
-                                   const std::vector<Index>& grid_shape) {
+                                   const std::vector<Index>& grid_shape,
+                                   CachePool::StrongPtr index_cache_pool = {},
+                                   bool pin_index = false) {
   ShardedKeyValueStoreParameters params;
   params.base_kvstore = base_kvstore;
   params.base_kvstore_path = base_kvstore_path;
   params.executor = executor;
   params.cache_pool = CachePool::WeakPtr(cache_pool);
+  params.index_cache_pool = CachePool::WeakPtr(index_cache_pool);
+  params.pin_index = pin_index;
   TENSORSTORE_CHECK_OK_AND_ASSIGN(
       auto index_codecs,
       ZarrCodecChainSpec::FromJson(
@@ -1292,6 +1297,61 @@ TEST_F(UnderlyingKeyValueStoreTest, BatchRead) {
   }
 }
 
+TEST_F(UnderlyingKeyValueStoreTest, IndexCachePool) {
+  // Nothing is retained in `cache_pool`, but the shard index is retained in
+  // `index_cache_pool`.
+  cache_pool = CachePool::Make({});
+  auto index_cache_pool = CachePool::Make(kSmallCacheLimits);
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  grid_shape = {3};
+  store = GetDefaultStore(mock_store, "shard_path",
+                          tensorstore::InlineExecutor{}, cache_pool,
+                          grid_shape, index_cache_pool);
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(0, grid_shape), absl::Cord("abc")).result());
+  mock_store->request_log.pop_all();
+
+  // Expected to result in a single request for the shard index.
+  TENSORSTORE_ASSERT_OK(
+      PrefetchShardIndexes(span(&store, 1), absl::Now()).result());
+  EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+
+  // Expected to result in a single request for the entry each time.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape)).result(),
+                MatchesKvsReadResult(absl::Cord("abc")));
+    EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+  }
+}
+
+TEST_F(UnderlyingKeyValueStoreTest, PinIndex) {
+  cache_pool = CachePool::Make({});
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  grid_shape = {3};
+  store = GetDefaultStore(mock_store, "shard_path",
+                          tensorstore::InlineExecutor{}, cache_pool,
+                          grid_shape, /*index_cache_pool=*/{},
+                          /*pin_index=*/true);
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(0, grid_shape), absl::Cord("abc")).result());
+  mock_store->request_log.pop_all();
+
+  // Expected to result in a request for the shard index, followed by a
+  // request for the entry.
+  EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("abc")));
+  EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(2));
+
+  // The pinned shard index is not evicted from `cache_pool`.
+  EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("abc")));
+  EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+}
+
 // Tests of ReadModifyWrite operations, using `KvsBackedTestCache` ->
 // `ShardedKeyValueStore` -> `MockKeyValueStore`.
 class ReadModifyWriteTest : public ::testing::Test {
@@ -1444,6 +1504,7 @@ TEST(ShardedKeyValueStoreTest, SpecRoundtripFile) {
       {"index_location", "end"},
       {"index_codecs",
        {{{"name", "bytes"}, {"configuration", {{"endian", "little"}}}}}},
+      {"pin_index", true},
   };
   tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
 }
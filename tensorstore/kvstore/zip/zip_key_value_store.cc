@@ -140,7 +140,9 @@ class ZipKvStore
 
   kvstore::SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
-    return base_.driver->GetSupportedFeatures(KeyRange::Singleton(base_.path));
+    return base_.driver->GetSupportedFeatures(
+               KeyRange::Singleton(base_.path)) &
+           ~kvstore::SupportedFeatures::kPartialWrite;
   }
 
   Result<KvStore> GetBase(std::string_view path,
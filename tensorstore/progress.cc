@@ -16,6 +16,8 @@
 
 #include <ostream>
 
+#include "absl/time/time.h"
+
 namespace tensorstore {
 
 bool operator==(const ReadProgress& a, const ReadProgress& b) {
@@ -54,10 +56,14 @@ bool operator!=(const CopyProgress& a, const CopyProgress& b) {
   return !(a == b);
 }
 std::ostream& operator<<(std::ostream& os, const CopyProgress& a) {
-  return os << "{ total_elements=" << a.total_elements
-            << ", read_elements=" << a.read_elements
-            << ", copied_elements=" << a.copied_elements
-            << ", committed_elements=" << a.committed_elements << " }";
+  os << "{ total_elements=" << a.total_elements
+     << ", read_elements=" << a.read_elements
+     << ", copied_elements=" << a.copied_elements
+     << ", committed_elements=" << a.committed_elements;
+  if (a.elapsed != absl::ZeroDuration()) {
+    os << ", elapsed=" << a.elapsed;
+  }
+  return os << " }";
 }
 
 }  // namespace tensorstore
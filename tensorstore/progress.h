@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/poly/poly.h"
 #include "tensorstore/util/future.h"
@@ -80,7 +81,14 @@ struct CopyProgress {
   /// Number of elements that have been committed.
   Index committed_elements;
 
+  /// Time elapsed since the copy was initiated, from which the throughput
+  /// may be computed, e.g. as
+  /// ``committed_elements / absl::ToDoubleSeconds(elapsed)``.
+  absl::Duration elapsed = absl::ZeroDuration();
+
   /// Compares two progress states for equality.
+  ///
+  /// The `elapsed` time is not compared, since it is not deterministic.
   friend bool operator==(const CopyProgress& a, const CopyProgress& b);
   friend bool operator!=(const CopyProgress& a, const CopyProgress& b);
 
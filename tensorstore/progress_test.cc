@@ -16,6 +16,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/time/time.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace {
@@ -85,6 +86,15 @@ TEST(CopyProgressTest, Ostream) {
       "{ total_elements=4, read_elements=3, copied_elements=2, "
       "committed_elements=1 }",
       tensorstore::StrCat(CopyProgress{4, 3, 2, 1}));
+  EXPECT_EQ(
+      "{ total_elements=4, read_elements=3, copied_elements=2, "
+      "committed_elements=1, elapsed=2s }",
+      tensorstore::StrCat(CopyProgress{4, 3, 2, 1, absl::Seconds(2)}));
+}
+
+TEST(CopyProgressTest, ComparisonIgnoresElapsed) {
+  EXPECT_EQ((CopyProgress{4, 3, 2, 1}),
+            (CopyProgress{4, 3, 2, 1, absl::Seconds(2)}));
 }
 
 }  // namespace
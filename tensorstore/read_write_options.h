@@ -20,11 +20,87 @@
 #include "absl/status/status.h"
 #include "tensorstore/batch.h"
 #include "tensorstore/contiguous_layout.h"
+#include "tensorstore/index.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/progress.h"
 
 namespace tensorstore {
 
+/// Limits the total size, in bytes, of the data read concurrently by
+/// `tensorstore::Prefetch`.  A value of `0` indicates no limit.
+///
+/// At least one chunk is always read at a time, even if it exceeds the limit.
+///
+/// \relates Prefetch
+struct PrefetchBytesLimit {
+  constexpr explicit PrefetchBytesLimit(Index value = 0) : value(value) {}
+  Index value;
+};
+
+/// Options for `tensorstore::Prefetch`.
+///
+/// \relates Prefetch
+struct PrefetchOptions {
+  template <typename T>
+  constexpr static inline bool IsOption = false;
+
+  absl::Status Set(PrefetchBytesLimit value) {
+    this->bytes_limit = value;
+    return absl::OkStatus();
+  }
+
+  absl::Status Set(Batch value) {
+    this->batch = std::move(value);
+    return absl::OkStatus();
+  }
+
+  /// Limit on the size of the data read concurrently.
+  PrefetchBytesLimit bytes_limit;
+
+  /// Optional batch, used for the initial chunk reads.
+  Batch batch{no_batch};
+};
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<PrefetchBytesLimit> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch::View> = true;
+
+/// Specifies that a read should also prefetch the data that a sequential scan
+/// along one of its dimensions is expected to read next.
+///
+/// Once the bounds of the read are resolved, the `count` regions that
+/// immediately follow the region being read along input dimension
+/// `dimension` are prefetched in the background, as if by
+/// `tensorstore::Prefetch` with the specified `bytes_limit`.  Regions outside
+/// the current bounds are skipped.  Has no effect if `count` is `0`.
+///
+/// Example::
+///
+///     // Read rows [0, 100) and prefetch rows [100, 300).
+///     TENSORSTORE_ASSIGN_OR_RETURN(
+///         auto array,
+///         tensorstore::Read(store | tensorstore::Dims(0).HalfOpenInterval(0,
+///                                                                     100),
+///                           tensorstore::ReadAhead{0, 2})
+///             .result());
+///
+/// \relates Read
+struct ReadAhead {
+  /// Input dimension of the read along which the scan proceeds.
+  DimensionIndex dimension = 0;
+
+  /// Number of subsequent regions, each the size of the read, to prefetch.
+  Index count = 0;
+
+  /// Limit on the size of the data prefetched concurrently.
+  PrefetchBytesLimit bytes_limit;
+};
+
 /// Options for `tensorstore::Read` into an existing target array.
 ///
 /// \relates Read[TensorStore, Array]
@@ -47,6 +123,11 @@ struct ReadOptions {
     return absl::OkStatus();
   }
 
+  absl::Status Set(ReadAhead value) {
+    this->read_ahead = value;
+    return absl::OkStatus();
+  }
+
   /// Constrains how the source TensorStore may be aligned to the target array.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
 
@@ -55,6 +136,9 @@ struct ReadOptions {
 
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Optional read-ahead.
+  ReadAhead read_ahead;
 };
 
 template <>
@@ -69,6 +153,9 @@ constexpr inline bool ReadOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadOptions::IsOption<ReadAhead> = true;
+
 /// Options for `tensorstore::Read` into new array.
 ///
 /// \relates Read[TensorStore]
@@ -91,6 +178,11 @@ struct ReadIntoNewArrayOptions {
     return absl::OkStatus();
   }
 
+  absl::Status Set(ReadAhead value) {
+    this->read_ahead = value;
+    return absl::OkStatus();
+  }
+
   /// Specifies the layout order of the newly-allocated array.  Defaults to
   /// `c_order`.
   ContiguousLayoutOrder layout_order = c_order;
@@ -100,6 +192,9 @@ struct ReadIntoNewArrayOptions {
 
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Optional read-ahead.
+  ReadAhead read_ahead;
 };
 
 template <>
@@ -116,6 +211,9 @@ constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadIntoNewArrayOptions::IsOption<ReadAhead> = true;
+
 /// Specifies restrictions on how references to the source array/source
 /// TensorStore may be used by write operations.
 ///
@@ -184,6 +282,29 @@ template <>
 constexpr inline bool WriteOptions::IsOption<SourceDataReferenceRestriction> =
     true;
 
+/// Limits the total size, in bytes, of the source data that a
+/// `tensorstore::Copy` has requested but not yet finished writing.
+///
+/// When specified, the source is read in cells of the target write chunk grid,
+/// in C order, and reading of further cells is deferred while the limit would
+/// be exceeded.  Cells are enlarged to also cover whole source read chunks if
+/// the source and target chunk grids are aligned and the limit permits.  A
+/// cell is finished once it has been copied to the target and, unless the
+/// target is bound to a transaction, committed; the commit is started as soon
+/// as the cell has been copied.  Reads, writes, and commits of different cells
+/// proceed concurrently.  Since cells cover whole target chunks, each target
+/// chunk is written only once.
+///
+/// A value of `0` (the default) indicates no limit, in which case the entire
+/// source is requested at once.  At least one cell is always in flight, even
+/// if it exceeds the limit.
+///
+/// \relates Copy[TensorStore, TensorStore]
+struct CopyBytesLimit {
+  constexpr explicit CopyBytesLimit(Index value = 0) : value(value) {}
+  Index value;
+};
+
 /// Options for `tensorstore::Copy`.
 ///
 /// \relates Copy[TensorStore, TensorStore]
@@ -211,6 +332,11 @@ struct CopyOptions {
     return absl::OkStatus();
   }
 
+  absl::Status Set(CopyBytesLimit value) {
+    this->bytes_limit = value;
+    return absl::OkStatus();
+  }
+
   /// Constrains how the source TensorStore may be aligned to the target
   /// TensorStore.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
@@ -225,6 +351,9 @@ struct CopyOptions {
 
   /// Optional batch for reading.
   Batch batch{no_batch};
+
+  /// Limit on the size of the data in flight.
+  CopyBytesLimit bytes_limit;
 };
 
 template <>
@@ -243,6 +372,9 @@ constexpr inline bool CopyOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool CopyOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool CopyOptions::IsOption<CopyBytesLimit> = true;
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_READ_WRITE_OPTIONS_H_
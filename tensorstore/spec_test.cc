@@ -304,6 +304,7 @@ TEST(SpecTest, SetContextAndKvstoreIncludeDefaults) {
           {"cache_pool", {"cache_pool"}},
           {"data_copy_concurrency", {"data_copy_concurrency"}},
           {"delete_existing", false},
+          {"disk_cache", {"disk_cache"}},
           {"metadata", ::nlohmann::json::object_t()},
           {"recheck_cached_data", true},
           {"recheck_cached_metadata", "open"},
@@ -318,6 +319,9 @@ TEST(SpecTest, SetContextAndKvstoreIncludeDefaults) {
                {"file_io_sync", {"file_io_sync"}},
                {"file_io_locking", {"file_io_locking"}},
                {"file_io_memmap", {"file_io_memmap"}},
+               {"file_io_uring", {"file_io_uring"}},
+               {"file_io_direct", {"file_io_direct"}},
+               {"file_io_group_commit", {"file_io_group_commit"}},
            }},
           {"schema",
            {{"dtype", "uint8"},
@@ -329,10 +333,14 @@ TEST(SpecTest, SetContextAndKvstoreIncludeDefaults) {
            {
                {"data_copy_concurrency", {{"limit", "shared"}}},
                {"cache_pool", {{"total_bytes_limit", 0}}},
+               {"disk_cache", ::nlohmann::json::object_t()},
                {"file_io_concurrency#a", {{"limit", 5}}},
                {"file_io_locking", ::nlohmann::json::object_t()},
                {"file_io_memmap", false},
                {"file_io_sync", true},
+               {"file_io_uring", ::nlohmann::json::object_t()},
+               {"file_io_direct", false},
+               {"file_io_group_commit", ::nlohmann::json::object_t()},
            }},
       })));
 }
@@ -368,6 +376,9 @@ TEST(SpecTest, SetContextAndKvstore) {
                {"file_io_sync", {"file_io_sync"}},
                {"file_io_locking", {"file_io_locking"}},
                {"file_io_memmap", {"file_io_memmap"}},
+               {"file_io_uring", {"file_io_uring"}},
+               {"file_io_direct", {"file_io_direct"}},
+               {"file_io_group_commit", {"file_io_group_commit"}},
            }},
           {"dtype", "uint8"},
           {"cache_pool", {"cache_pool"}},
@@ -376,14 +387,19 @@ TEST(SpecTest, SetContextAndKvstore) {
           {"transform",
            {{"input_inclusive_min", {0}}, {"input_exclusive_max", {{10}}}}},
           {"data_copy_concurrency", {"data_copy_concurrency"}},
+          {"disk_cache", {"disk_cache"}},
           {"context",
            {
                {"data_copy_concurrency", ::nlohmann::json::object_t()},
                {"cache_pool", ::nlohmann::json::object_t()},
+               {"disk_cache", ::nlohmann::json::object_t()},
                {"file_io_concurrency#a", {{"limit", 5}}},
                {"file_io_locking", ::nlohmann::json::object_t()},
                {"file_io_sync", true},
                {"file_io_memmap", false},
+               {"file_io_uring", ::nlohmann::json::object_t()},
+               {"file_io_direct", false},
+               {"file_io_group_commit", ::nlohmann::json::object_t()},
            }},
       })));
 }
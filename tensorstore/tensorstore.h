@@ -28,6 +28,7 @@
 #include "tensorstore/driver/copy.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/prefetch.h"
 #include "tensorstore/driver/read.h"
 #include "tensorstore/driver/write.h"
 #include "tensorstore/index.h"
@@ -652,6 +653,8 @@ constexpr inline bool CanReadTensorstoreToArray =
 ///
 /// - `Batch`
 ///
+/// - `ReadAhead`
+///
 /// Example::
 ///
 ///     TensorReader<int32_t, 3> store = ...;
@@ -714,6 +717,10 @@ Read(SourceTensorstore&& source, TargetArray&& target, Option&&... option) {
 ///
 /// - `ReadProgressFunction`
 ///
+/// - `Batch`
+///
+/// - `ReadAhead`
+///
 /// Example::
 ///
 ///     TensorReader<int32_t, 3> store = ...;
@@ -772,6 +779,68 @@ Read(SourceTensorstore&& source, Option&&... option) {
                                        std::move(options));
 }
 
+/// Reads the data of a `TensorStore` into its cache, without copying it
+/// anywhere, such that subsequent reads of the same region may be served from
+/// the cache.
+///
+/// The region is read in units of the read chunk grid, in C order.  Options
+/// compatible with `PrefetchOptions` are specified in any order after `store`.
+///
+/// Supported option types are:
+///
+/// - `PrefetchBytesLimit`, limiting the size of the data read concurrently.
+///   If not specified, all chunks are requested at once.
+///
+/// - `Batch`
+///
+/// Prefetching ignores any transaction bound to `store`; only the cached
+/// state of committed data is populated.  Prefetching has no effect on a
+/// TensorStore without a cache, or with a `cache_pool` that is too small to
+/// hold the region.
+///
+/// Example::
+///
+///     TENSORSTORE_RETURN_IF_ERROR(
+///         Prefetch(store | AllDims().SizedInterval({0, 0}, {1000, 1000}),
+///                  tensorstore::PrefetchBytesLimit{64 << 20})
+///             .result());
+///
+/// \param store Source `TensorStore` object that supports reading.  May be
+///     `Result`-wrapped.
+/// \param options Any option compatible with `PrefetchOptions`.
+/// \returns A future that becomes ready when the data has been read, or an
+///     error occurred.  Releasing all references to the future cancels the
+///     remaining reads.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename StoreResult>
+std::enable_if_t<
+    internal::IsTensorStoreThatSupportsMode<UnwrapResultType<StoreResult>,
+                                            ReadWriteMode::read>,
+    Future<void>>
+Prefetch(StoreResult&& store, PrefetchOptions options) {
+  return MapResult(
+      [&](UnwrapQualifiedResultType<StoreResult&&> unwrapped_store) {
+        return internal::DriverPrefetch(
+            internal::TensorStoreAccess::handle(
+                std::forward<decltype(unwrapped_store)>(unwrapped_store)),
+            std::move(options));
+      },
+      std::forward<StoreResult>(store));
+}
+template <typename StoreResult, typename... Option>
+std::enable_if_t<(IsCompatibleOptionSequence<PrefetchOptions, Option...> &&
+                  internal::IsTensorStoreThatSupportsMode<
+                      UnwrapResultType<StoreResult>, ReadWriteMode::read>),
+                 Future<void>>
+Prefetch(StoreResult&& store, Option&&... option) {
+  PrefetchOptions options;
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::SetAll(options, std::forward<Option>(option)...));
+  return tensorstore::Prefetch(std::forward<StoreResult>(store),
+                               std::move(options));
+}
+
 /// Evaluates whether the constraints required for `tensorstore::Write` are
 /// satisfied.
 ///
@@ -887,6 +956,8 @@ constexpr inline bool CanCopyTensorStoreToTensorStore =
 ///
 /// - `Batch`
 ///
+/// - `CopyBytesLimit`, bounding the memory used by large copies.
+///
 /// Example::
 ///
 ///     TensorReader<int32_t, 3> source = ...;